@@ -0,0 +1,263 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pbench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PBENCH_DEFAULT_REPETITIONS 5
+
+typedef struct PBenchResult_ {
+	const pchar	*name;
+	puint64		iterations;
+	puint64		bytes;
+	puint64		min_elapsed;
+	puint64		median_elapsed;
+	pdouble		mean_elapsed;
+} PBenchResult;
+
+static const PBenchCase * pbench_all_cases[] = {
+	pbench_containers_cases,
+	pbench_sync_cases,
+	pbench_ipc_cases,
+	pbench_crypto_cases,
+	NULL
+};
+
+void pbench_start (PBenchRun *run)
+{
+	run->start_ticks = p_time_profiler_ticks ();
+}
+
+void pbench_stop (PBenchRun *run)
+{
+	run->elapsed += p_time_profiler_ticks_to_nsecs (p_time_profiler_ticks () - run->start_ticks);
+}
+
+pint pbench_get_threads_count (void)
+{
+	pint count = p_uthread_ideal_count ();
+
+	return count < 2 ? 2 : count;
+}
+
+puint32 pbench_random (puint32 *state)
+{
+	/* Xorshift32, fast and good enough to shuffle keys */
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+
+	return *state;
+}
+
+static int pbench_compare_elapsed (const void *a, const void *b)
+{
+	puint64 val_a = *((const puint64 *) a);
+	puint64 val_b = *((const puint64 *) b);
+
+	return val_a < val_b ? -1 : (val_a > val_b ? 1 : 0);
+}
+
+static pboolean pbench_run_case (const PBenchCase	*bench_case,
+				 pdouble		scale,
+				 pint			repetitions,
+				 PBenchResult		*result)
+{
+	PBenchRun	run;
+	puint64		*elapsed;
+	pdouble		total = 0.0;
+	pint		i;
+
+	memset (&run, 0, sizeof (run));
+	memset (result, 0, sizeof (PBenchResult));
+
+	result->name       = bench_case->name;
+	result->iterations = (puint64) ((pdouble) bench_case->iterations * scale);
+
+	if (result->iterations == 0)
+		result->iterations = 1;
+
+	/* Warm up caches and allocators, results are not used */
+	run.iterations = result->iterations / 10 > 0 ? result->iterations / 10 : 1;
+
+	if (bench_case->func (&run) == FALSE)
+		return FALSE;
+
+	if ((elapsed = (puint64 *) p_malloc0 (sizeof (puint64) * (psize) repetitions)) == NULL)
+		return FALSE;
+
+	for (i = 0; i < repetitions; ++i) {
+		memset (&run, 0, sizeof (run));
+		run.iterations = result->iterations;
+
+		if (bench_case->func (&run) == FALSE) {
+			p_free (elapsed);
+			return FALSE;
+		}
+
+		elapsed[i]    = run.elapsed > 0 ? run.elapsed : 1;
+		result->bytes = run.bytes;
+		total        += (pdouble) elapsed[i];
+	}
+
+	qsort (elapsed, (size_t) repetitions, sizeof (puint64), pbench_compare_elapsed);
+
+	result->min_elapsed    = elapsed[0];
+	result->median_elapsed = elapsed[repetitions / 2];
+	result->mean_elapsed   = total / repetitions;
+
+	p_free (elapsed);
+
+	return TRUE;
+}
+
+static void pbench_print_result (FILE *out, const PBenchResult *result, pboolean is_first)
+{
+	pdouble seconds = (pdouble) result->median_elapsed / 1000000000.0;
+
+	fprintf (out, "%s\n    {\n", is_first ? "" : ",");
+	fprintf (out, "      \"name\": \"%s\",\n", result->name);
+	fprintf (out, "      \"iterations\": %llu,\n", (unsigned long long) result->iterations);
+	fprintf (out, "      \"median_ns\": %llu,\n", (unsigned long long) result->median_elapsed);
+	fprintf (out, "      \"min_ns\": %llu,\n", (unsigned long long) result->min_elapsed);
+	fprintf (out, "      \"mean_ns\": %.0f,\n", result->mean_elapsed);
+	fprintf (out, "      \"ns_per_op\": %.3f,\n",
+		 (pdouble) result->median_elapsed / (pdouble) result->iterations);
+	fprintf (out, "      \"ops_per_sec\": %.1f", (pdouble) result->iterations / seconds);
+
+	if (result->bytes > 0) {
+		fprintf (out, ",\n      \"bytes\": %llu,\n", (unsigned long long) result->bytes);
+		fprintf (out, "      \"mb_per_sec\": %.2f", (pdouble) result->bytes / seconds / (1024.0 * 1024.0));
+	}
+
+	fprintf (out, "\n    }");
+}
+
+static void pbench_print_usage (const pchar *name)
+{
+	fprintf (stderr, "Usage: %s [options]\n", name);
+	fprintf (stderr, "  --list               List available benchmarks\n");
+	fprintf (stderr, "  --filter <pattern>   Run only benchmarks containing the pattern\n");
+	fprintf (stderr, "  --repetitions <num>  Number of measured runs, default is %d\n", PBENCH_DEFAULT_REPETITIONS);
+	fprintf (stderr, "  --scale <factor>     Multiply default number of iterations\n");
+	fprintf (stderr, "  --output <file>      Write JSON results into the file instead of stdout\n");
+}
+
+int main (int argc, char **argv)
+{
+	const PBenchCase	*bench_case;
+	const pchar		*filter      = NULL;
+	const pchar		*output      = NULL;
+	pdouble			scale        = 1.0;
+	pint			repetitions  = PBENCH_DEFAULT_REPETITIONS;
+	pboolean		list_only    = FALSE;
+	pboolean		is_first     = TRUE;
+	pint			failed_count = 0;
+	FILE			*out         = stdout;
+	PBenchResult		result;
+	pint			i, j;
+
+	for (i = 1; i < argc; ++i) {
+		if (strcmp (argv[i], "--list") == 0)
+			list_only = TRUE;
+		else if (strcmp (argv[i], "--filter") == 0 && i + 1 < argc)
+			filter = argv[++i];
+		else if (strcmp (argv[i], "--repetitions") == 0 && i + 1 < argc)
+			repetitions = atoi (argv[++i]);
+		else if (strcmp (argv[i], "--scale") == 0 && i + 1 < argc)
+			scale = atof (argv[++i]);
+		else if (strcmp (argv[i], "--output") == 0 && i + 1 < argc)
+			output = argv[++i];
+		else {
+			pbench_print_usage (argv[0]);
+			return 1;
+		}
+	}
+
+	if (repetitions <= 0 || scale <= 0.0) {
+		pbench_print_usage (argv[0]);
+		return 1;
+	}
+
+	p_libsys_init ();
+
+	if (list_only == TRUE) {
+		for (i = 0; pbench_all_cases[i] != NULL; ++i)
+			for (j = 0; pbench_all_cases[i][j].name != NULL; ++j)
+				printf ("%s\n", pbench_all_cases[i][j].name);
+
+		p_libsys_shutdown ();
+		return 0;
+	}
+
+	if (output != NULL && (out = fopen (output, "w")) == NULL) {
+		fprintf (stderr, "Failed to open output file %s\n", output);
+		p_libsys_shutdown ();
+		return 1;
+	}
+
+	fprintf (out, "{\n");
+	fprintf (out, "  \"library\": \"plibsys\",\n");
+	fprintf (out, "  \"version\": \"%s\",\n", p_libsys_version ());
+	fprintf (out, "  \"timestamp\": %lld,\n", (long long) time (NULL));
+	fprintf (out, "  \"threads\": %d,\n", pbench_get_threads_count ());
+	fprintf (out, "  \"repetitions\": %d,\n", repetitions);
+	fprintf (out, "  \"benchmarks\": [");
+
+	for (i = 0; pbench_all_cases[i] != NULL; ++i) {
+		for (j = 0; pbench_all_cases[i][j].name != NULL; ++j) {
+			bench_case = &pbench_all_cases[i][j];
+
+			if (filter != NULL && strstr (bench_case->name, filter) == NULL)
+				continue;
+
+			if (pbench_run_case (bench_case, scale, repetitions, &result) == FALSE) {
+				fprintf (stderr, "%-40s FAILED\n", bench_case->name);
+				++failed_count;
+				continue;
+			}
+
+			fprintf (stderr, "%-40s %12.3f ns/op\n",
+				 bench_case->name,
+				 (pdouble) result.median_elapsed / (pdouble) result.iterations);
+
+			pbench_print_result (out, &result, is_first);
+			is_first = FALSE;
+		}
+	}
+
+	fprintf (out, "\n  ]\n}\n");
+
+	if (out != stdout)
+		fclose (out);
+
+	p_libsys_shutdown ();
+
+	return failed_count == 0 ? 0 : 1;
+}
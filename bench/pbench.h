@@ -0,0 +1,97 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pbench.h
+ * @brief Benchmark framework
+ * @author Alexander Saprykin
+ *
+ * Every benchmark is a function which performs a given number of iterations
+ * of some operation and measures time spent on them with pbench_start() and
+ * pbench_stop() calls, so any preparation work can be excluded from the
+ * measurement. Benchmarks are grouped into NULL-terminated tables which are
+ * exported by every benchmark module and run from the main routine.
+ */
+
+#ifndef PLIBSYS_HEADER_PBENCH_H
+#define PLIBSYS_HEADER_PBENCH_H
+
+#include "plibsys.h"
+
+/** Benchmark run state, passed to every benchmark function. */
+typedef struct PBenchRun_ {
+	puint64		iterations;	/**< Number of iterations to perform.		*/
+	puint64		elapsed;	/**< Measured time, in nanoseconds.		*/
+	puint64		bytes;		/**< Number of processed bytes, 0 if none.	*/
+	puint64		start_ticks;	/**< Ticks value at the measurement start.	*/
+} PBenchRun;
+
+/**
+ * @brief Benchmark function.
+ * @param run Benchmark run state.
+ * @return TRUE in case of success, FALSE otherwise.
+ */
+typedef pboolean (*PBenchFunc) (PBenchRun *run);
+
+/** Benchmark description. */
+typedef struct PBenchCase_ {
+	const pchar	*name;		/**< Unique benchmark name.			*/
+	PBenchFunc	func;		/**< Benchmark function.			*/
+	puint64		iterations;	/**< Default number of iterations.		*/
+} PBenchCase;
+
+extern const PBenchCase pbench_containers_cases[];
+extern const PBenchCase pbench_sync_cases[];
+extern const PBenchCase pbench_ipc_cases[];
+extern const PBenchCase pbench_crypto_cases[];
+
+/**
+ * @brief Starts time measurement.
+ * @param run Benchmark run state.
+ */
+void pbench_start (PBenchRun *run);
+
+/**
+ * @brief Stops time measurement and accumulates elapsed time.
+ * @param run Benchmark run state.
+ *
+ * Measurement can be started and stopped several times during a single run.
+ */
+void pbench_stop (PBenchRun *run);
+
+/**
+ * @brief Gets a number of threads to use for contention benchmarks.
+ * @return Number of threads, at least 2.
+ */
+pint pbench_get_threads_count (void);
+
+/**
+ * @brief Gets a next value of a deterministic pseudo-random sequence.
+ * @param state Sequence state, must be initialized with a seed value.
+ * @return Next pseudo-random value.
+ */
+puint32 pbench_random (puint32 *state);
+
+#endif /* PLIBSYS_HEADER_PBENCH_H */
@@ -0,0 +1,305 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pbench.h"
+
+#define PBENCH_RANDOM_SEED 0x2545F491
+
+static ppointer * pbench_create_keys (puint64 count)
+{
+	ppointer	*keys;
+	puint32		state = PBENCH_RANDOM_SEED;
+	puint64		i;
+
+	if ((keys = (ppointer *) p_malloc (sizeof (ppointer) * (psize) count)) == NULL)
+		return NULL;
+
+	/* Unique keys in a random order */
+	for (i = 0; i < count; ++i)
+		keys[i] = P_INT_TO_POINTER ((pint) (i + 1));
+
+	for (i = count - 1; i > 0; --i) {
+		puint64		j   = pbench_random (&state) % (i + 1);
+		ppointer	tmp = keys[i];
+
+		keys[i] = keys[j];
+		keys[j] = tmp;
+	}
+
+	return keys;
+}
+
+static pint pbench_tree_compare (pconstpointer a, pconstpointer b)
+{
+	pint val_a = P_POINTER_TO_INT (a);
+	pint val_b = P_POINTER_TO_INT (b);
+
+	return val_a < val_b ? -1 : (val_a > val_b ? 1 : 0);
+}
+
+static pboolean pbench_hash_table (PBenchRun *run, pint op)
+{
+	PHashTable	*table;
+	ppointer	*keys;
+	puint64		i;
+
+	if ((keys = pbench_create_keys (run->iterations)) == NULL)
+		return FALSE;
+
+	if ((table = p_hash_table_new ()) == NULL) {
+		p_free (keys);
+		return FALSE;
+	}
+
+	if (op == 0)
+		pbench_start (run);
+
+	for (i = 0; i < run->iterations; ++i)
+		p_hash_table_insert (table, keys[i], keys[i]);
+
+	if (op == 0)
+		pbench_stop (run);
+	else if (op == 1) {
+		pbench_start (run);
+
+		for (i = 0; i < run->iterations; ++i)
+			if (p_hash_table_lookup (table, keys[i]) != keys[i])
+				break;
+
+		pbench_stop (run);
+	} else {
+		pbench_start (run);
+
+		for (i = 0; i < run->iterations; ++i)
+			p_hash_table_remove (table, keys[i]);
+
+		pbench_stop (run);
+	}
+
+	p_hash_table_free (table);
+	p_free (keys);
+
+	return i == run->iterations ? TRUE : FALSE;
+}
+
+static pboolean pbench_hash_table_insert (PBenchRun *run)
+{
+	return pbench_hash_table (run, 0);
+}
+
+static pboolean pbench_hash_table_lookup (PBenchRun *run)
+{
+	return pbench_hash_table (run, 1);
+}
+
+static pboolean pbench_hash_table_remove (PBenchRun *run)
+{
+	return pbench_hash_table (run, 2);
+}
+
+static pboolean pbench_tree (PBenchRun *run, PTreeType type, pint op)
+{
+	PTree		*tree;
+	ppointer	*keys;
+	puint64		i;
+
+	if ((keys = pbench_create_keys (run->iterations)) == NULL)
+		return FALSE;
+
+	if ((tree = p_tree_new (type, (PCompareFunc) pbench_tree_compare)) == NULL) {
+		p_free (keys);
+		return FALSE;
+	}
+
+	if (op == 0)
+		pbench_start (run);
+
+	for (i = 0; i < run->iterations; ++i)
+		p_tree_insert (tree, keys[i], keys[i]);
+
+	if (op == 0)
+		pbench_stop (run);
+	else if (op == 1) {
+		pbench_start (run);
+
+		for (i = 0; i < run->iterations; ++i)
+			if (p_tree_lookup (tree, keys[i]) != keys[i])
+				break;
+
+		pbench_stop (run);
+	} else {
+		pbench_start (run);
+
+		for (i = 0; i < run->iterations; ++i)
+			if (p_tree_remove (tree, keys[i]) == FALSE)
+				break;
+
+		pbench_stop (run);
+	}
+
+	p_tree_free (tree);
+	p_free (keys);
+
+	return i == run->iterations ? TRUE : FALSE;
+}
+
+static pboolean pbench_tree_bst_insert (PBenchRun *run)
+{
+	return pbench_tree (run, P_TREE_TYPE_BINARY, 0);
+}
+
+static pboolean pbench_tree_bst_lookup (PBenchRun *run)
+{
+	return pbench_tree (run, P_TREE_TYPE_BINARY, 1);
+}
+
+static pboolean pbench_tree_bst_remove (PBenchRun *run)
+{
+	return pbench_tree (run, P_TREE_TYPE_BINARY, 2);
+}
+
+static pboolean pbench_tree_rb_insert (PBenchRun *run)
+{
+	return pbench_tree (run, P_TREE_TYPE_RB, 0);
+}
+
+static pboolean pbench_tree_rb_lookup (PBenchRun *run)
+{
+	return pbench_tree (run, P_TREE_TYPE_RB, 1);
+}
+
+static pboolean pbench_tree_rb_remove (PBenchRun *run)
+{
+	return pbench_tree (run, P_TREE_TYPE_RB, 2);
+}
+
+static pboolean pbench_tree_avl_insert (PBenchRun *run)
+{
+	return pbench_tree (run, P_TREE_TYPE_AVL, 0);
+}
+
+static pboolean pbench_tree_avl_lookup (PBenchRun *run)
+{
+	return pbench_tree (run, P_TREE_TYPE_AVL, 1);
+}
+
+static pboolean pbench_tree_avl_remove (PBenchRun *run)
+{
+	return pbench_tree (run, P_TREE_TYPE_AVL, 2);
+}
+
+static pboolean pbench_list_prepend (PBenchRun *run)
+{
+	PList	*list = NULL;
+	puint64	i;
+
+	pbench_start (run);
+
+	for (i = 0; i < run->iterations; ++i)
+		list = p_list_prepend (list, P_INT_TO_POINTER ((pint) i));
+
+	pbench_stop (run);
+
+	p_list_free (list);
+
+	return TRUE;
+}
+
+static pboolean pbench_list_append (PBenchRun *run)
+{
+	PList	*list = NULL;
+	puint64	i;
+
+	pbench_start (run);
+
+	for (i = 0; i < run->iterations; ++i)
+		list = p_list_append (list, P_INT_TO_POINTER ((pint) i));
+
+	pbench_stop (run);
+
+	p_list_free (list);
+
+	return TRUE;
+}
+
+static void pbench_list_foreach_func (ppointer data, ppointer user_data)
+{
+	*((puint64 *) user_data) += (puint64) P_POINTER_TO_INT (data);
+}
+
+static pboolean pbench_list_foreach (PBenchRun *run)
+{
+	PList	*list = NULL;
+	puint64	sum   = 0;
+	puint64	i;
+
+	for (i = 0; i < run->iterations; ++i)
+		list = p_list_prepend (list, P_INT_TO_POINTER ((pint) i));
+
+	pbench_start (run);
+	p_list_foreach (list, (PFunc) pbench_list_foreach_func, &sum);
+	pbench_stop (run);
+
+	p_list_free (list);
+
+	return sum == run->iterations * (run->iterations - 1) / 2 ? TRUE : FALSE;
+}
+
+static pboolean pbench_list_reverse (PBenchRun *run)
+{
+	PList	*list = NULL;
+	puint64	i;
+
+	for (i = 0; i < run->iterations; ++i)
+		list = p_list_prepend (list, P_INT_TO_POINTER ((pint) i));
+
+	pbench_start (run);
+	list = p_list_reverse (list);
+	pbench_stop (run);
+
+	p_list_free (list);
+
+	return TRUE;
+}
+
+const PBenchCase pbench_containers_cases[] = {
+	{"phashtable_insert",	pbench_hash_table_insert,	5000},
+	{"phashtable_lookup",	pbench_hash_table_lookup,	5000},
+	{"phashtable_remove",	pbench_hash_table_remove,	5000},
+	{"ptree_bst_insert",	pbench_tree_bst_insert,		200000},
+	{"ptree_bst_lookup",	pbench_tree_bst_lookup,		200000},
+	{"ptree_bst_remove",	pbench_tree_bst_remove,		200000},
+	{"ptree_rb_insert",	pbench_tree_rb_insert,		200000},
+	{"ptree_rb_lookup",	pbench_tree_rb_lookup,		200000},
+	{"ptree_rb_remove",	pbench_tree_rb_remove,		200000},
+	{"ptree_avl_insert",	pbench_tree_avl_insert,		200000},
+	{"ptree_avl_lookup",	pbench_tree_avl_lookup,		200000},
+	{"ptree_avl_remove",	pbench_tree_avl_remove,		200000},
+	{"plist_prepend",	pbench_list_prepend,		1000000},
+	{"plist_append",	pbench_list_append,		5000},
+	{"plist_foreach",	pbench_list_foreach,		1000000},
+	{"plist_reverse",	pbench_list_reverse,		1000000},
+	{NULL,			NULL,				0}
+};
@@ -0,0 +1,110 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pbench.h"
+
+#define PBENCH_CRYPTO_CHUNK_SIZE (64 * 1024)
+
+static pboolean pbench_crypto_hash (PBenchRun *run, PCryptoHashType type)
+{
+	PCryptoHash	*hash;
+	puchar		*chunk;
+	puchar		digest[64];
+	psize		len = sizeof (digest);
+	puint64		i;
+
+	if ((chunk = (puchar *) p_malloc (PBENCH_CRYPTO_CHUNK_SIZE)) == NULL)
+		return FALSE;
+
+	for (i = 0; i < PBENCH_CRYPTO_CHUNK_SIZE; ++i)
+		chunk[i] = (puchar) (i * 31);
+
+	if ((hash = p_crypto_hash_new (type)) == NULL) {
+		p_free (chunk);
+		return FALSE;
+	}
+
+	pbench_start (run);
+
+	for (i = 0; i < run->iterations; ++i)
+		p_crypto_hash_update (hash, chunk, PBENCH_CRYPTO_CHUNK_SIZE);
+
+	p_crypto_hash_get_digest (hash, digest, &len);
+
+	pbench_stop (run);
+
+	run->bytes = run->iterations * PBENCH_CRYPTO_CHUNK_SIZE;
+
+	p_crypto_hash_free (hash);
+	p_free (chunk);
+
+	return len > 0 ? TRUE : FALSE;
+}
+
+static pboolean pbench_crypto_hash_md5 (PBenchRun *run)
+{
+	return pbench_crypto_hash (run, P_CRYPTO_HASH_TYPE_MD5);
+}
+
+static pboolean pbench_crypto_hash_sha1 (PBenchRun *run)
+{
+	return pbench_crypto_hash (run, P_CRYPTO_HASH_TYPE_SHA1);
+}
+
+static pboolean pbench_crypto_hash_sha2_256 (PBenchRun *run)
+{
+	return pbench_crypto_hash (run, P_CRYPTO_HASH_TYPE_SHA2_256);
+}
+
+static pboolean pbench_crypto_hash_sha2_512 (PBenchRun *run)
+{
+	return pbench_crypto_hash (run, P_CRYPTO_HASH_TYPE_SHA2_512);
+}
+
+static pboolean pbench_crypto_hash_sha3_256 (PBenchRun *run)
+{
+	return pbench_crypto_hash (run, P_CRYPTO_HASH_TYPE_SHA3_256);
+}
+
+static pboolean pbench_crypto_hash_sha3_512 (PBenchRun *run)
+{
+	return pbench_crypto_hash (run, P_CRYPTO_HASH_TYPE_SHA3_512);
+}
+
+static pboolean pbench_crypto_hash_gost (PBenchRun *run)
+{
+	return pbench_crypto_hash (run, P_CRYPTO_HASH_TYPE_GOST);
+}
+
+const PBenchCase pbench_crypto_cases[] = {
+	{"pcryptohash_md5",		pbench_crypto_hash_md5,		2000},
+	{"pcryptohash_sha1",		pbench_crypto_hash_sha1,	2000},
+	{"pcryptohash_sha2_256",	pbench_crypto_hash_sha2_256,	1000},
+	{"pcryptohash_sha2_512",	pbench_crypto_hash_sha2_512,	1000},
+	{"pcryptohash_sha3_256",	pbench_crypto_hash_sha3_256,	1000},
+	{"pcryptohash_sha3_512",	pbench_crypto_hash_sha3_512,	1000},
+	{"pcryptohash_gost",		pbench_crypto_hash_gost,	200},
+	{NULL,				NULL,				0}
+};
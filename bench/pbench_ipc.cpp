@@ -0,0 +1,270 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pbench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define PBENCH_SHM_BUFFER_SIZE	(1024 * 1024)
+#define PBENCH_SHM_CHUNK_SIZE	4096
+#define PBENCH_SOCKET_CHUNK_SIZE	(64 * 1024)
+#define PBENCH_SOCKET_FILE_NAME		"plibsys_bench_send_file.bin"
+
+typedef pboolean (*PBenchSocketSendFunc) (PSocket *socket, ppointer arg);
+
+typedef struct PBenchSocketData_ {
+	PSocket		*server;
+	puint64		total_bytes;
+	puint64		received_bytes;
+} PBenchSocketData;
+
+static pboolean pbench_shm_buffer (PBenchRun *run)
+{
+	PShmBuffer	*buf;
+	pchar		name[64];
+	pchar		*chunk;
+	puint64		i;
+	pboolean	result = TRUE;
+
+	snprintf (name, sizeof (name), "plibsys_bench_shm_%d", (pint) p_process_get_current_pid ());
+
+	if ((chunk = (pchar *) p_malloc0 (PBENCH_SHM_CHUNK_SIZE)) == NULL)
+		return FALSE;
+
+	if ((buf = p_shm_buffer_new (name, PBENCH_SHM_BUFFER_SIZE, NULL)) == NULL) {
+		p_free (chunk);
+		return FALSE;
+	}
+
+	p_shm_buffer_take_ownership (buf);
+
+	pbench_start (run);
+
+	for (i = 0; i < run->iterations; ++i) {
+		if (p_shm_buffer_write (buf, chunk, PBENCH_SHM_CHUNK_SIZE, NULL) != PBENCH_SHM_CHUNK_SIZE ||
+		    p_shm_buffer_read (buf, chunk, PBENCH_SHM_CHUNK_SIZE, NULL) != PBENCH_SHM_CHUNK_SIZE) {
+			result = FALSE;
+			break;
+		}
+	}
+
+	pbench_stop (run);
+
+	run->bytes = run->iterations * PBENCH_SHM_CHUNK_SIZE;
+
+	p_shm_buffer_free (buf);
+	p_free (chunk);
+
+	return result;
+}
+
+static ppointer pbench_socket_receiver_thread (ppointer arg)
+{
+	PBenchSocketData	*data = (PBenchSocketData *) arg;
+	PSocket			*client;
+	pchar			*buffer;
+	pssize			received;
+
+	if ((buffer = (pchar *) p_malloc0 (PBENCH_SOCKET_CHUNK_SIZE)) == NULL)
+		return NULL;
+
+	if ((client = p_socket_accept (data->server, NULL)) == NULL) {
+		p_free (buffer);
+		return NULL;
+	}
+
+	while (data->received_bytes < data->total_bytes) {
+		received = p_socket_receive (client, buffer, PBENCH_SOCKET_CHUNK_SIZE, NULL);
+
+		if (received <= 0)
+			break;
+
+		data->received_bytes += (puint64) received;
+	}
+
+	p_socket_free (client);
+	p_free (buffer);
+
+	return NULL;
+}
+
+static pboolean pbench_socket_send_buffer (PSocket *socket, ppointer arg)
+{
+	const pchar	*buffer = (const pchar *) arg;
+	psize		sent    = 0;
+	pssize		res;
+
+	while (sent < PBENCH_SOCKET_CHUNK_SIZE) {
+		if ((res = p_socket_send (socket, buffer + sent, PBENCH_SOCKET_CHUNK_SIZE - sent, NULL)) <= 0)
+			return FALSE;
+
+		sent += (psize) res;
+	}
+
+	return TRUE;
+}
+
+static pboolean pbench_socket_send_file (PSocket *socket, ppointer arg)
+{
+	pint fd = *((pint *) arg);
+
+	return p_socket_send_file (socket, fd, 0, PBENCH_SOCKET_CHUNK_SIZE, NULL) == PBENCH_SOCKET_CHUNK_SIZE;
+}
+
+static pboolean pbench_socket_tcp_transfer (PBenchRun *run, PBenchSocketSendFunc send_func, ppointer send_arg)
+{
+	PBenchSocketData	data;
+	PSocketAddress		*addr;
+	PSocket			*client;
+	PUThread		*receiver;
+	puint64			i;
+	pboolean		result = TRUE;
+
+	memset (&data, 0, sizeof (data));
+
+	data.total_bytes = run->iterations * PBENCH_SOCKET_CHUNK_SIZE;
+
+	if ((data.server = p_socket_new (P_SOCKET_FAMILY_INET,
+					 P_SOCKET_TYPE_STREAM,
+					 P_SOCKET_PROTOCOL_TCP,
+					 NULL)) == NULL)
+		return FALSE;
+
+	if ((addr = p_socket_address_new ("127.0.0.1", 0)) == NULL) {
+		p_socket_free (data.server);
+		return FALSE;
+	}
+
+	if (p_socket_bind (data.server, addr, FALSE, NULL) == FALSE ||
+	    p_socket_listen (data.server, NULL) == FALSE) {
+		p_socket_address_free (addr);
+		p_socket_free (data.server);
+		return FALSE;
+	}
+
+	p_socket_address_free (addr);
+
+	/* Do not hang forever if the client fails to connect */
+	p_socket_set_timeout (data.server, 10000);
+
+	if ((addr = p_socket_get_local_address (data.server, NULL)) == NULL) {
+		p_socket_free (data.server);
+		return FALSE;
+	}
+
+	if ((receiver = p_uthread_create ((PUThreadFunc) pbench_socket_receiver_thread,
+					  &data,
+					  TRUE,
+					  NULL)) == NULL) {
+		p_socket_address_free (addr);
+		p_socket_free (data.server);
+		return FALSE;
+	}
+
+	if ((client = p_socket_new (P_SOCKET_FAMILY_INET,
+				    P_SOCKET_TYPE_STREAM,
+				    P_SOCKET_PROTOCOL_TCP,
+				    NULL)) == NULL ||
+	    p_socket_connect (client, addr, NULL) == FALSE)
+		result = FALSE;
+
+	pbench_start (run);
+
+	for (i = 0; result == TRUE && i < run->iterations; ++i)
+		result = send_func (client, send_arg);
+
+	if (client != NULL)
+		p_socket_shutdown (client, FALSE, TRUE, NULL);
+
+	p_uthread_join (receiver);
+
+	pbench_stop (run);
+
+	run->bytes = data.received_bytes;
+
+	if (data.received_bytes != data.total_bytes)
+		result = FALSE;
+
+	p_uthread_unref (receiver);
+	p_socket_free (client);
+	p_socket_address_free (addr);
+	p_socket_free (data.server);
+
+	return result;
+}
+
+static pboolean pbench_socket_tcp_loopback (PBenchRun *run)
+{
+	pchar		*buffer;
+	pboolean	result;
+
+	if ((buffer = (pchar *) p_malloc0 (PBENCH_SOCKET_CHUNK_SIZE)) == NULL)
+		return FALSE;
+
+	result = pbench_socket_tcp_transfer (run, pbench_socket_send_buffer, buffer);
+
+	p_free (buffer);
+
+	return result;
+}
+
+static pboolean pbench_socket_tcp_send_file (PBenchRun *run)
+{
+	FILE		*file;
+	pchar		*buffer;
+	pint		fd;
+	pboolean	result = FALSE;
+
+	if ((buffer = (pchar *) p_malloc0 (PBENCH_SOCKET_CHUNK_SIZE)) == NULL)
+		return FALSE;
+
+	if ((file = fopen (PBENCH_SOCKET_FILE_NAME, "wb")) != NULL) {
+		result = fwrite (buffer, 1, PBENCH_SOCKET_CHUNK_SIZE, file) == PBENCH_SOCKET_CHUNK_SIZE;
+		fclose (file);
+	}
+
+	p_free (buffer);
+
+	if (result == FALSE || (file = fopen (PBENCH_SOCKET_FILE_NAME, "rb")) == NULL) {
+		p_file_remove (PBENCH_SOCKET_FILE_NAME, NULL);
+		return FALSE;
+	}
+
+	fd     = fileno (file);
+	result = pbench_socket_tcp_transfer (run, pbench_socket_send_file, &fd);
+
+	fclose (file);
+	p_file_remove (PBENCH_SOCKET_FILE_NAME, NULL);
+
+	return result;
+}
+
+const PBenchCase pbench_ipc_cases[] = {
+	{"pshmbuffer_write_read",	pbench_shm_buffer,		100000},
+	{"psocket_tcp_loopback",	pbench_socket_tcp_loopback,	20000},
+	{"psocket_tcp_send_file",	pbench_socket_tcp_send_file,	20000},
+	{NULL,				NULL,				0}
+};
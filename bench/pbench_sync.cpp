@@ -0,0 +1,331 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pbench.h"
+
+#include <string.h>
+
+typedef pboolean (*PBenchLockFunc) (ppointer lock);
+
+typedef struct PBenchContentionData_ {
+	ppointer	lock;
+	PBenchLockFunc	lock_func;
+	PBenchLockFunc	unlock_func;
+	PBenchLockFunc	read_lock_func;
+	PBenchLockFunc	read_unlock_func;
+	puint64		iterations;
+	volatile pint	ready_count;
+	volatile pint	start_flag;
+	volatile pint	atomic_value;
+	volatile puint64 value;
+} PBenchContentionData;
+
+static pboolean pbench_atomic_int_inc (PBenchRun *run)
+{
+	volatile pint	value = 0;
+	puint64		i;
+
+	pbench_start (run);
+
+	for (i = 0; i < run->iterations; ++i)
+		p_atomic_int_inc (&value);
+
+	pbench_stop (run);
+
+	return TRUE;
+}
+
+static pboolean pbench_atomic_int_add (PBenchRun *run)
+{
+	volatile pint	value = 0;
+	puint64		i;
+
+	pbench_start (run);
+
+	for (i = 0; i < run->iterations; ++i)
+		(void) p_atomic_int_add (&value, 1);
+
+	pbench_stop (run);
+
+	return TRUE;
+}
+
+static pboolean pbench_atomic_int_cas (PBenchRun *run)
+{
+	volatile pint	value = 0;
+	puint64		i;
+
+	pbench_start (run);
+
+	for (i = 0; i < run->iterations; ++i)
+		(void) p_atomic_int_compare_and_exchange (&value, (pint) (i & 1), (pint) ((i + 1) & 1));
+
+	pbench_stop (run);
+
+	return TRUE;
+}
+
+static pboolean pbench_atomic_pointer_add (PBenchRun *run)
+{
+	volatile psize	value = 0;
+	puint64		i;
+
+	pbench_start (run);
+
+	for (i = 0; i < run->iterations; ++i)
+		(void) p_atomic_pointer_add (&value, 1);
+
+	pbench_stop (run);
+
+	return TRUE;
+}
+
+static pboolean pbench_counter_inc (PBenchRun *run)
+{
+	PCounter	*counter;
+	puint64		i;
+
+	if ((counter = p_counter_new (P_COUNTER_TYPE_SUM)) == NULL)
+		return FALSE;
+
+	pbench_start (run);
+
+	for (i = 0; i < run->iterations; ++i)
+		p_counter_inc (counter);
+
+	pbench_stop (run);
+
+	p_counter_free (counter);
+
+	return TRUE;
+}
+
+static void pbench_contention_wait_start (PBenchContentionData *data)
+{
+	p_atomic_int_inc (&data->ready_count);
+
+	while (p_atomic_int_get (&data->start_flag) == 0)
+		p_uthread_yield ();
+}
+
+static ppointer pbench_lock_thread (ppointer arg)
+{
+	PBenchContentionData	*data = (PBenchContentionData *) arg;
+	puint64			i;
+
+	pbench_contention_wait_start (data);
+
+	for (i = 0; i < data->iterations; ++i) {
+		if (data->read_lock_func != NULL && (i % 10) != 0) {
+			/* Readers take 90% of operations */
+			data->read_lock_func (data->lock);
+			(void) data->value;
+			data->read_unlock_func (data->lock);
+		} else {
+			data->lock_func (data->lock);
+			++data->value;
+			data->unlock_func (data->lock);
+		}
+	}
+
+	return NULL;
+}
+
+static ppointer pbench_atomic_thread (ppointer arg)
+{
+	PBenchContentionData	*data = (PBenchContentionData *) arg;
+	puint64			i;
+
+	pbench_contention_wait_start (data);
+
+	for (i = 0; i < data->iterations; ++i)
+		p_atomic_int_inc (&data->atomic_value);
+
+	return NULL;
+}
+
+static ppointer pbench_counter_thread (ppointer arg)
+{
+	PBenchContentionData	*data = (PBenchContentionData *) arg;
+	puint64			i;
+
+	pbench_contention_wait_start (data);
+
+	for (i = 0; i < data->iterations; ++i)
+		p_counter_inc ((PCounter *) data->lock);
+
+	return NULL;
+}
+
+static pboolean pbench_contention (PBenchRun *run, PUThreadFunc func, PBenchContentionData *data)
+{
+	PUThread	**threads;
+	pint		threads_count;
+	pint		i;
+
+	threads_count    = pbench_get_threads_count ();
+	data->iterations = run->iterations / (puint64) threads_count + 1;
+
+	if ((threads = (PUThread **) p_malloc0 (sizeof (PUThread *) * (psize) threads_count)) == NULL)
+		return FALSE;
+
+	for (i = 0; i < threads_count; ++i) {
+		if ((threads[i] = p_uthread_create (func, data, TRUE, NULL)) == NULL)
+			break;
+	}
+
+	if (i < threads_count) {
+		p_atomic_int_set (&data->start_flag, 1);
+
+		while (--i >= 0) {
+			p_uthread_join (threads[i]);
+			p_uthread_unref (threads[i]);
+		}
+
+		p_free (threads);
+		return FALSE;
+	}
+
+	while (p_atomic_int_get (&data->ready_count) < threads_count)
+		p_uthread_yield ();
+
+	pbench_start (run);
+
+	p_atomic_int_set (&data->start_flag, 1);
+
+	for (i = 0; i < threads_count; ++i)
+		p_uthread_join (threads[i]);
+
+	pbench_stop (run);
+
+	for (i = 0; i < threads_count; ++i)
+		p_uthread_unref (threads[i]);
+
+	p_free (threads);
+
+	return TRUE;
+}
+
+static pboolean pbench_mutex_contention (PBenchRun *run)
+{
+	PBenchContentionData	data;
+	pboolean		result;
+
+	memset (&data, 0, sizeof (data));
+
+	if ((data.lock = p_mutex_new ()) == NULL)
+		return FALSE;
+
+	data.lock_func   = (PBenchLockFunc) p_mutex_lock;
+	data.unlock_func = (PBenchLockFunc) p_mutex_unlock;
+
+	result = pbench_contention (run, (PUThreadFunc) pbench_lock_thread, &data);
+
+	p_mutex_free ((PMutex *) data.lock);
+
+	return result;
+}
+
+static pboolean pbench_spinlock_contention (PBenchRun *run)
+{
+	PBenchContentionData	data;
+	pboolean		result;
+
+	memset (&data, 0, sizeof (data));
+
+	if ((data.lock = p_spinlock_new ()) == NULL)
+		return FALSE;
+
+	data.lock_func   = (PBenchLockFunc) p_spinlock_lock;
+	data.unlock_func = (PBenchLockFunc) p_spinlock_unlock;
+
+	result = pbench_contention (run, (PUThreadFunc) pbench_lock_thread, &data);
+
+	p_spinlock_free ((PSpinLock *) data.lock);
+
+	return result;
+}
+
+static pboolean pbench_rwlock_contention (PBenchRun *run)
+{
+	PBenchContentionData	data;
+	pboolean		result;
+
+	memset (&data, 0, sizeof (data));
+
+	if ((data.lock = p_rwlock_new ()) == NULL)
+		return FALSE;
+
+	data.lock_func        = (PBenchLockFunc) p_rwlock_writer_lock;
+	data.unlock_func      = (PBenchLockFunc) p_rwlock_writer_unlock;
+	data.read_lock_func   = (PBenchLockFunc) p_rwlock_reader_lock;
+	data.read_unlock_func = (PBenchLockFunc) p_rwlock_reader_unlock;
+
+	result = pbench_contention (run, (PUThreadFunc) pbench_lock_thread, &data);
+
+	p_rwlock_free ((PRWLock *) data.lock);
+
+	return result;
+}
+
+static pboolean pbench_atomic_contention (PBenchRun *run)
+{
+	PBenchContentionData data;
+
+	memset (&data, 0, sizeof (data));
+
+	return pbench_contention (run, (PUThreadFunc) pbench_atomic_thread, &data);
+}
+
+static pboolean pbench_counter_contention (PBenchRun *run)
+{
+	PBenchContentionData	data;
+	pboolean		result;
+
+	memset (&data, 0, sizeof (data));
+
+	if ((data.lock = p_counter_new (P_COUNTER_TYPE_SUM)) == NULL)
+		return FALSE;
+
+	result = pbench_contention (run, (PUThreadFunc) pbench_counter_thread, &data);
+
+	p_counter_free ((PCounter *) data.lock);
+
+	return result;
+}
+
+const PBenchCase pbench_sync_cases[] = {
+	{"patomic_int_inc",		pbench_atomic_int_inc,		10000000},
+	{"patomic_int_add",		pbench_atomic_int_add,		10000000},
+	{"patomic_int_cas",		pbench_atomic_int_cas,		10000000},
+	{"patomic_pointer_add",		pbench_atomic_pointer_add,	10000000},
+	{"pcounter_inc",		pbench_counter_inc,		10000000},
+	{"patomic_int_inc_contention",	pbench_atomic_contention,	10000000},
+	{"pcounter_inc_contention",	pbench_counter_contention,	10000000},
+	{"pmutex_contention",		pbench_mutex_contention,	2000000},
+	{"pspinlock_contention",	pbench_spinlock_contention,	2000000},
+	{"prwlock_contention",		pbench_rwlock_contention,	2000000},
+	{NULL,				NULL,				0}
+};
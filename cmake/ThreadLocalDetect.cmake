@@ -0,0 +1,60 @@
+# The MIT License
+#
+# Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+#
+# Permission is hereby granted, free of charge, to any person obtaining
+# a copy of this software and associated documentation files (the
+# 'Software'), to deal in the Software without restriction, including
+# without limitation the rights to use, copy, modify, merge, publish,
+# distribute, sublicense, and/or sell copies of the Software, and to
+# permit persons to whom the Software is furnished to do so, subject to
+# the following conditions:
+#
+# The above copyright notice and this permission notice shall be
+# included in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+# EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+# MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+# IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+# CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+# TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+# SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+function (plibsys_detect_thread_local result)
+        #
+        # Compiler-native thread-local storage is much faster than the
+        # pthread_getspecific() family of calls, but its keyword depends
+        # on the compiler: GCC-compatible ones use __thread, C11 defines
+        # _Thread_local and MSVC uses __declspec(thread).
+        #
+        set (P_THREAD_LOCAL FALSE)
+        set (P_KEYWORD_INDEX 0)
+
+        foreach (KEYWORD "__thread" "_Thread_local" "__declspec(thread)")
+                math (EXPR P_KEYWORD_INDEX "${P_KEYWORD_INDEX} + 1")
+
+                check_c_source_compiles ("
+                                         static ${KEYWORD} int tls_value = 0;
+
+                                         static int * get_tls_value (void) {
+                                                return &tls_value;
+                                         }
+
+                                         int main () {
+                                                *get_tls_value () = 1;
+                                                return tls_value - 1;
+                                         }"
+                                         PLIBSYS_HAS_THREAD_LOCAL_${P_KEYWORD_INDEX}
+                )
+
+                if (PLIBSYS_HAS_THREAD_LOCAL_${P_KEYWORD_INDEX})
+                        set (P_THREAD_LOCAL ${KEYWORD})
+                        break()
+                endif()
+        endforeach()
+
+        # Assign result
+        set (${result} ${P_THREAD_LOCAL} PARENT_SCOPE)
+
+endfunction (plibsys_detect_thread_local)
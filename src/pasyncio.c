@@ -0,0 +1,1978 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "patomic.h"
+#include "pmutex.h"
+#include "ptimeprofiler.h"
+#include "puthread.h"
+#include "pasyncio.h"
+#include "perror-private.h"
+#include "plibsys-private.h"
+#include "psocket-private.h"
+#include "psysclose-private.h"
+
+#include <string.h>
+
+/* The thread backend requires poll(), see psocket.c for the list of
+ * platforms which lack it */
+#if !defined (P_OS_WIN)  && !defined (P_OS_BEOS) && !defined (P_OS_MAC9) && \
+    !defined (P_OS_OS2)  && !defined (P_OS_AMIGA)
+#  define P_ASYNC_IO_USE_THREAD
+#endif
+
+#if defined (PLIBSYS_HAS_IO_URING) || defined (P_ASYNC_IO_USE_THREAD)
+#  define P_ASYNC_IO_SUPPORTED
+#endif
+
+#ifdef P_ASYNC_IO_SUPPORTED
+#  include <errno.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <poll.h>
+#endif
+
+#ifdef PLIBSYS_HAS_IO_URING
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <linux/io_uring.h>
+#endif
+
+#ifdef MSG_NOSIGNAL
+#  define P_ASYNC_IO_SEND_FLAGS		MSG_NOSIGNAL
+#else
+#  define P_ASYNC_IO_SEND_FLAGS		0
+#endif
+
+/* Largest transfer length for a single operation */
+#define P_ASYNC_IO_MAX_LENGTH		0x7FFFF000
+
+/* io_uring limits for the submission and completion queues */
+#define P_ASYNC_IO_URING_MAX_SQ		4096
+#define P_ASYNC_IO_URING_MAX_CQ		65536
+
+/* User data of the cancel requests, never matches a slot index */
+#define P_ASYNC_IO_URING_CANCEL_DATA	((puint64) -1)
+
+#ifdef P_ASYNC_IO_SUPPORTED
+
+typedef enum PAsyncIOSlotState_ {
+	P_ASYNC_IO_SLOT_STATE_FREE	= 0,	/* Not used					*/
+	P_ASYNC_IO_SLOT_STATE_QUEUED	= 1,	/* Waits for submission				*/
+	P_ASYNC_IO_SLOT_STATE_ACTIVE	= 2,	/* Operation is in progress			*/
+	P_ASYNC_IO_SLOT_STATE_POLLING	= 3,	/* Waits for readiness to retry the operation	*/
+	P_ASYNC_IO_SLOT_STATE_DONE	= 4	/* Completed, waits to be taken			*/
+} PAsyncIOSlotState;
+
+typedef struct PAsyncIOSlot_ {
+	PAsyncIOOperation	operation;
+	PAsyncIOSlotState	state;
+	ppointer		user_data;
+	PSocket			*socket;
+	pint			fd;
+	pchar			*buffer;
+	psize			length;
+	puint64			offset;
+	struct sockaddr_storage	address;
+	socklen_t		address_len;
+	pssize			result;
+	pint			native_error;
+	pint			next;
+} PAsyncIOSlot;
+
+struct PAsyncIO_ {
+	PAsyncIOBackend		backend;
+	PAsyncIOSlot		*slots;
+	pint			capacity;
+	pint			free_head;
+	pint			pending;
+	pint			queued_head;
+	pint			queued_tail;
+	pint			queued_count;
+#ifdef PLIBSYS_HAS_IO_URING
+	pint			ring_fd;
+	puchar			*sq_ring;
+	psize			sq_ring_size;
+	puchar			*cq_ring;
+	psize			cq_ring_size;
+	struct io_uring_sqe	*sqes;
+	psize			sqes_size;
+	volatile puint		*sq_head;
+	volatile puint		*sq_tail;
+	puint			*sq_array;
+	puint			sq_mask;
+	puint			sq_entries;
+	puint			sq_local_tail;
+	volatile puint		*cq_head;
+	volatile puint		*cq_tail;
+	puint			cq_mask;
+	struct io_uring_cqe	*cqes;
+#endif
+#ifdef P_ASYNC_IO_USE_THREAD
+	PUThread		*thread;
+	PMutex			*mutex;
+	pint			wake_pipe[2];
+	pint			notify_pipe[2];
+	pint			incoming_head;
+	pint			incoming_tail;
+	pint			completed_head;
+	pint			completed_tail;
+	pboolean		stop;
+	pint			*waiting;
+	struct pollfd		*pfds;
+#endif
+};
+
+static pint pp_async_io_alloc_slot (PAsyncIO *aio, PAsyncIOOperation operation, ppointer user_data, PError **error);
+static void pp_async_io_free_slot (PAsyncIO *aio, pint index);
+static pboolean pp_async_io_queue_slot (PAsyncIO *aio, pint index, PError **error);
+static void pp_async_io_take_slot (PAsyncIO *aio, pint index, PAsyncIOCompletion *completion);
+static pboolean pp_async_io_wait_fd (pint fd, pint timeout, PError **error);
+static pboolean pp_async_io_socket_would_block (pint err_code);
+static pboolean pp_async_io_queue_operation (PAsyncIO *aio, PAsyncIOOperation operation, PSocket *socket,
+					     pint fd, pchar *buffer, psize buflen, puint64 offset,
+					     PSocketAddress *address, ppointer user_data, PError **error);
+
+#ifdef PLIBSYS_HAS_IO_URING
+static pboolean pp_async_io_uring_init (PAsyncIO *aio, PError **error);
+static void pp_async_io_uring_close (PAsyncIO *aio);
+static struct io_uring_sqe * pp_async_io_uring_get_sqe (PAsyncIO *aio, PError **error);
+static pboolean pp_async_io_uring_prepare (PAsyncIO *aio, pint index, PError **error);
+static pboolean pp_async_io_uring_prepare_poll (PAsyncIO *aio, pint index, PError **error);
+static void pp_async_io_uring_fail_slot (PAsyncIO *aio, pint index, const PError *error,
+					 PAsyncIOCompletion *completion);
+static pint pp_async_io_uring_submit (PAsyncIO *aio, PError **error);
+static pint pp_async_io_uring_reap (PAsyncIO *aio, PAsyncIOCompletion *completions, pint max, pboolean cancel);
+#endif
+
+#ifdef P_ASYNC_IO_USE_THREAD
+static pboolean pp_async_io_thread_init (PAsyncIO *aio, PError **error);
+static void pp_async_io_thread_close (PAsyncIO *aio);
+static pboolean pp_async_io_thread_create_pipe (pint *fds);
+static void pp_async_io_thread_drain_pipe (pint fd);
+static pboolean pp_async_io_thread_execute (PAsyncIO *aio, pint index);
+static void pp_async_io_thread_publish (PAsyncIO *aio, pint head, pint tail);
+static ppointer pp_async_io_thread_worker (ppointer data);
+static pint pp_async_io_thread_submit (PAsyncIO *aio);
+static pint pp_async_io_thread_reap (PAsyncIO *aio, PAsyncIOCompletion *completions, pint max);
+#endif
+
+static pint
+pp_async_io_alloc_slot (PAsyncIO		*aio,
+			PAsyncIOOperation	operation,
+			ppointer		user_data,
+			PError			**error)
+{
+	PAsyncIOSlot	*slot;
+	pint		index;
+
+	if (P_UNLIKELY (aio->free_head < 0)) {
+		p_error_set_error_static_p (error,
+					    (pint) P_ERROR_IO_WOULD_BLOCK,
+					    0,
+					    "Too many asynchronous operations in flight");
+		return -1;
+	}
+
+	index = aio->free_head;
+	slot  = &aio->slots[index];
+
+	aio->free_head = slot->next;
+
+	memset (slot, 0, sizeof (PAsyncIOSlot));
+
+	slot->operation = operation;
+	slot->user_data = user_data;
+	slot->fd        = -1;
+	slot->next      = -1;
+
+	++aio->pending;
+
+	return index;
+}
+
+static void
+pp_async_io_free_slot (PAsyncIO	*aio,
+		       pint		index)
+{
+	aio->slots[index].state = P_ASYNC_IO_SLOT_STATE_FREE;
+	aio->slots[index].next  = aio->free_head;
+
+	aio->free_head = index;
+
+	--aio->pending;
+}
+
+static pboolean
+pp_async_io_queue_slot (PAsyncIO	*aio,
+			pint		index,
+			PError		**error)
+{
+	aio->slots[index].state = P_ASYNC_IO_SLOT_STATE_QUEUED;
+
+#ifdef PLIBSYS_HAS_IO_URING
+	if (aio->backend == P_ASYNC_IO_BACKEND_IO_URING) {
+		if (P_UNLIKELY (pp_async_io_uring_prepare (aio, index, error) == FALSE))
+			return FALSE;
+
+		++aio->queued_count;
+		return TRUE;
+	}
+#endif
+
+	if (aio->queued_tail < 0)
+		aio->queued_head = index;
+	else
+		aio->slots[aio->queued_tail].next = index;
+
+	aio->queued_tail = index;
+
+	++aio->queued_count;
+
+	return TRUE;
+}
+
+static void
+pp_async_io_take_slot (PAsyncIO			*aio,
+		       pint			index,
+		       PAsyncIOCompletion	*completion)
+{
+	PAsyncIOSlot	*slot;
+	PErrorStorage	err_storage;
+	PError		*error;
+	pboolean	failed;
+
+	/* Completions are taken on the hot path, report failures without memory */
+	slot   = &aio->slots[index];
+	error  = p_error_init (&err_storage);
+	failed = FALSE;
+
+	completion->operation    = slot->operation;
+	completion->user_data    = slot->user_data;
+	completion->result       = slot->result;
+	completion->native_error = slot->native_error;
+	completion->error        = P_ERROR_IO_NONE;
+	completion->socket       = NULL;
+
+	if (slot->result >= 0) {
+		switch (slot->operation) {
+		case P_ASYNC_IO_OPERATION_ACCEPT:
+			completion->result = 0;
+
+			if (P_UNLIKELY ((completion->socket = p_socket_new_accepted (slot->socket,
+										     (pint) slot->result,
+										     &error)) == NULL)) {
+				failed = TRUE;
+
+				if (P_UNLIKELY (p_sys_close ((pint) slot->result) != 0))
+					P_WARNING ("PAsyncIO::pp_async_io_take_slot: p_sys_close() failed");
+			}
+			break;
+		case P_ASYNC_IO_OPERATION_CONNECT:
+			/* Gets the actual result if the connection was waited for */
+			failed = (p_socket_check_connect_result (slot->socket, &error) == FALSE);
+			break;
+		default:
+			break;
+		}
+
+		if (P_UNLIKELY (failed == TRUE)) {
+			completion->result       = -1;
+			completion->error        = (PErrorIO) p_error_get_code (error);
+			completion->native_error = p_error_get_native_code (error);
+
+			/* Rare failures are not reported into the storage */
+			if (p_error_get_code (error) == 0)
+				completion->error = P_ERROR_IO_FAILED;
+
+			p_error_clear (error);
+		}
+	} else {
+		completion->result = -1;
+		completion->error  = p_error_get_io_from_system (slot->native_error);
+	}
+
+	pp_async_io_free_slot (aio, index);
+}
+
+static pboolean
+pp_async_io_queue_operation (PAsyncIO			*aio,
+			     PAsyncIOOperation	operation,
+			     PSocket		*socket,
+			     pint		fd,
+			     pchar		*buffer,
+			     psize		buflen,
+			     puint64		offset,
+			     PSocketAddress	*address,
+			     ppointer		user_data,
+			     PError		**error)
+{
+	PAsyncIOSlot	*slot;
+	pint		index;
+
+	if (socket != NULL)
+		fd = p_socket_get_fd (socket);
+
+	if (P_UNLIKELY (fd < 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY ((index = pp_async_io_alloc_slot (aio, operation, user_data, error)) < 0))
+		return FALSE;
+
+	slot = &aio->slots[index];
+
+	slot->socket = socket;
+	slot->fd     = fd;
+	slot->buffer = buffer;
+	slot->length = buflen > P_ASYNC_IO_MAX_LENGTH ? P_ASYNC_IO_MAX_LENGTH : buflen;
+	slot->offset = offset;
+
+	if (address != NULL) {
+		if (P_UNLIKELY (p_socket_address_to_native (address,
+							    &slot->address,
+							    sizeof (slot->address)) == FALSE)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_FAILED,
+					     0,
+					     "Failed to convert socket address to native structure");
+			pp_async_io_free_slot (aio, index);
+			return FALSE;
+		}
+
+		slot->address_len = (socklen_t) p_socket_address_get_native_size (address);
+	}
+
+	if (P_UNLIKELY (pp_async_io_queue_slot (aio, index, error) == FALSE)) {
+		pp_async_io_free_slot (aio, index);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static pboolean
+pp_async_io_wait_fd (pint	fd,
+		     pint	timeout,
+		     PError	**error)
+{
+	struct pollfd	pfd;
+	pint		err_code;
+
+	pfd.fd      = fd;
+	pfd.events  = POLLIN;
+	pfd.revents = 0;
+
+	if (poll (&pfd, 1, timeout) < 0) {
+		err_code = p_error_get_last_system ();
+
+		/* Spurious wake up is fine, the caller checks the time left */
+		if (err_code == EINTR)
+			return TRUE;
+
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (err_code),
+				     err_code,
+				     "Failed to call poll() to wait for completions");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static pboolean
+pp_async_io_socket_would_block (pint err_code)
+{
+#if defined (EWOULDBLOCK) && (EWOULDBLOCK != EAGAIN)
+	if (err_code == EWOULDBLOCK)
+		return TRUE;
+#endif
+	return err_code == EAGAIN || err_code == EINPROGRESS;
+}
+
+#ifdef PLIBSYS_HAS_IO_URING
+static pboolean
+pp_async_io_uring_init (PAsyncIO	*aio,
+			PError		**error)
+{
+	struct io_uring_params	params;
+	struct io_uring_probe	*probe;
+	psize			probe_size;
+	pint			err_code;
+	pint			i;
+
+	static const puchar required_ops[] = {
+		IORING_OP_RECV,
+		IORING_OP_SEND,
+		IORING_OP_ACCEPT,
+		IORING_OP_CONNECT,
+		IORING_OP_READ,
+		IORING_OP_WRITE,
+		IORING_OP_FSYNC,
+		IORING_OP_POLL_ADD,
+		IORING_OP_ASYNC_CANCEL
+	};
+
+	memset (&params, 0, sizeof (params));
+
+	params.flags      = IORING_SETUP_CQSIZE;
+	params.cq_entries = (puint) (aio->capacity > P_ASYNC_IO_URING_MAX_CQ ? P_ASYNC_IO_URING_MAX_CQ
+									      : aio->capacity);
+
+	aio->ring_fd = (pint) syscall (__NR_io_uring_setup,
+				       (puint) (aio->capacity > P_ASYNC_IO_URING_MAX_SQ ? P_ASYNC_IO_URING_MAX_SQ
+											: aio->capacity),
+				       &params);
+
+	if (aio->ring_fd < 0) {
+		err_code = p_error_get_last_system ();
+
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (err_code),
+				     err_code,
+				     "Failed to call io_uring_setup() to create a ring");
+		return FALSE;
+	}
+
+	/* Check all the operations are supported by the kernel */
+	probe_size = sizeof (struct io_uring_probe) + 256 * sizeof (struct io_uring_probe_op);
+
+	if (P_UNLIKELY ((probe = p_malloc0 (probe_size)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for io_uring probe");
+		pp_async_io_uring_close (aio);
+		return FALSE;
+	}
+
+	if (syscall (__NR_io_uring_register, aio->ring_fd, IORING_REGISTER_PROBE, probe, 256) < 0) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_SUPPORTED,
+				     p_error_get_last_system (),
+				     "Failed to probe io_uring operations");
+		p_free (probe);
+		pp_async_io_uring_close (aio);
+		return FALSE;
+	}
+
+	for (i = 0; i < (pint) (sizeof (required_ops) / sizeof (required_ops[0])); ++i) {
+		if (required_ops[i] > probe->last_op ||
+		    (probe->ops[required_ops[i]].flags & IO_URING_OP_SUPPORTED) == 0) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NOT_SUPPORTED,
+					     0,
+					     "Required io_uring operation is not supported by the kernel");
+			p_free (probe);
+			pp_async_io_uring_close (aio);
+			return FALSE;
+		}
+	}
+
+	p_free (probe);
+
+	aio->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof (puint);
+	aio->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof (struct io_uring_cqe);
+	aio->sqes_size    = params.sq_entries * sizeof (struct io_uring_sqe);
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		if (aio->cq_ring_size > aio->sq_ring_size)
+			aio->sq_ring_size = aio->cq_ring_size;
+
+		aio->cq_ring_size = 0;
+	}
+
+	aio->sq_ring = mmap (NULL,
+			     aio->sq_ring_size,
+			     PROT_READ | PROT_WRITE,
+			     MAP_SHARED | MAP_POPULATE,
+			     aio->ring_fd,
+			     IORING_OFF_SQ_RING);
+
+	if (aio->sq_ring == MAP_FAILED) {
+		aio->sq_ring = NULL;
+		goto error_mmap;
+	}
+
+	if (aio->cq_ring_size == 0)
+		aio->cq_ring = aio->sq_ring;
+	else {
+		aio->cq_ring = mmap (NULL,
+				     aio->cq_ring_size,
+				     PROT_READ | PROT_WRITE,
+				     MAP_SHARED | MAP_POPULATE,
+				     aio->ring_fd,
+				     IORING_OFF_CQ_RING);
+
+		if (aio->cq_ring == MAP_FAILED) {
+			aio->cq_ring = NULL;
+			goto error_mmap;
+		}
+	}
+
+	aio->sqes = mmap (NULL,
+			  aio->sqes_size,
+			  PROT_READ | PROT_WRITE,
+			  MAP_SHARED | MAP_POPULATE,
+			  aio->ring_fd,
+			  IORING_OFF_SQES);
+
+	if (aio->sqes == MAP_FAILED) {
+		aio->sqes = NULL;
+		goto error_mmap;
+	}
+
+	aio->sq_head       = (volatile puint *) (aio->sq_ring + params.sq_off.head);
+	aio->sq_tail       = (volatile puint *) (aio->sq_ring + params.sq_off.tail);
+	aio->sq_array      = (puint *) (aio->sq_ring + params.sq_off.array);
+	aio->sq_mask       = *((puint *) (aio->sq_ring + params.sq_off.ring_mask));
+	aio->sq_entries    = params.sq_entries;
+	aio->sq_local_tail = *aio->sq_tail;
+
+	aio->cq_head = (volatile puint *) (aio->cq_ring + params.cq_off.head);
+	aio->cq_tail = (volatile puint *) (aio->cq_ring + params.cq_off.tail);
+	aio->cq_mask = *((puint *) (aio->cq_ring + params.cq_off.ring_mask));
+	aio->cqes    = (struct io_uring_cqe *) (aio->cq_ring + params.cq_off.cqes);
+
+	return TRUE;
+
+error_mmap:
+	err_code = p_error_get_last_system ();
+
+	p_error_set_error_p (error,
+			     (pint) p_error_get_io_from_system (err_code),
+			     err_code,
+			     "Failed to call mmap() to map io_uring queues");
+	pp_async_io_uring_close (aio);
+
+	return FALSE;
+}
+
+static void
+pp_async_io_uring_close (PAsyncIO *aio)
+{
+	if (aio->sqes != NULL)
+		munmap (aio->sqes, aio->sqes_size);
+
+	if (aio->cq_ring != NULL && aio->cq_ring != aio->sq_ring)
+		munmap (aio->cq_ring, aio->cq_ring_size);
+
+	if (aio->sq_ring != NULL)
+		munmap (aio->sq_ring, aio->sq_ring_size);
+
+	if (aio->ring_fd >= 0 && P_UNLIKELY (p_sys_close (aio->ring_fd) != 0))
+		P_WARNING ("PAsyncIO::pp_async_io_uring_close: p_sys_close() failed");
+
+	aio->sqes    = NULL;
+	aio->cq_ring = NULL;
+	aio->sq_ring = NULL;
+	aio->ring_fd = -1;
+}
+
+static struct io_uring_sqe *
+pp_async_io_uring_get_sqe (PAsyncIO	*aio,
+			   PError	**error)
+{
+	struct io_uring_sqe	*sqe;
+	puint			index;
+
+	/* Make room by passing the queued entries to the kernel */
+	if (aio->sq_local_tail - (puint) p_atomic_int_get ((volatile pint *) aio->sq_head) >= aio->sq_entries) {
+		if (P_UNLIKELY (pp_async_io_uring_submit (aio, error) < 0))
+			return NULL;
+
+		if (P_UNLIKELY (aio->sq_local_tail - (puint) p_atomic_int_get ((volatile pint *) aio->sq_head) >=
+				aio->sq_entries)) {
+			p_error_set_error_static_p (error,
+						    (pint) P_ERROR_IO_WOULD_BLOCK,
+						    EAGAIN,
+						    "Submission queue of io_uring is full");
+			return NULL;
+		}
+	}
+
+	index = aio->sq_local_tail & aio->sq_mask;
+	sqe   = &aio->sqes[index];
+
+	aio->sq_array[index] = index;
+	++aio->sq_local_tail;
+
+	memset (sqe, 0, sizeof (struct io_uring_sqe));
+
+	return sqe;
+}
+
+static pboolean
+pp_async_io_uring_prepare (PAsyncIO	*aio,
+			   pint		index,
+			   PError	**error)
+{
+	struct io_uring_sqe	*sqe;
+	PAsyncIOSlot		*slot;
+
+	if (P_UNLIKELY ((sqe = pp_async_io_uring_get_sqe (aio, error)) == NULL))
+		return FALSE;
+
+	slot = &aio->slots[index];
+
+	sqe->fd        = slot->fd;
+	sqe->user_data = (puint64) index;
+
+	switch (slot->operation) {
+	case P_ASYNC_IO_OPERATION_RECEIVE:
+		sqe->opcode = IORING_OP_RECV;
+		sqe->addr   = (puint64) PPOINTER_TO_PSIZE (slot->buffer);
+		sqe->len    = (puint32) slot->length;
+		break;
+	case P_ASYNC_IO_OPERATION_SEND:
+		sqe->opcode    = IORING_OP_SEND;
+		sqe->addr      = (puint64) PPOINTER_TO_PSIZE (slot->buffer);
+		sqe->len       = (puint32) slot->length;
+		sqe->msg_flags = P_ASYNC_IO_SEND_FLAGS;
+		break;
+	case P_ASYNC_IO_OPERATION_ACCEPT:
+		sqe->opcode       = IORING_OP_ACCEPT;
+		sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+		break;
+	case P_ASYNC_IO_OPERATION_CONNECT:
+		sqe->opcode = IORING_OP_CONNECT;
+		sqe->addr   = (puint64) PPOINTER_TO_PSIZE (&slot->address);
+		sqe->off    = (puint64) slot->address_len;
+		break;
+	case P_ASYNC_IO_OPERATION_READ:
+		sqe->opcode = IORING_OP_READ;
+		sqe->addr   = (puint64) PPOINTER_TO_PSIZE (slot->buffer);
+		sqe->len    = (puint32) slot->length;
+		sqe->off    = slot->offset;
+		break;
+	case P_ASYNC_IO_OPERATION_WRITE:
+		sqe->opcode = IORING_OP_WRITE;
+		sqe->addr   = (puint64) PPOINTER_TO_PSIZE (slot->buffer);
+		sqe->len    = (puint32) slot->length;
+		sqe->off    = slot->offset;
+		break;
+	case P_ASYNC_IO_OPERATION_FSYNC:
+		sqe->opcode = IORING_OP_FSYNC;
+		break;
+	}
+
+	return TRUE;
+}
+
+static pboolean
+pp_async_io_uring_prepare_poll (PAsyncIO	*aio,
+				pint		index,
+				PError		**error)
+{
+	struct io_uring_sqe	*sqe;
+	PAsyncIOSlot		*slot;
+
+	if (P_UNLIKELY ((sqe = pp_async_io_uring_get_sqe (aio, error)) == NULL))
+		return FALSE;
+
+	slot = &aio->slots[index];
+
+	sqe->opcode    = IORING_OP_POLL_ADD;
+	sqe->fd        = slot->fd;
+	sqe->user_data = (puint64) index;
+
+	if (slot->operation == P_ASYNC_IO_OPERATION_RECEIVE ||
+	    slot->operation == P_ASYNC_IO_OPERATION_ACCEPT)
+		sqe->poll32_events = POLLIN;
+	else
+		sqe->poll32_events = POLLOUT;
+
+	return TRUE;
+}
+
+/* Completes an operation which can't be passed to the kernel anymore */
+static void
+pp_async_io_uring_fail_slot (PAsyncIO			*aio,
+			     pint			index,
+			     const PError		*error,
+			     PAsyncIOCompletion		*completion)
+{
+	PAsyncIOSlot *slot;
+
+	slot = &aio->slots[index];
+
+	slot->result       = -1;
+	slot->native_error = p_error_get_native_code (error);
+
+	pp_async_io_take_slot (aio, index, completion);
+}
+
+static pint
+pp_async_io_uring_submit (PAsyncIO	*aio,
+			  PError	**error)
+{
+	puint	to_submit;
+	pint	ret;
+	pint	err_code;
+
+	to_submit = aio->sq_local_tail - (puint) p_atomic_int_get ((volatile pint *) aio->sq_head);
+
+	if (to_submit == 0)
+		return 0;
+
+	/* Publish the entries before the kernel reads them */
+	p_atomic_int_set ((volatile pint *) aio->sq_tail, (pint) aio->sq_local_tail);
+
+	for (;;) {
+		if ((ret = (pint) syscall (__NR_io_uring_enter, aio->ring_fd, to_submit, 0, 0, NULL, 0)) >= 0)
+			break;
+
+		err_code = p_error_get_last_system ();
+
+		if (err_code == EINTR)
+			continue;
+
+		p_error_set_error_static_p (error,
+					    (pint) p_error_get_io_from_system (err_code),
+					    err_code,
+					    "Failed to call io_uring_enter() to submit operations");
+		return -1;
+	}
+
+	return ret;
+}
+
+static pint
+pp_async_io_uring_reap (PAsyncIO		*aio,
+			PAsyncIOCompletion	*completions,
+			pint			max,
+			pboolean		cancel)
+{
+	struct io_uring_cqe	*cqe;
+	PAsyncIOSlot		*slot;
+	PErrorStorage		err_storage;
+	PError			*error;
+	puint			head;
+	puint			tail;
+	pint			index;
+	pint			count;
+
+	/* Retry failures are reported with the completions, without memory */
+	error = p_error_init (&err_storage);
+
+	head  = *aio->cq_head;
+	tail  = (puint) p_atomic_int_get ((volatile pint *) aio->cq_tail);
+	count = 0;
+
+	while (head != tail && count < max) {
+		cqe = &aio->cqes[head & aio->cq_mask];
+		++head;
+
+		if (cqe->user_data == P_ASYNC_IO_URING_CANCEL_DATA)
+			continue;
+
+		index = (pint) cqe->user_data;
+		slot  = &aio->slots[index];
+
+		if (slot->state == P_ASYNC_IO_SLOT_STATE_POLLING && cancel == FALSE) {
+			if (cqe->res >= 0) {
+				/* A connection is checked when taken, others are retried */
+				if (slot->operation == P_ASYNC_IO_OPERATION_CONNECT) {
+					slot->result = 0;
+					pp_async_io_take_slot (aio, index, &completions[count++]);
+				} else {
+					slot->state = P_ASYNC_IO_SLOT_STATE_ACTIVE;
+
+					if (P_UNLIKELY (pp_async_io_uring_prepare (aio,
+										   index,
+										   &error) == FALSE)) {
+						pp_async_io_uring_fail_slot (aio, index, error, &completions[count++]);
+						p_error_clear (error);
+					}
+				}
+
+				continue;
+			}
+		} else if (cqe->res < 0 && cancel == FALSE &&
+			   (slot->operation == P_ASYNC_IO_OPERATION_RECEIVE ||
+			    slot->operation == P_ASYNC_IO_OPERATION_SEND    ||
+			    slot->operation == P_ASYNC_IO_OPERATION_ACCEPT  ||
+			    slot->operation == P_ASYNC_IO_OPERATION_CONNECT) &&
+			   pp_async_io_socket_would_block (-cqe->res)) {
+			/* Older kernels don't wait for non-blocking sockets */
+			slot->state = P_ASYNC_IO_SLOT_STATE_POLLING;
+
+			if (P_UNLIKELY (pp_async_io_uring_prepare_poll (aio, index, &error) == FALSE)) {
+				pp_async_io_uring_fail_slot (aio, index, error, &completions[count++]);
+				p_error_clear (error);
+			}
+
+			continue;
+		}
+
+		slot->result       = cqe->res < 0 ? -1 : (pssize) cqe->res;
+		slot->native_error = cqe->res < 0 ? -cqe->res : 0;
+
+		if (cancel == FALSE)
+			pp_async_io_take_slot (aio, index, &completions[count++]);
+		else {
+			if (slot->operation == P_ASYNC_IO_OPERATION_ACCEPT && cqe->res >= 0 &&
+			    P_UNLIKELY (p_sys_close (cqe->res) != 0))
+				P_WARNING ("PAsyncIO::pp_async_io_uring_reap: p_sys_close() failed");
+
+			pp_async_io_free_slot (aio, index);
+		}
+	}
+
+	p_atomic_int_set ((volatile pint *) aio->cq_head, (pint) head);
+
+	return count;
+}
+#endif /* PLIBSYS_HAS_IO_URING */
+
+#ifdef P_ASYNC_IO_USE_THREAD
+static pboolean
+pp_async_io_thread_create_pipe (pint *fds)
+{
+	pint	flags;
+	pint	i;
+
+	if (pipe (fds) != 0)
+		return FALSE;
+
+	for (i = 0; i < 2; ++i) {
+		if ((flags = fcntl (fds[i], F_GETFL, 0)) == -1 ||
+		    fcntl (fds[i], F_SETFL, flags | O_NONBLOCK) == -1 ||
+		    (flags = fcntl (fds[i], F_GETFD, 0)) == -1 ||
+		    fcntl (fds[i], F_SETFD, flags | FD_CLOEXEC) == -1) {
+			(void) p_sys_close (fds[0]);
+			(void) p_sys_close (fds[1]);
+
+			fds[0] = fds[1] = -1;
+
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+static void
+pp_async_io_thread_drain_pipe (pint fd)
+{
+	pchar	buf[64];
+
+	while (read (fd, buf, sizeof (buf)) > 0)
+		;
+}
+
+static pboolean
+pp_async_io_thread_init (PAsyncIO	*aio,
+			 PError		**error)
+{
+	pint	err_code;
+
+	aio->incoming_head  = -1;
+	aio->incoming_tail  = -1;
+	aio->completed_head = -1;
+	aio->completed_tail = -1;
+
+	if (P_UNLIKELY ((aio->waiting = p_malloc0 ((psize) aio->capacity * sizeof (pint))) == NULL ||
+			(aio->pfds = p_malloc0 ((psize) (aio->capacity + 1) * sizeof (struct pollfd))) == NULL ||
+			(aio->mutex = p_mutex_new ()) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for asynchronous I/O worker");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_async_io_thread_create_pipe (aio->wake_pipe) == FALSE ||
+			pp_async_io_thread_create_pipe (aio->notify_pipe) == FALSE)) {
+		err_code = p_error_get_last_system ();
+
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (err_code),
+				     err_code,
+				     "Failed to create pipes for asynchronous I/O worker");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY ((aio->thread = p_uthread_create_full (pp_async_io_thread_worker,
+							      aio,
+							      TRUE,
+							      P_UTHREAD_PRIORITY_INHERIT,
+							      0,
+							      "pasyncio")) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to create asynchronous I/O worker thread");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void
+pp_async_io_thread_close (PAsyncIO *aio)
+{
+	pint i;
+
+	if (aio->thread != NULL) {
+		p_mutex_lock (aio->mutex);
+		aio->stop = TRUE;
+		p_mutex_unlock (aio->mutex);
+
+		if (P_UNLIKELY (write (aio->wake_pipe[1], "x", 1) != 1))
+			P_WARNING ("PAsyncIO::pp_async_io_thread_close: failed to wake up worker");
+
+		p_uthread_join (aio->thread);
+		p_uthread_unref (aio->thread);
+
+		aio->thread = NULL;
+	}
+
+	/* Close the connections which were accepted but not taken */
+	for (i = 0; i < aio->capacity; ++i) {
+		if (aio->slots[i].state == P_ASYNC_IO_SLOT_STATE_DONE &&
+		    aio->slots[i].operation == P_ASYNC_IO_OPERATION_ACCEPT &&
+		    aio->slots[i].result >= 0 &&
+		    P_UNLIKELY (p_sys_close ((pint) aio->slots[i].result) != 0))
+			P_WARNING ("PAsyncIO::pp_async_io_thread_close: p_sys_close() failed");
+	}
+
+	for (i = 0; i < 2; ++i) {
+		if (aio->wake_pipe[i] >= 0)
+			(void) p_sys_close (aio->wake_pipe[i]);
+
+		if (aio->notify_pipe[i] >= 0)
+			(void) p_sys_close (aio->notify_pipe[i]);
+	}
+
+	if (aio->mutex != NULL)
+		p_mutex_free (aio->mutex);
+
+	if (aio->pfds != NULL)
+		p_free (aio->pfds);
+
+	if (aio->waiting != NULL)
+		p_free (aio->waiting);
+}
+
+static pboolean
+pp_async_io_thread_execute (PAsyncIO	*aio,
+			    pint	index)
+{
+	PAsyncIOSlot	*slot;
+	pssize		ret;
+	pint		err_code;
+#ifndef PLIBSYS_HAS_ACCEPT4
+	pint		flags;
+#endif
+
+	slot = &aio->slots[index];
+
+	for (;;) {
+		switch (slot->operation) {
+		case P_ASYNC_IO_OPERATION_RECEIVE:
+			ret = recv (slot->fd, slot->buffer, slot->length, 0);
+			break;
+		case P_ASYNC_IO_OPERATION_SEND:
+			ret = send (slot->fd, slot->buffer, slot->length, P_ASYNC_IO_SEND_FLAGS);
+			break;
+		case P_ASYNC_IO_OPERATION_ACCEPT:
+#ifdef PLIBSYS_HAS_ACCEPT4
+			ret = accept4 (slot->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+			if ((ret = accept (slot->fd, NULL, NULL)) >= 0 &&
+			    (flags = fcntl ((pint) ret, F_GETFD, 0)) != -1)
+				(void) fcntl ((pint) ret, F_SETFD, flags | FD_CLOEXEC);
+#endif
+			break;
+		case P_ASYNC_IO_OPERATION_CONNECT:
+			/* Readiness means the connection attempt is finished, the
+			 * result is checked when the operation is taken */
+			if (slot->state == P_ASYNC_IO_SLOT_STATE_POLLING)
+				ret = 0;
+			else
+				ret = connect (slot->fd, (struct sockaddr *) &slot->address, slot->address_len);
+			break;
+		case P_ASYNC_IO_OPERATION_READ:
+			ret = pread (slot->fd, slot->buffer, slot->length, (off_t) slot->offset);
+			break;
+		case P_ASYNC_IO_OPERATION_WRITE:
+			ret = pwrite (slot->fd, slot->buffer, slot->length, (off_t) slot->offset);
+			break;
+		case P_ASYNC_IO_OPERATION_FSYNC:
+			ret = fsync (slot->fd);
+			break;
+		default:
+			ret = -1;
+			errno = EINVAL;
+			break;
+		}
+
+		if (ret >= 0) {
+			slot->result = ret;
+			break;
+		}
+
+		err_code = p_error_get_last_system ();
+
+		if (err_code == EINTR)
+			continue;
+
+		if (slot->operation <= P_ASYNC_IO_OPERATION_CONNECT && pp_async_io_socket_would_block (err_code)) {
+			slot->state = P_ASYNC_IO_SLOT_STATE_POLLING;
+			return FALSE;
+		}
+
+		slot->result       = -1;
+		slot->native_error = err_code;
+		break;
+	}
+
+	slot->state = P_ASYNC_IO_SLOT_STATE_DONE;
+
+	return TRUE;
+}
+
+static void
+pp_async_io_thread_publish (PAsyncIO	*aio,
+			    pint	head,
+			    pint	tail)
+{
+	if (head < 0)
+		return;
+
+	p_mutex_lock (aio->mutex);
+
+	if (aio->completed_tail < 0) {
+		aio->completed_head = head;
+
+		/* The pipe is readable as long as the list is not empty */
+		if (P_UNLIKELY (write (aio->notify_pipe[1], "x", 1) != 1))
+			P_WARNING ("PAsyncIO::pp_async_io_thread_publish: failed to notify about completions");
+	} else
+		aio->slots[aio->completed_tail].next = head;
+
+	aio->completed_tail = tail;
+
+	p_mutex_unlock (aio->mutex);
+}
+
+static ppointer
+pp_async_io_thread_worker (ppointer data)
+{
+	PAsyncIO	*aio;
+	PAsyncIOSlot	*slot;
+	pboolean	stop;
+	pint		waiting_count;
+	pint		done_head;
+	pint		done_tail;
+	pint		index;
+	pint		next;
+	pint		i;
+	pint		j;
+
+	aio           = (PAsyncIO *) data;
+	waiting_count = 0;
+
+	for (;;) {
+		p_mutex_lock (aio->mutex);
+
+		stop  = aio->stop;
+		index = aio->incoming_head;
+
+		aio->incoming_head = -1;
+		aio->incoming_tail = -1;
+
+		p_mutex_unlock (aio->mutex);
+
+		if (stop == TRUE)
+			break;
+
+		done_head = -1;
+		done_tail = -1;
+
+		/* Try new operations right away, most sockets are ready */
+		for (; index >= 0; index = next) {
+			next = aio->slots[index].next;
+
+			aio->slots[index].next = -1;
+
+			if (pp_async_io_thread_execute (aio, index) == FALSE) {
+				aio->waiting[waiting_count++] = index;
+				continue;
+			}
+
+			if (done_tail < 0)
+				done_head = index;
+			else
+				aio->slots[done_tail].next = index;
+
+			done_tail = index;
+		}
+
+		pp_async_io_thread_publish (aio, done_head, done_tail);
+
+		aio->pfds[0].fd      = aio->wake_pipe[0];
+		aio->pfds[0].events  = POLLIN;
+		aio->pfds[0].revents = 0;
+
+		for (i = 0; i < waiting_count; ++i) {
+			slot = &aio->slots[aio->waiting[i]];
+
+			aio->pfds[i + 1].fd      = slot->fd;
+			aio->pfds[i + 1].revents = 0;
+
+			if (slot->operation == P_ASYNC_IO_OPERATION_RECEIVE ||
+			    slot->operation == P_ASYNC_IO_OPERATION_ACCEPT)
+				aio->pfds[i + 1].events = POLLIN;
+			else
+				aio->pfds[i + 1].events = POLLOUT;
+		}
+
+		if (poll (aio->pfds, (nfds_t) (waiting_count + 1), -1) < 0) {
+			if (p_error_get_last_system () != EINTR) {
+				P_ERROR ("PAsyncIO::pp_async_io_thread_worker: failed to call poll()");
+				p_uthread_sleep (10);
+			}
+
+			continue;
+		}
+
+		if (aio->pfds[0].revents != 0)
+			pp_async_io_thread_drain_pipe (aio->wake_pipe[0]);
+
+		done_head = -1;
+		done_tail = -1;
+
+		for (i = 0, j = 0; i < waiting_count; ++i) {
+			index = aio->waiting[i];
+
+			if (aio->pfds[i + 1].revents == 0 || pp_async_io_thread_execute (aio, index) == FALSE) {
+				aio->waiting[j++] = index;
+				continue;
+			}
+
+			if (done_tail < 0)
+				done_head = index;
+			else
+				aio->slots[done_tail].next = index;
+
+			done_tail = index;
+		}
+
+		waiting_count = j;
+
+		pp_async_io_thread_publish (aio, done_head, done_tail);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+static pint
+pp_async_io_thread_submit (PAsyncIO *aio)
+{
+	pboolean	wake;
+	pint		ret;
+	pint		index;
+
+	if (aio->queued_head < 0)
+		return 0;
+
+	for (index = aio->queued_head; index >= 0; index = aio->slots[index].next)
+		aio->slots[index].state = P_ASYNC_IO_SLOT_STATE_ACTIVE;
+
+	p_mutex_lock (aio->mutex);
+
+	wake = aio->incoming_tail < 0;
+
+	if (wake == TRUE)
+		aio->incoming_head = aio->queued_head;
+	else
+		aio->slots[aio->incoming_tail].next = aio->queued_head;
+
+	aio->incoming_tail = aio->queued_tail;
+
+	p_mutex_unlock (aio->mutex);
+
+	/* The worker takes all the incoming operations at once, so it needs to
+	 * be woken up only for the first batch */
+	if (wake == TRUE && P_UNLIKELY (write (aio->wake_pipe[1], "x", 1) != 1))
+		P_WARNING ("PAsyncIO::pp_async_io_thread_submit: failed to wake up worker");
+
+	ret = aio->queued_count;
+
+	aio->queued_head  = -1;
+	aio->queued_tail  = -1;
+	aio->queued_count = 0;
+
+	return ret;
+}
+
+static pint
+pp_async_io_thread_reap (PAsyncIO		*aio,
+			 PAsyncIOCompletion	*completions,
+			 pint			max)
+{
+	pint	head;
+	pint	tail;
+	pint	index;
+	pint	count;
+
+	p_mutex_lock (aio->mutex);
+
+	head = aio->completed_head;
+	tail = head;
+
+	for (count = 1; tail >= 0 && count < max && aio->slots[tail].next >= 0; ++count)
+		tail = aio->slots[tail].next;
+
+	if (head >= 0) {
+		aio->completed_head = aio->slots[tail].next;
+
+		if (aio->completed_head < 0) {
+			aio->completed_tail = -1;
+			pp_async_io_thread_drain_pipe (aio->notify_pipe[0]);
+		}
+	}
+
+	p_mutex_unlock (aio->mutex);
+
+	if (head < 0)
+		return 0;
+
+	aio->slots[tail].next = -1;
+
+	for (count = 0, index = head; index >= 0; ++count) {
+		head = aio->slots[index].next;
+		pp_async_io_take_slot (aio, index, &completions[count]);
+		index = head;
+	}
+
+	return count;
+}
+#endif /* P_ASYNC_IO_USE_THREAD */
+
+P_LIB_API PAsyncIO *
+p_async_io_new (pint		capacity,
+		PAsyncIOBackend	backend,
+		PError		**error)
+{
+	PAsyncIO	*ret;
+	pint		i;
+
+	if (P_UNLIKELY (capacity <= 0 ||
+			backend < P_ASYNC_IO_BACKEND_DEFAULT ||
+			backend > P_ASYNC_IO_BACKEND_THREAD)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PAsyncIO))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for asynchronous I/O engine");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->slots = p_malloc0 ((psize) capacity * sizeof (PAsyncIOSlot))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for asynchronous I/O operations");
+		p_free (ret);
+		return NULL;
+	}
+
+	for (i = 0; i < capacity; ++i)
+		ret->slots[i].next = i + 1 < capacity ? i + 1 : -1;
+
+	ret->capacity    = capacity;
+	ret->free_head   = 0;
+	ret->queued_head = -1;
+	ret->queued_tail = -1;
+
+#ifdef PLIBSYS_HAS_IO_URING
+	ret->ring_fd = -1;
+#endif
+
+#ifdef P_ASYNC_IO_USE_THREAD
+	ret->wake_pipe[0]   = ret->wake_pipe[1]   = -1;
+	ret->notify_pipe[0] = ret->notify_pipe[1] = -1;
+#endif
+
+	if (backend == P_ASYNC_IO_BACKEND_DEFAULT || backend == P_ASYNC_IO_BACKEND_IO_URING) {
+#ifdef PLIBSYS_HAS_IO_URING
+		/* The ring may be prohibited by the system, i.e. in containers */
+		if (pp_async_io_uring_init (ret, backend == P_ASYNC_IO_BACKEND_IO_URING ? error : NULL) == TRUE) {
+			ret->backend = P_ASYNC_IO_BACKEND_IO_URING;
+			return ret;
+		}
+#else
+		if (backend == P_ASYNC_IO_BACKEND_IO_URING)
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NOT_SUPPORTED,
+					     0,
+					     "io_uring is not supported on this platform");
+#endif
+
+		if (backend == P_ASYNC_IO_BACKEND_IO_URING) {
+			p_free (ret->slots);
+			p_free (ret);
+			return NULL;
+		}
+	}
+
+#ifdef P_ASYNC_IO_USE_THREAD
+	ret->backend = P_ASYNC_IO_BACKEND_THREAD;
+
+	if (P_UNLIKELY (pp_async_io_thread_init (ret, error) == FALSE)) {
+		pp_async_io_thread_close (ret);
+		p_free (ret->slots);
+		p_free (ret);
+		return NULL;
+	}
+
+	return ret;
+#else
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Asynchronous I/O thread backend is not supported on this platform");
+	p_free (ret->slots);
+	p_free (ret);
+
+	return NULL;
+#endif
+}
+
+P_LIB_API PAsyncIOBackend
+p_async_io_get_backend (const PAsyncIO *aio)
+{
+	if (P_UNLIKELY (aio == NULL))
+		return P_ASYNC_IO_BACKEND_DEFAULT;
+
+	return aio->backend;
+}
+
+P_LIB_API pint
+p_async_io_get_pending (const PAsyncIO *aio)
+{
+	if (P_UNLIKELY (aio == NULL))
+		return 0;
+
+	return aio->pending;
+}
+
+P_LIB_API pboolean
+p_async_io_receive (PAsyncIO	*aio,
+		    PSocket	*socket,
+		    pchar	*buffer,
+		    psize	buflen,
+		    ppointer	user_data,
+		    PError	**error)
+{
+	if (P_UNLIKELY (aio == NULL || socket == NULL || buffer == NULL || buflen == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	return pp_async_io_queue_operation (aio,
+					    P_ASYNC_IO_OPERATION_RECEIVE,
+					    socket,
+					    -1,
+					    buffer,
+					    buflen,
+					    0,
+					    NULL,
+					    user_data,
+					    error);
+}
+
+P_LIB_API pboolean
+p_async_io_send (PAsyncIO	*aio,
+		 PSocket	*socket,
+		 const pchar	*buffer,
+		 psize		buflen,
+		 ppointer	user_data,
+		 PError		**error)
+{
+	if (P_UNLIKELY (aio == NULL || socket == NULL || buffer == NULL || buflen == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	return pp_async_io_queue_operation (aio,
+					    P_ASYNC_IO_OPERATION_SEND,
+					    socket,
+					    -1,
+					    (pchar *) buffer,
+					    buflen,
+					    0,
+					    NULL,
+					    user_data,
+					    error);
+}
+
+P_LIB_API pboolean
+p_async_io_accept (PAsyncIO	*aio,
+		   PSocket	*socket,
+		   ppointer	user_data,
+		   PError	**error)
+{
+	if (P_UNLIKELY (aio == NULL || socket == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	return pp_async_io_queue_operation (aio,
+					    P_ASYNC_IO_OPERATION_ACCEPT,
+					    socket,
+					    -1,
+					    NULL,
+					    0,
+					    0,
+					    NULL,
+					    user_data,
+					    error);
+}
+
+P_LIB_API pboolean
+p_async_io_connect (PAsyncIO		*aio,
+		    PSocket		*socket,
+		    PSocketAddress	*address,
+		    ppointer		user_data,
+		    PError		**error)
+{
+	if (P_UNLIKELY (aio == NULL || socket == NULL || address == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	return pp_async_io_queue_operation (aio,
+					    P_ASYNC_IO_OPERATION_CONNECT,
+					    socket,
+					    -1,
+					    NULL,
+					    0,
+					    0,
+					    address,
+					    user_data,
+					    error);
+}
+
+P_LIB_API pboolean
+p_async_io_read (PAsyncIO	*aio,
+		 pint		fd,
+		 pchar		*buffer,
+		 psize		buflen,
+		 puint64	offset,
+		 ppointer	user_data,
+		 PError		**error)
+{
+	if (P_UNLIKELY (aio == NULL || buffer == NULL || buflen == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	return pp_async_io_queue_operation (aio,
+					    P_ASYNC_IO_OPERATION_READ,
+					    NULL,
+					    fd,
+					    buffer,
+					    buflen,
+					    offset,
+					    NULL,
+					    user_data,
+					    error);
+}
+
+P_LIB_API pboolean
+p_async_io_write (PAsyncIO	*aio,
+		  pint		fd,
+		  const pchar	*buffer,
+		  psize		buflen,
+		  puint64	offset,
+		  ppointer	user_data,
+		  PError	**error)
+{
+	if (P_UNLIKELY (aio == NULL || buffer == NULL || buflen == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	return pp_async_io_queue_operation (aio,
+					    P_ASYNC_IO_OPERATION_WRITE,
+					    NULL,
+					    fd,
+					    (pchar *) buffer,
+					    buflen,
+					    offset,
+					    NULL,
+					    user_data,
+					    error);
+}
+
+P_LIB_API pboolean
+p_async_io_fsync (PAsyncIO	*aio,
+		  pint		fd,
+		  ppointer	user_data,
+		  PError	**error)
+{
+	if (P_UNLIKELY (aio == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	return pp_async_io_queue_operation (aio,
+					    P_ASYNC_IO_OPERATION_FSYNC,
+					    NULL,
+					    fd,
+					    NULL,
+					    0,
+					    0,
+					    NULL,
+					    user_data,
+					    error);
+}
+
+P_LIB_API pint
+p_async_io_submit (PAsyncIO	*aio,
+		   PError	**error)
+{
+	pint ret;
+
+	if (P_UNLIKELY (aio == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+#ifdef PLIBSYS_HAS_IO_URING
+	if (aio->backend == P_ASYNC_IO_BACKEND_IO_URING) {
+		if (P_UNLIKELY (pp_async_io_uring_submit (aio, error) < 0))
+			return -1;
+
+		ret = aio->queued_count;
+		aio->queued_count = 0;
+
+		return ret;
+	}
+#endif
+
+#ifdef P_ASYNC_IO_USE_THREAD
+	ret = pp_async_io_thread_submit (aio);
+#else
+	ret = 0;
+#endif
+
+	return ret;
+}
+
+P_LIB_API pint
+p_async_io_get_completions (PAsyncIO		*aio,
+			    PAsyncIOCompletion	*completions,
+			    pint		max,
+			    pint		timeout,
+			    PError		**error)
+{
+	puint64	start;
+	puint64	elapsed;
+	pint	wait_time;
+	pint	wait_fd;
+	pint	ret;
+
+	if (P_UNLIKELY (aio == NULL || completions == NULL || max <= 0 || timeout < -1)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (aio->queued_count > 0 && P_UNLIKELY (p_async_io_submit (aio, error) < 0))
+		return -1;
+
+	start = timeout > 0 ? p_time_profiler_ticks () : 0;
+
+	for (;;) {
+		if (aio->pending == 0)
+			return 0;
+
+#ifdef PLIBSYS_HAS_IO_URING
+		if (aio->backend == P_ASYNC_IO_BACKEND_IO_URING) {
+			ret     = pp_async_io_uring_reap (aio, completions, max, FALSE);
+			wait_fd = aio->ring_fd;
+
+			/* Operations retried after waiting for readiness */
+			if (aio->sq_local_tail != *aio->sq_tail &&
+			    P_UNLIKELY (pp_async_io_uring_submit (aio, error) < 0))
+				return -1;
+		}
+#endif
+
+#ifdef P_ASYNC_IO_USE_THREAD
+		if (aio->backend == P_ASYNC_IO_BACKEND_THREAD) {
+			ret     = pp_async_io_thread_reap (aio, completions, max);
+			wait_fd = aio->notify_pipe[0];
+		}
+#endif
+
+		if (ret > 0 || timeout == 0)
+			return ret;
+
+		wait_time = -1;
+
+		if (timeout > 0) {
+			elapsed = p_time_profiler_ticks_to_nsecs (p_time_profiler_ticks () - start) / 1000000;
+
+			if (elapsed >= (puint64) timeout)
+				return 0;
+
+			wait_time = timeout - (pint) elapsed;
+		}
+
+		if (P_UNLIKELY (pp_async_io_wait_fd (wait_fd, wait_time, error) == FALSE))
+			return -1;
+	}
+}
+
+P_LIB_API void
+p_async_io_free (PAsyncIO *aio)
+{
+#ifdef PLIBSYS_HAS_IO_URING
+	struct io_uring_sqe	*sqe;
+	pint			i;
+#endif
+
+	if (P_UNLIKELY (aio == NULL))
+		return;
+
+#ifdef PLIBSYS_HAS_IO_URING
+	if (aio->backend == P_ASYNC_IO_BACKEND_IO_URING) {
+		/* The kernel may still use the buffers after the ring is closed,
+		 * so cancel all the operations and wait for them */
+		for (i = 0; i < aio->capacity; ++i) {
+			if (aio->slots[i].state == P_ASYNC_IO_SLOT_STATE_FREE)
+				continue;
+
+			if (P_UNLIKELY ((sqe = pp_async_io_uring_get_sqe (aio, NULL)) == NULL)) {
+				P_WARNING ("PAsyncIO::p_async_io_free: failed to queue cancellation");
+				break;
+			}
+
+			sqe->opcode    = IORING_OP_ASYNC_CANCEL;
+			sqe->fd        = -1;
+			sqe->addr      = (puint64) i;
+			sqe->user_data = P_ASYNC_IO_URING_CANCEL_DATA;
+		}
+
+		/* Not cancelled operations may never complete, don't wait for them */
+		if (P_LIKELY (i == aio->capacity && pp_async_io_uring_submit (aio, NULL) >= 0)) {
+			for (;;) {
+				(void) pp_async_io_uring_reap (aio, NULL, 1, TRUE);
+
+				if (aio->pending == 0)
+					break;
+
+				if (syscall (__NR_io_uring_enter,
+					     aio->ring_fd,
+					     0,
+					     1,
+					     IORING_ENTER_GETEVENTS,
+					     NULL,
+					     0) < 0 && p_error_get_last_system () != EINTR) {
+					P_WARNING ("PAsyncIO::p_async_io_free: failed to wait for cancelled operations");
+					break;
+				}
+			}
+		}
+
+		pp_async_io_uring_close (aio);
+	}
+#endif
+
+#ifdef P_ASYNC_IO_USE_THREAD
+	if (aio->backend == P_ASYNC_IO_BACKEND_THREAD)
+		pp_async_io_thread_close (aio);
+#endif
+
+	p_free (aio->slots);
+	p_free (aio);
+}
+
+#else /* P_ASYNC_IO_SUPPORTED */
+
+P_LIB_API PAsyncIO *
+p_async_io_new (pint		capacity,
+		PAsyncIOBackend	backend,
+		PError		**error)
+{
+	P_UNUSED (capacity);
+	P_UNUSED (backend);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Asynchronous I/O is not supported on this platform");
+
+	return NULL;
+}
+
+P_LIB_API PAsyncIOBackend
+p_async_io_get_backend (const PAsyncIO *aio)
+{
+	P_UNUSED (aio);
+	return P_ASYNC_IO_BACKEND_DEFAULT;
+}
+
+P_LIB_API pint
+p_async_io_get_pending (const PAsyncIO *aio)
+{
+	P_UNUSED (aio);
+	return 0;
+}
+
+P_LIB_API pboolean
+p_async_io_receive (PAsyncIO	*aio,
+		    PSocket	*socket,
+		    pchar	*buffer,
+		    psize	buflen,
+		    ppointer	user_data,
+		    PError	**error)
+{
+	P_UNUSED (aio);
+	P_UNUSED (socket);
+	P_UNUSED (buffer);
+	P_UNUSED (buflen);
+	P_UNUSED (user_data);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Asynchronous I/O is not supported on this platform");
+
+	return FALSE;
+}
+
+P_LIB_API pboolean
+p_async_io_send (PAsyncIO	*aio,
+		 PSocket	*socket,
+		 const pchar	*buffer,
+		 psize		buflen,
+		 ppointer	user_data,
+		 PError		**error)
+{
+	P_UNUSED (aio);
+	P_UNUSED (socket);
+	P_UNUSED (buffer);
+	P_UNUSED (buflen);
+	P_UNUSED (user_data);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Asynchronous I/O is not supported on this platform");
+
+	return FALSE;
+}
+
+P_LIB_API pboolean
+p_async_io_accept (PAsyncIO	*aio,
+		   PSocket	*socket,
+		   ppointer	user_data,
+		   PError	**error)
+{
+	P_UNUSED (aio);
+	P_UNUSED (socket);
+	P_UNUSED (user_data);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Asynchronous I/O is not supported on this platform");
+
+	return FALSE;
+}
+
+P_LIB_API pboolean
+p_async_io_connect (PAsyncIO		*aio,
+		    PSocket		*socket,
+		    PSocketAddress	*address,
+		    ppointer		user_data,
+		    PError		**error)
+{
+	P_UNUSED (aio);
+	P_UNUSED (socket);
+	P_UNUSED (address);
+	P_UNUSED (user_data);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Asynchronous I/O is not supported on this platform");
+
+	return FALSE;
+}
+
+P_LIB_API pboolean
+p_async_io_read (PAsyncIO	*aio,
+		 pint		fd,
+		 pchar		*buffer,
+		 psize		buflen,
+		 puint64	offset,
+		 ppointer	user_data,
+		 PError		**error)
+{
+	P_UNUSED (aio);
+	P_UNUSED (fd);
+	P_UNUSED (buffer);
+	P_UNUSED (buflen);
+	P_UNUSED (offset);
+	P_UNUSED (user_data);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Asynchronous I/O is not supported on this platform");
+
+	return FALSE;
+}
+
+P_LIB_API pboolean
+p_async_io_write (PAsyncIO	*aio,
+		  pint		fd,
+		  const pchar	*buffer,
+		  psize		buflen,
+		  puint64	offset,
+		  ppointer	user_data,
+		  PError	**error)
+{
+	P_UNUSED (aio);
+	P_UNUSED (fd);
+	P_UNUSED (buffer);
+	P_UNUSED (buflen);
+	P_UNUSED (offset);
+	P_UNUSED (user_data);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Asynchronous I/O is not supported on this platform");
+
+	return FALSE;
+}
+
+P_LIB_API pboolean
+p_async_io_fsync (PAsyncIO	*aio,
+		  pint		fd,
+		  ppointer	user_data,
+		  PError	**error)
+{
+	P_UNUSED (aio);
+	P_UNUSED (fd);
+	P_UNUSED (user_data);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Asynchronous I/O is not supported on this platform");
+
+	return FALSE;
+}
+
+P_LIB_API pint
+p_async_io_submit (PAsyncIO	*aio,
+		   PError	**error)
+{
+	P_UNUSED (aio);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Asynchronous I/O is not supported on this platform");
+
+	return -1;
+}
+
+P_LIB_API pint
+p_async_io_get_completions (PAsyncIO		*aio,
+			    PAsyncIOCompletion	*completions,
+			    pint		max,
+			    pint		timeout,
+			    PError		**error)
+{
+	P_UNUSED (aio);
+	P_UNUSED (completions);
+	P_UNUSED (max);
+	P_UNUSED (timeout);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Asynchronous I/O is not supported on this platform");
+
+	return -1;
+}
+
+P_LIB_API void
+p_async_io_free (PAsyncIO *aio)
+{
+	P_UNUSED (aio);
+}
+
+#endif /* P_ASYNC_IO_SUPPORTED */
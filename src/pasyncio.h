@@ -0,0 +1,345 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pasyncio.h
+ * @brief Asynchronous I/O engine
+ * @author Alexander Saprykin
+ *
+ * Synchronous I/O calls like p_socket_receive() take a system call per
+ * operation and block the calling thread until the operation completes, so
+ * keeping many operations in flight requires as many threads.
+ *
+ * #PAsyncIO queues operations and completes them in the background: the
+ * calling thread only submits a batch of operations and later takes the
+ * completed ones. Supported operations are receiving, sending, accepting and
+ * connecting sockets, and reading, writing and syncing files.
+ *
+ * An operation is queued with one of p_async_io_receive(), p_async_io_send(),
+ * p_async_io_accept(), p_async_io_connect(), p_async_io_read(),
+ * p_async_io_write() or p_async_io_fsync() calls, each one taking a user data
+ * pointer to identify the operation on completion. Queued operations are
+ * started with p_async_io_submit(), all at once. Completed operations are
+ * taken with p_async_io_get_completions() as an array of #PAsyncIOCompletion
+ * records, in the order they completed.
+ *
+ * The number of operations in flight (queued, submitted or completed but not
+ * taken yet) is limited by the capacity given to p_async_io_new(). Buffers,
+ * sockets and file descriptors passed with an operation must remain valid
+ * until its completion is taken.
+ *
+ * Two backends are available:
+ * - #P_ASYNC_IO_BACKEND_IO_URING uses the Linux io_uring interface (Linux 5.6
+ * or newer): a batch of operations is submitted with a single system call and
+ * completions are read from the shared memory without system calls at all;
+ * - #P_ASYNC_IO_BACKEND_THREAD uses a worker thread which waits for the
+ * sockets readiness using poll() and performs the operations on behalf of the
+ * caller. File operations are performed synchronously by the worker thread.
+ *
+ * The io_uring backend is preferred when it is available and not prohibited by
+ * the system. #PAsyncIO is not supported on Windows.
+ *
+ * #PAsyncIO object is not thread-safe, use a separate object for every thread
+ * which performs asynchronous I/O.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PASYNCIO_H
+#define PLIBSYS_HEADER_PASYNCIO_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+#include <perror.h>
+#include <psocket.h>
+#include <psocketaddress.h>
+
+P_BEGIN_DECLS
+
+/** Asynchronous I/O engine opaque structure. */
+typedef struct PAsyncIO_ PAsyncIO;
+
+/** Asynchronous I/O backend. */
+typedef enum PAsyncIOBackend_ {
+	P_ASYNC_IO_BACKEND_DEFAULT	= 0,	/**< Best available backend.			*/
+	P_ASYNC_IO_BACKEND_IO_URING	= 1,	/**< Linux io_uring interface.			*/
+	P_ASYNC_IO_BACKEND_THREAD	= 2	/**< Worker thread with readiness polling.	*/
+} PAsyncIOBackend;
+
+/** Asynchronous I/O operation. */
+typedef enum PAsyncIOOperation_ {
+	P_ASYNC_IO_OPERATION_RECEIVE	= 0,	/**< Receive data from a socket.		*/
+	P_ASYNC_IO_OPERATION_SEND	= 1,	/**< Send data to a socket.			*/
+	P_ASYNC_IO_OPERATION_ACCEPT	= 2,	/**< Accept a socket connection.		*/
+	P_ASYNC_IO_OPERATION_CONNECT	= 3,	/**< Connect a socket.				*/
+	P_ASYNC_IO_OPERATION_READ	= 4,	/**< Read data from a file.			*/
+	P_ASYNC_IO_OPERATION_WRITE	= 5,	/**< Write data to a file.			*/
+	P_ASYNC_IO_OPERATION_FSYNC	= 6	/**< Flush file data to a storage.		*/
+} PAsyncIOOperation;
+
+/** Completed asynchronous I/O operation. */
+typedef struct PAsyncIOCompletion_ {
+	PAsyncIOOperation	operation;	/**< Completed operation.				*/
+	ppointer		user_data;	/**< User data given when the operation was queued.	*/
+	pssize			result;		/**< Number of bytes transferred, 0 for accepting,
+						     connecting and syncing, or -1 in case of error.	*/
+	PErrorIO		error;		/**< Error code, #P_ERROR_IO_NONE in case of success.	*/
+	pint			native_error;	/**< Platform native error code, 0 in case of success.	*/
+	PSocket			*socket;	/**< Accepted connection for
+						     #P_ASYNC_IO_OPERATION_ACCEPT, the caller owns it,
+						     NULL for the other operations.			*/
+} PAsyncIOCompletion;
+
+/**
+ * @brief Creates a new #PAsyncIO engine.
+ * @param capacity Maximum number of operations in flight.
+ * @param backend Backend to use, #P_ASYNC_IO_BACKEND_DEFAULT to choose the
+ * best available one.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PAsyncIO in case of success, NULL otherwise.
+ * @since 0.0.6
+ *
+ * If the @a backend is requested explicitly and it is not available, the call
+ * fails with #P_ERROR_IO_NOT_SUPPORTED.
+ */
+P_LIB_API PAsyncIO *		p_async_io_new			(pint			capacity,
+								 PAsyncIOBackend	backend,
+								 PError			**error);
+
+/**
+ * @brief Gets a backend used by a #PAsyncIO engine.
+ * @param aio #PAsyncIO to get the backend for.
+ * @return Backend used by the @a aio, #P_ASYNC_IO_BACKEND_DEFAULT in case of
+ * error.
+ * @since 0.0.6
+ */
+P_LIB_API PAsyncIOBackend	p_async_io_get_backend		(const PAsyncIO		*aio);
+
+/**
+ * @brief Gets a number of operations in flight.
+ * @param aio #PAsyncIO to get the number of operations for.
+ * @return Number of operations which were queued and whose completions were
+ * not taken yet.
+ * @since 0.0.6
+ */
+P_LIB_API pint			p_async_io_get_pending		(const PAsyncIO		*aio);
+
+/**
+ * @brief Queues receiving data from a socket.
+ * @param aio #PAsyncIO to queue the operation in.
+ * @param socket Connected #PSocket to receive data from.
+ * @param buffer Buffer to put the received data into.
+ * @param buflen Size of the @a buffer, in bytes.
+ * @param user_data Data to identify the operation on completion.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * Completes as soon as any data is available, the number of received bytes is
+ * the operation result. The result is 0 if the connection was closed by the
+ * remote side.
+ *
+ * Fails with #P_ERROR_IO_WOULD_BLOCK if the number of operations in flight
+ * reached the capacity, the same applies to the other operations.
+ */
+P_LIB_API pboolean		p_async_io_receive		(PAsyncIO		*aio,
+								 PSocket		*socket,
+								 pchar			*buffer,
+								 psize			buflen,
+								 ppointer		user_data,
+								 PError			**error);
+
+/**
+ * @brief Queues sending data to a socket.
+ * @param aio #PAsyncIO to queue the operation in.
+ * @param socket Connected #PSocket to send data to.
+ * @param buffer Buffer with the data to send.
+ * @param buflen Size of the data in the @a buffer, in bytes.
+ * @param user_data Data to identify the operation on completion.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * The number of sent bytes is the operation result, it may be less than the
+ * @a buflen.
+ */
+P_LIB_API pboolean		p_async_io_send			(PAsyncIO		*aio,
+								 PSocket		*socket,
+								 const pchar		*buffer,
+								 psize			buflen,
+								 ppointer		user_data,
+								 PError			**error);
+
+/**
+ * @brief Queues accepting a connection.
+ * @param aio #PAsyncIO to queue the operation in.
+ * @param socket Listening #PSocket to accept the connection from.
+ * @param user_data Data to identify the operation on completion.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * The accepted connection is passed in the @a socket field of the
+ * #PAsyncIOCompletion, the caller takes ownership of it.
+ */
+P_LIB_API pboolean		p_async_io_accept		(PAsyncIO		*aio,
+								 PSocket		*socket,
+								 ppointer		user_data,
+								 PError			**error);
+
+/**
+ * @brief Queues connecting a socket.
+ * @param aio #PAsyncIO to queue the operation in.
+ * @param socket Stream #PSocket to connect.
+ * @param address Address to connect the @a socket to, it is copied and may be
+ * freed right after the call.
+ * @param user_data Data to identify the operation on completion.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * On successful completion the @a socket is marked as connected, see
+ * p_socket_is_connected().
+ */
+P_LIB_API pboolean		p_async_io_connect		(PAsyncIO		*aio,
+								 PSocket		*socket,
+								 PSocketAddress		*address,
+								 ppointer		user_data,
+								 PError			**error);
+
+/**
+ * @brief Queues reading data from a file.
+ * @param aio #PAsyncIO to queue the operation in.
+ * @param fd File descriptor to read from.
+ * @param buffer Buffer to put the read data into.
+ * @param buflen Size of the @a buffer, in bytes.
+ * @param offset Offset in the file to read from, the file position is not
+ * used and not changed.
+ * @param user_data Data to identify the operation on completion.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * The number of read bytes is the operation result, 0 at the end of file.
+ */
+P_LIB_API pboolean		p_async_io_read			(PAsyncIO		*aio,
+								 pint			fd,
+								 pchar			*buffer,
+								 psize			buflen,
+								 puint64		offset,
+								 ppointer		user_data,
+								 PError			**error);
+
+/**
+ * @brief Queues writing data to a file.
+ * @param aio #PAsyncIO to queue the operation in.
+ * @param fd File descriptor to write to.
+ * @param buffer Buffer with the data to write.
+ * @param buflen Size of the data in the @a buffer, in bytes.
+ * @param offset Offset in the file to write at, the file position is not used
+ * and not changed.
+ * @param user_data Data to identify the operation on completion.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * The number of written bytes is the operation result.
+ */
+P_LIB_API pboolean		p_async_io_write		(PAsyncIO		*aio,
+								 pint			fd,
+								 const pchar		*buffer,
+								 psize			buflen,
+								 puint64		offset,
+								 ppointer		user_data,
+								 PError			**error);
+
+/**
+ * @brief Queues flushing file data to a storage device.
+ * @param aio #PAsyncIO to queue the operation in.
+ * @param fd File descriptor to flush.
+ * @param user_data Data to identify the operation on completion.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * Operations on the same file are not ordered: submit the flush after the
+ * writes it must cover were completed.
+ */
+P_LIB_API pboolean		p_async_io_fsync		(PAsyncIO		*aio,
+								 pint			fd,
+								 ppointer		user_data,
+								 PError			**error);
+
+/**
+ * @brief Starts all the queued operations.
+ * @param aio #PAsyncIO to start the operations in.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of started operations in case of success, -1 otherwise.
+ * @since 0.0.6
+ *
+ * All the operations queued since the last call are passed to the backend at
+ * once: with a single system call for the io_uring backend, or a single
+ * wake up of the worker thread for the thread backend.
+ */
+P_LIB_API pint			p_async_io_submit		(PAsyncIO		*aio,
+								 PError			**error);
+
+/**
+ * @brief Takes completed operations.
+ * @param aio #PAsyncIO to take the completed operations from.
+ * @param[out] completions Array to put the completed operations into.
+ * @param max Maximum number of operations to take, the size of the
+ * @a completions array.
+ * @param timeout Time to wait for the first completion in milliseconds, 0 to
+ * return immediately or -1 to wait infinitely.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of taken operations (can be 0 if none completed after the
+ * @a timeout), or -1 if error occurred.
+ * @since 0.0.6
+ *
+ * Operations queued but not submitted yet are submitted first. If there are
+ * no operations in flight, the call returns 0 immediately.
+ */
+P_LIB_API pint			p_async_io_get_completions	(PAsyncIO		*aio,
+								 PAsyncIOCompletion	*completions,
+								 pint			max,
+								 pint			timeout,
+								 PError			**error);
+
+/**
+ * @brief Frees a #PAsyncIO engine.
+ * @param aio #PAsyncIO to free.
+ * @since 0.0.6
+ *
+ * Operations in flight are cancelled, connections accepted but not taken yet
+ * are closed.
+ */
+P_LIB_API void			p_async_io_free			(PAsyncIO		*aio);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PASYNCIO_H */
@@ -0,0 +1,236 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "patomic.h"
+#include "pcounter.h"
+#include "pshard-private.h"
+
+/* Values of the different shards are kept on separate cache lines */
+#define P_COUNTER_LINE_VALUES	(P_SHARD_LINE_SIZE / sizeof (psize))
+
+struct PCounter_ {
+	PCounterType	type;
+	puint		shards_mask;
+	psize		*values;
+};
+
+static pssize pp_counter_initial_value (PCounterType type);
+static psize * pp_counter_current_shard (const PCounter *counter);
+static pssize pp_counter_aggregate (PCounterType type, pssize acc, pssize value);
+
+static pssize
+pp_counter_initial_value (PCounterType type)
+{
+	switch (type) {
+	case P_COUNTER_TYPE_MAX:
+		return P_MINSSIZE;
+	case P_COUNTER_TYPE_MIN:
+		return P_MAXSSIZE;
+	default:
+		return 0;
+	}
+}
+
+static psize *
+pp_counter_current_shard (const PCounter *counter)
+{
+	if (counter->shards_mask == 0)
+		return counter->values;
+
+	return counter->values + (psize) (p_shard_get_thread_index () & counter->shards_mask) *
+				 P_COUNTER_LINE_VALUES;
+}
+
+static pssize
+pp_counter_aggregate (PCounterType type, pssize acc, pssize value)
+{
+	switch (type) {
+	case P_COUNTER_TYPE_MAX:
+		return value > acc ? value : acc;
+	case P_COUNTER_TYPE_MIN:
+		return value < acc ? value : acc;
+	default:
+		return (pssize) ((psize) acc + (psize) value);
+	}
+}
+
+P_LIB_API PCounter *
+p_counter_new (PCounterType type)
+{
+	PCounter	*ret;
+	puint		shards;
+	puint		i;
+
+	if (P_UNLIKELY (type != P_COUNTER_TYPE_SUM &&
+			type != P_COUNTER_TYPE_MAX &&
+			type != P_COUNTER_TYPE_MIN))
+		return NULL;
+
+	shards = p_shard_get_count ();
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PCounter))) == NULL)) {
+		P_ERROR ("PCounter::p_counter_new: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->values = p_malloc0 (P_COUNTER_LINE_VALUES * shards * sizeof (psize))) == NULL)) {
+		P_ERROR ("PCounter::p_counter_new: failed(2) to allocate memory");
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->type        = type;
+	ret->shards_mask = shards - 1;
+
+	for (i = 0; i < shards; ++i)
+		ret->values[i * P_COUNTER_LINE_VALUES] = (psize) pp_counter_initial_value (type);
+
+	return ret;
+}
+
+P_LIB_API void
+p_counter_add (PCounter	*counter,
+	       pssize	value)
+{
+	psize	*shard;
+	pssize	current;
+
+	if (P_UNLIKELY (counter == NULL))
+		return;
+
+	shard = pp_counter_current_shard (counter);
+
+	if (counter->type == P_COUNTER_TYPE_SUM) {
+		(void) p_atomic_pointer_add (shard, value);
+		return;
+	}
+
+	/* Most of the updates don't change the tracked value, so check it first
+	 * to avoid writing into the cache line */
+	do {
+		current = (pssize) (psize) p_atomic_pointer_get (shard);
+
+		if (pp_counter_aggregate (counter->type, current, value) == current)
+			return;
+	} while (!p_atomic_pointer_compare_and_exchange (shard,
+							 (ppointer) (psize) current,
+							 (ppointer) (psize) value));
+}
+
+P_LIB_API void
+p_counter_inc (PCounter *counter)
+{
+	p_counter_add (counter, 1);
+}
+
+P_LIB_API void
+p_counter_dec (PCounter *counter)
+{
+	p_counter_add (counter, -1);
+}
+
+P_LIB_API pssize
+p_counter_get (const PCounter *counter)
+{
+	pssize	ret;
+	puint	i;
+
+	if (P_UNLIKELY (counter == NULL))
+		return 0;
+
+	ret = pp_counter_initial_value (counter->type);
+
+	for (i = 0; i <= counter->shards_mask; ++i)
+		ret = pp_counter_aggregate (counter->type,
+					    ret,
+					    (pssize) (psize) p_atomic_pointer_get (&counter->values[i * P_COUNTER_LINE_VALUES]));
+
+	return ret;
+}
+
+P_LIB_API pssize
+p_counter_get_and_reset (PCounter *counter)
+{
+	psize	*shard;
+	pssize	initial;
+	pssize	value;
+	pssize	ret;
+	puint	i;
+
+	if (P_UNLIKELY (counter == NULL))
+		return 0;
+
+	initial = pp_counter_initial_value (counter->type);
+	ret     = initial;
+
+	for (i = 0; i <= counter->shards_mask; ++i) {
+		shard = &counter->values[i * P_COUNTER_LINE_VALUES];
+
+		do {
+			value = (pssize) (psize) p_atomic_pointer_get (shard);
+		} while (!p_atomic_pointer_compare_and_exchange (shard,
+								 (ppointer) (psize) value,
+								 (ppointer) (psize) initial));
+
+		ret = pp_counter_aggregate (counter->type, ret, value);
+	}
+
+	return ret;
+}
+
+P_LIB_API void
+p_counter_reset (PCounter *counter)
+{
+	pssize	initial;
+	puint	i;
+
+	if (P_UNLIKELY (counter == NULL))
+		return;
+
+	initial = pp_counter_initial_value (counter->type);
+
+	for (i = 0; i <= counter->shards_mask; ++i)
+		p_atomic_pointer_set (&counter->values[i * P_COUNTER_LINE_VALUES], (ppointer) (psize) initial);
+}
+
+P_LIB_API PCounterType
+p_counter_get_type (const PCounter *counter)
+{
+	if (P_UNLIKELY (counter == NULL))
+		return P_COUNTER_TYPE_SUM;
+
+	return counter->type;
+}
+
+P_LIB_API void
+p_counter_free (PCounter *counter)
+{
+	if (P_UNLIKELY (counter == NULL))
+		return;
+
+	p_free (counter->values);
+	p_free (counter);
+}
@@ -0,0 +1,186 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pcounter.h
+ * @brief Sharded statistics counter
+ * @author Alexander Saprykin
+ *
+ * A statistics counter is meant to be updated very often from many threads
+ * (i.e. number of processed requests or bytes sent) and to be read rarely
+ * (i.e. when metrics are reported). A single shared atomic variable doesn't
+ * fit well such a pattern: every update from every thread touches the same
+ * CPU cache line, so concurrent threads serialize on it.
+ *
+ * #PCounter keeps several shards of values instead, each one on its own cache
+ * line. Every thread updates only its own shard using atomic operations, so
+ * concurrent threads rarely touch the same memory. Reading the counter
+ * aggregates all the shards, thus it is more expensive than an update.
+ *
+ * There are several types of counters, see #PCounterType:
+ * - #P_COUNTER_TYPE_SUM sums all the values added to it. It can be used both
+ * as a monotonic counter (p_counter_inc()) and as a gauge which goes up and
+ * down (i.e. p_counter_inc() and p_counter_dec() around a request to track the
+ * number of requests in flight);
+ * - #P_COUNTER_TYPE_MAX tracks the maximal value added to it (i.e. the largest
+ * request size or the peak queue depth);
+ * - #P_COUNTER_TYPE_MIN tracks the minimal value added to it.
+ *
+ * Updates are thread-safe and don't involve any locks. A read that happens
+ * concurrently with updates may or may not include them, but never returns a
+ * torn value. Note that if the platform doesn't support lock-free atomic
+ * operations (see p_atomic_is_lock_free()) they are simulated using a global
+ * mutex.
+ *
+ * Counter values have the #pssize type, so they are 32-bit wide on 32-bit
+ * platforms and may overflow there for long running counters.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PCOUNTER_H
+#define PLIBSYS_HEADER_PCOUNTER_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+
+P_BEGIN_DECLS
+
+/** Counter type. */
+typedef enum PCounterType_ {
+	P_COUNTER_TYPE_SUM	= 0,	/**< Sum of all the added values.	*/
+	P_COUNTER_TYPE_MAX	= 1,	/**< Maximal added value.		*/
+	P_COUNTER_TYPE_MIN	= 2	/**< Minimal added value.		*/
+} PCounterType;
+
+/** Sharded counter opaque data structure. */
+typedef struct PCounter_ PCounter;
+
+/**
+ * @brief Creates a new #PCounter object.
+ * @param type Counter type.
+ * @return Pointer to a newly created #PCounter object in case of success,
+ * NULL otherwise.
+ * @since 0.0.6
+ *
+ * The number of internal shards depends on the number of CPUs available in
+ * the system, see p_uthread_ideal_count().
+ */
+P_LIB_API PCounter *	p_counter_new		(PCounterType	type);
+
+/**
+ * @brief Adds a value to a counter.
+ * @param counter #PCounter to add the value to.
+ * @param value Value to add.
+ * @since 0.0.6
+ *
+ * For the #P_COUNTER_TYPE_SUM counter the @a value is added to the total sum,
+ * it may be negative. For the #P_COUNTER_TYPE_MAX and #P_COUNTER_TYPE_MIN
+ * counters the @a value replaces the tracked one only if it is greater or
+ * less accordingly.
+ *
+ * This call is thread-safe and lock-free.
+ */
+P_LIB_API void		p_counter_add		(PCounter	*counter,
+						 pssize		value);
+
+/**
+ * @brief Increments a counter by one.
+ * @param counter #PCounter to increment.
+ * @since 0.0.6
+ *
+ * The same as p_counter_add() with the value of 1.
+ */
+P_LIB_API void		p_counter_inc		(PCounter	*counter);
+
+/**
+ * @brief Decrements a counter by one.
+ * @param counter #PCounter to decrement.
+ * @since 0.0.6
+ *
+ * The same as p_counter_add() with the value of -1.
+ */
+P_LIB_API void		p_counter_dec		(PCounter	*counter);
+
+/**
+ * @brief Gets a value of a counter.
+ * @param counter #PCounter to get the value for.
+ * @return Sum of the added values for the #P_COUNTER_TYPE_SUM counter, the
+ * maximal or minimal added value for the #P_COUNTER_TYPE_MAX or
+ * #P_COUNTER_TYPE_MIN counters accordingly.
+ * @since 0.0.6
+ *
+ * The value is aggregated from all the shards on every call, so it is much
+ * more expensive than an update.
+ *
+ * If nothing has been added to the #P_COUNTER_TYPE_MAX counter since its
+ * creation or the last reset, #P_MINSSIZE is returned. #P_MAXSSIZE is
+ * returned for the #P_COUNTER_TYPE_MIN counter in the same case.
+ */
+P_LIB_API pssize	p_counter_get		(const PCounter	*counter);
+
+/**
+ * @brief Gets a value of a counter and resets it.
+ * @param counter #PCounter to get the value for.
+ * @return Counter value, see p_counter_get().
+ * @since 0.0.6
+ *
+ * Every shard is swapped with its initial value atomically, so no update is
+ * lost when the counter is being updated concurrently: it is either included
+ * into the returned value or is left in the counter. This call is useful to
+ * report values gathered over some interval.
+ */
+P_LIB_API pssize	p_counter_get_and_reset	(PCounter	*counter);
+
+/**
+ * @brief Resets a counter to its initial state.
+ * @param counter #PCounter to reset.
+ * @since 0.0.6
+ *
+ * Updates performed concurrently with the reset may be lost, use
+ * p_counter_get_and_reset() if that matters.
+ */
+P_LIB_API void		p_counter_reset		(PCounter	*counter);
+
+/**
+ * @brief Gets a type of a counter.
+ * @param counter #PCounter to get the type for.
+ * @return Counter type.
+ * @since 0.0.6
+ */
+P_LIB_API PCounterType	p_counter_get_type	(const PCounter	*counter);
+
+/**
+ * @brief Frees #PCounter object.
+ * @param counter #PCounter to free.
+ * @since 0.0.6
+ */
+P_LIB_API void		p_counter_free		(PCounter	*counter);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PCOUNTER_H */
@@ -28,6 +28,8 @@
 #include "pstring.h"
 #include "perror-private.h"
 
+#include <string.h>
+
 #ifndef P_OS_WIN
 #  if defined (P_OS_OS2)
 #    define INCL_DOSERRORS
@@ -37,12 +39,67 @@
 #  include <errno.h>
 #endif
 
+/* The first field mirrors the flag of PErrorStorage */
 struct PError_ {
-	pint	code;
-	pint	native_code;
-	pchar	*message;
+	pboolean	in_storage;
+	pint		code;
+	pint		native_code;
+	const pchar	*message;
+	puint		owns_message	: 1;
 };
 
+/* Make sure that the error object fits the caller storage */
+typedef pchar pp_error_storage_check[sizeof (PError) <= sizeof (PErrorStorage) ? 1 : -1];
+
+static void pp_error_release_message (PError *error);
+static pboolean pp_error_is_fillable (PError **error);
+static void pp_error_fill (PError *error, pint code, pint native_code, const pchar *message, pboolean is_static);
+
+static void
+pp_error_release_message (PError *error)
+{
+	if (error->owns_message)
+		p_free ((pchar *) error->message);
+
+	error->message      = NULL;
+	error->owns_message = FALSE;
+}
+
+/* A static error can be reported either through an empty pointer, or into a
+ * caller storage which doesn't hold any error yet */
+static pboolean
+pp_error_is_fillable (PError **error)
+{
+	if (error == NULL)
+		return FALSE;
+
+	if (*error == NULL)
+		return TRUE;
+
+	return (*error)->in_storage == TRUE && (*error)->code == 0 && (*error)->message == NULL;
+}
+
+static void
+pp_error_fill (PError		*error,
+	       pint		code,
+	       pint		native_code,
+	       const pchar	*message,
+	       pboolean		is_static)
+{
+	pp_error_release_message (error);
+
+	error->code        = code;
+	error->native_code = native_code;
+
+	if (is_static || message == NULL) {
+		error->message      = message;
+		error->owns_message = FALSE;
+	} else {
+		error->message      = p_strdup (message);
+		error->owns_message = error->message != NULL;
+	}
+}
+
 PErrorIO
 p_error_get_io_from_system (pint err_code)
 {
@@ -672,9 +729,39 @@ p_error_new_literal (pint		code,
 	if (P_UNLIKELY ((ret = p_error_new ()) == NULL))
 		return NULL;
 
-	ret->code        = code;
-	ret->native_code = native_code;
-	ret->message     = p_strdup (message);
+	pp_error_fill (ret, code, native_code, message, FALSE);
+
+	return ret;
+}
+
+P_LIB_API PError *
+p_error_new_static (pint	code,
+		    pint	native_code,
+		    const pchar	*message)
+{
+	PError *ret;
+
+	if (P_UNLIKELY ((ret = p_error_new ()) == NULL))
+		return NULL;
+
+	pp_error_fill (ret, code, native_code, message, TRUE);
+
+	return ret;
+}
+
+P_LIB_API PError *
+p_error_init (PErrorStorage *storage)
+{
+	PError *ret;
+
+	if (P_UNLIKELY (storage == NULL))
+		return NULL;
+
+	memset (storage, 0, sizeof (PErrorStorage));
+
+	storage->in_storage = TRUE;
+
+	ret = (PError *) storage;
 
 	return ret;
 }
@@ -728,11 +815,12 @@ p_error_copy (const PError *error)
 	if (P_UNLIKELY (error == NULL))
 		return NULL;
 
-	if (P_UNLIKELY ((ret = p_error_new_literal (error->code,
-						    error->native_code,
-						    error->message)) == NULL))
+	if (P_UNLIKELY ((ret = p_error_new ()) == NULL))
 		return NULL;
 
+	/* Static message can be shared by the copy as well */
+	pp_error_fill (ret, error->code, error->native_code, error->message, !error->owns_message);
+
 	return ret;
 }
 
@@ -745,12 +833,7 @@ p_error_set_error (PError	*error,
 	if (P_UNLIKELY (error == NULL))
 		return;
 
-	if (error->message != NULL)
-		p_free (error->message);
-
-	error->code        = code;
-	error->native_code = native_code;
-	error->message     = p_strdup (message);
+	pp_error_fill (error, code, native_code, message, FALSE);
 }
 
 P_LIB_API void
@@ -765,6 +848,21 @@ p_error_set_error_p (PError		**error,
 	*error = p_error_new_literal (code, native_code, message);
 }
 
+P_LIB_API void
+p_error_set_error_static_p (PError	**error,
+			    pint	code,
+			    pint	native_code,
+			    const pchar	*message)
+{
+	if (!pp_error_is_fillable (error))
+		return;
+
+	if (*error == NULL)
+		*error = p_error_new_static (code, native_code, message);
+	else
+		pp_error_fill (*error, code, native_code, message, TRUE);
+}
+
 P_LIB_API void
 p_error_set_code (PError	*error,
 		  pint		code)
@@ -792,10 +890,7 @@ p_error_set_message (PError		*error,
 	if (P_UNLIKELY (error == NULL))
 		return;
 
-	if (error->message != NULL)
-		p_free (error->message);
-
-	error->message = p_strdup (message);
+	pp_error_fill (error, error->code, error->native_code, message, FALSE);
 }
 
 P_LIB_API void
@@ -804,10 +899,8 @@ p_error_clear (PError *error)
 	if (P_UNLIKELY (error == NULL))
 		return;
 
-	if (error->message != NULL)
-		p_free (error->message);
+	pp_error_release_message (error);
 
-	error->message     = NULL;
 	error->code        = 0;
 	error->native_code = 0;
 }
@@ -818,8 +911,13 @@ p_error_free (PError	*error)
 	if (P_UNLIKELY (error == NULL))
 		return;
 
-	if (error->message != NULL)
-		p_free (error->message);
+	/* Caller storage is not ours to free, just make it empty again */
+	if (error->in_storage) {
+		p_error_clear (error);
+		return;
+	}
+
+	pp_error_release_message (error);
 
 	p_free (error);
 }
@@ -43,6 +43,27 @@
  * pointer into an API call. Simply initialize it with zero and check the result
  * after. Therefore you need to free memory if an error occurred.
  *
+ * Some failures are expected and frequent, i.e. a non-blocking socket which
+ * would block. To report such errors without touching the heap, put the error
+ * object into a caller-owned #PErrorStorage with p_error_init() and pass it
+ * instead of the NULL pointer:
+ * @code
+ * PErrorStorage storage;
+ * PError *error = p_error_init (&storage);
+ * ...
+ *
+ * if (p_error_get_code (error) != 0) {
+ *         ...
+ *         p_error_clear (error);
+ * }
+ * @endcode
+ * Only p_error_set_error_static_p() fills such an error in place, and only if
+ * it is empty, so clear it before the next call. The library reports this way
+ * only the expected failures on the hot paths: socket I/O which would block or
+ * times out. The messages are static and never copied, so these failures do not
+ * allocate any memory. Other errors are reported with p_error_set_error_p(),
+ * which leaves a non-NULL error untouched, including the one in the storage.
+ *
  * Most operating systems store the last error code of the most system calls in
  * a thread-specific variable. Moreover, Windows stores the error code of the
  * last socket related call in a separate variable. Use
@@ -67,6 +88,22 @@ P_BEGIN_DECLS
 /** Opaque data structure for an error object. */
 typedef struct PError_ PError;
 
+/** Size of #PErrorStorage, in bytes. */
+#define P_ERROR_STORAGE_SIZE	32
+
+/**
+ * Caller-owned storage for a #PError. Use p_error_init() to prepare it, the
+ * rest of the contents is opaque.
+ */
+typedef struct PErrorStorage_ {
+	pboolean	in_storage;	/**< Set by p_error_init(), do not modify.	*/
+	union {
+		puint64		align;
+		ppointer	align_ptr;
+		puchar		data[P_ERROR_STORAGE_SIZE];
+	} u;
+} PErrorStorage;
+
 /**
  * @brief Initializes a new empty #PError.
  * @return Newly initialized #PError object in case of success, NULL otherwise.
@@ -86,6 +123,37 @@ P_LIB_API PError *	p_error_new_literal	(pint		code,
 						 pint		native_code,
 						 const pchar	*message);
 
+/**
+ * @brief Initializes a new #PError with a static message.
+ * @param code Error code.
+ * @param native_code Native error code, leave 0 to ignore.
+ * @param message Error message, must stay valid during the error lifetime.
+ * @return Newly initialized #PError object in case of success, NULL otherwise.
+ * @since 0.0.6
+ *
+ * Unlike p_error_new_literal() the message is not copied, only the pointer to
+ * it is stored. Use it for the string literals.
+ */
+P_LIB_API PError *	p_error_new_static	(pint		code,
+						 pint		native_code,
+						 const pchar	*message);
+
+/**
+ * @brief Initializes an empty #PError inside the caller-owned storage.
+ * @param storage Storage to put the error object into.
+ * @return Pointer to the initialized #PError in case of success, NULL
+ * otherwise.
+ * @since 0.0.6
+ *
+ * The returned object lives in @a storage and doesn't require any memory
+ * allocations. Pass its address to the API calls in place of a pointer to
+ * NULL: p_error_set_error_static_p() fills it in place while it is empty
+ * (i.e. its code is 0), p_error_set_error_p() leaves it untouched as any other
+ * non-NULL error. Use p_error_clear() to make it empty again. p_error_free()
+ * only releases the copied message, if any, the storage itself is not freed.
+ */
+P_LIB_API PError *	p_error_init		(PErrorStorage	*storage);
+
 /**
  * @brief Gets an error message.
  * @param error #PError object to get the message from.
@@ -161,6 +229,27 @@ P_LIB_API void		p_error_set_error_p	(PError		**error,
 						 pint		native_code,
 						 const pchar	*message);
 
+/**
+ * @brief Sets error data with a static message through a double pointer.
+ * @param error #PError object to set the data for.
+ * @param code Error code.
+ * @param native_code Native error code, leave 0 to ignore.
+ * @param message Error message, must stay valid during the error lifetime.
+ * @since 0.0.6
+ *
+ * Works the same way as p_error_set_error_p() but doesn't copy the message,
+ * only the pointer to it is stored. In addition, if @a *error is an empty
+ * #PError initialized with p_error_init(), it is filled in place, so the error
+ * is reported without any memory allocations.
+ *
+ * @warning Unlike p_error_set_error_p(), @a *error is read to check for the
+ * caller storage, so it must be either NULL or a valid #PError object.
+ */
+P_LIB_API void		p_error_set_error_static_p	(PError		**error,
+							 pint		code,
+							 pint		native_code,
+							 const pchar	*message);
+
 /**
  * @brief Sets an error code.
  * @param error #PError object to set the code for.
@@ -200,6 +289,8 @@ P_LIB_API void		p_error_clear		(PError		*error);
  * @brief Frees a previously initialized error object.
  * @param error #PError object to free.
  * @since 0.0.1
+ * @note An error object from p_error_init() is only cleared, its storage
+ * belongs to the caller.
  */
 P_LIB_API void		p_error_free		(PError		*error);
 
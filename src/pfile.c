@@ -24,13 +24,91 @@
  */
 
 #include "perror.h"
+#include "pmem.h"
 #include "pfile.h"
 #include "perror-private.h"
+#include "psysclose-private.h"
 
 #ifndef P_OS_WIN
 #  include <unistd.h>
 #endif
 
+#if !defined (P_OS_WIN) && !defined (P_OS_BEOS) && !defined (P_OS_OS2) && !defined (P_OS_AMIGA)
+#  define P_MAPPED_FILE_HAS_MMAP
+#  include <sys/types.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  if defined (POSIX_MADV_NORMAL) || defined (MADV_NORMAL)
+#    define P_MAPPED_FILE_HAS_MADVISE
+#  endif
+#endif
+
+struct PMappedFile_ {
+	ppointer	map_addr;
+	psize		map_size;
+	ppointer	addr;
+	psize		size;
+	PMappedFileMode	mode;
+#ifdef P_OS_WIN
+	HANDLE		file_hdl;
+#endif
+};
+
+#if defined (P_OS_WIN) || defined (P_MAPPED_FILE_HAS_MMAP)
+static psize pp_mapped_file_get_granularity (void);
+static pboolean pp_mapped_file_get_range (const PMappedFile *file, psize offset, psize length,
+					  ppointer *start, psize *size);
+
+static psize
+pp_mapped_file_get_granularity (void)
+{
+#ifdef P_OS_WIN
+	SYSTEM_INFO	sys_info;
+
+	GetSystemInfo (&sys_info);
+
+	return (psize) sys_info.dwAllocationGranularity;
+#else
+	plong		page_size;
+
+#  ifdef _SC_PAGESIZE
+	page_size = sysconf (_SC_PAGESIZE);
+#  else
+	page_size = (plong) getpagesize ();
+#  endif
+
+	return page_size > 0 ? (psize) page_size : 4096;
+#endif
+}
+
+static pboolean
+pp_mapped_file_get_range (const PMappedFile	*file,
+			  psize			offset,
+			  psize			length,
+			  ppointer		*start,
+			  psize			*size)
+{
+	psize	page_size;
+	psize	delta;
+
+	if (P_UNLIKELY (offset > file->size || (length > 0 && length > file->size - offset)))
+		return FALSE;
+
+	if (length == 0)
+		length = file->size - offset;
+
+	/* System calls require a page-aligned address */
+	page_size = pp_mapped_file_get_granularity ();
+	delta     = ((psize) ((puchar *) file->addr + offset - (puchar *) file->map_addr)) % page_size;
+
+	*start = (puchar *) file->addr + offset - delta;
+	*size  = length + delta;
+
+	return TRUE;
+}
+#endif
+
 P_LIB_API pboolean
 p_file_is_exists (const pchar *file)
 {
@@ -78,3 +156,445 @@ p_file_remove (const pchar	*file,
 
 	return result;
 }
+
+P_LIB_API PMappedFile *
+p_mapped_file_new (const pchar		*path,
+		   PMappedFileMode	mode,
+		   PError		**error)
+{
+	return p_mapped_file_new_range (path, mode, 0, 0, error);
+}
+
+P_LIB_API PMappedFile *
+p_mapped_file_new_range (const pchar		*path,
+			 PMappedFileMode	mode,
+			 puint64		offset,
+			 psize			length,
+			 PError			**error)
+{
+#if defined (P_OS_WIN) || defined (P_MAPPED_FILE_HAS_MMAP)
+	PMappedFile	*ret;
+	puint64		file_size;
+	puint64		map_offset;
+	psize		granularity;
+#  ifdef P_OS_WIN
+	LARGE_INTEGER	win_size;
+	HANDLE		map_hdl;
+	DWORD		access;
+	DWORD		protect;
+	DWORD		map_access;
+#  else
+	struct stat	stat_buf;
+	pint		fd;
+	pint		flags;
+	pint		prot;
+#  endif
+#endif
+
+	if (P_UNLIKELY (path == NULL ||
+			mode < P_MAPPED_FILE_MODE_READ_ONLY ||
+			mode > P_MAPPED_FILE_MODE_COPY_ON_WRITE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+#if defined (P_OS_WIN) || defined (P_MAPPED_FILE_HAS_MMAP)
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PMappedFile))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for mapped file");
+		return NULL;
+	}
+
+	ret->mode = mode;
+
+#  ifdef P_OS_WIN
+	access = mode == P_MAPPED_FILE_MODE_READ_WRITE ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ;
+
+	if (P_UNLIKELY ((ret->file_hdl = CreateFileA ((LPCSTR) path,
+						      access,
+						      FILE_SHARE_READ | FILE_SHARE_WRITE,
+						      NULL,
+						      OPEN_EXISTING,
+						      FILE_ATTRIBUTE_NORMAL,
+						      NULL)) == INVALID_HANDLE_VALUE)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call CreateFile() to open file");
+		p_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY (GetFileSizeEx (ret->file_hdl, &win_size) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call GetFileSizeEx() to get file size");
+		p_mapped_file_free (ret);
+		return NULL;
+	}
+
+	file_size = (puint64) win_size.QuadPart;
+#  else
+	flags = mode == P_MAPPED_FILE_MODE_READ_WRITE ? O_RDWR : O_RDONLY;
+
+	if (P_UNLIKELY ((fd = open (path, flags)) == -1)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call open() to open file");
+		p_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY (fstat (fd, &stat_buf) == -1)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call fstat() to get file size");
+
+		if (P_UNLIKELY (p_sys_close (fd) != 0))
+			P_WARNING ("PFile::p_mapped_file_new_range: failed to close file descriptor");
+
+		p_free (ret);
+		return NULL;
+	}
+
+	file_size = (puint64) stat_buf.st_size;
+#  endif
+
+	if (P_UNLIKELY (offset > file_size ||
+			(length > 0 && (puint64) length > file_size - offset) ||
+			(length == 0 && file_size - offset > (puint64) ((psize) -1)))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Mapping range is out of the file bounds");
+#  ifndef P_OS_WIN
+		if (P_UNLIKELY (p_sys_close (fd) != 0))
+			P_WARNING ("PFile::p_mapped_file_new_range: failed to close file descriptor");
+#  endif
+		p_mapped_file_free (ret);
+		return NULL;
+	}
+
+	ret->size = length > 0 ? length : (psize) (file_size - offset);
+
+	/* Nothing to map, but it's still a valid mapping of an empty range */
+	if (ret->size == 0) {
+#  ifndef P_OS_WIN
+		if (P_UNLIKELY (p_sys_close (fd) != 0))
+			P_WARNING ("PFile::p_mapped_file_new_range: failed to close file descriptor");
+#  endif
+		return ret;
+	}
+
+	/* Mapping offset must be aligned to the allocation granularity */
+	granularity   = pp_mapped_file_get_granularity ();
+	map_offset    = offset - offset % granularity;
+	ret->map_size = ret->size + (psize) (offset - map_offset);
+
+#  ifdef P_OS_WIN
+	switch (mode) {
+	case P_MAPPED_FILE_MODE_READ_WRITE:
+		protect    = PAGE_READWRITE;
+		map_access = FILE_MAP_WRITE;
+		break;
+	case P_MAPPED_FILE_MODE_COPY_ON_WRITE:
+		protect    = PAGE_WRITECOPY;
+		map_access = FILE_MAP_COPY;
+		break;
+	default:
+		protect    = PAGE_READONLY;
+		map_access = FILE_MAP_READ;
+	}
+
+	if (P_UNLIKELY ((map_hdl = CreateFileMappingA (ret->file_hdl,
+						       NULL,
+						       protect,
+						       0,
+						       0,
+						       NULL)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call CreateFileMapping() to create file mapping");
+		p_mapped_file_free (ret);
+		return NULL;
+	}
+
+	ret->map_addr = MapViewOfFile (map_hdl,
+				       map_access,
+				       (DWORD) (map_offset >> 32),
+				       (DWORD) (map_offset & 0xFFFFFFFF),
+				       ret->map_size);
+
+	if (P_UNLIKELY (ret->map_addr == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call MapViewOfFile() to map file view");
+		CloseHandle (map_hdl);
+		p_mapped_file_free (ret);
+		return NULL;
+	}
+
+	/* The view keeps the mapping object alive */
+	if (P_UNLIKELY (!CloseHandle (map_hdl)))
+		P_WARNING ("PFile::p_mapped_file_new_range: CloseHandle() failed");
+#  else
+	prot  = PROT_READ;
+	flags = MAP_SHARED;
+
+	if (mode == P_MAPPED_FILE_MODE_READ_WRITE)
+		prot |= PROT_WRITE;
+	else if (mode == P_MAPPED_FILE_MODE_COPY_ON_WRITE) {
+		prot  |= PROT_WRITE;
+		flags  = MAP_PRIVATE;
+	}
+
+	ret->map_addr = mmap (NULL, ret->map_size, prot, flags, fd, (off_t) map_offset);
+
+	if (P_UNLIKELY (ret->map_addr == (void *) -1)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call mmap() to map file");
+
+		if (P_UNLIKELY (p_sys_close (fd) != 0))
+			P_WARNING ("PFile::p_mapped_file_new_range: failed to close file descriptor");
+
+		ret->map_addr = NULL;
+		p_mapped_file_free (ret);
+		return NULL;
+	}
+
+	/* The mapping stays valid after closing the descriptor */
+	if (P_UNLIKELY (p_sys_close (fd) != 0))
+		P_WARNING ("PFile::p_mapped_file_new_range: failed to close file descriptor");
+#  endif
+
+	ret->addr = (puchar *) ret->map_addr + (offset - map_offset);
+
+	return ret;
+#else
+	P_UNUSED (offset);
+	P_UNUSED (length);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_IMPLEMENTED,
+			     0,
+			     "File mapping is not supported on this platform");
+	return NULL;
+#endif
+}
+
+P_LIB_API ppointer
+p_mapped_file_get_address (const PMappedFile *file)
+{
+	if (P_UNLIKELY (file == NULL))
+		return NULL;
+
+	return file->addr;
+}
+
+P_LIB_API psize
+p_mapped_file_get_size (const PMappedFile *file)
+{
+	if (P_UNLIKELY (file == NULL))
+		return 0;
+
+	return file->size;
+}
+
+P_LIB_API pboolean
+p_mapped_file_advise (PMappedFile		*file,
+		      PMappedFileAdvice		advice,
+		      psize			offset,
+		      psize			length,
+		      PError			**error)
+{
+#ifdef P_MAPPED_FILE_HAS_MADVISE
+	ppointer	start;
+	psize		size;
+	pint		native_advice;
+	pint		res;
+#endif
+
+	if (P_UNLIKELY (file == NULL ||
+			advice < P_MAPPED_FILE_ADVICE_NORMAL ||
+			advice > P_MAPPED_FILE_ADVICE_DONT_NEED)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+#ifdef P_MAPPED_FILE_HAS_MADVISE
+	if (P_UNLIKELY (pp_mapped_file_get_range (file, offset, length, &start, &size) == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Advice range is out of the mapping bounds");
+		return FALSE;
+	}
+
+	if (size == 0)
+		return TRUE;
+
+#  ifdef POSIX_MADV_NORMAL
+	switch (advice) {
+	case P_MAPPED_FILE_ADVICE_SEQUENTIAL:
+		native_advice = POSIX_MADV_SEQUENTIAL;
+		break;
+	case P_MAPPED_FILE_ADVICE_RANDOM:
+		native_advice = POSIX_MADV_RANDOM;
+		break;
+	case P_MAPPED_FILE_ADVICE_WILL_NEED:
+		native_advice = POSIX_MADV_WILLNEED;
+		break;
+	case P_MAPPED_FILE_ADVICE_DONT_NEED:
+		native_advice = POSIX_MADV_DONTNEED;
+		break;
+	default:
+		native_advice = POSIX_MADV_NORMAL;
+	}
+
+	/* posix_madvise() returns an error code instead of setting errno */
+	if (P_UNLIKELY ((res = posix_madvise (start, size, native_advice)) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (res),
+				     res,
+				     "Failed to call posix_madvise() to set access pattern");
+		return FALSE;
+	}
+#  else
+	switch (advice) {
+	case P_MAPPED_FILE_ADVICE_SEQUENTIAL:
+		native_advice = MADV_SEQUENTIAL;
+		break;
+	case P_MAPPED_FILE_ADVICE_RANDOM:
+		native_advice = MADV_RANDOM;
+		break;
+	case P_MAPPED_FILE_ADVICE_WILL_NEED:
+		native_advice = MADV_WILLNEED;
+		break;
+	case P_MAPPED_FILE_ADVICE_DONT_NEED:
+		/* MADV_DONTNEED drops private changes on some systems */
+		return TRUE;
+	default:
+		native_advice = MADV_NORMAL;
+	}
+
+	if (P_UNLIKELY ((res = madvise (start, size, native_advice)) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call madvise() to set access pattern");
+		return FALSE;
+	}
+#  endif
+
+	return TRUE;
+#else
+	P_UNUSED (offset);
+	P_UNUSED (length);
+
+	return TRUE;
+#endif
+}
+
+P_LIB_API pboolean
+p_mapped_file_sync (PMappedFile	*file,
+		    psize	offset,
+		    psize	length,
+		    pboolean	async,
+		    PError	**error)
+{
+#if defined (P_OS_WIN) || defined (P_MAPPED_FILE_HAS_MMAP)
+	ppointer	start;
+	psize		size;
+#endif
+
+	if (P_UNLIKELY (file == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+#if defined (P_OS_WIN) || defined (P_MAPPED_FILE_HAS_MMAP)
+	if (P_UNLIKELY (pp_mapped_file_get_range (file, offset, length, &start, &size) == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Sync range is out of the mapping bounds");
+		return FALSE;
+	}
+
+	if (size == 0 || file->mode != P_MAPPED_FILE_MODE_READ_WRITE)
+		return TRUE;
+
+#  ifdef P_OS_WIN
+	if (P_UNLIKELY (FlushViewOfFile (start, size) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call FlushViewOfFile() to sync file mapping");
+		return FALSE;
+	}
+
+	if (async == FALSE && P_UNLIKELY (FlushFileBuffers (file->file_hdl) == 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call FlushFileBuffers() to sync file mapping");
+		return FALSE;
+	}
+#  else
+	if (P_UNLIKELY (msync (start, size, async ? MS_ASYNC : MS_SYNC) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_io (),
+				     p_error_get_last_system (),
+				     "Failed to call msync() to sync file mapping");
+		return FALSE;
+	}
+#  endif
+
+	return TRUE;
+#else
+	P_UNUSED (offset);
+	P_UNUSED (length);
+	P_UNUSED (async);
+
+	return TRUE;
+#endif
+}
+
+P_LIB_API void
+p_mapped_file_free (PMappedFile *file)
+{
+	if (P_UNLIKELY (file == NULL))
+		return;
+
+#ifdef P_OS_WIN
+	if (file->map_addr != NULL && P_UNLIKELY (UnmapViewOfFile (file->map_addr) == 0))
+		P_WARNING ("PFile::p_mapped_file_free: UnmapViewOfFile() failed");
+
+	if (file->file_hdl != INVALID_HANDLE_VALUE && file->file_hdl != NULL &&
+	    P_UNLIKELY (!CloseHandle (file->file_hdl)))
+		P_WARNING ("PFile::p_mapped_file_free: CloseHandle() failed");
+#elif defined (P_MAPPED_FILE_HAS_MMAP)
+	if (file->map_addr != NULL && P_UNLIKELY (munmap (file->map_addr, file->map_size) != 0))
+		P_WARNING ("PFile::p_mapped_file_free: munmap() failed");
+#endif
+
+	p_free (file);
+}
@@ -31,6 +31,20 @@
  * To check file existance use p_file_is_exists(). To remove an exisiting file
  * use p_file_remove().
  *
+ * #PMappedFile maps a file (or a part of it) into the process address space,
+ * so the file contents can be accessed directly through memory without
+ * copying it into intermediate buffers. Use p_mapped_file_new() to map the
+ * whole file or p_mapped_file_new_range() to map only a part of it, which is
+ * useful for the files larger than the available address space. The mapped
+ * memory is accessible with p_mapped_file_get_address() and
+ * p_mapped_file_get_size().
+ *
+ * The file can be mapped as read-only, read-write (changes go to the file) or
+ * copy-on-write (changes are private to the mapping). Access pattern hints can
+ * be given with p_mapped_file_advise(), they help the operating system to
+ * choose a read-ahead policy. Use p_mapped_file_sync() to flush the changes of
+ * a read-write mapping to the disk.
+ *
  * #P_DIR_SEPARATOR provides a platform independent directory separator symbol
  * which you can use to form file or directory path.
  */
@@ -82,6 +96,135 @@ P_LIB_API pboolean p_file_is_exists	(const pchar	*file);
 P_LIB_API pboolean p_file_remove	(const pchar	*file,
 					 PError		**error);
 
+/** File mapping access mode. */
+typedef enum PMappedFileMode_ {
+	P_MAPPED_FILE_MODE_READ_ONLY		= 0,	/**< Read-only access.				*/
+	P_MAPPED_FILE_MODE_READ_WRITE		= 1,	/**< Read-write access, changes are written
+							     to the file.				*/
+	P_MAPPED_FILE_MODE_COPY_ON_WRITE	= 2	/**< Read-write access, changes are private
+							     to the mapping.				*/
+} PMappedFileMode;
+
+/** File mapping access pattern hint. */
+typedef enum PMappedFileAdvice_ {
+	P_MAPPED_FILE_ADVICE_NORMAL		= 0,	/**< No special treatment.			*/
+	P_MAPPED_FILE_ADVICE_SEQUENTIAL		= 1,	/**< Pages are accessed sequentially.		*/
+	P_MAPPED_FILE_ADVICE_RANDOM		= 2,	/**< Pages are accessed randomly.		*/
+	P_MAPPED_FILE_ADVICE_WILL_NEED		= 3,	/**< Pages will be accessed soon.		*/
+	P_MAPPED_FILE_ADVICE_DONT_NEED		= 4	/**< Pages won't be accessed soon.		*/
+} PMappedFileAdvice;
+
+/** Memory-mapped file opaque structure. */
+typedef struct PMappedFile_ PMappedFile;
+
+/**
+ * @brief Maps a whole file into memory.
+ * @param path Path to the file to map.
+ * @param mode File mapping access mode.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PMappedFile in case of success, NULL otherwise.
+ * @since 0.0.6
+ *
+ * The file must exist. Mapping an empty file succeeds, but the mapped address
+ * is NULL and the size is zero in that case.
+ */
+P_LIB_API PMappedFile *	p_mapped_file_new		(const pchar		*path,
+							 PMappedFileMode	mode,
+							 PError			**error);
+
+/**
+ * @brief Maps a part of a file into memory.
+ * @param path Path to the file to map.
+ * @param mode File mapping access mode.
+ * @param offset Offset in the file to start mapping from, in bytes. Doesn't
+ * need to be aligned to the page size.
+ * @param length Number of bytes to map, 0 to map up to the end of the file.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PMappedFile in case of success, NULL otherwise.
+ * @since 0.0.6
+ *
+ * The mapped range must be within the file, mapping can't be used to extend
+ * the file.
+ */
+P_LIB_API PMappedFile *	p_mapped_file_new_range		(const pchar		*path,
+							 PMappedFileMode	mode,
+							 puint64		offset,
+							 psize			length,
+							 PError			**error);
+
+/**
+ * @brief Gets an address of the mapped file data.
+ * @param file #PMappedFile to get the address for.
+ * @return Pointer to the mapped data in case of success, NULL otherwise.
+ * @since 0.0.6
+ *
+ * The returned pointer corresponds to the offset given to
+ * p_mapped_file_new_range(), or to the start of the file.
+ */
+P_LIB_API ppointer	p_mapped_file_get_address	(const PMappedFile	*file);
+
+/**
+ * @brief Gets a size of the mapped file data.
+ * @param file #PMappedFile to get the size for.
+ * @return Size of the mapped data in bytes in case of success, 0 otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API psize		p_mapped_file_get_size		(const PMappedFile	*file);
+
+/**
+ * @brief Gives the operating system a hint about the mapped data access
+ * pattern.
+ * @param file #PMappedFile to give the hint for.
+ * @param advice Access pattern hint.
+ * @param offset Offset of the range to apply the hint to, relative to the
+ * mapped data address.
+ * @param length Length of the range, 0 to apply up to the end of the mapped
+ * data.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * Hints are optional: if the platform doesn't support them, the call does
+ * nothing and returns TRUE.
+ */
+P_LIB_API pboolean	p_mapped_file_advise		(PMappedFile		*file,
+							 PMappedFileAdvice	advice,
+							 psize			offset,
+							 psize			length,
+							 PError			**error);
+
+/**
+ * @brief Writes the changes of the mapped data back to the file.
+ * @param file #PMappedFile to sync.
+ * @param offset Offset of the range to sync, relative to the mapped data
+ * address.
+ * @param length Length of the range, 0 to sync up to the end of the mapped
+ * data.
+ * @param async Whether to only schedule writing instead of waiting for it to
+ * complete.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * Has a meaning only for the #P_MAPPED_FILE_MODE_READ_WRITE mapping, for the
+ * others it does nothing.
+ */
+P_LIB_API pboolean	p_mapped_file_sync		(PMappedFile		*file,
+							 psize			offset,
+							 psize			length,
+							 pboolean		async,
+							 PError			**error);
+
+/**
+ * @brief Unmaps a file and frees the #PMappedFile.
+ * @param file #PMappedFile to free.
+ * @since 0.0.6
+ *
+ * Changes of a read-write mapping which were not synced explicitly are written
+ * to the file by the operating system later.
+ */
+P_LIB_API void		p_mapped_file_free		(PMappedFile		*file);
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PFILE_H */
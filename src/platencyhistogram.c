@@ -0,0 +1,388 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Log-linear bucket layout (precision P, S = 2^P, H = 2^(P-1)):
+ *   values [0, S) are counted exactly in buckets [0, S);
+ *   values in [2^k, 2^(k+1)) for k >= P are split into H equal sub-buckets,
+ *   which start from the bucket S + (k - P) * H.
+ * So every value is stored with at least P significant bits. */
+
+#include "pmem.h"
+#include "patomic.h"
+#include "platencyhistogram.h"
+#include "pshard-private.h"
+
+/* Number of counters in a cache line, shards are aligned to it */
+#define P_LATENCY_HISTOGRAM_LINE_COUNTERS	(P_SHARD_LINE_SIZE / sizeof (psize))
+
+struct PLatencyHistogram_ {
+	pint		precision;
+	psize		buckets;
+	psize		stride;
+	puint		shards_mask;
+	psize		*counts;
+};
+
+static PLatencyHistogram * pp_latency_histogram_new_with_shards (pint precision, puint shards);
+static pint pp_latency_histogram_msb (puint64 value);
+static psize pp_latency_histogram_value_to_bucket (pint precision, puint64 value);
+static puint64 pp_latency_histogram_bucket_low (pint precision, psize bucket);
+static puint64 pp_latency_histogram_bucket_high (pint precision, psize bucket);
+static psize pp_latency_histogram_get_bucket_count (const PLatencyHistogram *hist, psize bucket);
+static psize * pp_latency_histogram_current_shard (const PLatencyHistogram *hist);
+
+static PLatencyHistogram *
+pp_latency_histogram_new_with_shards (pint precision, puint shards)
+{
+	PLatencyHistogram *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PLatencyHistogram))) == NULL)) {
+		P_ERROR ("PLatencyHistogram::pp_latency_histogram_new_with_shards: failed(1) to allocate memory");
+		return NULL;
+	}
+
+	ret->precision   = precision;
+	ret->buckets     = ((psize) 1 << precision) + (psize) (64 - precision) * ((psize) 1 << (precision - 1));
+	ret->shards_mask = shards - 1;
+
+	ret->stride = (ret->buckets + P_LATENCY_HISTOGRAM_LINE_COUNTERS - 1) /
+		      P_LATENCY_HISTOGRAM_LINE_COUNTERS * P_LATENCY_HISTOGRAM_LINE_COUNTERS;
+
+	if (P_UNLIKELY ((ret->counts = p_malloc0 (ret->stride * shards * sizeof (psize))) == NULL)) {
+		P_ERROR ("PLatencyHistogram::pp_latency_histogram_new_with_shards: failed(2) to allocate memory");
+		p_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+static pint
+pp_latency_histogram_msb (puint64 value)
+{
+#if defined (P_CC_GNU)
+	return 63 - __builtin_clzll (value);
+#else
+	pint ret = 0;
+
+	if (value >> 32) { value >>= 32; ret += 32; }
+	if (value >> 16) { value >>= 16; ret += 16; }
+	if (value >> 8)  { value >>= 8;  ret += 8;  }
+	if (value >> 4)  { value >>= 4;  ret += 4;  }
+	if (value >> 2)  { value >>= 2;  ret += 2;  }
+	if (value >> 1)  { ret += 1; }
+
+	return ret;
+#endif
+}
+
+static psize
+pp_latency_histogram_value_to_bucket (pint precision, puint64 value)
+{
+	psize	half;
+	pint	shift;
+
+	if (value < ((puint64) 1 << precision))
+		return (psize) value;
+
+	half  = (psize) 1 << (precision - 1);
+	shift = pp_latency_histogram_msb (value) - (precision - 1);
+
+	return ((psize) 1 << precision) + (psize) (shift - 1) * half + (psize) (value >> shift) - half;
+}
+
+static puint64
+pp_latency_histogram_bucket_low (pint precision, psize bucket)
+{
+	psize	half;
+	pint	shift;
+
+	if (bucket < ((psize) 1 << precision))
+		return (puint64) bucket;
+
+	half   = (psize) 1 << (precision - 1);
+	bucket = bucket - ((psize) 1 << precision);
+	shift  = (pint) (bucket / half) + 1;
+
+	return ((puint64) (bucket % half + half)) << shift;
+}
+
+static puint64
+pp_latency_histogram_bucket_high (pint precision, psize bucket)
+{
+	pint shift;
+
+	if (bucket < ((psize) 1 << precision))
+		return (puint64) bucket;
+
+	shift = (pint) ((bucket - ((psize) 1 << precision)) >> (precision - 1)) + 1;
+
+	return pp_latency_histogram_bucket_low (precision, bucket) + (((puint64) 1 << shift) - 1);
+}
+
+static psize
+pp_latency_histogram_get_bucket_count (const PLatencyHistogram *hist, psize bucket)
+{
+	psize	ret = 0;
+	puint	i;
+
+	for (i = 0; i <= hist->shards_mask; ++i)
+		ret += (psize) p_atomic_pointer_get (&hist->counts[i * hist->stride + bucket]);
+
+	return ret;
+}
+
+static psize *
+pp_latency_histogram_current_shard (const PLatencyHistogram *hist)
+{
+	if (hist->shards_mask == 0)
+		return hist->counts;
+
+	return hist->counts + (psize) (p_shard_get_thread_index () & hist->shards_mask) * hist->stride;
+}
+
+P_LIB_API PLatencyHistogram *
+p_latency_histogram_new (pint precision)
+{
+	if (P_UNLIKELY (precision < P_LATENCY_HISTOGRAM_MIN_PRECISION ||
+			precision > P_LATENCY_HISTOGRAM_MAX_PRECISION))
+		return NULL;
+
+	return pp_latency_histogram_new_with_shards (precision, p_shard_get_count ());
+}
+
+P_LIB_API void
+p_latency_histogram_record (PLatencyHistogram	*hist,
+			    puint64		value)
+{
+	if (P_UNLIKELY (hist == NULL))
+		return;
+
+	p_atomic_pointer_add (pp_latency_histogram_current_shard (hist) +
+			      pp_latency_histogram_value_to_bucket (hist->precision, value),
+			      1);
+}
+
+P_LIB_API void
+p_latency_histogram_record_ticks (PLatencyHistogram	*hist,
+				  puint64		ticks)
+{
+	p_latency_histogram_record (hist, p_time_profiler_ticks_to_nsecs (ticks));
+}
+
+P_LIB_API void
+p_latency_histogram_record_profiler (PLatencyHistogram		*hist,
+				     const PTimeProfiler	*profiler)
+{
+	if (P_UNLIKELY (hist == NULL || profiler == NULL))
+		return;
+
+	p_latency_histogram_record (hist, p_time_profiler_elapsed_nsecs (profiler));
+}
+
+P_LIB_API PLatencyHistogram *
+p_latency_histogram_snapshot (const PLatencyHistogram *hist)
+{
+	PLatencyHistogram	*ret;
+	psize			i;
+
+	if (P_UNLIKELY (hist == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = pp_latency_histogram_new_with_shards (hist->precision, 1)) == NULL))
+		return NULL;
+
+	for (i = 0; i < hist->buckets; ++i)
+		ret->counts[i] = pp_latency_histogram_get_bucket_count (hist, i);
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_latency_histogram_merge (PLatencyHistogram		*dst,
+			   const PLatencyHistogram	*src)
+{
+	psize	*shard;
+	psize	count;
+	psize	i;
+
+	if (P_UNLIKELY (dst == NULL || src == NULL))
+		return FALSE;
+
+	if (P_UNLIKELY (dst->precision != src->precision))
+		return FALSE;
+
+	shard = pp_latency_histogram_current_shard (dst);
+
+	for (i = 0; i < src->buckets; ++i) {
+		if ((count = pp_latency_histogram_get_bucket_count (src, i)) != 0)
+			p_atomic_pointer_add (&shard[i], (pssize) count);
+	}
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_latency_histogram_reset (PLatencyHistogram *hist)
+{
+	psize i;
+
+	if (P_UNLIKELY (hist == NULL))
+		return;
+
+	for (i = 0; i < hist->stride * (hist->shards_mask + 1); ++i)
+		p_atomic_pointer_set (&hist->counts[i], NULL);
+}
+
+P_LIB_API pint
+p_latency_histogram_get_precision (const PLatencyHistogram *hist)
+{
+	if (P_UNLIKELY (hist == NULL))
+		return 0;
+
+	return hist->precision;
+}
+
+P_LIB_API puint64
+p_latency_histogram_get_count (const PLatencyHistogram *hist)
+{
+	puint64	ret = 0;
+	psize	i;
+
+	if (P_UNLIKELY (hist == NULL))
+		return 0;
+
+	for (i = 0; i < hist->buckets; ++i)
+		ret += (puint64) pp_latency_histogram_get_bucket_count (hist, i);
+
+	return ret;
+}
+
+P_LIB_API puint64
+p_latency_histogram_get_min (const PLatencyHistogram *hist)
+{
+	psize i;
+
+	if (P_UNLIKELY (hist == NULL))
+		return 0;
+
+	for (i = 0; i < hist->buckets; ++i) {
+		if (pp_latency_histogram_get_bucket_count (hist, i) != 0)
+			return pp_latency_histogram_bucket_low (hist->precision, i);
+	}
+
+	return 0;
+}
+
+P_LIB_API puint64
+p_latency_histogram_get_max (const PLatencyHistogram *hist)
+{
+	psize i;
+
+	if (P_UNLIKELY (hist == NULL))
+		return 0;
+
+	for (i = hist->buckets; i > 0; --i) {
+		if (pp_latency_histogram_get_bucket_count (hist, i - 1) != 0)
+			return pp_latency_histogram_bucket_high (hist->precision, i - 1);
+	}
+
+	return 0;
+}
+
+P_LIB_API puint64
+p_latency_histogram_get_mean (const PLatencyHistogram *hist)
+{
+	pdouble	total = 0.0;
+	pdouble	sum   = 0.0;
+	puint64	low;
+	psize	count;
+	psize	i;
+
+	if (P_UNLIKELY (hist == NULL))
+		return 0;
+
+	for (i = 0; i < hist->buckets; ++i) {
+		if ((count = pp_latency_histogram_get_bucket_count (hist, i)) == 0)
+			continue;
+
+		/* Use a middle of the bucket range as the value */
+		low = pp_latency_histogram_bucket_low (hist->precision, i);
+
+		sum   += (pdouble) count * ((pdouble) low +
+					    (pdouble) (pp_latency_histogram_bucket_high (hist->precision, i) - low) / 2.0);
+		total += (pdouble) count;
+	}
+
+	if (total == 0.0)
+		return 0;
+
+	return (puint64) (sum / total + 0.5);
+}
+
+P_LIB_API puint64
+p_latency_histogram_get_percentile (const PLatencyHistogram	*hist,
+				    pdouble			percentile)
+{
+	puint64	total;
+	puint64	target;
+	puint64	passed = 0;
+	psize	i;
+
+	if (P_UNLIKELY (hist == NULL))
+		return 0;
+
+	if (percentile < 0.0)
+		percentile = 0.0;
+	else if (percentile > 100.0)
+		percentile = 100.0;
+
+	if ((total = p_latency_histogram_get_count (hist)) == 0)
+		return 0;
+
+	target = (puint64) ((pdouble) total * percentile / 100.0 + 0.5);
+
+	if (target == 0)
+		target = 1;
+
+	for (i = 0; i < hist->buckets; ++i) {
+		passed += (puint64) pp_latency_histogram_get_bucket_count (hist, i);
+
+		if (passed >= target)
+			return pp_latency_histogram_bucket_high (hist->precision, i);
+	}
+
+	return p_latency_histogram_get_max (hist);
+}
+
+P_LIB_API void
+p_latency_histogram_free (PLatencyHistogram *hist)
+{
+	if (P_UNLIKELY (hist == NULL))
+		return;
+
+	p_free (hist->counts);
+	p_free (hist);
+}
@@ -0,0 +1,236 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file platencyhistogram.h
+ * @brief Latency histogram
+ * @author Alexander Saprykin
+ *
+ * A latency histogram collects a distribution of time intervals (latencies)
+ * and answers statistical queries about it: total number of samples, minimal,
+ * maximal and mean values, and percentiles (i.e. p50, p99 or p99.9).
+ *
+ * The histogram uses log-linear buckets: values below 2^precision are counted
+ * exactly, and every next power of two range is split into 2^(precision-1)
+ * linear sub-buckets. Thus the relative error of any reported value doesn't
+ * exceed 1/2^(precision-1) regardless of the value magnitude, while memory
+ * consumption remains fixed and small. Precision of 7 bits gives an error
+ * below 1.6% and is a good default for most cases.
+ *
+ * Values are usually measured in nanoseconds, though the histogram doesn't
+ * depend on particular units. Use p_latency_histogram_record() to record a
+ * raw value, p_latency_histogram_record_ticks() to record a difference
+ * between two p_time_profiler_ticks() values, or
+ * p_latency_histogram_record_profiler() to record time elapsed on a
+ * #PTimeProfiler.
+ *
+ * Recording is thread-safe and doesn't involve any locks: the histogram keeps
+ * several shards of counters, and every thread updates its own shard using
+ * atomic operations, so concurrent threads rarely touch the same cache lines.
+ * Note that if the platform doesn't support lock-free atomic operations (see
+ * p_atomic_is_lock_free()) they are simulated using a global mutex.
+ *
+ * All the queries aggregate the shards on every call, so to query several
+ * statistics at once take a consistent snapshot with
+ * p_latency_histogram_snapshot() first. Snapshots from different histograms
+ * (for example, one per worker thread or per process) can be combined with
+ * p_latency_histogram_merge() if they have the same precision.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PLATENCYHISTOGRAM_H
+#define PLIBSYS_HEADER_PLATENCYHISTOGRAM_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+#include <ptimeprofiler.h>
+
+P_BEGIN_DECLS
+
+/** Minimal supported histogram precision, in bits. */
+#define P_LATENCY_HISTOGRAM_MIN_PRECISION	1
+/** Maximal supported histogram precision, in bits. */
+#define P_LATENCY_HISTOGRAM_MAX_PRECISION	12
+
+/** Latency histogram opaque data structure. */
+typedef struct PLatencyHistogram_ PLatencyHistogram;
+
+/**
+ * @brief Creates a new #PLatencyHistogram object.
+ * @param precision Number of significant bits to keep for every value, must
+ * be in the range of #P_LATENCY_HISTOGRAM_MIN_PRECISION and
+ * #P_LATENCY_HISTOGRAM_MAX_PRECISION.
+ * @return Pointer to a newly created #PLatencyHistogram object in case of
+ * success, NULL otherwise.
+ * @since 0.0.6
+ *
+ * The number of internal shards depends on the number of CPUs available in
+ * the system, see p_uthread_ideal_count().
+ */
+P_LIB_API PLatencyHistogram *	p_latency_histogram_new			(pint				precision);
+
+/**
+ * @brief Records a value into a histogram.
+ * @param hist #PLatencyHistogram to record the value into.
+ * @param value Value to record, usually in nanoseconds.
+ * @since 0.0.6
+ *
+ * This call is thread-safe and lock-free.
+ */
+P_LIB_API void			p_latency_histogram_record		(PLatencyHistogram		*hist,
+									 puint64			value);
+
+/**
+ * @brief Records a number of profiler ticks into a histogram.
+ * @param hist #PLatencyHistogram to record the value into.
+ * @param ticks Difference between two p_time_profiler_ticks() values.
+ * @since 0.0.6
+ *
+ * The @a ticks are converted into nanoseconds with
+ * p_time_profiler_ticks_to_nsecs() before recording.
+ *
+ * This call is thread-safe and lock-free.
+ */
+P_LIB_API void			p_latency_histogram_record_ticks	(PLatencyHistogram		*hist,
+									 puint64			ticks);
+
+/**
+ * @brief Records time elapsed on a profiler into a histogram.
+ * @param hist #PLatencyHistogram to record the value into.
+ * @param profiler Time profiler to take elapsed time from.
+ * @since 0.0.6
+ *
+ * Records the value of p_time_profiler_elapsed_nsecs(). The @a profiler is not
+ * reset, use p_time_profiler_reset() to start measuring the next interval.
+ *
+ * This call is thread-safe and lock-free.
+ */
+P_LIB_API void			p_latency_histogram_record_profiler	(PLatencyHistogram		*hist,
+									 const PTimeProfiler		*profiler);
+
+/**
+ * @brief Takes a snapshot of a histogram.
+ * @param hist #PLatencyHistogram to take the snapshot of.
+ * @return Pointer to a newly created #PLatencyHistogram object with a copy of
+ * the recorded values in case of success, NULL otherwise.
+ * @since 0.0.6
+ *
+ * The snapshot is a regular histogram, it can be queried, merged with other
+ * histograms and even used for recording. Free it with
+ * p_latency_histogram_free() after usage.
+ *
+ * Values recorded concurrently with taking the snapshot may or may not be
+ * included into it.
+ */
+P_LIB_API PLatencyHistogram *	p_latency_histogram_snapshot		(const PLatencyHistogram	*hist);
+
+/**
+ * @brief Adds all the values recorded in one histogram to another one.
+ * @param dst #PLatencyHistogram to add values to.
+ * @param src #PLatencyHistogram to take values from.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * Both histograms must have the same precision.
+ */
+P_LIB_API pboolean		p_latency_histogram_merge		(PLatencyHistogram		*dst,
+									 const PLatencyHistogram	*src);
+
+/**
+ * @brief Removes all the recorded values from a histogram.
+ * @param hist #PLatencyHistogram to reset.
+ * @since 0.0.6
+ */
+P_LIB_API void			p_latency_histogram_reset		(PLatencyHistogram		*hist);
+
+/**
+ * @brief Gets a precision of a histogram.
+ * @param hist #PLatencyHistogram to get the precision for.
+ * @return Number of significant bits kept for every value.
+ * @since 0.0.6
+ */
+P_LIB_API pint			p_latency_histogram_get_precision	(const PLatencyHistogram	*hist);
+
+/**
+ * @brief Gets a total number of values recorded in a histogram.
+ * @param hist #PLatencyHistogram to get the number of values for.
+ * @return Total number of recorded values.
+ * @since 0.0.6
+ */
+P_LIB_API puint64		p_latency_histogram_get_count		(const PLatencyHistogram	*hist);
+
+/**
+ * @brief Gets a minimal value recorded in a histogram.
+ * @param hist #PLatencyHistogram to get the minimal value for.
+ * @return Minimal recorded value (within the histogram precision), 0 if the
+ * histogram is empty.
+ * @since 0.0.6
+ */
+P_LIB_API puint64		p_latency_histogram_get_min		(const PLatencyHistogram	*hist);
+
+/**
+ * @brief Gets a maximal value recorded in a histogram.
+ * @param hist #PLatencyHistogram to get the maximal value for.
+ * @return Maximal recorded value (within the histogram precision), 0 if the
+ * histogram is empty.
+ * @since 0.0.6
+ */
+P_LIB_API puint64		p_latency_histogram_get_max		(const PLatencyHistogram	*hist);
+
+/**
+ * @brief Gets a mean of the values recorded in a histogram.
+ * @param hist #PLatencyHistogram to get the mean value for.
+ * @return Mean of the recorded values (within the histogram precision), 0 if
+ * the histogram is empty.
+ * @since 0.0.6
+ */
+P_LIB_API puint64		p_latency_histogram_get_mean		(const PLatencyHistogram	*hist);
+
+/**
+ * @brief Gets a value at a given percentile.
+ * @param hist #PLatencyHistogram to get the value for.
+ * @param percentile Percentile to get the value at, in the range [0, 100],
+ * i.e. 50.0 for median, 99.9 for p999.
+ * @return Value (within the histogram precision) that is greater than or equal
+ * to the given @a percentile of all the recorded values, 0 if the histogram is
+ * empty.
+ * @since 0.0.6
+ */
+P_LIB_API puint64		p_latency_histogram_get_percentile	(const PLatencyHistogram	*hist,
+									 pdouble			percentile);
+
+/**
+ * @brief Frees #PLatencyHistogram object.
+ * @param hist #PLatencyHistogram to free.
+ * @since 0.0.6
+ */
+P_LIB_API void			p_latency_histogram_free		(PLatencyHistogram		*hist);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PLATENCYHISTOGRAM_H */
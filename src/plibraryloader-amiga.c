@@ -55,6 +55,7 @@
 #include "perror.h"
 #include "pfile.h"
 #include "plibraryloader.h"
+#include "plibraryloader-private.h"
 #include "pmem.h"
 #include "pstring.h"
 
@@ -73,8 +74,9 @@
 typedef APTR plibrary_handle;
 
 struct PLibraryLoader_ {
-	plibrary_handle	handle;
-	Elf32_Error	last_error;
+	plibrary_handle		handle;
+	Elf32_Error		last_error;
+	PLibrarySymbolCache	*cache;
 };
 
 static struct Library   *pp_lib                    = NULL;
@@ -466,6 +468,13 @@ p_library_loader_new (const pchar *path)
 		return NULL;
 	}
 
+	if (P_UNLIKELY ((loader->cache = p_library_symbol_cache_new ()) == NULL)) {
+		P_ERROR ("PLibraryLoader::p_library_loader_new: failed to allocate memory");
+		pp_library_loader_clean_handle (handle);
+		p_free (loader);
+		return NULL;
+	}
+
 	loader->handle     = handle;
 	loader->last_error = ELF32_NO_ERROR;
 
@@ -476,11 +485,17 @@ P_LIB_API PFuncAddr
 p_library_loader_get_symbol (PLibraryLoader	*loader,
 			     const pchar	*sym)
 {
-	APTR func_addr = NULL;
+	APTR		func_addr = NULL;
+	PFuncAddr	ret_sym;
 
 	if (P_UNLIKELY (loader == NULL || sym == NULL || loader->handle == NULL))
 		return NULL;
 
+	if (p_library_symbol_cache_lookup (loader->cache, sym, &ret_sym) == TRUE) {
+		loader->last_error = ELF32_NO_ERROR;
+		return ret_sym;
+	}
+
 	if (pp_library_loader_elf_root == NULL || pp_IElf == NULL) {
 		P_ERROR ("PLibraryLoader::p_library_loader_new: shared library subsystem is not initialized");
 		return NULL;
@@ -491,6 +506,9 @@ p_library_loader_get_symbol (PLibraryLoader	*loader,
 					     (CONST_STRPTR) sym,
 					     &func_addr);
 
+	if (loader->last_error == ELF32_NO_ERROR && (ret_sym = (PFuncAddr) func_addr) != NULL)
+		p_library_symbol_cache_insert (loader->cache, sym, ret_sym);
+
 	return (PFuncAddr) func_addr;
 }
 
@@ -501,6 +519,7 @@ p_library_loader_free (PLibraryLoader *loader)
 		return;
 
 	pp_library_loader_clean_handle (loader->handle);
+	p_library_symbol_cache_free (loader->cache);
 
 	p_free (loader);
 }
@@ -26,6 +26,7 @@
 #include "perror.h"
 #include "pfile.h"
 #include "plibraryloader.h"
+#include "plibraryloader-private.h"
 #include "pmem.h"
 #include "pstring.h"
 
@@ -34,8 +35,9 @@
 typedef image_id plibrary_handle;
 
 struct PLibraryLoader_ {
-	plibrary_handle	handle;
-	status_t	last_status;
+	plibrary_handle		handle;
+	status_t		last_status;
+	PLibrarySymbolCache	*cache;
 };
 
 static void pp_library_loader_clean_handle (plibrary_handle handle);
@@ -67,6 +69,13 @@ p_library_loader_new (const pchar *path)
 		return NULL;
 	}
 
+	if (P_UNLIKELY ((loader->cache = p_library_symbol_cache_new ()) == NULL)) {
+		P_ERROR ("PLibraryLoader::p_library_loader_new: failed to allocate memory");
+		pp_library_loader_clean_handle (handle);
+		p_free (loader);
+		return NULL;
+	}
+
 	loader->handle      = handle;
 	loader->last_status = B_OK;
 
@@ -77,11 +86,17 @@ P_LIB_API PFuncAddr
 p_library_loader_get_symbol (PLibraryLoader *loader, const pchar *sym)
 {
 	ppointer	location = NULL;
+	PFuncAddr	func_addr;
 	status_t	status;
 
 	if (P_UNLIKELY (loader == NULL || sym == NULL))
 		return NULL;
 
+	if (p_library_symbol_cache_lookup (loader->cache, sym, &func_addr) == TRUE) {
+		loader->last_status = B_OK;
+		return func_addr;
+	}
+
 	if (P_UNLIKELY ((status = get_image_symbol (loader->handle,
 						    (pchar *) sym,
 						    B_SYMBOL_TYPE_ANY,
@@ -93,7 +108,10 @@ p_library_loader_get_symbol (PLibraryLoader *loader, const pchar *sym)
 
 	loader->last_status = B_OK;
 
-	return (PFuncAddr) location;
+	if ((func_addr = (PFuncAddr) location) != NULL)
+		p_library_symbol_cache_insert (loader->cache, sym, func_addr);
+
+	return func_addr;
 }
 
 P_LIB_API void
@@ -103,6 +121,7 @@ p_library_loader_free (PLibraryLoader *loader)
 		return;
 
 	pp_library_loader_clean_handle (loader->handle);
+	p_library_symbol_cache_free (loader->cache);
 
 	p_free (loader);
 }
@@ -26,6 +26,7 @@
 #include "perror.h"
 #include "pfile.h"
 #include "plibraryloader.h"
+#include "plibraryloader-private.h"
 #include "pmem.h"
 #include "pstring.h"
 
@@ -36,8 +37,9 @@
 typedef HMODULE plibrary_handle;
 
 struct PLibraryLoader_ {
-	plibrary_handle	handle;
-	APIRET		last_error;
+	plibrary_handle		handle;
+	APIRET			last_error;
+	PLibrarySymbolCache	*cache;
 };
 
 static void pp_library_loader_clean_handle (plibrary_handle handle);
@@ -83,6 +85,13 @@ p_library_loader_new (const pchar *path)
 		return NULL;
 	}
 
+	if (P_UNLIKELY ((loader->cache = p_library_symbol_cache_new ()) == NULL)) {
+		P_ERROR ("PLibraryLoader::p_library_loader_new: failed to allocate memory");
+		pp_library_loader_clean_handle (handle);
+		p_free (loader);
+		return NULL;
+	}
+
 	loader->handle     = handle;
 	loader->last_error = NO_ERROR;
 
@@ -92,12 +101,18 @@ p_library_loader_new (const pchar *path)
 P_LIB_API PFuncAddr
 p_library_loader_get_symbol (PLibraryLoader *loader, const pchar *sym)
 {
-	PFN	func_addr = NULL;
-	APIRET	ulrc;
+	PFN		func_addr = NULL;
+	PFuncAddr	ret_sym;
+	APIRET		ulrc;
 
 	if (P_UNLIKELY (loader == NULL || sym == NULL || loader->handle == NULL))
 		return NULL;
 
+	if (p_library_symbol_cache_lookup (loader->cache, sym, &ret_sym) == TRUE) {
+		loader->last_error = NO_ERROR;
+		return ret_sym;
+	}
+
 	if (P_UNLIKELY ((ulrc = DosQueryProcAddr (loader->handle, 0, (PSZ) sym, &func_addr)) != NO_ERROR)) {
 		P_ERROR ("PLibraryLoader::p_library_loader_get_symbol: DosQueryProcAddr() failed");
 		loader->last_error = ulrc;
@@ -106,7 +121,10 @@ p_library_loader_get_symbol (PLibraryLoader *loader, const pchar *sym)
 
 	loader->last_error = NO_ERROR;
 
-	return (PFuncAddr) func_addr;
+	if ((ret_sym = (PFuncAddr) func_addr) != NULL)
+		p_library_symbol_cache_insert (loader->cache, sym, ret_sym);
+
+	return ret_sym;
 }
 
 P_LIB_API void
@@ -116,6 +134,7 @@ p_library_loader_free (PLibraryLoader *loader)
 		return;
 
 	pp_library_loader_clean_handle (loader->handle);
+	p_library_symbol_cache_free (loader->cache);
 
 	p_free (loader);
 }
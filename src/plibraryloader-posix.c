@@ -26,6 +26,7 @@
 #include "perror.h"
 #include "pfile.h"
 #include "plibraryloader.h"
+#include "plibraryloader-private.h"
 #include "pmem.h"
 #include "pstring.h"
 
@@ -43,7 +44,8 @@
 typedef ppointer plibrary_handle;
 
 struct PLibraryLoader_ {
-	plibrary_handle	handle;
+	plibrary_handle		handle;
+	PLibrarySymbolCache	*cache;
 };
 
 static void pp_library_loader_clean_handle (plibrary_handle handle);
@@ -106,6 +108,13 @@ p_library_loader_new (const pchar *path)
 		return NULL;
 	}
 
+	if (P_UNLIKELY ((loader->cache = p_library_symbol_cache_new ()) == NULL)) {
+		P_ERROR ("PLibraryLoader::p_library_loader_new: failed to allocate memory");
+		pp_library_loader_clean_handle (handle);
+		p_free (loader);
+		return NULL;
+	}
+
 	loader->handle = handle;
 
 	return loader;
@@ -114,10 +123,21 @@ p_library_loader_new (const pchar *path)
 P_LIB_API PFuncAddr
 p_library_loader_get_symbol (PLibraryLoader *loader, const pchar *sym)
 {
+	PFuncAddr func_addr;
+
 	if (P_UNLIKELY (loader == NULL || sym == NULL || loader->handle == NULL))
 		return NULL;
 
-	return (PFuncAddr) dlsym (loader->handle, sym);
+	/* Drop a pending error, as a successful resolving would not report it */
+	if (p_library_symbol_cache_lookup (loader->cache, sym, &func_addr) == TRUE) {
+		(void) dlerror ();
+		return func_addr;
+	}
+
+	if ((func_addr = (PFuncAddr) dlsym (loader->handle, sym)) != NULL)
+		p_library_symbol_cache_insert (loader->cache, sym, func_addr);
+
+	return func_addr;
 }
 
 P_LIB_API void
@@ -127,6 +147,7 @@ p_library_loader_free (PLibraryLoader *loader)
 		return;
 
 	pp_library_loader_clean_handle (loader->handle);
+	p_library_symbol_cache_free (loader->cache);
 
 	p_free (loader);
 }
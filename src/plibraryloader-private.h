@@ -0,0 +1,81 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PLIBRARYLOADER_PRIVATE_H
+#define PLIBSYS_HEADER_PLIBRARYLOADER_PRIVATE_H
+
+#include "plibraryloader.h"
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Per-loader cache of the resolved symbols. */
+typedef struct PLibrarySymbolCache_ PLibrarySymbolCache;
+
+/**
+ * @brief Creates a new empty symbol cache.
+ * @return Pointer to the cache in case of success, NULL otherwise.
+ */
+PLibrarySymbolCache *	p_library_symbol_cache_new	(void);
+
+/**
+ * @brief Looks up a previously resolved symbol.
+ * @param cache Symbol cache.
+ * @param sym Name of the symbol.
+ * @param[out] addr Resolved address of the symbol.
+ * @return TRUE if the symbol was found in the cache, FALSE otherwise.
+ *
+ * Lookups never lock and may run concurrently with the insertions.
+ */
+pboolean		p_library_symbol_cache_lookup	(PLibrarySymbolCache	*cache,
+							 const pchar		*sym,
+							 PFuncAddr		*addr);
+
+/**
+ * @brief Puts a resolved symbol into the cache.
+ * @param cache Symbol cache.
+ * @param sym Name of the symbol.
+ * @param addr Resolved address of the symbol.
+ *
+ * Failing to allocate an entry is not an error, the symbol is just not cached.
+ */
+void			p_library_symbol_cache_insert	(PLibrarySymbolCache	*cache,
+							 const pchar		*sym,
+							 PFuncAddr		addr);
+
+/**
+ * @brief Frees the cache with all of its entries.
+ * @param cache Symbol cache to free.
+ */
+void			p_library_symbol_cache_free	(PLibrarySymbolCache	*cache);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PLIBRARYLOADER_PRIVATE_H */
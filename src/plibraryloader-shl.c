@@ -26,6 +26,7 @@
 #include "perror.h"
 #include "pfile.h"
 #include "plibraryloader.h"
+#include "plibraryloader-private.h"
 #include "pmem.h"
 #include "pstring.h"
 
@@ -36,8 +37,9 @@
 typedef shl_t plibrary_handle;
 
 struct PLibraryLoader_ {
-	plibrary_handle	handle;
-	int		last_error;
+	plibrary_handle		handle;
+	int			last_error;
+	PLibrarySymbolCache	*cache;
 };
 
 static void pp_library_loader_clean_handle (plibrary_handle handle);
@@ -69,6 +71,13 @@ p_library_loader_new (const pchar *path)
 		return NULL;
 	}
 
+	if (P_UNLIKELY ((loader->cache = p_library_symbol_cache_new ()) == NULL)) {
+		P_ERROR ("PLibraryLoader::p_library_loader_new: failed to allocate memory");
+		pp_library_loader_clean_handle (handle);
+		p_free (loader);
+		return NULL;
+	}
+
 	loader->handle     = handle;
 	loader->last_error = 0;
 
@@ -83,6 +92,11 @@ p_library_loader_get_symbol (PLibraryLoader *loader, const pchar *sym)
 	if (P_UNLIKELY (loader == NULL || sym == NULL || loader->handle == NULL))
 		return NULL;
 
+	if (p_library_symbol_cache_lookup (loader->cache, sym, &func_addr) == TRUE) {
+		loader->last_error = 0;
+		return func_addr;
+	}
+
 	if (P_UNLIKELY (shl_findsym (&loader->handle, sym, TYPE_UNDEFINED, (ppointer) &func_addr) != 0)) {
 		P_ERROR ("PLibraryLoader::p_library_loader_get_symbol: shl_findsym() failed");
 		loader->last_error = (errno == 0 ? -1 : errno);
@@ -91,6 +105,9 @@ p_library_loader_get_symbol (PLibraryLoader *loader, const pchar *sym)
 
 	loader->last_error = 0;
 
+	if (func_addr != NULL)
+		p_library_symbol_cache_insert (loader->cache, sym, func_addr);
+
 	return func_addr;
 }
 
@@ -101,6 +118,7 @@ p_library_loader_free (PLibraryLoader *loader)
 		return;
 
 	pp_library_loader_clean_handle (loader->handle);
+	p_library_symbol_cache_free (loader->cache);
 
 	p_free (loader);
 }
@@ -26,13 +26,15 @@
 #include "perror.h"
 #include "pfile.h"
 #include "plibraryloader.h"
+#include "plibraryloader-private.h"
 #include "pmem.h"
 #include "pstring.h"
 
 typedef HINSTANCE	plibrary_handle;
 
 struct PLibraryLoader_ {
-	plibrary_handle	handle;
+	plibrary_handle		handle;
+	PLibrarySymbolCache	*cache;
 };
 
 static void pp_library_loader_clean_handle (plibrary_handle handle);
@@ -64,6 +66,13 @@ p_library_loader_new (const pchar *path)
 		return NULL;
 	}
 
+	if (P_UNLIKELY ((loader->cache = p_library_symbol_cache_new ()) == NULL)) {
+		P_ERROR ("PLibraryLoader::p_library_loader_new: failed to allocate memory");
+		pp_library_loader_clean_handle (handle);
+		p_free (loader);
+		return NULL;
+	}
+
 	loader->handle = handle;
 
 	return loader;
@@ -77,7 +86,14 @@ p_library_loader_get_symbol (PLibraryLoader *loader, const pchar *sym)
 	if (P_UNLIKELY (loader == NULL || sym == NULL || loader->handle == NULL))
 		return NULL;
 
-	ret_sym = (PFuncAddr) GetProcAddress (loader->handle, sym);
+	/* Drop a pending error, as a successful resolving would not report it */
+	if (p_library_symbol_cache_lookup (loader->cache, sym, &ret_sym) == TRUE) {
+		p_error_set_last_system (0);
+		return ret_sym;
+	}
+
+	if ((ret_sym = (PFuncAddr) GetProcAddress (loader->handle, sym)) != NULL)
+		p_library_symbol_cache_insert (loader->cache, sym, ret_sym);
 
 	return ret_sym;
 }
@@ -89,6 +105,7 @@ p_library_loader_free (PLibraryLoader *loader)
 		return;
 
 	pp_library_loader_clean_handle (loader->handle);
+	p_library_symbol_cache_free (loader->cache);
 
 	p_free (loader);
 }
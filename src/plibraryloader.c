@@ -0,0 +1,152 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "patomic.h"
+#include "plibraryloader.h"
+#include "plibraryloader-private.h"
+#include "pmem.h"
+#include "pstring-private.h"
+
+#include <string.h>
+
+/* Fixed number of buckets: a plugin exports a few hundreds of symbols at
+ * most, so the chains stay short and we never need to rehash, which keeps
+ * the lookups lock-free */
+#define P_LIBRARY_SYMBOL_CACHE_BUCKETS	128
+
+typedef struct PLibrarySymbolEntry_ {
+	struct PLibrarySymbolEntry_	*next;
+	PFuncAddr			addr;
+	puint32				hash;
+} PLibrarySymbolEntry;
+
+struct PLibrarySymbolCache_ {
+	PLibrarySymbolEntry	*buckets[P_LIBRARY_SYMBOL_CACHE_BUCKETS];
+};
+
+PLibrarySymbolCache *
+p_library_symbol_cache_new (void)
+{
+	return p_malloc0 (sizeof (PLibrarySymbolCache));
+}
+
+pboolean
+p_library_symbol_cache_lookup (PLibrarySymbolCache	*cache,
+			       const pchar		*sym,
+			       PFuncAddr		*addr)
+{
+	PLibrarySymbolEntry	*entry;
+	puint32			hash;
+
+	if (P_UNLIKELY (cache == NULL || sym == NULL))
+		return FALSE;
+
+	hash  = p_string_hash (sym, strlen (sym));
+	entry = p_atomic_pointer_get (&cache->buckets[hash % P_LIBRARY_SYMBOL_CACHE_BUCKETS]);
+
+	for (; entry != NULL; entry = entry->next) {
+		if (entry->hash == hash && strcmp (P_STRING_ENTRY_DATA (entry), sym) == 0) {
+			*addr = entry->addr;
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+void
+p_library_symbol_cache_insert (PLibrarySymbolCache	*cache,
+			       const pchar		*sym,
+			       PFuncAddr		addr)
+{
+	PLibrarySymbolEntry	*entry;
+	PLibrarySymbolEntry	*head;
+	volatile void		*bucket;
+	psize			len;
+
+	if (P_UNLIKELY (cache == NULL || sym == NULL))
+		return;
+
+	len = strlen (sym);
+
+	if (P_UNLIKELY ((entry = p_string_entry_new (sizeof (PLibrarySymbolEntry), sym, len)) == NULL))
+		return;
+
+	entry->addr = addr;
+	entry->hash = p_string_hash (sym, len);
+	bucket      = &cache->buckets[entry->hash % P_LIBRARY_SYMBOL_CACHE_BUCKETS];
+
+	/* Entries are only prepended and never removed until the cache is freed,
+	 * so the readers always see a consistent chain. Two threads resolving
+	 * the same symbol may both insert it, which is harmless. */
+	do {
+		head        = p_atomic_pointer_get (bucket);
+		entry->next = head;
+	} while (p_atomic_pointer_compare_and_exchange (bucket, head, entry) == FALSE);
+}
+
+void
+p_library_symbol_cache_free (PLibrarySymbolCache *cache)
+{
+	PLibrarySymbolEntry	*entry;
+	PLibrarySymbolEntry	*next;
+	pint			i;
+
+	if (P_UNLIKELY (cache == NULL))
+		return;
+
+	for (i = 0; i < P_LIBRARY_SYMBOL_CACHE_BUCKETS; ++i) {
+		for (entry = cache->buckets[i]; entry != NULL; entry = next) {
+			next = entry->next;
+			p_free (entry);
+		}
+	}
+
+	p_free (cache);
+}
+
+P_LIB_API psize
+p_library_loader_bind_symbols (PLibraryLoader		*loader,
+			       const PLibrarySymbol	*symbols,
+			       psize			count)
+{
+	psize	bound = 0;
+	psize	i;
+
+	if (P_UNLIKELY (loader == NULL || (symbols == NULL && count > 0)))
+		return 0;
+
+	for (i = 0; i < count; ++i) {
+		if (P_UNLIKELY (symbols[i].addr == NULL))
+			continue;
+
+		*symbols[i].addr = p_library_loader_get_symbol (loader, symbols[i].name);
+
+		if (*symbols[i].addr != NULL)
+			++bound;
+	}
+
+	return bound;
+}
@@ -48,6 +48,13 @@
  * p_library_loader_get_symbol() to retrieve a pointer to a symbol within it.
  * Close the library after usage with p_library_loader_free().
  *
+ * Every successfully resolved symbol is remembered by the loader, so looking up
+ * the same name again doesn't go down to the operating system. Lookups in this
+ * cache don't take any locks and the loader can be shared between threads for
+ * symbol resolving. When you need a whole table of entry points (i.e. a plugin
+ * API), describe it with an array of #PLibrarySymbol and resolve it in one call
+ * with p_library_loader_bind_symbols().
+ *
  * Please note the following platform specific differences:
  *
  * - HP-UX doesn't support loading libraries containing TLS and built with
@@ -82,6 +89,12 @@ typedef struct PLibraryLoader_ PLibraryLoader;
 /** Pointer to a function address. */
 typedef void (*PFuncAddr) (void);
 
+/** Symbol binding entry for p_library_loader_bind_symbols(). */
+typedef struct PLibrarySymbol_ {
+	const pchar	*name;	/**< Name of the symbol.			*/
+	PFuncAddr	*addr;	/**< Location to store the symbol address.	*/
+} PLibrarySymbol;
+
 /**
  * @brief Loads a shared library.
  * @param path Path to the shared library file.
@@ -105,10 +118,35 @@ P_LIB_API PLibraryLoader *	p_library_loader_new		(const pchar	*path);
  * Since the symbol may have a NULL value, the returned NULL value from this
  * call actually doesn't mean the failed result. You can additionally check the
  * error result using p_library_loader_get_last_error().
+ *
+ * Since 0.0.6 the resolved symbols are cached within the loader, so repeated
+ * lookups of the same name are served without calling the operating system.
+ * Such a lookup succeeds as well, so the last error is cleared after it and
+ * p_library_loader_get_last_error() returns NULL.
  */
 P_LIB_API PFuncAddr		p_library_loader_get_symbol	(PLibraryLoader	*loader,
 								 const pchar	*sym);
 
+/**
+ * @brief Resolves a table of symbols in the loaded shared library.
+ * @param loader Pointer to the loaded shared library handle.
+ * @param symbols Array of the symbols to resolve.
+ * @param count Number of the elements in @a symbols.
+ * @return Number of the symbols resolved to a non-NULL address.
+ * @since 0.0.6
+ *
+ * The address of every symbol is written to the location pointed by its
+ * @a addr field, unresolved symbols get a NULL address. Entries with a NULL
+ * @a addr field are skipped. Compare the returned value with @a count to
+ * check that all the symbols were found.
+ *
+ * All the resolved symbols are put into the loader cache, so the following
+ * calls to p_library_loader_get_symbol() for the same names are cheap.
+ */
+P_LIB_API psize			p_library_loader_bind_symbols	(PLibraryLoader		*loader,
+								 const PLibrarySymbol	*symbols,
+								 psize			count);
+
 /**
  * @brief Frees memory and allocated resources of #PLibraryLoader.
  * @param loader #PLibraryLoader object to free.
@@ -29,14 +29,17 @@
 #define PLIBSYS_H_INSIDE
 
 #include "plibsysconfig.h"
+#include "pasyncio.h"
 #include "patomic.h"
 #include "pcondvariable.h"
+#include "pcounter.h"
 #include "pcryptohash.h"
 #include "pdir.h"
 #include "perror.h"
 #include "pfile.h"
 #include "phashtable.h"
 #include "pinifile.h"
+#include "platencyhistogram.h"
 #include "plibraryloader.h"
 #include "plist.h"
 #include "pmacros.h"
@@ -50,9 +53,16 @@
 #include "prwlock.h"
 #include "psemaphore.h"
 #include "pshm.h"
+#include "pshmallocator.h"
 #include "pshmbuffer.h"
+#include "pshmhashtable.h"
+#include "pshmqueue.h"
+#include "pshmsync.h"
 #include "psocket.h"
+#include "psocketacceptor.h"
 #include "psocketaddress.h"
+#include "psocketresolver.h"
+#include "psocketstream.h"
 #include "pspinlock.h"
 #include "pstdarg.h"
 #include "pstring.h"
@@ -44,6 +44,20 @@
 #    include <sys/mman.h>
 #    include <sys/stat.h>
 #    include <fcntl.h>
+#    if defined (PLIBSYS_MMAP_HAS_MAP_ANONYMOUS) || defined (PLIBSYS_MMAP_HAS_MAP_ANON)
+#      define P_MEM_MMAP_HAS_ANON
+#    endif
+#  endif
+#endif
+
+#ifdef P_OS_LINUX
+#  include <stdio.h>
+#  include <errno.h>
+#  include <sys/syscall.h>
+#  if defined (SYS_mbind) && defined (P_MEM_MMAP_HAS_ANON)
+#    define P_MEM_MMAP_HAS_MBIND
+#    define P_MEM_MMAP_MPOL_BIND	2
+#    define P_MEM_MMAP_MAX_NUMA_NODES	1024
 #  endif
 #endif
 
@@ -292,6 +306,317 @@ p_mem_mmap (psize	n_bytes,
 	return addr;
 }
 
+static psize pp_mem_get_page_size (void);
+static void pp_mem_touch_pages (ppointer mem, psize n_bytes);
+#ifdef P_MEM_MMAP_HAS_MBIND
+static pboolean pp_mem_bind_numa_node (ppointer mem, psize n_bytes, pint node);
+#endif
+
+static psize
+pp_mem_get_page_size (void)
+{
+#if defined (P_OS_WIN)
+	SYSTEM_INFO	sys_info;
+
+	GetSystemInfo (&sys_info);
+
+	return (psize) sys_info.dwPageSize;
+#elif defined (P_OS_BEOS)
+	return B_PAGE_SIZE;
+#elif defined (P_OS_OS2) || defined (P_OS_AMIGA)
+	return 4096;
+#else
+	plong		page_size;
+
+#  ifdef _SC_PAGESIZE
+	page_size = sysconf (_SC_PAGESIZE);
+#  else
+	page_size = (plong) getpagesize ();
+#  endif
+
+	return page_size > 0 ? (psize) page_size : 4096;
+#endif
+}
+
+static void
+pp_mem_touch_pages (ppointer	mem,
+		    psize	n_bytes)
+{
+	volatile puchar	*ptr = (volatile puchar *) mem;
+	psize		page_size;
+	psize		i;
+
+	/* Writing is required, reading may map a shared zero page */
+	page_size = pp_mem_get_page_size ();
+
+	for (i = 0; i < n_bytes; i += page_size)
+		ptr[i] = 0;
+}
+
+#ifdef P_MEM_MMAP_HAS_MBIND
+static pboolean
+pp_mem_bind_numa_node (ppointer	mem,
+		       psize	n_bytes,
+		       pint	node)
+{
+	pulong	mask[P_MEM_MMAP_MAX_NUMA_NODES / (sizeof (pulong) * 8)];
+	psize	bits = sizeof (pulong) * 8;
+
+	if (P_UNLIKELY (node >= P_MEM_MMAP_MAX_NUMA_NODES)) {
+		errno = EINVAL;
+		return FALSE;
+	}
+
+	memset (mask, 0, sizeof (mask));
+	mask[(psize) node / bits] |= 1UL << ((psize) node % bits);
+
+	/* No need for libnuma to make a single call */
+	return syscall (SYS_mbind,
+			mem,
+			(pulong) n_bytes,
+			P_MEM_MMAP_MPOL_BIND,
+			mask,
+			(pulong) (sizeof (mask) * 8 + 1),
+			0UL) == 0;
+}
+#endif
+
+P_LIB_API psize
+p_mem_get_huge_page_size (void)
+{
+#ifdef P_OS_LINUX
+	static volatile psize	huge_page_size = (psize) -1;
+	FILE			*file;
+	pchar			line[128];
+	pulong			size_kb;
+	psize			ret;
+
+	if (huge_page_size != (psize) -1)
+		return huge_page_size;
+
+	ret = 0;
+
+	if ((file = fopen ("/proc/meminfo", "r")) != NULL) {
+		while (fgets (line, sizeof (line), file) != NULL) {
+			if (sscanf (line, "Hugepagesize: %lu kB", &size_kb) == 1) {
+				ret = (psize) size_kb * 1024;
+				break;
+			}
+		}
+
+		fclose (file);
+	}
+
+	huge_page_size = ret;
+
+	return ret;
+#else
+	return 0;
+#endif
+}
+
+P_LIB_API ppointer
+p_mem_mmap_full (psize	n_bytes,
+		 puint	flags,
+		 PError	**error)
+{
+	ppointer	addr;
+	pboolean	strict;
+	pboolean	populated = FALSE;
+	pint		numa_node;
+#ifdef P_MEM_MMAP_HAS_ANON
+	pint		map_flags = MAP_PRIVATE;
+	pint		extra_flags;
+	psize		huge_size;
+	psize		map_size;
+	psize		map_len;
+	psize		page_size;
+	psize		head;
+	psize		tail;
+	pboolean	use_thp;
+#endif
+
+	if (P_UNLIKELY (n_bytes == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	strict    = (flags & P_MEM_MAP_FLAG_STRICT) != 0;
+	numa_node = (pint) ((flags >> 16) & 0xFFFF) - 1;
+
+#ifdef P_MEM_MMAP_HAS_ANON
+#  ifdef PLIBSYS_MMAP_HAS_MAP_ANONYMOUS
+	map_flags |= MAP_ANONYMOUS;
+#  else
+	map_flags |= MAP_ANON;
+#  endif
+
+	addr      = (void *) -1;
+	huge_size = p_mem_get_huge_page_size ();
+
+	/* Pages must not be faulted in before binding them to the NUMA node */
+	extra_flags = 0;
+#  ifdef MAP_POPULATE
+	if ((flags & P_MEM_MAP_FLAG_POPULATE) && numa_node < 0)
+		extra_flags |= MAP_POPULATE;
+#  endif
+
+	if (flags & P_MEM_MAP_FLAG_HUGE_PAGES) {
+#  ifdef MAP_HUGETLB
+		if (huge_size > 0 && n_bytes % huge_size == 0)
+			addr = mmap (NULL,
+				     n_bytes,
+				     PROT_READ | PROT_WRITE,
+				     map_flags | extra_flags | MAP_HUGETLB,
+				     -1,
+				     0);
+#  endif
+		if (addr == (void *) -1 && strict) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     p_error_get_last_system (),
+					     "Failed to map memory with explicit huge pages");
+			return NULL;
+		}
+
+		populated = addr != (void *) -1 && (extra_flags != 0);
+	}
+
+	if (addr == (void *) -1) {
+		use_thp  = (flags & (P_MEM_MAP_FLAG_HUGE_PAGES | P_MEM_MAP_FLAG_TRANSPARENT_HUGE_PAGES)) &&
+			   huge_size > 0 && n_bytes >= huge_size;
+
+		/* Unused parts can be unmapped only at the page boundaries */
+		page_size = pp_mem_get_page_size ();
+		map_len   = (n_bytes + page_size - 1) / page_size * page_size;
+		map_size  = use_thp ? map_len + huge_size : n_bytes;
+
+		/* Populating before madvise() would fault in regular pages */
+		if ((addr = mmap (NULL,
+				  map_size,
+				  PROT_READ | PROT_WRITE,
+				  map_flags | (use_thp ? 0 : extra_flags),
+				  -1,
+				  0)) == (void *) -1) {
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_io (),
+					     p_error_get_last_system (),
+					     "Failed to call mmap() to create file mapping");
+			return NULL;
+		}
+
+		populated = (use_thp == FALSE) && (extra_flags != 0);
+
+		if (use_thp) {
+			/* Huge pages can back only aligned regions, trim the rest */
+			head = (huge_size - (psize) ((pulong) addr % huge_size)) % huge_size;
+			tail = map_size - head - map_len;
+
+			if (head > 0 && P_UNLIKELY (munmap (addr, head) != 0))
+				P_WARNING ("PMem::p_mem_mmap_full: munmap() failed for unaligned head");
+
+			if (tail > 0 && P_UNLIKELY (munmap ((puchar *) addr + head + map_len, tail) != 0))
+				P_WARNING ("PMem::p_mem_mmap_full: munmap() failed for unaligned tail");
+
+			addr = (puchar *) addr + head;
+
+#  ifdef MADV_HUGEPAGE
+			if (madvise (addr, n_bytes, MADV_HUGEPAGE) != 0 && strict) {
+				p_error_set_error_p (error,
+						     (pint) p_error_get_last_io (),
+						     p_error_get_last_system (),
+						     "Failed to call madvise() to enable transparent huge pages");
+				munmap (addr, n_bytes);
+				return NULL;
+			}
+#  else
+			if (strict) {
+				p_error_set_error_p (error,
+						     (pint) P_ERROR_IO_NOT_SUPPORTED,
+						     0,
+						     "Transparent huge pages are not supported");
+				munmap (addr, n_bytes);
+				return NULL;
+			}
+#  endif
+		} else if ((flags & (P_MEM_MAP_FLAG_HUGE_PAGES | P_MEM_MAP_FLAG_TRANSPARENT_HUGE_PAGES)) && strict) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NOT_SUPPORTED,
+					     0,
+					     "Huge pages are not supported for this size");
+			munmap (addr, n_bytes);
+			return NULL;
+		}
+	}
+#else
+	if (P_UNLIKELY (strict && (flags & (P_MEM_MAP_FLAG_HUGE_PAGES | P_MEM_MAP_FLAG_TRANSPARENT_HUGE_PAGES)))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_SUPPORTED,
+				     0,
+				     "Huge pages are not supported on this platform");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((addr = p_mem_mmap (n_bytes, error)) == NULL))
+		return NULL;
+#endif
+
+	if (numa_node >= 0) {
+#ifdef P_MEM_MMAP_HAS_MBIND
+		if (pp_mem_bind_numa_node (addr, n_bytes, numa_node) == FALSE && strict) {
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_io (),
+					     p_error_get_last_system (),
+					     "Failed to call mbind() to bind memory to NUMA node");
+			p_mem_munmap (addr, n_bytes, NULL);
+			return NULL;
+		}
+#else
+		if (strict) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NOT_SUPPORTED,
+					     0,
+					     "NUMA binding is not supported on this platform");
+			p_mem_munmap (addr, n_bytes, NULL);
+			return NULL;
+		}
+#endif
+	}
+
+	if ((flags & P_MEM_MAP_FLAG_POPULATE) && populated == FALSE)
+		pp_mem_touch_pages (addr, n_bytes);
+
+	if (flags & P_MEM_MAP_FLAG_LOCK) {
+#if defined (P_OS_WIN)
+		if (VirtualLock (addr, n_bytes) == 0 && strict) {
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_io (),
+					     p_error_get_last_system (),
+					     "Failed to call VirtualLock() to lock memory");
+#elif defined (P_MEM_MMAP_HAS_ANON)
+		if (mlock (addr, n_bytes) != 0 && strict) {
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_io (),
+					     p_error_get_last_system (),
+					     "Failed to call mlock() to lock memory");
+#else
+		if (strict) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NOT_SUPPORTED,
+					     0,
+					     "Memory locking is not supported on this platform");
+#endif
+			p_mem_munmap (addr, n_bytes, NULL);
+			return NULL;
+		}
+	}
+
+	return addr;
+}
+
 P_LIB_API pboolean
 p_mem_munmap (ppointer	mem,
 	      psize	n_bytes,
@@ -57,6 +57,13 @@
  * i.e. custom memory allocator can request a large block first, and then it
  * allocates chunks of memory within the block upon request.
  *
+ * p_mem_mmap_full() gives more control over the mapped memory: it can be backed
+ * by huge pages to reduce TLB misses, pre-faulted to avoid page faults on the
+ * first touch, locked in the physical memory, or bound to a particular NUMA
+ * node. All of these are optimizations rather than requirements, so if the
+ * system refuses one of them, the allocation falls back to the regular memory
+ * unless #P_MEM_MAP_FLAG_STRICT is given.
+ *
  * @note OS/2 supports non-backed memory pages allocation, but in a specific
  * way: an exception handler to control access to uncommitted pages must be
  * allocated on the stack of each thread before using the mapped memory. To
@@ -77,6 +84,25 @@
 
 P_BEGIN_DECLS
 
+/** Memory mapping flags for p_mem_mmap_full(). */
+typedef enum PMemMapFlags_ {
+	P_MEM_MAP_FLAG_NONE			= 0,		/**< Regular memory mapping.			*/
+	P_MEM_MAP_FLAG_HUGE_PAGES		= 1 << 0,	/**< Use explicit (reserved) huge pages,
+								     falls back to transparent ones.		*/
+	P_MEM_MAP_FLAG_TRANSPARENT_HUGE_PAGES	= 1 << 1,	/**< Ask for transparent huge pages.		*/
+	P_MEM_MAP_FLAG_POPULATE			= 1 << 2,	/**< Pre-fault all the pages.			*/
+	P_MEM_MAP_FLAG_LOCK			= 1 << 3,	/**< Lock the pages in the physical memory.	*/
+	P_MEM_MAP_FLAG_STRICT			= 1 << 4	/**< Fail instead of falling back if any of
+								     the requested options can't be applied.	*/
+} PMemMapFlags;
+
+/**
+ * @brief Builds a p_mem_mmap_full() flag to bind memory to a NUMA node.
+ * @param node NUMA node index, starting from 0.
+ * @since 0.0.6
+ */
+#define P_MEM_MAP_NUMA_NODE(node)	((puint) (((node) + 1) & 0xFFFF) << 16)
+
 /** Memory management table. */
 typedef struct PMemVTable_ {
 	ppointer	(*f_malloc)	(psize		n_bytes);	/**< malloc() implementation.	*/
@@ -173,6 +199,41 @@ P_LIB_API void		p_mem_restore_vtable	(void);
 P_LIB_API ppointer	p_mem_mmap		(psize			n_bytes,
 						 PError			**error);
 
+/**
+ * @brief Gets memory from the system using a memory mapping with additional
+ * options.
+ * @param n_bytes Size of the memory block in bytes.
+ * @param flags Bitwise combination of #PMemMapFlags, optionally with a NUMA
+ * node built by P_MEM_MAP_NUMA_NODE().
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to the allocated memory block in case of success, NULL
+ * otherwise.
+ * @since 0.0.6
+ *
+ * Release the returned memory with p_mem_munmap() using the same @a n_bytes.
+ *
+ * Explicit huge pages (#P_MEM_MAP_FLAG_HUGE_PAGES) are taken from the pool
+ * reserved by the system administrator and are used only if @a n_bytes is a
+ * multiple of p_mem_get_huge_page_size(). Otherwise, or if the pool is
+ * exhausted, transparent huge pages are requested instead. For transparent huge
+ * pages the block is aligned to the huge page size.
+ *
+ * Huge pages, NUMA binding and pre-faulting are supported only on Linux,
+ * locking is supported on all the UNIX systems and Windows. Unless
+ * #P_MEM_MAP_FLAG_STRICT is given, the options which are not supported or
+ * refused by the system (i.e. due to the locked memory limit) are ignored.
+ */
+P_LIB_API ppointer	p_mem_mmap_full		(psize			n_bytes,
+						 puint			flags,
+						 PError			**error);
+
+/**
+ * @brief Gets the system huge page size.
+ * @return Default huge page size in bytes, 0 if huge pages are not supported.
+ * @since 0.0.6
+ */
+P_LIB_API psize		p_mem_get_huge_page_size	(void);
+
 /**
  * @brief Unmaps memory back to the system.
  * @param mem Pointer to a memory block previously allocated using the
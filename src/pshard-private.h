@@ -0,0 +1,62 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSHARD_PRIVATE_H
+#define PLIBSYS_HEADER_PSHARD_PRIVATE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/** Maximal number of shards with independent per-thread data. */
+#define P_SHARD_MAX_COUNT	32
+
+/** Assumed CPU cache line size, in bytes. Keep shards on separate lines. */
+#define P_SHARD_LINE_SIZE	64
+
+/**
+ * @brief Gets a number of shards to spread per-thread data over.
+ * @return Number of shards, a power of two which is not less than the ideal
+ * number of threads, up to #P_SHARD_MAX_COUNT.
+ */
+puint		p_shard_get_count		(void);
+
+/**
+ * @brief Gets a shard index of the current (caller) thread.
+ * @return Index of the shard, take it by the mask of the shard count.
+ *
+ * Threads are assigned to shards in a round-robin manner on first use if
+ * thread-local storage is supported, otherwise the thread ID is hashed.
+ */
+puint		p_shard_get_thread_index	(void);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSHARD_PRIVATE_H */
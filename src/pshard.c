@@ -0,0 +1,72 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "patomic.h"
+#include "puthread.h"
+#include "pshard-private.h"
+
+#ifdef PLIBSYS_THREAD_LOCAL
+static volatile pint pp_shard_next_thread_index = 0;
+static PLIBSYS_THREAD_LOCAL puint pp_shard_thread_index = 0;
+#endif
+
+puint
+p_shard_get_count (void)
+{
+	puint	ret;
+	pint	cpus;
+
+	cpus = p_uthread_ideal_count ();
+
+	for (ret = 1; ret < (puint) cpus && ret < P_SHARD_MAX_COUNT; ret <<= 1)
+		;
+
+	return ret;
+}
+
+puint
+p_shard_get_thread_index (void)
+{
+#ifdef PLIBSYS_THREAD_LOCAL
+	puint	index;
+
+	if (P_UNLIKELY ((index = pp_shard_thread_index) == 0)) {
+		index = (puint) p_atomic_int_add (&pp_shard_next_thread_index, 1) + 1;
+		pp_shard_thread_index = index;
+	}
+
+	return index;
+#else
+	puint64	id;
+
+	/* Thread handles are usually aligned pointers, so mix the bits */
+	id  = (puint64) ((psize) p_uthread_current_id ());
+	id ^= id >> 33;
+	id *= 0xFF51AFD7ED558CCDULL;
+	id ^= id >> 33;
+
+	return (puint) id;
+#endif
+}
@@ -45,6 +45,22 @@ p_shm_new (const pchar		*name,
 	return NULL;
 }
 
+P_LIB_API PShm *
+p_shm_new_full (const pchar	*name,
+		psize		size,
+		PShmAccessPerms	perms,
+		puint		flags,
+		PError		**error)
+{
+	P_UNUSED (name);
+	P_UNUSED (size);
+	P_UNUSED (perms);
+	P_UNUSED (flags);
+	P_UNUSED (error);
+
+	return NULL;
+}
+
 P_LIB_API void
 p_shm_take_ownership (PShm *shm)
 {
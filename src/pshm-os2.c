@@ -255,6 +255,27 @@ p_shm_new (const pchar		*name,
 	return ret;
 }
 
+P_LIB_API PShm *
+p_shm_new_full (const pchar	*name,
+		psize		size,
+		PShmAccessPerms	perms,
+		puint		flags,
+		PError		**error)
+{
+	/* Memory is committed at allocation time and huge pages are not
+	 * available, locking is not supported by the system */
+	if (P_UNLIKELY ((flags & P_SHM_FLAG_STRICT) &&
+			(flags & (P_SHM_FLAG_HUGE_PAGES | P_SHM_FLAG_LOCK)))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+				     0,
+				     "Requested shared memory options are not supported");
+		return NULL;
+	}
+
+	return p_shm_new (name, size, perms, error);
+}
+
 P_LIB_API void
 p_shm_take_ownership (PShm *shm)
 {
@@ -39,39 +39,116 @@
 #include <sys/mman.h>
 #include <errno.h>
 
+#if defined (P_OS_LINUX)
+#  include <stdio.h>
+#  include <sys/vfs.h>
+#  define P_SHM_HAS_HUGETLBFS
+#  define P_SHM_HUGETLBFS_MAGIC	0x958458f6
+#  define P_SHM_MOUNTS_FILE	"/proc/mounts"
+#endif
+
 #define P_SHM_SUFFIX		"_p_shm_object"
 #define P_SHM_INVALID_HDL	-1
 
 struct PShm_ {
 	pboolean	shm_created;
 	pchar		*platform_key;
+	pchar		*hugetlb_path;
 	ppointer	addr;
 	psize		size;
+	psize		map_size;
+	psize		page_size;
+	puint		flags;
 	PSemaphore	*sem;
 	PShmAccessPerms	perms;
 };
 
+#ifdef P_SHM_HAS_HUGETLBFS
+static pchar * pp_shm_get_hugetlb_path (const pchar *key, psize *page_size);
+#endif
+static pint pp_shm_open (PShm *shm, pboolean *is_exists);
+static pboolean pp_shm_map_segment (PShm *shm, pboolean *is_exists, PError **error);
+static pboolean pp_shm_apply_flags (PShm *shm, PError **error);
 static pboolean pp_shm_create_handle (PShm *shm, PError **error);
 static void pp_shm_clean_handle (PShm *shm);
 
-static pboolean
-pp_shm_create_handle (PShm	*shm,
-		      PError	**error)
+#ifdef P_SHM_HAS_HUGETLBFS
+static pchar *
+pp_shm_get_hugetlb_path (const pchar	*key,
+			 psize		*page_size)
 {
-	pboolean	is_exists;
-	pint		fd;
-	pint		flags;
-	struct stat	stat_buf;
+	FILE		*mounts;
+	struct statfs	fs_buf;
+	pchar		line[1024];
+	pchar		mount_dir[512];
+	pchar		fs_type[64];
+	pchar		*ret;
+
+	if (P_UNLIKELY ((mounts = fopen (P_SHM_MOUNTS_FILE, "r")) == NULL))
+		return NULL;
 
-	if (P_UNLIKELY (shm == NULL || shm->platform_key == NULL)) {
-		p_error_set_error_p (error,
-				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
-				     0,
-				     "Invalid input argument");
-		return FALSE;
+	ret = NULL;
+
+	while (ret == NULL && fgets (line, sizeof (line), mounts) != NULL) {
+		if (sscanf (line, "%*s %511s %63s", mount_dir, fs_type) != 2)
+			continue;
+
+		if (strcmp (fs_type, "hugetlbfs") != 0)
+			continue;
+
+		/* Mount point must be usable by us and report its page size */
+		if (access (mount_dir, W_OK | X_OK) != 0 ||
+		    statfs (mount_dir, &fs_buf) != 0 ||
+		    (pulong) fs_buf.f_type != P_SHM_HUGETLBFS_MAGIC ||
+		    fs_buf.f_bsize <= 0)
+			continue;
+
+		if (P_UNLIKELY ((ret = p_malloc0 (strlen (mount_dir) + strlen (key) + 2)) == NULL))
+			break;
+
+		strcpy (ret, mount_dir);
+
+		if (key[0] != '/')
+			strcat (ret, "/");
+
+		strcat (ret, key);
+
+		*page_size = (psize) fs_buf.f_bsize;
 	}
 
-	is_exists = FALSE;
+	fclose (mounts);
+
+	return ret;
+}
+#endif
+
+static pint
+pp_shm_open (PShm	*shm,
+	     pboolean	*is_exists)
+{
+	pint fd;
+
+	*is_exists = FALSE;
+
+	if (shm->hugetlb_path != NULL) {
+		while ((fd = open (shm->hugetlb_path,
+				   O_CREAT | O_EXCL | O_RDWR,
+				   0660)) == P_SHM_INVALID_HDL &&
+		       p_error_get_last_system () == EINTR)
+			;
+
+		if (fd == P_SHM_INVALID_HDL && p_error_get_last_system () == EEXIST) {
+			*is_exists = TRUE;
+
+			while ((fd = open (shm->hugetlb_path,
+					   O_RDWR,
+					   0660)) == P_SHM_INVALID_HDL &&
+			       p_error_get_last_system () == EINTR)
+				;
+		}
+
+		return fd;
+	}
 
 	while ((fd = shm_open (shm->platform_key,
 			       O_CREAT | O_EXCL | O_RDWR,
@@ -79,30 +156,42 @@ pp_shm_create_handle (PShm	*shm,
 	       p_error_get_last_system () == EINTR)
 		;
 
-	if (fd == P_SHM_INVALID_HDL) {
-		if (p_error_get_last_system () == EEXIST) {
-			is_exists = TRUE;
+	if (fd == P_SHM_INVALID_HDL && p_error_get_last_system () == EEXIST) {
+		*is_exists = TRUE;
 
-			while ((fd = shm_open (shm->platform_key,
-					       O_RDWR,
-					       0660)) == P_SHM_INVALID_HDL &&
-			       p_error_get_last_system () == EINTR)
-				;
-		}
-	} else
-		shm->shm_created = TRUE;
+		while ((fd = shm_open (shm->platform_key,
+				       O_RDWR,
+				       0660)) == P_SHM_INVALID_HDL &&
+		       p_error_get_last_system () == EINTR)
+			;
+	}
+
+	return fd;
+}
 
-	if (P_UNLIKELY (fd == P_SHM_INVALID_HDL)) {
+static pboolean
+pp_shm_map_segment (PShm	*shm,
+		    pboolean	*is_exists,
+		    PError	**error)
+{
+	pint		fd;
+	pint		flags;
+	pint		map_flags;
+	psize		size;
+	struct stat	stat_buf;
+
+	if (P_UNLIKELY ((fd = pp_shm_open (shm, is_exists)) == P_SHM_INVALID_HDL)) {
 		p_error_set_error_p (error,
 				     (pint) p_error_get_last_ipc (),
 				     p_error_get_last_system (),
 				     "Failed to call shm_open() to create memory segment");
-		pp_shm_clean_handle (shm);
 		return FALSE;
 	}
 
+	shm->shm_created = !(*is_exists);
+
 	/* Try to get size of the existing file descriptor */
-	if (is_exists) {
+	if (*is_exists) {
 		if (P_UNLIKELY (fstat (fd, &stat_buf) == -1)) {
 			p_error_set_error_p (error,
 					     (pint) p_error_get_last_ipc (),
@@ -110,31 +199,41 @@ pp_shm_create_handle (PShm	*shm,
 					     "Failed to call fstat() to get memory segment size");
 
 			if (P_UNLIKELY (p_sys_close (fd) != 0))
-				P_WARNING ("PShm::pp_shm_create_handle: p_sys_close() failed(1)");
+				P_WARNING ("PShm::pp_shm_map_segment: p_sys_close() failed(1)");
 
-			pp_shm_clean_handle (shm);
 			return FALSE;
 		}
 
-		shm->size = (psize) stat_buf.st_size;
+		size = (psize) stat_buf.st_size;
 	} else {
-		if (P_UNLIKELY ((ftruncate (fd, (off_t) shm->size)) == -1)) {
+		size = shm->size;
+
+		/* Huge page backed files can be sized in whole pages only */
+		if (shm->hugetlb_path != NULL)
+			size = (size + shm->page_size - 1) / shm->page_size * shm->page_size;
+
+		if (P_UNLIKELY ((ftruncate (fd, (off_t) size)) == -1)) {
 			p_error_set_error_p (error,
 					     (pint) p_error_get_last_ipc (),
 					     p_error_get_last_system (),
 					     "Failed to call ftruncate() to set memory segment size");
 
 			if (P_UNLIKELY (p_sys_close (fd) != 0))
-				P_WARNING ("PShm::pp_shm_create_handle: p_sys_close() failed(2)");
+				P_WARNING ("PShm::pp_shm_map_segment: p_sys_close() failed(2)");
 
-			pp_shm_clean_handle (shm);
 			return FALSE;
 		}
 	}
 
-	flags = (shm->perms == P_SHM_ACCESS_READONLY) ? PROT_READ : PROT_READ | PROT_WRITE;
+	flags     = (shm->perms == P_SHM_ACCESS_READONLY) ? PROT_READ : PROT_READ | PROT_WRITE;
+	map_flags = MAP_SHARED;
+
+#ifdef MAP_POPULATE
+	if (shm->flags & P_SHM_FLAG_POPULATE)
+		map_flags |= MAP_POPULATE;
+#endif
 
-	if (P_UNLIKELY ((shm->addr = mmap (NULL, shm->size, flags, MAP_SHARED, fd, 0)) == (void *) -1)) {
+	if (P_UNLIKELY ((shm->addr = mmap (NULL, size, flags, map_flags, fd, 0)) == (void *) -1)) {
 		p_error_set_error_p (error,
 				     (pint) p_error_get_last_ipc (),
 				     p_error_get_last_system (),
@@ -142,14 +241,129 @@ pp_shm_create_handle (PShm	*shm,
 		shm->addr = NULL;
 
 		if (P_UNLIKELY (p_sys_close (fd) != 0))
-			P_WARNING ("PShm::pp_shm_create_handle: p_sys_close() failed(3)");
+			P_WARNING ("PShm::pp_shm_map_segment: p_sys_close() failed(3)");
 
-		pp_shm_clean_handle (shm);
 		return FALSE;
 	}
 
 	if (P_UNLIKELY (p_sys_close (fd) != 0))
-		P_WARNING ("PShm::pp_shm_create_handle: p_sys_close() failed(4)");
+		P_WARNING ("PShm::pp_shm_map_segment: p_sys_close() failed(4)");
+
+	shm->map_size = size;
+
+	if (*is_exists)
+		shm->size = size;
+
+	return TRUE;
+}
+
+static pboolean
+pp_shm_apply_flags (PShm	*shm,
+		    PError	**error)
+{
+	pboolean		strict = (shm->flags & P_SHM_FLAG_STRICT) ? TRUE : FALSE;
+#ifndef MAP_POPULATE
+	volatile const puchar	*ptr;
+	psize			page_size;
+	psize			i;
+#endif
+
+	if ((shm->flags & P_SHM_FLAG_HUGE_PAGES) && shm->hugetlb_path == NULL) {
+		/* Transparent huge pages for shared memory are advisory only */
+#ifdef MADV_HUGEPAGE
+		if (P_UNLIKELY (madvise (shm->addr, shm->map_size, MADV_HUGEPAGE) != 0 && strict)) {
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_ipc (),
+					     p_error_get_last_system (),
+					     "Failed to call madvise() to request huge pages");
+			return FALSE;
+		}
+#endif
+	}
+
+#ifndef MAP_POPULATE
+	/* Read access is enough to fault in the pages of the shared object and
+	 * doesn't race with the data written by other processes */
+	if (shm->flags & P_SHM_FLAG_POPULATE) {
+		ptr       = (volatile const puchar *) shm->addr;
+		page_size = (psize) sysconf (_SC_PAGESIZE);
+
+		for (i = 0; i < shm->map_size; i += page_size)
+			(void) ptr[i];
+	}
+#endif
+
+	if (shm->flags & P_SHM_FLAG_LOCK) {
+		if (P_UNLIKELY (mlock (shm->addr, shm->map_size) != 0 && strict)) {
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_ipc (),
+					     p_error_get_last_system (),
+					     "Failed to call mlock() to lock memory segment");
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+static pboolean
+pp_shm_create_handle (PShm	*shm,
+		      PError	**error)
+{
+	pboolean	is_exists;
+	pboolean	strict;
+
+	if (P_UNLIKELY (shm == NULL || shm->platform_key == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	is_exists = FALSE;
+	strict    = (shm->flags & P_SHM_FLAG_STRICT) ? TRUE : FALSE;
+
+	if (shm->flags & P_SHM_FLAG_HUGE_PAGES) {
+#ifdef P_SHM_HAS_HUGETLBFS
+		shm->hugetlb_path = pp_shm_get_hugetlb_path (shm->platform_key, &shm->page_size);
+#endif
+		if (shm->hugetlb_path == NULL && strict) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+					     0,
+					     "No huge page file system is available for memory segment");
+			pp_shm_clean_handle (shm);
+			return FALSE;
+		}
+	}
+
+	if (shm->hugetlb_path != NULL &&
+	    pp_shm_map_segment (shm, &is_exists, strict ? error : NULL) == FALSE) {
+		if (strict) {
+			pp_shm_clean_handle (shm);
+			return FALSE;
+		}
+
+		/* Huge page pool may be exhausted, fall back to a regular segment */
+		if (shm->shm_created == TRUE && unlink (shm->hugetlb_path) == -1)
+			P_WARNING ("PShm::pp_shm_create_handle: unlink() failed");
+
+		p_free (shm->hugetlb_path);
+
+		shm->hugetlb_path = NULL;
+		shm->shm_created  = FALSE;
+	}
+
+	if (shm->addr == NULL && pp_shm_map_segment (shm, &is_exists, error) == FALSE) {
+		pp_shm_clean_handle (shm);
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_shm_apply_flags (shm, error) == FALSE)) {
+		pp_shm_clean_handle (shm);
+		return FALSE;
+	}
 
 	if (P_UNLIKELY ((shm->sem = p_semaphore_new (shm->platform_key, 1,
 						     is_exists ? P_SEM_ACCESS_OPEN : P_SEM_ACCESS_CREATE,
@@ -164,20 +378,31 @@ pp_shm_create_handle (PShm	*shm,
 static void
 pp_shm_clean_handle (PShm *shm)
 {
-	if (P_UNLIKELY (shm->addr != NULL && munmap (shm->addr, shm->size) == -1))
+	if (P_UNLIKELY (shm->addr != NULL && munmap (shm->addr, shm->map_size) == -1))
 		P_ERROR ("PShm::pp_shm_clean_handle: munmap () failed");
 
-	if (shm->shm_created == TRUE && shm_unlink (shm->platform_key) == -1)
-		P_ERROR ("PShm::pp_shm_clean_handle: shm_unlink() failed");
+	if (shm->shm_created == TRUE) {
+		if (shm->hugetlb_path != NULL) {
+			if (P_UNLIKELY (unlink (shm->hugetlb_path) == -1))
+				P_ERROR ("PShm::pp_shm_clean_handle: unlink() failed");
+		} else if (P_UNLIKELY (shm_unlink (shm->platform_key) == -1))
+			P_ERROR ("PShm::pp_shm_clean_handle: shm_unlink() failed");
+	}
 
 	if (P_LIKELY (shm->sem != NULL)) {
 		p_semaphore_free (shm->sem);
 		shm->sem         = NULL;
 	}
 
+	if (shm->hugetlb_path != NULL) {
+		p_free (shm->hugetlb_path);
+		shm->hugetlb_path = NULL;
+	}
+
 	shm->shm_created = FALSE;
 	shm->addr        = NULL;
 	shm->size        = 0;
+	shm->map_size    = 0;
 }
 
 P_LIB_API PShm *
@@ -185,6 +410,16 @@ p_shm_new (const pchar		*name,
 	   psize		size,
 	   PShmAccessPerms	perms,
 	   PError		**error)
+{
+	return p_shm_new_full (name, size, perms, P_SHM_FLAG_NONE, error);
+}
+
+P_LIB_API PShm *
+p_shm_new_full (const pchar	*name,
+		psize		size,
+		PShmAccessPerms	perms,
+		puint		flags,
+		PError		**error)
 {
 	PShm	*ret;
 	pchar	*new_name;
@@ -225,6 +460,7 @@ p_shm_new (const pchar		*name,
 #endif
 	ret->perms = perms;
 	ret->size  = size;
+	ret->flags = flags;
 
 	p_free (new_name);
 
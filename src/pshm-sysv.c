@@ -37,6 +37,7 @@
 #include <sys/shm.h>
 #include <sys/types.h>
 #include <sys/ipc.h>
+#include <sys/mman.h>
 #include <errno.h>
 
 #define P_SHM_SUFFIX		"_p_shm_object"
@@ -51,20 +52,73 @@ struct PShm_ {
 	pshm_hdl	shm_hdl;
 	ppointer	addr;
 	psize		size;
+	puint		flags;
 	PSemaphore	*sem;
 	PShmAccessPerms	perms;
 };
 
+static pboolean pp_shm_apply_flags (PShm *shm, pboolean huge_pages, PError **error);
 static pboolean pp_shm_create_handle (PShm *shm, PError **error);
 static void pp_shm_clean_handle (PShm *shm);
 
+static pboolean
+pp_shm_apply_flags (PShm	*shm,
+		    pboolean	huge_pages,
+		    PError	**error)
+{
+	volatile const puchar	*ptr;
+	pboolean		strict = (shm->flags & P_SHM_FLAG_STRICT) ? TRUE : FALSE;
+	psize			page_size;
+	psize			i;
+
+	if ((shm->flags & P_SHM_FLAG_HUGE_PAGES) && huge_pages == FALSE) {
+		/* Transparent huge pages for shared memory are advisory only */
+#ifdef MADV_HUGEPAGE
+		if (P_UNLIKELY (madvise (shm->addr, shm->size, MADV_HUGEPAGE) != 0 && strict)) {
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_ipc (),
+					     p_error_get_last_system (),
+					     "Failed to call madvise() to request huge pages");
+			return FALSE;
+		}
+#endif
+	}
+
+	/* Read access is enough to fault in the pages of the shared object and
+	 * doesn't race with the data written by other processes */
+	if (shm->flags & P_SHM_FLAG_POPULATE) {
+		ptr       = (volatile const puchar *) shm->addr;
+		page_size = (psize) sysconf (_SC_PAGESIZE);
+
+		for (i = 0; i < shm->size; i += page_size)
+			(void) ptr[i];
+	}
+
+	if (shm->flags & P_SHM_FLAG_LOCK) {
+		if (P_UNLIKELY (mlock (shm->addr, shm->size) != 0 && strict)) {
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_ipc (),
+					     p_error_get_last_system (),
+					     "Failed to call mlock() to lock memory segment");
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
 static pboolean
 pp_shm_create_handle (PShm	*shm,
 		      PError	**error)
 {
 	pboolean	is_exists;
+	pboolean	huge_pages;
 	pint		flags;
 	pint		built;
+#ifdef SHM_HUGETLB
+	psize		huge_size;
+#endif
+	PErrorIPC	huge_error;
 	struct shmid_ds	shm_stat;
 
 	if (P_UNLIKELY (shm == NULL || shm->platform_key == NULL)) {
@@ -96,11 +150,38 @@ pp_shm_create_handle (PShm	*shm,
 		return FALSE;
 	}
 
-	flags = (shm->perms == P_SHM_ACCESS_READONLY) ? 0444 : 0660;
+	flags      = (shm->perms == P_SHM_ACCESS_READONLY) ? 0444 : 0660;
+	huge_pages = FALSE;
+
+	if (shm->flags & P_SHM_FLAG_HUGE_PAGES) {
+		huge_error = P_ERROR_IPC_NOT_IMPLEMENTED;
+#ifdef SHM_HUGETLB
+		/* Huge page backed segments can be sized in whole pages only */
+		if ((huge_size = p_mem_get_huge_page_size ()) > 0) {
+			shm->shm_hdl = shmget (shm->unix_key,
+					       (shm->size + huge_size - 1) / huge_size * huge_size,
+					       IPC_CREAT | IPC_EXCL | SHM_HUGETLB | flags);
+
+			huge_pages = (shm->shm_hdl != P_SHM_INVALID_HDL);
+			huge_error = huge_pages || p_error_get_last_system () == EEXIST ?
+				     P_ERROR_IPC_NONE : p_error_get_last_ipc ();
+		}
+#endif
+		if (P_UNLIKELY (huge_error != P_ERROR_IPC_NONE && (shm->flags & P_SHM_FLAG_STRICT))) {
+			p_error_set_error_p (error,
+					     (pint) huge_error,
+					     p_error_get_last_system (),
+					     "Failed to call shmget() to create huge page memory segment");
+			pp_shm_clean_handle (shm);
+			return FALSE;
+		}
+	}
 
-	if ((shm->shm_hdl = shmget (shm->unix_key,
-				    shm->size,
-				    IPC_CREAT | IPC_EXCL | flags)) == P_SHM_INVALID_HDL) {
+	if (huge_pages == TRUE)
+		shm->file_created = (built == 1);
+	else if ((shm->shm_hdl = shmget (shm->unix_key,
+					 shm->size,
+					 IPC_CREAT | IPC_EXCL | flags)) == P_SHM_INVALID_HDL) {
 		if (p_error_get_last_system () == EEXIST) {
 			is_exists = TRUE;
 
@@ -140,6 +221,11 @@ pp_shm_create_handle (PShm	*shm,
 		return FALSE;
 	}
 
+	if (P_UNLIKELY (pp_shm_apply_flags (shm, huge_pages, error) == FALSE)) {
+		pp_shm_clean_handle (shm);
+		return FALSE;
+	}
+
 	if (P_UNLIKELY ((shm->sem = p_semaphore_new (shm->platform_key, 1,
 						     is_exists ? P_SEM_ACCESS_OPEN : P_SEM_ACCESS_CREATE,
 						     error)) == NULL)) {
@@ -186,6 +272,16 @@ p_shm_new (const pchar		*name,
 	   psize		size,
 	   PShmAccessPerms	perms,
 	   PError		**error)
+{
+	return p_shm_new_full (name, size, perms, P_SHM_FLAG_NONE, error);
+}
+
+P_LIB_API PShm *
+p_shm_new_full (const pchar	*name,
+		psize		size,
+		PShmAccessPerms	perms,
+		puint		flags,
+		PError		**error)
 {
 	PShm	*ret;
 	pchar	*new_name;
@@ -221,6 +317,7 @@ p_shm_new (const pchar		*name,
 	ret->platform_key = p_ipc_get_platform_key (new_name, FALSE);
 	ret->perms        = perms;
 	ret->size         = size;
+	ret->flags        = flags;
 
 	p_free (new_name);
 
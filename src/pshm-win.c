@@ -46,20 +46,60 @@ struct PShm_ {
 	pshm_hdl	shm_hdl;
 	ppointer	addr;
 	psize		size;
+	puint		flags;
 	PSemaphore	*sem;
 	PShmAccessPerms	perms;
 };
 
+static pboolean pp_shm_apply_flags (PShm *shm, PError **error);
 static pboolean pp_shm_create_handle (PShm *shm, PError **error);
 static void pp_shm_clean_handle (PShm *shm);
 
+static pboolean
+pp_shm_apply_flags (PShm	*shm,
+		    PError	**error)
+{
+	volatile const puchar	*ptr;
+	SYSTEM_INFO		sys_info;
+	psize			i;
+
+	/* Read access is enough to fault in the pages of the shared object and
+	 * doesn't race with the data written by other processes */
+	if (shm->flags & P_SHM_FLAG_POPULATE) {
+		ptr = (volatile const puchar *) shm->addr;
+
+		GetSystemInfo (&sys_info);
+
+		for (i = 0; i < shm->size; i += (psize) sys_info.dwPageSize)
+			(void) ptr[i];
+	}
+
+	if (shm->flags & P_SHM_FLAG_LOCK) {
+		if (P_UNLIKELY (VirtualLock (shm->addr, shm->size) == 0 && (shm->flags & P_SHM_FLAG_STRICT))) {
+			p_error_set_error_p (error,
+					     (pint) p_error_get_last_ipc (),
+					     p_error_get_last_system (),
+					     "Failed to call VirtualLock() to lock memory segment");
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
 static pboolean
 pp_shm_create_handle (PShm	*shm,
 		      PError	**error)
 {
 	pboolean			is_exists;
+	pboolean			huge_pages;
 	MEMORY_BASIC_INFORMATION	mem_stat;
 	DWORD				protect;
+	DWORD				map_access;
+#ifdef SEC_LARGE_PAGES
+	psize				huge_size;
+	psize				huge_total;
+#endif
 
 	if (P_UNLIKELY (shm == NULL || shm->platform_key == NULL)) {
 		p_error_set_error_p (error,
@@ -71,10 +111,49 @@ pp_shm_create_handle (PShm	*shm,
 
 	is_exists = FALSE;
 
-	protect = (shm->perms == P_SHM_ACCESS_READONLY) ? PAGE_READONLY : PAGE_READWRITE;
+	protect    = (shm->perms == P_SHM_ACCESS_READONLY) ? PAGE_READONLY : PAGE_READWRITE;
+	map_access = (protect == PAGE_READONLY) ? FILE_MAP_READ : FILE_MAP_ALL_ACCESS;
+	huge_pages = FALSE;
+
+	if (shm->flags & P_SHM_FLAG_HUGE_PAGES) {
+#ifdef SEC_LARGE_PAGES
+		/* Requires SeLockMemoryPrivilege, size must be in whole large pages */
+		if ((huge_size = (psize) GetLargePageMinimum ()) > 0) {
+			huge_total   = (shm->size + huge_size - 1) / huge_size * huge_size;
+			shm->shm_hdl = CreateFileMappingA (INVALID_HANDLE_VALUE,
+							   NULL,
+							   protect | SEC_COMMIT | SEC_LARGE_PAGES,
+							   HIDWORD(huge_total),
+							   LODWORD(huge_total),
+							   shm->platform_key);
+
+			if (shm->shm_hdl != NULL) {
+#  ifdef FILE_MAP_LARGE_PAGES
+				shm->addr = MapViewOfFile (shm->shm_hdl, map_access | FILE_MAP_LARGE_PAGES, 0, 0, 0);
+#  else
+				shm->addr = MapViewOfFile (shm->shm_hdl, map_access, 0, 0, 0);
+#  endif
+				if (shm->addr == NULL) {
+					CloseHandle (shm->shm_hdl);
+					shm->shm_hdl = P_SHM_INVALID_HDL;
+				} else
+					huge_pages = TRUE;
+			}
+		}
+#endif
+		if (P_UNLIKELY (huge_pages == FALSE && (shm->flags & P_SHM_FLAG_STRICT))) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IPC_NO_RESOURCES,
+					     p_error_get_last_system (),
+					     "Failed to create large page backed file mapping");
+			pp_shm_clean_handle (shm);
+			return FALSE;
+		}
+	}
 
 	/* Multibyte character set must be enabled */
-	if (P_UNLIKELY ((shm->shm_hdl = CreateFileMappingA (INVALID_HANDLE_VALUE,
+	if (huge_pages == FALSE &&
+	    P_UNLIKELY ((shm->shm_hdl = CreateFileMappingA (INVALID_HANDLE_VALUE,
 							    NULL,
 							    protect,
 							    HIDWORD(shm->size),
@@ -88,9 +167,8 @@ pp_shm_create_handle (PShm	*shm,
 		return FALSE;
 	}
 
-	protect = (protect == PAGE_READONLY) ? FILE_MAP_READ : FILE_MAP_ALL_ACCESS;
-
-	if (P_UNLIKELY ((shm->addr = MapViewOfFile (shm->shm_hdl, protect, 0, 0, 0)) == NULL)) {
+	if (huge_pages == FALSE &&
+	    P_UNLIKELY ((shm->addr = MapViewOfFile (shm->shm_hdl, map_access, 0, 0, 0)) == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) p_error_get_last_ipc (),
 				     p_error_get_last_system (),
@@ -113,6 +191,11 @@ pp_shm_create_handle (PShm	*shm,
 
 	shm->size = mem_stat.RegionSize;
 
+	if (P_UNLIKELY (pp_shm_apply_flags (shm, error) == FALSE)) {
+		pp_shm_clean_handle (shm);
+		return FALSE;
+	}
+
 	if (P_UNLIKELY ((shm->sem = p_semaphore_new (shm->platform_key, 1,
 						     is_exists ? P_SEM_ACCESS_OPEN : P_SEM_ACCESS_CREATE,
 						     error)) == NULL)) {
@@ -147,6 +230,16 @@ p_shm_new (const pchar		*name,
 	   psize		size,
 	   PShmAccessPerms	perms,
 	   PError		**error)
+{
+	return p_shm_new_full (name, size, perms, P_SHM_FLAG_NONE, error);
+}
+
+P_LIB_API PShm *
+p_shm_new_full (const pchar	*name,
+		psize		size,
+		PShmAccessPerms	perms,
+		puint		flags,
+		PError		**error)
 {
 	PShm	*ret;
 	pchar	*new_name;
@@ -182,6 +275,7 @@ p_shm_new (const pchar		*name,
 	ret->platform_key = p_ipc_get_platform_key (new_name, FALSE);
 	ret->perms        = perms;
 	ret->size         = size;
+	ret->flags        = flags;
 
 	p_free (new_name);
 
@@ -81,6 +81,15 @@
  *
  * You can take ownership of the shared memory segment with
  * p_shm_take_ownership() to explicitly remove it from the system after closing.
+ *
+ * Large segments which are accessed by several processes can be created with
+ * p_shm_new_full() to request huge page backing, to pre-fault all the pages at
+ * creation time and to lock them in the physical memory. This way the first
+ * access to the segment doesn't pay for page faults and TLB misses. All the
+ * options are applied on a best-effort basis unless #P_SHM_FLAG_STRICT is
+ * given. Huge page backed segments live in a separate namespace on some
+ * systems, so all the processes should pass the same #P_SHM_FLAG_HUGE_PAGES
+ * flag to attach to the same segment.
  */
 
 #if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
@@ -102,6 +111,16 @@ typedef enum PShmAccessPerms_ {
 	P_SHM_ACCESS_READWRITE	= 1	/**< Read/write access.	*/
 } PShmAccessPerms;
 
+/** Shared memory creation flags for p_shm_new_full(). */
+typedef enum PShmFlags_ {
+	P_SHM_FLAG_NONE		= 0,		/**< Regular shared memory segment.		*/
+	P_SHM_FLAG_HUGE_PAGES	= 1 << 0,	/**< Back the segment with huge pages.		*/
+	P_SHM_FLAG_POPULATE	= 1 << 1,	/**< Pre-fault all the pages on attach.		*/
+	P_SHM_FLAG_LOCK		= 1 << 2,	/**< Lock the pages in the physical memory.	*/
+	P_SHM_FLAG_STRICT	= 1 << 3	/**< Fail instead of falling back if any of
+						     the requested options can't be applied.	*/
+} PShmFlags;
+
 /** Shared memory opaque data structure. */
 typedef struct PShm_ PShm;
 
@@ -120,6 +139,36 @@ P_LIB_API PShm *	p_shm_new		(const pchar		*name,
 						 PShmAccessPerms	perms,
 						 PError			**error);
 
+/**
+ * @brief Creates a new #PShm object with extended creation options.
+ * @param name Shared memory name.
+ * @param size Size of the memory segment in bytes, can't be changed later.
+ * @param perms Memory segment permissions, see #PShmAccessPerms.
+ * @param flags Bitwise combination of #PShmFlags.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to a newly created #PShm object in case of success, NULL
+ * otherwise.
+ * @since 0.0.6
+ *
+ * Huge pages are taken from a mounted hugetlbfs (or an equivalent system
+ * mechanism) first, the segment size is rounded up to the huge page size in
+ * that case, though p_shm_get_size() still reports the requested size. If
+ * reserved huge pages are not available, transparent huge pages are
+ * requested for a regular segment.
+ *
+ * #P_SHM_FLAG_POPULATE pre-faults the pages of the mapping in the calling
+ * process, #P_SHM_FLAG_LOCK locks them with the system limits applied (see
+ * RLIMIT_MEMLOCK on UNIX systems).
+ *
+ * Without #P_SHM_FLAG_STRICT any option which can't be applied is silently
+ * skipped, with it the call fails instead.
+ */
+P_LIB_API PShm *	p_shm_new_full		(const pchar		*name,
+						 psize			size,
+						 PShmAccessPerms	perms,
+						 puint			flags,
+						 PError			**error);
+
 /**
  * @brief Takes ownership of a shared memory segment.
  * @param shm Shared memory segment.
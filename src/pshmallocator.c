@@ -0,0 +1,533 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "patomic.h"
+#include "pmem.h"
+#include "pshm.h"
+#include "pshmallocator.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define P_SHM_ALLOCATOR_MAGIC		0x50534841
+#define P_SHM_ALLOCATOR_BLOCK_MAGIC	0x50534142
+#define P_SHM_ALLOCATOR_VERSION		1
+#define P_SHM_ALLOCATOR_CLASS_COUNT	16
+#define P_SHM_ALLOCATOR_LARGE_CLASS	0xFFFFFFFF
+#define P_SHM_ALLOCATOR_SLAB_SIZE	65536
+#define P_SHM_ALLOCATOR_SLAB_RATIO	64
+
+/* Free list heads pack a block index (in alignment units) with an ABA tag */
+#define P_SHM_ALLOCATOR_INDEX_BITS	(sizeof (psize) == 8 ? 32 : 24)
+#define P_SHM_ALLOCATOR_INDEX_MASK	((((psize) 1) << P_SHM_ALLOCATOR_INDEX_BITS) - 1)
+
+#define P_SHM_ALLOCATOR_ALIGN(size)	(((size) + P_SHM_ALLOCATOR_ALIGNMENT - 1) &	\
+					 ~((psize) P_SHM_ALLOCATOR_ALIGNMENT - 1))
+
+typedef struct PShmAllocatorHeader_ {
+	volatile pint	magic;
+	puint32		version;
+	puint32		class_count;
+	puint32		reserved;
+	volatile psize	heap_top;
+	psize		heap_end;
+	psize		large_free;
+	volatile psize	free_heads[P_SHM_ALLOCATOR_CLASS_COUNT];
+} PShmAllocatorHeader;
+
+/* Precedes every block, the free list link is kept in the block itself */
+typedef struct PShmAllocatorBlock_ {
+	puint32		magic;
+	puint32		class_idx;
+	puint64		size;
+} PShmAllocatorBlock;
+
+struct PShmAllocator_ {
+	PShm			*shm;
+	PShmAllocatorHeader	*header;
+	puchar			*base;
+	psize			heap_start;
+	psize			slab_size;
+	pboolean		lock_free;
+};
+
+static const psize pp_shm_allocator_classes[P_SHM_ALLOCATOR_CLASS_COUNT] = {
+	16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096
+};
+
+static pint pp_shm_allocator_get_class (psize size);
+static PShmAllocatorBlock * pp_shm_allocator_get_block (const PShmAllocator *allocator, psize offset);
+static volatile psize * pp_shm_allocator_get_link (const PShmAllocator *allocator, psize block);
+static psize pp_shm_allocator_carve (PShmAllocator *allocator, psize size);
+static void pp_shm_allocator_push (PShmAllocator *allocator, pint cls, psize first, psize last);
+static psize pp_shm_allocator_pop (PShmAllocator *allocator, pint cls);
+static psize pp_shm_allocator_alloc_small (PShmAllocator *allocator, pint cls);
+static psize pp_shm_allocator_alloc_large (PShmAllocator *allocator, psize size);
+
+static pint
+pp_shm_allocator_get_class (psize size)
+{
+	pint i;
+
+	for (i = 0; i < P_SHM_ALLOCATOR_CLASS_COUNT; ++i)
+		if (size <= pp_shm_allocator_classes[i])
+			return i;
+
+	return -1;
+}
+
+static PShmAllocatorBlock *
+pp_shm_allocator_get_block (const PShmAllocator	*allocator,
+			    psize		offset)
+{
+	PShmAllocatorBlock	*block;
+	psize			heap_top;
+
+	heap_top = PPOINTER_TO_PSIZE (p_atomic_pointer_get (&allocator->header->heap_top));
+
+	if (P_UNLIKELY (offset < allocator->heap_start + sizeof (PShmAllocatorBlock) ||
+			offset >= heap_top ||
+			offset % P_SHM_ALLOCATOR_ALIGNMENT != 0))
+		return NULL;
+
+	block = (PShmAllocatorBlock *) (allocator->base + offset - sizeof (PShmAllocatorBlock));
+
+	if (P_UNLIKELY (block->magic != P_SHM_ALLOCATOR_BLOCK_MAGIC))
+		return NULL;
+
+	return block;
+}
+
+static volatile psize *
+pp_shm_allocator_get_link (const PShmAllocator	*allocator,
+			   psize		block)
+{
+	return (volatile psize *) (allocator->base + block + sizeof (PShmAllocatorBlock));
+}
+
+static psize
+pp_shm_allocator_carve (PShmAllocator	*allocator,
+			psize		size)
+{
+	psize top;
+
+	do {
+		top = PPOINTER_TO_PSIZE (p_atomic_pointer_get (&allocator->header->heap_top));
+
+		if (allocator->header->heap_end - top < size)
+			return 0;
+	} while (!p_atomic_pointer_compare_and_exchange (&allocator->header->heap_top,
+							 PSIZE_TO_POINTER (top),
+							 PSIZE_TO_POINTER (top + size)));
+
+	return top;
+}
+
+static void
+pp_shm_allocator_push (PShmAllocator	*allocator,
+		       pint		cls,
+		       psize		first,
+		       psize		last)
+{
+	volatile psize	*head = &allocator->header->free_heads[cls];
+	psize		old_head;
+	psize		new_head;
+
+	do {
+		old_head = PPOINTER_TO_PSIZE (p_atomic_pointer_get (head));
+		new_head = ((old_head >> P_SHM_ALLOCATOR_INDEX_BITS) + 1) << P_SHM_ALLOCATOR_INDEX_BITS;
+		new_head |= first / P_SHM_ALLOCATOR_ALIGNMENT;
+
+		*pp_shm_allocator_get_link (allocator, last) = (old_head & P_SHM_ALLOCATOR_INDEX_MASK) *
+							       P_SHM_ALLOCATOR_ALIGNMENT;
+	} while (!p_atomic_pointer_compare_and_exchange (head,
+							 PSIZE_TO_POINTER (old_head),
+							 PSIZE_TO_POINTER (new_head)));
+}
+
+static psize
+pp_shm_allocator_pop (PShmAllocator	*allocator,
+		      pint		cls)
+{
+	volatile psize	*head = &allocator->header->free_heads[cls];
+	psize		old_head;
+	psize		new_head;
+	psize		block;
+
+	do {
+		old_head = PPOINTER_TO_PSIZE (p_atomic_pointer_get (head));
+		block    = (old_head & P_SHM_ALLOCATOR_INDEX_MASK) * P_SHM_ALLOCATOR_ALIGNMENT;
+
+		if (block == 0)
+			return 0;
+
+		/* The link may be stale if the block has been taken concurrently,
+		 * the tag makes the exchange fail in that case */
+		new_head = ((old_head >> P_SHM_ALLOCATOR_INDEX_BITS) + 1) << P_SHM_ALLOCATOR_INDEX_BITS;
+		new_head |= (*pp_shm_allocator_get_link (allocator, block) / P_SHM_ALLOCATOR_ALIGNMENT) &
+			    P_SHM_ALLOCATOR_INDEX_MASK;
+	} while (!p_atomic_pointer_compare_and_exchange (head,
+							 PSIZE_TO_POINTER (old_head),
+							 PSIZE_TO_POINTER (new_head)));
+
+	return block;
+}
+
+static psize
+pp_shm_allocator_alloc_small (PShmAllocator	*allocator,
+			      pint		cls)
+{
+	PShmAllocatorBlock	*block;
+	psize			block_size;
+	psize			count;
+	psize			first;
+	psize			i;
+
+	if ((first = pp_shm_allocator_pop (allocator, cls)) != 0)
+		return first;
+
+	/* Carve a new slab, or at least a single block if the segment is full */
+	block_size = sizeof (PShmAllocatorBlock) + pp_shm_allocator_classes[cls];
+	count      = allocator->slab_size / block_size;
+
+	if (count == 0 || (first = pp_shm_allocator_carve (allocator, count * block_size)) == 0) {
+		count = 1;
+
+		if ((first = pp_shm_allocator_carve (allocator, block_size)) == 0)
+			return 0;
+	}
+
+	for (i = 0; i < count; ++i) {
+		block = (PShmAllocatorBlock *) (allocator->base + first + i * block_size);
+
+		block->magic     = P_SHM_ALLOCATOR_BLOCK_MAGIC;
+		block->class_idx = (puint32) cls;
+		block->size      = pp_shm_allocator_classes[cls];
+
+		if (i > 1)
+			*pp_shm_allocator_get_link (allocator, first + (i - 1) * block_size) = first + i * block_size;
+	}
+
+	/* The first block is ours, the rest goes to the free list at once */
+	if (count > 1)
+		pp_shm_allocator_push (allocator, cls, first + block_size, first + (count - 1) * block_size);
+
+	return first;
+}
+
+static psize
+pp_shm_allocator_alloc_large (PShmAllocator	*allocator,
+			      psize		size)
+{
+	PShmAllocatorBlock	*block;
+	PShmAllocatorBlock	*rest;
+	psize			*prev;
+	psize			cur;
+	psize			rest_offset;
+
+	prev = &allocator->header->large_free;
+
+	while ((cur = *prev) != 0) {
+		block = (PShmAllocatorBlock *) (allocator->base + cur);
+
+		if (block->size >= size) {
+			*prev = *pp_shm_allocator_get_link (allocator, cur);
+
+			/* Split off the tail if it is worth it */
+			if (block->size - size >= sizeof (PShmAllocatorBlock) + P_SHM_ALLOCATOR_MAX_SMALL_SIZE) {
+				rest_offset = cur + sizeof (PShmAllocatorBlock) + size;
+				rest        = (PShmAllocatorBlock *) (allocator->base + rest_offset);
+
+				rest->magic     = P_SHM_ALLOCATOR_BLOCK_MAGIC;
+				rest->class_idx = P_SHM_ALLOCATOR_LARGE_CLASS;
+				rest->size      = block->size - size - sizeof (PShmAllocatorBlock);
+				block->size     = size;
+
+				*pp_shm_allocator_get_link (allocator, rest_offset) = allocator->header->large_free;
+				allocator->header->large_free = rest_offset;
+			}
+
+			return cur;
+		}
+
+		prev = (psize *) pp_shm_allocator_get_link (allocator, cur);
+	}
+
+	if ((cur = pp_shm_allocator_carve (allocator, sizeof (PShmAllocatorBlock) + size)) == 0)
+		return 0;
+
+	block = (PShmAllocatorBlock *) (allocator->base + cur);
+
+	block->magic     = P_SHM_ALLOCATOR_BLOCK_MAGIC;
+	block->class_idx = P_SHM_ALLOCATOR_LARGE_CLASS;
+	block->size      = size;
+
+	return cur;
+}
+
+P_LIB_API PShmAllocator *
+p_shm_allocator_new (const pchar	*name,
+		     psize		size,
+		     PError		**error)
+{
+	PShmAllocator		*ret;
+	PShmAllocatorHeader	*header;
+	PShm			*shm;
+	psize			shm_size;
+	psize			heap_start;
+	psize			heap_end;
+
+	if (P_UNLIKELY (name == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((shm = p_shm_new (name, size, P_SHM_ACCESS_READWRITE, error)) == NULL))
+		return NULL;
+
+	shm_size   = p_shm_get_size (shm);
+	header     = (PShmAllocatorHeader *) p_shm_get_address (shm);
+	heap_start = P_SHM_ALLOCATOR_ALIGN (sizeof (PShmAllocatorHeader));
+
+	if (P_UNLIKELY (shm_size < heap_start + sizeof (PShmAllocatorBlock) + P_SHM_ALLOCATOR_ALIGNMENT)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Too small memory segment to hold required data");
+		p_shm_free (shm);
+		return NULL;
+	}
+
+	if (p_atomic_int_get (&header->magic) != P_SHM_ALLOCATOR_MAGIC) {
+		if (P_UNLIKELY (p_shm_lock (shm, error) == FALSE)) {
+			p_shm_free (shm);
+			return NULL;
+		}
+
+		if (p_atomic_int_get (&header->magic) != P_SHM_ALLOCATOR_MAGIC) {
+			/* Only as much as the free list index can address */
+			heap_end = shm_size - shm_size % P_SHM_ALLOCATOR_ALIGNMENT;
+
+			if (heap_end / P_SHM_ALLOCATOR_ALIGNMENT > P_SHM_ALLOCATOR_INDEX_MASK)
+				heap_end = P_SHM_ALLOCATOR_INDEX_MASK * P_SHM_ALLOCATOR_ALIGNMENT;
+
+			memset (header, 0, heap_start);
+
+			header->version     = P_SHM_ALLOCATOR_VERSION;
+			header->class_count = P_SHM_ALLOCATOR_CLASS_COUNT;
+			header->heap_end    = heap_end;
+
+			p_atomic_pointer_set (&header->heap_top, PSIZE_TO_POINTER (heap_start));
+			p_atomic_int_set (&header->magic, P_SHM_ALLOCATOR_MAGIC);
+		}
+
+		if (P_UNLIKELY (p_shm_unlock (shm, error) == FALSE)) {
+			p_shm_free (shm);
+			return NULL;
+		}
+	}
+
+	if (P_UNLIKELY (header->version != P_SHM_ALLOCATOR_VERSION ||
+			header->class_count != P_SHM_ALLOCATOR_CLASS_COUNT ||
+			header->heap_end > shm_size)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Memory segment doesn't contain a valid allocator");
+		p_shm_free (shm);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PShmAllocator))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for shared allocator");
+		p_shm_free (shm);
+		return NULL;
+	}
+
+	ret->shm        = shm;
+	ret->header     = header;
+	ret->base       = (puchar *) header;
+	ret->heap_start = heap_start;
+
+	/* Don't let a few size classes eat up a small segment */
+	ret->slab_size  = (header->heap_end - heap_start) / P_SHM_ALLOCATOR_SLAB_RATIO;
+
+	if (ret->slab_size > P_SHM_ALLOCATOR_SLAB_SIZE)
+		ret->slab_size = P_SHM_ALLOCATOR_SLAB_SIZE;
+
+	/* Emulated atomic operations don't work across the process boundary */
+	ret->lock_free  = p_atomic_is_lock_free ();
+
+	return ret;
+}
+
+P_LIB_API void
+p_shm_allocator_free (PShmAllocator *allocator)
+{
+	if (P_UNLIKELY (allocator == NULL))
+		return;
+
+	p_shm_free (allocator->shm);
+	p_free (allocator);
+}
+
+P_LIB_API void
+p_shm_allocator_take_ownership (PShmAllocator *allocator)
+{
+	if (P_UNLIKELY (allocator == NULL))
+		return;
+
+	p_shm_take_ownership (allocator->shm);
+}
+
+P_LIB_API psize
+p_shm_allocator_alloc (PShmAllocator	*allocator,
+		       psize		size,
+		       PError		**error)
+{
+	psize	block;
+	pint	cls;
+
+	if (P_UNLIKELY (allocator == NULL || size == 0 ||
+			size > allocator->header->heap_end)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return 0;
+	}
+
+	cls = pp_shm_allocator_get_class (size);
+
+	if (cls >= 0 && allocator->lock_free)
+		block = pp_shm_allocator_alloc_small (allocator, cls);
+	else {
+		if (P_UNLIKELY (p_shm_lock (allocator->shm, error) == FALSE))
+			return 0;
+
+		if (cls >= 0)
+			block = pp_shm_allocator_alloc_small (allocator, cls);
+		else
+			block = pp_shm_allocator_alloc_large (allocator, P_SHM_ALLOCATOR_ALIGN (size));
+
+		if (P_UNLIKELY (p_shm_unlock (allocator->shm, NULL) == FALSE))
+			P_WARNING ("PShmAllocator::p_shm_allocator_alloc: p_shm_unlock() failed");
+	}
+
+	if (P_UNLIKELY (block == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NO_RESOURCES,
+				     0,
+				     "Not enough free space in shared memory allocator");
+		return 0;
+	}
+
+	return block + sizeof (PShmAllocatorBlock);
+}
+
+P_LIB_API void
+p_shm_allocator_dealloc (PShmAllocator	*allocator,
+			 psize		offset)
+{
+	PShmAllocatorBlock	*block;
+	psize			block_offset;
+
+	if (P_UNLIKELY (allocator == NULL || offset == 0))
+		return;
+
+	if (P_UNLIKELY ((block = pp_shm_allocator_get_block (allocator, offset)) == NULL)) {
+		P_WARNING ("PShmAllocator::p_shm_allocator_dealloc: invalid block offset");
+		return;
+	}
+
+	block_offset = offset - sizeof (PShmAllocatorBlock);
+
+	if (block->class_idx < P_SHM_ALLOCATOR_CLASS_COUNT && allocator->lock_free) {
+		pp_shm_allocator_push (allocator, (pint) block->class_idx, block_offset, block_offset);
+		return;
+	}
+
+	if (P_UNLIKELY (p_shm_lock (allocator->shm, NULL) == FALSE)) {
+		P_WARNING ("PShmAllocator::p_shm_allocator_dealloc: p_shm_lock() failed");
+		return;
+	}
+
+	if (block->class_idx < P_SHM_ALLOCATOR_CLASS_COUNT)
+		pp_shm_allocator_push (allocator, (pint) block->class_idx, block_offset, block_offset);
+	else {
+		*pp_shm_allocator_get_link (allocator, block_offset) = allocator->header->large_free;
+		allocator->header->large_free = block_offset;
+	}
+
+	if (P_UNLIKELY (p_shm_unlock (allocator->shm, NULL) == FALSE))
+		P_WARNING ("PShmAllocator::p_shm_allocator_dealloc: p_shm_unlock() failed");
+}
+
+P_LIB_API ppointer
+p_shm_allocator_get_address (const PShmAllocator	*allocator,
+			     psize			offset)
+{
+	if (P_UNLIKELY (allocator == NULL ||
+			offset < allocator->heap_start ||
+			offset >= allocator->header->heap_end))
+		return NULL;
+
+	return allocator->base + offset;
+}
+
+P_LIB_API psize
+p_shm_allocator_get_offset (const PShmAllocator	*allocator,
+			    pconstpointer	address)
+{
+	const puchar *ptr = (const puchar *) address;
+
+	if (P_UNLIKELY (allocator == NULL ||
+			ptr < allocator->base + allocator->heap_start ||
+			ptr >= allocator->base + allocator->header->heap_end))
+		return 0;
+
+	return (psize) (ptr - allocator->base);
+}
+
+P_LIB_API psize
+p_shm_allocator_get_block_size (const PShmAllocator	*allocator,
+				psize			offset)
+{
+	PShmAllocatorBlock *block;
+
+	if (P_UNLIKELY (allocator == NULL))
+		return 0;
+
+	if (P_UNLIKELY ((block = pp_shm_allocator_get_block (allocator, offset)) == NULL))
+		return 0;
+
+	return (psize) block->size;
+}
@@ -0,0 +1,176 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pshmallocator.h
+ * @brief Shared memory allocator
+ * @author Alexander Saprykin
+ *
+ * A shared memory allocator manages a shared memory segment (see #PShm) as a
+ * heap, so variable-sized records can be placed right into the shared memory
+ * and passed between processes without copying or serialization.
+ *
+ * Allocated blocks are identified by offsets from the start of the segment
+ * rather than by pointers, because the segment may be mapped at different
+ * addresses in different processes. Use p_shm_allocator_get_address() to get
+ * the local address of a block and p_shm_allocator_get_offset() to convert it
+ * back. A zero offset never refers to a valid block.
+ *
+ * Small blocks (up to #P_SHM_ALLOCATOR_MAX_SMALL_SIZE bytes) are grouped into
+ * size classes and carved from the segment in slabs. Their free lists are
+ * lock-free if the platform provides lock-free atomic operations (see
+ * p_atomic_is_lock_free()), so allocation and deallocation usually don't
+ * require any system call. Larger blocks are served from a first-fit free list
+ * under the #PShm lock. Freed memory is reused only within the same size class
+ * for small blocks, and adjacent large blocks are not coalesced, so the segment
+ * should be sized with some reserve.
+ *
+ * All the processes working with the same allocator must use the same address
+ * model (i.e. all 32-bit or all 64-bit).
+ *
+ * Use p_shm_allocator_new() to create or attach to the allocator and
+ * p_shm_allocator_free() to detach from it. Take ownership with
+ * p_shm_allocator_take_ownership() to remove the segment from the system after
+ * detaching, please refer to the #PShm description for details.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSHMALLOCATOR_H
+#define PLIBSYS_HEADER_PSHMALLOCATOR_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+#include <perror.h>
+
+P_BEGIN_DECLS
+
+/** Maximum size of a block served from the lock-free size classes. */
+#define P_SHM_ALLOCATOR_MAX_SMALL_SIZE	4096
+
+/** Alignment of all the allocated blocks, in bytes. */
+#define P_SHM_ALLOCATOR_ALIGNMENT	16
+
+/** Shared memory allocator opaque data structure. */
+typedef struct PShmAllocator_ PShmAllocator;
+
+/**
+ * @brief Creates a new #PShmAllocator or attaches to an existing one.
+ * @param name Shared memory allocator name.
+ * @param size Size of the memory segment in bytes, pass 0 to attach to an
+ * already existing allocator.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to a newly created #PShmAllocator object in case of success,
+ * NULL otherwise.
+ * @since 0.0.6
+ *
+ * The first user of the segment initializes the allocator.
+ */
+P_LIB_API PShmAllocator *	p_shm_allocator_new		(const pchar		*name,
+								 psize			size,
+								 PError			**error);
+
+/**
+ * @brief Frees #PShmAllocator object.
+ * @param allocator #PShmAllocator to free.
+ * @since 0.0.6
+ *
+ * Blocks allocated in the segment are not released, other processes still can
+ * use them. The segment is not removed from the system unless the ownership
+ * has been taken with p_shm_allocator_take_ownership().
+ */
+P_LIB_API void			p_shm_allocator_free		(PShmAllocator		*allocator);
+
+/**
+ * @brief Takes ownership of a shared memory allocator.
+ * @param allocator #PShmAllocator to take ownership of.
+ * @since 0.0.6
+ */
+P_LIB_API void			p_shm_allocator_take_ownership	(PShmAllocator		*allocator);
+
+/**
+ * @brief Allocates a block in a #PShmAllocator segment.
+ * @param allocator #PShmAllocator to allocate the block with.
+ * @param size Size of the block in bytes.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Offset of the allocated block in case of success, 0 otherwise.
+ * @since 0.0.6
+ *
+ * The block is aligned to #P_SHM_ALLOCATOR_ALIGNMENT bytes, its content is
+ * undefined.
+ */
+P_LIB_API psize			p_shm_allocator_alloc		(PShmAllocator		*allocator,
+								 psize			size,
+								 PError			**error);
+
+/**
+ * @brief Releases a block previously allocated with p_shm_allocator_alloc().
+ * @param allocator #PShmAllocator to release the block with.
+ * @param offset Offset of the block.
+ * @since 0.0.6
+ *
+ * The block can be released by any process, not only by the one which has
+ * allocated it.
+ */
+P_LIB_API void			p_shm_allocator_dealloc		(PShmAllocator		*allocator,
+								 psize			offset);
+
+/**
+ * @brief Gets a local address of a block.
+ * @param allocator #PShmAllocator the block belongs to.
+ * @param offset Offset of the block.
+ * @return Address of the block in the calling process in case of success, NULL
+ * otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API ppointer		p_shm_allocator_get_address	(const PShmAllocator	*allocator,
+								 psize			offset);
+
+/**
+ * @brief Gets an offset of a block by its local address.
+ * @param allocator #PShmAllocator the block belongs to.
+ * @param address Address of the block in the calling process.
+ * @return Offset of the block in case of success, 0 otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API psize			p_shm_allocator_get_offset	(const PShmAllocator	*allocator,
+								 pconstpointer		address);
+
+/**
+ * @brief Gets a usable size of a block.
+ * @param allocator #PShmAllocator the block belongs to.
+ * @param offset Offset of the block.
+ * @return Usable size of the block in bytes (may be larger than requested) in
+ * case of success, 0 otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API psize			p_shm_allocator_get_block_size	(const PShmAllocator	*allocator,
+								 psize			offset);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSHMALLOCATOR_H */
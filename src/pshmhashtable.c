@@ -0,0 +1,508 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "patomic.h"
+#include "pmem.h"
+#include "pshm.h"
+#include "pshmhashtable.h"
+#include "pstring-private.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define P_SHM_HASH_TABLE_MAGIC		0x50534854
+#define P_SHM_HASH_TABLE_VERSION	1
+#define P_SHM_HASH_TABLE_UNIT		8
+#define P_SHM_HASH_TABLE_MAX_UNITS	0x7FFFFFFF
+#define P_SHM_HASH_TABLE_MIN_BUCKETS	16
+#define P_SHM_HASH_TABLE_MAX_BUCKETS	0x10000000
+#define P_SHM_HASH_TABLE_BUCKET_RATIO	128
+
+/* All the fields are of a fixed size to keep the layout the same for
+ * processes built with different compilers */
+typedef struct PShmHashTableHeader_ {
+	volatile pint	magic;
+	puint32		version;
+	puint32		bucket_count;
+	puint32		arena_offset;
+	puint32		arena_units;
+	volatile pint	arena_used;
+	volatile pint	count;
+	puint32		reserved;
+} PShmHashTableHeader;
+
+/* Entry is immutable after publishing, offsets are counted in units from the
+ * start of the arena, zero means no entry. The newest entry for a key shadows
+ * all the older ones, a tombstone entry marks the key as removed. */
+typedef struct PShmHashTableEntry_ {
+	volatile pint	next;
+	pint		tombstone;
+	puint32		hash;
+	puint32		key_len;
+	puint32		value_len;
+	puint32		reserved;
+} PShmHashTableEntry;
+
+struct PShmHashTable_ {
+	PShm			*shm;
+	PShmHashTableHeader	*header;
+	volatile pint		*buckets;
+	puchar			*arena;
+	PShmAccessPerms		perms;
+};
+
+static puint32 pp_shm_hash_table_hash (pconstpointer key, psize key_len);
+static psize pp_shm_hash_table_align (psize size);
+static pboolean pp_shm_hash_table_init_header (PShmHashTableHeader *header, psize size, psize buckets);
+static pboolean pp_shm_hash_table_check_header (const PShmHashTableHeader *header, psize size);
+static PShmHashTableEntry * pp_shm_hash_table_find (const PShmHashTable *table,
+						    pconstpointer key,
+						    psize key_len,
+						    puint32 hash);
+static pboolean pp_shm_hash_table_append (PShmHashTable *table,
+					  pconstpointer key,
+					  psize key_len,
+					  puint32 hash,
+					  pconstpointer value,
+					  psize value_len,
+					  pboolean tombstone,
+					  PError **error);
+
+static puint32
+pp_shm_hash_table_hash (pconstpointer	key,
+			psize		key_len)
+{
+	/* Hash is stored in the shared memory, it must be the same in all processes */
+	return p_string_hash ((const pchar *) key, key_len);
+}
+
+static psize
+pp_shm_hash_table_align (psize size)
+{
+	return (size + P_SHM_HASH_TABLE_UNIT - 1) / P_SHM_HASH_TABLE_UNIT * P_SHM_HASH_TABLE_UNIT;
+}
+
+static pboolean
+pp_shm_hash_table_init_header (PShmHashTableHeader	*header,
+			       psize			size,
+			       psize			buckets)
+{
+	psize	count;
+	psize	arena_offset;
+	psize	arena_units;
+
+	if (buckets == 0)
+		buckets = size / P_SHM_HASH_TABLE_BUCKET_RATIO;
+
+	if (buckets > P_SHM_HASH_TABLE_MAX_BUCKETS)
+		buckets = P_SHM_HASH_TABLE_MAX_BUCKETS;
+
+	for (count = P_SHM_HASH_TABLE_MIN_BUCKETS; count < buckets; count <<= 1)
+		;
+
+	arena_offset = pp_shm_hash_table_align (sizeof (PShmHashTableHeader) + count * sizeof (pint));
+
+	/* Arena must hold at least the reserved zero unit and a single entry */
+	if (P_UNLIKELY (size < arena_offset + P_SHM_HASH_TABLE_UNIT + sizeof (PShmHashTableEntry)))
+		return FALSE;
+
+	arena_units = (size - arena_offset) / P_SHM_HASH_TABLE_UNIT;
+
+	if (arena_units > P_SHM_HASH_TABLE_MAX_UNITS)
+		arena_units = P_SHM_HASH_TABLE_MAX_UNITS;
+
+	memset (header, 0, arena_offset);
+
+	header->version      = P_SHM_HASH_TABLE_VERSION;
+	header->bucket_count = (puint32) count;
+	header->arena_offset = (puint32) arena_offset;
+	header->arena_units  = (puint32) arena_units;
+
+	p_atomic_int_set (&header->arena_used, 1);
+	p_atomic_int_set (&header->count, 0);
+
+	/* Publish the table only after it has been completely initialized */
+	p_atomic_int_set (&header->magic, P_SHM_HASH_TABLE_MAGIC);
+
+	return TRUE;
+}
+
+static pboolean
+pp_shm_hash_table_check_header (const PShmHashTableHeader	*header,
+				psize				size)
+{
+	if (header->version != P_SHM_HASH_TABLE_VERSION)
+		return FALSE;
+
+	if (header->bucket_count == 0 || (header->bucket_count & (header->bucket_count - 1)) != 0)
+		return FALSE;
+
+	if (header->arena_offset < sizeof (PShmHashTableHeader) + header->bucket_count * sizeof (pint))
+		return FALSE;
+
+	return (psize) header->arena_offset + (psize) header->arena_units * P_SHM_HASH_TABLE_UNIT <= size;
+}
+
+static PShmHashTableEntry *
+pp_shm_hash_table_find (const PShmHashTable	*table,
+			pconstpointer		key,
+			psize			key_len,
+			puint32			hash)
+{
+	PShmHashTableEntry	*entry;
+	pint			offset;
+
+	offset = p_atomic_int_get (&table->buckets[hash & (table->header->bucket_count - 1)]);
+
+	while (offset > 0 && (puint32) offset < table->header->arena_units) {
+		entry = (PShmHashTableEntry *) (table->arena + (psize) offset * P_SHM_HASH_TABLE_UNIT);
+
+		/* Only the newest entry for the key matters */
+		if (entry->hash == hash &&
+		    entry->key_len == (puint32) key_len &&
+		    memcmp (entry + 1, key, key_len) == 0)
+			return entry->tombstone == 0 ? entry : NULL;
+
+		offset = entry->next;
+	}
+
+	return NULL;
+}
+
+/* Must be called with the segment lock held */
+static pboolean
+pp_shm_hash_table_append (PShmHashTable	*table,
+			  pconstpointer	key,
+			  psize		key_len,
+			  puint32	hash,
+			  pconstpointer	value,
+			  psize		value_len,
+			  pboolean	tombstone,
+			  PError	**error)
+{
+	PShmHashTableEntry	*entry;
+	volatile pint		*bucket;
+	psize			units;
+	pint			used;
+
+	units = pp_shm_hash_table_align (sizeof (PShmHashTableEntry) +
+					 pp_shm_hash_table_align (key_len) +
+					 value_len) / P_SHM_HASH_TABLE_UNIT;
+	used  = p_atomic_int_get (&table->header->arena_used);
+
+	if (P_UNLIKELY (units > (psize) (table->header->arena_units - (puint32) used))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NO_RESOURCES,
+				     0,
+				     "Not enough free space in shared memory hash table");
+		return FALSE;
+	}
+
+	bucket = &table->buckets[hash & (table->header->bucket_count - 1)];
+	entry  = (PShmHashTableEntry *) (table->arena + (psize) used * P_SHM_HASH_TABLE_UNIT);
+
+	entry->next      = p_atomic_int_get (bucket);
+	entry->tombstone = tombstone ? 1 : 0;
+	entry->hash      = hash;
+	entry->key_len   = (puint32) key_len;
+	entry->value_len = (puint32) value_len;
+	entry->reserved  = 0;
+
+	memcpy (entry + 1, key, key_len);
+
+	if (value_len > 0)
+		memcpy ((puchar *) (entry + 1) + pp_shm_hash_table_align (key_len), value, value_len);
+
+	p_atomic_int_set (&table->header->arena_used, used + (pint) units);
+
+	/* Older entries are never touched: a reader which has loaded the previous
+	 * bucket head still finds the old entry, while the new one shadows it for
+	 * all the readers starting after the publishing */
+	p_atomic_int_set (bucket, used);
+
+	return TRUE;
+}
+
+P_LIB_API PShmHashTable *
+p_shm_hash_table_new (const pchar	*name,
+		      psize		size,
+		      psize		buckets,
+		      PShmAccessPerms	perms,
+		      PError		**error)
+{
+	PShmHashTable		*ret;
+	PShmHashTableHeader	*header;
+	PShm			*shm;
+	psize			shm_size;
+	pboolean		inited;
+
+	if (P_UNLIKELY (name == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((shm = p_shm_new (name, size, perms, error)) == NULL))
+		return NULL;
+
+	shm_size = p_shm_get_size (shm);
+	header   = (PShmHashTableHeader *) p_shm_get_address (shm);
+
+	if (P_UNLIKELY (shm_size < sizeof (PShmHashTableHeader))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Too small memory segment to hold required data");
+		p_shm_free (shm);
+		return NULL;
+	}
+
+	if (p_atomic_int_get (&header->magic) != P_SHM_HASH_TABLE_MAGIC) {
+		if (P_UNLIKELY (perms == P_SHM_ACCESS_READONLY)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IPC_NOT_EXISTS,
+					     0,
+					     "Shared memory hash table is not initialized");
+			p_shm_free (shm);
+			return NULL;
+		}
+
+		if (P_UNLIKELY (p_shm_lock (shm, error) == FALSE)) {
+			p_shm_free (shm);
+			return NULL;
+		}
+
+		inited = TRUE;
+
+		if (p_atomic_int_get (&header->magic) != P_SHM_HASH_TABLE_MAGIC)
+			inited = pp_shm_hash_table_init_header (header, shm_size, buckets);
+
+		if (P_UNLIKELY (p_shm_unlock (shm, error) == FALSE)) {
+			p_shm_free (shm);
+			return NULL;
+		}
+
+		if (P_UNLIKELY (inited == FALSE)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+					     0,
+					     "Too small memory segment to hold required data");
+			p_shm_free (shm);
+			return NULL;
+		}
+	}
+
+	if (P_UNLIKELY (pp_shm_hash_table_check_header (header, shm_size) == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Memory segment doesn't contain a valid hash table");
+		p_shm_free (shm);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PShmHashTable))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for shared hash table");
+		p_shm_free (shm);
+		return NULL;
+	}
+
+	ret->shm     = shm;
+	ret->header  = header;
+	ret->buckets = (volatile pint *) (header + 1);
+	ret->arena   = (puchar *) header + header->arena_offset;
+	ret->perms   = perms;
+
+	return ret;
+}
+
+P_LIB_API void
+p_shm_hash_table_free (PShmHashTable *table)
+{
+	if (P_UNLIKELY (table == NULL))
+		return;
+
+	p_shm_free (table->shm);
+	p_free (table);
+}
+
+P_LIB_API void
+p_shm_hash_table_take_ownership (PShmHashTable *table)
+{
+	if (P_UNLIKELY (table == NULL))
+		return;
+
+	p_shm_take_ownership (table->shm);
+}
+
+P_LIB_API pboolean
+p_shm_hash_table_insert (PShmHashTable	*table,
+			 pconstpointer	key,
+			 psize		key_len,
+			 pconstpointer	value,
+			 psize		value_len,
+			 PError		**error)
+{
+	pboolean	existed;
+	pboolean	ret;
+	puint32		hash;
+
+	if (P_UNLIKELY (table == NULL || key == NULL || (value == NULL && value_len > 0) ||
+			key_len > (psize) P_MAXINT32 || value_len > (psize) P_MAXINT32)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (table->perms == P_SHM_ACCESS_READONLY)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_ACCESS,
+				     0,
+				     "Shared memory hash table is opened in read-only mode");
+		return FALSE;
+	}
+
+	hash = pp_shm_hash_table_hash (key, key_len);
+
+	if (P_UNLIKELY (p_shm_lock (table->shm, error) == FALSE))
+		return FALSE;
+
+	existed = pp_shm_hash_table_find (table, key, key_len, hash) != NULL;
+	ret     = pp_shm_hash_table_append (table, key, key_len, hash, value, value_len, FALSE, error);
+
+	if (ret == TRUE && existed == FALSE)
+		p_atomic_int_inc (&table->header->count);
+
+	if (P_UNLIKELY (p_shm_unlock (table->shm, ret ? error : NULL) == FALSE)) {
+		if (ret == FALSE)
+			P_WARNING ("PShmHashTable::p_shm_hash_table_insert: p_shm_unlock() failed");
+
+		return FALSE;
+	}
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_shm_hash_table_remove (PShmHashTable	*table,
+			 pconstpointer	key,
+			 psize		key_len,
+			 PError		**error)
+{
+	pboolean	found;
+	pboolean	ret;
+	puint32		hash;
+
+	if (P_UNLIKELY (table == NULL || key == NULL || key_len > (psize) P_MAXINT32)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (table->perms == P_SHM_ACCESS_READONLY)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_ACCESS,
+				     0,
+				     "Shared memory hash table is opened in read-only mode");
+		return FALSE;
+	}
+
+	hash = pp_shm_hash_table_hash (key, key_len);
+
+	if (P_UNLIKELY (p_shm_lock (table->shm, error) == FALSE))
+		return FALSE;
+
+	found = pp_shm_hash_table_find (table, key, key_len, hash) != NULL;
+	ret   = TRUE;
+
+	/* Removed key is shadowed with a tombstone entry */
+	if (found == TRUE &&
+	    (ret = pp_shm_hash_table_append (table, key, key_len, hash, NULL, 0, TRUE, error)) == TRUE)
+		(void) p_atomic_int_dec_and_test (&table->header->count);
+
+	if (P_UNLIKELY (p_shm_unlock (table->shm, ret ? error : NULL) == FALSE)) {
+		if (ret == FALSE)
+			P_WARNING ("PShmHashTable::p_shm_hash_table_remove: p_shm_unlock() failed");
+
+		return FALSE;
+	}
+
+	return found && ret;
+}
+
+P_LIB_API pboolean
+p_shm_hash_table_lookup (const PShmHashTable	*table,
+			 pconstpointer		key,
+			 psize			key_len,
+			 pconstpointer		*value,
+			 psize			*value_len)
+{
+	PShmHashTableEntry *entry;
+
+	if (P_UNLIKELY (table == NULL || key == NULL))
+		return FALSE;
+
+	if ((entry = pp_shm_hash_table_find (table,
+					     key,
+					     key_len,
+					     pp_shm_hash_table_hash (key, key_len))) == NULL)
+		return FALSE;
+
+	if (value != NULL)
+		*value = (const puchar *) (entry + 1) + pp_shm_hash_table_align (entry->key_len);
+
+	if (value_len != NULL)
+		*value_len = entry->value_len;
+
+	return TRUE;
+}
+
+P_LIB_API psize
+p_shm_hash_table_get_count (const PShmHashTable *table)
+{
+	if (P_UNLIKELY (table == NULL))
+		return 0;
+
+	return (psize) p_atomic_int_get (&table->header->count);
+}
+
+P_LIB_API psize
+p_shm_hash_table_get_free_space (const PShmHashTable *table)
+{
+	if (P_UNLIKELY (table == NULL))
+		return 0;
+
+	return (psize) (table->header->arena_units - (puint32) p_atomic_int_get (&table->header->arena_used)) *
+	       P_SHM_HASH_TABLE_UNIT;
+}
@@ -0,0 +1,196 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pshmhashtable.h
+ * @brief Shared memory hash table
+ * @author Alexander Saprykin
+ *
+ * A shared memory hash table keeps both its index and all the keys and values
+ * inside a single shared memory segment (see #PShm), so a table built by one
+ * process is instantly available to all the other processes which attach to
+ * the segment by its name, without loading or copying anything.
+ *
+ * Keys and values are arbitrary byte sequences which are copied into the
+ * segment on insertion. All the references inside the segment are stored as
+ * offsets, thus the segment can be mapped at any address in every process.
+ *
+ * The table is designed for read-mostly workloads: any number of readers
+ * performs lookups without any locking, while writers are serialized with the
+ * #PShm lock. A reader never observes a partially written entry: an entry is
+ * published only after it has been completely written.
+ *
+ * Storage is append-only and is never compacted: replacing a key appends a
+ * new entry which shadows the old one, removing a key appends a small tombstone
+ * entry. The space of the shadowed entries is never reclaimed while the segment
+ * exists. This keeps the lookups lock-free and the looked up values valid, but
+ * the segment should be sized for all the insertions, replacements and
+ * removals made during its lifetime. Use p_shm_hash_table_get_free_space() to
+ * check the remaining space, and recreate the table to reclaim it.
+ *
+ * Use p_shm_hash_table_new() to create or attach to the table and
+ * p_shm_hash_table_free() to detach from it. Take ownership with
+ * p_shm_hash_table_take_ownership() to remove the segment from the system
+ * after detaching, please refer to the #PShm description for details.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSHMHASHTABLE_H
+#define PLIBSYS_HEADER_PSHMHASHTABLE_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+#include <perror.h>
+#include <pshm.h>
+
+P_BEGIN_DECLS
+
+/** Shared memory hash table opaque data structure. */
+typedef struct PShmHashTable_ PShmHashTable;
+
+/**
+ * @brief Creates a new #PShmHashTable or attaches to an existing one.
+ * @param name Shared memory hash table name.
+ * @param size Size of the memory segment in bytes, pass 0 to attach to an
+ * already existing table.
+ * @param buckets Number of hash buckets, it is rounded up to the power of two
+ * and is used only when the table is created, pass 0 to pick it by the segment
+ * size.
+ * @param perms Memory segment permissions, a read-only table can only be
+ * looked up.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to a newly created #PShmHashTable object in case of success,
+ * NULL otherwise.
+ * @since 0.0.6
+ *
+ * The first read-write user of the segment initializes the table. Read-only
+ * users fail to attach to a segment which has not been initialized yet.
+ */
+P_LIB_API PShmHashTable *	p_shm_hash_table_new		(const pchar		*name,
+								 psize			size,
+								 psize			buckets,
+								 PShmAccessPerms	perms,
+								 PError			**error);
+
+/**
+ * @brief Frees #PShmHashTable object.
+ * @param table #PShmHashTable to free.
+ * @since 0.0.6
+ *
+ * It doesn't remove the table from the system unless the ownership has been
+ * taken with p_shm_hash_table_take_ownership().
+ */
+P_LIB_API void			p_shm_hash_table_free		(PShmHashTable		*table);
+
+/**
+ * @brief Takes ownership of a shared memory hash table.
+ * @param table #PShmHashTable to take ownership of.
+ * @since 0.0.6
+ */
+P_LIB_API void			p_shm_hash_table_take_ownership	(PShmHashTable		*table);
+
+/**
+ * @brief Inserts a new key-value pair into a #PShmHashTable.
+ * @param table #PShmHashTable to insert into.
+ * @param key Key to insert.
+ * @param key_len Length of the @a key in bytes.
+ * @param value Value to insert, may be NULL if @a value_len is 0.
+ * @param value_len Length of the @a value in bytes.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * If the key already exists, its value is replaced. Concurrent readers see
+ * either the old or the new value, but never a missing key.
+ */
+P_LIB_API pboolean		p_shm_hash_table_insert		(PShmHashTable		*table,
+								 pconstpointer		key,
+								 psize			key_len,
+								 pconstpointer		value,
+								 psize			value_len,
+								 PError			**error);
+
+/**
+ * @brief Removes a key from a #PShmHashTable.
+ * @param table #PShmHashTable to remove the key from.
+ * @param key Key to remove.
+ * @param key_len Length of the @a key in bytes.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE if the key has been removed, FALSE if it has not been found or
+ * in case of error.
+ * @since 0.0.6
+ *
+ * Removal appends a tombstone entry with the key, so it consumes the segment
+ * space as well and fails with #P_ERROR_IPC_NO_RESOURCES when the segment is
+ * full. Concurrent readers see either the old value or a missing key.
+ */
+P_LIB_API pboolean		p_shm_hash_table_remove		(PShmHashTable		*table,
+								 pconstpointer		key,
+								 psize			key_len,
+								 PError			**error);
+
+/**
+ * @brief Looks up a value by its key without copying it.
+ * @param table #PShmHashTable to look up in.
+ * @param key Key to look up.
+ * @param key_len Length of the @a key in bytes.
+ * @param[out] value Pointer to the value inside the segment, may be NULL.
+ * @param[out] value_len Length of the value in bytes, may be NULL.
+ * @return TRUE if the key has been found, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * This call never blocks. The returned pointer stays valid while the @a table
+ * is attached, even if the key is replaced or removed later.
+ */
+P_LIB_API pboolean		p_shm_hash_table_lookup		(const PShmHashTable	*table,
+								 pconstpointer		key,
+								 psize			key_len,
+								 pconstpointer		*value,
+								 psize			*value_len);
+
+/**
+ * @brief Gets the number of keys in a #PShmHashTable.
+ * @param table #PShmHashTable to get the number of keys for.
+ * @return Number of keys in the @a table.
+ * @since 0.0.6
+ */
+P_LIB_API psize			p_shm_hash_table_get_count	(const PShmHashTable	*table);
+
+/**
+ * @brief Gets the remaining space for new entries in a #PShmHashTable.
+ * @param table #PShmHashTable to get the free space for.
+ * @return Free space in bytes.
+ * @since 0.0.6
+ *
+ * Every entry takes its key and value lengths plus a small fixed overhead.
+ */
+P_LIB_API psize			p_shm_hash_table_get_free_space	(const PShmHashTable	*table);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSHMHASHTABLE_H */
@@ -0,0 +1,691 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "patomic.h"
+#include "pmem.h"
+#include "pshm.h"
+#include "pshmqueue.h"
+#include "pshmsync.h"
+#include "ptimeprofiler.h"
+#include "puthread.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define P_SHM_QUEUE_MAGIC		0x50534851
+#define P_SHM_QUEUE_VERSION		1
+#define P_SHM_QUEUE_CACHE_LINE		64
+#define P_SHM_QUEUE_SLOT_ALIGN		8
+#define P_SHM_QUEUE_MAX_CAPACITY	0x10000000
+#define P_SHM_QUEUE_MAX_MESSAGE_SIZE	0x7FFFFF00
+#define P_SHM_QUEUE_WAIT_SLICE		100
+#define P_SHM_QUEUE_POLL_INTERVAL	1
+
+/* All the fields are of a fixed size to keep the layout the same for
+ * processes built with different compilers, positions are kept on separate
+ * cache lines to avoid false sharing between producers and consumers */
+typedef struct PShmQueueHeader_ {
+	volatile pint	magic;
+	puint32		version;
+	puint32		capacity;
+	puint32		max_message_size;
+	puint32		slot_size;
+	puint32		slots_offset;
+	puint32		mutex_offset;
+	puint32		mutex_size;
+	puint32		cond_offset;
+	puint32		cond_size;
+	volatile pint	waiters;
+	puchar		pad1[P_SHM_QUEUE_CACHE_LINE - 11 * sizeof (pint)];
+	volatile pint	enqueue_pos;
+	puchar		pad2[P_SHM_QUEUE_CACHE_LINE - sizeof (pint)];
+	volatile pint	dequeue_pos;
+	puchar		pad3[P_SHM_QUEUE_CACHE_LINE - sizeof (pint)];
+} PShmQueueHeader;
+
+/* Sequence equals to the position for a free slot and to the position plus
+ * one for a published message, message data follows the slot header */
+typedef struct PShmQueueSlot_ {
+	volatile pint	sequence;
+	puint32		length;
+} PShmQueueSlot;
+
+struct PShmQueue_ {
+	PShm			*shm;
+	PShmQueueHeader		*header;
+	puchar			*slots;
+	PShmMutex		*mutex;
+	PShmCondVariable	*cond;
+	psize			slot_size;
+	puint32			mask;
+};
+
+static psize pp_shm_queue_align (psize size, psize align);
+static pint pp_shm_queue_pos_add (pint pos, puint32 value);
+static pint pp_shm_queue_pos_diff (pint a, pint b);
+static pboolean pp_shm_queue_get_layout (psize capacity, psize max_message_size, PShmQueueHeader *header);
+static pboolean pp_shm_queue_init_header (PShmQueueHeader *header, const PShmQueueHeader *layout, PError **error);
+static pboolean pp_shm_queue_check_header (const PShmQueueHeader *header,
+					   psize size,
+					   psize capacity,
+					   psize max_message_size);
+static PShmQueueSlot * pp_shm_queue_get_slot (const PShmQueue *queue, pint pos);
+static pboolean pp_shm_queue_has_message (const PShmQueue *queue);
+static pboolean pp_shm_queue_lock (PShmQueue *queue);
+static void pp_shm_queue_notify (PShmQueue *queue);
+static void pp_shm_queue_wait (PShmQueue *queue, pint timeout);
+static pint pp_shm_queue_try_dequeue (PShmQueue *queue, puchar *buf, psize len, psize *lengths, pint max_messages, PError **error);
+static pint pp_shm_queue_dequeue (PShmQueue *queue,
+				  ppointer buf,
+				  psize len,
+				  psize *lengths,
+				  pint max_messages,
+				  pint timeout,
+				  PError **error);
+
+static psize
+pp_shm_queue_align (psize	size,
+		    psize	align)
+{
+	return (size + align - 1) / align * align;
+}
+
+static pint
+pp_shm_queue_pos_add (pint	pos,
+		      puint32	value)
+{
+	/* Positions wrap around, avoid signed overflow */
+	return (pint) ((puint32) pos + value);
+}
+
+static pint
+pp_shm_queue_pos_diff (pint	a,
+		       pint	b)
+{
+	return (pint) ((puint32) a - (puint32) b);
+}
+
+static pboolean
+pp_shm_queue_get_layout (psize			capacity,
+			 psize			max_message_size,
+			 PShmQueueHeader	*header)
+{
+	psize	count;
+	psize	slot_size;
+	psize	mutex_size;
+	psize	cond_size;
+	psize	offset;
+
+	if (capacity > P_SHM_QUEUE_MAX_CAPACITY || max_message_size > P_SHM_QUEUE_MAX_MESSAGE_SIZE)
+		return FALSE;
+
+	for (count = 1; count < capacity; count <<= 1)
+		;
+
+	slot_size  = pp_shm_queue_align (sizeof (PShmQueueSlot) + max_message_size, P_SHM_QUEUE_SLOT_ALIGN);
+	mutex_size = p_shm_mutex_get_size ();
+	cond_size  = p_shm_cond_variable_get_size ();
+
+	/* Blocking needs both of the objects, otherwise the queue is polled */
+	if (mutex_size == 0 || cond_size == 0)
+		mutex_size = cond_size = 0;
+
+	memset (header, 0, sizeof (PShmQueueHeader));
+
+	offset = sizeof (PShmQueueHeader);
+
+	header->mutex_offset = (puint32) offset;
+	header->mutex_size   = (puint32) mutex_size;
+
+	offset += pp_shm_queue_align (mutex_size, P_SHM_QUEUE_CACHE_LINE);
+
+	header->cond_offset = (puint32) offset;
+	header->cond_size   = (puint32) cond_size;
+
+	offset += pp_shm_queue_align (cond_size, P_SHM_QUEUE_CACHE_LINE);
+
+	if (slot_size > (P_MAXSIZE - offset) / count)
+		return FALSE;
+
+	header->version          = P_SHM_QUEUE_VERSION;
+	header->capacity         = (puint32) count;
+	header->max_message_size = (puint32) max_message_size;
+	header->slot_size        = (puint32) slot_size;
+	header->slots_offset     = (puint32) offset;
+
+	return TRUE;
+}
+
+static pboolean
+pp_shm_queue_init_header (PShmQueueHeader		*header,
+			  const PShmQueueHeader		*layout,
+			  PError			**error)
+{
+	PShmQueueSlot	*slot;
+	puchar		*base;
+	puint32		i;
+
+	base = (puchar *) header;
+
+	memcpy (header, layout, sizeof (PShmQueueHeader));
+	memset (base + sizeof (PShmQueueHeader), 0, layout->slots_offset - sizeof (PShmQueueHeader));
+
+	if (layout->mutex_size > 0) {
+		if (P_UNLIKELY (p_shm_mutex_init (base + layout->mutex_offset,
+						  layout->mutex_size,
+						  error) == NULL))
+			return FALSE;
+
+		if (P_UNLIKELY (p_shm_cond_variable_init (base + layout->cond_offset,
+							  layout->cond_size,
+							  error) == NULL)) {
+			p_shm_mutex_destroy ((PShmMutex *) (base + layout->mutex_offset));
+			return FALSE;
+		}
+	}
+
+	for (i = 0; i < layout->capacity; ++i) {
+		slot = (PShmQueueSlot *) (base + layout->slots_offset + (psize) i * layout->slot_size);
+
+		slot->length = 0;
+		p_atomic_int_set (&slot->sequence, (pint) i);
+	}
+
+	p_atomic_int_set (&header->waiters, 0);
+	p_atomic_int_set (&header->enqueue_pos, 0);
+	p_atomic_int_set (&header->dequeue_pos, 0);
+
+	/* Publish the queue only after it has been completely initialized */
+	p_atomic_int_set (&header->magic, P_SHM_QUEUE_MAGIC);
+
+	return TRUE;
+}
+
+static pboolean
+pp_shm_queue_check_header (const PShmQueueHeader	*header,
+			   psize			size,
+			   psize			capacity,
+			   psize			max_message_size)
+{
+	psize count;
+
+	if (header->version != P_SHM_QUEUE_VERSION)
+		return FALSE;
+
+	if (header->capacity == 0 || (header->capacity & (header->capacity - 1)) != 0)
+		return FALSE;
+
+	if (header->slot_size < sizeof (PShmQueueSlot) + header->max_message_size)
+		return FALSE;
+
+	if (header->slots_offset < sizeof (PShmQueueHeader))
+		return FALSE;
+
+	if ((psize) header->slot_size > (size - header->slots_offset) / header->capacity)
+		return FALSE;
+
+	if (capacity == 0)
+		return TRUE;
+
+	for (count = 1; count < capacity; count <<= 1)
+		;
+
+	return header->capacity == (puint32) count && header->max_message_size == (puint32) max_message_size;
+}
+
+static PShmQueueSlot *
+pp_shm_queue_get_slot (const PShmQueue	*queue,
+		       pint		pos)
+{
+	return (PShmQueueSlot *) (queue->slots + (psize) ((puint32) pos & queue->mask) * queue->slot_size);
+}
+
+static pboolean
+pp_shm_queue_has_message (const PShmQueue *queue)
+{
+	PShmQueueSlot	*slot;
+	pint		pos;
+
+	pos  = p_atomic_int_get (&queue->header->dequeue_pos);
+	slot = pp_shm_queue_get_slot (queue, pos);
+
+	return pp_shm_queue_pos_diff (p_atomic_int_get (&slot->sequence), pp_shm_queue_pos_add (pos, 1)) >= 0;
+}
+
+static pboolean
+pp_shm_queue_lock (PShmQueue *queue)
+{
+	PShmSyncStatus status;
+
+	status = p_shm_mutex_lock (queue->mutex, NULL);
+
+	/* The mutex guards no data, so a dead owner leaves nothing to repair */
+	if (status == P_SHM_SYNC_STATUS_OWNER_DIED)
+		p_shm_mutex_make_consistent (queue->mutex, NULL);
+
+	return status != P_SHM_SYNC_STATUS_ERROR;
+}
+
+static void
+pp_shm_queue_notify (PShmQueue *queue)
+{
+	/* Pairs with the waiters increment before the last emptiness check in
+	 * pp_shm_queue_wait(): either the waiter sees the message or we see it */
+	if (queue->mutex == NULL || p_atomic_int_get (&queue->header->waiters) == 0)
+		return;
+
+	if (P_UNLIKELY (pp_shm_queue_lock (queue) == FALSE))
+		return;
+
+	p_shm_cond_variable_broadcast (queue->cond, NULL);
+	p_shm_mutex_unlock (queue->mutex, NULL);
+}
+
+static void
+pp_shm_queue_wait (PShmQueue	*queue,
+		   pint		timeout)
+{
+	PShmSyncStatus status;
+
+	if (queue->mutex == NULL || pp_shm_queue_lock (queue) == FALSE) {
+		p_uthread_sleep (P_SHM_QUEUE_POLL_INTERVAL);
+		return;
+	}
+
+	p_atomic_int_inc (&queue->header->waiters);
+
+	if (!pp_shm_queue_has_message (queue)) {
+		status = p_shm_cond_variable_timed_wait (queue->cond, queue->mutex, timeout, NULL);
+
+		if (status == P_SHM_SYNC_STATUS_OWNER_DIED)
+			p_shm_mutex_make_consistent (queue->mutex, NULL);
+	}
+
+	p_atomic_int_add (&queue->header->waiters, -1);
+	p_shm_mutex_unlock (queue->mutex, NULL);
+}
+
+static pint
+pp_shm_queue_try_dequeue (PShmQueue	*queue,
+			  puchar	*buf,
+			  psize		len,
+			  psize		*lengths,
+			  pint		max_messages,
+			  PError	**error)
+{
+	PShmQueueSlot	*slot;
+	psize		total;
+	psize		offset;
+	pint		pos;
+	pint		diff;
+	pint		count;
+	pint		i;
+
+	pos = p_atomic_int_get (&queue->header->dequeue_pos);
+
+	for (;;) {
+		total = 0;
+
+		/* Lengths are read before the slots are claimed, a successful claim
+		 * proves that no one has consumed and reused the slots meanwhile */
+		for (count = 0; count < max_messages; ++count) {
+			slot = pp_shm_queue_get_slot (queue, pp_shm_queue_pos_add (pos, (puint32) count));
+			diff = pp_shm_queue_pos_diff (p_atomic_int_get (&slot->sequence),
+						      pp_shm_queue_pos_add (pos, (puint32) count + 1));
+
+			if (diff != 0 || slot->length > len - total)
+				break;
+
+			total += slot->length;
+		}
+
+		if (count == 0) {
+			slot = pp_shm_queue_get_slot (queue, pos);
+			diff = pp_shm_queue_pos_diff (p_atomic_int_get (&slot->sequence),
+						      pp_shm_queue_pos_add (pos, 1));
+
+			if (diff < 0)
+				return 0;
+
+			if (diff == 0 && p_atomic_int_get (&queue->header->dequeue_pos) == pos) {
+				p_error_set_error_p (error,
+						     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+						     0,
+						     "Too small buffer to hold the message");
+				return -1;
+			}
+		} else if (p_atomic_int_compare_and_exchange (&queue->header->dequeue_pos,
+							       pos,
+							       pp_shm_queue_pos_add (pos, (puint32) count)) == TRUE)
+			break;
+
+		pos = p_atomic_int_get (&queue->header->dequeue_pos);
+	}
+
+	for (i = 0, offset = 0; i < count; ++i) {
+		slot = pp_shm_queue_get_slot (queue, pp_shm_queue_pos_add (pos, (puint32) i));
+
+		memcpy (buf + offset, slot + 1, slot->length);
+		lengths[i] = slot->length;
+		offset    += slot->length;
+
+		/* Hand the slot over to the producers of the next lap */
+		p_atomic_int_set (&slot->sequence, pp_shm_queue_pos_add (pos, (puint32) i + queue->mask + 1));
+	}
+
+	return count;
+}
+
+static pint
+pp_shm_queue_dequeue (PShmQueue	*queue,
+		      ppointer	buf,
+		      psize	len,
+		      psize	*lengths,
+		      pint	max_messages,
+		      pint	timeout,
+		      PError	**error)
+{
+	puint64	start;
+	puint64	elapsed;
+	pint	slice;
+	pint	ret;
+
+	start = timeout > 0 ? p_time_profiler_ticks () : 0;
+
+	for (;;) {
+		ret = pp_shm_queue_try_dequeue (queue, (puchar *) buf, len, lengths, max_messages, error);
+
+		if (ret != 0 || timeout == 0)
+			return ret;
+
+		slice = P_SHM_QUEUE_WAIT_SLICE;
+
+		if (timeout > 0) {
+			elapsed = p_time_profiler_ticks_to_nsecs (p_time_profiler_ticks () - start) / 1000000;
+
+			if (elapsed >= (puint64) timeout)
+				return 0;
+
+			if ((puint64) timeout - elapsed < (puint64) slice)
+				slice = (pint) ((puint64) timeout - elapsed);
+		}
+
+		/* Waits are sliced to survive a producer which died between
+		 * publishing a message and waking up the consumers */
+		pp_shm_queue_wait (queue, slice);
+	}
+}
+
+P_LIB_API PShmQueue *
+p_shm_queue_new (const pchar	*name,
+		 psize		capacity,
+		 psize		max_message_size,
+		 PError		**error)
+{
+	PShmQueue		*ret;
+	PShmQueueHeader		*header;
+	PShmQueueHeader		layout;
+	PShm			*shm;
+	psize			shm_size;
+	pboolean		inited;
+
+	if (P_UNLIKELY (name == NULL || (capacity == 0) != (max_message_size == 0))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	shm_size = 0;
+
+	if (capacity > 0) {
+		if (P_UNLIKELY (pp_shm_queue_get_layout (capacity, max_message_size, &layout) == FALSE)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+					     0,
+					     "Too large queue capacity or message size");
+			return NULL;
+		}
+
+		shm_size = layout.slots_offset + (psize) layout.capacity * layout.slot_size;
+	}
+
+	if (P_UNLIKELY ((shm = p_shm_new (name, shm_size, P_SHM_ACCESS_READWRITE, error)) == NULL))
+		return NULL;
+
+	shm_size = p_shm_get_size (shm);
+	header   = (PShmQueueHeader *) p_shm_get_address (shm);
+
+	if (P_UNLIKELY (shm_size < sizeof (PShmQueueHeader))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Too small memory segment to hold required data");
+		p_shm_free (shm);
+		return NULL;
+	}
+
+	if (p_atomic_int_get (&header->magic) != P_SHM_QUEUE_MAGIC) {
+		if (P_UNLIKELY (capacity == 0)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IPC_NOT_EXISTS,
+					     0,
+					     "Shared memory queue is not initialized");
+			p_shm_free (shm);
+			return NULL;
+		}
+
+		if (P_UNLIKELY (p_shm_lock (shm, error) == FALSE)) {
+			p_shm_free (shm);
+			return NULL;
+		}
+
+		inited = TRUE;
+
+		if (p_atomic_int_get (&header->magic) != P_SHM_QUEUE_MAGIC) {
+			if (P_UNLIKELY (shm_size < layout.slots_offset + (psize) layout.capacity * layout.slot_size)) {
+				p_error_set_error_p (error,
+						     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+						     0,
+						     "Too small memory segment to hold required data");
+				inited = FALSE;
+			} else
+				inited = pp_shm_queue_init_header (header, &layout, error);
+		}
+
+		if (P_UNLIKELY (p_shm_unlock (shm, inited ? error : NULL) == FALSE)) {
+			p_shm_free (shm);
+			return NULL;
+		}
+
+		if (P_UNLIKELY (inited == FALSE)) {
+			p_shm_free (shm);
+			return NULL;
+		}
+	}
+
+	if (P_UNLIKELY (pp_shm_queue_check_header (header, shm_size, capacity, max_message_size) == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Memory segment doesn't contain a compatible queue");
+		p_shm_free (shm);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PShmQueue))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for shared queue");
+		p_shm_free (shm);
+		return NULL;
+	}
+
+	ret->shm       = shm;
+	ret->header    = header;
+	ret->slots     = (puchar *) header + header->slots_offset;
+	ret->slot_size = header->slot_size;
+	ret->mask      = header->capacity - 1;
+
+	/* Objects created by an incompatible build can't be used, poll instead */
+	if (header->mutex_size > 0 &&
+	    header->mutex_size == (puint32) p_shm_mutex_get_size () &&
+	    header->cond_size == (puint32) p_shm_cond_variable_get_size ()) {
+		ret->mutex = (PShmMutex *) ((puchar *) header + header->mutex_offset);
+		ret->cond  = (PShmCondVariable *) ((puchar *) header + header->cond_offset);
+	}
+
+	return ret;
+}
+
+P_LIB_API void
+p_shm_queue_free (PShmQueue *queue)
+{
+	if (P_UNLIKELY (queue == NULL))
+		return;
+
+	p_shm_free (queue->shm);
+	p_free (queue);
+}
+
+P_LIB_API void
+p_shm_queue_take_ownership (PShmQueue *queue)
+{
+	if (P_UNLIKELY (queue == NULL))
+		return;
+
+	p_shm_take_ownership (queue->shm);
+}
+
+P_LIB_API pssize
+p_shm_queue_enqueue (PShmQueue		*queue,
+		     pconstpointer	data,
+		     psize		len,
+		     PError		**error)
+{
+	PShmQueueSlot	*slot;
+	pint		pos;
+	pint		diff;
+
+	if (P_UNLIKELY (queue == NULL || data == NULL || len == 0 ||
+			len > queue->header->max_message_size)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	pos = p_atomic_int_get (&queue->header->enqueue_pos);
+
+	for (;;) {
+		slot = pp_shm_queue_get_slot (queue, pos);
+		diff = pp_shm_queue_pos_diff (p_atomic_int_get (&slot->sequence), pos);
+
+		if (diff == 0) {
+			if (p_atomic_int_compare_and_exchange (&queue->header->enqueue_pos,
+							       pos,
+							       pp_shm_queue_pos_add (pos, 1)) == TRUE)
+				break;
+		} else if (diff < 0)
+			return 0;
+
+		pos = p_atomic_int_get (&queue->header->enqueue_pos);
+	}
+
+	memcpy (slot + 1, data, len);
+	slot->length = (puint32) len;
+
+	/* Publish the message for the consumers */
+	p_atomic_int_set (&slot->sequence, pp_shm_queue_pos_add (pos, 1));
+
+	pp_shm_queue_notify (queue);
+
+	return (pssize) len;
+}
+
+P_LIB_API pssize
+p_shm_queue_dequeue (PShmQueue	*queue,
+		     ppointer	buf,
+		     psize	len,
+		     pint	timeout,
+		     PError	**error)
+{
+	psize	length;
+	pint	ret;
+
+	if (P_UNLIKELY (queue == NULL || buf == NULL || len == 0 || timeout < -1)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	ret = pp_shm_queue_dequeue (queue, buf, len, &length, 1, timeout, error);
+
+	return ret > 0 ? (pssize) length : (pssize) ret;
+}
+
+P_LIB_API pint
+p_shm_queue_dequeue_batch (PShmQueue	*queue,
+			   ppointer	buf,
+			   psize	len,
+			   psize	*lengths,
+			   pint		max_messages,
+			   pint		timeout,
+			   PError	**error)
+{
+	if (P_UNLIKELY (queue == NULL || buf == NULL || len == 0 || lengths == NULL ||
+			max_messages <= 0 || timeout < -1)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	return pp_shm_queue_dequeue (queue, buf, len, lengths, max_messages, timeout, error);
+}
+
+P_LIB_API psize
+p_shm_queue_get_max_message_size (const PShmQueue *queue)
+{
+	if (P_UNLIKELY (queue == NULL))
+		return 0;
+
+	return queue->header->max_message_size;
+}
+
+P_LIB_API psize
+p_shm_queue_get_capacity (const PShmQueue *queue)
+{
+	if (P_UNLIKELY (queue == NULL))
+		return 0;
+
+	return queue->header->capacity;
+}
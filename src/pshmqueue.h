@@ -0,0 +1,193 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pshmqueue.h
+ * @brief Shared memory message queue
+ * @author Alexander Saprykin
+ *
+ * A shared memory message queue passes discrete messages between any number
+ * of producers and consumers, both threads and processes, through a single
+ * shared memory segment (see #PShm). Unlike #PShmBuffer, which is a byte
+ * stream, the queue preserves message boundaries: every dequeue returns
+ * exactly one message as it was enqueued.
+ *
+ * The queue is a bounded ring of fixed size slots. Every slot holds a
+ * length-prefixed message and a sequence number which tells whether the slot
+ * is ready to be written or read, so producers and consumers claim slots
+ * with a single atomic operation and never take a global lock. The number of
+ * slots and the maximum message size are fixed when the queue is created.
+ *
+ * Use p_shm_queue_enqueue() to put a message into the queue, it never blocks
+ * and fails softly when the queue is full. Use p_shm_queue_dequeue() to take a
+ * single message and p_shm_queue_dequeue_batch() to take several messages at
+ * once. Both dequeue calls can wait for a message to arrive: on platforms with
+ * process-shared synchronization primitives (see #PShmMutex) waiting consumers
+ * sleep and are woken up by producers, otherwise the queue is polled.
+ *
+ * Use p_shm_queue_new() to create or attach to the queue and
+ * p_shm_queue_free() to detach from it. Take ownership with
+ * p_shm_queue_take_ownership() to remove the segment from the system after
+ * detaching, please refer to the #PShm description for details.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSHMQUEUE_H
+#define PLIBSYS_HEADER_PSHMQUEUE_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+#include <perror.h>
+
+P_BEGIN_DECLS
+
+/** Shared memory message queue opaque data structure. */
+typedef struct PShmQueue_ PShmQueue;
+
+/**
+ * @brief Creates a new #PShmQueue or attaches to an existing one.
+ * @param name Shared memory queue name.
+ * @param capacity Number of message slots, it is rounded up to the power of
+ * two, pass 0 to attach to an already existing queue.
+ * @param max_message_size Maximum message size in bytes, pass 0 to attach to
+ * an already existing queue.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to a newly created #PShmQueue object in case of success,
+ * NULL otherwise.
+ * @since 0.0.6
+ *
+ * The first user of the segment initializes the queue, the others must pass
+ * either the same parameters or zeros.
+ */
+P_LIB_API PShmQueue *	p_shm_queue_new			(const pchar	*name,
+							 psize		capacity,
+							 psize		max_message_size,
+							 PError		**error);
+
+/**
+ * @brief Frees #PShmQueue object.
+ * @param queue #PShmQueue to free.
+ * @since 0.0.6
+ *
+ * It doesn't remove the queue from the system unless the ownership has been
+ * taken with p_shm_queue_take_ownership().
+ */
+P_LIB_API void		p_shm_queue_free		(PShmQueue	*queue);
+
+/**
+ * @brief Takes ownership of a shared memory queue.
+ * @param queue #PShmQueue to take ownership of.
+ * @since 0.0.6
+ */
+P_LIB_API void		p_shm_queue_take_ownership	(PShmQueue	*queue);
+
+/**
+ * @brief Puts a message into a #PShmQueue.
+ * @param queue #PShmQueue to put the message into.
+ * @param data Message to put.
+ * @param len Length of the @a data in bytes, must be greater than zero and
+ * not greater than the maximum message size.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of written bytes (can be 0 if queue is full), or -1 if error
+ * occurred.
+ * @since 0.0.6
+ */
+P_LIB_API pssize	p_shm_queue_enqueue		(PShmQueue	*queue,
+							 pconstpointer	data,
+							 psize		len,
+							 PError		**error);
+
+/**
+ * @brief Takes a single message from a #PShmQueue.
+ * @param queue #PShmQueue to take the message from.
+ * @param[out] buf Buffer to store the message in.
+ * @param len Length of the @a buf in bytes.
+ * @param timeout Time to wait for a message in milliseconds, 0 to return
+ * immediately or -1 to wait infinitely.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Length of the message (can be 0 if queue is empty after the
+ * @a timeout), or -1 if error occurred.
+ * @since 0.0.6
+ *
+ * If the next message doesn't fit into the @a buf, the call fails and the
+ * message is left in the queue. Use p_shm_queue_get_max_message_size() to
+ * allocate a buffer which always fits.
+ */
+P_LIB_API pssize	p_shm_queue_dequeue		(PShmQueue	*queue,
+							 ppointer	buf,
+							 psize		len,
+							 pint		timeout,
+							 PError		**error);
+
+/**
+ * @brief Takes several messages from a #PShmQueue at once.
+ * @param queue #PShmQueue to take the messages from.
+ * @param[out] buf Buffer to store the messages in.
+ * @param len Length of the @a buf in bytes.
+ * @param[out] lengths Array to store the lengths of the messages in.
+ * @param max_messages Maximum number of messages to take, the @a lengths array
+ * must hold at least that number of elements.
+ * @param timeout Time to wait for the first message in milliseconds, 0 to
+ * return immediately or -1 to wait infinitely.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of taken messages (can be 0 if queue is empty after the
+ * @a timeout), or -1 if error occurred.
+ * @since 0.0.6
+ *
+ * Messages are stored in the @a buf one after another without gaps, in the
+ * order they were taken from the queue. The call takes as many consecutive
+ * messages as are available and fit into the @a buf, claiming all of them
+ * with a single atomic operation.
+ */
+P_LIB_API pint		p_shm_queue_dequeue_batch	(PShmQueue	*queue,
+							 ppointer	buf,
+							 psize		len,
+							 psize		*lengths,
+							 pint		max_messages,
+							 pint		timeout,
+							 PError		**error);
+
+/**
+ * @brief Gets the maximum message size of a #PShmQueue.
+ * @param queue #PShmQueue to get the maximum message size for.
+ * @return Maximum message size in bytes.
+ * @since 0.0.6
+ */
+P_LIB_API psize		p_shm_queue_get_max_message_size (const PShmQueue *queue);
+
+/**
+ * @brief Gets the number of message slots of a #PShmQueue.
+ * @param queue #PShmQueue to get the number of slots for.
+ * @return Number of message slots.
+ * @since 0.0.6
+ */
+P_LIB_API psize		p_shm_queue_get_capacity	(const PShmQueue *queue);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSHMQUEUE_H */
@@ -0,0 +1,211 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "perror.h"
+#include "pshmsync.h"
+
+#include <stdlib.h>
+
+struct PShmMutex_ {
+	pint	hdl;
+};
+
+struct PShmCondVariable_ {
+	pint	hdl;
+};
+
+P_LIB_API psize
+p_shm_mutex_get_size (void)
+{
+	return 0;
+}
+
+P_LIB_API PShmMutex *
+p_shm_mutex_init (ppointer	mem,
+		  psize		size,
+		  PError	**error)
+{
+	P_UNUSED (mem);
+	P_UNUSED (size);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+			     0,
+			     "No process-shared synchronization implementation");
+
+	return NULL;
+}
+
+P_LIB_API PShmSyncStatus
+p_shm_mutex_lock (PShmMutex	*mutex,
+		  PError	**error)
+{
+	P_UNUSED (mutex);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+			     0,
+			     "No process-shared synchronization implementation");
+
+	return P_SHM_SYNC_STATUS_ERROR;
+}
+
+P_LIB_API PShmSyncStatus
+p_shm_mutex_trylock (PShmMutex	*mutex,
+		     PError	**error)
+{
+	P_UNUSED (mutex);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+			     0,
+			     "No process-shared synchronization implementation");
+
+	return P_SHM_SYNC_STATUS_ERROR;
+}
+
+P_LIB_API pboolean
+p_shm_mutex_unlock (PShmMutex	*mutex,
+		    PError	**error)
+{
+	P_UNUSED (mutex);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+			     0,
+			     "No process-shared synchronization implementation");
+
+	return FALSE;
+}
+
+P_LIB_API pboolean
+p_shm_mutex_make_consistent (PShmMutex	*mutex,
+			     PError	**error)
+{
+	P_UNUSED (mutex);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+			     0,
+			     "No process-shared synchronization implementation");
+
+	return FALSE;
+}
+
+P_LIB_API void
+p_shm_mutex_destroy (PShmMutex *mutex)
+{
+	P_UNUSED (mutex);
+}
+
+P_LIB_API psize
+p_shm_cond_variable_get_size (void)
+{
+	return 0;
+}
+
+P_LIB_API PShmCondVariable *
+p_shm_cond_variable_init (ppointer	mem,
+			  psize		size,
+			  PError	**error)
+{
+	P_UNUSED (mem);
+	P_UNUSED (size);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+			     0,
+			     "No process-shared synchronization implementation");
+
+	return NULL;
+}
+
+P_LIB_API PShmSyncStatus
+p_shm_cond_variable_wait (PShmCondVariable	*cond,
+			  PShmMutex		*mutex,
+			  PError		**error)
+{
+	P_UNUSED (cond);
+	P_UNUSED (mutex);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+			     0,
+			     "No process-shared synchronization implementation");
+
+	return P_SHM_SYNC_STATUS_ERROR;
+}
+
+P_LIB_API PShmSyncStatus
+p_shm_cond_variable_timed_wait (PShmCondVariable	*cond,
+				PShmMutex		*mutex,
+				pint			timeout,
+				PError			**error)
+{
+	P_UNUSED (cond);
+	P_UNUSED (mutex);
+	P_UNUSED (timeout);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+			     0,
+			     "No process-shared synchronization implementation");
+
+	return P_SHM_SYNC_STATUS_ERROR;
+}
+
+P_LIB_API pboolean
+p_shm_cond_variable_signal (PShmCondVariable	*cond,
+			    PError		**error)
+{
+	P_UNUSED (cond);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+			     0,
+			     "No process-shared synchronization implementation");
+
+	return FALSE;
+}
+
+P_LIB_API pboolean
+p_shm_cond_variable_broadcast (PShmCondVariable	*cond,
+			       PError			**error)
+{
+	P_UNUSED (cond);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+			     0,
+			     "No process-shared synchronization implementation");
+
+	return FALSE;
+}
+
+P_LIB_API void
+p_shm_cond_variable_destroy (PShmCondVariable *cond)
+{
+	P_UNUSED (cond);
+}
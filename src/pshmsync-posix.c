@@ -0,0 +1,447 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "perror.h"
+#include "pshmsync.h"
+#include "perror-private.h"
+
+#include <stdlib.h>
+#include <errno.h>
+#include <sys/time.h>
+#include <time.h>
+#include <pthread.h>
+
+struct PShmMutex_ {
+	pthread_mutex_t	hdl;
+};
+
+struct PShmCondVariable_ {
+	pthread_cond_t	hdl;
+};
+
+static pboolean pp_shm_sync_check_memory (ppointer mem, psize size, psize need, PError **error);
+static PShmSyncStatus pp_shm_sync_get_status (pint code, const pchar *func, PError **error);
+
+static pboolean
+pp_shm_sync_check_memory (ppointer	mem,
+			  psize		size,
+			  psize		need,
+			  PError	**error)
+{
+	if (P_UNLIKELY (mem == NULL || size < need ||
+			PPOINTER_TO_UINT (mem) % P_SHM_SYNC_ALIGNMENT != 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static PShmSyncStatus
+pp_shm_sync_get_status (pint		code,
+			const pchar	*func,
+			PError		**error)
+{
+	switch (code) {
+	case 0:
+		return P_SHM_SYNC_STATUS_OK;
+#ifdef PLIBSYS_HAS_POSIX_ROBUST_MUTEX
+	case EOWNERDEAD:
+		return P_SHM_SYNC_STATUS_OWNER_DIED;
+#endif
+	case EBUSY:
+		return P_SHM_SYNC_STATUS_BUSY;
+	case ETIMEDOUT:
+		return P_SHM_SYNC_STATUS_TIMED_OUT;
+	default:
+		p_error_set_error_p (error,
+				     (pint) p_error_get_ipc_from_system (code),
+				     code,
+				     func);
+		return P_SHM_SYNC_STATUS_ERROR;
+	}
+}
+
+P_LIB_API psize
+p_shm_mutex_get_size (void)
+{
+	return sizeof (PShmMutex);
+}
+
+P_LIB_API PShmMutex *
+p_shm_mutex_init (ppointer	mem,
+		  psize		size,
+		  PError	**error)
+{
+	PShmMutex		*ret;
+	pthread_mutexattr_t	attr;
+	pint			res;
+
+	if (P_UNLIKELY (pp_shm_sync_check_memory (mem, size, sizeof (PShmMutex), error) == FALSE))
+		return NULL;
+
+	ret = (PShmMutex *) mem;
+
+	if (P_UNLIKELY ((res = pthread_mutexattr_init (&attr)) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_ipc_from_system (res),
+				     res,
+				     "Failed to call pthread_mutexattr_init() to create mutex attributes");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((res = pthread_mutexattr_setpshared (&attr, PTHREAD_PROCESS_SHARED)) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_ipc_from_system (res),
+				     res,
+				     "Failed to call pthread_mutexattr_setpshared() to share mutex");
+		pthread_mutexattr_destroy (&attr);
+		return NULL;
+	}
+
+#ifdef PLIBSYS_HAS_POSIX_ROBUST_MUTEX
+	if (P_UNLIKELY ((res = pthread_mutexattr_setrobust (&attr, PTHREAD_MUTEX_ROBUST)) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_ipc_from_system (res),
+				     res,
+				     "Failed to call pthread_mutexattr_setrobust() to make mutex robust");
+		pthread_mutexattr_destroy (&attr);
+		return NULL;
+	}
+#endif
+
+	res = pthread_mutex_init (&ret->hdl, &attr);
+
+	if (P_UNLIKELY (pthread_mutexattr_destroy (&attr) != 0))
+		P_WARNING ("PShmMutex::p_shm_mutex_init: pthread_mutexattr_destroy() failed");
+
+	if (P_UNLIKELY (res != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_ipc_from_system (res),
+				     res,
+				     "Failed to call pthread_mutex_init() to create mutex");
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API PShmSyncStatus
+p_shm_mutex_lock (PShmMutex	*mutex,
+		  PError	**error)
+{
+	if (P_UNLIKELY (mutex == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return P_SHM_SYNC_STATUS_ERROR;
+	}
+
+	return pp_shm_sync_get_status (pthread_mutex_lock (&mutex->hdl),
+				       "Failed to call pthread_mutex_lock() to lock mutex",
+				       error);
+}
+
+P_LIB_API PShmSyncStatus
+p_shm_mutex_trylock (PShmMutex	*mutex,
+		     PError	**error)
+{
+	if (P_UNLIKELY (mutex == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return P_SHM_SYNC_STATUS_ERROR;
+	}
+
+	return pp_shm_sync_get_status (pthread_mutex_trylock (&mutex->hdl),
+				       "Failed to call pthread_mutex_trylock() to lock mutex",
+				       error);
+}
+
+P_LIB_API pboolean
+p_shm_mutex_unlock (PShmMutex	*mutex,
+		    PError	**error)
+{
+	pint res;
+
+	if (P_UNLIKELY (mutex == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY ((res = pthread_mutex_unlock (&mutex->hdl)) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_ipc_from_system (res),
+				     res,
+				     "Failed to call pthread_mutex_unlock() to unlock mutex");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_shm_mutex_make_consistent (PShmMutex	*mutex,
+			     PError	**error)
+{
+#ifdef PLIBSYS_HAS_POSIX_ROBUST_MUTEX
+	pint res;
+#endif
+
+	if (P_UNLIKELY (mutex == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+#ifdef PLIBSYS_HAS_POSIX_ROBUST_MUTEX
+	if (P_UNLIKELY ((res = pthread_mutex_consistent (&mutex->hdl)) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_ipc_from_system (res),
+				     res,
+				     "Failed to call pthread_mutex_consistent() to recover mutex");
+		return FALSE;
+	}
+
+	return TRUE;
+#else
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IPC_NOT_IMPLEMENTED,
+			     0,
+			     "Robust mutexes are not supported");
+	return FALSE;
+#endif
+}
+
+P_LIB_API void
+p_shm_mutex_destroy (PShmMutex *mutex)
+{
+	if (P_UNLIKELY (mutex == NULL))
+		return;
+
+	if (P_UNLIKELY (pthread_mutex_destroy (&mutex->hdl) != 0))
+		P_WARNING ("PShmMutex::p_shm_mutex_destroy: pthread_mutex_destroy() failed");
+}
+
+P_LIB_API psize
+p_shm_cond_variable_get_size (void)
+{
+	return sizeof (PShmCondVariable);
+}
+
+P_LIB_API PShmCondVariable *
+p_shm_cond_variable_init (ppointer	mem,
+			  psize		size,
+			  PError	**error)
+{
+	PShmCondVariable	*ret;
+	pthread_condattr_t	attr;
+	pint			res;
+
+	if (P_UNLIKELY (pp_shm_sync_check_memory (mem, size, sizeof (PShmCondVariable), error) == FALSE))
+		return NULL;
+
+	ret = (PShmCondVariable *) mem;
+
+	if (P_UNLIKELY ((res = pthread_condattr_init (&attr)) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_ipc_from_system (res),
+				     res,
+				     "Failed to call pthread_condattr_init() to create condition attributes");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((res = pthread_condattr_setpshared (&attr, PTHREAD_PROCESS_SHARED)) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_ipc_from_system (res),
+				     res,
+				     "Failed to call pthread_condattr_setpshared() to share condition variable");
+		pthread_condattr_destroy (&attr);
+		return NULL;
+	}
+
+#ifdef PLIBSYS_HAS_POSIX_CONDATTR_SETCLOCK
+	/* Timed waits must not be affected by the system time changes */
+	if (P_UNLIKELY ((res = pthread_condattr_setclock (&attr, CLOCK_MONOTONIC)) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_ipc_from_system (res),
+				     res,
+				     "Failed to call pthread_condattr_setclock() to use monotonic clock");
+		pthread_condattr_destroy (&attr);
+		return NULL;
+	}
+#endif
+
+	res = pthread_cond_init (&ret->hdl, &attr);
+
+	if (P_UNLIKELY (pthread_condattr_destroy (&attr) != 0))
+		P_WARNING ("PShmCondVariable::p_shm_cond_variable_init: pthread_condattr_destroy() failed");
+
+	if (P_UNLIKELY (res != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_ipc_from_system (res),
+				     res,
+				     "Failed to call pthread_cond_init() to create condition variable");
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API PShmSyncStatus
+p_shm_cond_variable_wait (PShmCondVariable	*cond,
+			  PShmMutex		*mutex,
+			  PError		**error)
+{
+	if (P_UNLIKELY (cond == NULL || mutex == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return P_SHM_SYNC_STATUS_ERROR;
+	}
+
+	return pp_shm_sync_get_status (pthread_cond_wait (&cond->hdl, &mutex->hdl),
+				       "Failed to call pthread_cond_wait() to wait on condition variable",
+				       error);
+}
+
+P_LIB_API PShmSyncStatus
+p_shm_cond_variable_timed_wait (PShmCondVariable	*cond,
+				PShmMutex		*mutex,
+				pint			timeout,
+				PError			**error)
+{
+#ifndef PLIBSYS_HAS_POSIX_CONDATTR_SETCLOCK
+	struct timeval	now;
+#endif
+	struct timespec	abstime;
+
+	if (P_UNLIKELY (cond == NULL || mutex == NULL || timeout < 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return P_SHM_SYNC_STATUS_ERROR;
+	}
+
+	/* The deadline must be on the same clock the condition variable uses */
+#ifdef PLIBSYS_HAS_POSIX_CONDATTR_SETCLOCK
+	if (P_UNLIKELY (clock_gettime (CLOCK_MONOTONIC, &abstime) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_last_ipc (),
+				     p_error_get_last_system (),
+				     "Failed to call clock_gettime() to get current time");
+		return P_SHM_SYNC_STATUS_ERROR;
+	}
+
+	abstime.tv_sec  += timeout / 1000;
+	abstime.tv_nsec += (long) (timeout % 1000) * 1000000;
+#else
+	gettimeofday (&now, NULL);
+
+	abstime.tv_sec  = now.tv_sec + timeout / 1000;
+	abstime.tv_nsec = (long) now.tv_usec * 1000 + (long) (timeout % 1000) * 1000000;
+#endif
+
+	if (abstime.tv_nsec >= 1000000000) {
+		abstime.tv_sec  += 1;
+		abstime.tv_nsec -= 1000000000;
+	}
+
+	return pp_shm_sync_get_status (pthread_cond_timedwait (&cond->hdl, &mutex->hdl, &abstime),
+				       "Failed to call pthread_cond_timedwait() to wait on condition variable",
+				       error);
+}
+
+P_LIB_API pboolean
+p_shm_cond_variable_signal (PShmCondVariable	*cond,
+			    PError		**error)
+{
+	pint res;
+
+	if (P_UNLIKELY (cond == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY ((res = pthread_cond_signal (&cond->hdl)) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_ipc_from_system (res),
+				     res,
+				     "Failed to call pthread_cond_signal() to signal condition variable");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_shm_cond_variable_broadcast (PShmCondVariable	*cond,
+			       PError			**error)
+{
+	pint res;
+
+	if (P_UNLIKELY (cond == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IPC_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY ((res = pthread_cond_broadcast (&cond->hdl)) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_ipc_from_system (res),
+				     res,
+				     "Failed to call pthread_cond_broadcast() to broadcast condition variable");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_shm_cond_variable_destroy (PShmCondVariable *cond)
+{
+	if (P_UNLIKELY (cond == NULL))
+		return;
+
+	if (P_UNLIKELY (pthread_cond_destroy (&cond->hdl) != 0))
+		P_WARNING ("PShmCondVariable::p_shm_cond_variable_destroy: pthread_cond_destroy() failed");
+}
@@ -0,0 +1,258 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file pshmsync.h
+ * @brief Process-shared mutex and condition variable
+ * @author Alexander Saprykin
+ *
+ * #PMutex and #PCondVariable are limited to the threads of a single process,
+ * while #PShm and #PSemaphore locking costs a system call for every acquire,
+ * even without any contention. #PShmMutex and #PShmCondVariable fill this gap:
+ * they are placed right inside a shared memory segment (see #PShm) and can be
+ * used by all the processes which have the segment attached. Uncontended
+ * locking doesn't enter the kernel on most systems.
+ *
+ * Objects are initialized in place: reserve p_shm_mutex_get_size() or
+ * p_shm_cond_variable_get_size() bytes inside the segment at an offset aligned
+ * to #P_SHM_SYNC_ALIGNMENT, then call p_shm_mutex_init() or
+ * p_shm_cond_variable_init() exactly once, usually from the process which has
+ * created the segment. Other processes cast the address of the already
+ * initialized object within their mapping of the segment to #PShmMutex or
+ * #PShmCondVariable pointer. Objects must be destroyed with
+ * p_shm_mutex_destroy() and p_shm_cond_variable_destroy() when no process uses
+ * them anymore.
+ *
+ * The mutex is robust where the system supports it: if a process or a thread
+ * dies while holding the lock, the next locker acquires it with the
+ * #P_SHM_SYNC_STATUS_OWNER_DIED status. The data guarded by the mutex may be
+ * inconsistent at that point: the new owner should repair it and call
+ * p_shm_mutex_make_consistent() before unlocking, otherwise the mutex becomes
+ * permanently unusable and all the further lock attempts fail.
+ *
+ * The objects don't store any process-local addresses, so they stay valid even
+ * if the segment is mapped at different addresses in different processes.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSHMSYNC_H
+#define PLIBSYS_HEADER_PSHMSYNC_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+#include <perror.h>
+
+P_BEGIN_DECLS
+
+/** Required alignment of #PShmMutex and #PShmCondVariable memory, in bytes. */
+#define P_SHM_SYNC_ALIGNMENT	8
+
+/** Result of the process-shared locking operations. */
+typedef enum PShmSyncStatus_ {
+	P_SHM_SYNC_STATUS_OK		= 0,	/**< Operation succeeded.				*/
+	P_SHM_SYNC_STATUS_OWNER_DIED	= 1,	/**< Lock is acquired, but the previous owner
+						     died while holding it.				*/
+	P_SHM_SYNC_STATUS_BUSY		= 2,	/**< Lock is held by someone else.			*/
+	P_SHM_SYNC_STATUS_TIMED_OUT	= 3,	/**< Waiting timed out, lock is acquired.		*/
+	P_SHM_SYNC_STATUS_ERROR		= 4	/**< Operation failed, lock is not acquired.		*/
+} PShmSyncStatus;
+
+/** Process-shared mutex opaque data structure. */
+typedef struct PShmMutex_ PShmMutex;
+
+/** Process-shared condition variable opaque data structure. */
+typedef struct PShmCondVariable_ PShmCondVariable;
+
+/**
+ * @brief Gets the size of memory required for a #PShmMutex object.
+ * @return Size of the #PShmMutex object in bytes, 0 if process-shared mutexes
+ * are not supported.
+ * @since 0.0.6
+ */
+P_LIB_API psize			p_shm_mutex_get_size		(void);
+
+/**
+ * @brief Initializes a #PShmMutex object in place.
+ * @param mem Memory to initialize the mutex in, usually inside a shared memory
+ * segment, must be aligned to #P_SHM_SYNC_ALIGNMENT.
+ * @param size Size of the @a mem, in bytes.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to the initialized #PShmMutex object (equals to @a mem) in
+ * case of success, NULL otherwise.
+ * @since 0.0.6
+ *
+ * The mutex must be initialized only once for all the processes.
+ */
+P_LIB_API PShmMutex *		p_shm_mutex_init		(ppointer		mem,
+								 psize			size,
+								 PError			**error);
+
+/**
+ * @brief Locks a #PShmMutex object.
+ * @param mutex #PShmMutex to lock.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return #P_SHM_SYNC_STATUS_OK or #P_SHM_SYNC_STATUS_OWNER_DIED if the mutex
+ * is locked, #P_SHM_SYNC_STATUS_ERROR otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API PShmSyncStatus	p_shm_mutex_lock		(PShmMutex		*mutex,
+								 PError			**error);
+
+/**
+ * @brief Tries to lock a #PShmMutex object immediately.
+ * @param mutex #PShmMutex to lock.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return #P_SHM_SYNC_STATUS_OK or #P_SHM_SYNC_STATUS_OWNER_DIED if the mutex
+ * is locked, #P_SHM_SYNC_STATUS_BUSY if it is held by someone else,
+ * #P_SHM_SYNC_STATUS_ERROR otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API PShmSyncStatus	p_shm_mutex_trylock		(PShmMutex		*mutex,
+								 PError			**error);
+
+/**
+ * @brief Unlocks a #PShmMutex object.
+ * @param mutex #PShmMutex to unlock.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API pboolean		p_shm_mutex_unlock		(PShmMutex		*mutex,
+								 PError			**error);
+
+/**
+ * @brief Marks the state guarded by a recovered #PShmMutex as consistent.
+ * @param mutex #PShmMutex locked with the #P_SHM_SYNC_STATUS_OWNER_DIED status.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * Must be called by the owner of the mutex before unlocking it.
+ */
+P_LIB_API pboolean		p_shm_mutex_make_consistent	(PShmMutex		*mutex,
+								 PError			**error);
+
+/**
+ * @brief Destroys a #PShmMutex object.
+ * @param mutex #PShmMutex to destroy.
+ * @since 0.0.6
+ *
+ * The mutex must be unlocked and not used by any process. The memory itself is
+ * not freed.
+ */
+P_LIB_API void			p_shm_mutex_destroy		(PShmMutex		*mutex);
+
+/**
+ * @brief Gets the size of memory required for a #PShmCondVariable object.
+ * @return Size of the #PShmCondVariable object in bytes, 0 if process-shared
+ * condition variables are not supported.
+ * @since 0.0.6
+ */
+P_LIB_API psize			p_shm_cond_variable_get_size	(void);
+
+/**
+ * @brief Initializes a #PShmCondVariable object in place.
+ * @param mem Memory to initialize the condition variable in, usually inside a
+ * shared memory segment, must be aligned to #P_SHM_SYNC_ALIGNMENT.
+ * @param size Size of the @a mem, in bytes.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to the initialized #PShmCondVariable object (equals to
+ * @a mem) in case of success, NULL otherwise.
+ * @since 0.0.6
+ *
+ * The condition variable must be initialized only once for all the processes.
+ */
+P_LIB_API PShmCondVariable *	p_shm_cond_variable_init	(ppointer		mem,
+								 psize			size,
+								 PError			**error);
+
+/**
+ * @brief Waits for a signal on a #PShmCondVariable object.
+ * @param cond #PShmCondVariable to wait on.
+ * @param mutex Locked #PShmMutex which will remain locked after waiting.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return #P_SHM_SYNC_STATUS_OK or #P_SHM_SYNC_STATUS_OWNER_DIED (see
+ * p_shm_mutex_lock()) after the wake up, #P_SHM_SYNC_STATUS_ERROR otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API PShmSyncStatus	p_shm_cond_variable_wait	(PShmCondVariable	*cond,
+								 PShmMutex		*mutex,
+								 PError			**error);
+
+/**
+ * @brief Waits for a signal on a #PShmCondVariable object with a timeout.
+ * @param cond #PShmCondVariable to wait on.
+ * @param mutex Locked #PShmMutex which will remain locked after waiting.
+ * @param timeout Timeout in milliseconds.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return #P_SHM_SYNC_STATUS_OK or #P_SHM_SYNC_STATUS_OWNER_DIED (see
+ * p_shm_mutex_lock()) after the wake up, #P_SHM_SYNC_STATUS_TIMED_OUT if no
+ * signal has been received in time, #P_SHM_SYNC_STATUS_ERROR otherwise.
+ * @since 0.0.6
+ *
+ * Use the timeout to avoid waiting forever for a peer process which may have
+ * died before emitting the signal.
+ */
+P_LIB_API PShmSyncStatus	p_shm_cond_variable_timed_wait	(PShmCondVariable	*cond,
+								 PShmMutex		*mutex,
+								 pint			timeout,
+								 PError			**error);
+
+/**
+ * @brief Wakes up a single process or thread waiting on a #PShmCondVariable.
+ * @param cond #PShmCondVariable to emit the signal on.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API pboolean		p_shm_cond_variable_signal	(PShmCondVariable	*cond,
+								 PError			**error);
+
+/**
+ * @brief Wakes up all the processes and threads waiting on a #PShmCondVariable.
+ * @param cond #PShmCondVariable to emit the signal on.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API pboolean		p_shm_cond_variable_broadcast	(PShmCondVariable	*cond,
+								 PError			**error);
+
+/**
+ * @brief Destroys a #PShmCondVariable object.
+ * @param cond #PShmCondVariable to destroy.
+ * @since 0.0.6
+ *
+ * No process should wait on the condition variable. The memory itself is not
+ * freed.
+ */
+P_LIB_API void			p_shm_cond_variable_destroy	(PShmCondVariable	*cond);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSHMSYNC_H */
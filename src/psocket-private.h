@@ -0,0 +1,57 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSOCKET_PRIVATE_H
+#define PLIBSYS_HEADER_PSOCKET_PRIVATE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+#include "perror.h"
+#include "psocket.h"
+
+P_BEGIN_DECLS
+
+/**
+ * @brief Wraps a socket descriptor accepted on a listening socket.
+ * @param socket Listening socket the descriptor was accepted on.
+ * @param fd Accepted socket descriptor.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PSocket in case of success, NULL otherwise.
+ *
+ * The family, type and protocol are taken from the listening socket, so they
+ * are not queried like p_socket_new_from_fd() does. The descriptor is not
+ * closed on failure.
+ */
+PSocket * p_socket_new_accepted (const PSocket	*socket,
+				 pint		fd,
+				 PError		**error);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSOCKET_PRIVATE_H */
@@ -26,11 +26,10 @@
 
 #include "pmem.h"
 #include "psocket.h"
-#ifdef P_OS_SCO
-#  include "ptimeprofiler.h"
-#endif
+#include "ptimeprofiler.h"
 #include "perror-private.h"
 #include "plibsys-private.h"
+#include "psocket-private.h"
 #include "psysclose-private.h"
 
 #include <stdlib.h>
@@ -41,9 +40,16 @@
 #  include <errno.h>
 #  include <unistd.h>
 #  include <signal.h>
+#  include <netinet/tcp.h>
+#  ifdef PLIBSYS_HAS_SENDFILE
+#    include <sys/stat.h>
+#    include <sys/sendfile.h>
+#  endif
 #  ifdef P_OS_VMS
 #    include <stropts.h>
 #  endif
+#else
+#  include <io.h>
 #endif
 
 #ifndef P_OS_WIN
@@ -58,6 +64,13 @@
 #  endif
 #endif
 
+#if !defined (P_OS_WIN) && defined (AF_UNIX)
+#  define P_SOCKET_HAS_UNIX
+#  if defined (SCM_RIGHTS) && defined (CMSG_SPACE)
+#    define P_SOCKET_HAS_FD_PASSING
+#  endif
+#endif
+
 /* On old Solaris systems SOMAXCONN is set to 5 */
 #define P_SOCKET_DEFAULT_BACKLOG	5
 
@@ -99,9 +112,42 @@ struct PSocket_ {
 #  define P_SOCKET_DEFAULT_SEND_FLAGS	0
 #endif
 
+/* Size of the intermediate buffer to send file data through user space */
+#define P_SOCKET_SEND_FILE_BUFFER_SIZE	65536
+
+/* Maximal amount of file data to send with a single system call */
+#define P_SOCKET_SEND_FILE_MAX_CHUNK	0x40000000
+
+typedef enum PSocketSendFileMethod_ {
+	P_SOCKET_SEND_FILE_METHOD_MEMORY	= 0,
+	P_SOCKET_SEND_FILE_METHOD_SENDFILE	= 1,
+	P_SOCKET_SEND_FILE_METHOD_SPLICE	= 2,
+	P_SOCKET_SEND_FILE_METHOD_COPY		= 3
+} PSocketSendFileMethod;
+
 static pboolean pp_socket_set_fd_blocking (pint fd, pboolean blocking, PError **error);
 static pboolean pp_socket_check (const PSocket *socket, PError **error);
+#ifdef P_SOCKET_HAS_FD_PASSING
+static pboolean pp_socket_check_unix (const PSocket *socket, PError **error);
+#endif
 static pboolean pp_socket_set_details_from_fd (PSocket *socket, PError **error);
+static pboolean pp_socket_get_native_address (const PSocket *socket, pboolean remote,
+					      struct sockaddr_storage *buffer, socklen_t *len, PError **error);
+static pint pp_socket_accept_fd (const PSocket *socket, struct sockaddr_storage *buffer,
+				socklen_t *len, pint *err_code);
+static pint pp_socket_start_connect (const PSocket *socket, const struct sockaddr_storage *buffer, psize len);
+static pint pp_socket_wait_connect (PSocket **sockets, pint *pending, pint count, pint timeout, PError **error);
+static PSocket * pp_socket_accept (const PSocket *socket, struct sockaddr_storage *buffer,
+				   socklen_t *len, PError **error);
+static pssize pp_socket_receive_from (const PSocket *socket, struct sockaddr_storage *buffer,
+				      socklen_t *len, pchar *data, psize datalen, PError **error);
+static pboolean pp_socket_get_option_native (PSocketOption option, pint *level, pint *name);
+static pssize pp_socket_read_file (pint fd, pchar *buffer, psize length, puint64 offset, pint *err_code);
+static pssize pp_socket_send_file_chunk (const PSocket *socket, PSocketSendFileMethod method, pint fd,
+					 const pchar *data, pchar *buffer, puint64 offset, psize length,
+					 pint *err_code);
+static pssize pp_socket_send_file_data (const PSocket *socket, pint fd, const pchar *data,
+					puint64 offset, psize length, PError **error);
 
 static pboolean
 pp_socket_set_fd_blocking (pint		fd,
@@ -165,6 +211,23 @@ pp_socket_check (const PSocket *socket,
 	return TRUE;
 }
 
+#ifdef P_SOCKET_HAS_FD_PASSING
+static pboolean
+pp_socket_check_unix (const PSocket	*socket,
+		      PError		**error)
+{
+	if (P_UNLIKELY (socket->family != P_SOCKET_FAMILY_UNIX)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "File descriptors can be passed only through Unix domain socket");
+		return FALSE;
+	}
+
+	return pp_socket_check (socket, error);
+}
+#endif
+
 static pboolean
 pp_socket_set_details_from_fd (PSocket	*socket,
 				PError	**error)
@@ -259,6 +322,11 @@ pp_socket_set_details_from_fd (PSocket	*socket,
 	case P_SOCKET_FAMILY_INET6:
 		socket->family = P_SOCKET_FAMILY_INET6;
 		break;
+#endif
+#ifdef P_SOCKET_HAS_UNIX
+	case P_SOCKET_FAMILY_UNIX:
+		socket->family = P_SOCKET_FAMILY_UNIX;
+		break;
 #endif
 	default:
 		socket->family = P_SOCKET_FAMILY_UNKNOWN;
@@ -547,6 +615,106 @@ p_socket_new (PSocketFamily	family,
 	return ret;
 }
 
+P_LIB_API pboolean
+p_socket_new_pair (PSocketType	type,
+		   PSocket	**first,
+		   PSocket	**second,
+		   PError	**error)
+{
+#ifdef P_SOCKET_HAS_UNIX
+	pint	native_type;
+	pint	fds[2];
+	pint	flags;
+	pint	i;
+
+	if (P_UNLIKELY (first == NULL || second == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	switch (type) {
+	case P_SOCKET_TYPE_STREAM:
+		native_type = SOCK_STREAM;
+		break;
+
+	case P_SOCKET_TYPE_DATAGRAM:
+		native_type = SOCK_DGRAM;
+		break;
+
+#ifdef SOCK_SEQPACKET
+	case P_SOCKET_TYPE_SEQPACKET:
+		native_type = SOCK_SEQPACKET;
+		break;
+#endif
+
+	default:
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Unable to create socket pair with unknown type");
+		return FALSE;
+	}
+
+#ifdef SOCK_CLOEXEC
+	native_type |= SOCK_CLOEXEC;
+#endif
+
+	if (P_UNLIKELY (socketpair (AF_UNIX, native_type, 0, fds) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
+				     (pint) p_error_get_last_net (),
+				     "Failed to call socketpair() to create socket pair");
+		return FALSE;
+	}
+
+	for (i = 0; i < 2; ++i) {
+		flags = fcntl (fds[i], F_GETFD, 0);
+
+		if (P_LIKELY (flags != -1 && (flags & FD_CLOEXEC) == 0)) {
+			flags |= FD_CLOEXEC;
+
+			if (P_UNLIKELY (fcntl (fds[i], F_SETFD, flags) < 0))
+				P_WARNING ("PSocket::p_socket_new_pair: fcntl() with FD_CLOEXEC failed");
+		}
+	}
+
+	if (P_UNLIKELY ((*first = p_socket_new_from_fd (fds[0], error)) == NULL)) {
+		if (P_UNLIKELY (p_sys_close (fds[0]) != 0))
+			P_WARNING ("PSocket::p_socket_new_pair: p_sys_close() failed");
+
+		if (P_UNLIKELY (p_sys_close (fds[1]) != 0))
+			P_WARNING ("PSocket::p_socket_new_pair: p_sys_close() failed");
+
+		return FALSE;
+	}
+
+	if (P_UNLIKELY ((*second = p_socket_new_from_fd (fds[1], error)) == NULL)) {
+		p_socket_free (*first);
+		*first = NULL;
+
+		if (P_UNLIKELY (p_sys_close (fds[1]) != 0))
+			P_WARNING ("PSocket::p_socket_new_pair: p_sys_close() failed");
+
+		return FALSE;
+	}
+
+	return TRUE;
+#else
+	P_UNUSED (type);
+	P_UNUSED (first);
+	P_UNUSED (second);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Unix domain sockets are not supported on this platform");
+	return FALSE;
+#endif
+}
+
 P_LIB_API pint
 p_socket_get_fd (const PSocket *socket)
 {
@@ -619,32 +787,64 @@ p_socket_get_timeout (const PSocket *socket)
 	return socket->timeout;
 }
 
-P_LIB_API PSocketAddress *
-p_socket_get_local_address (const PSocket	*socket,
-			    PError		**error)
+static pboolean
+pp_socket_get_native_address (const PSocket		*socket,
+			      pboolean			remote,
+			      struct sockaddr_storage	*buffer,
+			      socklen_t			*len,
+			      PError			**error)
 {
-	struct sockaddr_storage	buffer;
-	socklen_t		len;
-	PSocketAddress		*ret;
-
 	if (P_UNLIKELY (socket == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
 				     "Invalid input argument");
-		return NULL;
+		return FALSE;
 	}
 
-	len = sizeof (buffer);
+	*len = sizeof (struct sockaddr_storage);
+
+	if (remote == FALSE) {
+		if (P_UNLIKELY (getsockname (socket->fd, (struct sockaddr *) buffer, len) < 0)) {
+			p_error_set_error_p (error,
+					     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
+					     (pint) p_error_get_last_net (),
+					     "Failed to call getsockname() to get local socket address");
+			return FALSE;
+		}
+
+		return TRUE;
+	}
 
-	if (P_UNLIKELY (getsockname (socket->fd, (struct sockaddr *) &buffer, &len) < 0)) {
+	if (P_UNLIKELY (getpeername (socket->fd, (struct sockaddr *) buffer, len) < 0)) {
 		p_error_set_error_p (error,
 				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
 				     (pint) p_error_get_last_net (),
-				     "Failed to call getsockname() to get local socket address");
-		return NULL;
+				     "Failed to call getpeername() to get remote socket address");
+		return FALSE;
 	}
 
+#ifdef P_OS_SYLLABLE
+	/* Syllable has a bug with a wrong byte order for a TCP port,
+	 * as it only supports IPv4 we can easily fix it here. */
+	((struct sockaddr_in *) buffer)->sin_port =
+			p_htons (((struct sockaddr_in *) buffer)->sin_port);
+#endif
+
+	return TRUE;
+}
+
+P_LIB_API PSocketAddress *
+p_socket_get_local_address (const PSocket	*socket,
+			    PError		**error)
+{
+	struct sockaddr_storage	buffer;
+	socklen_t		len;
+	PSocketAddress		*ret;
+
+	if (P_UNLIKELY (pp_socket_get_native_address (socket, FALSE, &buffer, &len, error) == FALSE))
+		return NULL;
+
 	ret = p_socket_address_new_from_native (&buffer, (psize) len);
 
 	if (P_UNLIKELY (ret == NULL))
@@ -656,38 +856,46 @@ p_socket_get_local_address (const PSocket	*socket,
 	return ret;
 }
 
-P_LIB_API PSocketAddress *
-p_socket_get_remote_address (const PSocket	*socket,
-			     PError		**error)
+P_LIB_API pboolean
+p_socket_get_local_address_into (const PSocket		*socket,
+				 PSocketAddressStorage	*address,
+				 PError			**error)
 {
 	struct sockaddr_storage	buffer;
-	socklen_t 		len;
-	PSocketAddress		*ret;
+	socklen_t		len;
 
-	if (P_UNLIKELY (socket == NULL)) {
+	if (P_UNLIKELY (address == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
 				     "Invalid input argument");
-		return NULL;
+		return FALSE;
 	}
 
-	len = sizeof (buffer);
+	if (P_UNLIKELY (pp_socket_get_native_address (socket, FALSE, &buffer, &len, error) == FALSE))
+		return FALSE;
 
-	if (P_UNLIKELY (getpeername (socket->fd, (struct sockaddr *) &buffer, &len) < 0)) {
+	if (P_UNLIKELY (p_socket_address_init_from_native (address, &buffer, (psize) len) == NULL)) {
 		p_error_set_error_p (error,
-				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
-				     (pint) p_error_get_last_net (),
-				     "Failed to call getpeername() to get remote socket address");
-		return NULL;
+				     (pint) P_ERROR_IO_FAILED,
+				     0,
+				     "Failed to create socket address from native structure");
+		return FALSE;
 	}
 
-#ifdef P_OS_SYLLABLE
-	/* Syllable has a bug with a wrong byte order for a TCP port,
-	 * as it only supports IPv4 we can easily fix it here. */
-	((struct sockaddr_in *) &buffer)->sin_port =
-			p_htons (((struct sockaddr_in *) &buffer)->sin_port);
-#endif
+	return TRUE;
+}
+
+P_LIB_API PSocketAddress *
+p_socket_get_remote_address (const PSocket	*socket,
+			     PError		**error)
+{
+	struct sockaddr_storage	buffer;
+	socklen_t 		len;
+	PSocketAddress		*ret;
+
+	if (P_UNLIKELY (pp_socket_get_native_address (socket, TRUE, &buffer, &len, error) == FALSE))
+		return NULL;
 
 	ret = p_socket_address_new_from_native (&buffer, (psize) len);
 
@@ -700,6 +908,36 @@ p_socket_get_remote_address (const PSocket	*socket,
 	return ret;
 }
 
+P_LIB_API pboolean
+p_socket_get_remote_address_into (const PSocket		*socket,
+				  PSocketAddressStorage	*address,
+				  PError		**error)
+{
+	struct sockaddr_storage	buffer;
+	socklen_t		len;
+
+	if (P_UNLIKELY (address == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_socket_get_native_address (socket, TRUE, &buffer, &len, error) == FALSE))
+		return FALSE;
+
+	if (P_UNLIKELY (p_socket_address_init_from_native (address, &buffer, (psize) len) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_FAILED,
+				     0,
+				     "Failed to create socket address from native structure");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
 P_LIB_API pboolean
 p_socket_is_connected (const PSocket *socket)
 {
@@ -736,18 +974,18 @@ p_socket_check_connect_result (PSocket  *socket,
 	optlen = sizeof (val);
 
 	if (P_UNLIKELY (getsockopt (socket->fd, SOL_SOCKET, SO_ERROR, (ppointer) &val, &optlen) < 0)) {
-		p_error_set_error_p (error,
-				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
-				     (pint) p_error_get_last_net (),
-				     "Failed to call getsockopt() to get connection status");
+		p_error_set_error_static_p (error,
+					    (pint) p_error_get_io_from_system (p_error_get_last_net ()),
+					    (pint) p_error_get_last_net (),
+					    "Failed to call getsockopt() to get connection status");
 		return FALSE;
 	}
 
 	if (P_UNLIKELY (val != 0))
-		p_error_set_error_p (error,
-				     (pint) p_error_get_io_from_system (val),
-				     val,
-				     "Error in socket layer");
+		p_error_set_error_static_p (error,
+					    (pint) p_error_get_io_from_system (val),
+					    val,
+					    "Error in socket layer");
 
 	socket->connected = (val == 0);
 
@@ -824,10 +1062,6 @@ p_socket_bind (const PSocket	*socket,
 {
 	struct sockaddr_storage	addr;
 
-#ifdef SO_REUSEPORT
-	pboolean		reuse_port;
-#endif
-
 #ifdef P_OS_WIN
 	pchar			value;
 #else
@@ -862,16 +1096,14 @@ p_socket_bind (const PSocket	*socket,
 		P_WARNING ("PSocket::p_socket_bind: setsockopt() with SO_REUSEADDR failed");
 
 #ifdef SO_REUSEPORT
-	reuse_port = allow_reuse && (socket->type == P_SOCKET_TYPE_DATAGRAM);
+	/* Only enable the option, it may be also set explicitly with
+	 * p_socket_set_option() before binding */
+	if (allow_reuse && socket->type == P_SOCKET_TYPE_DATAGRAM) {
+		value = 1;
 
-#  ifdef P_OS_WIN
-	value = !! (pchar) reuse_port;
-#  else
-	value = !! (pint) reuse_port;
-#  endif
-
-	if (setsockopt (socket->fd, SOL_SOCKET, SO_REUSEPORT, &value, sizeof (value)) < 0)
-		P_WARNING ("PSocket::p_socket_bind: setsockopt() with SO_REUSEPORT failed");
+		if (setsockopt (socket->fd, SOL_SOCKET, SO_REUSEPORT, &value, sizeof (value)) < 0)
+			P_WARNING ("PSocket::p_socket_bind: setsockopt() with SO_REUSEPORT failed");
+	}
 #endif
 
 	if (P_UNLIKELY (p_socket_address_to_native (address, &addr, sizeof (addr)) == FALSE)) {
@@ -895,64 +1127,181 @@ p_socket_bind (const PSocket	*socket,
 	return TRUE;
 }
 
-P_LIB_API pboolean
-p_socket_connect (PSocket		*socket,
-		  PSocketAddress	*address,
-		  PError		**error)
+static pint
+pp_socket_start_connect (const PSocket			*socket,
+			 const struct sockaddr_storage	*buffer,
+			 psize				len)
 {
-	struct sockaddr_storage	buffer;
-	pint			err_code;
-	pint			conn_result;
-	PErrorIO		sock_err;
+#if !defined (P_OS_WIN) && defined (EINTR)
+	pint err_code;
 
-	if (P_UNLIKELY (socket == NULL || address == NULL)) {
-		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
-				     0,
-				     "Invalid input argument");
-		return FALSE;
+	for (;;) {
+		if (P_LIKELY (connect (socket->fd, (const struct sockaddr *) buffer, (socklen_t) len) == 0))
+			return 0;
+
+		err_code = p_error_get_last_net ();
+
+		if (err_code != EINTR)
+			return err_code;
 	}
+#else
+	if (connect (socket->fd, (const struct sockaddr *) buffer, (pint) len) == 0)
+		return 0;
 
-	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
-		return FALSE;
+	return p_error_get_last_net ();
+#endif
+}
 
-	if (P_UNLIKELY (p_socket_address_to_native (address, &buffer, sizeof (buffer)) == FALSE)) {
+static pint
+pp_socket_wait_connect (PSocket		**sockets,
+			pint		*pending,
+			pint		count,
+			pint		timeout,
+			PError		**error)
+{
+	puint64		start;
+	puint64		elapsed;
+	pint		wait_time;
+	pint		ret;
+	pint		i;
+#ifdef P_SOCKET_USE_POLL
+	struct pollfd	*pfds;
+	pint		evret;
+	pint		err_code;
+	pint		j;
+#else
+	PSocket		*socket;
+	pint		saved_timeout;
+#endif
+
+	ret   = 0;
+	start = p_time_profiler_ticks ();
+
+#ifdef P_SOCKET_USE_POLL
+	if (P_UNLIKELY ((pfds = p_malloc ((psize) count * sizeof (struct pollfd))) == NULL)) {
 		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_FAILED,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
 				     0,
-				     "Failed to convert socket address to native structure");
-		return FALSE;
+				     "Failed to allocate memory for poll descriptors");
+		return -1;
 	}
 
-#if !defined (P_OS_WIN) && defined (EINTR)
-	for (;;) {
-		conn_result = connect (socket->fd, (struct sockaddr *) &buffer,
-				       (socklen_t) p_socket_address_get_native_size (address));
+	for (i = 0; i < count; ++i) {
+		pfds[i].fd      = sockets[pending[i]]->fd;
+		pfds[i].events  = POLLOUT;
+		pfds[i].revents = 0;
+	}
 
-		if (P_LIKELY (conn_result == 0))
-			break;
+	while (count > 0) {
+		wait_time = -1;
 
-		err_code = p_error_get_last_net ();
+		if (timeout > 0) {
+			elapsed = p_time_profiler_ticks_to_nsecs (p_time_profiler_ticks () - start) / 1000000;
 
-		if (err_code == EINTR)
-			continue;
-		else
-			break;
-	}
-#else
-	conn_result = connect (socket->fd, (struct sockaddr *) &buffer,
-			       (pint) p_socket_address_get_native_size (address));
+			if (elapsed >= (puint64) timeout)
+				break;
 
-	if (conn_result != 0)
-		err_code = p_error_get_last_net ();
-#endif
+			wait_time = timeout - (pint) elapsed;
+		}
 
-	if (conn_result == 0) {
-		socket->connected = TRUE;
-		return TRUE;
-	}
+		if ((evret = poll (pfds, count, wait_time)) < 0) {
+			err_code = p_error_get_last_net ();
 
-	sock_err = p_error_get_io_from_system (err_code);
+#  ifdef EINTR
+			if (err_code == EINTR)
+				continue;
+#  endif
+			p_error_set_error_p (error,
+					     (pint) p_error_get_io_from_system (err_code),
+					     err_code,
+					     "Failed to call poll() on sockets");
+			p_free (pfds);
+			return -1;
+		}
+
+		if (evret == 0)
+			break;
+
+		/* Drop completed connections and keep waiting for the rest */
+		for (i = 0, j = 0; i < count; ++i) {
+			if (pfds[i].revents != 0) {
+				if (p_socket_check_connect_result (sockets[pending[i]], NULL) == TRUE)
+					++ret;
+			} else {
+				pfds[j]    = pfds[i];
+				pending[j] = pending[i];
+				++j;
+			}
+		}
+
+		count = j;
+	}
+
+	p_free (pfds);
+#else
+	P_UNUSED (error);
+
+	/* All the connections are in progress already, so waiting for them one
+	 * by one still takes about the time of the slowest one */
+	for (i = 0; i < count; ++i) {
+		socket    = sockets[pending[i]];
+		wait_time = 0;
+
+		if (timeout > 0) {
+			elapsed   = p_time_profiler_ticks_to_nsecs (p_time_profiler_ticks () - start) / 1000000;
+			wait_time = elapsed >= (puint64) timeout ? 1 : timeout - (pint) elapsed;
+		}
+
+		saved_timeout   = socket->timeout;
+		socket->timeout = wait_time;
+
+		if (p_socket_io_condition_wait (socket, P_SOCKET_IO_CONDITION_POLLOUT, NULL) == TRUE &&
+		    p_socket_check_connect_result (socket, NULL) == TRUE)
+			++ret;
+
+		socket->timeout = saved_timeout;
+	}
+#endif
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_socket_connect (PSocket		*socket,
+		  PSocketAddress	*address,
+		  PError		**error)
+{
+	struct sockaddr_storage	buffer;
+	pint			err_code;
+	PErrorIO		sock_err;
+
+	if (P_UNLIKELY (socket == NULL || address == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return FALSE;
+
+	if (P_UNLIKELY (p_socket_address_to_native (address, &buffer, sizeof (buffer)) == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_FAILED,
+				     0,
+				     "Failed to convert socket address to native structure");
+		return FALSE;
+	}
+
+	err_code = pp_socket_start_connect (socket, &buffer, p_socket_address_get_native_size (address));
+
+	if (err_code == 0) {
+		socket->connected = TRUE;
+		return TRUE;
+	}
+
+	sock_err = p_error_get_io_from_system (err_code);
 
 	if (P_LIKELY (sock_err == P_ERROR_IO_WOULD_BLOCK || sock_err == P_ERROR_IO_IN_PROGRESS)) {
 		if (socket->blocking) {
@@ -977,6 +1326,98 @@ p_socket_connect (PSocket		*socket,
 	return FALSE;
 }
 
+P_LIB_API pint
+p_socket_connect_batch (PSocket		**sockets,
+			pint		count,
+			PSocketAddress	*address,
+			pint		timeout,
+			PError		**error)
+{
+	struct sockaddr_storage	buffer;
+	PErrorIO		sock_err;
+	psize			len;
+	pint			*pending;
+	pint			pending_count;
+	pint			err_code;
+	pint			ret;
+	pint			i;
+
+	if (P_UNLIKELY (sockets == NULL || count < 0 || address == NULL || timeout < 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	for (i = 0; i < count; ++i) {
+		if (P_UNLIKELY (sockets[i] == NULL)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+					     0,
+					     "Invalid input argument");
+			return -1;
+		}
+	}
+
+	if (count == 0)
+		return 0;
+
+	if (P_UNLIKELY (p_socket_address_to_native (address, &buffer, sizeof (buffer)) == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_FAILED,
+				     0,
+				     "Failed to convert socket address to native structure");
+		return -1;
+	}
+
+	if (P_UNLIKELY ((pending = p_malloc ((psize) count * sizeof (pint))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for pending connections");
+		return -1;
+	}
+
+	len           = p_socket_address_get_native_size (address);
+	pending_count = 0;
+	ret           = 0;
+
+	/* Start all the connections first, the descriptors are non-blocking */
+	for (i = 0; i < count; ++i) {
+		if (sockets[i]->closed)
+			continue;
+
+		if ((err_code = pp_socket_start_connect (sockets[i], &buffer, len)) == 0) {
+			sockets[i]->connected = TRUE;
+			++ret;
+			continue;
+		}
+
+		sock_err = p_error_get_io_from_system (err_code);
+
+		if (sock_err == P_ERROR_IO_WOULD_BLOCK || sock_err == P_ERROR_IO_IN_PROGRESS)
+			pending[pending_count++] = i;
+	}
+
+	if (pending_count > 0) {
+		if (P_UNLIKELY ((err_code = pp_socket_wait_connect (sockets,
+								    pending,
+								    pending_count,
+								    timeout,
+								    error)) < 0)) {
+			p_free (pending);
+			return -1;
+		}
+
+		ret += err_code;
+	}
+
+	p_free (pending);
+
+	return ret;
+}
+
 P_LIB_API pboolean
 p_socket_listen (PSocket	*socket,
 		 PError		**error)
@@ -1004,142 +1445,663 @@ p_socket_listen (PSocket	*socket,
 	return TRUE;
 }
 
-P_LIB_API PSocket *
-p_socket_accept (const PSocket	*socket,
-		 PError		**error)
+static pint
+pp_socket_accept_fd (const PSocket		*socket,
+		     struct sockaddr_storage	*buffer,
+		     socklen_t			*len,
+		     pint			*err_code)
 {
-	PSocket		*ret;
-	PErrorIO	sock_err;
-	pint		res;
-	pint		err_code;
-#ifndef P_OS_WIN
-	pint		flags;
+	pint	res;
+#if !defined (P_OS_WIN) && !defined (PLIBSYS_HAS_ACCEPT4)
+	pint	flags;
 #endif
 
-	if (P_UNLIKELY (socket == NULL)) {
-		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
-				     0,
-				     "Invalid input argument");
-		return NULL;
-	}
-
-	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
-		return NULL;
-
 	for (;;) {
-		if (socket->blocking &&
-		    p_socket_io_condition_wait (socket,
-						P_SOCKET_IO_CONDITION_POLLIN,
-						error) == FALSE)
-			return NULL;
-
-		if ((res = (pint) accept (socket->fd, NULL, 0)) < 0) {
-			err_code = p_error_get_last_net ();
-#if !defined (P_OS_WIN) && defined (EINTR)
-			if (p_error_get_last_net () == EINTR)
-				continue;
+		if (buffer != NULL)
+			*len = sizeof (struct sockaddr_storage);
+
+#ifdef PLIBSYS_HAS_ACCEPT4
+		res = accept4 (socket->fd,
+			       (struct sockaddr *) buffer,
+			       buffer != NULL ? len : NULL,
+			       SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+		res = (pint) accept (socket->fd, (struct sockaddr *) buffer, buffer != NULL ? len : NULL);
 #endif
-			sock_err = p_error_get_io_from_system (err_code);
-
-			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
-				continue;
 
-			p_error_set_error_p (error,
-					     (pint) sock_err,
-					     err_code,
-					     "Failed to call accept() on socket");
+		if (P_LIKELY (res >= 0))
+			break;
 
-			return NULL;
-		}
+		*err_code = p_error_get_last_net ();
 
-		break;
+#if !defined (P_OS_WIN) && defined (EINTR)
+		if (*err_code == EINTR)
+			continue;
+#endif
+		return -1;
 	}
 
 #ifdef P_OS_WIN
 	/* The socket inherits the accepting sockets event mask and even object,
 	 * we need to remove that */
 	WSAEventSelect (res, NULL, 0);
-#else
+#elif !defined (PLIBSYS_HAS_ACCEPT4)
 	flags = fcntl (res, F_GETFD, 0);
 
 	if (P_LIKELY (flags != -1 && (flags & FD_CLOEXEC) == 0)) {
 		flags |= FD_CLOEXEC;
 
 		if (P_UNLIKELY (fcntl (res, F_SETFD, flags) < 0))
-			P_WARNING ("PSocket::p_socket_accept: fcntl() with FD_CLOEXEC failed");
+			P_WARNING ("PSocket::pp_socket_accept_fd: fcntl() with FD_CLOEXEC failed");
 	}
 #endif
 
-	if (P_UNLIKELY ((ret = p_socket_new_from_fd (res, error)) == NULL)) {
-		if (P_UNLIKELY (p_sys_close (res) != 0))
-			P_WARNING ("PSocket::p_socket_accept: p_sys_close() failed");
-	} else
-		ret->protocol = socket->protocol;
+	return res;
+}
+
+PSocket *
+p_socket_new_accepted (const PSocket	*socket,
+		       pint		fd,
+		       PError		**error)
+{
+	PSocket	*ret;
+#if !defined (P_OS_WIN) && defined (SO_NOSIGPIPE)
+	pint	flags;
+#endif
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocket))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket");
+		return NULL;
+	}
+
+	ret->fd = fd;
+
+#ifdef P_OS_WIN
+	ret->events = WSA_INVALID_EVENT;
+#endif
+
+	/* The accepted socket has the same details as the listening one, there is
+	 * no need to query them like p_socket_new_from_fd() does */
+#ifndef PLIBSYS_HAS_ACCEPT4
+	if (P_UNLIKELY (pp_socket_set_fd_blocking (ret->fd, FALSE, error) == FALSE)) {
+		p_free (ret);
+		return NULL;
+	}
+#endif
+
+#if !defined (P_OS_WIN) && defined (SO_NOSIGPIPE)
+	flags = 1;
+
+	if (setsockopt (ret->fd, SOL_SOCKET, SO_NOSIGPIPE, &flags, sizeof (flags)) < 0)
+		P_WARNING ("PSocket::p_socket_new_accepted: setsockopt() with SO_NOSIGPIPE failed");
+#endif
+
+	ret->family    = socket->family;
+	ret->protocol  = socket->protocol;
+	ret->type      = socket->type;
+	ret->keepalive = socket->keepalive;
+	ret->connected = TRUE;
+	ret->timeout   = 0;
+	ret->blocking  = TRUE;
+
+	p_socket_set_listen_backlog (ret, P_SOCKET_DEFAULT_BACKLOG);
+
+#ifdef P_OS_SCO
+	if (P_UNLIKELY ((ret->timer = p_time_profiler_new ()) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for internal timer");
+		p_free (ret);
+		return NULL;
+	}
+#endif
+
+#ifdef P_OS_WIN
+	if (P_UNLIKELY ((ret->events = WSACreateEvent ()) == WSA_INVALID_EVENT)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_FAILED,
+				     (pint) p_error_get_last_net (),
+				     "Failed to call WSACreateEvent() on socket");
+		p_free (ret);
+		return NULL;
+	}
+#endif
 
 	return ret;
 }
 
-P_LIB_API pssize
-p_socket_receive (const PSocket	*socket,
-		  pchar		*buffer,
-		  psize		buflen,
-		  PError	**error)
+static PSocket *
+pp_socket_accept (const PSocket		*socket,
+		  struct sockaddr_storage	*buffer,
+		  socklen_t		*len,
+		  PError		**error)
 {
+	PSocket		*ret;
 	PErrorIO	sock_err;
-	pssize		ret;
+	pint		res;
 	pint		err_code;
 
-	if (P_UNLIKELY (socket == NULL || buffer == NULL)) {
+	if (P_UNLIKELY (socket == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
 				     "Invalid input argument");
-		return -1;
+		return NULL;
 	}
 
 	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
-		return -1;
+		return NULL;
 
 	for (;;) {
 		if (socket->blocking &&
 		    p_socket_io_condition_wait (socket,
 						P_SOCKET_IO_CONDITION_POLLIN,
 						error) == FALSE)
-			return -1;
-
-		if ((ret = recv (socket->fd, buffer, (socklen_t) buflen, 0)) < 0) {
-			err_code = p_error_get_last_net ();
+			return NULL;
 
-#if !defined (P_OS_WIN) && defined (EINTR)
-			if (err_code == EINTR)
-				continue;
-#endif
+		if ((res = pp_socket_accept_fd (socket, buffer, len, &err_code)) < 0) {
 			sock_err = p_error_get_io_from_system (err_code);
 
 			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
 				continue;
 
-			p_error_set_error_p (error,
-					     (pint) sock_err,
-					     err_code,
-					     "Failed to call recv() on socket");
+			p_error_set_error_static_p (error,
+						    (pint) sock_err,
+						    err_code,
+						    "Failed to call accept() on socket");
 
-			return -1;
+			return NULL;
 		}
 
 		break;
 	}
 
+	if (P_UNLIKELY ((ret = p_socket_new_accepted (socket, res, error)) == NULL)) {
+		if (P_UNLIKELY (p_sys_close (res) != 0))
+			P_WARNING ("PSocket::pp_socket_accept: p_sys_close() failed");
+	}
+
 	return ret;
 }
 
-P_LIB_API pssize
-p_socket_receive_from (const PSocket	*socket,
-		       PSocketAddress	**address,
+P_LIB_API PSocket *
+p_socket_accept (const PSocket	*socket,
+		 PError		**error)
+{
+	return pp_socket_accept (socket, NULL, NULL, error);
+}
+
+P_LIB_API PSocket *
+p_socket_accept_into (const PSocket		*socket,
+		      PSocketAddressStorage	*address,
+		      PError			**error)
+{
+	struct sockaddr_storage	buffer;
+	socklen_t		len;
+	PSocket			*ret;
+
+	if (P_UNLIKELY (address == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = pp_socket_accept (socket, &buffer, &len, error)) == NULL))
+		return NULL;
+
+	/* Some systems don't report an address for the accepted connection */
+	if (P_UNLIKELY (len == 0 || p_socket_address_init_from_native (address, &buffer, (psize) len) == NULL)) {
+		if (P_UNLIKELY (pp_socket_get_native_address (ret, TRUE, &buffer, &len, error) == FALSE)) {
+			p_socket_free (ret);
+			return NULL;
+		}
+
+		if (P_UNLIKELY (p_socket_address_init_from_native (address, &buffer, (psize) len) == NULL)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_FAILED,
+					     0,
+					     "Failed to get remote address of accepted socket");
+			p_socket_free (ret);
+			return NULL;
+		}
+	}
+
+	return ret;
+}
+
+P_LIB_API pint
+p_socket_accept_batch (const PSocket	*socket,
+		       PSocket		**sockets,
+		       pint		max,
+		       PError		**error)
+{
+	PErrorIO	sock_err;
+	pint		count;
+	pint		res;
+	pint		err_code;
+
+	if (P_UNLIKELY (socket == NULL || sockets == NULL || max <= 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return -1;
+
+	count = 0;
+
+	/* Try to accept before waiting, the queue is likely non-empty */
+	while (count < max) {
+		if ((res = pp_socket_accept_fd (socket, NULL, NULL, &err_code)) < 0) {
+			if (count > 0)
+				break;
+
+			sock_err = p_error_get_io_from_system (err_code);
+
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK) {
+				if (p_socket_io_condition_wait (socket,
+								P_SOCKET_IO_CONDITION_POLLIN,
+								error) == FALSE)
+					return -1;
+
+				continue;
+			}
+
+			p_error_set_error_static_p (error,
+						    (pint) sock_err,
+						    err_code,
+						    "Failed to call accept() on socket");
+			return -1;
+		}
+
+		if (P_UNLIKELY ((sockets[count] = p_socket_new_accepted (socket,
+									 res,
+									 count == 0 ? error : NULL)) == NULL)) {
+			if (P_UNLIKELY (p_sys_close (res) != 0))
+				P_WARNING ("PSocket::p_socket_accept_batch: p_sys_close() failed");
+
+			if (count == 0)
+				return -1;
+
+			break;
+		}
+
+		++count;
+	}
+
+	return count;
+}
+
+P_LIB_API pssize
+p_socket_receive (const PSocket	*socket,
+		  pchar		*buffer,
+		  psize		buflen,
+		  PError	**error)
+{
+	PErrorIO	sock_err;
+	pssize		ret;
+	pint		err_code;
+
+	if (P_UNLIKELY (socket == NULL || buffer == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return -1;
+
+	for (;;) {
+		if (socket->blocking &&
+		    p_socket_io_condition_wait (socket,
+						P_SOCKET_IO_CONDITION_POLLIN,
+						error) == FALSE)
+			return -1;
+
+		if ((ret = recv (socket->fd, buffer, (socklen_t) buflen, 0)) < 0) {
+			err_code = p_error_get_last_net ();
+
+#if !defined (P_OS_WIN) && defined (EINTR)
+			if (err_code == EINTR)
+				continue;
+#endif
+			sock_err = p_error_get_io_from_system (err_code);
+
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+				continue;
+
+			p_error_set_error_static_p (error,
+						    (pint) sock_err,
+						    err_code,
+						    "Failed to call recv() on socket");
+
+			return -1;
+		}
+
+		break;
+	}
+
+	return ret;
+}
+
+static pssize
+pp_socket_receive_from (const PSocket		*socket,
+			struct sockaddr_storage	*buffer,
+			socklen_t		*len,
+			pchar			*data,
+			psize			datalen,
+			PError			**error)
+{
+	PErrorIO	sock_err;
+	pssize		ret;
+	pint		err_code;
+
+	if (P_UNLIKELY (socket == NULL || data == NULL || datalen == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return -1;
+
+	for (;;) {
+		if (socket->blocking &&
+		    p_socket_io_condition_wait (socket,
+						P_SOCKET_IO_CONDITION_POLLIN,
+						error) == FALSE)
+			return -1;
+
+		*len = sizeof (struct sockaddr_storage);
+
+		if ((ret = recvfrom (socket->fd,
+				     data,
+				     (socklen_t) datalen,
+				     0,
+				     (struct sockaddr *) buffer,
+				     len)) < 0) {
+			err_code = p_error_get_last_net ();
+
+#if !defined (P_OS_WIN) && defined (EINTR)
+			if (err_code == EINTR)
+				continue;
+#endif
+			sock_err = p_error_get_io_from_system (err_code);
+
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+				continue;
+
+			p_error_set_error_static_p (error,
+						    (pint) sock_err,
+						    err_code,
+						    "Failed to call recvfrom() on socket");
+
+			return -1;
+		}
+
+		break;
+	}
+
+	return ret;
+}
+
+P_LIB_API pssize
+p_socket_receive_from (const PSocket	*socket,
+		       PSocketAddress	**address,
 		       pchar		*buffer,
 		       psize		buflen,
 		       PError		**error)
+{
+	struct sockaddr_storage sa;
+	socklen_t		optlen;
+	pssize			ret;
+
+	if ((ret = pp_socket_receive_from (socket, &sa, &optlen, buffer, buflen, error)) < 0)
+		return -1;
+
+	if (address != NULL)
+		*address = p_socket_address_new_from_native (&sa, optlen);
+
+	return ret;
+}
+
+P_LIB_API pssize
+p_socket_receive_from_into (const PSocket		*socket,
+			    PSocketAddressStorage	*address,
+			    pchar			*buffer,
+			    psize			buflen,
+			    PError			**error)
+{
+	struct sockaddr_storage sa;
+	socklen_t		optlen;
+	pssize			ret;
+
+	if ((ret = pp_socket_receive_from (socket, &sa, &optlen, buffer, buflen, error)) < 0)
+		return -1;
+
+	/* Connection-oriented sockets may not report the sender */
+	if (address != NULL && p_socket_address_init_from_native (address, &sa, optlen) == NULL)
+		memset (address, 0, sizeof (PSocketAddressStorage));
+
+	return ret;
+}
+
+P_LIB_API pssize
+p_socket_send (const PSocket	*socket,
+	       const pchar	*buffer,
+	       psize		buflen,
+	       PError		**error)
+{
+	PErrorIO	sock_err;
+	pssize		ret;
+	pint		err_code;
+
+	if (P_UNLIKELY (socket == NULL || buffer == NULL || buflen == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return -1;
+
+	for (;;) {
+		if (socket->blocking &&
+		    p_socket_io_condition_wait (socket,
+						P_SOCKET_IO_CONDITION_POLLOUT,
+						error) == FALSE)
+			return -1;
+
+		if ((ret = send (socket->fd,
+				 buffer,
+				 (socklen_t) buflen,
+				 P_SOCKET_DEFAULT_SEND_FLAGS)) < 0) {
+			err_code = p_error_get_last_net ();
+
+#if !defined (P_OS_WIN) && defined (EINTR)
+			if (err_code == EINTR)
+				continue;
+#endif
+			sock_err = p_error_get_io_from_system (err_code);
+
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+				continue;
+
+			p_error_set_error_static_p (error,
+						    (pint) sock_err,
+						    err_code,
+						    "Failed to call send() on socket");
+
+			return -1;
+		}
+
+		break;
+	}
+
+	return ret;
+}
+
+P_LIB_API pssize
+p_socket_receive_fds (const PSocket	*socket,
+		      pchar		*buffer,
+		      psize		buflen,
+		      pint		*fds,
+		      pint		*count,
+		      PError		**error)
+{
+#ifdef P_SOCKET_HAS_FD_PASSING
+	union {
+		struct cmsghdr	align;
+		pchar		buf[CMSG_SPACE (sizeof (pint) * P_SOCKET_MAX_PASSED_FDS)];
+	}			control;
+	struct msghdr		msg;
+	struct iovec		iov;
+	struct cmsghdr		*cmsg;
+	PErrorIO		sock_err;
+	pssize			ret;
+	pint			err_code;
+	pint			max_fds;
+	pint			num_fds;
+	pint			received;
+	pint			fd;
+	pint			flags;
+	pint			i;
+
+	if (P_UNLIKELY (socket == NULL || buffer == NULL || buflen == 0 ||
+			count == NULL || *count < 0 || (*count > 0 && fds == NULL))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (P_UNLIKELY (pp_socket_check_unix (socket, error) == FALSE))
+		return -1;
+
+	max_fds = *count > P_SOCKET_MAX_PASSED_FDS ? P_SOCKET_MAX_PASSED_FDS : *count;
+
+	for (;;) {
+		if (socket->blocking &&
+		    p_socket_io_condition_wait (socket,
+						P_SOCKET_IO_CONDITION_POLLIN,
+						error) == FALSE)
+			return -1;
+
+		memset (&msg, 0, sizeof (msg));
+		memset (&control, 0, sizeof (control));
+
+		iov.iov_base = buffer;
+		iov.iov_len  = buflen;
+
+		msg.msg_iov    = &iov;
+		msg.msg_iovlen = 1;
+
+		if (max_fds > 0) {
+			msg.msg_control    = control.buf;
+			msg.msg_controllen = CMSG_SPACE (sizeof (pint) * (psize) max_fds);
+		}
+
+#ifdef MSG_CMSG_CLOEXEC
+		ret = recvmsg (socket->fd, &msg, MSG_CMSG_CLOEXEC);
+#else
+		ret = recvmsg (socket->fd, &msg, 0);
+#endif
+
+		if (ret < 0) {
+			err_code = p_error_get_last_net ();
+
+#ifdef EINTR
+			if (err_code == EINTR)
+				continue;
+#endif
+			sock_err = p_error_get_io_from_system (err_code);
+
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+				continue;
+
+			p_error_set_error_static_p (error,
+						    (pint) sock_err,
+						    err_code,
+						    "Failed to call recvmsg() on socket");
+
+			return -1;
+		}
+
+		break;
+	}
+
+	received = 0;
+
+	for (cmsg = CMSG_FIRSTHDR (&msg); cmsg != NULL; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+		if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+			continue;
+
+		num_fds = (pint) ((cmsg->cmsg_len - CMSG_LEN (0)) / sizeof (pint));
+
+		for (i = 0; i < num_fds; ++i) {
+			memcpy (&fd, CMSG_DATA (cmsg) + i * sizeof (pint), sizeof (pint));
+
+			/* Should not happen as the control buffer is limited */
+			if (P_UNLIKELY (received == max_fds)) {
+				if (P_UNLIKELY (p_sys_close (fd) != 0))
+					P_WARNING ("PSocket::p_socket_receive_fds: p_sys_close() failed");
+
+				continue;
+			}
+
+#ifndef MSG_CMSG_CLOEXEC
+			flags = fcntl (fd, F_GETFD, 0);
+
+			if (P_LIKELY (flags != -1 && (flags & FD_CLOEXEC) == 0) &&
+			    P_UNLIKELY (fcntl (fd, F_SETFD, flags | FD_CLOEXEC) < 0))
+				P_WARNING ("PSocket::p_socket_receive_fds: fcntl() with FD_CLOEXEC failed");
+#else
+			P_UNUSED (flags);
+#endif
+			fds[received++] = fd;
+		}
+	}
+
+	*count = received;
+
+	return ret;
+#else
+	P_UNUSED (socket);
+	P_UNUSED (buffer);
+	P_UNUSED (buflen);
+	P_UNUSED (fds);
+	P_UNUSED (count);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Passing file descriptors is not supported on this platform");
+	return -1;
+#endif
+}
+
+P_LIB_API pssize
+p_socket_send_to (const PSocket		*socket,
+		  PSocketAddress	*address,
+		  const pchar		*buffer,
+		  psize			buflen,
+		  PError		**error)
 {
 	PErrorIO		sock_err;
 	struct sockaddr_storage sa;
@@ -1147,7 +2109,7 @@ p_socket_receive_from (const PSocket	*socket,
 	pssize			ret;
 	pint			err_code;
 
-	if (P_UNLIKELY (socket == NULL || buffer == NULL || buflen == 0)) {
+	if (!socket || !address || !buffer) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
@@ -1155,63 +2117,453 @@ p_socket_receive_from (const PSocket	*socket,
 		return -1;
 	}
 
-	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
-		return -1;
+	if (!pp_socket_check (socket, error))
+		return -1;
+
+	if (!p_socket_address_to_native (address, &sa, sizeof (sa))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_FAILED,
+				     0,
+				     "Failed to convert socket address to native structure");
+		return -1;
+	}
+
+	optlen = (socklen_t) p_socket_address_get_native_size (address);
+
+	for (;;) {
+		if (socket->blocking &&
+		    p_socket_io_condition_wait (socket, P_SOCKET_IO_CONDITION_POLLOUT, error) == FALSE)
+			return -1;
+
+		if ((ret = sendto (socket->fd,
+				   buffer,
+				   (socklen_t) buflen,
+				   0,
+				   (struct sockaddr *) &sa,
+				   optlen)) < 0) {
+			err_code = p_error_get_last_net ();
+
+#if !defined (P_OS_WIN) && defined (EINTR)
+			if (err_code == EINTR)
+				continue;
+#endif
+			sock_err = p_error_get_io_from_system (err_code);
+
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+				continue;
+
+			p_error_set_error_static_p (error,
+						    (pint) sock_err,
+						    err_code,
+						    "Failed to call sendto() on socket");
+
+			return -1;
+		}
+
+		break;
+	}
+
+	return ret;
+}
+
+P_LIB_API pssize
+p_socket_send_fds (const PSocket	*socket,
+		   const pchar		*buffer,
+		   psize		buflen,
+		   const pint		*fds,
+		   pint			count,
+		   PError		**error)
+{
+#ifdef P_SOCKET_HAS_FD_PASSING
+	union {
+		struct cmsghdr	align;
+		pchar		buf[CMSG_SPACE (sizeof (pint) * P_SOCKET_MAX_PASSED_FDS)];
+	}			control;
+	struct msghdr		msg;
+	struct iovec		iov;
+	struct cmsghdr		*cmsg;
+	PErrorIO		sock_err;
+	pssize			ret;
+	pint			err_code;
+
+	if (P_UNLIKELY (socket == NULL || buffer == NULL || buflen == 0 ||
+			count < 0 || count > P_SOCKET_MAX_PASSED_FDS ||
+			(count > 0 && fds == NULL))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (P_UNLIKELY (pp_socket_check_unix (socket, error) == FALSE))
+		return -1;
+
+	memset (&msg, 0, sizeof (msg));
+	memset (&control, 0, sizeof (control));
+
+	iov.iov_base = (ppointer) buffer;
+	iov.iov_len  = buflen;
+
+	msg.msg_iov    = &iov;
+	msg.msg_iovlen = 1;
+
+	if (count > 0) {
+		msg.msg_control    = control.buf;
+		msg.msg_controllen = CMSG_SPACE (sizeof (pint) * (psize) count);
+
+		cmsg = CMSG_FIRSTHDR (&msg);
+
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type  = SCM_RIGHTS;
+		cmsg->cmsg_len   = CMSG_LEN (sizeof (pint) * (psize) count);
+
+		memcpy (CMSG_DATA (cmsg), fds, sizeof (pint) * (psize) count);
+	}
+
+	for (;;) {
+		if (socket->blocking &&
+		    p_socket_io_condition_wait (socket,
+						P_SOCKET_IO_CONDITION_POLLOUT,
+						error) == FALSE)
+			return -1;
+
+		if ((ret = sendmsg (socket->fd, &msg, P_SOCKET_DEFAULT_SEND_FLAGS)) < 0) {
+			err_code = p_error_get_last_net ();
+
+#ifdef EINTR
+			if (err_code == EINTR)
+				continue;
+#endif
+			sock_err = p_error_get_io_from_system (err_code);
+
+			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+				continue;
+
+			p_error_set_error_static_p (error,
+						    (pint) sock_err,
+						    err_code,
+						    "Failed to call sendmsg() on socket");
+
+			return -1;
+		}
+
+		break;
+	}
+
+	return ret;
+#else
+	P_UNUSED (socket);
+	P_UNUSED (buffer);
+	P_UNUSED (buflen);
+	P_UNUSED (fds);
+	P_UNUSED (count);
+
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Passing file descriptors is not supported on this platform");
+	return -1;
+#endif
+}
+
+static pboolean
+pp_socket_get_option_native (PSocketOption	option,
+			     pint		*level,
+			     pint		*name)
+{
+	*level = IPPROTO_TCP;
+
+	switch (option) {
+#ifdef TCP_NODELAY
+	case P_SOCKET_OPTION_TCP_NODELAY:
+		*name = TCP_NODELAY;
+		return TRUE;
+#endif
+#if defined (TCP_CORK)
+	case P_SOCKET_OPTION_TCP_CORK:
+		*name = TCP_CORK;
+		return TRUE;
+#elif defined (TCP_NOPUSH)
+	case P_SOCKET_OPTION_TCP_CORK:
+		*name = TCP_NOPUSH;
+		return TRUE;
+#endif
+#ifdef TCP_QUICKACK
+	case P_SOCKET_OPTION_TCP_QUICKACK:
+		*name = TCP_QUICKACK;
+		return TRUE;
+#endif
+#ifdef TCP_FASTOPEN
+	case P_SOCKET_OPTION_TCP_FASTOPEN:
+		*name = TCP_FASTOPEN;
+		return TRUE;
+#endif
+#ifdef TCP_FASTOPEN_CONNECT
+	case P_SOCKET_OPTION_TCP_FASTOPEN_CONNECT:
+		*name = TCP_FASTOPEN_CONNECT;
+		return TRUE;
+#endif
+#ifdef TCP_DEFER_ACCEPT
+	case P_SOCKET_OPTION_TCP_DEFER_ACCEPT:
+		*name = TCP_DEFER_ACCEPT;
+		return TRUE;
+#endif
+#ifdef SO_BUSY_POLL
+	case P_SOCKET_OPTION_BUSY_POLL:
+		*level = SOL_SOCKET;
+		*name  = SO_BUSY_POLL;
+		return TRUE;
+#endif
+#ifdef SO_REUSEPORT
+	case P_SOCKET_OPTION_REUSE_PORT:
+		*level = SOL_SOCKET;
+		*name  = SO_REUSEPORT;
+		return TRUE;
+#endif
+	default:
+		return FALSE;
+	}
+}
+
+static pssize
+pp_socket_read_file (pint	fd,
+		     pchar	*buffer,
+		     psize	length,
+		     puint64	offset,
+		     pint	*err_code)
+{
+#ifdef P_OS_WIN
+	OVERLAPPED	overlapped;
+	HANDLE		file_hdl;
+	DWORD		read_bytes;
+
+	if ((file_hdl = (HANDLE) _get_osfhandle (fd)) == INVALID_HANDLE_VALUE) {
+		*err_code = p_error_get_last_system ();
+		return -1;
+	}
+
+	memset (&overlapped, 0, sizeof (overlapped));
+
+	overlapped.Offset     = (DWORD) (offset & 0xFFFFFFFF);
+	overlapped.OffsetHigh = (DWORD) (offset >> 32);
+
+	if (!ReadFile (file_hdl, buffer, (DWORD) length, &read_bytes, &overlapped)) {
+		if (GetLastError () == ERROR_HANDLE_EOF)
+			return 0;
+
+		*err_code = p_error_get_last_system ();
+		return -1;
+	}
+
+	return (pssize) read_bytes;
+#else
+	pssize ret;
+
+	if ((off_t) offset < 0 || (puint64) (off_t) offset != offset) {
+		*err_code = EINVAL;
+		return -1;
+	}
+
+	if ((ret = pread (fd, buffer, length, (off_t) offset)) < 0)
+		*err_code = p_error_get_last_system ();
+
+	return ret;
+#endif
+}
+
+static pssize
+pp_socket_send_file_chunk (const PSocket		*socket,
+			   PSocketSendFileMethod	method,
+			   pint				fd,
+			   const pchar			*data,
+			   pchar			*buffer,
+			   puint64			offset,
+			   psize			length,
+			   pint				*err_code)
+{
+#ifdef PLIBSYS_HAS_SENDFILE
+	off_t	file_offset;
+#endif
+	pssize	ret;
+
+	switch (method) {
+	case P_SOCKET_SEND_FILE_METHOD_MEMORY:
+		if ((ret = send (socket->fd,
+				 data + offset,
+				 (socklen_t) length,
+				 P_SOCKET_DEFAULT_SEND_FLAGS)) < 0)
+			*err_code = p_error_get_last_net ();
+
+		return ret;
+#ifdef PLIBSYS_HAS_SENDFILE
+	case P_SOCKET_SEND_FILE_METHOD_SENDFILE:
+		file_offset = (off_t) offset;
+
+		if (file_offset < 0 || (puint64) file_offset != offset) {
+			*err_code = EINVAL;
+			return -1;
+		}
+
+		if ((ret = sendfile (socket->fd, fd, &file_offset, length)) < 0)
+			*err_code = p_error_get_last_net ();
+
+		return ret;
+#endif
+#ifdef PLIBSYS_HAS_SPLICE
+	case P_SOCKET_SEND_FILE_METHOD_SPLICE:
+		if ((ret = splice (fd,
+				   NULL,
+				   socket->fd,
+				   NULL,
+				   length,
+				   SPLICE_F_MOVE | (socket->blocking ? 0 : SPLICE_F_NONBLOCK))) < 0)
+			*err_code = p_error_get_last_net ();
+
+		return ret;
+#endif
+	default:
+		if ((ret = pp_socket_read_file (fd,
+						buffer,
+						length < P_SOCKET_SEND_FILE_BUFFER_SIZE ? length : P_SOCKET_SEND_FILE_BUFFER_SIZE,
+						offset,
+						err_code)) <= 0)
+			return ret;
+
+		/* Not sent part of the buffer will be read once again on the next call */
+		if ((ret = send (socket->fd,
+				 buffer,
+				 (socklen_t) ret,
+				 P_SOCKET_DEFAULT_SEND_FLAGS)) < 0)
+			*err_code = p_error_get_last_net ();
+
+		return ret;
+	}
+}
+
+static pssize
+pp_socket_send_file_data (const PSocket	*socket,
+			  pint		fd,
+			  const pchar	*data,
+			  puint64	offset,
+			  psize		length,
+			  PError	**error)
+{
+	PSocketSendFileMethod	method;
+	PErrorIO		sock_err;
+	pchar			*buffer = NULL;
+	psize			sent    = 0;
+	psize			chunk;
+	pssize			ret;
+	pint			err_code;
+#ifdef PLIBSYS_HAS_SENDFILE
+	struct stat		file_stat;
+#endif
+
+	if (data != NULL)
+		method = P_SOCKET_SEND_FILE_METHOD_MEMORY;
+	else {
+#ifdef PLIBSYS_HAS_SENDFILE
+		method = P_SOCKET_SEND_FILE_METHOD_SENDFILE;
+#else
+		method = P_SOCKET_SEND_FILE_METHOD_COPY;
+#endif
+	}
+
+	while (sent < length) {
+		chunk = length - sent < P_SOCKET_SEND_FILE_MAX_CHUNK ? length - sent : P_SOCKET_SEND_FILE_MAX_CHUNK;
 
-	optlen = sizeof (sa);
+		if (method == P_SOCKET_SEND_FILE_METHOD_COPY && buffer == NULL &&
+		    P_UNLIKELY ((buffer = p_malloc (P_SOCKET_SEND_FILE_BUFFER_SIZE)) == NULL)) {
+			if (sent > 0)
+				break;
+
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for file data buffer");
+			return -1;
+		}
 
-	for (;;) {
 		if (socket->blocking &&
 		    p_socket_io_condition_wait (socket,
-						P_SOCKET_IO_CONDITION_POLLIN,
-						error) == FALSE)
+						P_SOCKET_IO_CONDITION_POLLOUT,
+						sent > 0 ? NULL : error) == FALSE) {
+			if (sent > 0)
+				break;
+
+			p_free (buffer);
 			return -1;
+		}
 
-		if ((ret = recvfrom (socket->fd,
-				     buffer,
-				     (socklen_t) buflen,
-				     0,
-				     (struct sockaddr *) &sa,
-				     &optlen)) < 0) {
-			err_code = p_error_get_last_net ();
+		err_code = 0;
+
+		if ((ret = pp_socket_send_file_chunk (socket,
+						      method,
+						      fd,
+						      data,
+						      buffer,
+						      offset + sent,
+						      chunk,
+						      &err_code)) == 0)
+			break;
+
+		if (ret > 0) {
+			sent += (psize) ret;
+			continue;
+		}
 
 #if !defined (P_OS_WIN) && defined (EINTR)
-			if (err_code == EINTR)
-				continue;
+		if (err_code == EINTR)
+			continue;
 #endif
-			sock_err = p_error_get_io_from_system (err_code);
-
-			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
-				continue;
 
-			p_error_set_error_p (error,
-					     (pint) sock_err,
-					     err_code,
-					     "Failed to call recvfrom() on socket");
+#ifdef PLIBSYS_HAS_SENDFILE
+		/* Not every file type supports sendfile(), use the fallback then */
+		if (method == P_SOCKET_SEND_FILE_METHOD_SENDFILE &&
+		    (err_code == EINVAL || err_code == ENOSYS || err_code == ESPIPE)) {
+			method = P_SOCKET_SEND_FILE_METHOD_COPY;
 
-			return -1;
+#  ifdef PLIBSYS_HAS_SPLICE
+			/* Pipes can't be read at an offset, but can be spliced */
+			if (offset == 0 && fstat (fd, &file_stat) == 0 && S_ISFIFO (file_stat.st_mode))
+				method = P_SOCKET_SEND_FILE_METHOD_SPLICE;
+#  endif
+			continue;
 		}
+#endif
 
-		break;
+		sock_err = p_error_get_io_from_system (err_code);
+
+		if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
+			continue;
+
+		/* The error will be reported on the next call */
+		if (sent > 0)
+			break;
+
+		p_error_set_error_p (error,
+				     (pint) sock_err,
+				     err_code,
+				     "Failed to send file data through socket");
+
+		p_free (buffer);
+		return -1;
 	}
 
-	if (address != NULL)
-		*address = p_socket_address_new_from_native (&sa, optlen);
+	p_free (buffer);
 
-	return ret;
+	return (pssize) sent;
 }
 
 P_LIB_API pssize
-p_socket_send (const PSocket	*socket,
-	       const pchar	*buffer,
-	       psize		buflen,
-	       PError		**error)
+p_socket_send_file (const PSocket	*socket,
+		    pint		fd,
+		    puint64		offset,
+		    psize		length,
+		    PError		**error)
 {
-	PErrorIO	sock_err;
-	pssize		ret;
-	pint		err_code;
-
-	if (P_UNLIKELY (socket == NULL || buffer == NULL || buflen == 0)) {
+	if (P_UNLIKELY (socket == NULL || fd < 0 || length == 0)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
@@ -1222,56 +2574,20 @@ p_socket_send (const PSocket	*socket,
 	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
 		return -1;
 
-	for (;;) {
-		if (socket->blocking &&
-		    p_socket_io_condition_wait (socket,
-						P_SOCKET_IO_CONDITION_POLLOUT,
-						error) == FALSE)
-			return -1;
-
-		if ((ret = send (socket->fd,
-				 buffer,
-				 (socklen_t) buflen,
-				 P_SOCKET_DEFAULT_SEND_FLAGS)) < 0) {
-			err_code = p_error_get_last_net ();
-
-#if !defined (P_OS_WIN) && defined (EINTR)
-			if (err_code == EINTR)
-				continue;
-#endif
-			sock_err = p_error_get_io_from_system (err_code);
-
-			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
-				continue;
-
-			p_error_set_error_p (error,
-					     (pint) sock_err,
-					     err_code,
-					     "Failed to call send() on socket");
-
-			return -1;
-		}
-
-		break;
-	}
-
-	return ret;
+	return pp_socket_send_file_data (socket, fd, NULL, offset, length, error);
 }
 
 P_LIB_API pssize
-p_socket_send_to (const PSocket		*socket,
-		  PSocketAddress	*address,
-		  const pchar		*buffer,
-		  psize			buflen,
-		  PError		**error)
+p_socket_send_mapped_file (const PSocket	*socket,
+			   const PMappedFile	*file,
+			   psize		offset,
+			   psize		length,
+			   PError		**error)
 {
-	PErrorIO		sock_err;
-	struct sockaddr_storage sa;
-	socklen_t		optlen;
-	pssize			ret;
-	pint			err_code;
+	const pchar	*data;
+	psize		size;
 
-	if (!socket || !address || !buffer) {
+	if (P_UNLIKELY (socket == NULL || file == NULL)) {
 		p_error_set_error_p (error,
 				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
@@ -1279,53 +2595,24 @@ p_socket_send_to (const PSocket		*socket,
 		return -1;
 	}
 
-	if (!pp_socket_check (socket, error))
-		return -1;
+	data = (const pchar *) p_mapped_file_get_address (file);
+	size = p_mapped_file_get_size (file);
 
-	if (!p_socket_address_to_native (address, &sa, sizeof (sa))) {
+	if (length == 0 && offset < size)
+		length = size - offset;
+
+	if (P_UNLIKELY (data == NULL || length == 0 || offset > size || length > size - offset)) {
 		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_FAILED,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
 				     0,
-				     "Failed to convert socket address to native structure");
+				     "Invalid mapped file range");
 		return -1;
 	}
 
-	optlen = (socklen_t) p_socket_address_get_native_size (address);
-
-	for (;;) {
-		if (socket->blocking &&
-		    p_socket_io_condition_wait (socket, P_SOCKET_IO_CONDITION_POLLOUT, error) == FALSE)
-			return -1;
-
-		if ((ret = sendto (socket->fd,
-				   buffer,
-				   (socklen_t) buflen,
-				   0,
-				   (struct sockaddr *) &sa,
-				   optlen)) < 0) {
-			err_code = p_error_get_last_net ();
-
-#if !defined (P_OS_WIN) && defined (EINTR)
-			if (err_code == EINTR)
-				continue;
-#endif
-			sock_err = p_error_get_io_from_system (err_code);
-
-			if (socket->blocking && sock_err == P_ERROR_IO_WOULD_BLOCK)
-				continue;
-
-			p_error_set_error_p (error,
-					     (pint) sock_err,
-					     err_code,
-					     "Failed to call sendto() on socket");
-
-			return -1;
-		}
-
-		break;
-	}
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return -1;
 
-	return ret;
+	return pp_socket_send_file_data (socket, -1, data, (puint64) offset, length, error);
 }
 
 P_LIB_API pboolean
@@ -1475,6 +2762,178 @@ p_socket_set_buffer_size (const PSocket		*socket,
 	return TRUE;
 }
 
+P_LIB_API pboolean
+p_socket_set_option (const PSocket	*socket,
+		     PSocketOption	option,
+		     pint		value,
+		     PError		**error)
+{
+	pint	level;
+	pint	name;
+
+	if (P_UNLIKELY (socket == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return FALSE;
+
+	if (P_UNLIKELY (pp_socket_get_option_native (option, &level, &name) == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_SUPPORTED,
+				     0,
+				     "Socket option is not supported");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (setsockopt (socket->fd,
+				    level,
+				    name,
+				    (pconstpointer) &value,
+				    sizeof (value)) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
+				     (pint) p_error_get_last_net (),
+				     "Failed to call setsockopt() on socket to set option");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_socket_get_option (const PSocket	*socket,
+		     PSocketOption	option,
+		     pint		*value,
+		     PError		**error)
+{
+	socklen_t	optlen;
+	pint		level;
+	pint		name;
+	pint		optval = 0;
+
+	if (P_UNLIKELY (socket == NULL || value == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return FALSE;
+
+	if (P_UNLIKELY (pp_socket_get_option_native (option, &level, &name) == FALSE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_SUPPORTED,
+				     0,
+				     "Socket option is not supported");
+		return FALSE;
+	}
+
+	optlen = sizeof (optval);
+
+	if (P_UNLIKELY (getsockopt (socket->fd,
+				    level,
+				    name,
+				    (ppointer) &optval,
+				    &optlen) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
+				     (pint) p_error_get_last_net (),
+				     "Failed to call getsockopt() on socket to get option");
+		return FALSE;
+	}
+
+	/* Some systems report boolean options as arbitrary non-zero values */
+	switch (option) {
+	case P_SOCKET_OPTION_TCP_NODELAY:
+	case P_SOCKET_OPTION_TCP_CORK:
+	case P_SOCKET_OPTION_TCP_QUICKACK:
+	case P_SOCKET_OPTION_TCP_FASTOPEN_CONNECT:
+	case P_SOCKET_OPTION_REUSE_PORT:
+		optval = !!optval;
+		break;
+	default:
+		break;
+	}
+
+	*value = optval;
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_socket_is_option_supported (PSocketOption option)
+{
+	pint	level;
+	pint	name;
+
+	return pp_socket_get_option_native (option, &level, &name);
+}
+
+P_LIB_API pboolean
+p_socket_get_tcp_info (const PSocket	*socket,
+		       PSocketTcpInfo	*info,
+		       PError		**error)
+{
+#ifdef PLIBSYS_HAS_TCP_INFO
+	struct tcp_info	tcp_info;
+	socklen_t	optlen;
+#endif
+
+	if (P_UNLIKELY (socket == NULL || info == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (pp_socket_check (socket, error) == FALSE))
+		return FALSE;
+
+#ifdef PLIBSYS_HAS_TCP_INFO
+	memset (&tcp_info, 0, sizeof (tcp_info));
+	optlen = sizeof (tcp_info);
+
+	if (P_UNLIKELY (getsockopt (socket->fd,
+				    IPPROTO_TCP,
+				    TCP_INFO,
+				    (ppointer) &tcp_info,
+				    &optlen) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (p_error_get_last_net ()),
+				     (pint) p_error_get_last_net (),
+				     "Failed to call getsockopt() on socket to get TCP info");
+		return FALSE;
+	}
+
+	info->rtt           = (puint32) tcp_info.tcpi_rtt;
+	info->rtt_var       = (puint32) tcp_info.tcpi_rttvar;
+	info->snd_cwnd      = (puint32) tcp_info.tcpi_snd_cwnd;
+	info->snd_ssthresh  = (puint32) tcp_info.tcpi_snd_ssthresh;
+	info->snd_mss       = (puint32) tcp_info.tcpi_snd_mss;
+	info->rcv_mss       = (puint32) tcp_info.tcpi_rcv_mss;
+	info->unacked       = (puint32) tcp_info.tcpi_unacked;
+	info->lost          = (puint32) tcp_info.tcpi_lost;
+	info->retransmits   = (puint32) tcp_info.tcpi_retransmits;
+	info->total_retrans = (puint32) tcp_info.tcpi_total_retrans;
+
+	return TRUE;
+#else
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "TCP info is not supported on this platform");
+	return FALSE;
+#endif
+}
+
 P_LIB_API pboolean
 p_socket_io_condition_wait (const PSocket	*socket,
 			    PSocketIOCondition	condition,
@@ -1511,10 +2970,10 @@ p_socket_io_condition_wait (const PSocket	*socket,
 	if (evret == WSA_WAIT_EVENT_0)
 		return TRUE;
 	else if (evret == WSA_WAIT_TIMEOUT) {
-		p_error_set_error_p (error,
-				     (pint) P_ERROR_IO_TIMED_OUT,
-				     (pint) p_error_get_last_net (),
-				     "Timed out while waiting socket condition");
+		p_error_set_error_static_p (error,
+					    (pint) P_ERROR_IO_TIMED_OUT,
+					    (pint) p_error_get_last_net (),
+					    "Timed out while waiting socket condition");
 		return FALSE;
 	} else {
 		p_error_set_error_p (error,
@@ -1573,10 +3032,10 @@ p_socket_io_condition_wait (const PSocket	*socket,
 		if (evret == 1)
 			return TRUE;
 		else if (evret == 0) {
-			p_error_set_error_p (error,
-					     (pint) P_ERROR_IO_TIMED_OUT,
-					     (pint) p_error_get_last_net (),
-					     "Timed out while waiting socket condition");
+			p_error_set_error_static_p (error,
+						    (pint) P_ERROR_IO_TIMED_OUT,
+						    (pint) p_error_get_last_net (),
+						    "Timed out while waiting socket condition");
 			return FALSE;
 		} else {
 			p_error_set_error_p (error,
@@ -1630,10 +3089,10 @@ p_socket_io_condition_wait (const PSocket	*socket,
 		if (evret == 1)
 			return TRUE;
 		else if (evret == 0) {
-			p_error_set_error_p (error,
-					     (pint) P_ERROR_IO_TIMED_OUT,
-					     (pint) p_error_get_last_net (),
-					     "Timed out while waiting socket condition");
+			p_error_set_error_static_p (error,
+						    (pint) P_ERROR_IO_TIMED_OUT,
+						    (pint) p_error_get_last_net (),
+						    "Timed out while waiting socket condition");
 			return FALSE;
 		} else {
 			p_error_set_error_p (error,
@@ -103,6 +103,23 @@
  * The close-on-exec flag is always set on the socket desciptor. Use
  * p_socket_get_fd() to overwrite this behavior.
  *
+ * To serve file contents through a socket use p_socket_send_file(): it lets
+ * the operating system move the data from a file to the socket directly
+ * (using sendfile() or splice() when available), avoiding copying it through
+ * user space buffers. Data from a #PMappedFile can be sent with
+ * p_socket_send_mapped_file().
+ *
+ * Low level tuning options, like TCP_NODELAY or TCP_CORK, can be changed with
+ * p_socket_set_option(), and p_socket_get_tcp_info() gives a snapshot of a TCP
+ * connection state (round trip time, congestion window, retransmits).
+ *
+ * Unix domain sockets (#P_SOCKET_FAMILY_UNIX) are a cheaper transport than
+ * TCP loopback for communication between processes on the same host. They use
+ * addresses created with p_socket_address_new_unix() and the default protocol.
+ * A connected pair of such sockets is created at once with p_socket_new_pair(),
+ * and a file descriptor (i.e. an accepted connection) can be passed to another
+ * process with p_socket_send_fds() and p_socket_receive_fds().
+ *
  * #PSocket ignores the SIGPIPE signal on UNIX systems if possible. Take it into
  * account if you want to handle this signal.
  *
@@ -155,9 +172,13 @@
 #include <pmacros.h>
 #include <psocketaddress.h>
 #include <perror.h>
+#include <pfile.h>
 
 P_BEGIN_DECLS
 
+/** Maximum number of file descriptors passed with a single message. */
+#define P_SOCKET_MAX_PASSED_FDS		64
+
 /** Socket protocols specified by the IANA.  */
 typedef enum PSocketProtocol_ {
 	P_SOCKET_PROTOCOL_UNKNOWN	= -1,	/**< Unknown protocol.	*/
@@ -187,6 +208,38 @@ typedef enum PSocketIOCondition_ {
 	P_SOCKET_IO_CONDITION_POLLOUT	= 2	/**< Ready to write.	*/
 } PSocketIOCondition;
 
+/** Socket options for fine tuning, see p_socket_set_option(). */
+typedef enum PSocketOption_ {
+	P_SOCKET_OPTION_TCP_NODELAY		= 0,	/**< Disable Nagle's algorithm (TCP_NODELAY), boolean.		*/
+	P_SOCKET_OPTION_TCP_CORK		= 1,	/**< Hold partial frames until uncorked (TCP_CORK or
+							     TCP_NOPUSH), boolean.					*/
+	P_SOCKET_OPTION_TCP_QUICKACK		= 2,	/**< Send ACKs immediately (TCP_QUICKACK), boolean.		*/
+	P_SOCKET_OPTION_TCP_FASTOPEN		= 3,	/**< Accept TCP Fast Open connections on a listening socket
+							     (TCP_FASTOPEN), pending requests queue length.		*/
+	P_SOCKET_OPTION_TCP_FASTOPEN_CONNECT	= 4,	/**< Use TCP Fast Open to connect (TCP_FASTOPEN_CONNECT),
+							     boolean.							*/
+	P_SOCKET_OPTION_TCP_DEFER_ACCEPT	= 5,	/**< Accept a connection only when data arrives
+							     (TCP_DEFER_ACCEPT), timeout in seconds.			*/
+	P_SOCKET_OPTION_BUSY_POLL		= 6,	/**< Busy poll the device queue on receive (SO_BUSY_POLL),
+							     time in microseconds.					*/
+	P_SOCKET_OPTION_REUSE_PORT		= 7	/**< Allow several sockets to bind the same address and port
+							     (SO_REUSEPORT), boolean.					*/
+} PSocketOption;
+
+/** TCP connection state snapshot, see p_socket_get_tcp_info(). */
+typedef struct PSocketTcpInfo_ {
+	puint32	rtt;		/**< Smoothed round trip time, in microseconds.		*/
+	puint32	rtt_var;	/**< Round trip time variance, in microseconds.		*/
+	puint32	snd_cwnd;	/**< Congestion window, in segments.			*/
+	puint32	snd_ssthresh;	/**< Slow start threshold, in segments.			*/
+	puint32	snd_mss;	/**< Maximal segment size to send, in bytes.		*/
+	puint32	rcv_mss;	/**< Maximal segment size to receive, in bytes.		*/
+	puint32	unacked;	/**< Number of sent but not acknowledged segments.	*/
+	puint32	lost;		/**< Number of segments considered as lost.		*/
+	puint32	retransmits;	/**< Number of retransmits of the current segment.	*/
+	puint32	total_retrans;	/**< Total number of retransmitted segments.		*/
+} PSocketTcpInfo;
+
 /** Socket opaque structure. */
 typedef struct PSocket_ PSocket;
 
@@ -230,6 +283,28 @@ P_LIB_API PSocket *		p_socket_new 			(PSocketFamily		family,
 								 PSocketProtocol	protocol,
 								 PError			**error);
 
+/**
+ * @brief Creates a pair of connected Unix domain sockets.
+ * @param type Socket type.
+ * @param[out] first Pointer to store the first socket in.
+ * @param[out] second Pointer to store the second socket in.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ * @sa p_socket_send_fds(), p_socket_receive_fds()
+ *
+ * The sockets are unnamed and connected to each other, data sent to one of
+ * them is received from another one. The pair is usually created before
+ * starting a child process which inherits one of the sockets (use
+ * p_socket_get_fd() and clear the close-on-exec flag for it).
+ *
+ * Not supported on Windows, see p_socket_address_is_unix_supported().
+ */
+P_LIB_API pboolean		p_socket_new_pair		(PSocketType		type,
+								 PSocket		**first,
+								 PSocket		**second,
+								 PError			**error);
+
 /**
  * @brief Gets an underlying file descriptor of a @a socket.
  * @param socket #PSocket to get the file descriptor for.
@@ -363,6 +438,19 @@ P_LIB_API pint			p_socket_get_timeout		(const PSocket		*socket);
 P_LIB_API PSocketAddress *	p_socket_get_local_address	(const PSocket 		*socket,
 								 PError			**error);
 
+/**
+ * @brief Gets a @a socket local (bound) address without allocating memory.
+ * @param socket #PSocket to get the local address for.
+ * @param[out] address Storage to put the local address into.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ * @sa p_socket_get_local_address(), p_socket_address_from_storage()
+ */
+P_LIB_API pboolean		p_socket_get_local_address_into	(const PSocket		*socket,
+								 PSocketAddressStorage	*address,
+								 PError			**error);
+
 /**
  * @brief Gets a @a socket remote endpoint address.
  * @param socket #PSocket to get the remote endpoint address for.
@@ -381,6 +469,19 @@ P_LIB_API PSocketAddress *	p_socket_get_local_address	(const PSocket 		*socket,
 P_LIB_API PSocketAddress *	p_socket_get_remote_address	(const PSocket 		*socket,
 								 PError			**error);
 
+/**
+ * @brief Gets a @a socket remote endpoint address without allocating memory.
+ * @param socket #PSocket to get the remote endpoint address for.
+ * @param[out] address Storage to put the remote address into.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ * @sa p_socket_get_remote_address(), p_socket_address_from_storage()
+ */
+P_LIB_API pboolean		p_socket_get_remote_address_into	(const PSocket		*socket,
+									 PSocketAddressStorage	*address,
+									 PError			**error);
+
 /**
  * @brief Checks whether a @a socket is connected.
  * @param socket #PSocket to check a connection for.
@@ -567,6 +668,37 @@ P_LIB_API pboolean		p_socket_connect		(PSocket		*socket,
 								 PSocketAddress		*address,
 								 PError			**error);
 
+/**
+ * @brief Connects several sockets to a given remote address in parallel.
+ * @param sockets Array of stream sockets to connect.
+ * @param count Number of sockets in the @a sockets array.
+ * @param address #PSocketAddress to connect the sockets to.
+ * @param timeout Maximum time to wait for the connections, in milliseconds, 0
+ * to wait until all the connection attempts complete.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of the connected sockets in case of success, -1 otherwise.
+ * @since 0.0.6
+ * @sa p_socket_connect(), p_socket_is_connected()
+ *
+ * Connecting sockets one by one takes a round trip per connection, which adds
+ * up when a whole pool of connections must be (re-)established at once, i.e.
+ * after a server failover. This call starts connecting all the @a sockets
+ * without waiting, and then waits for all the pending connections at once, so
+ * it takes about a single round trip regardless of the @a count. The sockets'
+ * blocking mode and timeouts are not used.
+ *
+ * A connection failure doesn't fail the whole call, use p_socket_is_connected()
+ * to find out which of the @a sockets were connected. The sockets which were
+ * not connected in time or failed to connect should be freed, they can't be
+ * connected again. The call fails only if the arguments are invalid or waiting
+ * for the connections is impossible.
+ */
+P_LIB_API pint			p_socket_connect_batch		(PSocket		**sockets,
+								 pint			count,
+								 PSocketAddress		*address,
+								 pint			timeout,
+								 PError			**error);
+
 /**
  * @brief Puts a @a socket into a listening state.
  * @param socket #PSocket to start listening.
@@ -599,10 +731,61 @@ P_LIB_API pboolean		p_socket_listen			(PSocket 		*socket,
  * This call has meaning only for connection oriented sockets. The socket can
  * accept new incoming connections only after calling p_socket_bind() and
  * p_socket_listen().
+ *
+ * Since 0.0.6 the accepted socket details are taken from the listening
+ * @a socket, and where possible the accepted socket is created in the
+ * non-blocking mode with the close-on-exec flag by a single system call.
  */
 P_LIB_API PSocket *		p_socket_accept			(const PSocket		*socket,
 								 PError			**error);
 
+/**
+ * @brief Accepts a @a socket incoming connection and saves a remote address.
+ * @param socket #PSocket to accept the incoming connection from.
+ * @param[out] address Storage to put the remote address of the accepted
+ * connection into.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return New #PSocket with the accepted connection in case of success, NULL
+ * otherwise.
+ * @since 0.0.6
+ * @sa p_socket_accept(), p_socket_address_from_storage()
+ *
+ * The remote address is taken from the accept() call itself, so no additional
+ * system call or memory allocation is required to get it.
+ */
+P_LIB_API PSocket *		p_socket_accept_into		(const PSocket		*socket,
+								 PSocketAddressStorage	*address,
+								 PError			**error);
+
+/**
+ * @brief Accepts several pending @a socket incoming connections at once.
+ * @param socket #PSocket to accept the incoming connections from.
+ * @param[out] sockets Array to put the accepted connections into.
+ * @param max Maximum number of connections to accept, the size of the
+ * @a sockets array.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of the accepted connections in case of success, -1 otherwise.
+ * @since 0.0.6
+ * @sa p_socket_accept()
+ *
+ * If the @a socket is in a blocking mode, the call waits for the first
+ * incoming connection using the @a socket timeout. After that it doesn't
+ * block anymore: all the connections already pending are accepted, up to
+ * @a max. A non-blocking @a socket fails with #P_ERROR_IO_WOULD_BLOCK if there
+ * are no pending connections.
+ *
+ * Use it to drain the accept queue after a wake up: unlike calling
+ * p_socket_accept() in a loop, the @a socket readiness is waited for only
+ * once, and the call returns as soon as the queue is empty.
+ *
+ * If an error occurs after some connections were accepted, the accepted
+ * connections are returned and the error is reported by the next call.
+ */
+P_LIB_API pint			p_socket_accept_batch		(const PSocket		*socket,
+								 PSocket		**sockets,
+								 pint			max,
+								 PError			**error);
+
 /**
  * @brief Receives data from a given @a socket.
  * @param socket #PSocket to receive data from.
@@ -653,6 +836,29 @@ P_LIB_API pssize		p_socket_receive_from		(const PSocket 		*socket,
 								 psize			buflen,
 								 PError			**error);
 
+/**
+ * @brief Receives data from a given @a socket and saves a remote address into
+ * a caller-owned storage.
+ * @param socket #PSocket to receive data from.
+ * @param[out] address Storage to put the remote address into, may be NULL.
+ * @param buffer Buffer to write received data in.
+ * @param buflen Length of @a buffer.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of written data in case of success, -1 otherwise.
+ * @since 0.0.6
+ * @sa p_socket_receive_from(), p_socket_address_from_storage()
+ *
+ * Works the same way as p_socket_receive_from() but doesn't allocate memory,
+ * so it's suitable for a per-datagram receive loop. If the system doesn't
+ * report the sender address, the @a address family is set to
+ * #P_SOCKET_FAMILY_UNKNOWN.
+ */
+P_LIB_API pssize		p_socket_receive_from_into	(const PSocket		*socket,
+								 PSocketAddressStorage	*address,
+								 pchar			*buffer,
+								 psize			buflen,
+								 PError			**error);
+
 /**
  * @brief Sends data through a given @a socket.
  * @param socket #PSocket to send data through.
@@ -698,6 +904,126 @@ P_LIB_API pssize		p_socket_send_to		(const PSocket		*socket,
 								 psize			buflen,
 								 PError			**error);
 
+/**
+ * @brief Sends data along with file descriptors through a Unix domain socket.
+ * @param socket Connected #P_SOCKET_FAMILY_UNIX socket to send data through.
+ * @param buffer Buffer with data to send.
+ * @param buflen Length of @a buffer, must not be 0.
+ * @param fds File descriptors to pass, may be NULL if the @a count is 0.
+ * @param count Number of file descriptors in the @a fds, up to
+ * #P_SOCKET_MAX_PASSED_FDS.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of sent data in case of success, -1 otherwise.
+ * @note If the @a socket is in a blocking mode, then the caller will be blocked
+ * until data sent.
+ * @since 0.0.6
+ * @sa p_socket_receive_fds(), p_socket_new_pair()
+ *
+ * The descriptors are duplicated into the receiving process (SCM_RIGHTS), so
+ * the sender may close its copies right after the call. At least one byte of
+ * data is always sent with the descriptors as they can't be passed alone.
+ *
+ * Not supported on Windows, see p_socket_address_is_unix_supported().
+ */
+P_LIB_API pssize		p_socket_send_fds		(const PSocket		*socket,
+								 const pchar		*buffer,
+								 psize			buflen,
+								 const pint		*fds,
+								 pint			count,
+								 PError			**error);
+
+/**
+ * @brief Receives data along with file descriptors from a Unix domain socket.
+ * @param socket Connected #P_SOCKET_FAMILY_UNIX socket to receive data from.
+ * @param buffer Buffer to write received data in.
+ * @param buflen Length of @a buffer, must not be 0.
+ * @param[out] fds Array to store received file descriptors in, may be NULL if
+ * @a count points to 0.
+ * @param[in,out] count Size of the @a fds array on input, number of received
+ * file descriptors on output.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of written data in case of success, -1 otherwise.
+ * @note If the @a socket is in a blocking mode, then the caller will be blocked
+ * until data arrives.
+ * @since 0.0.6
+ * @sa p_socket_send_fds()
+ *
+ * The caller owns the received descriptors and must close them, the
+ * close-on-exec flag is set for them. Descriptors which don't fit into the
+ * @a fds array (up to #P_SOCKET_MAX_PASSED_FDS) are closed by the system.
+ *
+ * Not supported on Windows, see p_socket_address_is_unix_supported().
+ */
+P_LIB_API pssize		p_socket_receive_fds		(const PSocket		*socket,
+								 pchar			*buffer,
+								 psize			buflen,
+								 pint			*fds,
+								 pint			*count,
+								 PError			**error);
+
+/**
+ * @brief Sends data from a file through a given @a socket.
+ * @param socket #PSocket to send data through.
+ * @param fd File descriptor to read data from.
+ * @param offset Offset in the file to start reading data from, in bytes.
+ * @param length Number of bytes to send.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of sent data in case of success, -1 otherwise.
+ * @note If the @a socket is in a blocking mode, then the caller will be blocked
+ * until all the data sent.
+ * @since 0.0.6
+ * @sa p_socket_send_mapped_file(), p_socket_send()
+ *
+ * On Linux the data is transferred with sendfile() inside the kernel, without
+ * copying it into user space. If the @a fd refers to a pipe, splice() is used
+ * instead, the @a offset must be 0 in that case. On other platforms, or if
+ * the file doesn't support such a transfer, the data is read into an
+ * intermediate buffer and sent with send().
+ *
+ * The @a fd must refer to a file opened for reading. The file position of the
+ * @a fd is not changed on UNIX systems, while on Windows it may be.
+ *
+ * In the blocking mode the call returns after all the @a length bytes were
+ * sent, in the non-blocking mode it sends as much data as possible without
+ * blocking and fails with #P_ERROR_IO_WOULD_BLOCK if no data could be sent at
+ * all. In both modes the returned size may be less than @a length if the end
+ * of the file was reached, or if an error occurred after some data was already
+ * sent: the error will be reported by the next call in that case.
+ *
+ * This call is used only with connection oriented sockets after a connection
+ * has been established.
+ */
+P_LIB_API pssize		p_socket_send_file		(const PSocket		*socket,
+								 pint			fd,
+								 puint64		offset,
+								 psize			length,
+								 PError			**error);
+
+/**
+ * @brief Sends data from a mapped file through a given @a socket.
+ * @param socket #PSocket to send data through.
+ * @param file #PMappedFile to send data from.
+ * @param offset Offset of the data to send, relative to the mapped data
+ * address.
+ * @param length Number of bytes to send, 0 to send up to the end of the mapped
+ * data.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Size in bytes of sent data in case of success, -1 otherwise.
+ * @note If the @a socket is in a blocking mode, then the caller will be blocked
+ * until all the data sent.
+ * @since 0.0.6
+ * @sa p_socket_send_file(), p_socket_send()
+ *
+ * The data is sent directly from the mapped memory, so no intermediate buffer
+ * is involved. The blocking and non-blocking modes behave the same way as for
+ * p_socket_send_file().
+ */
+P_LIB_API pssize		p_socket_send_mapped_file	(const PSocket		*socket,
+								 const PMappedFile	*file,
+								 psize			offset,
+								 psize			length,
+								 PError			**error);
+
 /**
  * @brief Closes a @a socket.
  * @param socket #PSocket to close.
@@ -756,6 +1082,98 @@ P_LIB_API pboolean		p_socket_set_buffer_size	(const PSocket		*socket,
 								 psize			size,
 								 PError			**error);
 
+/**
+ * @brief Sets a tuning option on a @a socket.
+ * @param socket #PSocket to set the option on.
+ * @param option Option to set.
+ * @param value Option value: 0 or 1 for boolean options, a number for the
+ * others, see #PSocketOption.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ * @sa p_socket_get_option(), p_socket_is_option_supported()
+ *
+ * These options are mostly used to tune connection oriented sockets for a low
+ * latency or a high throughput, and not all of them are available on every
+ * platform. If an option isn't supported, the call fails with
+ * #P_ERROR_IO_NOT_SUPPORTED.
+ *
+ * #P_SOCKET_OPTION_TCP_NODELAY sends small writes immediately instead of
+ * coalescing them, which is what most request-response protocols want.
+ * #P_SOCKET_OPTION_TCP_CORK does the opposite: while it is set, partial frames
+ * are held back, so a header and a body written separately (i.e. with
+ * p_socket_send() and p_socket_send_file()) go in the same packets. Clearing
+ * it flushes the pending data.
+ *
+ * #P_SOCKET_OPTION_TCP_QUICKACK is not permanent on Linux: the system may turn
+ * it off by itself, so it is usually set again after every receive.
+ *
+ * #P_SOCKET_OPTION_TCP_FASTOPEN and #P_SOCKET_OPTION_TCP_DEFER_ACCEPT are set
+ * on a listening socket, preferably before p_socket_listen().
+ * #P_SOCKET_OPTION_TCP_FASTOPEN_CONNECT is set on a client socket before
+ * p_socket_connect(). #P_SOCKET_OPTION_BUSY_POLL may require additional
+ * privileges to increase the value.
+ *
+ * #P_SOCKET_OPTION_REUSE_PORT must be set on all the sockets sharing the same
+ * address before p_socket_bind(). On Linux incoming connections (or
+ * datagrams) are distributed between such sockets, see #PSocketAcceptor.
+ */
+P_LIB_API pboolean		p_socket_set_option		(const PSocket		*socket,
+								 PSocketOption		option,
+								 pint			value,
+								 PError			**error);
+
+/**
+ * @brief Gets a tuning option value of a @a socket.
+ * @param socket #PSocket to get the option for.
+ * @param option Option to get.
+ * @param[out] value Pointer to store the option value.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ * @sa p_socket_set_option()
+ *
+ * Boolean options are reported as 0 or 1. Note that the system may adjust the
+ * value given to p_socket_set_option(), i.e. round the timeout of
+ * #P_SOCKET_OPTION_TCP_DEFER_ACCEPT.
+ */
+P_LIB_API pboolean		p_socket_get_option		(const PSocket		*socket,
+								 PSocketOption		option,
+								 pint			*value,
+								 PError			**error);
+
+/**
+ * @brief Checks whether a tuning option is supported on the current
+ * platform.
+ * @param option Option to check.
+ * @return TRUE if the @a option is supported, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * Even if the option is supported by the platform, the running system (i.e.
+ * an older kernel version) may still reject it.
+ */
+P_LIB_API pboolean		p_socket_is_option_supported	(PSocketOption		option);
+
+/**
+ * @brief Gets a snapshot of a TCP connection state.
+ * @param socket #PSocket to get the state for.
+ * @param[out] info Structure to store the state in.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * The snapshot contains the round trip time estimation, congestion control
+ * state and retransmission counters, which are useful to observe the
+ * connection quality without any additional tools. Fields which are not
+ * reported by the system are set to 0.
+ *
+ * Currently this call is supported on Linux only, on other platforms it fails
+ * with #P_ERROR_IO_NOT_SUPPORTED.
+ */
+P_LIB_API pboolean		p_socket_get_tcp_info		(const PSocket		*socket,
+								 PSocketTcpInfo		*info,
+								 PError			**error);
+
 /**
  * @brief Waits for a specified I/O @a condition on @a socket.
  * @param socket #PSocket to wait for @a condition on.
@@ -0,0 +1,469 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "patomic.h"
+#include "puthread.h"
+#include "psocketacceptor.h"
+#include "perror-private.h"
+
+#ifdef PLIBSYS_HAS_REUSEPORT_CBPF
+#  include <sys/types.h>
+#  include <sys/socket.h>
+#  include <linux/filter.h>
+#endif
+
+/* Default backlog of every listening socket */
+#define P_SOCKET_ACCEPTOR_BACKLOG	1024
+
+/* Accept timeout to check the stop request, in milliseconds */
+#define P_SOCKET_ACCEPTOR_POLL_TIMEOUT	100
+
+/* Delay after an unexpected accept() error, in milliseconds */
+#define P_SOCKET_ACCEPTOR_ERROR_DELAY	10
+
+typedef struct PSocketAcceptorWorker_ {
+	PSocketAcceptor	*acceptor;
+	PUThread	*thread;
+	pint		index;
+} PSocketAcceptorWorker;
+
+struct PSocketAcceptor_ {
+	PSocket			**listeners;
+	pint			listeners_count;
+	PSocketAcceptorWorker	*workers;
+	pint			workers_count;
+	PSocketAcceptorFunc	func;
+	ppointer		user_data;
+	volatile pint		stop;
+	pboolean		running;
+};
+
+static PSocket * pp_socket_acceptor_create_listener (PSocketAddress *address,
+						     pboolean reuse_port,
+						     PError **error);
+static PUThreadCpuSet * pp_socket_acceptor_create_cpu_sets (pint workers);
+static void pp_socket_acceptor_join_workers (PSocketAcceptor *acceptor, pint count);
+static ppointer pp_socket_acceptor_worker (ppointer data);
+
+static PSocket *
+pp_socket_acceptor_create_listener (PSocketAddress	*address,
+				    pboolean		reuse_port,
+				    PError		**error)
+{
+	PSocket	*socket;
+
+	if (P_UNLIKELY ((socket = p_socket_new (p_socket_address_get_family (address),
+						P_SOCKET_TYPE_STREAM,
+						P_SOCKET_PROTOCOL_TCP,
+						error)) == NULL))
+		return NULL;
+
+	if (reuse_port == TRUE &&
+	    P_UNLIKELY (p_socket_set_option (socket, P_SOCKET_OPTION_REUSE_PORT, 1, error) == FALSE)) {
+		p_socket_free (socket);
+		return NULL;
+	}
+
+	p_socket_set_listen_backlog (socket, P_SOCKET_ACCEPTOR_BACKLOG);
+
+	if (P_UNLIKELY (p_socket_bind (socket, address, TRUE, error) == FALSE ||
+			p_socket_listen (socket, error) == FALSE)) {
+		p_socket_free (socket);
+		return NULL;
+	}
+
+	/* Accepting wakes up periodically to check the stop request */
+	p_socket_set_timeout (socket, P_SOCKET_ACCEPTOR_POLL_TIMEOUT);
+
+	return socket;
+}
+
+static PUThreadCpuSet *
+pp_socket_acceptor_create_cpu_sets (pint workers)
+{
+	PUThreadTopology	*topology;
+	PUThreadCpuSet		*cpus;
+	PUThreadCpuInfo		info;
+	pint			count;
+	pint			i;
+
+	if (P_UNLIKELY ((topology = p_uthread_topology_new ()) == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((cpus = p_malloc0 ((psize) workers * sizeof (PUThreadCpuSet))) == NULL)) {
+		p_uthread_topology_free (topology);
+		return NULL;
+	}
+
+	count = p_uthread_topology_get_cpu_count (topology);
+
+	for (i = 0; i < count; ++i) {
+		if (P_LIKELY (p_uthread_topology_get_cpu_info (topology, i, &info) == TRUE))
+			p_uthread_cpu_set_add (&cpus[info.cpu % workers], info.cpu);
+	}
+
+	p_uthread_topology_free (topology);
+
+	return cpus;
+}
+
+static void
+pp_socket_acceptor_join_workers (PSocketAcceptor	*acceptor,
+				 pint			count)
+{
+	pint i;
+
+	p_atomic_int_set (&acceptor->stop, 1);
+
+	for (i = 0; i < count; ++i) {
+		p_uthread_join (acceptor->workers[i].thread);
+		p_uthread_unref (acceptor->workers[i].thread);
+
+		acceptor->workers[i].thread = NULL;
+	}
+}
+
+static ppointer
+pp_socket_acceptor_worker (ppointer data)
+{
+	PSocketAcceptorWorker	*worker;
+	PSocketAcceptor		*acceptor;
+	PSocket			*listener;
+	PSocket			*conn;
+	PErrorStorage		err_storage;
+	PError			*error;
+
+	/* Accept times out all the time when idle, do not allocate errors for it */
+	worker   = (PSocketAcceptorWorker *) data;
+	acceptor = worker->acceptor;
+	listener = acceptor->listeners[worker->index % acceptor->listeners_count];
+	error    = p_error_init (&err_storage);
+
+	while (p_atomic_int_get (&acceptor->stop) == 0) {
+		if ((conn = p_socket_accept (listener, &error)) == NULL) {
+			if (p_error_get_code (error) != (pint) P_ERROR_IO_TIMED_OUT) {
+				/* Most likely out of descriptors, let other threads free some */
+				P_WARNING ("PSocketAcceptor::pp_socket_acceptor_worker: failed to accept connection");
+				p_uthread_sleep (P_SOCKET_ACCEPTOR_ERROR_DELAY);
+			}
+
+			p_error_clear (error);
+			continue;
+		}
+
+		acceptor->func (conn, worker->index, acceptor->user_data);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+P_LIB_API PSocketAcceptor *
+p_socket_acceptor_new (PSocketAddress	*address,
+		       pint		workers,
+		       PError		**error)
+{
+	PSocketAcceptor		*ret;
+	PSocketAddressStorage	storage;
+	PSocketAddress		*bound_address;
+	pboolean		reuse_port;
+	pint			i;
+
+	if (P_UNLIKELY (address == NULL || workers < 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (workers == 0)
+		workers = p_uthread_ideal_count ();
+
+	if (workers < 1)
+		workers = 1;
+
+	/* Only Linux distributes connections between the sockets, on other
+	 * systems the last bound socket gets all of them */
+#ifdef P_OS_LINUX
+	reuse_port = workers > 1 && p_socket_is_option_supported (P_SOCKET_OPTION_REUSE_PORT);
+#else
+	reuse_port = FALSE;
+#endif
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocketAcceptor))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket acceptor");
+		return NULL;
+	}
+
+	ret->workers_count   = workers;
+	ret->listeners_count = reuse_port == TRUE ? workers : 1;
+
+	if (P_UNLIKELY ((ret->listeners = p_malloc0 ((psize) ret->listeners_count * sizeof (PSocket *))) == NULL ||
+			(ret->workers = p_malloc0 ((psize) workers * sizeof (PSocketAcceptorWorker))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket acceptor workers");
+		p_socket_acceptor_free (ret);
+		return NULL;
+	}
+
+	bound_address = address;
+
+	for (i = 0; i < ret->listeners_count; ++i) {
+		if (P_UNLIKELY ((ret->listeners[i] = pp_socket_acceptor_create_listener (bound_address,
+											 reuse_port,
+											 error)) == NULL)) {
+			p_socket_acceptor_free (ret);
+			return NULL;
+		}
+
+		/* Other sockets must join the port chosen by the system */
+		if (i == 0 && ret->listeners_count > 1 && p_socket_address_get_port (address) == 0) {
+			if (P_UNLIKELY (p_socket_get_local_address_into (ret->listeners[0],
+									 &storage,
+									 error) == FALSE)) {
+				p_socket_acceptor_free (ret);
+				return NULL;
+			}
+
+			bound_address = p_socket_address_from_storage (&storage);
+		}
+	}
+
+	for (i = 0; i < workers; ++i) {
+		ret->workers[i].acceptor = ret;
+		ret->workers[i].index    = i;
+	}
+
+	return ret;
+}
+
+P_LIB_API pboolean
+p_socket_acceptor_set_cpu_steering (PSocketAcceptor	*acceptor,
+				    PError		**error)
+{
+#ifdef PLIBSYS_HAS_REUSEPORT_CBPF
+	struct sock_filter	code[3];
+	struct sock_fprog	prog;
+	pint			err_code;
+#endif
+
+	if (P_UNLIKELY (acceptor == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+#ifdef PLIBSYS_HAS_REUSEPORT_CBPF
+	if (acceptor->listeners_count == 1)
+		return TRUE;
+
+	/* A = current CPU number */
+	code[0].code = BPF_LD | BPF_W | BPF_ABS;
+	code[0].jt   = 0;
+	code[0].jf   = 0;
+	code[0].k    = (puint32) (SKF_AD_OFF + SKF_AD_CPU);
+
+	/* A = A % listeners */
+	code[1].code = BPF_ALU | BPF_MOD | BPF_K;
+	code[1].jt   = 0;
+	code[1].jf   = 0;
+	code[1].k    = (puint32) acceptor->listeners_count;
+
+	/* Return A as an index of the socket in the group */
+	code[2].code = BPF_RET | BPF_A;
+	code[2].jt   = 0;
+	code[2].jf   = 0;
+	code[2].k    = 0;
+
+	prog.len    = (unsigned short) (sizeof (code) / sizeof (code[0]));
+	prog.filter = code;
+
+	/* The program is shared by the whole group, any socket can be used */
+	if (P_UNLIKELY (setsockopt (p_socket_get_fd (acceptor->listeners[0]),
+				    SOL_SOCKET,
+				    SO_ATTACH_REUSEPORT_CBPF,
+				    &prog,
+				    sizeof (prog)) != 0)) {
+		err_code = p_error_get_last_net ();
+
+		p_error_set_error_p (error,
+				     (pint) p_error_get_io_from_system (err_code),
+				     err_code,
+				     "Failed to call setsockopt() to attach CPU steering program");
+		return FALSE;
+	}
+
+	return TRUE;
+#else
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "CPU steering is not supported on this platform");
+	return FALSE;
+#endif
+}
+
+P_LIB_API pboolean
+p_socket_acceptor_start (PSocketAcceptor	*acceptor,
+			 PSocketAcceptorFunc	func,
+			 ppointer		user_data,
+			 pboolean		pin_workers,
+			 PError			**error)
+{
+	PUThreadCpuSet	*cpus;
+	pint		i;
+
+	if (P_UNLIKELY (acceptor == NULL || func == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (acceptor->running == TRUE)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Socket acceptor is already started");
+		return FALSE;
+	}
+
+	acceptor->func      = func;
+	acceptor->user_data = user_data;
+
+	p_atomic_int_set (&acceptor->stop, 0);
+
+	cpus = pin_workers == TRUE ? pp_socket_acceptor_create_cpu_sets (acceptor->workers_count) : NULL;
+
+	for (i = 0; i < acceptor->workers_count; ++i) {
+		acceptor->workers[i].thread =
+			p_uthread_create_with_affinity ((PUThreadFunc) pp_socket_acceptor_worker,
+							&acceptor->workers[i],
+							TRUE,
+							P_UTHREAD_PRIORITY_INHERIT,
+							0,
+							"psocketacceptor",
+							cpus != NULL && p_uthread_cpu_set_get_count (&cpus[i]) > 0 ?
+								&cpus[i] : NULL);
+
+		if (P_UNLIKELY (acceptor->workers[i].thread == NULL)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to create socket acceptor worker thread");
+			pp_socket_acceptor_join_workers (acceptor, i);
+
+			if (cpus != NULL)
+				p_free (cpus);
+
+			return FALSE;
+		}
+	}
+
+	if (cpus != NULL)
+		p_free (cpus);
+
+	acceptor->running = TRUE;
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_socket_acceptor_stop (PSocketAcceptor *acceptor)
+{
+	if (P_UNLIKELY (acceptor == NULL))
+		return;
+
+	if (acceptor->running == FALSE)
+		return;
+
+	pp_socket_acceptor_join_workers (acceptor, acceptor->workers_count);
+
+	acceptor->running = FALSE;
+}
+
+P_LIB_API pint
+p_socket_acceptor_get_workers (const PSocketAcceptor *acceptor)
+{
+	if (P_UNLIKELY (acceptor == NULL))
+		return 0;
+
+	return acceptor->workers_count;
+}
+
+P_LIB_API pint
+p_socket_acceptor_get_listeners (const PSocketAcceptor *acceptor)
+{
+	if (P_UNLIKELY (acceptor == NULL))
+		return 0;
+
+	return acceptor->listeners_count;
+}
+
+P_LIB_API PSocket *
+p_socket_acceptor_get_listener (const PSocketAcceptor	*acceptor,
+				pint			index)
+{
+	if (P_UNLIKELY (acceptor == NULL || index < 0 || index >= acceptor->listeners_count))
+		return NULL;
+
+	return acceptor->listeners[index];
+}
+
+P_LIB_API void
+p_socket_acceptor_free (PSocketAcceptor *acceptor)
+{
+	pint i;
+
+	if (P_UNLIKELY (acceptor == NULL))
+		return;
+
+	p_socket_acceptor_stop (acceptor);
+
+	if (acceptor->listeners != NULL) {
+		for (i = 0; i < acceptor->listeners_count; ++i) {
+			if (acceptor->listeners[i] != NULL)
+				p_socket_free (acceptor->listeners[i]);
+		}
+
+		p_free (acceptor->listeners);
+	}
+
+	if (acceptor->workers != NULL)
+		p_free (acceptor->workers);
+
+	p_free (acceptor);
+}
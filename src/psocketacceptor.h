@@ -0,0 +1,215 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file psocketacceptor.h
+ * @brief Multi-threaded connection acceptor
+ * @author Alexander Saprykin
+ *
+ * A server with a single listening socket accepts all the incoming
+ * connections on one thread, even if the connections are processed by a pool
+ * of threads later. Under a high connection rate this thread becomes a
+ * bottleneck, and all the workers contend on the single accept queue.
+ *
+ * #PSocketAcceptor runs a number of worker threads, each one with its own
+ * listening socket bound to the same address using the SO_REUSEPORT option
+ * (see #P_SOCKET_OPTION_REUSE_PORT). The kernel distributes incoming
+ * connections between the listening sockets, so accepting scales with the
+ * number of workers. Every accepted connection is passed to a callback on the
+ * worker thread which accepted it.
+ *
+ * On Linux the distribution can be additionally bound to CPUs with
+ * p_socket_acceptor_set_cpu_steering(): a connection is then accepted by the
+ * worker corresponding to the CPU which received it. Combined with pinning the
+ * workers to their CPUs (see p_socket_acceptor_start()) this keeps all the
+ * processing of a connection on the same CPU.
+ *
+ * Distributing connections between several listening sockets is supported
+ * only on Linux. On other platforms a single listening socket is created and
+ * shared by all the workers.
+ *
+ * Here is an example of #PSocketAcceptor usage:
+ * @code
+ * static void
+ * on_connection (PSocket *socket, pint worker, ppointer user_data)
+ * {
+ *	... serve the connection ...
+ *	p_socket_free (socket);
+ * }
+ *
+ * addr     = p_socket_address_new ("0.0.0.0", 8080);
+ * acceptor = p_socket_acceptor_new (addr, 0, NULL);
+ *
+ * p_socket_acceptor_start (acceptor, on_connection, NULL, TRUE, NULL);
+ * ...
+ * p_socket_acceptor_free (acceptor);
+ * @endcode
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSOCKETACCEPTOR_H
+#define PLIBSYS_HEADER_PSOCKETACCEPTOR_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+#include <perror.h>
+#include <psocket.h>
+#include <psocketaddress.h>
+
+P_BEGIN_DECLS
+
+/** Multi-threaded connection acceptor opaque structure. */
+typedef struct PSocketAcceptor_ PSocketAcceptor;
+
+/**
+ * @brief Accepted connection callback.
+ * @param socket Accepted connection, the callback takes ownership of it.
+ * @param worker Index of the worker which accepted the connection, starting
+ * from 0.
+ * @param user_data Data given to p_socket_acceptor_start().
+ * @since 0.0.6
+ *
+ * The callback is called from the worker thread, no new connections are
+ * accepted by that worker until it returns. Long running processing should be
+ * moved to another thread.
+ */
+typedef void (*PSocketAcceptorFunc) (PSocket *socket, pint worker, ppointer user_data);
+
+/**
+ * @brief Creates a new #PSocketAcceptor.
+ * @param address Address to listen on. If the port is 0, a free port is
+ * chosen by the system and shared by all the listening sockets.
+ * @param workers Number of worker threads, pass 0 to use
+ * p_uthread_ideal_count().
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PSocketAcceptor in case of success, NULL otherwise.
+ * @since 0.0.6
+ *
+ * The listening sockets are created, bound with address reusing allowed and
+ * put into the listening state. Use p_socket_acceptor_get_listener() to get
+ * the actual bound address or to tune the sockets. The workers are not
+ * started until p_socket_acceptor_start() is called, the connections are
+ * queued meanwhile.
+ */
+P_LIB_API PSocketAcceptor *	p_socket_acceptor_new			(PSocketAddress		*address,
+									 pint			workers,
+									 PError			**error);
+
+/**
+ * @brief Steers incoming connections to the workers by the receiving CPU.
+ * @param acceptor #PSocketAcceptor to set the steering for.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * Attaches a BPF program to the listening sockets group, which chooses a
+ * socket for an incoming connection by the number of the CPU handling it: a
+ * connection received by the CPU N is accepted by the worker N modulo the
+ * number of workers. Start the workers with pinning to get the most of it.
+ *
+ * Supported only on Linux, fails with #P_ERROR_IO_NOT_SUPPORTED on other
+ * platforms.
+ */
+P_LIB_API pboolean		p_socket_acceptor_set_cpu_steering	(PSocketAcceptor	*acceptor,
+									 PError			**error);
+
+/**
+ * @brief Starts accepting connections.
+ * @param acceptor #PSocketAcceptor to start.
+ * @param func Callback to pass the accepted connections to.
+ * @param user_data Data to pass to the @a func.
+ * @param pin_workers Whether to pin the worker threads to CPUs: the worker N
+ * runs on the CPUs whose number modulo the number of workers equals N.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * Pinning is a best effort: if the platform doesn't support thread affinity,
+ * the workers run unpinned. Fails if the @a acceptor is already started.
+ */
+P_LIB_API pboolean		p_socket_acceptor_start			(PSocketAcceptor	*acceptor,
+									 PSocketAcceptorFunc	func,
+									 ppointer		user_data,
+									 pboolean		pin_workers,
+									 PError			**error);
+
+/**
+ * @brief Stops accepting connections.
+ * @param acceptor #PSocketAcceptor to stop.
+ * @since 0.0.6
+ *
+ * Waits for all the workers to finish: the callbacks which are running at the
+ * moment are completed first. The listening sockets remain open, so the
+ * acceptor can be started again.
+ */
+P_LIB_API void			p_socket_acceptor_stop			(PSocketAcceptor	*acceptor);
+
+/**
+ * @brief Gets the number of worker threads.
+ * @param acceptor #PSocketAcceptor to get the number of workers for.
+ * @return Number of worker threads in case of success, 0 otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API pint			p_socket_acceptor_get_workers		(const PSocketAcceptor	*acceptor);
+
+/**
+ * @brief Gets the number of listening sockets.
+ * @param acceptor #PSocketAcceptor to get the number of sockets for.
+ * @return Number of listening sockets in case of success, 0 otherwise.
+ * @since 0.0.6
+ *
+ * Equals to the number of workers if the platform supports distributing
+ * connections between the sockets, 1 otherwise.
+ */
+P_LIB_API pint			p_socket_acceptor_get_listeners		(const PSocketAcceptor	*acceptor);
+
+/**
+ * @brief Gets a listening socket.
+ * @param acceptor #PSocketAcceptor to get the socket for.
+ * @param index Index of the socket, starting from 0.
+ * @return Listening #PSocket in case of success, NULL otherwise.
+ * @since 0.0.6
+ *
+ * The socket is owned by the @a acceptor, do not free or close it.
+ */
+P_LIB_API PSocket *		p_socket_acceptor_get_listener		(const PSocketAcceptor	*acceptor,
+									 pint			index);
+
+/**
+ * @brief Stops the workers and frees the #PSocketAcceptor.
+ * @param acceptor #PSocketAcceptor to free.
+ * @since 0.0.6
+ *
+ * The listening sockets are closed, pending connections which were not
+ * accepted yet are dropped.
+ */
+P_LIB_API void			p_socket_acceptor_free			(PSocketAcceptor	*acceptor);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSOCKETACCEPTOR_H */
@@ -28,6 +28,7 @@
 #include "psocketaddress.h"
 #include "plibsys-private.h"
 
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -35,6 +36,11 @@
 #  include <arpa/inet.h>
 #endif
 
+#if defined (AF_UNIX) && !defined (P_OS_WIN)
+#  define P_SOCKET_ADDRESS_HAS_UNIX
+#  include <sys/un.h>
+#endif
+
 #if defined (PLIBSYS_HAS_GETADDRINFO) && !defined (PLIBSYS_SOCKADDR_IN6_HAS_SCOPEID)
 #  undef PLIBSYS_HAS_GETADDRINFO
 #endif
@@ -76,12 +82,26 @@
 #  endif
 #endif
 
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+#  define P_SOCKET_ADDRESS_UNIX_NATIVE_LEN	(sizeof (((struct sockaddr_un *) NULL)->sun_path))
+/* Some platforms have a huge path buffer, limit it to fit the storage */
+#  define P_SOCKET_ADDRESS_UNIX_PATH_LEN	(P_SOCKET_ADDRESS_UNIX_NATIVE_LEN < 108 ? \
+						 P_SOCKET_ADDRESS_UNIX_NATIVE_LEN : 108)
+#endif
+
 struct PSocketAddress_ {
 	PSocketFamily	family;
 	union addr_ {
 		struct in_addr sin_addr;
 #ifdef AF_INET6
 		struct in6_addr sin6_addr;
+#endif
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+		struct {
+			pchar		path[P_SOCKET_ADDRESS_UNIX_PATH_LEN];
+			puint16		len;
+			pboolean	abstract;
+		} un;
 #endif
 	} 		addr;
 	puint16 	port;
@@ -89,70 +109,110 @@ struct PSocketAddress_ {
 	puint32		scope_id;
 };
 
-P_LIB_API PSocketAddress *
-p_socket_address_new_from_native (pconstpointer	native,
-				  psize		len)
-{
-	PSocketAddress	*ret;
-	puint16		family;
+/* Storage should be able to hold any address */
+typedef pchar pp_socket_address_storage_check[sizeof (PSocketAddress) <= sizeof (PSocketAddressStorage) ? 1 : -1];
 
-	if (P_UNLIKELY (native == NULL || len == 0))
-		return NULL;
+static pboolean pp_socket_address_fill_from_native (PSocketAddress *addr, pconstpointer native, psize len);
+static pboolean pp_socket_address_fill (PSocketAddress *addr, const pchar *address, puint16 port);
+static pboolean pp_socket_address_fill_unix (PSocketAddress *addr, const pchar *path, pboolean abstract);
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocketAddress))) == NULL))
-		return NULL;
+static pboolean
+pp_socket_address_fill_from_native (PSocketAddress	*addr,
+				    pconstpointer	native,
+				    psize		len)
+{
+	puint16 family;
 
 	family = ((const struct sockaddr *) native)->sa_family;
 
 	if (family == AF_INET) {
 		if (len < sizeof (struct sockaddr_in)) {
-			P_WARNING ("PSocketAddress::p_socket_address_new_from_native: invalid IPv4 native size");
-			p_free (ret);
-			return NULL;
+			P_WARNING ("PSocketAddress::pp_socket_address_fill_from_native: invalid IPv4 native size");
+			return FALSE;
 		}
 
-		memcpy (&ret->addr.sin_addr, &((const struct sockaddr_in *) native)->sin_addr, sizeof (struct in_addr));
-		ret->family = P_SOCKET_FAMILY_INET;
-		ret->port   = p_ntohs (((struct sockaddr_in *) native)->sin_port);
-		return ret;
+		memcpy (&addr->addr.sin_addr, &((const struct sockaddr_in *) native)->sin_addr, sizeof (struct in_addr));
+		addr->family = P_SOCKET_FAMILY_INET;
+		addr->port   = p_ntohs (((struct sockaddr_in *) native)->sin_port);
+		return TRUE;
 	}
 #ifdef AF_INET6
 	else if (family == AF_INET6) {
 		if (len < sizeof (struct sockaddr_in6)) {
-			P_WARNING ("PSocketAddress::p_socket_address_new_from_native: invalid IPv6 native size");
-			p_free (ret);
-			return NULL;
+			P_WARNING ("PSocketAddress::pp_socket_address_fill_from_native: invalid IPv6 native size");
+			return FALSE;
 		}
 
-		memcpy (&ret->addr.sin6_addr,
+		memcpy (&addr->addr.sin6_addr,
 			&((struct sockaddr_in6 *) native)->sin6_addr,
 			sizeof (struct in6_addr));
 
-		ret->family   = P_SOCKET_FAMILY_INET6;
-		ret->port     = p_ntohs (((struct sockaddr_in *) native)->sin_port);
+		addr->family   = P_SOCKET_FAMILY_INET6;
+		addr->port     = p_ntohs (((struct sockaddr_in *) native)->sin_port);
 #ifdef PLIBSYS_SOCKADDR_IN6_HAS_FLOWINFO
-		ret->flowinfo = ((struct sockaddr_in6 *) native)->sin6_flowinfo;
+		addr->flowinfo = ((struct sockaddr_in6 *) native)->sin6_flowinfo;
 #endif
 #ifdef PLIBSYS_SOCKADDR_IN6_HAS_SCOPEID
-		ret->scope_id = ((struct sockaddr_in6 *) native)->sin6_scope_id;
+		addr->scope_id = ((struct sockaddr_in6 *) native)->sin6_scope_id;
 #endif
-		return ret;
+		return TRUE;
 	}
 #endif
-	else {
-		p_free (ret);
-		return NULL;
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+	else if (family == AF_UNIX) {
+		const pchar	*path;
+		psize		path_len;
+		psize		i;
+
+		if (len < offsetof (struct sockaddr_un, sun_path)) {
+			P_WARNING ("PSocketAddress::pp_socket_address_fill_from_native: invalid Unix native size");
+			return FALSE;
+		}
+
+		path     = ((const struct sockaddr_un *) native)->sun_path;
+		path_len = len - offsetof (struct sockaddr_un, sun_path);
+
+		if (path_len > P_SOCKET_ADDRESS_UNIX_NATIVE_LEN)
+			path_len = P_SOCKET_ADDRESS_UNIX_NATIVE_LEN;
+
+		/* Name in the abstract namespace starts with zero and is not
+		 * zero-terminated, an unnamed socket has no path at all */
+		if (path_len > 1 && path[0] == '\0') {
+			addr->addr.un.abstract = TRUE;
+			++path;
+			--path_len;
+		} else {
+			for (i = 0; i < path_len && path[i] != '\0'; ++i)
+				;
+
+			path_len = i;
+		}
+
+		if (path_len >= P_SOCKET_ADDRESS_UNIX_PATH_LEN) {
+			P_WARNING ("PSocketAddress::pp_socket_address_fill_from_native: too long Unix socket path");
+			return FALSE;
+		}
+
+		memcpy (addr->addr.un.path, path, path_len);
+		addr->addr.un.path[path_len] = '\0';
+		addr->addr.un.len            = (puint16) path_len;
+		addr->family                 = P_SOCKET_FAMILY_UNIX;
+		return TRUE;
 	}
+#endif
+	else
+		return FALSE;
 }
 
-P_LIB_API PSocketAddress *
-p_socket_address_new (const pchar	*address,
-		      puint16		port)
+static pboolean
+pp_socket_address_fill (PSocketAddress	*addr,
+			const pchar	*address,
+			puint16		port)
 {
-	PSocketAddress		*ret;
 #if defined (P_OS_WIN) || defined (PLIBSYS_HAS_GETADDRINFO)
 	struct addrinfo		hints;
 	struct addrinfo		*res;
+	pboolean		ret;
 #endif
 
 #ifdef P_OS_WIN
@@ -164,9 +224,6 @@ p_socket_address_new (const pchar	*address,
 	pint 			len;
 #endif /* P_OS_WIN */
 
-	if (P_UNLIKELY (address == NULL))
-		return NULL;
-
 #if (defined (P_OS_WIN) || defined (PLIBSYS_HAS_GETADDRINFO)) && defined (AF_INET6)
 	if (strchr (address, ':') != NULL) {
 		memset (&hints, 0, sizeof (hints));
@@ -179,14 +236,14 @@ p_socket_address_new (const pchar	*address,
 #  endif
 
 		if (P_UNLIKELY (getaddrinfo (address, NULL, &hints, &res) != 0))
-			return NULL;
+			return FALSE;
 
 		if (P_LIKELY (res->ai_family  == AF_INET6 &&
 			      res->ai_addrlen == sizeof (struct sockaddr_in6))) {
 			((struct sockaddr_in6 *) res->ai_addr)->sin6_port = p_htons (port);
-			ret = p_socket_address_new_from_native (res->ai_addr, res->ai_addrlen);
+			ret = pp_socket_address_fill_from_native (addr, res->ai_addr, res->ai_addrlen);
 		} else
-			ret = NULL;
+			ret = FALSE;
 
 		freeaddrinfo (res);
 
@@ -194,12 +251,7 @@ p_socket_address_new (const pchar	*address,
 	}
 #endif
 
-	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocketAddress))) == NULL)) {
-		P_ERROR ("PSocketAddress::p_socket_address_new: failed to allocate memory");
-		return NULL;
-	}
-
-	ret->port = port;
+	addr->port = port;
 
 #ifdef P_OS_WIN
 	memset (&sa, 0, sizeof (sa));
@@ -207,36 +259,199 @@ p_socket_address_new (const pchar	*address,
 	sin->sin_family = AF_INET;
 
 	if (WSAStringToAddressA ((LPSTR) address, AF_INET, NULL, (LPSOCKADDR) &sa, &len) == 0) {
-		memcpy (&ret->addr.sin_addr, &sin->sin_addr, sizeof (struct in_addr));
-		ret->family = P_SOCKET_FAMILY_INET;
-		return ret;
+		memcpy (&addr->addr.sin_addr, &sin->sin_addr, sizeof (struct in_addr));
+		addr->family = P_SOCKET_FAMILY_INET;
+		return TRUE;
 	}
 #  ifdef AF_INET6
 	else {
 		sin6->sin6_family = AF_INET6;
 
 		if (WSAStringToAddressA ((LPSTR) address, AF_INET6, NULL, (LPSOCKADDR) &sa, &len) == 0) {
-			memcpy (&ret->addr.sin6_addr, &sin6->sin6_addr, sizeof (struct in6_addr));
-			ret->family = P_SOCKET_FAMILY_INET6;
-			return ret;
+			memcpy (&addr->addr.sin6_addr, &sin6->sin6_addr, sizeof (struct in6_addr));
+			addr->family = P_SOCKET_FAMILY_INET6;
+			return TRUE;
 		}
 	}
 #  endif /* AF_INET6 */
 #else /* P_OS_WIN */
-	if (inet_pton (AF_INET, address, &ret->addr.sin_addr) > 0) {
-		ret->family = P_SOCKET_FAMILY_INET;
-		return ret;
+	if (inet_pton (AF_INET, address, &addr->addr.sin_addr) > 0) {
+		addr->family = P_SOCKET_FAMILY_INET;
+		return TRUE;
 	}
 #  ifdef AF_INET6
-	else if (inet_pton (AF_INET6, address, &ret->addr.sin6_addr) > 0) {
-		ret->family = P_SOCKET_FAMILY_INET6;
-		return ret;
+	else if (inet_pton (AF_INET6, address, &addr->addr.sin6_addr) > 0) {
+		addr->family = P_SOCKET_FAMILY_INET6;
+		return TRUE;
 	}
 #  endif /* AF_INET6 */
 #endif /* P_OS_WIN */
 
-	p_free (ret);
-	return NULL;
+	return FALSE;
+}
+
+static pboolean
+pp_socket_address_fill_unix (PSocketAddress	*addr,
+			     const pchar	*path,
+			     pboolean		abstract)
+{
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+	psize len;
+
+#  ifndef P_OS_LINUX
+	if (abstract == TRUE)
+		return FALSE;
+#  endif
+
+	len = strlen (path);
+
+	if (P_UNLIKELY (len == 0 || len >= P_SOCKET_ADDRESS_UNIX_PATH_LEN))
+		return FALSE;
+
+	memcpy (addr->addr.un.path, path, len + 1);
+
+	addr->addr.un.len      = (puint16) len;
+	addr->addr.un.abstract = abstract;
+	addr->family           = P_SOCKET_FAMILY_UNIX;
+
+	return TRUE;
+#else
+	P_UNUSED (addr);
+	P_UNUSED (path);
+	P_UNUSED (abstract);
+
+	return FALSE;
+#endif
+}
+
+P_LIB_API PSocketAddress *
+p_socket_address_new_from_native (pconstpointer	native,
+				  psize		len)
+{
+	PSocketAddress *ret;
+
+	if (P_UNLIKELY (native == NULL || len == 0))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocketAddress))) == NULL))
+		return NULL;
+
+	if (P_UNLIKELY (pp_socket_address_fill_from_native (ret, native, len) == FALSE)) {
+		p_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API PSocketAddress *
+p_socket_address_init_from_native (PSocketAddressStorage	*storage,
+				   pconstpointer		native,
+				   psize			len)
+{
+	PSocketAddress *ret;
+
+	if (P_UNLIKELY (storage == NULL || native == NULL || len == 0))
+		return NULL;
+
+	ret = (PSocketAddress *) storage;
+	memset (ret, 0, sizeof (PSocketAddress));
+
+	return pp_socket_address_fill_from_native (ret, native, len) ? ret : NULL;
+}
+
+P_LIB_API PSocketAddress *
+p_socket_address_new (const pchar	*address,
+		      puint16		port)
+{
+	PSocketAddress *ret;
+
+	if (P_UNLIKELY (address == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocketAddress))) == NULL)) {
+		P_ERROR ("PSocketAddress::p_socket_address_new: failed to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY (pp_socket_address_fill (ret, address, port) == FALSE)) {
+		p_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API PSocketAddress *
+p_socket_address_init (PSocketAddressStorage	*storage,
+		       const pchar		*address,
+		       puint16			port)
+{
+	PSocketAddress *ret;
+
+	if (P_UNLIKELY (storage == NULL || address == NULL))
+		return NULL;
+
+	ret = (PSocketAddress *) storage;
+	memset (ret, 0, sizeof (PSocketAddress));
+
+	return pp_socket_address_fill (ret, address, port) ? ret : NULL;
+}
+
+P_LIB_API PSocketAddress *
+p_socket_address_new_unix (const pchar	*path,
+			   pboolean	abstract)
+{
+	PSocketAddress *ret;
+
+	if (P_UNLIKELY (path == NULL))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocketAddress))) == NULL)) {
+		P_ERROR ("PSocketAddress::p_socket_address_new_unix: failed to allocate memory");
+		return NULL;
+	}
+
+	if (P_UNLIKELY (pp_socket_address_fill_unix (ret, path, abstract) == FALSE)) {
+		p_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API PSocketAddress *
+p_socket_address_init_unix (PSocketAddressStorage	*storage,
+			    const pchar			*path,
+			    pboolean			abstract)
+{
+	PSocketAddress *ret;
+
+	if (P_UNLIKELY (storage == NULL || path == NULL))
+		return NULL;
+
+	ret = (PSocketAddress *) storage;
+	memset (ret, 0, sizeof (PSocketAddress));
+
+	return pp_socket_address_fill_unix (ret, path, abstract) ? ret : NULL;
+}
+
+P_LIB_API PSocketAddress *
+p_socket_address_copy_into (const PSocketAddress	*addr,
+			    PSocketAddressStorage	*storage)
+{
+	if (P_UNLIKELY (addr == NULL || storage == NULL))
+		return NULL;
+
+	memcpy (storage, addr, sizeof (PSocketAddress));
+
+	return (PSocketAddress *) storage;
+}
+
+P_LIB_API PSocketAddress *
+p_socket_address_from_storage (PSocketAddressStorage *storage)
+{
+	return (PSocketAddress *) storage;
 }
 
 P_LIB_API PSocketAddress *
@@ -312,6 +527,9 @@ p_socket_address_to_native (const PSocketAddress	*addr,
 #ifdef AF_INET6
 	struct sockaddr_in6	*sin6;
 #endif
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+	struct sockaddr_un	*sun_addr;
+#endif
 
 	if (P_UNLIKELY (addr == NULL || dest == NULL || destlen == 0))
 		return FALSE;
@@ -351,6 +569,24 @@ p_socket_address_to_native (const PSocketAddress	*addr,
 #endif
 		return TRUE;
 	}
+#endif
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+	else if (addr->family == P_SOCKET_FAMILY_UNIX) {
+		if (P_UNLIKELY (destlen < sizeof (struct sockaddr_un))) {
+			P_WARNING ("PSocketAddress::p_socket_address_to_native: invalid buffer size for Unix");
+			return FALSE;
+		}
+
+		sun_addr = (struct sockaddr_un *) dest;
+
+		memset (sun_addr, 0, sizeof (struct sockaddr_un));
+		sun_addr->sun_family = AF_UNIX;
+
+		memcpy (sun_addr->sun_path + (addr->addr.un.abstract ? 1 : 0),
+			addr->addr.un.path,
+			addr->addr.un.len);
+		return TRUE;
+	}
 #endif
 	else {
 		P_WARNING ("PSocketAddress::p_socket_address_to_native: unsupported socket address");
@@ -369,6 +605,16 @@ p_socket_address_get_native_size (const PSocketAddress *addr)
 #ifdef AF_INET6
 	else if (addr->family == P_SOCKET_FAMILY_INET6)
 		return sizeof (struct sockaddr_in6);
+#endif
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+	else if (addr->family == P_SOCKET_FAMILY_UNIX) {
+		/* Both a path and an abstract name take one more byte: either the
+		 * terminating zero or the leading one, unnamed has no path */
+		if (addr->addr.un.len == 0)
+			return offsetof (struct sockaddr_un, sun_path);
+
+		return offsetof (struct sockaddr_un, sun_path) + addr->addr.un.len + 1;
+	}
 #endif
 	else {
 		P_WARNING ("PSocketAddress::p_socket_address_get_native_size: unsupported socket family");
@@ -385,8 +631,10 @@ p_socket_address_get_family (const PSocketAddress *addr)
 	return addr->family;
 }
 
-P_LIB_API pchar *
-p_socket_address_get_address (const PSocketAddress *addr)
+P_LIB_API pboolean
+p_socket_address_get_address_into (const PSocketAddress	*addr,
+				   pchar			*buf,
+				   psize			buflen)
 {
 #ifdef AF_INET6
 	pchar			buffer[INET6_ADDRSTRLEN];
@@ -395,7 +643,7 @@ p_socket_address_get_address (const PSocketAddress *addr)
 #endif
 
 #ifdef P_OS_WIN
-	DWORD			buflen = sizeof (buffer);
+	DWORD			winbuflen = sizeof (buffer);
 	DWORD			addrlen;
 	struct sockaddr_storage	sa;
 	struct sockaddr_in	*sin;
@@ -404,8 +652,23 @@ p_socket_address_get_address (const PSocketAddress *addr)
 #  endif /* AF_INET6 */
 #endif /* P_OS_WIN */
 
-	if (P_UNLIKELY (addr == NULL || addr->family == P_SOCKET_FAMILY_UNKNOWN))
-		return NULL;
+	if (P_UNLIKELY (addr == NULL || addr->family == P_SOCKET_FAMILY_UNKNOWN ||
+			buf == NULL || buflen == 0))
+		return FALSE;
+
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+	if (addr->family == P_SOCKET_FAMILY_UNIX) {
+		if (P_UNLIKELY ((psize) addr->addr.un.len + (addr->addr.un.abstract ? 1 : 0) >= buflen))
+			return FALSE;
+
+		if (addr->addr.un.abstract)
+			*buf++ = '@';
+
+		memcpy (buf, addr->addr.un.path, (psize) addr->addr.un.len + 1);
+
+		return TRUE;
+	}
+#endif
 #ifdef P_OS_WIN
 	sin = (struct sockaddr_in *) &sa;
 #  ifdef AF_INET6
@@ -435,17 +698,35 @@ p_socket_address_get_address (const PSocketAddress *addr)
 					     addrlen,
 					     NULL,
 					     (LPSTR) buffer,
-					     &buflen) != 0))
-		return NULL;
+					     &winbuflen) != 0))
+		return FALSE;
 #else /* !P_OS_WIN */
-	if (addr->family == P_SOCKET_FAMILY_INET)
-		inet_ntop (AF_INET, &addr->addr.sin_addr, buffer, sizeof (buffer));
+	if (addr->family == P_SOCKET_FAMILY_INET) {
+		if (P_UNLIKELY (inet_ntop (AF_INET, &addr->addr.sin_addr, buffer, sizeof (buffer)) == NULL))
+			return FALSE;
+	}
 #  ifdef AF_INET6
-	else
-		inet_ntop (AF_INET6, &addr->addr.sin6_addr, buffer, sizeof (buffer));
+	else if (P_UNLIKELY (inet_ntop (AF_INET6, &addr->addr.sin6_addr, buffer, sizeof (buffer)) == NULL))
+		return FALSE;
 #  endif /* AF_INET6 */
 #endif /* P_OS_WIN */
 
+	if (P_UNLIKELY (strlen (buffer) >= buflen))
+		return FALSE;
+
+	strcpy (buf, buffer);
+
+	return TRUE;
+}
+
+P_LIB_API pchar *
+p_socket_address_get_address (const PSocketAddress *addr)
+{
+	pchar buffer[P_SOCKET_ADDRESS_MAX_STRING_LEN];
+
+	if (P_UNLIKELY (p_socket_address_get_address_into (addr, buffer, sizeof (buffer)) == FALSE))
+		return NULL;
+
 	return p_strdup (buffer);
 }
 
@@ -556,6 +837,40 @@ p_socket_address_is_ipv6_supported (void)
 #endif
 }
 
+P_LIB_API pboolean
+p_socket_address_is_unix_supported (void)
+{
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
+P_LIB_API pboolean
+p_socket_address_is_abstract_supported (void)
+{
+#if defined (P_SOCKET_ADDRESS_HAS_UNIX) && defined (P_OS_LINUX)
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
+P_LIB_API pboolean
+p_socket_address_is_abstract (const PSocketAddress *addr)
+{
+#ifdef P_SOCKET_ADDRESS_HAS_UNIX
+	if (P_UNLIKELY (addr == NULL || addr->family != P_SOCKET_FAMILY_UNIX))
+		return FALSE;
+
+	return addr->addr.un.abstract;
+#else
+	P_UNUSED (addr);
+	return FALSE;
+#endif
+}
+
 P_LIB_API pboolean
 p_socket_address_is_any (const PSocketAddress *addr)
 {
@@ -570,12 +885,11 @@ p_socket_address_is_any (const PSocketAddress *addr)
 		return (addr4 == INADDR_ANY);
 	}
 #ifdef AF_INET6
-	else
+	else if (addr->family == P_SOCKET_FAMILY_INET6)
 		return IN6_IS_ADDR_UNSPECIFIED (&addr->addr.sin6_addr);
-#else
+#endif
 	else
 		return FALSE;
-#endif
 }
 
 P_LIB_API pboolean
@@ -593,12 +907,11 @@ p_socket_address_is_loopback (const PSocketAddress *addr)
 		return ((addr4 & 0xff000000) == 0x7f000000);
 	}
 #ifdef AF_INET6
-	else
+	else if (addr->family == P_SOCKET_FAMILY_INET6)
 		return IN6_IS_ADDR_LOOPBACK (&addr->addr.sin6_addr);
-#else
+#endif
 	else
 		return FALSE;
-#endif
 }
 
 P_LIB_API void
@@ -50,6 +50,25 @@
  * If you want to get the underlying native address structure for further usage
  * in system calls use p_socket_address_to_native(), and
  * p_socket_address_new_from_native() for a vice versa conversion.
+ *
+ * All the p_socket_address_new_* calls allocate an address on the heap. On hot
+ * paths, like receiving a datagram per call, that can be avoided with a
+ * caller-owned #PSocketAddressStorage: p_socket_address_init(),
+ * p_socket_address_init_from_native() and p_socket_address_copy_into() fill the
+ * storage in place and return a #PSocketAddress pointing into it. The same
+ * storage is used by the *_into variants of the #PSocket calls. Such an
+ * address is valid as long as the storage is, and must not be freed with
+ * p_socket_address_free(). Use p_socket_address_get_address_into() to format
+ * an address into a caller-provided buffer.
+ *
+ * Unix domain socket addresses (#P_SOCKET_FAMILY_UNIX) are used for local
+ * communication between processes on the same host, bypassing the network
+ * stack. Such an address is created with p_socket_address_new_unix() and is
+ * either a path in the file system, or a name in the abstract namespace which
+ * doesn't create a file (Linux only, see
+ * p_socket_address_is_abstract_supported()). Unix domain socket addresses have
+ * no port, and they are not supported on Windows, see
+ * p_socket_address_is_unix_supported().
  */
 
 #if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
@@ -75,15 +94,36 @@ typedef enum PSocketFamily_ {
 	P_SOCKET_FAMILY_UNKNOWN = 0,		/**< Unknown family.	*/
 	P_SOCKET_FAMILY_INET	= AF_INET,	/**< IPv4 family.	*/
 #ifdef AF_INET6
-	P_SOCKET_FAMILY_INET6	= AF_INET6	/**< IPv6 family.	*/
+	P_SOCKET_FAMILY_INET6	= AF_INET6,	/**< IPv6 family.	*/
+#else
+	P_SOCKET_FAMILY_INET6	= -1,		/**< No IPv6 family.	*/
+#endif
+#if defined (AF_UNIX) && !defined (P_OS_WIN)
+	P_SOCKET_FAMILY_UNIX	= AF_UNIX	/**< Unix domain family.	*/
 #else
-	P_SOCKET_FAMILY_INET6	= -1		/**< No IPv6 family.	*/
+	P_SOCKET_FAMILY_UNIX	= -2		/**< No Unix domain family.	*/
 #endif
 } PSocketFamily;
 
 /** Socket address opaque structure. */
 typedef struct PSocketAddress_ PSocketAddress;
 
+/** Size of #PSocketAddressStorage, in bytes. */
+#define P_SOCKET_ADDRESS_STORAGE_SIZE		160
+
+/** Buffer size enough to hold any socket address string, including the
+ * terminating zero and Unix domain socket paths. */
+#define P_SOCKET_ADDRESS_MAX_STRING_LEN	110
+
+/** Caller-owned storage for a #PSocketAddress, contents are opaque. */
+typedef struct PSocketAddressStorage_ {
+	union {
+		puint64		align;
+		ppointer	align_ptr;
+		puchar		data[P_SOCKET_ADDRESS_STORAGE_SIZE];
+	} u;
+} PSocketAddressStorage;
+
 /**
  * @brief Creates new #PSocketAddress from the native socket address raw data.
  * @param native Pointer to the native socket address raw data.
@@ -94,6 +134,21 @@ typedef struct PSocketAddress_ PSocketAddress;
 P_LIB_API PSocketAddress *	p_socket_address_new_from_native	(pconstpointer		native,
 									 psize			len);
 
+/**
+ * @brief Initializes #PSocketAddressStorage from the native socket address raw
+ * data.
+ * @param storage Storage to initialize.
+ * @param native Pointer to the native socket address raw data.
+ * @param len Raw data length, in bytes.
+ * @return Pointer to #PSocketAddress inside the @a storage in case of success,
+ * NULL otherwise.
+ * @since 0.0.6
+ * @note Do not free the returned pointer with p_socket_address_free().
+ */
+P_LIB_API PSocketAddress *	p_socket_address_init_from_native	(PSocketAddressStorage	*storage,
+									 pconstpointer		native,
+									 psize			len);
+
 /**
  * @brief Creates new #PSocketAddress.
  * @param address String representation of an address (i.e. "172.146.45.5").
@@ -110,6 +165,85 @@ P_LIB_API PSocketAddress *	p_socket_address_new_from_native	(pconstpointer		nati
 P_LIB_API PSocketAddress *	p_socket_address_new			(const pchar		*address,
 									 puint16		port);
 
+/**
+ * @brief Initializes #PSocketAddressStorage from a string representation of an
+ * address.
+ * @param storage Storage to initialize.
+ * @param address String representation of an address (i.e. "172.146.45.5").
+ * @param port Port number.
+ * @return Pointer to #PSocketAddress inside the @a storage in case of success,
+ * NULL otherwise.
+ * @since 0.0.6
+ * @note Do not free the returned pointer with p_socket_address_free().
+ *
+ * Works the same way as p_socket_address_new() but doesn't allocate memory.
+ */
+P_LIB_API PSocketAddress *	p_socket_address_init			(PSocketAddressStorage	*storage,
+									 const pchar		*address,
+									 puint16		port);
+
+/**
+ * @brief Creates new #PSocketAddress for a Unix domain socket.
+ * @param path Path to the socket in the file system, or a name in the
+ * abstract namespace if @a abstract is TRUE.
+ * @param abstract Whether the @a path is a name in the abstract namespace.
+ * @return Pointer to #PSocketAddress in case of success, NULL otherwise.
+ * @since 0.0.6
+ * @sa p_socket_address_is_unix_supported(),
+ * p_socket_address_is_abstract_supported()
+ *
+ * The @a path length is limited to 107 bytes (or less, depending on the
+ * platform), an empty @a path is not allowed.
+ *
+ * Binding a socket to a path creates a socket file which is not removed when
+ * the socket is closed, and binding fails if the file already exists. Remove
+ * the file with p_file_remove() before binding and after closing the socket.
+ * The abstract namespace doesn't have such a problem: a name is released when
+ * the last socket bound to it is closed.
+ */
+P_LIB_API PSocketAddress *	p_socket_address_new_unix		(const pchar		*path,
+									 pboolean		abstract);
+
+/**
+ * @brief Initializes #PSocketAddressStorage for a Unix domain socket.
+ * @param storage Storage to initialize.
+ * @param path Path to the socket in the file system, or a name in the
+ * abstract namespace if @a abstract is TRUE.
+ * @param abstract Whether the @a path is a name in the abstract namespace.
+ * @return Pointer to #PSocketAddress inside the @a storage in case of success,
+ * NULL otherwise.
+ * @since 0.0.6
+ * @note Do not free the returned pointer with p_socket_address_free().
+ *
+ * Works the same way as p_socket_address_new_unix() but doesn't allocate
+ * memory.
+ */
+P_LIB_API PSocketAddress *	p_socket_address_init_unix		(PSocketAddressStorage	*storage,
+									 const pchar		*path,
+									 pboolean		abstract);
+
+/**
+ * @brief Copies a socket address into #PSocketAddressStorage.
+ * @param addr #PSocketAddress to copy.
+ * @param storage Storage to copy the @a addr into.
+ * @return Pointer to #PSocketAddress inside the @a storage in case of success,
+ * NULL otherwise.
+ * @since 0.0.6
+ * @note Do not free the returned pointer with p_socket_address_free().
+ */
+P_LIB_API PSocketAddress *	p_socket_address_copy_into		(const PSocketAddress	*addr,
+									 PSocketAddressStorage	*storage);
+
+/**
+ * @brief Gets #PSocketAddress stored inside #PSocketAddressStorage.
+ * @param storage Storage previously filled by one of the p_socket_address_init*
+ * calls or by the *_into #PSocket calls.
+ * @return Pointer to #PSocketAddress inside the @a storage.
+ * @since 0.0.6
+ * @note Do not free the returned pointer with p_socket_address_free().
+ */
+P_LIB_API PSocketAddress *	p_socket_address_from_storage		(PSocketAddressStorage	*storage);
+
 /**
  * @brief Creates new #PSocketAddress for the any-address representation.
  * @param family Socket family.
@@ -173,9 +307,28 @@ P_LIB_API PSocketFamily		p_socket_address_get_family		(const PSocketAddress	*add
  * @return Pointer to the string representation of the socket address in case of
  * success, NULL otherwise. The caller takes ownership of the returned pointer.
  * @since 0.0.1
+ *
+ * For a Unix domain socket address it is the socket path, a name in the
+ * abstract namespace is prefixed with the '@' literal. An unnamed Unix domain
+ * socket (i.e. created with p_socket_new_pair()) has an empty address.
  */
 P_LIB_API pchar *		p_socket_address_get_address		(const PSocketAddress	*addr);
 
+/**
+ * @brief Formats a socket address string representation into a buffer.
+ * @param addr #PSocketAddress to get address string for.
+ * @param[out] buf Buffer to put the zero-terminated string into.
+ * @param buflen Size of the @a buf, in bytes.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * A buffer of #P_SOCKET_ADDRESS_MAX_STRING_LEN bytes is enough for any
+ * address.
+ */
+P_LIB_API pboolean		p_socket_address_get_address_into	(const PSocketAddress	*addr,
+									 pchar			*buf,
+									 psize			buflen);
+
 /**
  * @brief Gets a port number of a socket address.
  * @param addr #PSocketAddress to get the port number for.
@@ -251,6 +404,31 @@ P_LIB_API pboolean		p_socket_address_is_scope_id_supported	(void);
  */
 P_LIB_API pboolean		p_socket_address_is_ipv6_supported	(void);
 
+/**
+ * @brief Checks whether Unix domain sockets are supported.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API pboolean		p_socket_address_is_unix_supported	(void);
+
+/**
+ * @brief Checks whether the abstract namespace for Unix domain sockets is
+ * supported.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API pboolean		p_socket_address_is_abstract_supported	(void);
+
+/**
+ * @brief Checks whether a given socket address is a Unix domain socket name in
+ * the abstract namespace.
+ * @param addr #PSocketAddress to check.
+ * @return TRUE if the @a addr is in the abstract namespace, FALSE otherwise.
+ * @since 0.0.6
+ * @sa p_socket_address_new_unix()
+ */
+P_LIB_API pboolean		p_socket_address_is_abstract		(const PSocketAddress	*addr);
+
 /**
  * @brief Checks whether a given socket address is an any-address
  * representation. Such an address is a 0.0.0.0.
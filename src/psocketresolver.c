@@ -0,0 +1,939 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "pmutex.h"
+#include "pcondvariable.h"
+#include "prwlock.h"
+#include "patomic.h"
+#include "pstring.h"
+#include "pstring-private.h"
+#include "puthread.h"
+#include "ptimeprofiler.h"
+#include "psocketresolver.h"
+#include "perror-private.h"
+#include "plibsys-private.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined (PLIBSYS_HAS_GETADDRINFO) && !defined (PLIBSYS_SOCKADDR_IN6_HAS_SCOPEID)
+#  undef PLIBSYS_HAS_GETADDRINFO
+#endif
+
+#ifdef PLIBSYS_HAS_GETADDRINFO
+#  include <netdb.h>
+#endif
+
+#ifdef P_OS_VMS
+#  if PLIBSYS_SIZEOF_VOID_P == 8
+#    define addrinfo __addrinfo64
+#  endif
+#endif
+
+#if defined (P_OS_BEOS) || defined (P_OS_OS2)
+#  ifdef AF_INET6
+#    undef AF_INET6
+#  endif
+#endif
+
+#define P_SOCKET_RESOLVER_CACHE_BUCKETS	64
+#define P_SOCKET_RESOLVER_CACHE_MAX	256
+
+typedef enum PSocketResolveState_ {
+	P_SOCKET_RESOLVE_STATE_PENDING	= 0,
+	P_SOCKET_RESOLVE_STATE_RUNNING	= 1,
+	P_SOCKET_RESOLVE_STATE_CALLBACK	= 2,
+	P_SOCKET_RESOLVE_STATE_DONE	= 3
+} PSocketResolveState;
+
+typedef struct PSocketResolverEntry_ {
+	struct PSocketResolverEntry_	*next;
+	pchar				*host;
+	PSocketFamily			family;
+	puint32				hash;
+	puint64				expire_time;
+	PList				*addrs;
+} PSocketResolverEntry;
+
+struct PSocketResolveRequest_ {
+	volatile pint		ref_count;
+	PSocketResolveRequest	*next;
+	PMutex			*mutex;
+	PCondVariable		*cond;
+	PSocketResolveFunc	func;
+	ppointer		user_data;
+	pchar			*host;
+	puint16			port;
+	PSocketFamily		family;
+	PSocketResolveState	state;
+	pboolean		cancelled;
+	P_HANDLE		callback_thread;
+	PList			*result;
+	PError			*error;
+};
+
+struct PSocketResolver_ {
+	PMutex			*mutex;
+	PCondVariable		*cond;
+	PSocketResolveRequest	*queue_head;
+	PSocketResolveRequest	*queue_tail;
+	pboolean		stopping;
+	PUThread		**threads;
+	pint			threads_count;
+	PRWLock			*cache_lock;
+	PSocketResolverEntry	*cache[P_SOCKET_RESOLVER_CACHE_BUCKETS];
+	psize			cache_count;
+	puint32			cache_ttl;
+	PTimeProfiler		*timer;
+};
+
+static puint32 pp_socket_resolver_hash (const pchar *host, PSocketFamily family);
+static void pp_socket_resolver_free_list (PList *list);
+static PList * pp_socket_resolver_copy_list (const PList *list, puint16 port);
+static PList * pp_socket_resolver_resolve (const pchar *host, PSocketFamily family, PError **error);
+static PList * pp_socket_resolver_cache_lookup (PSocketResolver *resolver, const pchar *host,
+						puint16 port, PSocketFamily family, pboolean *found);
+static void pp_socket_resolver_cache_insert (PSocketResolver *resolver, const pchar *host,
+					     PSocketFamily family, PList *addrs);
+static void pp_socket_resolver_cache_clear (PSocketResolver *resolver);
+static PList * pp_socket_resolver_lookup_internal (PSocketResolver *resolver, const pchar *host,
+						   puint16 port, PSocketFamily family, PError **error);
+static pboolean pp_socket_resolver_check_args (const PSocketResolver *resolver, const pchar *host,
+					       PSocketFamily family, PError **error);
+static void pp_socket_resolve_request_unref (PSocketResolveRequest *request);
+static void pp_socket_resolve_request_complete (PSocketResolveRequest *request, PList *result, PError *error);
+static void pp_socket_resolver_process (PSocketResolver *resolver, PSocketResolveRequest *request);
+static ppointer pp_socket_resolver_thread_func (ppointer data);
+
+#if defined (P_OS_WIN) || defined (PLIBSYS_HAS_GETADDRINFO)
+static PErrorIO pp_socket_resolver_get_io_from_gai (pint code);
+
+static PErrorIO
+pp_socket_resolver_get_io_from_gai (pint code)
+{
+	/* Some of the codes may be aliased on some platforms, so avoid switch */
+#ifdef EAI_NONAME
+	if (code == EAI_NONAME)
+		return P_ERROR_IO_NOT_EXISTS;
+#endif
+#ifdef EAI_NODATA
+	if (code == EAI_NODATA)
+		return P_ERROR_IO_NOT_EXISTS;
+#endif
+#ifdef EAI_AGAIN
+	if (code == EAI_AGAIN)
+		return P_ERROR_IO_NOT_AVAILABLE;
+#endif
+#ifdef EAI_MEMORY
+	if (code == EAI_MEMORY)
+		return P_ERROR_IO_NO_RESOURCES;
+#endif
+#ifdef EAI_FAMILY
+	if (code == EAI_FAMILY)
+		return P_ERROR_IO_NOT_SUPPORTED;
+#endif
+#ifdef EAI_SYSTEM
+	if (code == EAI_SYSTEM)
+		return p_error_get_last_io ();
+#endif
+
+	return P_ERROR_IO_FAILED;
+}
+#endif
+
+static puint32
+pp_socket_resolver_hash (const pchar	*host,
+			 PSocketFamily	family)
+{
+	return p_string_hash (host, strlen (host)) ^ (puint32) family;
+}
+
+static void
+pp_socket_resolver_free_list (PList *list)
+{
+	p_list_foreach (list, (PFunc) p_socket_address_free, NULL);
+	p_list_free (list);
+}
+
+static PList *
+pp_socket_resolver_copy_list (const PList	*list,
+			      puint16		port)
+{
+	struct sockaddr_storage	sa;
+	PSocketAddress		*addr;
+	PList			*node;
+	PList			*ret = NULL;
+
+	for (; list != NULL; list = list->next) {
+		memset (&sa, 0, sizeof (sa));
+
+		if (P_UNLIKELY (p_socket_address_to_native ((const PSocketAddress *) list->data,
+							    &sa,
+							    sizeof (sa)) == FALSE))
+			continue;
+
+		if (((struct sockaddr *) &sa)->sa_family == AF_INET)
+			((struct sockaddr_in *) &sa)->sin_port = p_htons (port);
+#ifdef AF_INET6
+		else if (((struct sockaddr *) &sa)->sa_family == AF_INET6)
+			((struct sockaddr_in6 *) &sa)->sin6_port = p_htons (port);
+#endif
+
+		if (P_UNLIKELY ((addr = p_socket_address_new_from_native (&sa, sizeof (sa))) == NULL)) {
+			pp_socket_resolver_free_list (ret);
+			return NULL;
+		}
+
+		if (P_UNLIKELY ((node = p_list_prepend (ret, addr)) == NULL)) {
+			p_socket_address_free (addr);
+			pp_socket_resolver_free_list (ret);
+			return NULL;
+		}
+
+		ret = node;
+	}
+
+	return p_list_reverse (ret);
+}
+
+static PList *
+pp_socket_resolver_resolve (const pchar		*host,
+			    PSocketFamily	family,
+			    PError		**error)
+{
+	PSocketAddress	*addr;
+	PList		*ret = NULL;
+#if defined (P_OS_WIN) || defined (PLIBSYS_HAS_GETADDRINFO)
+	struct addrinfo	hints;
+	struct addrinfo	*res;
+	struct addrinfo	*ai;
+	PList		*node;
+	pint		code;
+#endif
+
+	/* Numeric addresses don't need the system resolver */
+	if ((addr = p_socket_address_new (host, 0)) != NULL) {
+		if (family != P_SOCKET_FAMILY_UNKNOWN && p_socket_address_get_family (addr) != family) {
+			p_socket_address_free (addr);
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NOT_EXISTS,
+					     0,
+					     "Numeric address doesn't match the requested socket family");
+			return NULL;
+		}
+
+		if (P_UNLIKELY ((ret = p_list_append (NULL, addr)) == NULL)) {
+			p_socket_address_free (addr);
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for resolved address");
+		}
+
+		return ret;
+	}
+
+#if defined (P_OS_WIN) || defined (PLIBSYS_HAS_GETADDRINFO)
+	memset (&hints, 0, sizeof (hints));
+
+	hints.ai_family   = family == P_SOCKET_FAMILY_UNKNOWN ? AF_UNSPEC : (pint) family;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_protocol = 0;
+
+	if (P_UNLIKELY ((code = getaddrinfo (host, NULL, &hints, &res)) != 0)) {
+		p_error_set_error_p (error,
+				     (pint) pp_socket_resolver_get_io_from_gai (code),
+				     code,
+				     "Failed to call getaddrinfo() to resolve host name");
+		return NULL;
+	}
+
+	for (ai = res; ai != NULL; ai = ai->ai_next) {
+		if ((addr = p_socket_address_new_from_native (ai->ai_addr, (psize) ai->ai_addrlen)) == NULL)
+			continue;
+
+		if (P_UNLIKELY ((node = p_list_prepend (ret, addr)) == NULL)) {
+			p_socket_address_free (addr);
+			pp_socket_resolver_free_list (ret);
+			freeaddrinfo (res);
+
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to allocate memory for resolved address");
+			return NULL;
+		}
+
+		ret = node;
+	}
+
+	freeaddrinfo (res);
+
+	if (P_UNLIKELY (ret == NULL))
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_EXISTS,
+				     0,
+				     "No supported addresses found for host name");
+
+	return p_list_reverse (ret);
+#else
+	p_error_set_error_p (error,
+			     (pint) P_ERROR_IO_NOT_SUPPORTED,
+			     0,
+			     "Host name resolution is not supported on this platform");
+	return NULL;
+#endif
+}
+
+static PList *
+pp_socket_resolver_cache_lookup (PSocketResolver	*resolver,
+				 const pchar		*host,
+				 puint16		port,
+				 PSocketFamily		family,
+				 pboolean		*found)
+{
+	PSocketResolverEntry	*entry;
+	PList			*ret = NULL;
+	puint32			hash;
+	puint64			now;
+
+	*found = FALSE;
+
+	if (resolver->cache_ttl == 0)
+		return NULL;
+
+	hash = pp_socket_resolver_hash (host, family);
+	now  = p_time_profiler_elapsed_usecs (resolver->timer);
+
+	p_rwlock_reader_lock (resolver->cache_lock);
+
+	for (entry = resolver->cache[hash % P_SOCKET_RESOLVER_CACHE_BUCKETS]; entry != NULL; entry = entry->next) {
+		if (entry->hash != hash || entry->family != family || strcmp (entry->host, host) != 0)
+			continue;
+
+		if (entry->expire_time > now) {
+			ret    = pp_socket_resolver_copy_list (entry->addrs, port);
+			*found = ret != NULL;
+		}
+
+		break;
+	}
+
+	p_rwlock_reader_unlock (resolver->cache_lock);
+
+	return ret;
+}
+
+static void
+pp_socket_resolver_cache_insert (PSocketResolver	*resolver,
+				 const pchar		*host,
+				 PSocketFamily		family,
+				 PList			*addrs)
+{
+	PSocketResolverEntry	*entry;
+	PSocketResolverEntry	**link;
+	PSocketResolverEntry	**oldest;
+	puint32			hash;
+	puint64			now;
+	pint			i;
+
+	hash = pp_socket_resolver_hash (host, family);
+	now  = p_time_profiler_elapsed_usecs (resolver->timer);
+
+	p_rwlock_writer_lock (resolver->cache_lock);
+
+	for (entry = resolver->cache[hash % P_SOCKET_RESOLVER_CACHE_BUCKETS]; entry != NULL; entry = entry->next) {
+		if (entry->hash == hash && entry->family == family && strcmp (entry->host, host) == 0) {
+			pp_socket_resolver_free_list (entry->addrs);
+
+			entry->addrs       = addrs;
+			entry->expire_time = now + (puint64) resolver->cache_ttl * 1000;
+
+			p_rwlock_writer_unlock (resolver->cache_lock);
+			return;
+		}
+	}
+
+	if (resolver->cache_count >= P_SOCKET_RESOLVER_CACHE_MAX) {
+		oldest = NULL;
+
+		/* Drop the expired entries first, then the one to expire soonest */
+		for (i = 0; i < P_SOCKET_RESOLVER_CACHE_BUCKETS; ++i) {
+			link = &resolver->cache[i];
+
+			while (*link != NULL) {
+				entry = *link;
+
+				if (entry->expire_time <= now) {
+					*link = entry->next;
+
+					pp_socket_resolver_free_list (entry->addrs);
+					p_free (entry->host);
+					p_free (entry);
+
+					--resolver->cache_count;
+					continue;
+				}
+
+				if (oldest == NULL || entry->expire_time < (*oldest)->expire_time)
+					oldest = link;
+
+				link = &entry->next;
+			}
+		}
+
+		if (resolver->cache_count >= P_SOCKET_RESOLVER_CACHE_MAX && oldest != NULL) {
+			entry   = *oldest;
+			*oldest = entry->next;
+
+			pp_socket_resolver_free_list (entry->addrs);
+			p_free (entry->host);
+			p_free (entry);
+
+			--resolver->cache_count;
+		}
+	}
+
+	if (P_UNLIKELY ((entry = p_malloc0 (sizeof (PSocketResolverEntry))) == NULL ||
+			(entry->host = p_strdup (host)) == NULL)) {
+		p_free (entry);
+		p_rwlock_writer_unlock (resolver->cache_lock);
+		pp_socket_resolver_free_list (addrs);
+		return;
+	}
+
+	entry->family      = family;
+	entry->hash        = hash;
+	entry->expire_time = now + (puint64) resolver->cache_ttl * 1000;
+	entry->addrs       = addrs;
+	entry->next        = resolver->cache[hash % P_SOCKET_RESOLVER_CACHE_BUCKETS];
+
+	resolver->cache[hash % P_SOCKET_RESOLVER_CACHE_BUCKETS] = entry;
+	++resolver->cache_count;
+
+	p_rwlock_writer_unlock (resolver->cache_lock);
+}
+
+static void
+pp_socket_resolver_cache_clear (PSocketResolver *resolver)
+{
+	PSocketResolverEntry	*entry;
+	pint			i;
+
+	for (i = 0; i < P_SOCKET_RESOLVER_CACHE_BUCKETS; ++i) {
+		while ((entry = resolver->cache[i]) != NULL) {
+			resolver->cache[i] = entry->next;
+
+			pp_socket_resolver_free_list (entry->addrs);
+			p_free (entry->host);
+			p_free (entry);
+		}
+	}
+
+	resolver->cache_count = 0;
+}
+
+static PList *
+pp_socket_resolver_lookup_internal (PSocketResolver	*resolver,
+				    const pchar		*host,
+				    puint16		port,
+				    PSocketFamily	family,
+				    PError		**error)
+{
+	PList		*addrs;
+	PList		*ret;
+	pboolean	found;
+
+	ret = pp_socket_resolver_cache_lookup (resolver, host, port, family, &found);
+
+	if (found == TRUE)
+		return ret;
+
+	if ((addrs = pp_socket_resolver_resolve (host, family, error)) == NULL)
+		return NULL;
+
+	if (P_UNLIKELY ((ret = pp_socket_resolver_copy_list (addrs, port)) == NULL)) {
+		pp_socket_resolver_free_list (addrs);
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for resolved address");
+		return NULL;
+	}
+
+	if (resolver->cache_ttl > 0)
+		pp_socket_resolver_cache_insert (resolver, host, family, addrs);
+	else
+		pp_socket_resolver_free_list (addrs);
+
+	return ret;
+}
+
+static pboolean
+pp_socket_resolver_check_args (const PSocketResolver	*resolver,
+			       const pchar		*host,
+			       PSocketFamily		family,
+			       PError			**error)
+{
+	if (P_UNLIKELY (resolver == NULL || host == NULL || *host == '\0')) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (P_UNLIKELY (family != P_SOCKET_FAMILY_UNKNOWN &&
+			family != P_SOCKET_FAMILY_INET    &&
+			(family != P_SOCKET_FAMILY_INET6 || p_socket_address_is_ipv6_supported () == FALSE))) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NOT_SUPPORTED,
+				     0,
+				     "Unsupported socket family for host name resolution");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void
+pp_socket_resolve_request_unref (PSocketResolveRequest *request)
+{
+	if (p_atomic_int_dec_and_test (&request->ref_count) == FALSE)
+		return;
+
+	if (request->result != NULL)
+		pp_socket_resolver_free_list (request->result);
+
+	if (request->error != NULL)
+		p_error_free (request->error);
+
+	if (request->cond != NULL)
+		p_cond_variable_free (request->cond);
+
+	if (request->mutex != NULL)
+		p_mutex_free (request->mutex);
+
+	p_free (request->host);
+	p_free (request);
+}
+
+static void
+pp_socket_resolve_request_complete (PSocketResolveRequest	*request,
+				    PList			*result,
+				    PError			*error)
+{
+	p_mutex_lock (request->mutex);
+
+	if (request->cancelled == TRUE) {
+		request->state = P_SOCKET_RESOLVE_STATE_DONE;
+		p_mutex_unlock (request->mutex);
+
+		if (result != NULL)
+			pp_socket_resolver_free_list (result);
+
+		if (error != NULL)
+			p_error_free (error);
+
+		return;
+	}
+
+	request->result = result;
+	request->error  = error;
+
+	if (request->func != NULL) {
+		request->state           = P_SOCKET_RESOLVE_STATE_CALLBACK;
+		request->callback_thread = p_uthread_current_id ();
+		p_mutex_unlock (request->mutex);
+
+		request->func (request, request->user_data);
+
+		p_mutex_lock (request->mutex);
+	}
+
+	request->state = P_SOCKET_RESOLVE_STATE_DONE;
+
+	p_cond_variable_broadcast (request->cond);
+	p_mutex_unlock (request->mutex);
+}
+
+static void
+pp_socket_resolver_process (PSocketResolver		*resolver,
+			    PSocketResolveRequest	*request)
+{
+	PList	*result;
+	PError	*error = NULL;
+
+	p_mutex_lock (request->mutex);
+
+	if (request->cancelled == TRUE) {
+		p_mutex_unlock (request->mutex);
+		pp_socket_resolve_request_unref (request);
+		return;
+	}
+
+	request->state = P_SOCKET_RESOLVE_STATE_RUNNING;
+	p_mutex_unlock (request->mutex);
+
+	result = pp_socket_resolver_lookup_internal (resolver,
+						     request->host,
+						     request->port,
+						     request->family,
+						     &error);
+
+	pp_socket_resolve_request_complete (request, result, error);
+	pp_socket_resolve_request_unref (request);
+}
+
+static ppointer
+pp_socket_resolver_thread_func (ppointer data)
+{
+	PSocketResolver		*resolver = (PSocketResolver *) data;
+	PSocketResolveRequest	*request;
+
+	while (TRUE) {
+		p_mutex_lock (resolver->mutex);
+
+		while (resolver->queue_head == NULL && resolver->stopping == FALSE)
+			p_cond_variable_wait (resolver->cond, resolver->mutex);
+
+		/* Remaining requests are aborted by the resolver itself */
+		if (resolver->stopping == TRUE) {
+			p_mutex_unlock (resolver->mutex);
+			break;
+		}
+
+		request              = resolver->queue_head;
+		resolver->queue_head = request->next;
+
+		if (resolver->queue_head == NULL)
+			resolver->queue_tail = NULL;
+
+		p_mutex_unlock (resolver->mutex);
+
+		request->next = NULL;
+		pp_socket_resolver_process (resolver, request);
+	}
+
+	return NULL;
+}
+
+P_LIB_API PSocketResolver *
+p_socket_resolver_new (pint	threads,
+		       puint32	cache_ttl,
+		       PError	**error)
+{
+	PSocketResolver	*ret;
+	pint		i;
+
+	if (P_UNLIKELY (threads < 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (threads == 0)
+		threads = P_SOCKET_RESOLVER_DEFAULT_THREADS;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocketResolver))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for resolver");
+		return NULL;
+	}
+
+	ret->cache_ttl = cache_ttl;
+
+	if (P_UNLIKELY ((ret->mutex      = p_mutex_new ())                                   == NULL ||
+			(ret->cond       = p_cond_variable_new ())                           == NULL ||
+			(ret->cache_lock = p_rwlock_new ())                                  == NULL ||
+			(ret->timer      = p_time_profiler_new ())                           == NULL ||
+			(ret->threads    = p_malloc0 (sizeof (PUThread *) * (psize) threads)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for resolver");
+		p_socket_resolver_free (ret);
+		return NULL;
+	}
+
+	for (i = 0; i < threads; ++i) {
+		ret->threads[i] = p_uthread_create (pp_socket_resolver_thread_func,
+						    ret,
+						    TRUE,
+						    "PSocketResolver");
+
+		if (P_UNLIKELY (ret->threads[i] == NULL)) {
+			p_error_set_error_p (error,
+					     (pint) P_ERROR_IO_NO_RESOURCES,
+					     0,
+					     "Failed to start resolver thread");
+			p_socket_resolver_free (ret);
+			return NULL;
+		}
+
+		++ret->threads_count;
+	}
+
+	return ret;
+}
+
+P_LIB_API PList *
+p_socket_resolver_lookup (PSocketResolver	*resolver,
+			  const pchar		*host,
+			  puint16		port,
+			  PSocketFamily		family,
+			  PError		**error)
+{
+	if (P_UNLIKELY (pp_socket_resolver_check_args (resolver, host, family, error) == FALSE))
+		return NULL;
+
+	return pp_socket_resolver_lookup_internal (resolver, host, port, family, error);
+}
+
+P_LIB_API PSocketResolveRequest *
+p_socket_resolver_lookup_async (PSocketResolver		*resolver,
+				const pchar		*host,
+				puint16			port,
+				PSocketFamily		family,
+				PSocketResolveFunc	func,
+				ppointer		user_data,
+				PError			**error)
+{
+	PSocketResolveRequest	*ret;
+	PList			*result;
+	pboolean		found;
+
+	if (P_UNLIKELY (pp_socket_resolver_check_args (resolver, host, family, error) == FALSE))
+		return NULL;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocketResolveRequest))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for resolve request");
+		return NULL;
+	}
+
+	ret->ref_count = 1;
+	ret->func      = func;
+	ret->user_data = user_data;
+	ret->port      = port;
+	ret->family    = family;
+	ret->state     = P_SOCKET_RESOLVE_STATE_PENDING;
+
+	if (P_UNLIKELY ((ret->host  = p_strdup (host))          == NULL ||
+			(ret->mutex = p_mutex_new ())           == NULL ||
+			(ret->cond  = p_cond_variable_new ())   == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for resolve request");
+		pp_socket_resolve_request_unref (ret);
+		return NULL;
+	}
+
+	/* Cached results don't need a round trip through the resolver threads */
+	result = pp_socket_resolver_cache_lookup (resolver, host, port, family, &found);
+
+	/* Keep the request alive in case the callback frees it */
+	p_atomic_int_inc (&ret->ref_count);
+
+	if (found == TRUE) {
+		pp_socket_resolve_request_complete (ret, result, NULL);
+		pp_socket_resolve_request_unref (ret);
+		return ret;
+	}
+
+	p_mutex_lock (resolver->mutex);
+
+	if (resolver->queue_tail != NULL)
+		resolver->queue_tail->next = ret;
+	else
+		resolver->queue_head = ret;
+
+	resolver->queue_tail = ret;
+
+	p_cond_variable_signal (resolver->cond);
+	p_mutex_unlock (resolver->mutex);
+
+	return ret;
+}
+
+P_LIB_API void
+p_socket_resolver_clear_cache (PSocketResolver *resolver)
+{
+	if (P_UNLIKELY (resolver == NULL))
+		return;
+
+	p_rwlock_writer_lock (resolver->cache_lock);
+	pp_socket_resolver_cache_clear (resolver);
+	p_rwlock_writer_unlock (resolver->cache_lock);
+}
+
+P_LIB_API void
+p_socket_resolver_free (PSocketResolver *resolver)
+{
+	PSocketResolveRequest	*request;
+	PError			*error;
+	pint			i;
+
+	if (P_UNLIKELY (resolver == NULL))
+		return;
+
+	if (resolver->threads_count > 0) {
+		p_mutex_lock (resolver->mutex);
+		resolver->stopping = TRUE;
+		p_cond_variable_broadcast (resolver->cond);
+		p_mutex_unlock (resolver->mutex);
+
+		for (i = 0; i < resolver->threads_count; ++i) {
+			p_uthread_join (resolver->threads[i]);
+			p_uthread_unref (resolver->threads[i]);
+		}
+	}
+
+	while ((request = resolver->queue_head) != NULL) {
+		resolver->queue_head = request->next;
+		request->next        = NULL;
+
+		error = p_error_new_literal ((pint) P_ERROR_IO_ABORTED,
+					     0,
+					     "Resolver has been stopped before processing request");
+
+		pp_socket_resolve_request_complete (request, NULL, error);
+		pp_socket_resolve_request_unref (request);
+	}
+
+	pp_socket_resolver_cache_clear (resolver);
+
+	if (resolver->timer != NULL)
+		p_time_profiler_free (resolver->timer);
+
+	if (resolver->cache_lock != NULL)
+		p_rwlock_free (resolver->cache_lock);
+
+	if (resolver->cond != NULL)
+		p_cond_variable_free (resolver->cond);
+
+	if (resolver->mutex != NULL)
+		p_mutex_free (resolver->mutex);
+
+	p_free (resolver->threads);
+	p_free (resolver);
+}
+
+P_LIB_API pboolean
+p_socket_resolve_request_is_done (PSocketResolveRequest *request)
+{
+	pboolean ret;
+
+	if (P_UNLIKELY (request == NULL))
+		return FALSE;
+
+	p_mutex_lock (request->mutex);
+	ret = request->state == P_SOCKET_RESOLVE_STATE_DONE;
+	p_mutex_unlock (request->mutex);
+
+	return ret;
+}
+
+P_LIB_API void
+p_socket_resolve_request_wait (PSocketResolveRequest *request)
+{
+	if (P_UNLIKELY (request == NULL))
+		return;
+
+	p_mutex_lock (request->mutex);
+
+	while (request->state != P_SOCKET_RESOLVE_STATE_DONE)
+		p_cond_variable_wait (request->cond, request->mutex);
+
+	p_mutex_unlock (request->mutex);
+}
+
+P_LIB_API PList *
+p_socket_resolve_request_take_result (PSocketResolveRequest	*request,
+				      PError			**error)
+{
+	PList *ret = NULL;
+
+	if (P_UNLIKELY (request == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	p_mutex_lock (request->mutex);
+
+	if (request->state != P_SOCKET_RESOLVE_STATE_DONE &&
+	    request->state != P_SOCKET_RESOLVE_STATE_CALLBACK)
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_IN_PROGRESS,
+				     0,
+				     "Resolve request is not completed yet");
+	else if (request->error != NULL) {
+		if (error != NULL)
+			*error = p_error_copy (request->error);
+	} else if (request->result == NULL)
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_MORE,
+				     0,
+				     "Resolve request result has been already taken");
+	else {
+		ret             = request->result;
+		request->result = NULL;
+	}
+
+	p_mutex_unlock (request->mutex);
+
+	return ret;
+}
+
+P_LIB_API void
+p_socket_resolve_request_free (PSocketResolveRequest *request)
+{
+	if (P_UNLIKELY (request == NULL))
+		return;
+
+	p_mutex_lock (request->mutex);
+
+	request->cancelled = TRUE;
+
+	/* Callback may use the user data, do not let it outlive the request */
+	while (request->state == P_SOCKET_RESOLVE_STATE_CALLBACK &&
+	       request->callback_thread != p_uthread_current_id ())
+		p_cond_variable_wait (request->cond, request->mutex);
+
+	p_mutex_unlock (request->mutex);
+
+	pp_socket_resolve_request_unref (request);
+}
@@ -0,0 +1,223 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file psocketresolver.h
+ * @brief Asynchronous host name resolution
+ * @author Alexander Saprykin
+ *
+ * #PSocketAddress understands only numeric network addresses. To connect to a
+ * host given by its name, the name should be resolved into one or more socket
+ * addresses first. Name resolution usually involves a network round trip and
+ * may take a considerable amount of time, so doing it on the thread which is
+ * going to use the connection adds the resolver latency to the connection
+ * setup.
+ *
+ * #PSocketResolver owns a small pool of threads which perform lookups on
+ * behalf of the caller. Use p_socket_resolver_lookup_async() to start a
+ * lookup: it returns immediately with a #PSocketResolveRequest handle. The
+ * completion can be either signalled through a callback, which is called from
+ * one of the resolver threads, or checked with
+ * p_socket_resolve_request_is_done() and p_socket_resolve_request_wait(). When
+ * the request is completed, use p_socket_resolve_request_take_result() to get
+ * the list of resolved addresses.
+ *
+ * p_socket_resolver_lookup() performs the same lookup synchronously on the
+ * calling thread.
+ *
+ * Successful results are kept in a resolver cache and reused by subsequent
+ * lookups of the same host name and socket family, so repeated lookups don't
+ * hit the system resolver. The system resolver doesn't report a DNS record
+ * lifetime, thus the cache uses the time-to-live value given to
+ * p_socket_resolver_new() for all the entries. Failed lookups are not cached.
+ *
+ * Numeric addresses are accepted as well and don't involve the system
+ * resolver, so the same code path can be used for both the host names and the
+ * IP addresses.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSOCKETRESOLVER_H
+#define PLIBSYS_HEADER_PSOCKETRESOLVER_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+#include <plist.h>
+#include <perror.h>
+#include <psocketaddress.h>
+
+P_BEGIN_DECLS
+
+/** Default number of the resolver threads. */
+#define P_SOCKET_RESOLVER_DEFAULT_THREADS	2
+
+/** Default cache time-to-live, in milliseconds. */
+#define P_SOCKET_RESOLVER_DEFAULT_TTL		60000
+
+/** Host name resolver opaque structure. */
+typedef struct PSocketResolver_ PSocketResolver;
+
+/** Asynchronous resolve request opaque structure. */
+typedef struct PSocketResolveRequest_ PSocketResolveRequest;
+
+/**
+ * @brief Resolve request completion callback.
+ * @param request Completed request.
+ * @param user_data Data given to p_socket_resolver_lookup_async().
+ * @since 0.0.6
+ *
+ * The callback is called from one of the resolver threads, or from the thread
+ * calling p_socket_resolver_free() for the requests which were not processed
+ * yet. It is allowed to take the result and free the @a request inside the
+ * callback.
+ */
+typedef void (*PSocketResolveFunc) (PSocketResolveRequest *request, ppointer user_data);
+
+/**
+ * @brief Creates a new #PSocketResolver.
+ * @param threads Number of the resolver threads, pass 0 to use
+ * #P_SOCKET_RESOLVER_DEFAULT_THREADS.
+ * @param cache_ttl Time-to-live of the cached results, in milliseconds, pass 0
+ * to disable caching.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PSocketResolver in case of success, NULL otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API PSocketResolver *	p_socket_resolver_new			(pint			threads,
+									 puint32		cache_ttl,
+									 PError			**error);
+
+/**
+ * @brief Resolves a host name synchronously.
+ * @param resolver #PSocketResolver to use the cache of.
+ * @param host Host name or a numeric address to resolve.
+ * @param port Port number to set for all the resolved addresses.
+ * @param family Socket family to resolve the @a host for,
+ * #P_SOCKET_FAMILY_UNKNOWN to accept any family.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return List of #PSocketAddress in case of success, NULL otherwise.
+ * @since 0.0.6
+ *
+ * The lookup is performed on the calling thread. The caller takes ownership of
+ * the returned list and all the addresses in it. Addresses are ordered as the
+ * system resolver returned them, so the first one is the preferred one.
+ */
+P_LIB_API PList *		p_socket_resolver_lookup		(PSocketResolver	*resolver,
+									 const pchar		*host,
+									 puint16		port,
+									 PSocketFamily		family,
+									 PError			**error);
+
+/**
+ * @brief Starts an asynchronous host name resolution.
+ * @param resolver #PSocketResolver to perform the lookup with.
+ * @param host Host name or a numeric address to resolve.
+ * @param port Port number to set for all the resolved addresses.
+ * @param family Socket family to resolve the @a host for,
+ * #P_SOCKET_FAMILY_UNKNOWN to accept any family.
+ * @param func Completion callback, NULL to poll the request instead.
+ * @param user_data Data to pass to the @a func.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to #PSocketResolveRequest in case of success, NULL
+ * otherwise.
+ * @since 0.0.6
+ *
+ * If the result is already cached, the request is completed (and the @a func
+ * is called) before returning. The returned request should be freed with
+ * p_socket_resolve_request_free() in any case.
+ */
+P_LIB_API PSocketResolveRequest *	p_socket_resolver_lookup_async	(PSocketResolver	*resolver,
+									 const pchar		*host,
+									 puint16		port,
+									 PSocketFamily		family,
+									 PSocketResolveFunc	func,
+									 ppointer		user_data,
+									 PError			**error);
+
+/**
+ * @brief Drops all the cached lookup results.
+ * @param resolver #PSocketResolver to clear the cache for.
+ * @since 0.0.6
+ */
+P_LIB_API void			p_socket_resolver_clear_cache		(PSocketResolver	*resolver);
+
+/**
+ * @brief Stops the resolver threads and frees the #PSocketResolver.
+ * @param resolver #PSocketResolver to free.
+ * @since 0.0.6
+ *
+ * Lookups which are already in progress are completed first. Requests which
+ * have not been processed yet are completed with the #P_ERROR_IO_ABORTED
+ * error. Requests remain valid after the resolver is freed.
+ */
+P_LIB_API void			p_socket_resolver_free			(PSocketResolver	*resolver);
+
+/**
+ * @brief Checks whether a resolve request is completed.
+ * @param request #PSocketResolveRequest to check.
+ * @return TRUE if the @a request is completed, FALSE otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API pboolean		p_socket_resolve_request_is_done	(PSocketResolveRequest	*request);
+
+/**
+ * @brief Waits for a resolve request to complete.
+ * @param request #PSocketResolveRequest to wait for.
+ * @since 0.0.6
+ * @note Do not call it from the completion callback.
+ */
+P_LIB_API void			p_socket_resolve_request_wait		(PSocketResolveRequest	*request);
+
+/**
+ * @brief Takes the result of a completed resolve request.
+ * @param request Completed #PSocketResolveRequest.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return List of #PSocketAddress in case of success, NULL otherwise.
+ * @since 0.0.6
+ *
+ * The caller takes ownership of the returned list and all the addresses in it,
+ * so the result can be taken only once. NULL is returned if the @a request is
+ * not completed yet.
+ */
+P_LIB_API PList *		p_socket_resolve_request_take_result	(PSocketResolveRequest	*request,
+									 PError			**error);
+
+/**
+ * @brief Frees a resolve request.
+ * @param request #PSocketResolveRequest to free.
+ * @since 0.0.6
+ *
+ * If the @a request is not completed yet, it is cancelled and the completion
+ * callback will not be called. If the callback is running on another thread at
+ * the moment, this call waits for it to return.
+ */
+P_LIB_API void			p_socket_resolve_request_free		(PSocketResolveRequest	*request);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSOCKETRESOLVER_H */
@@ -0,0 +1,491 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pmem.h"
+#include "psocketstream.h"
+
+#include <string.h>
+
+/* Default size of the read and write buffers */
+#define P_SOCKET_STREAM_DEFAULT_SIZE	16384
+
+struct PSocketStream_ {
+	PSocket		*socket;
+	pchar		*read_buf;
+	psize		read_size;
+	psize		read_start;
+	psize		read_end;
+	pchar		*write_buf;
+	psize		write_size;
+	psize		write_len;
+};
+
+static pssize pp_socket_stream_fill (PSocketStream *stream, PError **error);
+static void pp_socket_stream_take (PSocketStream *stream, pchar *buffer, psize len);
+static pssize pp_socket_stream_find (const pchar *data, psize len, const pchar *delim, psize delim_len);
+static pboolean pp_socket_stream_send_all (PSocket *socket, const pchar *data, psize len, psize *sent, PError **error);
+
+static pssize
+pp_socket_stream_fill (PSocketStream	*stream,
+		       PError		**error)
+{
+	pssize ret;
+
+	if (stream->read_start == stream->read_end) {
+		stream->read_start = 0;
+		stream->read_end   = 0;
+	} else if (stream->read_end == stream->read_size && stream->read_start > 0) {
+		/* Move the rest of the data to the beginning to make room */
+		memmove (stream->read_buf,
+			 stream->read_buf + stream->read_start,
+			 stream->read_end - stream->read_start);
+
+		stream->read_end  -= stream->read_start;
+		stream->read_start = 0;
+	}
+
+	ret = p_socket_receive (stream->socket,
+				stream->read_buf + stream->read_end,
+				stream->read_size - stream->read_end,
+				error);
+
+	if (ret > 0)
+		stream->read_end += (psize) ret;
+
+	return ret;
+}
+
+static void
+pp_socket_stream_take (PSocketStream	*stream,
+		       pchar		*buffer,
+		       psize		len)
+{
+	memcpy (buffer, stream->read_buf + stream->read_start, len);
+
+	stream->read_start += len;
+}
+
+static pssize
+pp_socket_stream_find (const pchar	*data,
+		       psize		len,
+		       const pchar	*delim,
+		       psize		delim_len)
+{
+	const pchar	*ptr;
+	const pchar	*end;
+
+	if (len < delim_len)
+		return -1;
+
+	ptr = data;
+	end = data + len - delim_len + 1;
+
+	while (ptr < end) {
+		if ((ptr = memchr (ptr, delim[0], (psize) (end - ptr))) == NULL)
+			return -1;
+
+		if (memcmp (ptr, delim, delim_len) == 0)
+			return (pssize) (ptr - data);
+
+		++ptr;
+	}
+
+	return -1;
+}
+
+static pboolean
+pp_socket_stream_send_all (PSocket	*socket,
+			   const pchar	*data,
+			   psize	len,
+			   psize	*sent,
+			   PError	**error)
+{
+	pssize ret;
+
+	*sent = 0;
+
+	while (*sent < len) {
+		if ((ret = p_socket_send (socket, data + *sent, len - *sent, error)) < 0)
+			return FALSE;
+
+		*sent += (psize) ret;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API PSocketStream *
+p_socket_stream_new (PSocket	*socket,
+		     psize	read_size,
+		     psize	write_size,
+		     PError	**error)
+{
+	PSocketStream *ret;
+
+	if (P_UNLIKELY (socket == NULL || p_socket_get_type (socket) != P_SOCKET_TYPE_STREAM)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return NULL;
+	}
+
+	if (read_size == 0)
+		read_size = P_SOCKET_STREAM_DEFAULT_SIZE;
+
+	if (write_size == 0)
+		write_size = P_SOCKET_STREAM_DEFAULT_SIZE;
+
+	if (P_UNLIKELY (read_size + write_size < read_size)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Too large buffer size");
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PSocketStream))) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket stream");
+		return NULL;
+	}
+
+	/* Both buffers share the same memory block */
+	if (P_UNLIKELY ((ret->read_buf = p_malloc (read_size + write_size)) == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_NO_RESOURCES,
+				     0,
+				     "Failed to allocate memory for socket stream buffers");
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->socket     = socket;
+	ret->read_size  = read_size;
+	ret->write_buf  = ret->read_buf + read_size;
+	ret->write_size = write_size;
+
+	return ret;
+}
+
+P_LIB_API PSocket *
+p_socket_stream_get_socket (const PSocketStream *stream)
+{
+	if (P_UNLIKELY (stream == NULL))
+		return NULL;
+
+	return stream->socket;
+}
+
+P_LIB_API psize
+p_socket_stream_get_buffered (const PSocketStream *stream)
+{
+	if (P_UNLIKELY (stream == NULL))
+		return 0;
+
+	return stream->read_end - stream->read_start;
+}
+
+P_LIB_API psize
+p_socket_stream_get_unflushed (const PSocketStream *stream)
+{
+	if (P_UNLIKELY (stream == NULL))
+		return 0;
+
+	return stream->write_len;
+}
+
+P_LIB_API pssize
+p_socket_stream_read (PSocketStream	*stream,
+		      pchar		*buffer,
+		      psize		buflen,
+		      PError		**error)
+{
+	pssize	ret;
+	psize	avail;
+
+	if (P_UNLIKELY (stream == NULL || buffer == NULL || buflen == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (stream->read_start == stream->read_end) {
+		/* Nothing to gain from copying through the buffer */
+		if (buflen >= stream->read_size)
+			return p_socket_receive (stream->socket, buffer, buflen, error);
+
+		if ((ret = pp_socket_stream_fill (stream, error)) <= 0)
+			return ret;
+	}
+
+	avail = stream->read_end - stream->read_start;
+	avail = avail < buflen ? avail : buflen;
+
+	pp_socket_stream_take (stream, buffer, avail);
+
+	return (pssize) avail;
+}
+
+P_LIB_API pssize
+p_socket_stream_read_exact (PSocketStream	*stream,
+			    pchar		*buffer,
+			    psize		len,
+			    PError		**error)
+{
+	pssize	ret;
+	psize	avail;
+
+	if (P_UNLIKELY (stream == NULL || buffer == NULL || len == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (len <= stream->read_size) {
+		/* Keep the data buffered until it is complete, so a failed call
+		 * can be repeated */
+		while ((avail = stream->read_end - stream->read_start) < len) {
+			if ((ret = pp_socket_stream_fill (stream, error)) < 0)
+				return -1;
+
+			if (ret == 0) {
+				pp_socket_stream_take (stream, buffer, avail);
+				return (pssize) avail;
+			}
+		}
+
+		pp_socket_stream_take (stream, buffer, len);
+
+		return (pssize) len;
+	}
+
+	avail = stream->read_end - stream->read_start;
+
+	pp_socket_stream_take (stream, buffer, avail);
+
+	/* Buffered data is already taken from the stream, so report it with a
+	 * short count rather than lose it in case of error */
+	while (avail < len) {
+		if ((ret = p_socket_receive (stream->socket,
+					     buffer + avail,
+					     len - avail,
+					     avail > 0 ? NULL : error)) < 0)
+			return avail > 0 ? (pssize) avail : -1;
+
+		if (ret == 0)
+			break;
+
+		avail += (psize) ret;
+	}
+
+	return (pssize) avail;
+}
+
+P_LIB_API pssize
+p_socket_stream_read_until (PSocketStream	*stream,
+			    const pchar		*delim,
+			    psize		delim_len,
+			    pchar		*buffer,
+			    psize		buflen,
+			    PError		**error)
+{
+	pssize	ret;
+	pssize	pos;
+	psize	avail;
+	psize	window;
+	psize	scanned;
+	psize	from;
+
+	if (P_UNLIKELY (stream == NULL || delim == NULL || delim_len == 0 ||
+			buffer == NULL || buflen == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	scanned = 0;
+
+	for (;;) {
+		avail  = stream->read_end - stream->read_start;
+		window = avail < buflen ? avail : buflen;
+
+		/* Don't scan the same data twice, but mind the delimiter
+		 * which may be split between the old and the new data */
+		from = scanned >= delim_len ? scanned - delim_len + 1 : 0;
+		pos  = pp_socket_stream_find (stream->read_buf + stream->read_start + from,
+					      window - from,
+					      delim,
+					      delim_len);
+
+		if (pos >= 0) {
+			window = from + (psize) pos + delim_len;
+			pp_socket_stream_take (stream, buffer, window);
+
+			return (pssize) window;
+		}
+
+		if (avail >= buflen || avail == stream->read_size) {
+			pp_socket_stream_take (stream, buffer, window);
+
+			return (pssize) window;
+		}
+
+		scanned = window;
+
+		if ((ret = pp_socket_stream_fill (stream, error)) < 0)
+			return -1;
+
+		if (ret == 0) {
+			pp_socket_stream_take (stream, buffer, avail);
+
+			return (pssize) avail;
+		}
+	}
+}
+
+P_LIB_API pssize
+p_socket_stream_peek (PSocketStream	*stream,
+		      psize		len,
+		      const pchar	**data,
+		      PError		**error)
+{
+	pssize ret;
+
+	if (P_UNLIKELY (stream == NULL || data == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (len > stream->read_size)
+		len = stream->read_size;
+
+	while (stream->read_end - stream->read_start < len) {
+		if ((ret = pp_socket_stream_fill (stream, error)) < 0)
+			return -1;
+
+		if (ret == 0)
+			break;
+	}
+
+	*data = stream->read_buf + stream->read_start;
+
+	return (pssize) (stream->read_end - stream->read_start);
+}
+
+P_LIB_API pssize
+p_socket_stream_write (PSocketStream	*stream,
+		       const pchar	*buffer,
+		       psize		buflen,
+		       PError		**error)
+{
+	pssize	ret;
+	psize	sent;
+
+	if (P_UNLIKELY (stream == NULL || buffer == NULL || buflen == 0)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return -1;
+	}
+
+	if (buflen > stream->write_size - stream->write_len &&
+	    P_UNLIKELY (p_socket_stream_flush (stream, error) == FALSE))
+		return -1;
+
+	if (buflen >= stream->write_size) {
+		/* Once some data has been sent, return a short count instead of
+		 * an error, so the caller knows where to continue from */
+		for (sent = 0; sent < buflen; sent += (psize) ret) {
+			if ((ret = p_socket_send (stream->socket,
+						  buffer + sent,
+						  buflen - sent,
+						  sent > 0 ? NULL : error)) < 0)
+				return sent > 0 ? (pssize) sent : -1;
+		}
+
+		return (pssize) buflen;
+	}
+
+	memcpy (stream->write_buf + stream->write_len, buffer, buflen);
+	stream->write_len += buflen;
+
+	return (pssize) buflen;
+}
+
+P_LIB_API pboolean
+p_socket_stream_flush (PSocketStream	*stream,
+		       PError		**error)
+{
+	psize sent;
+
+	if (P_UNLIKELY (stream == NULL)) {
+		p_error_set_error_p (error,
+				     (pint) P_ERROR_IO_INVALID_ARGUMENT,
+				     0,
+				     "Invalid input argument");
+		return FALSE;
+	}
+
+	if (stream->write_len == 0)
+		return TRUE;
+
+	if (P_UNLIKELY (pp_socket_stream_send_all (stream->socket,
+						   stream->write_buf,
+						   stream->write_len,
+						   &sent,
+						   error) == FALSE)) {
+		memmove (stream->write_buf, stream->write_buf + sent, stream->write_len - sent);
+		stream->write_len -= sent;
+
+		return FALSE;
+	}
+
+	stream->write_len = 0;
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_socket_stream_free (PSocketStream *stream)
+{
+	if (P_UNLIKELY (stream == NULL))
+		return;
+
+	p_free (stream->read_buf);
+	p_free (stream);
+}
@@ -0,0 +1,271 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file psocketstream.h
+ * @brief Buffered socket stream
+ * @author Alexander Saprykin
+ *
+ * Parsing a protocol directly on top of p_socket_receive() takes a system
+ * call for every small field being read, and every protocol implementation
+ * has to deal with partially received messages on its own. Sending small
+ * pieces of a message with p_socket_send() has the same problem, and also
+ * produces many small network packets.
+ *
+ * #PSocketStream wraps a connected stream #PSocket with a read and a write
+ * buffer. Reading calls take the data from the read buffer and fill it from
+ * the socket only when it runs out of data, so the socket is read in large
+ * chunks. Writing calls put the data into the write buffer which is sent to
+ * the socket when it gets full or when p_socket_stream_flush() is called.
+ *
+ * The following reading calls are available:
+ * - p_socket_stream_read() reads as much data as is available, up to the
+ * given size;
+ * - p_socket_stream_read_exact() reads exactly the given number of bytes,
+ * which fits length-prefixed protocols;
+ * - p_socket_stream_read_until() reads up to and including a delimiter,
+ * which fits line-based protocols;
+ * - p_socket_stream_peek() gives access to the buffered data without
+ * consuming it, i.e. to look at a message header before reading it.
+ *
+ * The stream doesn't own the socket: the socket must remain valid while the
+ * stream is used, and it is not closed when the stream is freed. Data written
+ * to the stream but not flushed yet is discarded when the stream is freed, so
+ * call p_socket_stream_flush() before.
+ *
+ * The stream is meant to be used with a socket in a blocking mode, see
+ * p_socket_set_blocking(). With a non-blocking socket a call may fail with
+ * #P_ERROR_IO_WOULD_BLOCK, in that case it can be repeated later without
+ * losing the data as long as the requested size doesn't exceed the buffer
+ * size.
+ *
+ * #PSocketStream object is not thread-safe.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSOCKETSTREAM_H
+#define PLIBSYS_HEADER_PSOCKETSTREAM_H
+
+#include <pmacros.h>
+#include <ptypes.h>
+#include <perror.h>
+#include <psocket.h>
+
+P_BEGIN_DECLS
+
+/** Buffered socket stream opaque data structure. */
+typedef struct PSocketStream_ PSocketStream;
+
+/**
+ * @brief Creates a new #PSocketStream object.
+ * @param socket Connected stream #PSocket to wrap.
+ * @param read_size Size of the read buffer in bytes, 0 to use the default
+ * size.
+ * @param write_size Size of the write buffer in bytes, 0 to use the default
+ * size.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Pointer to a newly created #PSocketStream object in case of
+ * success, NULL otherwise.
+ * @since 0.0.6
+ *
+ * The default size of the buffers is 16 KiB. The @a socket must be of the
+ * #P_SOCKET_TYPE_STREAM type.
+ */
+P_LIB_API PSocketStream *	p_socket_stream_new		(PSocket		*socket,
+								 psize			read_size,
+								 psize			write_size,
+								 PError			**error);
+
+/**
+ * @brief Gets a socket wrapped by a stream.
+ * @param stream #PSocketStream to get the socket for.
+ * @return #PSocket wrapped by the @a stream, NULL in case of error.
+ * @since 0.0.6
+ */
+P_LIB_API PSocket *		p_socket_stream_get_socket	(const PSocketStream	*stream);
+
+/**
+ * @brief Gets the number of bytes available in a read buffer.
+ * @param stream #PSocketStream to get the number of bytes for.
+ * @return Number of bytes which can be read from the @a stream without
+ * accessing the socket.
+ * @since 0.0.6
+ */
+P_LIB_API psize			p_socket_stream_get_buffered	(const PSocketStream	*stream);
+
+/**
+ * @brief Gets the number of bytes waiting in a write buffer.
+ * @param stream #PSocketStream to get the number of bytes for.
+ * @return Number of bytes written to the @a stream but not sent to the socket
+ * yet.
+ * @since 0.0.6
+ */
+P_LIB_API psize			p_socket_stream_get_unflushed	(const PSocketStream	*stream);
+
+/**
+ * @brief Reads available data from a stream.
+ * @param stream #PSocketStream to read data from.
+ * @param buffer Buffer to put the read data into.
+ * @param buflen Size of the @a buffer in bytes.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of bytes read in case of success, 0 if the connection was
+ * closed by the remote side, -1 otherwise.
+ * @since 0.0.6
+ *
+ * Takes the buffered data if there is any, otherwise reads the socket once.
+ * A read which is not less than the read buffer size bypasses the buffer.
+ */
+P_LIB_API pssize		p_socket_stream_read		(PSocketStream		*stream,
+								 pchar			*buffer,
+								 psize			buflen,
+								 PError			**error);
+
+/**
+ * @brief Reads an exact number of bytes from a stream.
+ * @param stream #PSocketStream to read data from.
+ * @param buffer Buffer to put the read data into.
+ * @param len Number of bytes to read.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return @a len in case of success, a lesser number of bytes if the
+ * connection was closed before all the data was received, -1 otherwise.
+ * @since 0.0.6
+ *
+ * Reads the socket until @a len bytes are received.
+ *
+ * If @a len is not greater than the read buffer size, the data is kept
+ * buffered until it is complete, so a failed call doesn't consume anything and
+ * can be repeated. A bigger read returns a lesser number of bytes in case of
+ * error after some data has been already taken, the error is reported only if
+ * nothing has been read.
+ */
+P_LIB_API pssize		p_socket_stream_read_exact	(PSocketStream		*stream,
+								 pchar			*buffer,
+								 psize			len,
+								 PError			**error);
+
+/**
+ * @brief Reads data from a stream up to a delimiter.
+ * @param stream #PSocketStream to read data from.
+ * @param delim Delimiter to read up to, i.e. "\n" or "\r\n".
+ * @param delim_len Length of the @a delim in bytes.
+ * @param buffer Buffer to put the read data into.
+ * @param buflen Size of the @a buffer in bytes.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of bytes read including the delimiter in case of success, 0
+ * if the connection was closed by the remote side and there is no more data,
+ * -1 otherwise.
+ * @since 0.0.6
+ *
+ * Reads the socket until the @a delim is received, the delimiter is put into
+ * the @a buffer as well.
+ *
+ * The data is returned without the delimiter if it doesn't fit into the
+ * @a buffer or into the read buffer, or if the connection was closed before
+ * the delimiter was received. Check whether the data ends with the @a delim
+ * to distinguish a complete piece of data, the rest of it can be read with
+ * the next call.
+ */
+P_LIB_API pssize		p_socket_stream_read_until	(PSocketStream		*stream,
+								 const pchar		*delim,
+								 psize			delim_len,
+								 pchar			*buffer,
+								 psize			buflen,
+								 PError			**error);
+
+/**
+ * @brief Peeks buffered data from a stream without consuming it.
+ * @param stream #PSocketStream to peek data from.
+ * @param len Number of bytes to make available.
+ * @param[out] data Pointer to store a pointer to the buffered data in.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of bytes available at the @a data in case of success, -1
+ * otherwise.
+ * @since 0.0.6
+ *
+ * Reads the socket until at least @a len bytes are buffered, the @a len is
+ * limited to the read buffer size. Fewer bytes are available only if the
+ * connection was closed by the remote side.
+ *
+ * The data remains in the stream and is returned by the next reading call.
+ * The pointer stored in the @a data is valid until the next call for the
+ * @a stream.
+ */
+P_LIB_API pssize		p_socket_stream_peek		(PSocketStream		*stream,
+								 psize			len,
+								 const pchar		**data,
+								 PError			**error);
+
+/**
+ * @brief Writes data to a stream.
+ * @param stream #PSocketStream to write data to.
+ * @param buffer Buffer with the data to write.
+ * @param buflen Size of the data in the @a buffer in bytes.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return Number of bytes consumed from the @a buffer in case of success, -1
+ * otherwise.
+ * @since 0.0.6
+ *
+ * Puts the data into the write buffer, which is sent to the socket first if
+ * there is not enough space left in it. A write which is not less than the
+ * write buffer size is sent to the socket directly.
+ *
+ * A buffered write either consumes all the @a buflen bytes or nothing in case
+ * of error. A direct write may fail after sending a part of the data: then the
+ * number of the sent bytes is returned without an error, and the caller should
+ * write the rest again. -1 is returned only if nothing has been consumed.
+ */
+P_LIB_API pssize		p_socket_stream_write		(PSocketStream		*stream,
+								 const pchar		*buffer,
+								 psize			buflen,
+								 PError			**error);
+
+/**
+ * @brief Sends buffered data of a stream to the socket.
+ * @param stream #PSocketStream to flush.
+ * @param[out] error Error report object, NULL to ignore.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * In case of error the data which has not been sent remains in the write
+ * buffer, so the call can be repeated.
+ */
+P_LIB_API pboolean		p_socket_stream_flush		(PSocketStream		*stream,
+								 PError			**error);
+
+/**
+ * @brief Frees a #PSocketStream object.
+ * @param stream #PSocketStream to free.
+ * @since 0.0.6
+ *
+ * The unflushed data is discarded. The wrapped socket is not closed.
+ */
+P_LIB_API void			p_socket_stream_free		(PSocketStream		*stream);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSOCKETSTREAM_H */
@@ -0,0 +1,73 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
+#  error "Header files shouldn't be included directly, consider using <plibsys.h> instead."
+#endif
+
+#ifndef PLIBSYS_HEADER_PSTRING_PRIVATE_H
+#define PLIBSYS_HEADER_PSTRING_PRIVATE_H
+
+#include "pmacros.h"
+#include "ptypes.h"
+
+P_BEGIN_DECLS
+
+/**
+ * @brief Gets a string stored right after the entry allocated with
+ * p_string_entry_new().
+ * @param entry Pointer to the entry of the actual structure type.
+ */
+#define P_STRING_ENTRY_DATA(entry) ((const pchar *) ((entry) + 1))
+
+/**
+ * @brief Calculates a FNV-1a hash of the string data.
+ * @param data Data to calculate the hash for.
+ * @param len Length of @a data, in bytes.
+ * @return Hash value.
+ *
+ * The value is stable across processes and platforms, so it can be stored in
+ * the shared memory.
+ */
+puint32		p_string_hash		(const pchar	*data,
+					 psize		len);
+
+/**
+ * @brief Allocates a zeroed entry followed by a copy of the string.
+ * @param entry_size Size of the entry structure, in bytes.
+ * @param data String data to copy, may be not NUL-terminated.
+ * @param len Length of @a data, in bytes.
+ * @return Pointer to the entry in case of success, NULL otherwise.
+ *
+ * The copy is always NUL-terminated, use #P_STRING_ENTRY_DATA to get it.
+ * Free the entry with p_free().
+ */
+ppointer	p_string_entry_new	(psize		entry_size,
+					 const pchar	*data,
+					 psize		len);
+
+P_END_DECLS
+
+#endif /* PLIBSYS_HEADER_PSTRING_PRIVATE_H */
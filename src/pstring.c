@@ -25,13 +25,152 @@
  */
 
 #include "pmem.h"
+#include "pmutex.h"
 #include "pstring.h"
+#include "pstring-private.h"
 
 #include <string.h>
 #include <ctype.h>
 
 #define P_STR_MAX_EXPON		308
 
+#define P_STRING_INTERNER_INITIAL_BUCKETS	64
+
+typedef struct PStringInternEntry_ {
+	struct PStringInternEntry_	*next;
+	puint32				hash;
+	psize				len;
+} PStringInternEntry;
+
+struct PStringInterner_ {
+	PMutex			*mutex;
+	PStringInternEntry	**buckets;
+	psize			num_buckets;
+	psize			count;
+};
+
+static PStringInternEntry * pp_string_interner_find (const PStringInterner *interner, const pchar *data, psize len, puint32 hash);
+static void pp_string_interner_grow (PStringInterner *interner);
+static const pchar * pp_string_interner_intern (PStringInterner *interner, const pchar *data, psize len, pboolean insert);
+
+static PStringInternEntry *
+pp_string_interner_find (const PStringInterner	*interner,
+			 const pchar		*data,
+			 psize			len,
+			 puint32		hash)
+{
+	PStringInternEntry *entry;
+
+	for (entry = interner->buckets[hash % interner->num_buckets]; entry != NULL; entry = entry->next) {
+		if (entry->hash == hash &&
+		    entry->len == len &&
+		    memcmp (P_STRING_ENTRY_DATA (entry), data, len) == 0)
+			return entry;
+	}
+
+	return NULL;
+}
+
+static void
+pp_string_interner_grow (PStringInterner *interner)
+{
+	PStringInternEntry	**buckets;
+	PStringInternEntry	*entry;
+	PStringInternEntry	*next;
+	psize			num_buckets;
+	psize			i;
+
+	num_buckets = interner->num_buckets * 2;
+
+	/* Growing is an optimization only, keep longer chains on failure */
+	if (P_UNLIKELY ((buckets = p_malloc0 (num_buckets * sizeof (PStringInternEntry *))) == NULL))
+		return;
+
+	for (i = 0; i < interner->num_buckets; ++i) {
+		for (entry = interner->buckets[i]; entry != NULL; entry = next) {
+			next = entry->next;
+
+			entry->next                        = buckets[entry->hash % num_buckets];
+			buckets[entry->hash % num_buckets] = entry;
+		}
+	}
+
+	p_free (interner->buckets);
+
+	interner->buckets     = buckets;
+	interner->num_buckets = num_buckets;
+}
+
+static const pchar *
+pp_string_interner_intern (PStringInterner	*interner,
+			   const pchar		*data,
+			   psize		len,
+			   pboolean		insert)
+{
+	PStringInternEntry	*entry;
+	puint32			hash;
+
+	hash = p_string_hash (data, len);
+
+	p_mutex_lock (interner->mutex);
+
+	if ((entry = pp_string_interner_find (interner, data, len, hash)) != NULL || insert == FALSE) {
+		p_mutex_unlock (interner->mutex);
+		return entry != NULL ? P_STRING_ENTRY_DATA (entry) : NULL;
+	}
+
+	if (P_UNLIKELY ((entry = p_string_entry_new (sizeof (PStringInternEntry), data, len)) == NULL)) {
+		p_mutex_unlock (interner->mutex);
+		P_ERROR ("PString::pp_string_interner_intern: failed to allocate memory");
+		return NULL;
+	}
+
+	entry->hash = hash;
+	entry->len  = len;
+
+	if (interner->count >= interner->num_buckets * 2)
+		pp_string_interner_grow (interner);
+
+	entry->next                                     = interner->buckets[hash % interner->num_buckets];
+	interner->buckets[hash % interner->num_buckets] = entry;
+
+	++interner->count;
+
+	p_mutex_unlock (interner->mutex);
+
+	return P_STRING_ENTRY_DATA (entry);
+}
+
+puint32
+p_string_hash (const pchar	*data,
+	       psize		len)
+{
+	puint32 hash = 2166136261U;
+
+	/* FNV-1a */
+	while (len-- > 0) {
+		hash ^= (puint32) (puchar) *data++;
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+ppointer
+p_string_entry_new (psize	entry_size,
+		    const pchar	*data,
+		    psize	len)
+{
+	puchar *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (entry_size + len + 1)) == NULL))
+		return NULL;
+
+	memcpy (ret + entry_size, data, len);
+
+	return ret;
+}
+
 P_LIB_API pchar *
 p_strdup (const pchar *str)
 {
@@ -206,3 +345,222 @@ p_strtod (const pchar *str)
 	/* Return signed and scaled floating point result */
 	return sign * (frac ? (value / scale) : (value * scale));
 }
+
+P_LIB_API PStringView
+p_string_view_from_str (const pchar *str)
+{
+	return p_string_view_from_data (str, str != NULL ? strlen (str) : 0);
+}
+
+P_LIB_API PStringView
+p_string_view_from_data (const pchar	*data,
+			 psize		len)
+{
+	PStringView view;
+
+	view.data = data != NULL ? data : "";
+	view.len  = data != NULL ? len : 0;
+
+	return view;
+}
+
+P_LIB_API PStringView
+p_string_view_trim (PStringView view)
+{
+	while (view.len > 0 && isspace (* ((const puchar *) view.data))) {
+		++view.data;
+		--view.len;
+	}
+
+	while (view.len > 0 && isspace (* ((const puchar *) view.data + view.len - 1)))
+		--view.len;
+
+	return view;
+}
+
+P_LIB_API pboolean
+p_string_view_split (PStringView	*view,
+		     pchar		delim,
+		     PStringView	*token)
+{
+	pssize pos;
+
+	/* Exhausted view has no data pointer at all */
+	if (P_UNLIKELY (view == NULL || token == NULL || view->data == NULL))
+		return FALSE;
+
+	if ((pos = p_string_view_find_char (*view, delim)) < 0) {
+		*token     = *view;
+		view->data = NULL;
+		view->len  = 0;
+	} else {
+		token->data = view->data;
+		token->len  = (psize) pos;
+		view->data += pos + 1;
+		view->len  -= (psize) pos + 1;
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pssize
+p_string_view_find_char (PStringView	view,
+			 pchar		c)
+{
+	const pchar *ptr;
+
+	if (P_UNLIKELY (view.data == NULL || view.len == 0))
+		return -1;
+
+	if ((ptr = memchr (view.data, c, view.len)) == NULL)
+		return -1;
+
+	return (pssize) (ptr - view.data);
+}
+
+P_LIB_API pssize
+p_string_view_find (PStringView	view,
+		    PStringView	needle)
+{
+	const pchar	*ptr;
+	const pchar	*end;
+
+	if (P_UNLIKELY (view.data == NULL || needle.data == NULL))
+		return -1;
+
+	if (needle.len == 0)
+		return 0;
+
+	if (needle.len > view.len)
+		return -1;
+
+	ptr = view.data;
+	end = view.data + (view.len - needle.len);
+
+	/* Jump between the occurrences of the first character only */
+	while (ptr <= end) {
+		if ((ptr = memchr (ptr, needle.data[0], (psize) (end - ptr) + 1)) == NULL)
+			return -1;
+
+		if (memcmp (ptr, needle.data, needle.len) == 0)
+			return (pssize) (ptr - view.data);
+
+		++ptr;
+	}
+
+	return -1;
+}
+
+P_LIB_API pboolean
+p_string_view_equal (PStringView	view,
+		     PStringView	other)
+{
+	if (view.len != other.len)
+		return FALSE;
+
+	if (view.len == 0)
+		return TRUE;
+
+	if (P_UNLIKELY (view.data == NULL || other.data == NULL))
+		return FALSE;
+
+	return memcmp (view.data, other.data, view.len) == 0;
+}
+
+P_LIB_API PStringInterner *
+p_string_interner_new (void)
+{
+	PStringInterner *ret;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PStringInterner))) == NULL)) {
+		P_ERROR ("PString::p_string_interner_new: failed to allocate memory");
+		return NULL;
+	}
+
+	ret->num_buckets = P_STRING_INTERNER_INITIAL_BUCKETS;
+
+	if (P_UNLIKELY ((ret->buckets = p_malloc0 (ret->num_buckets * sizeof (PStringInternEntry *))) == NULL)) {
+		P_ERROR ("PString::p_string_interner_new: failed to allocate memory");
+		p_free (ret);
+		return NULL;
+	}
+
+	if (P_UNLIKELY ((ret->mutex = p_mutex_new ()) == NULL)) {
+		P_ERROR ("PString::p_string_interner_new: failed to create mutex");
+		p_free (ret->buckets);
+		p_free (ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+P_LIB_API const pchar *
+p_string_interner_intern (PStringInterner	*interner,
+			  const pchar		*str)
+{
+	if (P_UNLIKELY (interner == NULL || str == NULL))
+		return NULL;
+
+	return pp_string_interner_intern (interner, str, strlen (str), TRUE);
+}
+
+P_LIB_API const pchar *
+p_string_interner_intern_view (PStringInterner	*interner,
+			       PStringView	view)
+{
+	if (P_UNLIKELY (interner == NULL || view.data == NULL))
+		return NULL;
+
+	if (P_UNLIKELY (memchr (view.data, '\0', view.len) != NULL))
+		return NULL;
+
+	return pp_string_interner_intern (interner, view.data, view.len, TRUE);
+}
+
+P_LIB_API const pchar *
+p_string_interner_lookup (PStringInterner	*interner,
+			  const pchar		*str)
+{
+	if (P_UNLIKELY (interner == NULL || str == NULL))
+		return NULL;
+
+	return pp_string_interner_intern (interner, str, strlen (str), FALSE);
+}
+
+P_LIB_API psize
+p_string_interner_get_count (PStringInterner *interner)
+{
+	psize ret;
+
+	if (P_UNLIKELY (interner == NULL))
+		return 0;
+
+	p_mutex_lock (interner->mutex);
+	ret = interner->count;
+	p_mutex_unlock (interner->mutex);
+
+	return ret;
+}
+
+P_LIB_API void
+p_string_interner_free (PStringInterner *interner)
+{
+	PStringInternEntry	*entry;
+	PStringInternEntry	*next;
+	psize			i;
+
+	if (P_UNLIKELY (interner == NULL))
+		return;
+
+	for (i = 0; i < interner->num_buckets; ++i) {
+		for (entry = interner->buckets[i]; entry != NULL; entry = next) {
+			next = entry->next;
+			p_free (entry);
+		}
+	}
+
+	p_mutex_free (interner->mutex);
+	p_free (interner->buckets);
+	p_free (interner);
+}
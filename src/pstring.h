@@ -32,6 +32,26 @@
  * ASCII table) with the trailing zero character (\0).
  *
  * Some useful string manipulation routines are represented here.
+ *
+ * #PStringView is a non-owning reference to a part of a string: a pointer and
+ * a length, without the trailing zero. Views are passed by value and none of
+ * the p_string_view_* routines allocate memory, i.e. trimming a view or
+ * splitting it by a delimiter just produces other views into the same string:
+ * @code
+ * PStringView line = p_string_view_from_str (" key = value ");
+ * PStringView token;
+ *
+ * while (p_string_view_split (&line, '=', &token))
+ *     process (p_string_view_trim (token));
+ * @endcode
+ * Take into account that the viewed string must stay alive while a view is
+ * used.
+ *
+ * #PStringInterner keeps a single canonical copy of every string put into it.
+ * Interning equal strings gives the same pointer, so the interned strings can
+ * be compared by the pointer and used as #PHashTable keys directly. The
+ * interned strings are valid until the interner is freed. The interner is
+ * thread-safe.
  */
 
 #if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
@@ -112,6 +132,156 @@ P_LIB_API pchar *	p_strtok	(pchar		*str,
  */
 P_LIB_API double	p_strtod	(const pchar	*str);
 
+/** Non-owning view of a string part. */
+typedef struct PStringView_ {
+	const pchar	*data;	/**< Pointer to the first character.	*/
+	psize		len;	/**< Length in characters.		*/
+} PStringView;
+
+/** String interner opaque structure. */
+typedef struct PStringInterner_ PStringInterner;
+
+/**
+ * @brief Makes a view of a zero-terminated string.
+ * @param str String to view, NULL gives an empty view.
+ * @return View of the whole @a str.
+ * @since 0.0.6
+ */
+P_LIB_API PStringView	p_string_view_from_str		(const pchar	*str);
+
+/**
+ * @brief Makes a view of a memory range.
+ * @param data Pointer to the first character.
+ * @param len Number of the characters to view.
+ * @return View of the given range, an empty view if @a data is NULL.
+ * @since 0.0.6
+ *
+ * The range may contain zero characters, they are treated as any others.
+ */
+P_LIB_API PStringView	p_string_view_from_data		(const pchar	*data,
+							 psize		len);
+
+/**
+ * @brief Removes leading and trailing whitespaces from a view.
+ * @param view View to trim.
+ * @return Trimmed view of the same string.
+ * @since 0.0.6
+ *
+ * Whitespaces are the same as in p_strchomp(), but the string is not copied.
+ */
+P_LIB_API PStringView	p_string_view_trim		(PStringView	view);
+
+/**
+ * @brief Takes the next token from a view split by a delimiter.
+ * @param[in,out] view View to split, it is advanced past the taken token.
+ * @param delim Delimiter character.
+ * @param[out] token Next token, without the delimiter.
+ * @return TRUE if the token was taken, FALSE if there are no more tokens.
+ * @since 0.0.6
+ *
+ * Unlike p_strtok() empty tokens are not skipped: "a,,b" gives "a", "" and
+ * "b", while an empty string gives a single empty token. The viewed string is
+ * not modified.
+ */
+P_LIB_API pboolean	p_string_view_split		(PStringView	*view,
+							 pchar		delim,
+							 PStringView	*token);
+
+/**
+ * @brief Finds the first occurrence of a character in a view.
+ * @param view View to search in.
+ * @param c Character to find.
+ * @return Offset of the character in case of success, -1 otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API pssize	p_string_view_find_char		(PStringView	view,
+							 pchar		c);
+
+/**
+ * @brief Finds the first occurrence of a substring in a view.
+ * @param view View to search in.
+ * @param needle Substring to find.
+ * @return Offset of the substring in case of success, -1 otherwise.
+ * @since 0.0.6
+ *
+ * An empty @a needle is found at the offset 0.
+ */
+P_LIB_API pssize	p_string_view_find		(PStringView	view,
+							 PStringView	needle);
+
+/**
+ * @brief Compares two views for equality.
+ * @param view First view to compare.
+ * @param other Second view to compare.
+ * @return TRUE if both views have the same characters, FALSE otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API pboolean	p_string_view_equal		(PStringView	view,
+							 PStringView	other);
+
+/**
+ * @brief Creates a new string interner.
+ * @return Pointer to #PStringInterner in case of success, NULL otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API PStringInterner *	p_string_interner_new		(void);
+
+/**
+ * @brief Gets a canonical copy of a string, adding it if needed.
+ * @param interner String interner.
+ * @param str Zero-terminated string to intern.
+ * @return Canonical copy of @a str in case of success, NULL otherwise.
+ * @since 0.0.6
+ * @note The returned string is owned by @a interner, do not modify or free it.
+ *
+ * Equal strings always give the same pointer during the lifetime of
+ * @a interner.
+ */
+P_LIB_API const pchar *		p_string_interner_intern	(PStringInterner	*interner,
+								 const pchar		*str);
+
+/**
+ * @brief Gets a canonical copy of a viewed string, adding it if needed.
+ * @param interner String interner.
+ * @param view View of the string to intern, it must not contain zero
+ * characters.
+ * @return Zero-terminated canonical copy of the viewed string in case of
+ * success, NULL otherwise.
+ * @since 0.0.6
+ * @note The returned string is owned by @a interner, do not modify or free it.
+ *
+ * Works the same way as p_string_interner_intern(), but doesn't require the
+ * string to be zero-terminated, so the parts of a bigger string can be
+ * interned without making temporary copies.
+ */
+P_LIB_API const pchar *		p_string_interner_intern_view	(PStringInterner	*interner,
+								 PStringView		view);
+
+/**
+ * @brief Looks up a canonical copy of a string without adding it.
+ * @param interner String interner.
+ * @param str Zero-terminated string to look up.
+ * @return Canonical copy of @a str if it was interned before, NULL otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API const pchar *		p_string_interner_lookup	(PStringInterner	*interner,
+								 const pchar		*str);
+
+/**
+ * @brief Gets the number of the interned strings.
+ * @param interner String interner.
+ * @return Number of the interned strings.
+ * @since 0.0.6
+ */
+P_LIB_API psize			p_string_interner_get_count	(PStringInterner	*interner);
+
+/**
+ * @brief Frees a string interner with all the interned strings.
+ * @param interner String interner to free.
+ * @since 0.0.6
+ */
+P_LIB_API void			p_string_interner_free		(PStringInterner	*interner);
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PSTRING_H */
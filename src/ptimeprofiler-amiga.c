@@ -74,8 +74,8 @@ p_time_profiler_get_ticks_internal ()
 	return (((puint64) eclock.ev_hi) * pp_time_profiler_freq + (puint64) eclock.ev_lo);
 }
 
-puint64
-p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
+static puint64
+pp_time_profiler_elapsed_ticks (const PTimeProfiler *profiler)
 {
 	puint64 value;
 
@@ -86,7 +86,27 @@ p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
 	if (P_UNLIKELY (value < profiler->counter))
 		value += (((puint64) 1) << 32) * pp_time_profiler_freq;
 
-	return (value - profiler->counter) * 1000000ULL / pp_time_profiler_freq;
+	return value - profiler->counter;
+}
+
+puint64
+p_time_profiler_ticks_to_nsecs_internal (puint64 ticks)
+{
+	/* Split the value to prevent overflow */
+	return (ticks / pp_time_profiler_freq) * 1000000000ULL +
+	       (ticks % pp_time_profiler_freq) * 1000000000ULL / pp_time_profiler_freq;
+}
+
+puint64
+p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
+{
+	return pp_time_profiler_elapsed_ticks (profiler) * 1000000ULL / pp_time_profiler_freq;
+}
+
+puint64
+p_time_profiler_elapsed_nsecs_internal (const PTimeProfiler *profiler)
+{
+	return p_time_profiler_ticks_to_nsecs_internal (pp_time_profiler_elapsed_ticks (profiler));
 }
 
 void
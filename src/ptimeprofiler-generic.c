@@ -41,12 +41,24 @@ p_time_profiler_get_ticks_internal ()
 	return (puint64) (val * 1000000);
 }
 
+puint64
+p_time_profiler_ticks_to_nsecs_internal (puint64 ticks)
+{
+	return ticks * 1000;
+}
+
 puint64
 p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
 {
 	return p_time_profiler_get_ticks_internal () - profiler->counter;
 }
 
+puint64
+p_time_profiler_elapsed_nsecs_internal (const PTimeProfiler *profiler)
+{
+	return p_time_profiler_ticks_to_nsecs_internal (p_time_profiler_elapsed_usecs_internal (profiler));
+}
+
 void
 p_time_profiler_init (void)
 {
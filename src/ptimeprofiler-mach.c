@@ -34,21 +34,31 @@ static puint64 pp_time_profiler_freq_denom = 0;
 puint64
 p_time_profiler_get_ticks_internal ()
 {
-	puint64 val = mach_absolute_time ();
+	return (puint64) mach_absolute_time ();
+}
 
-	/* To prevent overflow */
-	val /= 1000;
+puint64
+p_time_profiler_ticks_to_nsecs_internal (puint64 ticks)
+{
+	if (P_UNLIKELY (pp_time_profiler_freq_denom == 0))
+		return 0;
 
-	val *= pp_time_profiler_freq_num;
-	val /= pp_time_profiler_freq_denom;
+	/* Split the value to prevent overflow */
+	return (ticks / pp_time_profiler_freq_denom) * pp_time_profiler_freq_num +
+	       (ticks % pp_time_profiler_freq_denom) * pp_time_profiler_freq_num / pp_time_profiler_freq_denom;
+}
 
-	return val;
+puint64
+p_time_profiler_elapsed_nsecs_internal (const PTimeProfiler *profiler)
+{
+	return p_time_profiler_ticks_to_nsecs_internal (p_time_profiler_get_ticks_internal () -
+							profiler->counter);
 }
 
 puint64
 p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
 {
-	return p_time_profiler_get_ticks_internal () - profiler->counter;
+	return p_time_profiler_elapsed_nsecs_internal (profiler) / 1000;
 }
 
 void
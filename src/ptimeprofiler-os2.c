@@ -55,25 +55,15 @@ p_time_profiler_get_ticks_internal ()
 	return tick_time.ticks;
 }
 
-puint64
-p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
+static puint64
+pp_time_profiler_ticks_to_units (puint64 ticks, puint64 units_per_sec)
 {
-	puint64	ticks;
 #if PLIBSYS_HAS_LLDIV
 	lldiv_t	ldres;
 #endif
 	puint64	quot;
 	puint64	rem;
 
-	ticks = p_time_profiler_get_ticks_internal ();
-
-	if (ticks < profiler->counter) {
-		P_WARNING ("PTimeProfiler::p_time_profiler_elapsed_usecs_internal: negative jitter");
-		return 1;
-	}
-
-	ticks -= profiler->counter;
-
 #if PLIBSYS_HAS_LLDIV
 	ldres = lldiv ((long long) ticks, (long long) pp_time_profiler_freq);
 
@@ -84,7 +74,43 @@ p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
 	rem  = ticks % pp_time_profiler_freq;
 #endif
 
-	return (puint64) (quot * 1000000LL + (rem * 1000000LL) / pp_time_profiler_freq);
+	return (puint64) (quot * units_per_sec + (rem * units_per_sec) / pp_time_profiler_freq);
+}
+
+puint64
+p_time_profiler_ticks_to_nsecs_internal (puint64 ticks)
+{
+	return pp_time_profiler_ticks_to_units (ticks, 1000000000ULL);
+}
+
+puint64
+p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
+{
+	puint64	ticks;
+
+	ticks = p_time_profiler_get_ticks_internal ();
+
+	if (ticks < profiler->counter) {
+		P_WARNING ("PTimeProfiler::p_time_profiler_elapsed_usecs_internal: negative jitter");
+		return 1;
+	}
+
+	return pp_time_profiler_ticks_to_units (ticks - profiler->counter, 1000000ULL);
+}
+
+puint64
+p_time_profiler_elapsed_nsecs_internal (const PTimeProfiler *profiler)
+{
+	puint64	ticks;
+
+	ticks = p_time_profiler_get_ticks_internal ();
+
+	if (ticks < profiler->counter) {
+		P_WARNING ("PTimeProfiler::p_time_profiler_elapsed_nsecs_internal: negative jitter");
+		return 1;
+	}
+
+	return pp_time_profiler_ticks_to_units (ticks - profiler->counter, 1000000000ULL);
 }
 
 void
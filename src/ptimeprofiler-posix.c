@@ -23,6 +23,7 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include "patomic.h"
 #include "ptimeprofiler.h"
 #include "ptimeprofiler-private.h"
 
@@ -34,16 +35,46 @@
 #  define _POSIX_MONOTONIC_CLOCK (-1)
 #endif
 
+/* Time-stamp counter can be used only if a monotonic clock is available for
+ * calibration */
+#if defined (P_CPU_X86_64) && defined (P_CC_GNU) && (_POSIX_MONOTONIC_CLOCK >= 0)
+#  define P_TIME_PROFILER_HAS_TSC
+#endif
+
+/* Duration of the time-stamp counter calibration, in nanoseconds */
+#define P_TIME_PROFILER_TSC_CALIBRATION_NSECS	2000000ULL
+
+/* Fixed-point shift used to convert time-stamp counter ticks to nanoseconds */
+#define P_TIME_PROFILER_TSC_SHIFT		24
+
+/* Time-stamp counter calibration states */
+#define P_TIME_PROFILER_TSC_STATE_NONE		0
+#define P_TIME_PROFILER_TSC_STATE_CALIBRATING	1
+#define P_TIME_PROFILER_TSC_STATE_READY		2
+
 typedef puint64 (* PPOSIXTicksFunc) (void);
 
 static PPOSIXTicksFunc pp_time_profiler_ticks_func = NULL;
 
+#ifdef P_TIME_PROFILER_HAS_TSC
+static pboolean		pp_time_profiler_use_tsc   = FALSE;
+static puint64		pp_time_profiler_tsc_mult  = 0;
+static volatile pint	pp_time_profiler_tsc_state = P_TIME_PROFILER_TSC_STATE_NONE;
+#endif
+
 #if (_POSIX_MONOTONIC_CLOCK >= 0) || defined (P_OS_IRIX)
 static puint64 pp_time_profiler_get_ticks_clock ();
 #endif
 
 static puint64 pp_time_profiler_get_ticks_gtod ();
 
+#ifdef P_TIME_PROFILER_HAS_TSC
+static puint64 pp_time_profiler_get_ticks_tsc (void);
+static pboolean pp_time_profiler_has_invariant_tsc (void);
+static void pp_time_profiler_calibrate_tsc (void);
+static puint64 pp_time_profiler_get_tsc_mult (void);
+#endif
+
 #if (_POSIX_MONOTONIC_CLOCK >= 0) || defined (P_OS_IRIX)
 static puint64
 pp_time_profiler_get_ticks_clock ()
@@ -58,7 +89,7 @@ pp_time_profiler_get_ticks_clock ()
 		P_ERROR ("PTimeProfiler::pp_time_profiler_get_ticks_clock: clock_gettime() failed");
 		return pp_time_profiler_get_ticks_gtod ();
 	} else
-		return (puint64) (ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+		return (puint64) ts.tv_sec * 1000000000ULL + (puint64) ts.tv_nsec;
 }
 #endif
 
@@ -72,19 +103,133 @@ pp_time_profiler_get_ticks_gtod ()
 		return 0;
 	}
 
-	return (puint64) (tv.tv_sec * 1000000 + tv.tv_usec);
+	return ((puint64) tv.tv_sec * 1000000ULL + (puint64) tv.tv_usec) * 1000ULL;
+}
+
+#ifdef P_TIME_PROFILER_HAS_TSC
+static puint64
+pp_time_profiler_get_ticks_tsc (void)
+{
+	puint32 lo;
+	puint32 hi;
+
+	__asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+
+	return ((puint64) hi << 32) | (puint64) lo;
 }
 
+static pboolean
+pp_time_profiler_has_invariant_tsc (void)
+{
+	puint32 eax;
+	puint32 ebx;
+	puint32 ecx;
+	puint32 edx;
+
+	__asm__ __volatile__ ("cpuid"
+			      : "=a" (eax), "=b" (ebx), "=c" (ecx), "=d" (edx)
+			      : "a" (0x80000000U), "c" (0));
+
+	if (eax < 0x80000007U)
+		return FALSE;
+
+	__asm__ __volatile__ ("cpuid"
+			      : "=a" (eax), "=b" (ebx), "=c" (ecx), "=d" (edx)
+			      : "a" (0x80000007U), "c" (0));
+
+	/* EDX bit 8 indicates invariant TSC */
+	return (edx & (1U << 8)) != 0 ? TRUE : FALSE;
+}
+
+static void
+pp_time_profiler_calibrate_tsc (void)
+{
+	puint64	clock_start;
+	puint64	clock_end;
+	puint64	tsc_start;
+	puint64	tsc_end;
+
+	clock_start = pp_time_profiler_get_ticks_clock ();
+	tsc_start   = pp_time_profiler_get_ticks_tsc ();
+
+	do {
+		clock_end = pp_time_profiler_get_ticks_clock ();
+		tsc_end   = pp_time_profiler_get_ticks_tsc ();
+	} while (clock_end - clock_start < P_TIME_PROFILER_TSC_CALIBRATION_NSECS);
+
+	/* Nanoseconds per tick in fixed-point representation */
+	if (P_LIKELY (tsc_end > tsc_start))
+		pp_time_profiler_tsc_mult = ((clock_end - clock_start) << P_TIME_PROFILER_TSC_SHIFT) /
+					    (tsc_end - tsc_start);
+
+	if (P_UNLIKELY (pp_time_profiler_tsc_mult == 0)) {
+		P_WARNING ("PTimeProfiler::pp_time_profiler_calibrate_tsc: failed to calibrate TSC");
+		pp_time_profiler_tsc_mult = 1ULL << P_TIME_PROFILER_TSC_SHIFT;
+	}
+}
+
+/* Calibration takes a while, so it is done on the first conversion rather
+ * than during the library initialization */
+static puint64
+pp_time_profiler_get_tsc_mult (void)
+{
+	if (P_LIKELY (p_atomic_int_get (&pp_time_profiler_tsc_state) == P_TIME_PROFILER_TSC_STATE_READY))
+		return pp_time_profiler_tsc_mult;
+
+	if (p_atomic_int_compare_and_exchange (&pp_time_profiler_tsc_state,
+					       P_TIME_PROFILER_TSC_STATE_NONE,
+					       P_TIME_PROFILER_TSC_STATE_CALIBRATING) == TRUE) {
+		pp_time_profiler_calibrate_tsc ();
+		p_atomic_int_set (&pp_time_profiler_tsc_state, P_TIME_PROFILER_TSC_STATE_READY);
+	} else {
+		while (p_atomic_int_get (&pp_time_profiler_tsc_state) != P_TIME_PROFILER_TSC_STATE_READY)
+			;
+	}
+
+	return pp_time_profiler_tsc_mult;
+}
+#endif
+
 puint64
 p_time_profiler_get_ticks_internal ()
 {
+#ifdef P_TIME_PROFILER_HAS_TSC
+	if (P_LIKELY (pp_time_profiler_use_tsc == TRUE))
+		return pp_time_profiler_get_ticks_tsc ();
+#endif
+
 	return pp_time_profiler_ticks_func ();
 }
 
+puint64
+p_time_profiler_ticks_to_nsecs_internal (puint64 ticks)
+{
+#ifdef P_TIME_PROFILER_HAS_TSC
+	puint64 mult;
+
+	if (P_LIKELY (pp_time_profiler_use_tsc == TRUE)) {
+		mult = pp_time_profiler_get_tsc_mult ();
+
+		/* Split the value to prevent overflow */
+		return (((ticks >> 32) * mult) << (32 - P_TIME_PROFILER_TSC_SHIFT)) +
+		       (((ticks & 0xFFFFFFFFULL) * mult) >> P_TIME_PROFILER_TSC_SHIFT);
+	}
+#endif
+
+	return ticks;
+}
+
+puint64
+p_time_profiler_elapsed_nsecs_internal (const PTimeProfiler *profiler)
+{
+	return p_time_profiler_ticks_to_nsecs_internal (p_time_profiler_get_ticks_internal () -
+							profiler->counter);
+}
+
 puint64
 p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
 {
-	return pp_time_profiler_ticks_func () - profiler->counter;
+	return p_time_profiler_elapsed_nsecs_internal (profiler) / 1000;
 }
 
 void
@@ -100,10 +245,23 @@ p_time_profiler_init (void)
 #else
 	pp_time_profiler_ticks_func = (PPOSIXTicksFunc) pp_time_profiler_get_ticks_gtod;
 #endif
+
+#ifdef P_TIME_PROFILER_HAS_TSC
+	/* The frequency is calibrated later, see pp_time_profiler_get_tsc_mult() */
+	if (pp_time_profiler_ticks_func == (PPOSIXTicksFunc) pp_time_profiler_get_ticks_clock &&
+	    pp_time_profiler_has_invariant_tsc () == TRUE)
+		pp_time_profiler_use_tsc = TRUE;
+#endif
 }
 
 void
 p_time_profiler_shutdown (void)
 {
 	pp_time_profiler_ticks_func = NULL;
+
+#ifdef P_TIME_PROFILER_HAS_TSC
+	pp_time_profiler_use_tsc   = FALSE;
+	pp_time_profiler_tsc_mult  = 0;
+	pp_time_profiler_tsc_state = P_TIME_PROFILER_TSC_STATE_NONE;
+#endif
 }
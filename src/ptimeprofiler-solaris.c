@@ -36,12 +36,24 @@ p_time_profiler_get_ticks_internal ()
 	return (puint64) gethrtime ();
 }
 
+puint64
+p_time_profiler_ticks_to_nsecs_internal (puint64 ticks)
+{
+	return ticks;
+}
+
 puint64
 p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
 {
 	return (((puint64) gethrtime ()) - profiler->counter) / 1000;
 }
 
+puint64
+p_time_profiler_elapsed_nsecs_internal (const PTimeProfiler *profiler)
+{
+	return ((puint64) gethrtime ()) - profiler->counter;
+}
+
 void
 p_time_profiler_init (void)
 {
@@ -42,7 +42,7 @@ static PWin32ElapsedFunc pp_time_profiler_elapsed_func = NULL;
 static puint64           pp_time_profiler_freq         = 1;
 
 static puint64 WINAPI pp_time_profiler_get_hr_ticks (void);
-static puint64 pp_time_profiler_elapsed_hr (puint64 last_counter);
+static puint64 pp_time_profiler_ticks_to_units (puint64 ticks, puint64 units_per_sec);
 static puint64 pp_time_profiler_elapsed_tick64 (puint64 last_counter);
 static puint64 pp_time_profiler_elapsed_tick (puint64 last_counter);
 
@@ -60,17 +60,14 @@ pp_time_profiler_get_hr_ticks (void)
 }
 
 static puint64
-pp_time_profiler_elapsed_hr (puint64 last_counter)
+pp_time_profiler_ticks_to_units (puint64 ticks, puint64 units_per_sec)
 {
-	puint64	ticks;
 #ifdef PLIBSYS_HAS_LLDIV
 	lldiv_t	ldres;
 #endif
 	puint64	quot;
 	puint64	rem;
 
-	ticks = pp_time_profiler_ticks_func () - last_counter;
-
 #ifdef PLIBSYS_HAS_LLDIV
 	ldres = lldiv ((long long) ticks, (long long) pp_time_profiler_freq);
 
@@ -81,13 +78,13 @@ pp_time_profiler_elapsed_hr (puint64 last_counter)
 	rem  = ticks % pp_time_profiler_freq;
 #endif
 
-	return (puint64) (quot * 1000000 + (rem * 1000000) / pp_time_profiler_freq);
+	return (puint64) (quot * units_per_sec + (rem * units_per_sec) / pp_time_profiler_freq);
 }
 
 static puint64
 pp_time_profiler_elapsed_tick64 (puint64 last_counter)
 {
-	return (pp_time_profiler_ticks_func () - last_counter) * 1000;
+	return pp_time_profiler_ticks_func () - last_counter;
 }
 
 static puint64
@@ -102,7 +99,7 @@ pp_time_profiler_elapsed_tick (puint64 last_counter)
 	if (P_UNLIKELY (val < last_counter))
 		high_bit = 1;
 
-	return ((val | (high_bit << 32)) - last_counter) * 1000;
+	return (val | (high_bit << 32)) - last_counter;
 }
 
 puint64
@@ -111,10 +108,22 @@ p_time_profiler_get_ticks_internal ()
 	return pp_time_profiler_ticks_func ();
 }
 
+puint64
+p_time_profiler_ticks_to_nsecs_internal (puint64 ticks)
+{
+	return pp_time_profiler_ticks_to_units (ticks, 1000000000ULL);
+}
+
 puint64
 p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler)
 {
-	return pp_time_profiler_elapsed_func (profiler->counter);
+	return pp_time_profiler_ticks_to_units (pp_time_profiler_elapsed_func (profiler->counter), 1000000ULL);
+}
+
+puint64
+p_time_profiler_elapsed_nsecs_internal (const PTimeProfiler *profiler)
+{
+	return pp_time_profiler_ticks_to_units (pp_time_profiler_elapsed_func (profiler->counter), 1000000000ULL);
 }
 
 void
@@ -133,7 +142,7 @@ p_time_profiler_init (void)
 		} else {
 			pp_time_profiler_freq         = (puint64) (tcounter.QuadPart);
 			pp_time_profiler_ticks_func   = (PWin32TicksFunc) pp_time_profiler_get_hr_ticks;
-			pp_time_profiler_elapsed_func = (PWin32ElapsedFunc) pp_time_profiler_elapsed_hr;
+			pp_time_profiler_elapsed_func = (PWin32ElapsedFunc) pp_time_profiler_elapsed_tick64;
 		}
 	}
 
@@ -145,6 +154,8 @@ p_time_profiler_init (void)
 			return;
 		}
 
+		/* Tick counters are in milliseconds */
+		pp_time_profiler_freq         = 1000;
 		pp_time_profiler_ticks_func   = (PWin32TicksFunc) GetProcAddress (hmodule, "GetTickCount64");
 		pp_time_profiler_elapsed_func = (PWin32ElapsedFunc) pp_time_profiler_elapsed_tick64;
 
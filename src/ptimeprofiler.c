@@ -29,6 +29,8 @@
 
 extern puint64 p_time_profiler_get_ticks_internal (void);
 extern puint64 p_time_profiler_elapsed_usecs_internal (const PTimeProfiler *profiler);
+extern puint64 p_time_profiler_elapsed_nsecs_internal (const PTimeProfiler *profiler);
+extern puint64 p_time_profiler_ticks_to_nsecs_internal (puint64 ticks);
 
 P_LIB_API PTimeProfiler *
 p_time_profiler_new ()
@@ -63,6 +65,27 @@ p_time_profiler_elapsed_usecs (const PTimeProfiler *profiler)
 	return p_time_profiler_elapsed_usecs_internal (profiler);
 }
 
+P_LIB_API puint64
+p_time_profiler_elapsed_nsecs (const PTimeProfiler *profiler)
+{
+	if (P_UNLIKELY (profiler == NULL))
+		return 0;
+
+	return p_time_profiler_elapsed_nsecs_internal (profiler);
+}
+
+P_LIB_API puint64
+p_time_profiler_ticks (void)
+{
+	return p_time_profiler_get_ticks_internal ();
+}
+
+P_LIB_API puint64
+p_time_profiler_ticks_to_nsecs (puint64 ticks)
+{
+	return p_time_profiler_ticks_to_nsecs_internal (ticks);
+}
+
 P_LIB_API void
 p_time_profiler_free (PTimeProfiler *profiler)
 {
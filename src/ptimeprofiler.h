@@ -37,8 +37,22 @@
  *
  * To start using a profiler create a new one with p_time_profiler_new() call
  * and p_time_profiler_elapsed_usecs() to get elapsed time since the creation.
+ * If you need a finer resolution use p_time_profiler_elapsed_nsecs() instead.
  * If you need to reset a profiler use p_time_profiler_reset(). Remove a
  * profiler with p_time_profiler_free().
+ *
+ * For very short code paths which are executed millions of times per second
+ * even a profiler object could be too heavy. In that case read raw values of
+ * the tick counter with p_time_profiler_ticks() before and after the measured
+ * code, and convert the difference to nanoseconds with
+ * p_time_profiler_ticks_to_nsecs() later, out of the hot path.
+ *
+ * On x86-64 POSIX systems with an invariant time-stamp counter (TSC) the
+ * profiler reads the counter directly from the CPU, which is much cheaper than
+ * a system call. The TSC frequency is calibrated against the monotonic system
+ * clock once, on the first conversion of ticks to time, which takes about 2 ms.
+ * On other systems the most precise available system clock is used, so the
+ * actual resolution may be much lower than one nanosecond.
  */
 
 #if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
@@ -81,6 +95,43 @@ P_LIB_API void			p_time_profiler_reset		(PTimeProfiler *	profiler);
  */
 P_LIB_API puint64		p_time_profiler_elapsed_usecs	(const PTimeProfiler *	profiler);
 
+/**
+ * @brief Calculates elapsed time since the last reset or creation with
+ * nanosecond resolution.
+ * @param profiler Time profiler to calculate elapsed time for.
+ * @return Nanoseconds elapsed since the last reset or creation.
+ * @since 0.0.6
+ *
+ * Actual precision depends on the underlying system clock, see
+ * p_time_profiler_ticks() for details.
+ */
+P_LIB_API puint64		p_time_profiler_elapsed_nsecs	(const PTimeProfiler *	profiler);
+
+/**
+ * @brief Gets a current value of the profiler tick counter.
+ * @return Current value of the tick counter.
+ * @since 0.0.6
+ *
+ * Units of the returned value are platform dependent: it could be CPU cycles,
+ * nanoseconds, microseconds or any other ticks of the underlying system clock.
+ * Use p_time_profiler_ticks_to_nsecs() to convert a difference between two
+ * values into nanoseconds.
+ *
+ * This call is intended for the hot code paths: it doesn't perform any
+ * allocations and on systems with an invariant time-stamp counter it doesn't
+ * involve any system calls.
+ */
+P_LIB_API puint64		p_time_profiler_ticks		(void);
+
+/**
+ * @brief Converts a number of profiler ticks into nanoseconds.
+ * @param ticks Number of ticks to convert, usually a difference between two
+ * values returned by p_time_profiler_ticks().
+ * @return Nanoseconds corresponding to the given number of @a ticks.
+ * @since 0.0.6
+ */
+P_LIB_API puint64		p_time_profiler_ticks_to_nsecs	(puint64		ticks);
+
 /**
  * @brief Frees #PTimeProfiler object.
  * @param profiler #PTimeProfiler to free.
@@ -339,6 +339,26 @@ p_uthread_free_internal (PUThread *thread)
 	p_free (thread);
 }
 
+pboolean
+p_uthread_set_affinity_internal (PUThread		*thread,
+				 const PUThreadCpuSet	*cpus)
+{
+	P_UNUSED (thread);
+	P_UNUSED (cpus);
+
+	return FALSE;
+}
+
+pboolean
+p_uthread_get_affinity_internal (PUThread	*thread,
+				 PUThreadCpuSet	*cpus)
+{
+	P_UNUSED (thread);
+	P_UNUSED (cpus);
+
+	return FALSE;
+}
+
 P_LIB_API void
 p_uthread_yield (void)
 {
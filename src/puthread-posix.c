@@ -48,6 +48,8 @@
 #  ifndef P_OS_VMS
 #    include <sched.h>
 #  endif
+#elif defined (PLIBSYS_HAS_PTHREAD_AFFINITY)
+#  include <sched.h>
 #endif
 
 #ifdef PLIBSYS_HAS_PTHREAD_PRCTL
@@ -442,6 +444,68 @@ p_uthread_free_internal (PUThread *thread)
 	p_free (thread);
 }
 
+pboolean
+p_uthread_set_affinity_internal (PUThread		*thread,
+				 const PUThreadCpuSet	*cpus)
+{
+#ifdef PLIBSYS_HAS_PTHREAD_AFFINITY
+	cpu_set_t	native_cpus;
+	pint		i;
+
+	CPU_ZERO (&native_cpus);
+
+	for (i = 0; i < P_UTHREAD_CPU_SET_SIZE && i < CPU_SETSIZE; ++i) {
+		if (p_uthread_cpu_set_contains (cpus, i) == TRUE)
+			CPU_SET (i, &native_cpus);
+	}
+
+	if (P_UNLIKELY (pthread_setaffinity_np (thread == NULL ? pthread_self () : thread->hdl,
+						sizeof (native_cpus),
+						&native_cpus) != 0)) {
+		P_WARNING ("PUThread::p_uthread_set_affinity_internal: pthread_setaffinity_np() failed");
+		return FALSE;
+	}
+
+	return TRUE;
+#else
+	P_UNUSED (thread);
+	P_UNUSED (cpus);
+
+	return FALSE;
+#endif
+}
+
+pboolean
+p_uthread_get_affinity_internal (PUThread	*thread,
+				 PUThreadCpuSet	*cpus)
+{
+#ifdef PLIBSYS_HAS_PTHREAD_AFFINITY
+	cpu_set_t	native_cpus;
+	pint		i;
+
+	CPU_ZERO (&native_cpus);
+
+	if (P_UNLIKELY (pthread_getaffinity_np (thread == NULL ? pthread_self () : thread->hdl,
+						sizeof (native_cpus),
+						&native_cpus) != 0)) {
+		P_WARNING ("PUThread::p_uthread_get_affinity_internal: pthread_getaffinity_np() failed");
+		return FALSE;
+	}
+
+	for (i = 0; i < P_UTHREAD_CPU_SET_SIZE && i < CPU_SETSIZE; ++i) {
+		if (CPU_ISSET (i, &native_cpus))
+			p_uthread_cpu_set_add (cpus, i);
+	}
+
+	return TRUE;
+#else
+	P_UNUSED (thread);
+	P_UNUSED (cpus);
+
+	return FALSE;
+#endif
+}
+
 P_LIB_API void
 p_uthread_yield (void)
 {
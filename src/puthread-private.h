@@ -46,6 +46,7 @@ typedef struct PUThreadBase_ {
 	ppointer		data;		/**< Thread input data.	*/
 	PUThreadPriority	prio;		/**< Thread priority.	*/
 	pchar			*name;		/**< Thread name	*/
+	PUThreadCpuSet		*cpus;		/**< Initial affinity.	*/
 } PUThreadBase;
 
 P_END_DECLS
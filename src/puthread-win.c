@@ -372,6 +372,63 @@ p_uthread_free_internal (PUThread *thread)
 	p_free (thread);
 }
 
+pboolean
+p_uthread_set_affinity_internal (PUThread		*thread,
+				 const PUThreadCpuSet	*cpus)
+{
+	DWORD_PTR	mask = 0;
+	pint		i;
+
+	/* Only the current processor group is supported */
+	for (i = 0; i < (pint) (sizeof (DWORD_PTR) * 8) && i < P_UTHREAD_CPU_SET_SIZE; ++i) {
+		if (p_uthread_cpu_set_contains (cpus, i) == TRUE)
+			mask |= ((DWORD_PTR) 1) << i;
+	}
+
+	if (P_UNLIKELY (mask == 0))
+		return FALSE;
+
+	if (P_UNLIKELY (SetThreadAffinityMask (thread == NULL ? GetCurrentThread () : thread->hdl, mask) == 0)) {
+		P_WARNING ("PUThread::p_uthread_set_affinity_internal: SetThreadAffinityMask() failed");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+pboolean
+p_uthread_get_affinity_internal (PUThread	*thread,
+				 PUThreadCpuSet	*cpus)
+{
+	HANDLE		hdl;
+	DWORD_PTR	process_mask;
+	DWORD_PTR	system_mask;
+	DWORD_PTR	mask;
+	pint		i;
+
+	hdl = thread == NULL ? GetCurrentThread () : thread->hdl;
+
+	if (P_UNLIKELY (GetProcessAffinityMask (GetCurrentProcess (), &process_mask, &system_mask) == 0)) {
+		P_WARNING ("PUThread::p_uthread_get_affinity_internal: GetProcessAffinityMask() failed");
+		return FALSE;
+	}
+
+	/* There is no direct getter: set the widest mask and restore the old one */
+	if (P_UNLIKELY ((mask = SetThreadAffinityMask (hdl, process_mask)) == 0)) {
+		P_WARNING ("PUThread::p_uthread_get_affinity_internal: SetThreadAffinityMask() failed");
+		return FALSE;
+	}
+
+	SetThreadAffinityMask (hdl, mask);
+
+	for (i = 0; i < (pint) (sizeof (DWORD_PTR) * 8) && i < P_UTHREAD_CPU_SET_SIZE; ++i) {
+		if ((mask & (((DWORD_PTR) 1) << i)) != 0)
+			p_uthread_cpu_set_add (cpus, i);
+	}
+
+	return TRUE;
+}
+
 P_LIB_API void
 p_uthread_yield (void)
 {
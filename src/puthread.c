@@ -97,6 +97,26 @@ typedef void (WINAPI * SystemInfoFunc) (LPSYSTEM_INFO);
 #  include <proto/exec.h>
 #endif
 
+#ifdef P_OS_LINUX
+#  include <stdio.h>
+#  define P_UTHREAD_SYS_CPU_PATH	"/sys/devices/system/cpu"
+#  define P_UTHREAD_SYS_NODE_PATH	"/sys/devices/system/node"
+#  define P_UTHREAD_SYS_PATH_MAX	128
+#  define P_UTHREAD_SYS_BUF_MAX		1024
+#  define P_UTHREAD_SYS_MAX_CACHES	16
+#endif
+
+#define P_UTHREAD_STATIC_KEY_FALLBACK	-1
+#define P_UTHREAD_STATIC_CLEANUP_PASSES	4
+
+struct PUThreadTopology_ {
+	pint		cpu_count;
+	pint		core_count;
+	pint		package_count;
+	pint		node_count;
+	PUThreadCpuInfo	*cpus;
+};
+
 extern void p_uthread_init_internal (void);
 extern void p_uthread_shutdown_internal (void);
 extern void p_uthread_exit_internal (void);
@@ -107,9 +127,29 @@ extern PUThread * p_uthread_create_internal (PUThreadFunc	func,
 					     pboolean		joinable,
 					     PUThreadPriority	prio,
 					     psize		stack_size);
+extern pboolean p_uthread_set_affinity_internal (PUThread *thread, const PUThreadCpuSet *cpus);
+extern pboolean p_uthread_get_affinity_internal (PUThread *thread, PUThreadCpuSet *cpus);
 
 static void pp_uthread_cleanup (ppointer data);
 static ppointer pp_uthread_proxy (ppointer data);
+static pint pp_uthread_static_get_index (PUThreadStaticKey *key);
+static PUThreadKey * pp_uthread_static_get_key (PUThreadStaticKey *key);
+
+#ifdef PLIBSYS_THREAD_LOCAL
+static void pp_uthread_static_cleanup (ppointer data);
+#endif
+static pint pp_uthread_topology_count_unique (const PUThreadTopology *topology, pboolean by_node);
+static pboolean pp_uthread_topology_detect_default (PUThreadTopology *topology);
+
+#ifdef P_OS_LINUX
+static void pp_uthread_build_sys_path (pchar *buf, const pchar *dir, pint id, const pchar *file);
+static pboolean pp_uthread_read_sys_file (const pchar *path, pchar *buf, psize len);
+static pint pp_uthread_read_sys_int (const pchar *path);
+static psize pp_uthread_parse_size (const pchar *str);
+static pboolean pp_uthread_parse_cpu_list (const pchar *str, PUThreadCpuSet *cpus);
+static void pp_uthread_read_caches (PUThreadCpuInfo *info);
+static pboolean pp_uthread_topology_detect_sys (PUThreadTopology *topology);
+#endif
 
 #ifndef P_OS_WIN
 #  if !defined (PLIBSYS_HAS_CLOCKNANOSLEEP) && !defined (PLIBSYS_HAS_NANOSLEEP)
@@ -120,12 +160,106 @@ static pint pp_uthread_nanosleep (puint32 msec);
 static PUThreadKey * pp_uthread_specific_data = NULL;
 static PSpinLock * pp_uthread_new_spin = NULL;
 
+#ifdef PLIBSYS_THREAD_LOCAL
+/* Caches the TLS key values to avoid system calls on hot paths */
+static PLIBSYS_THREAD_LOCAL PUThreadBase * pp_uthread_current_tls = NULL;
+static PLIBSYS_THREAD_LOCAL ppointer pp_uthread_static_values[P_UTHREAD_STATIC_KEY_MAX];
+static PLIBSYS_THREAD_LOCAL pboolean pp_uthread_static_registered = FALSE;
+
+static PDestroyFunc pp_uthread_static_funcs[P_UTHREAD_STATIC_KEY_MAX];
+static volatile pint pp_uthread_static_count = 0;
+static PUThreadKey * pp_uthread_static_cleanup_key = NULL;
+#endif
+
 static void
 pp_uthread_cleanup (ppointer data)
 {
+#ifdef PLIBSYS_THREAD_LOCAL
+	pp_uthread_current_tls = NULL;
+#endif
+
 	p_uthread_unref (data);
 }
 
+static pint
+pp_uthread_static_get_index (PUThreadStaticKey *key)
+{
+	pint index;
+
+	if (P_LIKELY ((index = p_atomic_int_get (&key->index)) != 0))
+		return index;
+
+#ifdef PLIBSYS_THREAD_LOCAL
+	/* Slot taken by a key which has lost the race below is wasted */
+	index = p_atomic_int_add (&pp_uthread_static_count, 1) + 1;
+
+	if (index > P_UTHREAD_STATIC_KEY_MAX)
+		index = P_UTHREAD_STATIC_KEY_FALLBACK;
+	else
+		pp_uthread_static_funcs[index - 1] = key->free_func;
+#else
+	index = P_UTHREAD_STATIC_KEY_FALLBACK;
+#endif
+
+	if (p_atomic_int_compare_and_exchange (&key->index, 0, index) == FALSE)
+		index = p_atomic_int_get (&key->index);
+
+	return index;
+}
+
+static PUThreadKey *
+pp_uthread_static_get_key (PUThreadStaticKey *key)
+{
+	PUThreadKey *tls_key;
+
+	if (P_LIKELY ((tls_key = p_atomic_pointer_get (&key->key)) != NULL))
+		return tls_key;
+
+	if (P_UNLIKELY ((tls_key = p_uthread_local_new (key->free_func)) == NULL))
+		return NULL;
+
+	if (p_atomic_pointer_compare_and_exchange (&key->key, NULL, tls_key) == FALSE) {
+		p_uthread_local_free (tls_key);
+		tls_key = p_atomic_pointer_get (&key->key);
+	}
+
+	return tls_key;
+}
+
+#ifdef PLIBSYS_THREAD_LOCAL
+static void
+pp_uthread_static_cleanup (ppointer data)
+{
+	ppointer	value;
+	pboolean	found;
+	pint		pass;
+	pint		i;
+
+	P_UNUSED (data);
+
+	/* Destroy notifications may set new values as well */
+	for (pass = 0; pass < P_UTHREAD_STATIC_CLEANUP_PASSES; ++pass) {
+		found = FALSE;
+
+		for (i = 0; i < P_UTHREAD_STATIC_KEY_MAX; ++i) {
+			if ((value = pp_uthread_static_values[i]) == NULL)
+				continue;
+
+			pp_uthread_static_values[i] = NULL;
+			found = TRUE;
+
+			if (pp_uthread_static_funcs[i] != NULL)
+				pp_uthread_static_funcs[i] (value);
+		}
+
+		if (found == FALSE)
+			break;
+	}
+
+	pp_uthread_static_registered = FALSE;
+}
+#endif
+
 static ppointer
 pp_uthread_proxy (ppointer data)
 {
@@ -133,12 +267,21 @@ pp_uthread_proxy (ppointer data)
 
 	p_uthread_set_local (pp_uthread_specific_data, data);
 
+#ifdef PLIBSYS_THREAD_LOCAL
+	pp_uthread_current_tls = base_thread;
+#endif
+
 	p_spinlock_lock (pp_uthread_new_spin);
 	p_spinlock_unlock (pp_uthread_new_spin);
 
 	if (base_thread->name != NULL)
 		p_uthread_set_name_internal ((PUThread *) base_thread);
 
+	if (base_thread->cpus != NULL) {
+		if (P_UNLIKELY (p_uthread_set_affinity (NULL, base_thread->cpus) == FALSE))
+			P_WARNING ("PUThread::pp_uthread_proxy: failed to set thread affinity");
+	}
+
 	base_thread->func (base_thread->data);
 
 	return NULL;
@@ -153,6 +296,11 @@ p_uthread_init (void)
 	if (P_LIKELY (pp_uthread_new_spin == NULL))
 		pp_uthread_new_spin = p_spinlock_new ();
 
+#ifdef PLIBSYS_THREAD_LOCAL
+	if (P_LIKELY (pp_uthread_static_cleanup_key == NULL))
+		pp_uthread_static_cleanup_key = p_uthread_local_new ((PDestroyFunc) pp_uthread_static_cleanup);
+#endif
+
 	p_uthread_init_internal ();
 }
 
@@ -173,6 +321,20 @@ p_uthread_shutdown (void)
 		pp_uthread_specific_data = NULL;
 	}
 
+#ifdef PLIBSYS_THREAD_LOCAL
+	pp_uthread_current_tls = NULL;
+
+	if (P_LIKELY (pp_uthread_static_cleanup_key != NULL)) {
+		if (pp_uthread_static_registered == TRUE) {
+			p_uthread_set_local (pp_uthread_static_cleanup_key, NULL);
+			pp_uthread_static_cleanup (NULL);
+		}
+
+		p_uthread_local_free (pp_uthread_static_cleanup_key);
+		pp_uthread_static_cleanup_key = NULL;
+	}
+#endif
+
 	if (P_LIKELY (pp_uthread_new_spin != NULL)) {
 		p_spinlock_free (pp_uthread_new_spin);
 		pp_uthread_new_spin = NULL;
@@ -181,6 +343,291 @@ p_uthread_shutdown (void)
 	p_uthread_shutdown_internal ();
 }
 
+static pint
+pp_uthread_topology_count_unique (const PUThreadTopology	*topology,
+				  pboolean			by_node)
+{
+	pint	count;
+	pint	value;
+	pint	i;
+	pint	j;
+
+	for (i = 0, count = 0; i < topology->cpu_count; ++i) {
+		value = by_node ? topology->cpus[i].node : topology->cpus[i].package;
+
+		for (j = 0; j < i; ++j) {
+			if (value == (by_node ? topology->cpus[j].node : topology->cpus[j].package))
+				break;
+		}
+
+		if (j == i)
+			++count;
+	}
+
+	return count;
+}
+
+static pboolean
+pp_uthread_topology_detect_default (PUThreadTopology *topology)
+{
+	pint count;
+	pint i;
+
+	count = p_uthread_ideal_count ();
+
+	if (P_UNLIKELY (count > P_UTHREAD_CPU_SET_SIZE))
+		count = P_UTHREAD_CPU_SET_SIZE;
+
+	if (P_UNLIKELY ((topology->cpus = p_malloc0 ((psize) count * sizeof (PUThreadCpuInfo))) == NULL))
+		return FALSE;
+
+	topology->cpu_count  = count;
+	topology->core_count = count;
+
+	for (i = 0; i < count; ++i) {
+		topology->cpus[i].cpu  = i;
+		topology->cpus[i].core = i;
+	}
+
+	return TRUE;
+}
+
+#ifdef P_OS_LINUX
+static void
+pp_uthread_build_sys_path (pchar	*buf,
+			   const pchar	*dir,
+			   pint		id,
+			   const pchar	*file)
+{
+	pchar	num[16];
+	pint	pos;
+
+	pos      = (pint) sizeof (num) - 1;
+	num[pos] = '\0';
+
+	do {
+		num[--pos] = (pchar) ('0' + id % 10);
+		id /= 10;
+	} while (id > 0);
+
+	strcpy (buf, dir);
+	strcat (buf, num + pos);
+	strcat (buf, file);
+}
+
+static pboolean
+pp_uthread_read_sys_file (const pchar	*path,
+			  pchar		*buf,
+			  psize		len)
+{
+	FILE		*file;
+	pboolean	ret;
+
+	if ((file = fopen (path, "r")) == NULL)
+		return FALSE;
+
+	ret = fgets (buf, (pint) len, file) != NULL;
+
+	fclose (file);
+
+	return ret;
+}
+
+static pint
+pp_uthread_read_sys_int (const pchar *path)
+{
+	pchar buf[32];
+
+	if (pp_uthread_read_sys_file (path, buf, sizeof (buf)) == FALSE)
+		return -1;
+
+	return atoi (buf);
+}
+
+static psize
+pp_uthread_parse_size (const pchar *str)
+{
+	psize	size;
+	pchar	*end;
+
+	size = (psize) strtoul (str, &end, 10);
+
+	if (*end == 'K')
+		size *= 1024;
+	else if (*end == 'M')
+		size *= 1024 * 1024;
+	else if (*end == 'G')
+		size *= 1024 * 1024 * 1024;
+
+	return size;
+}
+
+static pboolean
+pp_uthread_parse_cpu_list (const pchar		*str,
+			   PUThreadCpuSet	*cpus)
+{
+	pchar	*end;
+	plong	first;
+	plong	last;
+
+	p_uthread_cpu_set_clear (cpus);
+
+	/* Format is a comma-separated list of numbers and ranges: 0-3,8,10-11 */
+	while (*str >= '0' && *str <= '9') {
+		first = strtol (str, &end, 10);
+		last  = first;
+
+		if (*end == '-')
+			last = strtol (end + 1, &end, 10);
+
+		for (; first <= last && first < P_UTHREAD_CPU_SET_SIZE; ++first)
+			p_uthread_cpu_set_add (cpus, (pint) first);
+
+		if (*end != ',')
+			break;
+
+		str = end + 1;
+	}
+
+	return p_uthread_cpu_set_get_count (cpus) > 0;
+}
+
+static void
+pp_uthread_read_caches (PUThreadCpuInfo *info)
+{
+	pchar	prefix[P_UTHREAD_SYS_PATH_MAX];
+	pchar	path[P_UTHREAD_SYS_PATH_MAX];
+	pchar	buf[32];
+	psize	size;
+	pint	level;
+	pint	line;
+	pint	i;
+
+	pp_uthread_build_sys_path (prefix, P_UTHREAD_SYS_CPU_PATH "/cpu", info->cpu, "/cache/index");
+
+	for (i = 0; i < P_UTHREAD_SYS_MAX_CACHES; ++i) {
+		pp_uthread_build_sys_path (path, prefix, i, "/level");
+
+		if ((level = pp_uthread_read_sys_int (path)) < 0)
+			break;
+
+		pp_uthread_build_sys_path (path, prefix, i, "/type");
+
+		if (pp_uthread_read_sys_file (path, buf, sizeof (buf)) == FALSE ||
+		    strncmp (buf, "Instruction", 11) == 0)
+			continue;
+
+		pp_uthread_build_sys_path (path, prefix, i, "/size");
+
+		if (pp_uthread_read_sys_file (path, buf, sizeof (buf)) == FALSE)
+			continue;
+
+		size = pp_uthread_parse_size (buf);
+
+		if (level == 1)
+			info->l1_cache_size = size;
+		else if (level == 2)
+			info->l2_cache_size = size;
+		else if (level == 3)
+			info->l3_cache_size = size;
+
+		pp_uthread_build_sys_path (path, prefix, i, "/coherency_line_size");
+
+		if (info->cache_line_size == 0 && (line = pp_uthread_read_sys_int (path)) > 0)
+			info->cache_line_size = (psize) line;
+	}
+}
+
+static pboolean
+pp_uthread_topology_detect_sys (PUThreadTopology *topology)
+{
+	PUThreadCpuInfo	*info;
+	PUThreadCpuSet	online;
+	PUThreadCpuSet	siblings;
+	PUThreadCpuSet	nodes;
+	pchar		path[P_UTHREAD_SYS_PATH_MAX];
+	pchar		buf[P_UTHREAD_SYS_BUF_MAX];
+	pint		count;
+	pint		node;
+	pint		cpu;
+	pint		i;
+	pint		j;
+
+	if (pp_uthread_read_sys_file (P_UTHREAD_SYS_CPU_PATH "/online", buf, sizeof (buf)) == FALSE ||
+	    pp_uthread_parse_cpu_list (buf, &online) == FALSE)
+		return FALSE;
+
+	count = p_uthread_cpu_set_get_count (&online);
+
+	if (P_UNLIKELY ((topology->cpus = p_malloc0 ((psize) count * sizeof (PUThreadCpuInfo))) == NULL))
+		return FALSE;
+
+	topology->cpu_count = count;
+
+	for (cpu = 0, i = 0; cpu < P_UTHREAD_CPU_SET_SIZE && i < count; ++cpu) {
+		if (p_uthread_cpu_set_contains (&online, cpu) == FALSE)
+			continue;
+
+		info = &topology->cpus[i++];
+
+		info->cpu  = cpu;
+		info->core = -1;
+
+		pp_uthread_build_sys_path (path, P_UTHREAD_SYS_CPU_PATH "/cpu", cpu, "/topology/physical_package_id");
+
+		if ((info->package = pp_uthread_read_sys_int (path)) < 0)
+			info->package = 0;
+
+		pp_uthread_read_caches (info);
+	}
+
+	/* Core index is assigned by its first CPU and shared with its SMT siblings */
+	for (i = 0; i < count; ++i) {
+		info = &topology->cpus[i];
+
+		if (info->core >= 0)
+			continue;
+
+		info->core = topology->core_count++;
+
+		pp_uthread_build_sys_path (path, P_UTHREAD_SYS_CPU_PATH "/cpu", info->cpu, "/topology/thread_siblings_list");
+
+		if (pp_uthread_read_sys_file (path, buf, sizeof (buf)) == FALSE ||
+		    pp_uthread_parse_cpu_list (buf, &siblings) == FALSE)
+			continue;
+
+		for (j = i + 1; j < count; ++j) {
+			if (topology->cpus[j].core < 0 &&
+			    p_uthread_cpu_set_contains (&siblings, topology->cpus[j].cpu) == TRUE)
+				topology->cpus[j].core = info->core;
+		}
+	}
+
+	/* Systems without NUMA support have no nodes, all the CPUs stay on node 0 */
+	if (pp_uthread_read_sys_file (P_UTHREAD_SYS_NODE_PATH "/online", buf, sizeof (buf)) == FALSE ||
+	    pp_uthread_parse_cpu_list (buf, &nodes) == FALSE)
+		return TRUE;
+
+	for (node = 0; node < P_UTHREAD_CPU_SET_SIZE; ++node) {
+		if (p_uthread_cpu_set_contains (&nodes, node) == FALSE)
+			continue;
+
+		pp_uthread_build_sys_path (path, P_UTHREAD_SYS_NODE_PATH "/node", node, "/cpulist");
+
+		if (pp_uthread_read_sys_file (path, buf, sizeof (buf)) == FALSE ||
+		    pp_uthread_parse_cpu_list (buf, &siblings) == FALSE)
+			continue;
+
+		for (i = 0; i < count; ++i) {
+			if (p_uthread_cpu_set_contains (&siblings, topology->cpus[i].cpu) == TRUE)
+				topology->cpus[i].node = node;
+		}
+	}
+
+	return TRUE;
+}
+#endif
+
 P_LIB_API PUThread *
 p_uthread_create_full (PUThreadFunc	func,
 		       ppointer		data,
@@ -189,11 +636,34 @@ p_uthread_create_full (PUThreadFunc	func,
 		       psize		stack_size,
 		       const pchar	*name)
 {
-	PUThreadBase *base_thread;
+	/* All checks will be inside */
+	return p_uthread_create_with_affinity (func, data, joinable, prio, stack_size, name, NULL);
+}
+
+P_LIB_API PUThread *
+p_uthread_create_with_affinity (PUThreadFunc		func,
+				ppointer		data,
+				pboolean		joinable,
+				PUThreadPriority	prio,
+				psize			stack_size,
+				const pchar		*name,
+				const PUThreadCpuSet	*cpus)
+{
+	PUThreadBase	*base_thread;
+	PUThreadCpuSet	*thread_cpus = NULL;
 
 	if (P_UNLIKELY (func == NULL))
 		return NULL;
 
+	if (cpus != NULL) {
+		if (P_UNLIKELY ((thread_cpus = p_malloc (sizeof (PUThreadCpuSet))) == NULL)) {
+			P_ERROR ("PUThread::p_uthread_create_with_affinity: failed to allocate memory");
+			return NULL;
+		}
+
+		memcpy (thread_cpus, cpus, sizeof (PUThreadCpuSet));
+	}
+
 	p_spinlock_lock (pp_uthread_new_spin);
 
 	base_thread = (PUThreadBase *) p_uthread_create_internal (pp_uthread_proxy,
@@ -208,7 +678,9 @@ p_uthread_create_full (PUThreadFunc	func,
 		base_thread->func      = func;
 		base_thread->data      = data;
 		base_thread->name      = p_strdup (name);
-	}
+		base_thread->cpus      = thread_cpus;
+	} else
+		p_free (thread_cpus);
 
 	p_spinlock_unlock (pp_uthread_new_spin);
 
@@ -222,7 +694,48 @@ p_uthread_create (PUThreadFunc	func,
 		  const pchar	*name)
 {
 	/* All checks will be inside */
-	return p_uthread_create_full (func, data, joinable, P_UTHREAD_PRIORITY_INHERIT, 0, name);
+	return p_uthread_create_with_affinity (func, data, joinable, P_UTHREAD_PRIORITY_INHERIT, 0, name, NULL);
+}
+
+P_LIB_API pboolean
+p_uthread_set_affinity (PUThread		*thread,
+			const PUThreadCpuSet	*cpus)
+{
+	if (P_UNLIKELY (cpus == NULL || p_uthread_cpu_set_get_count (cpus) == 0))
+		return FALSE;
+
+	/* Foreign threads have no handle, they can only refer to the caller */
+	if (thread != NULL && ((PUThreadBase *) thread)->ours == FALSE) {
+		if (P_UNLIKELY (thread != p_uthread_current ())) {
+			P_WARNING ("PUThread::p_uthread_set_affinity: foreign thread can be bound only by itself");
+			return FALSE;
+		}
+
+		thread = NULL;
+	}
+
+	return p_uthread_set_affinity_internal (thread, cpus);
+}
+
+P_LIB_API pboolean
+p_uthread_get_affinity (PUThread	*thread,
+			PUThreadCpuSet	*cpus)
+{
+	if (P_UNLIKELY (cpus == NULL))
+		return FALSE;
+
+	if (thread != NULL && ((PUThreadBase *) thread)->ours == FALSE) {
+		if (P_UNLIKELY (thread != p_uthread_current ())) {
+			P_WARNING ("PUThread::p_uthread_get_affinity: foreign thread can be queried only by itself");
+			return FALSE;
+		}
+
+		thread = NULL;
+	}
+
+	p_uthread_cpu_set_clear (cpus);
+
+	return p_uthread_get_affinity_internal (thread, cpus);
 }
 
 P_LIB_API void
@@ -264,7 +777,14 @@ p_uthread_join (PUThread *thread)
 P_LIB_API PUThread *
 p_uthread_current (void)
 {
-	PUThreadBase *base_thread = p_uthread_get_local (pp_uthread_specific_data);
+	PUThreadBase *base_thread;
+
+#ifdef PLIBSYS_THREAD_LOCAL
+	if (P_LIKELY (pp_uthread_current_tls != NULL))
+		return (PUThread *) pp_uthread_current_tls;
+#endif
+
+	base_thread = p_uthread_get_local (pp_uthread_specific_data);
 
 	if (P_UNLIKELY (base_thread == NULL)) {
 		if (P_UNLIKELY ((base_thread = p_malloc0 (sizeof (PUThreadBase))) == NULL)) {
@@ -277,9 +797,83 @@ p_uthread_current (void)
 		p_uthread_set_local (pp_uthread_specific_data, base_thread);
 	}
 
+#ifdef PLIBSYS_THREAD_LOCAL
+	pp_uthread_current_tls = base_thread;
+#endif
+
 	return (PUThread *) base_thread;
 }
 
+P_LIB_API ppointer
+p_uthread_static_get_local (PUThreadStaticKey *key)
+{
+#ifdef PLIBSYS_THREAD_LOCAL
+	pint index;
+#endif
+
+	if (P_UNLIKELY (key == NULL))
+		return NULL;
+
+#ifdef PLIBSYS_THREAD_LOCAL
+	if (P_LIKELY ((index = pp_uthread_static_get_index (key)) > 0))
+		return pp_uthread_static_values[index - 1];
+#endif
+
+	return p_uthread_get_local (pp_uthread_static_get_key (key));
+}
+
+P_LIB_API void
+p_uthread_static_set_local (PUThreadStaticKey	*key,
+			    ppointer		value)
+{
+#ifdef PLIBSYS_THREAD_LOCAL
+	pint index;
+#endif
+
+	if (P_UNLIKELY (key == NULL))
+		return;
+
+#ifdef PLIBSYS_THREAD_LOCAL
+	if (P_LIKELY ((index = pp_uthread_static_get_index (key)) > 0)) {
+		pp_uthread_static_values[index - 1] = value;
+
+		/* Native TLS has no destructors, use a system TLS key for that */
+		if (value != NULL &&
+		    pp_uthread_static_registered == FALSE &&
+		    pp_uthread_static_cleanup_key != NULL) {
+			p_uthread_set_local (pp_uthread_static_cleanup_key, PINT_TO_POINTER (1));
+			pp_uthread_static_registered = TRUE;
+		}
+
+		return;
+	}
+#endif
+
+	p_uthread_set_local (pp_uthread_static_get_key (key), value);
+}
+
+P_LIB_API void
+p_uthread_static_replace_local (PUThreadStaticKey	*key,
+				ppointer		value)
+{
+	ppointer old_value;
+
+	if (P_UNLIKELY (key == NULL))
+		return;
+
+	if (pp_uthread_static_get_index (key) == P_UTHREAD_STATIC_KEY_FALLBACK) {
+		p_uthread_replace_local (pp_uthread_static_get_key (key), value);
+		return;
+	}
+
+	old_value = p_uthread_static_get_local (key);
+
+	if (old_value != NULL && key->free_func != NULL)
+		key->free_func (old_value);
+
+	p_uthread_static_set_local (key, value);
+}
+
 P_LIB_API pint
 p_uthread_ideal_count (void)
 {
@@ -444,6 +1038,194 @@ p_uthread_ideal_count (void)
 #endif
 }
 
+P_LIB_API void
+p_uthread_cpu_set_clear (PUThreadCpuSet *cpus)
+{
+	if (P_UNLIKELY (cpus == NULL))
+		return;
+
+	memset (cpus, 0, sizeof (PUThreadCpuSet));
+}
+
+P_LIB_API pboolean
+p_uthread_cpu_set_add (PUThreadCpuSet	*cpus,
+		       pint		cpu)
+{
+	if (P_UNLIKELY (cpus == NULL || cpu < 0 || cpu >= P_UTHREAD_CPU_SET_SIZE))
+		return FALSE;
+
+	cpus->bits[cpu / 32] |= ((puint32) 1) << (cpu % 32);
+
+	return TRUE;
+}
+
+P_LIB_API void
+p_uthread_cpu_set_remove (PUThreadCpuSet	*cpus,
+			  pint			cpu)
+{
+	if (P_UNLIKELY (cpus == NULL || cpu < 0 || cpu >= P_UTHREAD_CPU_SET_SIZE))
+		return;
+
+	cpus->bits[cpu / 32] &= ~(((puint32) 1) << (cpu % 32));
+}
+
+P_LIB_API pboolean
+p_uthread_cpu_set_contains (const PUThreadCpuSet	*cpus,
+			    pint			cpu)
+{
+	if (P_UNLIKELY (cpus == NULL || cpu < 0 || cpu >= P_UTHREAD_CPU_SET_SIZE))
+		return FALSE;
+
+	return (cpus->bits[cpu / 32] & (((puint32) 1) << (cpu % 32))) != 0;
+}
+
+P_LIB_API pint
+p_uthread_cpu_set_get_count (const PUThreadCpuSet *cpus)
+{
+	puint32	bits;
+	pint	count;
+	pint	i;
+
+	if (P_UNLIKELY (cpus == NULL))
+		return 0;
+
+	for (i = 0, count = 0; i < P_UTHREAD_CPU_SET_SIZE / 32; ++i) {
+		for (bits = cpus->bits[i]; bits != 0; bits &= bits - 1)
+			++count;
+	}
+
+	return count;
+}
+
+P_LIB_API PUThreadTopology *
+p_uthread_topology_new (void)
+{
+	PUThreadTopology	*ret;
+	pboolean		detected = FALSE;
+
+	if (P_UNLIKELY ((ret = p_malloc0 (sizeof (PUThreadTopology))) == NULL)) {
+		P_ERROR ("PUThread::p_uthread_topology_new: failed to allocate memory");
+		return NULL;
+	}
+
+#ifdef P_OS_LINUX
+	detected = pp_uthread_topology_detect_sys (ret);
+#endif
+
+	if (detected == FALSE && ret->cpus == NULL)
+		detected = pp_uthread_topology_detect_default (ret);
+
+	if (P_UNLIKELY (detected == FALSE)) {
+		P_ERROR ("PUThread::p_uthread_topology_new: failed to allocate memory");
+		p_free (ret);
+		return NULL;
+	}
+
+	ret->package_count = pp_uthread_topology_count_unique (ret, FALSE);
+	ret->node_count    = pp_uthread_topology_count_unique (ret, TRUE);
+
+	return ret;
+}
+
+P_LIB_API void
+p_uthread_topology_free (PUThreadTopology *topology)
+{
+	if (P_UNLIKELY (topology == NULL))
+		return;
+
+	p_free (topology->cpus);
+	p_free (topology);
+}
+
+P_LIB_API pint
+p_uthread_topology_get_cpu_count (const PUThreadTopology *topology)
+{
+	if (P_UNLIKELY (topology == NULL))
+		return 0;
+
+	return topology->cpu_count;
+}
+
+P_LIB_API pint
+p_uthread_topology_get_core_count (const PUThreadTopology *topology)
+{
+	if (P_UNLIKELY (topology == NULL))
+		return 0;
+
+	return topology->core_count;
+}
+
+P_LIB_API pint
+p_uthread_topology_get_package_count (const PUThreadTopology *topology)
+{
+	if (P_UNLIKELY (topology == NULL))
+		return 0;
+
+	return topology->package_count;
+}
+
+P_LIB_API pint
+p_uthread_topology_get_node_count (const PUThreadTopology *topology)
+{
+	if (P_UNLIKELY (topology == NULL))
+		return 0;
+
+	return topology->node_count;
+}
+
+P_LIB_API pboolean
+p_uthread_topology_get_cpu_info (const PUThreadTopology	*topology,
+				 pint			index,
+				 PUThreadCpuInfo	*info)
+{
+	if (P_UNLIKELY (topology == NULL || info == NULL || index < 0 || index >= topology->cpu_count))
+		return FALSE;
+
+	memcpy (info, &topology->cpus[index], sizeof (PUThreadCpuInfo));
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_uthread_topology_get_core_cpus (const PUThreadTopology	*topology,
+				  pint				core,
+				  PUThreadCpuSet		*cpus)
+{
+	pint i;
+
+	if (P_UNLIKELY (topology == NULL || cpus == NULL || core < 0 || core >= topology->core_count))
+		return FALSE;
+
+	p_uthread_cpu_set_clear (cpus);
+
+	for (i = 0; i < topology->cpu_count; ++i) {
+		if (topology->cpus[i].core == core)
+			p_uthread_cpu_set_add (cpus, topology->cpus[i].cpu);
+	}
+
+	return TRUE;
+}
+
+P_LIB_API pboolean
+p_uthread_topology_get_node_cpus (const PUThreadTopology	*topology,
+				  pint				node,
+				  PUThreadCpuSet		*cpus)
+{
+	pint i;
+
+	if (P_UNLIKELY (topology == NULL || cpus == NULL))
+		return FALSE;
+
+	p_uthread_cpu_set_clear (cpus);
+
+	for (i = 0; i < topology->cpu_count; ++i) {
+		if (topology->cpus[i].node == node)
+			p_uthread_cpu_set_add (cpus, topology->cpus[i].cpu);
+	}
+
+	return p_uthread_cpu_set_get_count (cpus) > 0;
+}
+
 P_LIB_API void
 p_uthread_ref (PUThread *thread)
 {
@@ -465,6 +1247,7 @@ p_uthread_unref (PUThread *thread)
 
 	if (p_atomic_int_dec_and_test (&base_thread->ref_count) == TRUE) {
 		p_free (base_thread->name);
+		p_free (base_thread->cpus);
 
 		if (base_thread->ours == TRUE)
 			p_uthread_free_internal (thread);
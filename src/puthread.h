@@ -82,9 +82,38 @@
  * p_uthread_replace_local(). The only difference is that the former one calls
  * the provided destroy notification function before replacing the old value.
  *
+ * A TLS key can also be defined statically as a #PUThreadStaticKey
+ * initialized with #P_UTHREAD_STATIC_KEY_INIT. Such a key doesn't need to be
+ * created or freed and is accessed with p_uthread_static_get_local(),
+ * p_uthread_static_set_local() and p_uthread_static_replace_local(). When
+ * the compiler supports native thread-local storage, a static key costs just
+ * a couple of memory loads instead of a system TLS lookup, which makes it
+ * suitable for per-thread caches on hot paths. The number of such fast keys
+ * is limited by #P_UTHREAD_STATIC_KEY_MAX, the rest fall back to the regular
+ * TLS keys transparently.
+ *
+ * If the compiler-native thread-local storage is available, the
+ * #P_UTHREAD_NATIVE_TLS storage class specifier is defined, it can be used to
+ * declare thread-local variables directly. Note that such variables have no
+ * destroy notification.
+ *
  * Thread names are used on most of operating systems for debugging purposes,
  * thereby some limitations for long name can be applied and too long names
  * will be truncated automatically.
+ *
+ * A thread can be bound to a set of logical CPUs (#PUThreadCpuSet) using
+ * p_uthread_set_affinity(), or right from the start using
+ * p_uthread_create_with_affinity(). This is useful to keep latency-critical
+ * threads on dedicated cores and to keep threads close to their memory on
+ * NUMA systems. Affinity is not supported on all the platforms, so the calls
+ * may fail.
+ *
+ * To pick the CPUs use #PUThreadTopology, it describes how logical CPUs are
+ * grouped into physical cores (SMT siblings), packages and NUMA nodes, along
+ * with the cache sizes. Unlike p_uthread_ideal_count(), it allows to size
+ * thread pools by the number of physical cores. On the systems where the
+ * topology can't be detected, every logical CPU is reported as a separate
+ * core in a single package and NUMA node.
  */
 
 #if !defined (PLIBSYS_H_INSIDE) && !defined (PLIBSYS_COMPILATION)
@@ -108,6 +137,56 @@ typedef struct PUThread_ PUThread;
 /** TLS key opaque data type. */
 typedef struct PUThreadKey_ PUThreadKey;
 
+/** Maximum number of logical CPUs in a #PUThreadCpuSet. */
+#define P_UTHREAD_CPU_SET_SIZE	1024
+
+/** Set of logical CPUs, use p_uthread_cpu_set_*() calls to access it. */
+typedef struct PUThreadCpuSet_ {
+	puint32	bits[P_UTHREAD_CPU_SET_SIZE / 32];	/**< CPU bit mask.	*/
+} PUThreadCpuSet;
+
+/** Logical CPU description. */
+typedef struct PUThreadCpuInfo_ {
+	pint	cpu;			/**< Logical CPU number as used in #PUThreadCpuSet.		*/
+	pint	core;			/**< Physical core index, shared by SMT siblings.		*/
+	pint	package;		/**< Physical package (socket) ID.				*/
+	pint	node;			/**< NUMA node ID.						*/
+	psize	l1_cache_size;		/**< L1 data cache size in bytes, 0 if unknown.			*/
+	psize	l2_cache_size;		/**< L2 cache size in bytes, 0 if unknown.			*/
+	psize	l3_cache_size;		/**< L3 cache size in bytes, 0 if unknown.			*/
+	psize	cache_line_size;	/**< Cache line size in bytes, 0 if unknown.			*/
+} PUThreadCpuInfo;
+
+/** CPU topology opaque data type. */
+typedef struct PUThreadTopology_ PUThreadTopology;
+
+/** Maximum number of static TLS keys served by the compiler-native TLS. */
+#define P_UTHREAD_STATIC_KEY_MAX	64
+
+/** Static TLS key, must be initialized with #P_UTHREAD_STATIC_KEY_INIT. */
+typedef struct PUThreadStaticKey_ {
+	volatile pint	index;		/**< Native TLS slot index, internal.	*/
+	volatile void	*key;		/**< Fallback TLS key, internal.	*/
+	PDestroyFunc	free_func;	/**< TLS value destroy notification.	*/
+} PUThreadStaticKey;
+
+/**
+ * @brief Initializer for a #PUThreadStaticKey.
+ * @param free_func TLS value destroy notification, may be NULL.
+ * @since 0.0.6
+ */
+#define P_UTHREAD_STATIC_KEY_INIT(free_func) { 0, NULL, (PDestroyFunc) (free_func) }
+
+#ifdef PLIBSYS_THREAD_LOCAL
+/**
+ * @brief Storage class specifier for compiler-native thread-local variables.
+ * @since 0.0.6
+ *
+ * Defined only if the compiler supports native thread-local storage.
+ */
+#  define P_UTHREAD_NATIVE_TLS	PLIBSYS_THREAD_LOCAL
+#endif
+
 /** Thread priority. */
 typedef enum PUThreadPriority_ {
 	P_UTHREAD_PRIORITY_INHERIT	= 0,	/**< Inherits the caller thread priority. Default priority.	*/
@@ -158,6 +237,32 @@ P_LIB_API PUThread *	p_uthread_create	(PUThreadFunc		func,
 						 pboolean		joinable,
 						 const pchar		*name);
 
+/**
+ * @brief Creates a new #PUThread bound to a set of CPUs and starts it.
+ * @param func Main thread function to run.
+ * @param data Pointer to pass into the thread main function, may be NULL.
+ * @param joinable Whether to create a joinable thread or not.
+ * @param prio Thread priority.
+ * @param stack_size Thread stack size, in bytes. Leave zero to use a default
+ * value.
+ * @param name Thread name, maybe NULL.
+ * @param cpus Set of CPUs to run the thread on, NULL to not bind the thread.
+ * @return Pointer to #PUThread in case of success, NULL otherwise.
+ * @since 0.0.6
+ * @note Unreference the returned value after use with p_uthread_unref(). You do
+ * not need to call p_uthread_ref() explicitly on the returned value.
+ *
+ * The affinity is applied before the @a func is called. If it can't be applied
+ * the thread runs anyway and a warning is printed.
+ */
+P_LIB_API PUThread *	p_uthread_create_with_affinity (PUThreadFunc	func,
+							ppointer		data,
+							pboolean		joinable,
+							PUThreadPriority	prio,
+							psize			stack_size,
+							const pchar		*name,
+							const PUThreadCpuSet	*cpus);
+
 /**
  * @brief Exits from the currently running (caller) thread.
  * @param code Exit code.
@@ -192,6 +297,35 @@ P_LIB_API pint		p_uthread_sleep		(puint32		msec);
 P_LIB_API pboolean	p_uthread_set_priority	(PUThread		*thread,
 						 PUThreadPriority	prio);
 
+/**
+ * @brief Binds a thread to a set of CPUs.
+ * @param thread Thread to bind, NULL for the current (caller) thread.
+ * @param cpus Set of CPUs to run the thread on, must not be empty.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * A thread structure of the thread created outside the library (see
+ * p_uthread_current()) can be used only from the thread itself, FALSE is
+ * returned otherwise.
+ */
+P_LIB_API pboolean	p_uthread_set_affinity	(PUThread		*thread,
+						 const PUThreadCpuSet	*cpus);
+
+/**
+ * @brief Gets a set of CPUs a thread is allowed to run on.
+ * @param thread Thread to get the affinity for, NULL for the current (caller)
+ * thread.
+ * @param[out] cpus Set of CPUs to store the affinity in.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * A thread structure of the thread created outside the library (see
+ * p_uthread_current()) can be used only from the thread itself, FALSE is
+ * returned otherwise.
+ */
+P_LIB_API pboolean	p_uthread_get_affinity	(PUThread		*thread,
+						 PUThreadCpuSet		*cpus);
+
 /**
  * @brief Tells the scheduler to skip the current (caller) thread in the current
  * planning stage.
@@ -233,6 +367,144 @@ P_LIB_API PUThread *	p_uthread_current	(void);
  */
 P_LIB_API pint		p_uthread_ideal_count	(void);
 
+/**
+ * @brief Removes all the CPUs from a #PUThreadCpuSet.
+ * @param cpus #PUThreadCpuSet to clear.
+ * @since 0.0.6
+ */
+P_LIB_API void		p_uthread_cpu_set_clear	(PUThreadCpuSet		*cpus);
+
+/**
+ * @brief Adds a CPU to a #PUThreadCpuSet.
+ * @param cpus #PUThreadCpuSet to add the CPU to.
+ * @param cpu Logical CPU number, starting from 0.
+ * @return TRUE in case of success, FALSE if the @a cpu is out of range.
+ * @since 0.0.6
+ */
+P_LIB_API pboolean	p_uthread_cpu_set_add	(PUThreadCpuSet		*cpus,
+						 pint			cpu);
+
+/**
+ * @brief Removes a CPU from a #PUThreadCpuSet.
+ * @param cpus #PUThreadCpuSet to remove the CPU from.
+ * @param cpu Logical CPU number, starting from 0.
+ * @since 0.0.6
+ */
+P_LIB_API void		p_uthread_cpu_set_remove (PUThreadCpuSet	*cpus,
+						  pint			cpu);
+
+/**
+ * @brief Checks whether a #PUThreadCpuSet contains a CPU.
+ * @param cpus #PUThreadCpuSet to check.
+ * @param cpu Logical CPU number, starting from 0.
+ * @return TRUE if the @a cpu is in the set, FALSE otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API pboolean	p_uthread_cpu_set_contains (const PUThreadCpuSet *cpus,
+						    pint		cpu);
+
+/**
+ * @brief Gets the number of CPUs in a #PUThreadCpuSet.
+ * @param cpus #PUThreadCpuSet to count the CPUs in.
+ * @return Number of CPUs in the set.
+ * @since 0.0.6
+ */
+P_LIB_API pint		p_uthread_cpu_set_get_count (const PUThreadCpuSet *cpus);
+
+/**
+ * @brief Detects the CPU topology of the system.
+ * @return Pointer to a newly created #PUThreadTopology object in case of
+ * success, NULL otherwise.
+ * @since 0.0.6
+ *
+ * Only online CPUs are taken into account. The topology is a snapshot, it
+ * doesn't reflect CPUs going online or offline later.
+ */
+P_LIB_API PUThreadTopology *	p_uthread_topology_new	(void);
+
+/**
+ * @brief Frees #PUThreadTopology object.
+ * @param topology #PUThreadTopology to free.
+ * @since 0.0.6
+ */
+P_LIB_API void		p_uthread_topology_free	(PUThreadTopology	*topology);
+
+/**
+ * @brief Gets the number of logical CPUs.
+ * @param topology #PUThreadTopology to get the number of CPUs for.
+ * @return Number of logical CPUs.
+ * @since 0.0.6
+ */
+P_LIB_API pint		p_uthread_topology_get_cpu_count	(const PUThreadTopology	*topology);
+
+/**
+ * @brief Gets the number of physical cores.
+ * @param topology #PUThreadTopology to get the number of cores for.
+ * @return Number of physical cores.
+ * @since 0.0.6
+ *
+ * Logical CPUs of a single core (SMT siblings) share execution units, so this
+ * is a better limit for CPU-bound thread pools than p_uthread_ideal_count().
+ */
+P_LIB_API pint		p_uthread_topology_get_core_count	(const PUThreadTopology	*topology);
+
+/**
+ * @brief Gets the number of physical packages (sockets).
+ * @param topology #PUThreadTopology to get the number of packages for.
+ * @return Number of physical packages.
+ * @since 0.0.6
+ */
+P_LIB_API pint		p_uthread_topology_get_package_count	(const PUThreadTopology	*topology);
+
+/**
+ * @brief Gets the number of NUMA nodes.
+ * @param topology #PUThreadTopology to get the number of NUMA nodes for.
+ * @return Number of NUMA nodes with CPUs.
+ * @since 0.0.6
+ */
+P_LIB_API pint		p_uthread_topology_get_node_count	(const PUThreadTopology	*topology);
+
+/**
+ * @brief Gets a logical CPU description.
+ * @param topology #PUThreadTopology to get the description from.
+ * @param index Index of the CPU, from 0 to p_uthread_topology_get_cpu_count()
+ * exclusive.
+ * @param[out] info Logical CPU description.
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ *
+ * CPUs are sorted by their logical numbers, but the numbers are not always
+ * contiguous: use the @a cpu field of the @a info for a #PUThreadCpuSet.
+ */
+P_LIB_API pboolean	p_uthread_topology_get_cpu_info		(const PUThreadTopology	*topology,
+								 pint			index,
+								 PUThreadCpuInfo	*info);
+
+/**
+ * @brief Gets logical CPUs of a physical core.
+ * @param topology #PUThreadTopology to get the CPUs from.
+ * @param core Physical core index, from 0 to
+ * p_uthread_topology_get_core_count() exclusive.
+ * @param[out] cpus Set of the core's logical CPUs (SMT siblings).
+ * @return TRUE in case of success, FALSE otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API pboolean	p_uthread_topology_get_core_cpus	(const PUThreadTopology	*topology,
+								 pint			core,
+								 PUThreadCpuSet		*cpus);
+
+/**
+ * @brief Gets logical CPUs of a NUMA node.
+ * @param topology #PUThreadTopology to get the CPUs from.
+ * @param node NUMA node ID.
+ * @param[out] cpus Set of the node's logical CPUs.
+ * @return TRUE if the node has at least one CPU, FALSE otherwise.
+ * @since 0.0.6
+ */
+P_LIB_API pboolean	p_uthread_topology_get_node_cpus	(const PUThreadTopology	*topology,
+								 pint			node,
+								 PUThreadCpuSet		*cpus);
+
 /**
  * @brief Increments a thread reference counter
  * @param thread #PUThread to increment the reference counter.
@@ -306,6 +578,39 @@ P_LIB_API void		p_uthread_set_local	(PUThreadKey		*key,
 P_LIB_API void		p_uthread_replace_local	(PUThreadKey		*key,
 						 ppointer		value);
 
+/**
+ * @brief Gets a TLS value of a static key.
+ * @param key Static TLS key to get the value for.
+ * @return TLS value for the given key, NULL if it has not been set.
+ * @since 0.0.6
+ */
+P_LIB_API ppointer	p_uthread_static_get_local	(PUThreadStaticKey	*key);
+
+/**
+ * @brief Sets a TLS value of a static key.
+ * @param key Static TLS key to set the value for.
+ * @param value TLS value to set.
+ * @since 0.0.6
+ *
+ * It doesn't call the destroy notification function on the old value. A
+ * non-NULL value is destroyed with the notification function on the thread
+ * exit.
+ */
+P_LIB_API void		p_uthread_static_set_local	(PUThreadStaticKey	*key,
+							 ppointer		value);
+
+/**
+ * @brief Replaces a TLS value of a static key.
+ * @param key Static TLS key to replace the value for.
+ * @param value TLS value to set.
+ * @since 0.0.6
+ *
+ * This call does perform the destroy notification function on the old TLS
+ * value. This is the only difference with p_uthread_static_set_local().
+ */
+P_LIB_API void		p_uthread_static_replace_local	(PUThreadStaticKey	*key,
+							 ppointer		value);
+
 P_END_DECLS
 
 #endif /* PLIBSYS_HEADER_PUTHREAD_H */
@@ -0,0 +1,353 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+#ifdef P_OS_UNIX
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+P_TEST_MODULE_INIT ();
+
+#define PASYNCIO_TEST_FILE	"." P_DIR_SEPARATOR "pasyncio_test_file"
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static pint async_io_test_wait (PAsyncIO		*aio,
+				PAsyncIOCompletion	*completions,
+				pint			count)
+{
+	pint	total;
+	pint	ret;
+	pint	i;
+
+	total = 0;
+
+	for (i = 0; i < 10 && total < count; ++i) {
+		if ((ret = p_async_io_get_completions (aio, completions + total, count - total, 500, NULL)) < 0)
+			return -1;
+
+		total += ret;
+	}
+
+	return total;
+}
+
+static PAsyncIOCompletion * async_io_test_find (PAsyncIOCompletion	*completions,
+						pint			count,
+						ppointer		user_data)
+{
+	pint i;
+
+	for (i = 0; i < count; ++i) {
+		if (completions[i].user_data == user_data)
+			return &completions[i];
+	}
+
+	return NULL;
+}
+
+static void async_io_test_backend (PAsyncIOBackend backend)
+{
+	PAsyncIO		*aio;
+	PAsyncIOCompletion	completions[4];
+	PAsyncIOCompletion	*completion;
+	PSocketAddress		*addr;
+	PSocketAddress		*server_addr;
+	PSocket			*server;
+	PSocket			*client;
+	PSocket			*accepted;
+	PError			*error;
+	pchar			send_buf[] = "asynchronous I/O";
+	pchar			recv_buf[64];
+	pchar			extra_buf[2][8];
+
+	error = NULL;
+	aio   = p_async_io_new (8, backend, &error);
+
+	if (aio == NULL) {
+		/* io_uring may be missing or prohibited */
+		P_TEST_CHECK (backend == P_ASYNC_IO_BACKEND_IO_URING);
+		P_TEST_CHECK (error != NULL);
+
+		p_error_free (error);
+		return;
+	}
+
+	P_TEST_CHECK (p_async_io_get_backend (aio) == backend);
+	P_TEST_CHECK (p_async_io_get_pending (aio) == 0);
+
+	/* Nothing to wait for */
+	P_TEST_CHECK (p_async_io_get_completions (aio, completions, 4, -1, NULL) == 0);
+	P_TEST_CHECK (p_async_io_submit (aio, NULL) == 0);
+
+	server = p_socket_new (P_SOCKET_FAMILY_INET, P_SOCKET_TYPE_STREAM, P_SOCKET_PROTOCOL_TCP, NULL);
+	client = p_socket_new (P_SOCKET_FAMILY_INET, P_SOCKET_TYPE_STREAM, P_SOCKET_PROTOCOL_TCP, NULL);
+	addr   = p_socket_address_new ("127.0.0.1", 0);
+
+	P_TEST_REQUIRE (server != NULL);
+	P_TEST_REQUIRE (client != NULL);
+	P_TEST_REQUIRE (addr != NULL);
+
+	P_TEST_REQUIRE (p_socket_bind (server, addr, FALSE, NULL) == TRUE);
+	P_TEST_REQUIRE (p_socket_listen (server, NULL) == TRUE);
+
+	server_addr = p_socket_get_local_address (server, NULL);
+	P_TEST_REQUIRE (server_addr != NULL);
+
+	/* Accept and connect at the same time */
+	P_TEST_CHECK (p_async_io_accept (aio, server, (ppointer) "accept", NULL) == TRUE);
+	P_TEST_CHECK (p_async_io_connect (aio, client, server_addr, (ppointer) "connect", NULL) == TRUE);
+	P_TEST_CHECK (p_async_io_get_pending (aio) == 2);
+	P_TEST_CHECK (p_async_io_submit (aio, NULL) == 2);
+
+	P_TEST_REQUIRE (async_io_test_wait (aio, completions, 2) == 2);
+	P_TEST_CHECK (p_async_io_get_pending (aio) == 0);
+
+	completion = async_io_test_find (completions, 2, (ppointer) "accept");
+	P_TEST_REQUIRE (completion != NULL);
+	P_TEST_CHECK (completion->operation == P_ASYNC_IO_OPERATION_ACCEPT);
+	P_TEST_CHECK (completion->result == 0);
+	P_TEST_CHECK (completion->error == P_ERROR_IO_NONE);
+	P_TEST_REQUIRE (completion->socket != NULL);
+
+	accepted = completion->socket;
+
+	completion = async_io_test_find (completions, 2, (ppointer) "connect");
+	P_TEST_REQUIRE (completion != NULL);
+	P_TEST_CHECK (completion->operation == P_ASYNC_IO_OPERATION_CONNECT);
+	P_TEST_CHECK (completion->result == 0);
+	P_TEST_CHECK (completion->error == P_ERROR_IO_NONE);
+	P_TEST_CHECK (completion->socket == NULL);
+
+	/* Receive is queued before the data is sent */
+	memset (recv_buf, 0, sizeof (recv_buf));
+
+	P_TEST_CHECK (p_async_io_receive (aio, accepted, recv_buf, sizeof (recv_buf), (ppointer) "receive", NULL) == TRUE);
+	P_TEST_CHECK (p_async_io_submit (aio, NULL) == 1);
+	P_TEST_CHECK (p_async_io_get_completions (aio, completions, 4, 0, NULL) == 0);
+
+	/* Queued operations are submitted implicitly */
+	P_TEST_CHECK (p_async_io_send (aio, client, send_buf, sizeof (send_buf), (ppointer) "send", NULL) == TRUE);
+	P_TEST_REQUIRE (async_io_test_wait (aio, completions, 2) == 2);
+
+	completion = async_io_test_find (completions, 2, (ppointer) "send");
+	P_TEST_REQUIRE (completion != NULL);
+	P_TEST_CHECK (completion->operation == P_ASYNC_IO_OPERATION_SEND);
+	P_TEST_CHECK (completion->result == (pssize) sizeof (send_buf));
+
+	completion = async_io_test_find (completions, 2, (ppointer) "receive");
+	P_TEST_REQUIRE (completion != NULL);
+	P_TEST_CHECK (completion->operation == P_ASYNC_IO_OPERATION_RECEIVE);
+	P_TEST_CHECK (completion->result == (pssize) sizeof (send_buf));
+	P_TEST_CHECK (strcmp (recv_buf, send_buf) == 0);
+
+	/* Closed connection completes the receive with zero bytes */
+	P_TEST_CHECK (p_async_io_receive (aio, client, recv_buf, sizeof (recv_buf), (ppointer) "eof", NULL) == TRUE);
+	P_TEST_CHECK (p_async_io_submit (aio, NULL) == 1);
+	P_TEST_CHECK (p_socket_shutdown (accepted, FALSE, TRUE, NULL) == TRUE);
+	P_TEST_REQUIRE (async_io_test_wait (aio, completions, 1) == 1);
+
+	P_TEST_CHECK (completions[0].user_data == (ppointer) "eof");
+	P_TEST_CHECK (completions[0].result == 0);
+	P_TEST_CHECK (completions[0].error == P_ERROR_IO_NONE);
+
+	/* Capacity limit */
+	p_async_io_free (aio);
+
+	aio = p_async_io_new (2, backend, NULL);
+	P_TEST_REQUIRE (aio != NULL);
+
+	P_TEST_CHECK (p_async_io_receive (aio, accepted, extra_buf[0], sizeof (extra_buf[0]), NULL, NULL) == TRUE);
+	P_TEST_CHECK (p_async_io_receive (aio, accepted, extra_buf[1], sizeof (extra_buf[1]), NULL, NULL) == TRUE);
+	P_TEST_CHECK (p_async_io_receive (aio, accepted, recv_buf, sizeof (recv_buf), NULL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_WOULD_BLOCK);
+	P_TEST_CHECK (p_async_io_get_pending (aio) == 2);
+
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_async_io_submit (aio, NULL) == 2);
+	P_TEST_CHECK (p_async_io_get_completions (aio, completions, 4, 50, NULL) == 0);
+
+	/* Operations in flight are cancelled */
+	p_async_io_free (aio);
+
+#ifdef P_OS_UNIX
+	pchar	file_buf[16];
+	pint	fd;
+
+	aio = p_async_io_new (4, backend, NULL);
+	P_TEST_REQUIRE (aio != NULL);
+
+	fd = open (PASYNCIO_TEST_FILE, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	P_TEST_REQUIRE (fd >= 0);
+
+	P_TEST_CHECK (p_async_io_write (aio, fd, "0123456789", 10, 0, (ppointer) "write", NULL) == TRUE);
+	P_TEST_REQUIRE (async_io_test_wait (aio, completions, 1) == 1);
+	P_TEST_CHECK (completions[0].operation == P_ASYNC_IO_OPERATION_WRITE);
+	P_TEST_CHECK (completions[0].result == 10);
+
+	P_TEST_CHECK (p_async_io_fsync (aio, fd, (ppointer) "fsync", NULL) == TRUE);
+	P_TEST_CHECK (p_async_io_read (aio, fd, file_buf, 4, 3, (ppointer) "read", NULL) == TRUE);
+	P_TEST_REQUIRE (async_io_test_wait (aio, completions, 2) == 2);
+
+	completion = async_io_test_find (completions, 2, (ppointer) "fsync");
+	P_TEST_REQUIRE (completion != NULL);
+	P_TEST_CHECK (completion->operation == P_ASYNC_IO_OPERATION_FSYNC);
+	P_TEST_CHECK (completion->result == 0);
+
+	completion = async_io_test_find (completions, 2, (ppointer) "read");
+	P_TEST_REQUIRE (completion != NULL);
+	P_TEST_CHECK (completion->operation == P_ASYNC_IO_OPERATION_READ);
+	P_TEST_CHECK (completion->result == 4);
+	P_TEST_CHECK (memcmp (file_buf, "3456", 4) == 0);
+
+	/* Errors are reported with the completion */
+	P_TEST_CHECK (close (fd) == 0);
+	P_TEST_CHECK (p_async_io_read (aio, fd, file_buf, 4, 0, (ppointer) "bad", NULL) == TRUE);
+	P_TEST_REQUIRE (async_io_test_wait (aio, completions, 1) == 1);
+	P_TEST_CHECK (completions[0].result == -1);
+	P_TEST_CHECK (completions[0].error != P_ERROR_IO_NONE);
+	P_TEST_CHECK (completions[0].native_error != 0);
+
+	P_TEST_CHECK (p_file_remove (PASYNCIO_TEST_FILE, NULL) == TRUE);
+
+	p_async_io_free (aio);
+#endif
+
+	p_socket_free (accepted);
+	p_socket_free (client);
+	p_socket_free (server);
+	p_socket_address_free (server_addr);
+	p_socket_address_free (addr);
+}
+
+P_TEST_CASE_BEGIN (pasyncio_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.f_free    = pmem_free;
+	vtable.f_malloc  = pmem_alloc;
+	vtable.f_realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_async_io_new (4, P_ASYNC_IO_BACKEND_DEFAULT, NULL) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pasyncio_bad_input_test)
+{
+	PAsyncIOCompletion	completion;
+	pchar			buf[8];
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_async_io_new (0, P_ASYNC_IO_BACKEND_DEFAULT, NULL) == NULL);
+	P_TEST_CHECK (p_async_io_new (4, (PAsyncIOBackend) -1, NULL) == NULL);
+	P_TEST_CHECK (p_async_io_get_backend (NULL) == P_ASYNC_IO_BACKEND_DEFAULT);
+	P_TEST_CHECK (p_async_io_get_pending (NULL) == 0);
+	P_TEST_CHECK (p_async_io_receive (NULL, NULL, buf, sizeof (buf), NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_async_io_send (NULL, NULL, buf, sizeof (buf), NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_async_io_accept (NULL, NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_async_io_connect (NULL, NULL, NULL, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_async_io_read (NULL, 0, buf, sizeof (buf), 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_async_io_write (NULL, 0, buf, sizeof (buf), 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_async_io_fsync (NULL, 0, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_async_io_submit (NULL, NULL) == -1);
+	P_TEST_CHECK (p_async_io_get_completions (NULL, &completion, 1, 0, NULL) == -1);
+
+	p_async_io_free (NULL);
+
+	PAsyncIO *aio = p_async_io_new (4, P_ASYNC_IO_BACKEND_DEFAULT, NULL);
+
+	if (aio != NULL) {
+		PError *error = NULL;
+
+		P_TEST_CHECK (p_async_io_receive (aio, NULL, buf, sizeof (buf), NULL, &error) == FALSE);
+		P_TEST_CHECK (error != NULL);
+		P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+
+		p_error_free (error);
+
+		P_TEST_CHECK (p_async_io_read (aio, -1, buf, sizeof (buf), 0, NULL, NULL) == FALSE);
+		P_TEST_CHECK (p_async_io_write (aio, 0, buf, 0, 0, NULL, NULL) == FALSE);
+		P_TEST_CHECK (p_async_io_get_completions (aio, NULL, 1, 0, NULL) == -1);
+		P_TEST_CHECK (p_async_io_get_completions (aio, &completion, 0, 0, NULL) == -1);
+		P_TEST_CHECK (p_async_io_get_completions (aio, &completion, 1, -2, NULL) == -1);
+		P_TEST_CHECK (p_async_io_get_pending (aio) == 0);
+
+		p_async_io_free (aio);
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pasyncio_general_test)
+{
+	p_libsys_init ();
+
+	async_io_test_backend (P_ASYNC_IO_BACKEND_IO_URING);
+	async_io_test_backend (P_ASYNC_IO_BACKEND_THREAD);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pasyncio_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pasyncio_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pasyncio_general_test);
+}
+P_TEST_SUITE_END()
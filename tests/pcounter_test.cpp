@@ -0,0 +1,256 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PCOUNTER_THREAD_VALUES	10000
+#define PCOUNTER_THREADS	4
+
+static PCounter * global_sum   = NULL;
+static PCounter * global_gauge = NULL;
+static PCounter * global_max   = NULL;
+static PCounter * global_min   = NULL;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * counter_test_thread (void *data)
+{
+	pssize base = (pssize) (psize) data;
+
+	for (pint i = 1; i <= PCOUNTER_THREAD_VALUES; ++i) {
+		p_counter_inc (global_sum);
+		p_counter_inc (global_gauge);
+		p_counter_add (global_max, base + i);
+		p_counter_add (global_min, base - i);
+		p_counter_dec (global_gauge);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pcounter_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.f_free    = pmem_free;
+	vtable.f_malloc  = pmem_alloc;
+	vtable.f_realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_counter_new (P_COUNTER_TYPE_SUM) == NULL);
+	P_TEST_CHECK (p_counter_new (P_COUNTER_TYPE_MAX) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcounter_bad_input_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_counter_new ((PCounterType) -1) == NULL);
+	P_TEST_CHECK (p_counter_new ((PCounterType) 3) == NULL);
+	P_TEST_CHECK (p_counter_get (NULL) == 0);
+	P_TEST_CHECK (p_counter_get_and_reset (NULL) == 0);
+	P_TEST_CHECK (p_counter_get_type (NULL) == P_COUNTER_TYPE_SUM);
+
+	p_counter_add (NULL, 10);
+	p_counter_inc (NULL);
+	p_counter_dec (NULL);
+	p_counter_reset (NULL);
+	p_counter_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcounter_general_test)
+{
+	PCounter *sum;
+	PCounter *max;
+	PCounter *min;
+
+	p_libsys_init ();
+
+	sum = p_counter_new (P_COUNTER_TYPE_SUM);
+	P_TEST_REQUIRE (sum != NULL);
+
+	max = p_counter_new (P_COUNTER_TYPE_MAX);
+	P_TEST_REQUIRE (max != NULL);
+
+	min = p_counter_new (P_COUNTER_TYPE_MIN);
+	P_TEST_REQUIRE (min != NULL);
+
+	P_TEST_CHECK (p_counter_get_type (sum) == P_COUNTER_TYPE_SUM);
+	P_TEST_CHECK (p_counter_get_type (max) == P_COUNTER_TYPE_MAX);
+	P_TEST_CHECK (p_counter_get_type (min) == P_COUNTER_TYPE_MIN);
+
+	/* Initial values */
+	P_TEST_CHECK (p_counter_get (sum) == 0);
+	P_TEST_CHECK (p_counter_get (max) == P_MINSSIZE);
+	P_TEST_CHECK (p_counter_get (min) == P_MAXSSIZE);
+
+	/* Sum counter and gauge */
+	p_counter_inc (sum);
+	p_counter_inc (sum);
+	p_counter_add (sum, 40);
+	P_TEST_CHECK (p_counter_get (sum) == 42);
+
+	p_counter_dec (sum);
+	p_counter_add (sum, -50);
+	P_TEST_CHECK (p_counter_get (sum) == -9);
+
+	P_TEST_CHECK (p_counter_get_and_reset (sum) == -9);
+	P_TEST_CHECK (p_counter_get (sum) == 0);
+
+	p_counter_add (sum, 100);
+	p_counter_reset (sum);
+	P_TEST_CHECK (p_counter_get (sum) == 0);
+
+	/* Max tracker */
+	p_counter_add (max, 10);
+	p_counter_add (max, -5);
+	p_counter_add (max, 7);
+	P_TEST_CHECK (p_counter_get (max) == 10);
+
+	p_counter_inc (max);
+	P_TEST_CHECK (p_counter_get (max) == 10);
+
+	p_counter_add (max, 25);
+	P_TEST_CHECK (p_counter_get_and_reset (max) == 25);
+	P_TEST_CHECK (p_counter_get (max) == P_MINSSIZE);
+
+	p_counter_add (max, -3);
+	P_TEST_CHECK (p_counter_get (max) == -3);
+
+	p_counter_reset (max);
+	P_TEST_CHECK (p_counter_get (max) == P_MINSSIZE);
+
+	/* Min tracker */
+	p_counter_add (min, 10);
+	p_counter_add (min, -5);
+	p_counter_add (min, 7);
+	P_TEST_CHECK (p_counter_get (min) == -5);
+
+	p_counter_dec (min);
+	P_TEST_CHECK (p_counter_get (min) == -5);
+
+	p_counter_add (min, -25);
+	P_TEST_CHECK (p_counter_get_and_reset (min) == -25);
+	P_TEST_CHECK (p_counter_get (min) == P_MAXSSIZE);
+
+	p_counter_add (min, 3);
+	P_TEST_CHECK (p_counter_get (min) == 3);
+
+	p_counter_reset (min);
+	P_TEST_CHECK (p_counter_get (min) == P_MAXSSIZE);
+
+	p_counter_free (sum);
+	p_counter_free (max);
+	p_counter_free (min);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pcounter_thread_test)
+{
+	PUThread *threads[PCOUNTER_THREADS];
+
+	p_libsys_init ();
+
+	global_sum   = p_counter_new (P_COUNTER_TYPE_SUM);
+	global_gauge = p_counter_new (P_COUNTER_TYPE_SUM);
+	global_max   = p_counter_new (P_COUNTER_TYPE_MAX);
+	global_min   = p_counter_new (P_COUNTER_TYPE_MIN);
+
+	P_TEST_REQUIRE (global_sum != NULL);
+	P_TEST_REQUIRE (global_gauge != NULL);
+	P_TEST_REQUIRE (global_max != NULL);
+	P_TEST_REQUIRE (global_min != NULL);
+
+	for (pint i = 0; i < PCOUNTER_THREADS; ++i) {
+		threads[i] = p_uthread_create ((PUThreadFunc) counter_test_thread,
+					       (ppointer) (psize) (i * PCOUNTER_THREAD_VALUES),
+					       TRUE,
+					       NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	for (pint i = 0; i < PCOUNTER_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (threads[i]) == 0);
+		p_uthread_unref (threads[i]);
+	}
+
+	P_TEST_CHECK (p_counter_get (global_sum) == PCOUNTER_THREADS * PCOUNTER_THREAD_VALUES);
+	P_TEST_CHECK (p_counter_get (global_gauge) == 0);
+	P_TEST_CHECK (p_counter_get (global_max) == PCOUNTER_THREADS * PCOUNTER_THREAD_VALUES);
+	P_TEST_CHECK (p_counter_get (global_min) == -PCOUNTER_THREAD_VALUES);
+
+	P_TEST_CHECK (p_counter_get_and_reset (global_sum) == PCOUNTER_THREADS * PCOUNTER_THREAD_VALUES);
+	P_TEST_CHECK (p_counter_get (global_sum) == 0);
+
+	p_counter_free (global_sum);
+	p_counter_free (global_gauge);
+	p_counter_free (global_max);
+	p_counter_free (global_min);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pcounter_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pcounter_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pcounter_general_test);
+	P_TEST_SUITE_RUN_CASE (pcounter_thread_test);
+}
+P_TEST_SUITE_END()
@@ -33,6 +33,10 @@ P_TEST_MODULE_INIT ();
 #define PERROR_TEST_MESSAGE	"PError test error message"
 #define PERROR_TEST_MESSAGE_2	"Another PError test error message"
 
+/* Static messages are checked by identity, so keep them in a single object */
+static const pchar perror_test_msg[]   = PERROR_TEST_MESSAGE;
+static const pchar perror_test_msg_2[] = PERROR_TEST_MESSAGE_2;
+
 extern "C" ppointer pmem_alloc (psize nbytes)
 {
 	P_UNUSED (nbytes);
@@ -69,6 +73,22 @@ P_TEST_CASE_BEGIN (perror_nomem_test)
 	P_TEST_CHECK (p_error_new () == NULL);
 	P_TEST_CHECK (p_error_new_literal (0, 0, NULL) == NULL);
 	P_TEST_CHECK (p_error_copy (error) == NULL);
+	P_TEST_CHECK (p_error_new_static (0, 0, perror_test_msg) == NULL);
+
+	/* Errors in the caller storage with static messages need no memory */
+	PErrorStorage	storage;
+	PError		*st_error = p_error_init (&storage);
+
+	P_TEST_CHECK (st_error != NULL);
+
+	p_error_set_error_static_p (&st_error, 10, -10, perror_test_msg);
+
+	P_TEST_CHECK (st_error == (PError *) &storage);
+	P_TEST_CHECK (p_error_get_code (st_error) == 10);
+	P_TEST_CHECK (p_error_get_native_code (st_error) == -10);
+	P_TEST_CHECK (p_error_get_message (st_error) == perror_test_msg);
+
+	p_error_free (st_error);
 
 	p_mem_restore_vtable ();
 
@@ -100,6 +120,10 @@ P_TEST_CASE_BEGIN (perror_invalid_test)
 	p_error_set_error_p (&error, 0, 0, NULL);
 	P_TEST_CHECK (error == (PError *) 0x1);
 
+	p_error_set_error_static_p (NULL, 0, 0, NULL);
+
+	P_TEST_CHECK (p_error_init (NULL) == NULL);
+
 	p_error_clear (NULL);
 	p_error_free (NULL);
 
@@ -227,10 +251,135 @@ P_TEST_CASE_BEGIN (perror_general_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (perror_static_test)
+{
+	PErrorStorage	storage;
+	PError		*error;
+	PError		*copy_error;
+
+	p_libsys_init ();
+
+	/* Static message is not copied */
+	error = p_error_new_static (10, -10, perror_test_msg);
+
+	P_TEST_REQUIRE (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == 10);
+	P_TEST_CHECK (p_error_get_native_code (error) == -10);
+	P_TEST_CHECK (p_error_get_message (error) == perror_test_msg);
+
+	copy_error = p_error_copy (error);
+
+	P_TEST_REQUIRE (copy_error != NULL);
+	P_TEST_CHECK (p_error_get_code (copy_error) == 10);
+	P_TEST_CHECK (p_error_get_message (copy_error) == perror_test_msg);
+
+	p_error_free (copy_error);
+
+	/* Changing the message makes a copy */
+	p_error_set_message (error, perror_test_msg_2);
+
+	P_TEST_CHECK (p_error_get_message (error) != perror_test_msg_2);
+	P_TEST_CHECK (strcmp (p_error_get_message (error), PERROR_TEST_MESSAGE_2) == 0);
+
+	p_error_free (error);
+
+	error = NULL;
+	p_error_set_error_static_p (&error, 20, -20, perror_test_msg);
+
+	P_TEST_REQUIRE (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == 20);
+	P_TEST_CHECK (p_error_get_message (error) == perror_test_msg);
+
+	p_error_free (error);
+
+	/* Already reported error is not a caller storage, it stays untouched */
+	error = p_error_new ();
+
+	P_TEST_REQUIRE (error != NULL);
+
+	copy_error = error;
+	p_error_set_error_static_p (&error, 25, -25, perror_test_msg);
+
+	P_TEST_CHECK (error == copy_error);
+	P_TEST_CHECK (p_error_get_code (error) == 0);
+	P_TEST_CHECK (p_error_get_message (error) == NULL);
+
+	p_error_free (error);
+
+	/* Caller storage */
+	error = p_error_init (&storage);
+
+	P_TEST_REQUIRE (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == 0);
+	P_TEST_CHECK (p_error_get_native_code (error) == 0);
+	P_TEST_CHECK (p_error_get_message (error) == NULL);
+
+	p_error_set_error_static_p (&error, 30, -30, perror_test_msg);
+
+	P_TEST_CHECK (error == (PError *) &storage);
+	P_TEST_CHECK (p_error_get_code (error) == 30);
+	P_TEST_CHECK (p_error_get_native_code (error) == -30);
+	P_TEST_CHECK (p_error_get_domain (error) == P_ERROR_DOMAIN_NONE);
+	P_TEST_CHECK (p_error_get_message (error) == perror_test_msg);
+
+	/* The first error is kept, the non-static setter never fills in place */
+	p_error_set_error_static_p (&error, 40, -40, perror_test_msg_2);
+	p_error_set_error_p (&error, 40, -40, PERROR_TEST_MESSAGE_2);
+
+	P_TEST_CHECK (error == (PError *) &storage);
+	P_TEST_CHECK (p_error_get_code (error) == 30);
+	P_TEST_CHECK (p_error_get_message (error) == perror_test_msg);
+
+	copy_error = p_error_copy (error);
+
+	P_TEST_REQUIRE (copy_error != NULL);
+	P_TEST_CHECK (copy_error != error);
+	P_TEST_CHECK (p_error_get_code (copy_error) == 30);
+	P_TEST_CHECK (p_error_get_message (copy_error) == perror_test_msg);
+
+	p_error_free (copy_error);
+
+	/* Cleared storage can be reused */
+	p_error_clear (error);
+
+	P_TEST_CHECK (p_error_get_code (error) == 0);
+	P_TEST_CHECK (p_error_get_message (error) == NULL);
+
+	p_error_set_error_p (&error, (pint) P_ERROR_DOMAIN_IO, -50, perror_test_msg_2);
+
+	P_TEST_CHECK (error == (PError *) &storage);
+	P_TEST_CHECK (p_error_get_code (error) == 0);
+	P_TEST_CHECK (p_error_get_message (error) == NULL);
+
+	p_error_set_error_static_p (&error, (pint) P_ERROR_DOMAIN_IO, -50, perror_test_msg_2);
+
+	P_TEST_CHECK (error == (PError *) &storage);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_DOMAIN_IO);
+	P_TEST_CHECK (p_error_get_domain (error) == P_ERROR_DOMAIN_IO);
+	P_TEST_CHECK (p_error_get_message (error) == perror_test_msg_2);
+
+	/* Freeing only empties the storage */
+	p_error_free (error);
+
+	P_TEST_CHECK (p_error_get_code (error) == 0);
+	P_TEST_CHECK (p_error_get_message (error) == NULL);
+
+	p_error_set_error (error, 60, -60, PERROR_TEST_MESSAGE);
+
+	P_TEST_CHECK (p_error_get_code (error) == 60);
+	P_TEST_CHECK (strcmp (p_error_get_message (error), PERROR_TEST_MESSAGE) == 0);
+
+	p_error_free (error);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (perror_nomem_test);
 	P_TEST_SUITE_RUN_CASE (perror_invalid_test);
 	P_TEST_SUITE_RUN_CASE (perror_general_test);
+	P_TEST_SUITE_RUN_CASE (perror_static_test);
 }
 P_TEST_SUITE_END()
@@ -27,10 +27,58 @@
 #include "ptestmacros.h"
 
 #include <stdio.h>
+#include <string.h>
 
 P_TEST_MODULE_INIT ();
 
 #define PFILE_TEST_FILE "." P_DIR_SEPARATOR "pfile_test_file.txt"
+#define PFILE_MAP_TEST_FILE "." P_DIR_SEPARATOR "pfile_map_test_file.bin"
+#define PFILE_MAP_TEST_SIZE (256 * 1024 + 123)
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static bool create_map_test_file (psize size)
+{
+	FILE *file = fopen (PFILE_MAP_TEST_FILE, "wb");
+
+	if (file == NULL)
+		return false;
+
+	for (psize i = 0; i < size; ++i) {
+		if (fputc ((int) (i % 251), file) == EOF) {
+			fclose (file);
+			return false;
+		}
+	}
+
+	return fclose (file) == 0;
+}
+
+static bool check_map_test_data (const puchar *data, psize offset, psize size)
+{
+	for (psize i = 0; i < size; ++i) {
+		if (data[i] != (puchar) ((offset + i) % 251))
+			return false;
+	}
+
+	return true;
+}
 
 P_TEST_CASE_BEGIN (pfile_general_test)
 {
@@ -54,8 +102,207 @@ P_TEST_CASE_BEGIN (pfile_general_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (pfile_mapped_nomem_test)
+{
+	p_libsys_init ();
+
+	P_TEST_REQUIRE (create_map_test_file (1024));
+
+	PMemVTable vtable;
+
+	vtable.f_free    = pmem_free;
+	vtable.f_malloc  = pmem_alloc;
+	vtable.f_realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_mapped_file_new (PFILE_MAP_TEST_FILE, P_MAPPED_FILE_MODE_READ_ONLY, NULL) == NULL);
+
+	p_mem_restore_vtable ();
+
+	P_TEST_CHECK (p_file_remove (PFILE_MAP_TEST_FILE, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfile_mapped_bad_input_test)
+{
+	p_libsys_init ();
+
+	PError *error = NULL;
+
+	P_TEST_CHECK (p_mapped_file_new (NULL, P_MAPPED_FILE_MODE_READ_ONLY, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_mapped_file_new_range (NULL, P_MAPPED_FILE_MODE_READ_ONLY, 0, 0, NULL) == NULL);
+	P_TEST_CHECK (p_mapped_file_new (PFILE_MAP_TEST_FILE, (PMappedFileMode) 10, NULL) == NULL);
+
+	P_TEST_CHECK (p_mapped_file_new ("." P_DIR_SEPARATOR "pfile_map_test_not_exists.bin",
+					 P_MAPPED_FILE_MODE_READ_ONLY,
+					 &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_mapped_file_get_address (NULL) == NULL);
+	P_TEST_CHECK (p_mapped_file_get_size (NULL) == 0);
+	P_TEST_CHECK (p_mapped_file_advise (NULL, P_MAPPED_FILE_ADVICE_NORMAL, 0, 0, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_mapped_file_sync (NULL, 0, 0, FALSE, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+
+	p_mapped_file_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pfile_mapped_general_test)
+{
+	p_libsys_init ();
+
+	P_TEST_REQUIRE (create_map_test_file (PFILE_MAP_TEST_SIZE));
+
+	/* Whole file */
+	PMappedFile *map = p_mapped_file_new (PFILE_MAP_TEST_FILE, P_MAPPED_FILE_MODE_READ_ONLY, NULL);
+
+	P_TEST_REQUIRE (map != NULL);
+	P_TEST_CHECK (p_mapped_file_get_size (map) == PFILE_MAP_TEST_SIZE);
+	P_TEST_REQUIRE (p_mapped_file_get_address (map) != NULL);
+
+	P_TEST_CHECK (p_mapped_file_advise (map, P_MAPPED_FILE_ADVICE_SEQUENTIAL, 0, 0, NULL) == TRUE);
+	P_TEST_CHECK (p_mapped_file_advise (map, P_MAPPED_FILE_ADVICE_WILL_NEED, 100, 5000, NULL) == TRUE);
+	P_TEST_CHECK (p_mapped_file_advise (map, P_MAPPED_FILE_ADVICE_RANDOM, 0, PFILE_MAP_TEST_SIZE, NULL) == TRUE);
+	P_TEST_CHECK (p_mapped_file_advise (map, P_MAPPED_FILE_ADVICE_NORMAL, 0, 0, NULL) == TRUE);
+	P_TEST_CHECK (p_mapped_file_advise (map, P_MAPPED_FILE_ADVICE_NORMAL, 1, PFILE_MAP_TEST_SIZE, NULL) == FALSE);
+	P_TEST_CHECK (p_mapped_file_advise (map, (PMappedFileAdvice) 10, 0, 0, NULL) == FALSE);
+
+	P_TEST_CHECK (check_map_test_data ((const puchar *) p_mapped_file_get_address (map),
+					   0,
+					   PFILE_MAP_TEST_SIZE));
+
+	/* Nothing to sync for read-only mapping */
+	P_TEST_CHECK (p_mapped_file_sync (map, 0, 0, FALSE, NULL) == TRUE);
+
+	p_mapped_file_free (map);
+
+	/* Unaligned range */
+	map = p_mapped_file_new_range (PFILE_MAP_TEST_FILE, P_MAPPED_FILE_MODE_READ_ONLY, 70001, 1000, NULL);
+
+	P_TEST_REQUIRE (map != NULL);
+	P_TEST_CHECK (p_mapped_file_get_size (map) == 1000);
+	P_TEST_CHECK (check_map_test_data ((const puchar *) p_mapped_file_get_address (map), 70001, 1000));
+	P_TEST_CHECK (p_mapped_file_advise (map, P_MAPPED_FILE_ADVICE_DONT_NEED, 10, 0, NULL) == TRUE);
+
+	p_mapped_file_free (map);
+
+	/* Range up to the end of the file */
+	map = p_mapped_file_new_range (PFILE_MAP_TEST_FILE, P_MAPPED_FILE_MODE_READ_ONLY, 200000, 0, NULL);
+
+	P_TEST_REQUIRE (map != NULL);
+	P_TEST_CHECK (p_mapped_file_get_size (map) == PFILE_MAP_TEST_SIZE - 200000);
+	P_TEST_CHECK (check_map_test_data ((const puchar *) p_mapped_file_get_address (map),
+					   200000,
+					   PFILE_MAP_TEST_SIZE - 200000));
+
+	p_mapped_file_free (map);
+
+	/* Out of bounds */
+	PError *error = NULL;
+
+	P_TEST_CHECK (p_mapped_file_new_range (PFILE_MAP_TEST_FILE,
+					       P_MAPPED_FILE_MODE_READ_ONLY,
+					       PFILE_MAP_TEST_SIZE + 1,
+					       0,
+					       &error) == NULL);
+	P_TEST_CHECK (error != NULL && p_error_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+	p_error_free (error);
+
+	P_TEST_CHECK (p_mapped_file_new_range (PFILE_MAP_TEST_FILE,
+					       P_MAPPED_FILE_MODE_READ_ONLY,
+					       100,
+					       PFILE_MAP_TEST_SIZE,
+					       NULL) == NULL);
+
+	/* Copy-on-write changes don't reach the file */
+	map = p_mapped_file_new (PFILE_MAP_TEST_FILE, P_MAPPED_FILE_MODE_COPY_ON_WRITE, NULL);
+
+	P_TEST_REQUIRE (map != NULL);
+
+	puchar *data = (puchar *) p_mapped_file_get_address (map);
+	memset (data, 0xFF, 4096);
+
+	P_TEST_CHECK (p_mapped_file_sync (map, 0, 0, FALSE, NULL) == TRUE);
+
+	p_mapped_file_free (map);
+
+	map = p_mapped_file_new (PFILE_MAP_TEST_FILE, P_MAPPED_FILE_MODE_READ_ONLY, NULL);
+
+	P_TEST_REQUIRE (map != NULL);
+	P_TEST_CHECK (check_map_test_data ((const puchar *) p_mapped_file_get_address (map), 0, 4096));
+
+	p_mapped_file_free (map);
+
+	/* Read-write changes do */
+	map = p_mapped_file_new_range (PFILE_MAP_TEST_FILE, P_MAPPED_FILE_MODE_READ_WRITE, 5000, 100, NULL);
+
+	P_TEST_REQUIRE (map != NULL);
+
+	data = (puchar *) p_mapped_file_get_address (map);
+	memset (data, 0xAB, 100);
+
+	P_TEST_CHECK (p_mapped_file_sync (map, 10, 50, TRUE, NULL) == TRUE);
+	P_TEST_CHECK (p_mapped_file_sync (map, 0, 0, FALSE, NULL) == TRUE);
+	P_TEST_CHECK (p_mapped_file_sync (map, 0, 101, FALSE, NULL) == FALSE);
+
+	p_mapped_file_free (map);
+
+	FILE *file = fopen (PFILE_MAP_TEST_FILE, "rb");
+	P_TEST_REQUIRE (file != NULL);
+
+	puchar buf[102];
+
+	P_TEST_CHECK (fseek (file, 4999, SEEK_SET) == 0);
+	P_TEST_CHECK (fread (buf, 1, sizeof (buf), file) == sizeof (buf));
+	P_TEST_CHECK (fclose (file) == 0);
+
+	P_TEST_CHECK (check_map_test_data (buf, 4999, 1));
+	P_TEST_CHECK (check_map_test_data (buf + 101, 5100, 1));
+
+	for (pint i = 1; i < 101; ++i)
+		P_TEST_CHECK (buf[i] == 0xAB);
+
+	P_TEST_CHECK (p_file_remove (PFILE_MAP_TEST_FILE, NULL) == TRUE);
+
+	/* Empty file */
+	P_TEST_REQUIRE (create_map_test_file (0));
+
+	map = p_mapped_file_new (PFILE_MAP_TEST_FILE, P_MAPPED_FILE_MODE_READ_ONLY, NULL);
+
+	P_TEST_REQUIRE (map != NULL);
+	P_TEST_CHECK (p_mapped_file_get_address (map) == NULL);
+	P_TEST_CHECK (p_mapped_file_get_size (map) == 0);
+	P_TEST_CHECK (p_mapped_file_sync (map, 0, 0, FALSE, NULL) == TRUE);
+
+	p_mapped_file_free (map);
+
+	P_TEST_CHECK (p_file_remove (PFILE_MAP_TEST_FILE, NULL) == TRUE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (pfile_general_test);
+	P_TEST_SUITE_RUN_CASE (pfile_mapped_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pfile_mapped_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (pfile_mapped_general_test);
 }
 P_TEST_SUITE_END()
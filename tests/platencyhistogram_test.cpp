@@ -0,0 +1,254 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PLATENCYHISTOGRAM_THREAD_VALUES 10000
+
+static PLatencyHistogram * global_hist = NULL;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static bool check_precision (puint64 expected, puint64 value, pint precision)
+{
+	puint64 error = expected >> (precision - 1);
+
+	return value + error >= expected && value <= expected + error;
+}
+
+static void * latency_histogram_test_thread (void *)
+{
+	for (pint i = 1; i <= PLATENCYHISTOGRAM_THREAD_VALUES; ++i)
+		p_latency_histogram_record (global_hist, (puint64) i);
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (platencyhistogram_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.f_free    = pmem_free;
+	vtable.f_malloc  = pmem_alloc;
+	vtable.f_realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_latency_histogram_new (7) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (platencyhistogram_bad_input_test)
+{
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_latency_histogram_new (P_LATENCY_HISTOGRAM_MIN_PRECISION - 1) == NULL);
+	P_TEST_CHECK (p_latency_histogram_new (P_LATENCY_HISTOGRAM_MAX_PRECISION + 1) == NULL);
+	P_TEST_CHECK (p_latency_histogram_snapshot (NULL) == NULL);
+	P_TEST_CHECK (p_latency_histogram_merge (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_latency_histogram_get_precision (NULL) == 0);
+	P_TEST_CHECK (p_latency_histogram_get_count (NULL) == 0);
+	P_TEST_CHECK (p_latency_histogram_get_min (NULL) == 0);
+	P_TEST_CHECK (p_latency_histogram_get_max (NULL) == 0);
+	P_TEST_CHECK (p_latency_histogram_get_mean (NULL) == 0);
+	P_TEST_CHECK (p_latency_histogram_get_percentile (NULL, 50.0) == 0);
+
+	p_latency_histogram_record (NULL, 0);
+	p_latency_histogram_record_ticks (NULL, 0);
+	p_latency_histogram_record_profiler (NULL, NULL);
+	p_latency_histogram_reset (NULL);
+	p_latency_histogram_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (platencyhistogram_general_test)
+{
+	PLatencyHistogram	*hist;
+	PLatencyHistogram	*snapshot;
+	PLatencyHistogram	*other_hist;
+	PTimeProfiler		*profiler;
+
+	p_libsys_init ();
+
+	hist = p_latency_histogram_new (7);
+	P_TEST_REQUIRE (hist != NULL);
+
+	P_TEST_CHECK (p_latency_histogram_get_precision (hist) == 7);
+	P_TEST_CHECK (p_latency_histogram_get_count (hist) == 0);
+	P_TEST_CHECK (p_latency_histogram_get_min (hist) == 0);
+	P_TEST_CHECK (p_latency_histogram_get_max (hist) == 0);
+	P_TEST_CHECK (p_latency_histogram_get_mean (hist) == 0);
+	P_TEST_CHECK (p_latency_histogram_get_percentile (hist, 50.0) == 0);
+
+	/* Small values are stored exactly */
+	for (pint i = 1; i <= 100; ++i)
+		p_latency_histogram_record (hist, (puint64) i);
+
+	P_TEST_CHECK (p_latency_histogram_get_count (hist) == 100);
+	P_TEST_CHECK (p_latency_histogram_get_min (hist) == 1);
+	P_TEST_CHECK (p_latency_histogram_get_max (hist) == 100);
+	P_TEST_CHECK (p_latency_histogram_get_percentile (hist, 0.0) == 1);
+	P_TEST_CHECK (p_latency_histogram_get_percentile (hist, 50.0) == 50);
+	P_TEST_CHECK (p_latency_histogram_get_percentile (hist, 99.0) == 99);
+	P_TEST_CHECK (p_latency_histogram_get_percentile (hist, 100.0) == 100);
+	P_TEST_CHECK (p_latency_histogram_get_mean (hist) == 51);
+
+	p_latency_histogram_reset (hist);
+	P_TEST_CHECK (p_latency_histogram_get_count (hist) == 0);
+
+	/* Large values are stored with the given precision */
+	for (pint i = 1; i <= 1000; ++i)
+		p_latency_histogram_record (hist, (puint64) i * 1000000ULL);
+
+	P_TEST_CHECK (p_latency_histogram_get_count (hist) == 1000);
+	P_TEST_CHECK (check_precision (1000000ULL, p_latency_histogram_get_min (hist), 7));
+	P_TEST_CHECK (check_precision (1000000000ULL, p_latency_histogram_get_max (hist), 7));
+	P_TEST_CHECK (check_precision (500000000ULL, p_latency_histogram_get_percentile (hist, 50.0), 7));
+	P_TEST_CHECK (check_precision (990000000ULL, p_latency_histogram_get_percentile (hist, 99.0), 7));
+	P_TEST_CHECK (check_precision (999000000ULL, p_latency_histogram_get_percentile (hist, 99.9), 7));
+	P_TEST_CHECK (check_precision (500500000ULL, p_latency_histogram_get_mean (hist), 7));
+
+	p_latency_histogram_record (hist, P_MAXUINT64);
+	P_TEST_CHECK (p_latency_histogram_get_max (hist) == P_MAXUINT64);
+
+	/* Snapshot and merge */
+	snapshot = p_latency_histogram_snapshot (hist);
+	P_TEST_REQUIRE (snapshot != NULL);
+
+	P_TEST_CHECK (p_latency_histogram_get_precision (snapshot) == 7);
+	P_TEST_CHECK (p_latency_histogram_get_count (snapshot) == 1001);
+	P_TEST_CHECK (p_latency_histogram_get_min (snapshot) == p_latency_histogram_get_min (hist));
+	P_TEST_CHECK (p_latency_histogram_get_percentile (snapshot, 50.0) ==
+		      p_latency_histogram_get_percentile (hist, 50.0));
+
+	P_TEST_CHECK (p_latency_histogram_merge (snapshot, hist) == TRUE);
+	P_TEST_CHECK (p_latency_histogram_get_count (snapshot) == 2002);
+	P_TEST_CHECK (p_latency_histogram_get_count (hist) == 1001);
+
+	other_hist = p_latency_histogram_new (5);
+	P_TEST_REQUIRE (other_hist != NULL);
+
+	P_TEST_CHECK (p_latency_histogram_merge (other_hist, hist) == FALSE);
+	P_TEST_CHECK (p_latency_histogram_get_count (other_hist) == 0);
+
+	/* Profiler recording */
+	p_latency_histogram_reset (hist);
+
+	profiler = p_time_profiler_new ();
+	P_TEST_REQUIRE (profiler != NULL);
+
+	p_uthread_sleep (10);
+	p_latency_histogram_record_profiler (hist, profiler);
+
+	P_TEST_CHECK (p_latency_histogram_get_count (hist) == 1);
+	P_TEST_CHECK (p_latency_histogram_get_min (hist) >= 9000000ULL);
+
+	p_latency_histogram_reset (hist);
+
+	puint64 start_ticks = p_time_profiler_ticks ();
+	p_uthread_sleep (10);
+	p_latency_histogram_record_ticks (hist, p_time_profiler_ticks () - start_ticks);
+
+	P_TEST_CHECK (p_latency_histogram_get_count (hist) == 1);
+	P_TEST_CHECK (p_latency_histogram_get_max (hist) >= 9000000ULL);
+
+	p_time_profiler_free (profiler);
+	p_latency_histogram_free (other_hist);
+	p_latency_histogram_free (snapshot);
+	p_latency_histogram_free (hist);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (platencyhistogram_thread_test)
+{
+	PUThread *thr1;
+	PUThread *thr2;
+
+	p_libsys_init ();
+
+	global_hist = p_latency_histogram_new (P_LATENCY_HISTOGRAM_MAX_PRECISION);
+	P_TEST_REQUIRE (global_hist != NULL);
+
+	thr1 = p_uthread_create ((PUThreadFunc) latency_histogram_test_thread, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thr1 != NULL);
+
+	thr2 = p_uthread_create ((PUThreadFunc) latency_histogram_test_thread, NULL, TRUE, NULL);
+	P_TEST_REQUIRE (thr2 != NULL);
+
+	P_TEST_CHECK (p_uthread_join (thr1) == 0);
+	P_TEST_CHECK (p_uthread_join (thr2) == 0);
+
+	P_TEST_CHECK (p_latency_histogram_get_count (global_hist) == 2 * PLATENCYHISTOGRAM_THREAD_VALUES);
+	P_TEST_CHECK (p_latency_histogram_get_min (global_hist) == 1);
+	P_TEST_CHECK (check_precision (PLATENCYHISTOGRAM_THREAD_VALUES,
+				       p_latency_histogram_get_max (global_hist),
+				       P_LATENCY_HISTOGRAM_MAX_PRECISION));
+
+	p_uthread_unref (thr1);
+	p_uthread_unref (thr2);
+	p_latency_histogram_free (global_hist);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (platencyhistogram_nomem_test);
+	P_TEST_SUITE_RUN_CASE (platencyhistogram_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (platencyhistogram_general_test);
+	P_TEST_SUITE_RUN_CASE (platencyhistogram_thread_test);
+}
+P_TEST_SUITE_END()
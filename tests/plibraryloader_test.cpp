@@ -113,6 +113,7 @@ P_TEST_CASE_BEGIN (plibraryloader_general_test)
 	P_TEST_CHECK (p_library_loader_new ("./unexistent_file.nofile") == NULL);
 	P_TEST_CHECK (p_library_loader_get_symbol (NULL, NULL) == NULL);
 	P_TEST_CHECK (p_library_loader_get_symbol (NULL, "unexistent_symbol") == NULL);
+	P_TEST_CHECK (p_library_loader_bind_symbols (NULL, NULL, 0) == 0);
 
 	p_library_loader_free (NULL);
 
@@ -178,6 +179,41 @@ P_TEST_CASE_BEGIN (plibraryloader_general_test)
 
 	mfree_func (NULL);
 
+	/* Cached lookups must give the same address */
+	P_TEST_CHECK (p_library_loader_get_symbol (loader, "p_free") ==
+		      p_library_loader_get_symbol (loader, "p_free"));
+
+	if (p_library_loader_get_symbol (loader, "p_free") != NULL) {
+		/* Cached lookup must not report an error from a failed one */
+		P_TEST_CHECK (p_library_loader_get_symbol (loader, "there_is_no_such_a_symbol") == (PFuncAddr) NULL);
+		P_TEST_CHECK (p_library_loader_get_symbol (loader, "p_free") != NULL);
+
+		err_msg = p_library_loader_get_last_error (loader);
+		P_TEST_CHECK (err_msg == NULL);
+		p_free (err_msg);
+	}
+
+	if (p_library_loader_get_symbol (loader, "p_free") != NULL) {
+		PFuncAddr	bound_free    = NULL;
+		PFuncAddr	bound_missing = (PFuncAddr) mfree_func;
+		PLibrarySymbol	symbols[3];
+
+		symbols[0].name = "p_free";
+		symbols[0].addr = &bound_free;
+		symbols[1].name = "there_is_no_such_a_symbol";
+		symbols[1].addr = &bound_missing;
+		symbols[2].name = "p_malloc";
+		symbols[2].addr = NULL;
+
+		P_TEST_CHECK (p_library_loader_bind_symbols (loader, NULL, 1) == 0);
+		P_TEST_CHECK (p_library_loader_bind_symbols (loader, symbols, 0) == 0);
+		P_TEST_CHECK (bound_free == NULL);
+
+		P_TEST_CHECK (p_library_loader_bind_symbols (loader, symbols, 3) == 1);
+		P_TEST_CHECK (bound_free == (PFuncAddr) mfree_func);
+		P_TEST_CHECK (bound_missing == NULL);
+	}
+
 	p_library_loader_free (loader);
 	p_libsys_shutdown ();
 }
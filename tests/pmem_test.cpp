@@ -162,9 +162,96 @@ P_TEST_CASE_BEGIN (pmem_general_test)
 }
 P_TEST_CASE_END ()
 
+static bool check_mmap_full (ppointer ptr, psize n_bytes)
+{
+	if (ptr == NULL)
+		return false;
+
+	for (psize i = 0; i < n_bytes; i += 1000)
+		*(((pchar *) ptr) + i) = (pchar) (i % 127);
+
+	for (psize i = 0; i < n_bytes; i += 1000) {
+		if (*(((pchar *) ptr) + i) != (pchar) (i % 127))
+			return false;
+	}
+
+	return true;
+}
+
+P_TEST_CASE_BEGIN (pmem_mmap_full_test)
+{
+	p_libsys_init ();
+
+	PError *error = NULL;
+
+	P_TEST_CHECK (p_mem_mmap_full (0, P_MEM_MAP_FLAG_NONE, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+
+	/* Plain mapping */
+	ppointer ptr = p_mem_mmap_full (1024, P_MEM_MAP_FLAG_NONE, NULL);
+	P_TEST_CHECK (check_mmap_full (ptr, 1024));
+	P_TEST_CHECK (p_mem_munmap (ptr, 1024, NULL) == TRUE);
+
+	/* Pre-faulted and locked, locking may be refused due to limits */
+	ptr = p_mem_mmap_full (64 * 1024, P_MEM_MAP_FLAG_POPULATE | P_MEM_MAP_FLAG_LOCK, NULL);
+	P_TEST_CHECK (check_mmap_full (ptr, 64 * 1024));
+	P_TEST_CHECK (p_mem_munmap (ptr, 64 * 1024, NULL) == TRUE);
+
+	psize huge_size = p_mem_get_huge_page_size ();
+	psize n_bytes   = huge_size > 0 ? huge_size * 2 : 4 * 1024 * 1024;
+
+	/* Huge pages fall back to the regular ones if not available */
+	ptr = p_mem_mmap_full (n_bytes, P_MEM_MAP_FLAG_HUGE_PAGES | P_MEM_MAP_FLAG_POPULATE, NULL);
+	P_TEST_CHECK (check_mmap_full (ptr, n_bytes));
+	P_TEST_CHECK (p_mem_munmap (ptr, n_bytes, NULL) == TRUE);
+
+	ptr = p_mem_mmap_full (n_bytes + 100, P_MEM_MAP_FLAG_TRANSPARENT_HUGE_PAGES, NULL);
+	P_TEST_CHECK (check_mmap_full (ptr, n_bytes + 100));
+
+	if (huge_size > 0)
+		P_TEST_CHECK (((psize) ptr) % huge_size == 0);
+
+	P_TEST_CHECK (p_mem_munmap (ptr, n_bytes + 100, NULL) == TRUE);
+
+	/* Explicit huge pages need a multiple of the huge page size */
+	if (huge_size > 0) {
+		error = NULL;
+		ptr   = p_mem_mmap_full (huge_size + 1,
+					 P_MEM_MAP_FLAG_HUGE_PAGES | P_MEM_MAP_FLAG_STRICT,
+					 &error);
+		P_TEST_CHECK (ptr == NULL);
+		P_TEST_CHECK (error != NULL);
+		p_error_free (error);
+	}
+
+	/* NUMA binding, the first node always exists */
+	ptr = p_mem_mmap_full (n_bytes, P_MEM_MAP_NUMA_NODE (0) | P_MEM_MAP_FLAG_POPULATE, NULL);
+	P_TEST_CHECK (check_mmap_full (ptr, n_bytes));
+	P_TEST_CHECK (p_mem_munmap (ptr, n_bytes, NULL) == TRUE);
+
+	/* Strict mode may fail, but must not leak a mapping */
+	error = NULL;
+	ptr   = p_mem_mmap_full (n_bytes,
+				 P_MEM_MAP_FLAG_HUGE_PAGES | P_MEM_MAP_FLAG_STRICT,
+				 &error);
+
+	if (ptr != NULL) {
+		P_TEST_CHECK (check_mmap_full (ptr, n_bytes));
+		P_TEST_CHECK (p_mem_munmap (ptr, n_bytes, NULL) == TRUE);
+	} else {
+		P_TEST_CHECK (error != NULL);
+		p_error_free (error);
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (pmem_bad_input_test);
 	P_TEST_SUITE_RUN_CASE (pmem_general_test);
+	P_TEST_SUITE_RUN_CASE (pmem_mmap_full_test);
 }
 P_TEST_SUITE_END()
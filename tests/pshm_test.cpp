@@ -94,6 +94,11 @@ P_TEST_CASE_BEGIN (pshm_nomem_test)
 	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
 
 	P_TEST_CHECK (p_shm_new ("p_shm_test_memory_block", 1024, P_SHM_ACCESS_READWRITE, NULL) == NULL);
+	P_TEST_CHECK (p_shm_new_full ("p_shm_test_memory_block",
+				      1024,
+				      P_SHM_ACCESS_READWRITE,
+				      P_SHM_FLAG_POPULATE,
+				      NULL) == NULL);
 
 	p_mem_restore_vtable ();
 
@@ -106,6 +111,7 @@ P_TEST_CASE_BEGIN (pshm_invalid_test)
 	p_libsys_init ();
 
 	P_TEST_CHECK (p_shm_new (NULL, 0, P_SHM_ACCESS_READWRITE, NULL) == NULL);
+	P_TEST_CHECK (p_shm_new_full (NULL, 0, P_SHM_ACCESS_READWRITE, P_SHM_FLAG_LOCK, NULL) == NULL);
 	P_TEST_CHECK (p_shm_lock (NULL, NULL) == FALSE);
 	P_TEST_CHECK (p_shm_unlock (NULL, NULL) == FALSE);
 	P_TEST_CHECK (p_shm_get_address (NULL) == NULL);
@@ -305,11 +311,79 @@ P_TEST_CASE_BEGIN (pshm_thread_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (pshm_flags_test)
+{
+	PShm		*shm;
+	PShm		*shm2;
+	PError		*error = NULL;
+	pchar		*addr;
+	puint		flags;
+
+	p_libsys_init ();
+
+	/* Options are applied on a best-effort basis without the strict flag */
+	flags = P_SHM_FLAG_HUGE_PAGES | P_SHM_FLAG_POPULATE | P_SHM_FLAG_LOCK;
+
+	shm = p_shm_new_full ("p_shm_test_flags_block", 1024 * 1024, P_SHM_ACCESS_READWRITE, flags, NULL);
+	P_TEST_REQUIRE (shm != NULL);
+	p_shm_take_ownership (shm);
+	p_shm_free (shm);
+
+	shm = p_shm_new_full ("p_shm_test_flags_block", 1024 * 1024, P_SHM_ACCESS_READWRITE, flags, NULL);
+	P_TEST_REQUIRE (shm != NULL);
+	P_TEST_CHECK (p_shm_get_size (shm) == 1024 * 1024);
+
+	addr = (pchar *) p_shm_get_address (shm);
+	P_TEST_REQUIRE (addr != NULL);
+
+	for (pint i = 0; i < 1024 * 1024; i += 4096)
+		addr[i] = 'x';
+
+	/* Populating an existing segment must keep its contents */
+	shm2 = p_shm_new_full ("p_shm_test_flags_block",
+			       1024 * 1024,
+			       P_SHM_ACCESS_READWRITE,
+			       flags,
+			       NULL);
+	P_TEST_REQUIRE (shm2 != NULL);
+
+	addr = (pchar *) p_shm_get_address (shm2);
+	P_TEST_REQUIRE (addr != NULL);
+
+	for (pint i = 0; i < 1024 * 1024; i += 4096)
+		P_TEST_CHECK (addr[i] == 'x');
+
+	p_shm_free (shm2);
+	p_shm_take_ownership (shm);
+	p_shm_free (shm);
+
+	/* Strict mode either honors the options or reports an error */
+	shm = p_shm_new_full ("p_shm_test_flags_block",
+			      1024 * 1024,
+			      P_SHM_ACCESS_READWRITE,
+			      P_SHM_FLAG_HUGE_PAGES | P_SHM_FLAG_STRICT,
+			      &error);
+
+	if (shm == NULL) {
+		P_TEST_CHECK (error != NULL);
+		p_error_free (error);
+	} else {
+		P_TEST_CHECK (error == NULL);
+		P_TEST_CHECK (p_shm_get_size (shm) == 1024 * 1024);
+		p_shm_take_ownership (shm);
+		p_shm_free (shm);
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (pshm_nomem_test);
 	P_TEST_SUITE_RUN_CASE (pshm_invalid_test);
 	P_TEST_SUITE_RUN_CASE (pshm_general_test);
+	P_TEST_SUITE_RUN_CASE (pshm_flags_test);
 	P_TEST_SUITE_RUN_CASE (pshm_thread_test);
 }
 P_TEST_SUITE_END()
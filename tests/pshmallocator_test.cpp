@@ -0,0 +1,295 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PSHMALLOCATOR_TEST_BLOCKS	64
+#define PSHMALLOCATOR_TEST_ROUNDS	200
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * shm_allocator_test_thread (void *arg)
+{
+	PShmAllocator	*allocator = (PShmAllocator *) arg;
+	psize		blocks[PSHMALLOCATOR_TEST_BLOCKS];
+	psize		sizes[PSHMALLOCATOR_TEST_BLOCKS];
+	puchar		*addr;
+	puchar		pattern;
+
+	pattern = (puchar) (PPOINTER_TO_PSIZE (p_uthread_current ()) & 0xFF);
+
+	/* Blocks owned by different threads must never overlap */
+	for (pint round = 0; round < PSHMALLOCATOR_TEST_ROUNDS; ++round) {
+		for (pint i = 0; i < PSHMALLOCATOR_TEST_BLOCKS; ++i) {
+			sizes[i]  = (psize) (8 + ((i * 37 + round) % 700));
+			blocks[i] = p_shm_allocator_alloc (allocator, sizes[i], NULL);
+
+			if (blocks[i] == 0)
+				p_uthread_exit (1);
+
+			memset (p_shm_allocator_get_address (allocator, blocks[i]), pattern, sizes[i]);
+		}
+
+		for (pint i = 0; i < PSHMALLOCATOR_TEST_BLOCKS; ++i) {
+			addr = (puchar *) p_shm_allocator_get_address (allocator, blocks[i]);
+
+			for (psize j = 0; j < sizes[i]; ++j)
+				if (addr[j] != pattern)
+					p_uthread_exit (1);
+
+			p_shm_allocator_dealloc (allocator, blocks[i]);
+		}
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pshmallocator_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.f_free    = pmem_free;
+	vtable.f_malloc  = pmem_alloc;
+	vtable.f_realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_shm_allocator_new ("p_shm_allocator_test", 65536, NULL) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pshmallocator_invalid_test)
+{
+	PShmAllocator	*allocator;
+	PError		*error = NULL;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_shm_allocator_new (NULL, 65536, NULL) == NULL);
+	P_TEST_CHECK (p_shm_allocator_alloc (NULL, 16, NULL) == 0);
+	P_TEST_CHECK (p_shm_allocator_get_address (NULL, 16) == NULL);
+	P_TEST_CHECK (p_shm_allocator_get_offset (NULL, &error) == 0);
+	P_TEST_CHECK (p_shm_allocator_get_block_size (NULL, 16) == 0);
+	p_shm_allocator_dealloc (NULL, 16);
+	p_shm_allocator_take_ownership (NULL);
+	p_shm_allocator_free (NULL);
+
+	allocator = p_shm_allocator_new ("p_shm_allocator_small", 16, &error);
+	P_TEST_CHECK (allocator == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	allocator = p_shm_allocator_new ("p_shm_allocator_small", 16, NULL);
+
+	if (allocator != NULL)
+		p_shm_allocator_take_ownership (allocator);
+
+	p_shm_allocator_free (allocator);
+
+	allocator = p_shm_allocator_new ("p_shm_allocator_invalid", 65536, NULL);
+	P_TEST_REQUIRE (allocator != NULL);
+
+	P_TEST_CHECK (p_shm_allocator_alloc (allocator, 0, NULL) == 0);
+	P_TEST_CHECK (p_shm_allocator_alloc (allocator, 1024 * 1024, &error) == 0);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+
+	P_TEST_CHECK (p_shm_allocator_get_address (allocator, 0) == NULL);
+	P_TEST_CHECK (p_shm_allocator_get_address (allocator, 1024 * 1024) == NULL);
+	P_TEST_CHECK (p_shm_allocator_get_offset (allocator, &error) == 0);
+	P_TEST_CHECK (p_shm_allocator_get_block_size (allocator, 0) == 0);
+	P_TEST_CHECK (p_shm_allocator_get_block_size (allocator, 17) == 0);
+
+	/* Releasing foreign offsets is ignored */
+	p_shm_allocator_dealloc (allocator, 0);
+	p_shm_allocator_dealloc (allocator, 1024 * 1024);
+
+	p_shm_allocator_take_ownership (allocator);
+	p_shm_allocator_free (allocator);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pshmallocator_general_test)
+{
+	PShmAllocator	*allocator;
+	PShmAllocator	*allocator2;
+	PError		*error = NULL;
+	psize		small[16];
+	psize		large;
+	psize		large2;
+	psize		offset;
+	pchar		*addr;
+
+	p_libsys_init ();
+
+	allocator = p_shm_allocator_new ("p_shm_allocator_test", 512 * 1024, NULL);
+	P_TEST_REQUIRE (allocator != NULL);
+	p_shm_allocator_take_ownership (allocator);
+	p_shm_allocator_free (allocator);
+
+	allocator = p_shm_allocator_new ("p_shm_allocator_test", 512 * 1024, NULL);
+	P_TEST_REQUIRE (allocator != NULL);
+
+	for (pint i = 0; i < 16; ++i) {
+		small[i] = p_shm_allocator_alloc (allocator, (psize) (i * 100 + 1), NULL);
+		P_TEST_REQUIRE (small[i] != 0);
+		P_TEST_CHECK (small[i] % P_SHM_ALLOCATOR_ALIGNMENT == 0);
+		P_TEST_CHECK (p_shm_allocator_get_block_size (allocator, small[i]) >= (psize) (i * 100 + 1));
+
+		addr = (pchar *) p_shm_allocator_get_address (allocator, small[i]);
+		P_TEST_REQUIRE (addr != NULL);
+		P_TEST_CHECK (p_shm_allocator_get_offset (allocator, addr) == small[i]);
+
+		memset (addr, 'a' + i, (psize) (i * 100 + 1));
+	}
+
+	large = p_shm_allocator_alloc (allocator, 100 * 1024, NULL);
+	P_TEST_REQUIRE (large != 0);
+	P_TEST_CHECK (p_shm_allocator_get_block_size (allocator, large) >= 100 * 1024);
+	memset (p_shm_allocator_get_address (allocator, large), 'z', 100 * 1024);
+
+	/* Another attachment sees the same data by the same offsets */
+	allocator2 = p_shm_allocator_new ("p_shm_allocator_test", 0, NULL);
+	P_TEST_REQUIRE (allocator2 != NULL);
+
+	for (pint i = 0; i < 16; ++i) {
+		addr = (pchar *) p_shm_allocator_get_address (allocator2, small[i]);
+		P_TEST_REQUIRE (addr != NULL);
+		P_TEST_CHECK (addr[0] == 'a' + i && addr[i * 100] == 'a' + i);
+	}
+
+	addr = (pchar *) p_shm_allocator_get_address (allocator2, large);
+	P_TEST_CHECK (addr[0] == 'z' && addr[100 * 1024 - 1] == 'z');
+
+	/* Released blocks are reused, no matter which attachment released them */
+	offset = small[3];
+	p_shm_allocator_dealloc (allocator2, offset);
+	P_TEST_CHECK (p_shm_allocator_alloc (allocator, 301, NULL) == offset);
+
+	p_shm_allocator_dealloc (allocator2, large);
+	large2 = p_shm_allocator_alloc (allocator, 20 * 1024, NULL);
+	P_TEST_CHECK (large2 == large);
+
+	/* The tail of the split block is reused as well */
+	offset = p_shm_allocator_alloc (allocator, 20 * 1024, NULL);
+	P_TEST_CHECK (offset > large2 && offset < large2 + 100 * 1024);
+
+	/* Exhaust the segment */
+	while (p_shm_allocator_alloc (allocator, 8 * 1024, &error) != 0)
+		;
+
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IPC_NO_RESOURCES);
+	p_error_free (error);
+
+	p_shm_allocator_free (allocator2);
+	p_shm_allocator_take_ownership (allocator);
+	p_shm_allocator_free (allocator);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pshmallocator_thread_test)
+{
+	PShmAllocator	*allocator;
+	PUThread	*thr1;
+	PUThread	*thr2;
+	PUThread	*thr3;
+
+	p_libsys_init ();
+
+	allocator = p_shm_allocator_new ("p_shm_allocator_thread", 4 * 1024 * 1024, NULL);
+	P_TEST_REQUIRE (allocator != NULL);
+	p_shm_allocator_take_ownership (allocator);
+	p_shm_allocator_free (allocator);
+
+	allocator = p_shm_allocator_new ("p_shm_allocator_thread", 4 * 1024 * 1024, NULL);
+	P_TEST_REQUIRE (allocator != NULL);
+
+	thr1 = p_uthread_create ((PUThreadFunc) shm_allocator_test_thread, (ppointer) allocator, TRUE, NULL);
+	P_TEST_REQUIRE (thr1 != NULL);
+
+	thr2 = p_uthread_create ((PUThreadFunc) shm_allocator_test_thread, (ppointer) allocator, TRUE, NULL);
+	P_TEST_REQUIRE (thr2 != NULL);
+
+	thr3 = p_uthread_create ((PUThreadFunc) shm_allocator_test_thread, (ppointer) allocator, TRUE, NULL);
+	P_TEST_REQUIRE (thr3 != NULL);
+
+	P_TEST_CHECK (p_uthread_join (thr1) == 0);
+	P_TEST_CHECK (p_uthread_join (thr2) == 0);
+	P_TEST_CHECK (p_uthread_join (thr3) == 0);
+
+	p_uthread_unref (thr1);
+	p_uthread_unref (thr2);
+	p_uthread_unref (thr3);
+
+	p_shm_allocator_take_ownership (allocator);
+	p_shm_allocator_free (allocator);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pshmallocator_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pshmallocator_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pshmallocator_general_test);
+	P_TEST_SUITE_RUN_CASE (pshmallocator_thread_test);
+}
+P_TEST_SUITE_END()
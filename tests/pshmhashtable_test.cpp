@@ -0,0 +1,322 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <stdio.h>
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PSHMHASHTABLE_TEST_KEYS		2000
+
+static volatile pboolean	is_writer_done = FALSE;
+static volatile pint		reader_errors  = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * shm_hash_table_reader_thread (void *arg)
+{
+	PShmHashTable	*table = (PShmHashTable *) arg;
+	pconstpointer	value;
+	psize		value_len;
+	pchar		key[32];
+	pint		val;
+
+	/* Every found value must be complete and match its key */
+	while (!is_writer_done) {
+		for (pint i = 0; i < PSHMHASHTABLE_TEST_KEYS; i += 7) {
+			snprintf (key, sizeof (key), "key_%d", i);
+
+			if (!p_shm_hash_table_lookup (table, key, strlen (key), &value, &value_len))
+				continue;
+
+			memcpy (&val, value, sizeof (val));
+
+			if (value_len != sizeof (pint) || (val != i && val != -i))
+				p_atomic_int_inc (&reader_errors);
+		}
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pshmhashtable_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.f_free    = pmem_free;
+	vtable.f_malloc  = pmem_alloc;
+	vtable.f_realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_shm_hash_table_new ("p_shm_hash_table_test", 65536, 0, P_SHM_ACCESS_READWRITE, NULL) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pshmhashtable_invalid_test)
+{
+	PShmHashTable	*table;
+	PError		*error = NULL;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_shm_hash_table_new (NULL, 65536, 0, P_SHM_ACCESS_READWRITE, NULL) == NULL);
+	P_TEST_CHECK (p_shm_hash_table_insert (NULL, "key", 3, "value", 5, NULL) == FALSE);
+	P_TEST_CHECK (p_shm_hash_table_remove (NULL, "key", 3, NULL) == FALSE);
+	P_TEST_CHECK (p_shm_hash_table_lookup (NULL, "key", 3, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_shm_hash_table_get_count (NULL) == 0);
+	P_TEST_CHECK (p_shm_hash_table_get_free_space (NULL) == 0);
+	p_shm_hash_table_take_ownership (NULL);
+	p_shm_hash_table_free (NULL);
+
+	/* Segment is too small for the table */
+	table = p_shm_hash_table_new ("p_shm_hash_table_small", 64, 0, P_SHM_ACCESS_READWRITE, &error);
+	P_TEST_CHECK (table == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	table = p_shm_hash_table_new ("p_shm_hash_table_small", 64, 0, P_SHM_ACCESS_READWRITE, NULL);
+
+	if (table != NULL)
+		p_shm_hash_table_take_ownership (table);
+
+	p_shm_hash_table_free (table);
+
+	/* Read-only users can't initialize the table */
+	table = p_shm_hash_table_new ("p_shm_hash_table_uninit", 65536, 0, P_SHM_ACCESS_READONLY, &error);
+	P_TEST_CHECK (table == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+
+	table = p_shm_hash_table_new ("p_shm_hash_table_uninit", 65536, 0, P_SHM_ACCESS_READWRITE, NULL);
+	P_TEST_REQUIRE (table != NULL);
+	P_TEST_CHECK (p_shm_hash_table_insert (table, NULL, 3, "value", 5, NULL) == FALSE);
+	P_TEST_CHECK (p_shm_hash_table_insert (table, "key", 3, NULL, 5, NULL) == FALSE);
+	P_TEST_CHECK (p_shm_hash_table_remove (table, NULL, 3, NULL) == FALSE);
+	P_TEST_CHECK (p_shm_hash_table_lookup (table, NULL, 3, NULL, NULL) == FALSE);
+	p_shm_hash_table_take_ownership (table);
+	p_shm_hash_table_free (table);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pshmhashtable_general_test)
+{
+	PShmHashTable	*table;
+	PShmHashTable	*table2;
+	PError		*error = NULL;
+	pconstpointer	value;
+	psize		value_len;
+	psize		free_space;
+	pchar		key[32];
+	pint		val;
+
+	p_libsys_init ();
+
+	table = p_shm_hash_table_new ("p_shm_hash_table_test", 256 * 1024, 0, P_SHM_ACCESS_READWRITE, NULL);
+	P_TEST_REQUIRE (table != NULL);
+	p_shm_hash_table_take_ownership (table);
+	p_shm_hash_table_free (table);
+
+	table = p_shm_hash_table_new ("p_shm_hash_table_test", 256 * 1024, 64, P_SHM_ACCESS_READWRITE, NULL);
+	P_TEST_REQUIRE (table != NULL);
+	P_TEST_CHECK (p_shm_hash_table_get_count (table) == 0);
+
+	free_space = p_shm_hash_table_get_free_space (table);
+	P_TEST_CHECK (free_space > 0 && free_space < 256 * 1024);
+
+	for (pint i = 0; i < PSHMHASHTABLE_TEST_KEYS; ++i) {
+		snprintf (key, sizeof (key), "key_%d", i);
+		P_TEST_REQUIRE (p_shm_hash_table_insert (table, key, strlen (key), &i, sizeof (i), NULL) == TRUE);
+	}
+
+	P_TEST_CHECK (p_shm_hash_table_get_count (table) == PSHMHASHTABLE_TEST_KEYS);
+	P_TEST_CHECK (p_shm_hash_table_get_free_space (table) < free_space);
+
+	/* Empty value and zero-length key */
+	P_TEST_CHECK (p_shm_hash_table_insert (table, "", 0, NULL, 0, NULL) == TRUE);
+	P_TEST_CHECK (p_shm_hash_table_lookup (table, "", 0, &value, &value_len) == TRUE);
+	P_TEST_CHECK (value_len == 0);
+	P_TEST_CHECK (p_shm_hash_table_remove (table, "", 0, NULL) == TRUE);
+
+	/* Another attachment sees all the data at a different address */
+	table2 = p_shm_hash_table_new ("p_shm_hash_table_test", 0, 0, P_SHM_ACCESS_READONLY, NULL);
+
+	if (table2 == NULL) {
+		/* Some systems may want exactly the same permissions */
+		table2 = p_shm_hash_table_new ("p_shm_hash_table_test", 0, 0, P_SHM_ACCESS_READWRITE, NULL);
+	}
+
+	P_TEST_REQUIRE (table2 != NULL);
+	P_TEST_CHECK (p_shm_hash_table_get_count (table2) == PSHMHASHTABLE_TEST_KEYS);
+
+	for (pint i = 0; i < PSHMHASHTABLE_TEST_KEYS; ++i) {
+		snprintf (key, sizeof (key), "key_%d", i);
+		P_TEST_REQUIRE (p_shm_hash_table_lookup (table2, key, strlen (key), &value, &value_len) == TRUE);
+		P_TEST_CHECK (value_len == sizeof (pint));
+
+		memcpy (&val, value, sizeof (val));
+		P_TEST_CHECK (val == i);
+	}
+
+	P_TEST_CHECK (p_shm_hash_table_lookup (table2, "key_missing", 11, NULL, NULL) == FALSE);
+
+	/* Replace and remove */
+	val = 1000000;
+	P_TEST_CHECK (p_shm_hash_table_insert (table, "key_5", 5, &val, sizeof (val), NULL) == TRUE);
+	P_TEST_CHECK (p_shm_hash_table_get_count (table2) == PSHMHASHTABLE_TEST_KEYS);
+	P_TEST_CHECK (p_shm_hash_table_lookup (table2, "key_5", 5, &value, NULL) == TRUE);
+	P_TEST_CHECK (memcmp (value, &val, sizeof (val)) == 0);
+
+	P_TEST_CHECK (p_shm_hash_table_remove (table, "key_5", 5, NULL) == TRUE);
+	P_TEST_CHECK (p_shm_hash_table_remove (table, "key_5", 5, NULL) == FALSE);
+	P_TEST_CHECK (p_shm_hash_table_lookup (table2, "key_5", 5, NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_shm_hash_table_get_count (table2) == PSHMHASHTABLE_TEST_KEYS - 1);
+
+	P_TEST_CHECK (p_shm_hash_table_lookup (table2, "key_6", 5, NULL, &value_len) == TRUE);
+	P_TEST_CHECK (value_len == sizeof (pint));
+
+	/* Removed key can be inserted again, old values stay in place */
+	pconstpointer old_value;
+
+	P_TEST_REQUIRE (p_shm_hash_table_lookup (table2, "key_6", 5, &old_value, NULL) == TRUE);
+
+	val = 2000000;
+	P_TEST_CHECK (p_shm_hash_table_insert (table, "key_5", 5, &val, sizeof (val), NULL) == TRUE);
+	P_TEST_CHECK (p_shm_hash_table_insert (table, "key_6", 5, &val, sizeof (val), NULL) == TRUE);
+	P_TEST_CHECK (p_shm_hash_table_get_count (table2) == PSHMHASHTABLE_TEST_KEYS);
+	P_TEST_CHECK (p_shm_hash_table_lookup (table2, "key_5", 5, &value, NULL) == TRUE);
+	P_TEST_CHECK (memcmp (value, &val, sizeof (val)) == 0);
+	P_TEST_CHECK (p_shm_hash_table_lookup (table2, "key_6", 5, &value, NULL) == TRUE);
+	P_TEST_CHECK (memcmp (value, &val, sizeof (val)) == 0);
+
+	memcpy (&val, old_value, sizeof (val));
+	P_TEST_CHECK (val == 6);
+
+	/* Fill up the table */
+	while (p_shm_hash_table_insert (table, "key_fill", 8, key, sizeof (key), &error) == TRUE)
+		;
+
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IPC_NO_RESOURCES);
+	P_TEST_CHECK (p_shm_hash_table_get_free_space (table) < 64);
+	p_error_free (error);
+
+	p_shm_hash_table_free (table2);
+	p_shm_hash_table_take_ownership (table);
+	p_shm_hash_table_free (table);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pshmhashtable_thread_test)
+{
+	PShmHashTable	*table;
+	PUThread	*thr;
+	pchar		key[32];
+	pint		val;
+
+	p_libsys_init ();
+
+	table = p_shm_hash_table_new ("p_shm_hash_table_thread", 1024 * 1024, 0, P_SHM_ACCESS_READWRITE, NULL);
+	P_TEST_REQUIRE (table != NULL);
+	p_shm_hash_table_take_ownership (table);
+	p_shm_hash_table_free (table);
+
+	table = p_shm_hash_table_new ("p_shm_hash_table_thread", 1024 * 1024, 0, P_SHM_ACCESS_READWRITE, NULL);
+	P_TEST_REQUIRE (table != NULL);
+
+	is_writer_done = FALSE;
+	reader_errors  = 0;
+
+	thr = p_uthread_create ((PUThreadFunc) shm_hash_table_reader_thread, (ppointer) table, TRUE, NULL);
+	P_TEST_REQUIRE (thr != NULL);
+
+	for (pint i = 0; i < PSHMHASHTABLE_TEST_KEYS; ++i) {
+		snprintf (key, sizeof (key), "key_%d", i);
+		P_TEST_CHECK (p_shm_hash_table_insert (table, key, strlen (key), &i, sizeof (i), NULL) == TRUE);
+
+		if (i % 3 == 0) {
+			val = -i;
+			P_TEST_CHECK (p_shm_hash_table_insert (table, key, strlen (key), &val, sizeof (val), NULL) == TRUE);
+		}
+
+		if (i % 100 == 0)
+			p_uthread_yield ();
+	}
+
+	is_writer_done = TRUE;
+
+	P_TEST_CHECK (p_uthread_join (thr) == 0);
+	P_TEST_CHECK (p_atomic_int_get (&reader_errors) == 0);
+	P_TEST_CHECK (p_shm_hash_table_get_count (table) == PSHMHASHTABLE_TEST_KEYS);
+
+	p_uthread_unref (thr);
+
+	p_shm_hash_table_take_ownership (table);
+	p_shm_hash_table_free (table);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pshmhashtable_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pshmhashtable_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pshmhashtable_general_test);
+	P_TEST_SUITE_RUN_CASE (pshmhashtable_thread_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,380 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+#define PSHMQUEUE_TEST_PRODUCERS	2
+#define PSHMQUEUE_TEST_CONSUMERS	2
+#define PSHMQUEUE_TEST_MESSAGES		20000
+#define PSHMQUEUE_TEST_BATCH		8
+
+typedef struct _QueueTestMessage {
+	pint	producer;
+	pint	value;
+} QueueTestMessage;
+
+static volatile pint	received_count = 0;
+static volatile pint	received_sum   = 0;
+static volatile pint	message_errors = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void * shm_queue_producer_thread (void *arg)
+{
+	PShmQueue		*queue;
+	QueueTestMessage	msg;
+	pssize			res;
+
+	/* Every thread uses its own attachment, just like a separate process */
+	queue = p_shm_queue_new ("p_shm_queue_thread", 0, 0, NULL);
+
+	if (queue == NULL)
+		p_uthread_exit (1);
+
+	msg.producer = PPOINTER_TO_INT (arg);
+
+	for (pint i = 1; i <= PSHMQUEUE_TEST_MESSAGES; ++i) {
+		msg.value = i;
+
+		while ((res = p_shm_queue_enqueue (queue, &msg, sizeof (msg), NULL)) == 0)
+			p_uthread_yield ();
+
+		if (res != (pssize) sizeof (msg))
+			p_atomic_int_inc (&message_errors);
+	}
+
+	p_shm_queue_free (queue);
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+static void * shm_queue_consumer_thread (void *arg)
+{
+	PShmQueue		*queue;
+	QueueTestMessage	msgs[PSHMQUEUE_TEST_BATCH];
+	psize			lengths[PSHMQUEUE_TEST_BATCH];
+	pint			last[PSHMQUEUE_TEST_PRODUCERS];
+	pint			count;
+
+	P_UNUSED (arg);
+
+	queue = p_shm_queue_new ("p_shm_queue_thread", 0, 0, NULL);
+
+	if (queue == NULL)
+		p_uthread_exit (1);
+
+	memset (last, 0, sizeof (last));
+
+	while (p_atomic_int_get (&received_count) < PSHMQUEUE_TEST_PRODUCERS * PSHMQUEUE_TEST_MESSAGES) {
+		count = p_shm_queue_dequeue_batch (queue,
+						   msgs,
+						   sizeof (msgs),
+						   lengths,
+						   PSHMQUEUE_TEST_BATCH,
+						   10,
+						   NULL);
+
+		if (count < 0) {
+			p_atomic_int_inc (&message_errors);
+			break;
+		}
+
+		for (pint i = 0; i < count; ++i) {
+			/* Messages of a single producer must arrive in order */
+			if (lengths[i] != sizeof (QueueTestMessage) ||
+			    msgs[i].producer < 0 || msgs[i].producer >= PSHMQUEUE_TEST_PRODUCERS ||
+			    msgs[i].value <= last[msgs[i].producer]) {
+				p_atomic_int_inc (&message_errors);
+				continue;
+			}
+
+			last[msgs[i].producer] = msgs[i].value;
+			p_atomic_int_add (&received_sum, msgs[i].value);
+		}
+
+		p_atomic_int_add (&received_count, count);
+	}
+
+	p_shm_queue_free (queue);
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pshmqueue_nomem_test)
+{
+	p_libsys_init ();
+
+	PMemVTable vtable;
+
+	vtable.f_free    = pmem_free;
+	vtable.f_malloc  = pmem_alloc;
+	vtable.f_realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_shm_queue_new ("p_shm_queue_test", 16, 64, NULL) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pshmqueue_invalid_test)
+{
+	PShmQueue	*queue;
+	PError		*error = NULL;
+	pchar		buf[64];
+	psize		lengths[4];
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_shm_queue_new (NULL, 16, 64, NULL) == NULL);
+	P_TEST_CHECK (p_shm_queue_new ("p_shm_queue_invalid", 16, 0, NULL) == NULL);
+	P_TEST_CHECK (p_shm_queue_new ("p_shm_queue_invalid", 0, 64, NULL) == NULL);
+	P_TEST_CHECK (p_shm_queue_enqueue (NULL, buf, sizeof (buf), NULL) == -1);
+	P_TEST_CHECK (p_shm_queue_dequeue (NULL, buf, sizeof (buf), 0, NULL) == -1);
+	P_TEST_CHECK (p_shm_queue_dequeue_batch (NULL, buf, sizeof (buf), lengths, 4, 0, NULL) == -1);
+	P_TEST_CHECK (p_shm_queue_get_max_message_size (NULL) == 0);
+	P_TEST_CHECK (p_shm_queue_get_capacity (NULL) == 0);
+	p_shm_queue_take_ownership (NULL);
+	p_shm_queue_free (NULL);
+
+	/* Too large parameters can't be mapped */
+	queue = p_shm_queue_new ("p_shm_queue_invalid", (psize) P_MAXINT32, 64, &error);
+	P_TEST_CHECK (queue == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	queue = p_shm_queue_new ("p_shm_queue_invalid", 16, 64, NULL);
+	P_TEST_REQUIRE (queue != NULL);
+
+	P_TEST_CHECK (p_shm_queue_enqueue (queue, NULL, 10, NULL) == -1);
+	P_TEST_CHECK (p_shm_queue_enqueue (queue, buf, 0, NULL) == -1);
+	P_TEST_CHECK (p_shm_queue_enqueue (queue, buf, 65, NULL) == -1);
+	P_TEST_CHECK (p_shm_queue_dequeue (queue, NULL, sizeof (buf), 0, NULL) == -1);
+	P_TEST_CHECK (p_shm_queue_dequeue (queue, buf, 0, 0, NULL) == -1);
+	P_TEST_CHECK (p_shm_queue_dequeue (queue, buf, sizeof (buf), -2, NULL) == -1);
+	P_TEST_CHECK (p_shm_queue_dequeue_batch (queue, buf, sizeof (buf), NULL, 4, 0, NULL) == -1);
+	P_TEST_CHECK (p_shm_queue_dequeue_batch (queue, buf, sizeof (buf), lengths, 0, 0, NULL) == -1);
+
+	/* Existing queue with different parameters */
+	P_TEST_CHECK (p_shm_queue_new ("p_shm_queue_invalid", 16, 32, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+
+	p_shm_queue_take_ownership (queue);
+	p_shm_queue_free (queue);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pshmqueue_general_test)
+{
+	PShmQueue	*queue;
+	PShmQueue	*queue2;
+	PError		*error = NULL;
+	pchar		buf[256];
+	pchar		msg[64];
+	psize		lengths[8];
+	psize		offset;
+	pint		count;
+
+	p_libsys_init ();
+
+	queue = p_shm_queue_new ("p_shm_queue_test", 10, 64, NULL);
+	P_TEST_REQUIRE (queue != NULL);
+	p_shm_queue_take_ownership (queue);
+	p_shm_queue_free (queue);
+
+	queue = p_shm_queue_new ("p_shm_queue_test", 10, 64, NULL);
+	P_TEST_REQUIRE (queue != NULL);
+
+	P_TEST_CHECK (p_shm_queue_get_capacity (queue) == 16);
+	P_TEST_CHECK (p_shm_queue_get_max_message_size (queue) == 64);
+
+	/* Empty queue doesn't block with a zero timeout */
+	P_TEST_CHECK (p_shm_queue_dequeue (queue, buf, sizeof (buf), 0, NULL) == 0);
+	P_TEST_CHECK (p_shm_queue_dequeue (queue, buf, sizeof (buf), 50, NULL) == 0);
+	P_TEST_CHECK (p_shm_queue_dequeue_batch (queue, buf, sizeof (buf), lengths, 8, 0, NULL) == 0);
+
+	/* Another attachment sees the same queue */
+	queue2 = p_shm_queue_new ("p_shm_queue_test", 0, 0, NULL);
+	P_TEST_REQUIRE (queue2 != NULL);
+	P_TEST_CHECK (p_shm_queue_get_capacity (queue2) == 16);
+	P_TEST_CHECK (p_shm_queue_get_max_message_size (queue2) == 64);
+
+	/* Fill up the queue, message boundaries are preserved */
+	for (pint i = 0; i < 16; ++i) {
+		memset (msg, 'a' + i, sizeof (msg));
+		P_TEST_CHECK (p_shm_queue_enqueue (queue, msg, (psize) (i + 1), NULL) == i + 1);
+	}
+
+	P_TEST_CHECK (p_shm_queue_enqueue (queue, msg, 1, NULL) == 0);
+
+	P_TEST_CHECK (p_shm_queue_dequeue (queue2, buf, sizeof (buf), 0, NULL) == 1);
+	P_TEST_CHECK (buf[0] == 'a');
+
+	P_TEST_CHECK (p_shm_queue_dequeue (queue2, buf, sizeof (buf), -1, NULL) == 2);
+	P_TEST_CHECK (buf[0] == 'b' && buf[1] == 'b');
+
+	/* Message doesn't fit, it must stay in the queue */
+	P_TEST_CHECK (p_shm_queue_dequeue (queue2, buf, 2, 0, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_shm_queue_dequeue_batch (queue2, buf, 2, lengths, 8, 0, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	/* Batch is limited by the number of messages and by the buffer size */
+	count = p_shm_queue_dequeue_batch (queue2, buf, sizeof (buf), lengths, 3, 0, NULL);
+	P_TEST_CHECK (count == 3);
+
+	offset = 0;
+
+	for (pint i = 0; i < count; offset += lengths[i], ++i) {
+		P_TEST_CHECK (lengths[i] == (psize) (i + 3));
+		P_TEST_CHECK (buf[offset] == 'c' + i && buf[offset + lengths[i] - 1] == 'c' + i);
+	}
+
+	count = p_shm_queue_dequeue_batch (queue2, buf, 20, lengths, 8, 0, NULL);
+	P_TEST_CHECK (count == 2);
+	P_TEST_CHECK (lengths[0] == 6 && lengths[1] == 7);
+
+	/* Freed slots are reused on the next lap */
+	for (pint i = 0; i < 7; ++i)
+		P_TEST_CHECK (p_shm_queue_enqueue (queue2, msg, 64, NULL) == 64);
+
+	P_TEST_CHECK (p_shm_queue_enqueue (queue2, msg, 64, NULL) == 0);
+
+	offset = 0;
+
+	while ((count = p_shm_queue_dequeue_batch (queue, buf, sizeof (buf), lengths, 8, 0, NULL)) > 0) {
+		for (pint i = 0; i < count; ++i)
+			offset += lengths[i];
+	}
+
+	P_TEST_CHECK (count == 0);
+	P_TEST_CHECK (offset == 8 + 9 + 10 + 11 + 12 + 13 + 14 + 15 + 16 + 7 * 64);
+
+	p_shm_queue_free (queue2);
+	p_shm_queue_take_ownership (queue);
+	p_shm_queue_free (queue);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pshmqueue_thread_test)
+{
+	PShmQueue	*queue;
+	PUThread	*producers[PSHMQUEUE_TEST_PRODUCERS];
+	PUThread	*consumers[PSHMQUEUE_TEST_CONSUMERS];
+
+	p_libsys_init ();
+
+	queue = p_shm_queue_new ("p_shm_queue_thread", 64, sizeof (QueueTestMessage), NULL);
+	P_TEST_REQUIRE (queue != NULL);
+	p_shm_queue_take_ownership (queue);
+	p_shm_queue_free (queue);
+
+	queue = p_shm_queue_new ("p_shm_queue_thread", 64, sizeof (QueueTestMessage), NULL);
+	P_TEST_REQUIRE (queue != NULL);
+
+	received_count = 0;
+	received_sum   = 0;
+	message_errors = 0;
+
+	for (pint i = 0; i < PSHMQUEUE_TEST_CONSUMERS; ++i) {
+		consumers[i] = p_uthread_create ((PUThreadFunc) shm_queue_consumer_thread, NULL, TRUE, NULL);
+		P_TEST_REQUIRE (consumers[i] != NULL);
+	}
+
+	for (pint i = 0; i < PSHMQUEUE_TEST_PRODUCERS; ++i) {
+		producers[i] = p_uthread_create ((PUThreadFunc) shm_queue_producer_thread,
+						 PINT_TO_POINTER (i),
+						 TRUE,
+						 NULL);
+		P_TEST_REQUIRE (producers[i] != NULL);
+	}
+
+	for (pint i = 0; i < PSHMQUEUE_TEST_PRODUCERS; ++i) {
+		P_TEST_CHECK (p_uthread_join (producers[i]) == 0);
+		p_uthread_unref (producers[i]);
+	}
+
+	for (pint i = 0; i < PSHMQUEUE_TEST_CONSUMERS; ++i) {
+		P_TEST_CHECK (p_uthread_join (consumers[i]) == 0);
+		p_uthread_unref (consumers[i]);
+	}
+
+	P_TEST_CHECK (p_atomic_int_get (&message_errors) == 0);
+	P_TEST_CHECK (p_atomic_int_get (&received_count) == PSHMQUEUE_TEST_PRODUCERS * PSHMQUEUE_TEST_MESSAGES);
+	P_TEST_CHECK (p_atomic_int_get (&received_sum) ==
+		      PSHMQUEUE_TEST_PRODUCERS * (PSHMQUEUE_TEST_MESSAGES * (PSHMQUEUE_TEST_MESSAGES + 1) / 2));
+
+	p_shm_queue_take_ownership (queue);
+	p_shm_queue_free (queue);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pshmqueue_nomem_test);
+	P_TEST_SUITE_RUN_CASE (pshmqueue_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pshmqueue_general_test);
+	P_TEST_SUITE_RUN_CASE (pshmqueue_thread_test);
+}
+P_TEST_SUITE_END()
@@ -0,0 +1,243 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PSHMSYNC_TEST_ITERATIONS	1000
+
+typedef struct _ShmSyncTestLayout {
+	PShmMutex		*mutex;
+	PShmCondVariable	*cond;
+	volatile pint		*counter;
+	volatile pint		*turn;
+} ShmSyncTestLayout;
+
+static pboolean
+shmsync_test_layout (ppointer addr, ShmSyncTestLayout *layout)
+{
+	psize mutex_size;
+	psize cond_size;
+
+	mutex_size = (p_shm_mutex_get_size () + P_SHM_SYNC_ALIGNMENT - 1) /
+		     P_SHM_SYNC_ALIGNMENT * P_SHM_SYNC_ALIGNMENT;
+	cond_size  = (p_shm_cond_variable_get_size () + P_SHM_SYNC_ALIGNMENT - 1) /
+		     P_SHM_SYNC_ALIGNMENT * P_SHM_SYNC_ALIGNMENT;
+
+	layout->mutex   = (PShmMutex *) addr;
+	layout->cond    = (PShmCondVariable *) ((pchar *) addr + mutex_size);
+	layout->counter = (volatile pint *) ((pchar *) addr + mutex_size + cond_size);
+	layout->turn    = layout->counter + 1;
+
+	return mutex_size > 0 && cond_size > 0;
+}
+
+static void * shmsync_test_ping_thread (void *arg)
+{
+	ShmSyncTestLayout	*layout = (ShmSyncTestLayout *) arg;
+	PShmSyncStatus		status;
+
+	for (pint i = 0; i < PSHMSYNC_TEST_ITERATIONS; ++i) {
+		if (p_shm_mutex_lock (layout->mutex, NULL) != P_SHM_SYNC_STATUS_OK)
+			p_uthread_exit (1);
+
+		while (*layout->turn != 1) {
+			status = p_shm_cond_variable_wait (layout->cond, layout->mutex, NULL);
+
+			if (status != P_SHM_SYNC_STATUS_OK)
+				p_uthread_exit (1);
+		}
+
+		++(*layout->counter);
+		*layout->turn = 0;
+
+		if (p_shm_cond_variable_broadcast (layout->cond, NULL) == FALSE ||
+		    p_shm_mutex_unlock (layout->mutex, NULL) == FALSE)
+			p_uthread_exit (1);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+static void * shmsync_test_dead_owner_thread (void *arg)
+{
+	ShmSyncTestLayout *layout = (ShmSyncTestLayout *) arg;
+
+	/* Exit while holding the lock */
+	if (p_shm_mutex_lock (layout->mutex, NULL) != P_SHM_SYNC_STATUS_OK)
+		p_uthread_exit (1);
+
+	*layout->counter = -1;
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+P_TEST_CASE_BEGIN (pshmsync_invalid_test)
+{
+	pchar mem[256];
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_shm_mutex_init (NULL, 256, NULL) == NULL);
+	P_TEST_CHECK (p_shm_mutex_init (mem, 0, NULL) == NULL);
+	P_TEST_CHECK (p_shm_mutex_lock (NULL, NULL) == P_SHM_SYNC_STATUS_ERROR);
+	P_TEST_CHECK (p_shm_mutex_trylock (NULL, NULL) == P_SHM_SYNC_STATUS_ERROR);
+	P_TEST_CHECK (p_shm_mutex_unlock (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_shm_mutex_make_consistent (NULL, NULL) == FALSE);
+	p_shm_mutex_destroy (NULL);
+
+	P_TEST_CHECK (p_shm_cond_variable_init (NULL, 256, NULL) == NULL);
+	P_TEST_CHECK (p_shm_cond_variable_init (mem, 0, NULL) == NULL);
+	P_TEST_CHECK (p_shm_cond_variable_wait (NULL, NULL, NULL) == P_SHM_SYNC_STATUS_ERROR);
+	P_TEST_CHECK (p_shm_cond_variable_timed_wait (NULL, NULL, 10, NULL) == P_SHM_SYNC_STATUS_ERROR);
+	P_TEST_CHECK (p_shm_cond_variable_signal (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_shm_cond_variable_broadcast (NULL, NULL) == FALSE);
+	p_shm_cond_variable_destroy (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pshmsync_general_test)
+{
+	PShm			*shm;
+	PShm			*shm2;
+	PUThread		*thr;
+	ShmSyncTestLayout	layout;
+	ShmSyncTestLayout	layout2;
+	PError			*error = NULL;
+
+	p_libsys_init ();
+
+	shm = p_shm_new ("p_shmsync_test_block", 4096, P_SHM_ACCESS_READWRITE, NULL);
+	P_TEST_REQUIRE (shm != NULL);
+	p_shm_take_ownership (shm);
+	p_shm_free (shm);
+
+	shm = p_shm_new ("p_shmsync_test_block", 4096, P_SHM_ACCESS_READWRITE, NULL);
+	P_TEST_REQUIRE (shm != NULL);
+
+	if (!shmsync_test_layout (p_shm_get_address (shm), &layout)) {
+		P_TEST_CHECK (p_shm_mutex_init (p_shm_get_address (shm), 4096, NULL) == NULL);
+		p_shm_take_ownership (shm);
+		p_shm_free (shm);
+		p_libsys_shutdown ();
+		P_TEST_CASE_RETURN ();
+	}
+
+	P_TEST_CHECK (p_shm_mutex_init (p_shm_get_address (shm), 1, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_REQUIRE (p_shm_mutex_init (layout.mutex, p_shm_mutex_get_size (), NULL) == layout.mutex);
+	P_TEST_REQUIRE (p_shm_cond_variable_init (layout.cond,
+						  p_shm_cond_variable_get_size (),
+						  NULL) == layout.cond);
+
+	*layout.counter = 0;
+	*layout.turn    = 0;
+
+	/* Second mapping of the same segment acts like another process */
+	shm2 = p_shm_new ("p_shmsync_test_block", 4096, P_SHM_ACCESS_READWRITE, NULL);
+	P_TEST_REQUIRE (shm2 != NULL);
+	P_TEST_CHECK (shmsync_test_layout (p_shm_get_address (shm2), &layout2) == TRUE);
+
+	P_TEST_CHECK (p_shm_mutex_trylock (layout.mutex, NULL) == P_SHM_SYNC_STATUS_OK);
+	P_TEST_CHECK (p_shm_cond_variable_timed_wait (layout.cond,
+						      layout.mutex,
+						      50,
+						      NULL) == P_SHM_SYNC_STATUS_TIMED_OUT);
+	P_TEST_CHECK (p_shm_mutex_unlock (layout.mutex, NULL) == TRUE);
+
+	thr = p_uthread_create ((PUThreadFunc) shmsync_test_ping_thread, (ppointer) &layout2, TRUE, NULL);
+	P_TEST_REQUIRE (thr != NULL);
+
+	for (pint i = 0; i < PSHMSYNC_TEST_ITERATIONS; ++i) {
+		P_TEST_REQUIRE (p_shm_mutex_lock (layout.mutex, NULL) == P_SHM_SYNC_STATUS_OK);
+
+		while (*layout.turn != 0)
+			P_TEST_REQUIRE (p_shm_cond_variable_wait (layout.cond,
+								  layout.mutex,
+								  NULL) == P_SHM_SYNC_STATUS_OK);
+
+		++(*layout.counter);
+		*layout.turn = 1;
+
+		P_TEST_CHECK (p_shm_cond_variable_signal (layout.cond, NULL) == TRUE);
+		P_TEST_CHECK (p_shm_mutex_unlock (layout.mutex, NULL) == TRUE);
+	}
+
+	P_TEST_CHECK (p_uthread_join (thr) == 0);
+	P_TEST_CHECK (*layout.counter == PSHMSYNC_TEST_ITERATIONS * 2);
+
+	p_uthread_unref (thr);
+
+	/* Lock held by a dead owner must not wedge the segment forever */
+	thr = p_uthread_create ((PUThreadFunc) shmsync_test_dead_owner_thread, (ppointer) &layout2, TRUE, NULL);
+	P_TEST_REQUIRE (thr != NULL);
+	P_TEST_CHECK (p_uthread_join (thr) == 0);
+	p_uthread_unref (thr);
+
+	P_TEST_CHECK (*layout.counter == -1);
+
+	switch (p_shm_mutex_trylock (layout.mutex, NULL)) {
+	case P_SHM_SYNC_STATUS_OWNER_DIED:
+		*layout.counter = 0;
+		P_TEST_CHECK (p_shm_mutex_make_consistent (layout.mutex, NULL) == TRUE);
+		P_TEST_CHECK (p_shm_mutex_unlock (layout.mutex, NULL) == TRUE);
+		P_TEST_CHECK (p_shm_mutex_lock (layout.mutex, NULL) == P_SHM_SYNC_STATUS_OK);
+		P_TEST_CHECK (p_shm_mutex_unlock (layout.mutex, NULL) == TRUE);
+
+		p_shm_cond_variable_destroy (layout.cond);
+		p_shm_mutex_destroy (layout.mutex);
+		break;
+	case P_SHM_SYNC_STATUS_BUSY:
+		/* No robust mutexes on this system, the lock is lost */
+		break;
+	default:
+		P_TEST_CHECK (FALSE);
+	}
+
+	p_shm_free (shm2);
+	p_shm_take_ownership (shm);
+	p_shm_free (shm);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (pshmsync_invalid_test);
+	P_TEST_SUITE_RUN_CASE (pshmsync_general_test);
+}
+P_TEST_SUITE_END()
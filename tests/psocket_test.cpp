@@ -26,10 +26,19 @@
 #include "plibsys.h"
 #include "ptestmacros.h"
 
+#include <stdio.h>
 #include <string.h>
 
+#ifdef P_OS_LINUX
+#  include <unistd.h>
+#endif
+
 P_TEST_MODULE_INIT ();
 
+#define PSOCKET_SEND_FILE_TEST_FILE "." P_DIR_SEPARATOR "psocket_send_file_test.bin"
+#define PSOCKET_SEND_FILE_TEST_SIZE (2 * 1024 * 1024 + 321)
+#define PSOCKET_UNIX_TEST_PATH "." P_DIR_SEPARATOR "psocket_unix_test.sock"
+
 static pchar             socket_data[]       = "This is a socket test data!";
 volatile static pboolean is_sender_working   = FALSE;
 volatile static pboolean is_receiver_working = FALSE;
@@ -40,6 +49,13 @@ typedef struct _SocketTestData {
 	pboolean	shutdown_channel;
 } SocketTestData;
 
+typedef struct _SocketReceiveTestData {
+	PSocket		*socket;
+	pchar		*buffer;
+	psize		expected;
+	psize		received;
+} SocketReceiveTestData;
+
 extern "C" ppointer pmem_alloc (psize nbytes)
 {
 	P_UNUSED (nbytes);
@@ -583,6 +599,80 @@ static void * tcp_socket_receiver_thread (void *arg)
 	return NULL;
 }
 
+static void * tcp_socket_receive_all_thread (void *arg)
+{
+	SocketReceiveTestData	*data = (SocketReceiveTestData *) arg;
+	pssize			ret;
+
+	while (data->received < data->expected) {
+		ret = p_socket_receive (data->socket,
+					data->buffer + data->received,
+					data->expected - data->received,
+					NULL);
+
+		if (ret <= 0)
+			break;
+
+		data->received += (psize) ret;
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
+static pboolean receive_sent_data (PSocket		*socket,
+				   SocketReceiveTestData	*data,
+				   pssize		(*send_func) (ppointer),
+				   ppointer		send_arg,
+				   psize		pending,
+				   psize		expected)
+{
+	PUThread	*thr;
+	pssize		sent;
+
+	memset (data->buffer, 0, PSOCKET_SEND_FILE_TEST_SIZE * 2);
+
+	data->socket   = socket;
+	data->expected = pending + expected;
+	data->received = 0;
+
+	if ((thr = p_uthread_create ((PUThreadFunc) tcp_socket_receive_all_thread,
+				     (ppointer) data,
+				     TRUE,
+				     NULL)) == NULL)
+		return FALSE;
+
+	sent = send_func (send_arg);
+
+	p_uthread_join (thr);
+	p_uthread_unref (thr);
+
+	return sent == (pssize) expected && data->received == data->expected;
+}
+
+typedef struct _SocketSendFileArgs {
+	PSocket			*socket;
+	pint			fd;
+	const PMappedFile	*file;
+	puint64			offset;
+	psize			length;
+} SocketSendFileArgs;
+
+static pssize send_file_func (ppointer arg)
+{
+	SocketSendFileArgs *args = (SocketSendFileArgs *) arg;
+
+	return p_socket_send_file (args->socket, args->fd, args->offset, args->length, NULL);
+}
+
+static pssize send_mapped_file_func (ppointer arg)
+{
+	SocketSendFileArgs *args = (SocketSendFileArgs *) arg;
+
+	return p_socket_send_mapped_file (args->socket, args->file, (psize) args->offset, args->length, NULL);
+}
+
 P_TEST_CASE_BEGIN (psocket_nomem_test)
 {
 	p_libsys_init ();
@@ -623,6 +713,25 @@ P_TEST_CASE_BEGIN (psocket_nomem_test)
 	P_TEST_CHECK (p_socket_get_local_address (socket, NULL) == NULL);
 	P_TEST_CHECK (p_socket_get_remote_address (socket, NULL) == NULL);
 
+	/* Expected failures are reported into the caller storage without memory */
+	PErrorStorage	err_storage;
+	PError		*st_error = p_error_init (&err_storage);
+	pchar		buf[16];
+
+	p_socket_set_blocking (socket, FALSE);
+
+	P_TEST_CHECK (p_socket_receive (socket, buf, sizeof (buf), &st_error) == -1);
+	P_TEST_CHECK (st_error == (PError *) &err_storage);
+	P_TEST_CHECK (p_error_get_code (st_error) == (pint) P_ERROR_IO_WOULD_BLOCK);
+	P_TEST_CHECK (p_error_get_message (st_error) != NULL);
+
+	p_error_clear (st_error);
+
+	P_TEST_CHECK (p_socket_receive (socket, buf, sizeof (buf), &st_error) == -1);
+	P_TEST_CHECK (p_error_get_code (st_error) == (pint) P_ERROR_IO_WOULD_BLOCK);
+
+	p_error_free (st_error);
+
 	p_mem_restore_vtable ();
 
 	p_socket_close (socket, NULL);
@@ -680,6 +789,16 @@ P_TEST_CASE_BEGIN (psocket_bad_input_test)
 	P_TEST_CHECK (error != NULL);
 	clean_error (&error);
 
+	PSocketAddressStorage addr_storage;
+
+	P_TEST_CHECK (p_socket_get_local_address_into (NULL, &addr_storage, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	P_TEST_CHECK (p_socket_get_remote_address_into (NULL, &addr_storage, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
 	P_TEST_CHECK (p_socket_is_connected (NULL) == FALSE);
 	P_TEST_CHECK (p_socket_is_closed (NULL) == TRUE);
 
@@ -708,6 +827,10 @@ P_TEST_CASE_BEGIN (psocket_bad_input_test)
 	P_TEST_CHECK (error != NULL);
 	clean_error (&error);
 
+	P_TEST_CHECK (p_socket_accept_into (NULL, &addr_storage, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
 	P_TEST_CHECK (p_socket_receive (NULL, NULL, 0, &error) == -1);
 	P_TEST_CHECK (error != NULL);
 	clean_error (&error);
@@ -716,6 +839,10 @@ P_TEST_CASE_BEGIN (psocket_bad_input_test)
 	P_TEST_CHECK (error != NULL);
 	clean_error (&error);
 
+	P_TEST_CHECK (p_socket_receive_from_into (NULL, NULL, NULL, 0, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
 	P_TEST_CHECK (p_socket_send (NULL, NULL, 0, &error) == -1);
 	P_TEST_CHECK (error != NULL);
 	clean_error (&error);
@@ -724,6 +851,28 @@ P_TEST_CASE_BEGIN (psocket_bad_input_test)
 	P_TEST_CHECK (error != NULL);
 	clean_error (&error);
 
+	P_TEST_CHECK (p_socket_send_file (NULL, 0, 0, 10, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	P_TEST_CHECK (p_socket_send_mapped_file (NULL, NULL, 0, 0, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	P_TEST_CHECK (p_socket_set_option (NULL, P_SOCKET_OPTION_TCP_NODELAY, 1, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	P_TEST_CHECK (p_socket_get_option (NULL, P_SOCKET_OPTION_TCP_NODELAY, NULL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	P_TEST_CHECK (p_socket_get_tcp_info (NULL, NULL, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	P_TEST_CHECK (p_socket_is_option_supported ((PSocketOption) -1) == FALSE);
+
 	P_TEST_CHECK (p_socket_close (NULL, &error) == FALSE);
 	P_TEST_CHECK (error != NULL);
 	clean_error (&error);
@@ -1116,6 +1265,809 @@ P_TEST_CASE_BEGIN (psocket_shutdown_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (psocket_address_into_test)
+{
+	p_libsys_init ();
+
+	PSocketAddressStorage	storage;
+	PSocketAddressStorage	local_storage;
+	PSocketAddress		*addr;
+	PSocketAddress		*local_addr;
+	pchar			buf[sizeof (socket_data)];
+
+	/* UDP */
+	PSocket *udp_recv = p_socket_new (P_SOCKET_FAMILY_INET,
+					  P_SOCKET_TYPE_DATAGRAM,
+					  P_SOCKET_PROTOCOL_UDP,
+					  NULL);
+	PSocket *udp_send = p_socket_new (P_SOCKET_FAMILY_INET,
+					  P_SOCKET_TYPE_DATAGRAM,
+					  P_SOCKET_PROTOCOL_UDP,
+					  NULL);
+	P_TEST_REQUIRE (udp_recv != NULL && udp_send != NULL);
+
+	addr = p_socket_address_init (&storage, "127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+
+	P_TEST_CHECK (p_socket_bind (udp_recv, addr, FALSE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_bind (udp_send, addr, FALSE, NULL) == TRUE);
+
+	P_TEST_CHECK (p_socket_get_local_address_into (udp_recv, &storage, NULL) == TRUE);
+	addr = p_socket_address_from_storage (&storage);
+	P_TEST_CHECK (p_socket_address_get_port (addr) != 0);
+
+	P_TEST_CHECK (p_socket_send_to (udp_send,
+					addr,
+					socket_data,
+					sizeof (socket_data),
+					NULL) == (pssize) sizeof (socket_data));
+
+	p_socket_set_timeout (udp_recv, 2000);
+
+	P_TEST_CHECK (p_socket_receive_from_into (udp_recv,
+						  &storage,
+						  buf,
+						  sizeof (buf),
+						  NULL) == (pssize) sizeof (socket_data));
+	P_TEST_CHECK (memcmp (buf, socket_data, sizeof (socket_data)) == 0);
+
+	P_TEST_CHECK (p_socket_get_local_address_into (udp_send, &local_storage, NULL) == TRUE);
+	addr       = p_socket_address_from_storage (&storage);
+	local_addr = p_socket_address_from_storage (&local_storage);
+	P_TEST_CHECK (compare_socket_addresses (addr, local_addr) == TRUE);
+
+	pchar str_addr[P_SOCKET_ADDRESS_MAX_STRING_LEN];
+
+	P_TEST_CHECK (p_socket_address_get_address_into (addr, str_addr, sizeof (str_addr)) == TRUE);
+	P_TEST_CHECK (strcmp (str_addr, "127.0.0.1") == 0);
+
+	p_socket_free (udp_recv);
+	p_socket_free (udp_send);
+
+	/* TCP */
+	PSocket *tcp_server = p_socket_new (P_SOCKET_FAMILY_INET,
+					    P_SOCKET_TYPE_STREAM,
+					    P_SOCKET_PROTOCOL_TCP,
+					    NULL);
+	PSocket *tcp_client = p_socket_new (P_SOCKET_FAMILY_INET,
+					    P_SOCKET_TYPE_STREAM,
+					    P_SOCKET_PROTOCOL_TCP,
+					    NULL);
+	P_TEST_REQUIRE (tcp_server != NULL && tcp_client != NULL);
+
+	addr = p_socket_address_init (&storage, "127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+
+	P_TEST_CHECK (p_socket_bind (tcp_server, addr, FALSE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_listen (tcp_server, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_get_local_address_into (tcp_server, &storage, NULL) == TRUE);
+
+	p_socket_set_timeout (tcp_server, 2000);
+
+	P_TEST_CHECK (p_socket_connect (tcp_client, p_socket_address_from_storage (&storage), NULL) == TRUE);
+
+	PSocket *tcp_accepted = p_socket_accept_into (tcp_server, &storage, NULL);
+	P_TEST_REQUIRE (tcp_accepted != NULL);
+
+	P_TEST_CHECK (p_socket_get_local_address_into (tcp_client, &local_storage, NULL) == TRUE);
+	P_TEST_CHECK (compare_socket_addresses (p_socket_address_from_storage (&storage),
+						p_socket_address_from_storage (&local_storage)) == TRUE);
+
+	P_TEST_CHECK (p_socket_get_remote_address_into (tcp_accepted, &storage, NULL) == TRUE);
+	P_TEST_CHECK (compare_socket_addresses (p_socket_address_from_storage (&storage),
+						p_socket_address_from_storage (&local_storage)) == TRUE);
+
+	p_socket_free (tcp_accepted);
+	p_socket_free (tcp_client);
+	p_socket_free (tcp_server);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocket_send_file_test)
+{
+	p_libsys_init ();
+
+	PSocketAddressStorage	storage;
+	PSocketAddress		*addr;
+	SocketReceiveTestData	recv_data;
+	SocketSendFileArgs	args;
+	PError			*error = NULL;
+	pchar			*file_data;
+	FILE			*file;
+
+	file_data        = (pchar *) p_malloc (PSOCKET_SEND_FILE_TEST_SIZE);
+	recv_data.buffer = (pchar *) p_malloc (PSOCKET_SEND_FILE_TEST_SIZE * 2);
+	P_TEST_REQUIRE (file_data != NULL && recv_data.buffer != NULL);
+
+	for (pint i = 0; i < PSOCKET_SEND_FILE_TEST_SIZE; ++i)
+		file_data[i] = (pchar) (i * 31 + i / 4093);
+
+	file = fopen (PSOCKET_SEND_FILE_TEST_FILE, "wb");
+	P_TEST_REQUIRE (file != NULL);
+	P_TEST_REQUIRE (fwrite (file_data, 1, PSOCKET_SEND_FILE_TEST_SIZE, file) == PSOCKET_SEND_FILE_TEST_SIZE);
+	fclose (file);
+
+	PSocket *tcp_server = p_socket_new (P_SOCKET_FAMILY_INET,
+					    P_SOCKET_TYPE_STREAM,
+					    P_SOCKET_PROTOCOL_TCP,
+					    NULL);
+	PSocket *tcp_client = p_socket_new (P_SOCKET_FAMILY_INET,
+					    P_SOCKET_TYPE_STREAM,
+					    P_SOCKET_PROTOCOL_TCP,
+					    NULL);
+	P_TEST_REQUIRE (tcp_server != NULL && tcp_client != NULL);
+
+	addr = p_socket_address_init (&storage, "127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+
+	P_TEST_CHECK (p_socket_bind (tcp_server, addr, FALSE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_listen (tcp_server, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_get_local_address_into (tcp_server, &storage, NULL) == TRUE);
+
+	p_socket_set_timeout (tcp_server, 2000);
+
+	P_TEST_CHECK (p_socket_connect (tcp_client, p_socket_address_from_storage (&storage), NULL) == TRUE);
+
+	PSocket *tcp_accepted = p_socket_accept (tcp_server, NULL);
+	P_TEST_REQUIRE (tcp_accepted != NULL);
+
+	p_socket_set_timeout (tcp_accepted, 5000);
+
+	file = fopen (PSOCKET_SEND_FILE_TEST_FILE, "rb");
+	P_TEST_REQUIRE (file != NULL);
+
+	args.socket = tcp_client;
+	args.fd     = fileno (file);
+	args.file   = NULL;
+
+	/* Invalid file descriptor and length */
+	P_TEST_CHECK (p_socket_send_file (tcp_client, -1, 0, 10, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	P_TEST_CHECK (p_socket_send_file (tcp_client, args.fd, 0, 0, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	/* Whole file */
+	args.offset = 0;
+	args.length = PSOCKET_SEND_FILE_TEST_SIZE;
+
+	P_TEST_CHECK (receive_sent_data (tcp_accepted,
+					 &recv_data,
+					 send_file_func,
+					 &args,
+					 0,
+					 PSOCKET_SEND_FILE_TEST_SIZE) == TRUE);
+	P_TEST_CHECK (memcmp (recv_data.buffer, file_data, PSOCKET_SEND_FILE_TEST_SIZE) == 0);
+
+	/* File range */
+	args.offset = 12345;
+	args.length = 100000;
+
+	P_TEST_CHECK (receive_sent_data (tcp_accepted,
+					 &recv_data,
+					 send_file_func,
+					 &args,
+					 0,
+					 100000) == TRUE);
+	P_TEST_CHECK (memcmp (recv_data.buffer, file_data + 12345, 100000) == 0);
+
+	/* Range crossing the end of file */
+	args.offset = PSOCKET_SEND_FILE_TEST_SIZE - 100;
+	args.length = 1000;
+
+	P_TEST_CHECK (p_socket_send_file (tcp_client, args.fd, args.offset, args.length, NULL) == 100);
+	P_TEST_CHECK (p_socket_receive (tcp_accepted, recv_data.buffer, 100, NULL) == 100);
+	P_TEST_CHECK (memcmp (recv_data.buffer, file_data + PSOCKET_SEND_FILE_TEST_SIZE - 100, 100) == 0);
+
+	/* Range after the end of file */
+	args.offset = PSOCKET_SEND_FILE_TEST_SIZE + 100;
+	P_TEST_CHECK (p_socket_send_file (tcp_client, args.fd, args.offset, args.length, NULL) == 0);
+
+	/* File position must be left intact */
+	P_TEST_CHECK (ftell (file) == 0);
+
+	fclose (file);
+
+	/* Mapped file */
+	PMappedFile *mapped = p_mapped_file_new (PSOCKET_SEND_FILE_TEST_FILE, P_MAPPED_FILE_MODE_READ_ONLY, NULL);
+	P_TEST_REQUIRE (mapped != NULL);
+
+	args.file   = mapped;
+	args.offset = 0;
+	args.length = 0;
+
+	P_TEST_CHECK (receive_sent_data (tcp_accepted,
+					 &recv_data,
+					 send_mapped_file_func,
+					 &args,
+					 0,
+					 PSOCKET_SEND_FILE_TEST_SIZE) == TRUE);
+	P_TEST_CHECK (memcmp (recv_data.buffer, file_data, PSOCKET_SEND_FILE_TEST_SIZE) == 0);
+
+	args.offset = 777;
+	args.length = 5000;
+
+	P_TEST_CHECK (receive_sent_data (tcp_accepted,
+					 &recv_data,
+					 send_mapped_file_func,
+					 &args,
+					 0,
+					 5000) == TRUE);
+	P_TEST_CHECK (memcmp (recv_data.buffer, file_data + 777, 5000) == 0);
+
+	P_TEST_CHECK (p_socket_send_mapped_file (tcp_client, mapped, PSOCKET_SEND_FILE_TEST_SIZE, 0, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	P_TEST_CHECK (p_socket_send_mapped_file (tcp_client, mapped, 10, PSOCKET_SEND_FILE_TEST_SIZE, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	/* Non-blocking mode sends only as much as fits into the socket buffers */
+	P_TEST_CHECK (p_socket_set_buffer_size (tcp_client, P_SOCKET_DIRECTION_SND, 32768, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_set_buffer_size (tcp_accepted, P_SOCKET_DIRECTION_RCV, 32768, NULL) == TRUE);
+
+	p_socket_set_blocking (tcp_client, FALSE);
+
+	pssize first_sent = p_socket_send_mapped_file (tcp_client, mapped, 0, 0, NULL);
+	pssize pending    = first_sent;
+	pssize sent;
+
+	P_TEST_CHECK (first_sent > 0);
+
+	while (pending > 0 && pending < PSOCKET_SEND_FILE_TEST_SIZE) {
+		if ((sent = p_socket_send_mapped_file (tcp_client, mapped, 0, 0, &error)) <= 0)
+			break;
+
+		pending += sent;
+	}
+
+	P_TEST_CHECK (pending < PSOCKET_SEND_FILE_TEST_SIZE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_WOULD_BLOCK);
+	clean_error (&error);
+
+	p_socket_set_blocking (tcp_client, TRUE);
+
+	P_TEST_CHECK (receive_sent_data (tcp_accepted,
+					 &recv_data,
+					 send_mapped_file_func,
+					 &args,
+					 (psize) pending,
+					 5000) == TRUE);
+	P_TEST_CHECK (memcmp (recv_data.buffer, file_data, (psize) first_sent) == 0);
+	P_TEST_CHECK (memcmp (recv_data.buffer + pending, file_data + 777, 5000) == 0);
+
+	p_mapped_file_free (mapped);
+
+#ifdef P_OS_LINUX
+	/* Pipe data is spliced */
+	pint pipe_fds[2];
+
+	P_TEST_REQUIRE (pipe (pipe_fds) == 0);
+	P_TEST_CHECK (write (pipe_fds[1], file_data, 4096) == 4096);
+	close (pipe_fds[1]);
+
+	P_TEST_CHECK (p_socket_send_file (tcp_client, pipe_fds[0], 1, 4096, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	P_TEST_CHECK (p_socket_send_file (tcp_client, pipe_fds[0], 0, 8192, NULL) == 4096);
+	P_TEST_CHECK (p_socket_receive (tcp_accepted, recv_data.buffer, 4096, NULL) == 4096);
+	P_TEST_CHECK (memcmp (recv_data.buffer, file_data, 4096) == 0);
+
+	close (pipe_fds[0]);
+#endif
+
+	P_TEST_CHECK (p_file_remove (PSOCKET_SEND_FILE_TEST_FILE, NULL) == TRUE);
+
+	p_socket_free (tcp_accepted);
+	p_socket_free (tcp_client);
+	p_socket_free (tcp_server);
+
+	p_free (recv_data.buffer);
+	p_free (file_data);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocket_options_test)
+{
+	p_libsys_init ();
+
+	PSocketAddressStorage	storage;
+	PSocketAddress		*addr;
+	PSocketTcpInfo		info;
+	PError			*error = NULL;
+	pint			value;
+
+	PSocket *tcp_server = p_socket_new (P_SOCKET_FAMILY_INET,
+					    P_SOCKET_TYPE_STREAM,
+					    P_SOCKET_PROTOCOL_TCP,
+					    NULL);
+	PSocket *tcp_client = p_socket_new (P_SOCKET_FAMILY_INET,
+					    P_SOCKET_TYPE_STREAM,
+					    P_SOCKET_PROTOCOL_TCP,
+					    NULL);
+	P_TEST_REQUIRE (tcp_server != NULL && tcp_client != NULL);
+
+	/* Unknown option */
+	P_TEST_CHECK (p_socket_set_option (tcp_client, (PSocketOption) 100, 1, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_NOT_SUPPORTED);
+	clean_error (&error);
+
+	P_TEST_CHECK (p_socket_get_option (tcp_client, (PSocketOption) 100, &value, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_NOT_SUPPORTED);
+	clean_error (&error);
+
+	/* Listening socket options */
+	if (p_socket_is_option_supported (P_SOCKET_OPTION_TCP_DEFER_ACCEPT)) {
+		P_TEST_CHECK (p_socket_set_option (tcp_server, P_SOCKET_OPTION_TCP_DEFER_ACCEPT, 5, NULL) == TRUE);
+		P_TEST_CHECK (p_socket_get_option (tcp_server, P_SOCKET_OPTION_TCP_DEFER_ACCEPT, &value, NULL) == TRUE);
+		P_TEST_CHECK (value > 0);
+
+		P_TEST_CHECK (p_socket_set_option (tcp_server, P_SOCKET_OPTION_TCP_DEFER_ACCEPT, 0, NULL) == TRUE);
+	}
+
+	if (p_socket_is_option_supported (P_SOCKET_OPTION_TCP_FASTOPEN))
+		(void) p_socket_set_option (tcp_server, P_SOCKET_OPTION_TCP_FASTOPEN, 16, NULL);
+
+	if (p_socket_is_option_supported (P_SOCKET_OPTION_REUSE_PORT)) {
+		P_TEST_CHECK (p_socket_set_option (tcp_server, P_SOCKET_OPTION_REUSE_PORT, 1, NULL) == TRUE);
+		P_TEST_CHECK (p_socket_get_option (tcp_server, P_SOCKET_OPTION_REUSE_PORT, &value, NULL) == TRUE);
+		P_TEST_CHECK (value == 1);
+	}
+
+	addr = p_socket_address_init (&storage, "127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+
+	P_TEST_CHECK (p_socket_bind (tcp_server, addr, FALSE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_listen (tcp_server, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_get_local_address_into (tcp_server, &storage, NULL) == TRUE);
+
+	p_socket_set_timeout (tcp_server, 2000);
+
+	P_TEST_CHECK (p_socket_connect (tcp_client, p_socket_address_from_storage (&storage), NULL) == TRUE);
+
+	PSocket *tcp_accepted = p_socket_accept (tcp_server, NULL);
+	P_TEST_REQUIRE (tcp_accepted != NULL);
+
+	/* Connected socket options */
+	P_TEST_CHECK (p_socket_is_option_supported (P_SOCKET_OPTION_TCP_NODELAY) == TRUE);
+
+	P_TEST_CHECK (p_socket_set_option (tcp_client, P_SOCKET_OPTION_TCP_NODELAY, 1, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_get_option (tcp_client, P_SOCKET_OPTION_TCP_NODELAY, &value, NULL) == TRUE);
+	P_TEST_CHECK (value == 1);
+
+	P_TEST_CHECK (p_socket_set_option (tcp_client, P_SOCKET_OPTION_TCP_NODELAY, 0, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_get_option (tcp_client, P_SOCKET_OPTION_TCP_NODELAY, &value, NULL) == TRUE);
+	P_TEST_CHECK (value == 0);
+
+	if (p_socket_is_option_supported (P_SOCKET_OPTION_TCP_CORK)) {
+		P_TEST_CHECK (p_socket_set_option (tcp_client, P_SOCKET_OPTION_TCP_CORK, 1, NULL) == TRUE);
+		P_TEST_CHECK (p_socket_get_option (tcp_client, P_SOCKET_OPTION_TCP_CORK, &value, NULL) == TRUE);
+		P_TEST_CHECK (value == 1);
+
+		P_TEST_CHECK (p_socket_send (tcp_client, socket_data, sizeof (socket_data), NULL) ==
+			      (pssize) sizeof (socket_data));
+
+		P_TEST_CHECK (p_socket_set_option (tcp_client, P_SOCKET_OPTION_TCP_CORK, 0, NULL) == TRUE);
+		P_TEST_CHECK (p_socket_get_option (tcp_client, P_SOCKET_OPTION_TCP_CORK, &value, NULL) == TRUE);
+		P_TEST_CHECK (value == 0);
+
+		pchar buf[sizeof (socket_data)];
+
+		p_socket_set_timeout (tcp_accepted, 2000);
+
+		P_TEST_CHECK (p_socket_receive (tcp_accepted, buf, sizeof (buf), NULL) == (pssize) sizeof (socket_data));
+		P_TEST_CHECK (memcmp (buf, socket_data, sizeof (socket_data)) == 0);
+	}
+
+	if (p_socket_is_option_supported (P_SOCKET_OPTION_TCP_QUICKACK)) {
+		P_TEST_CHECK (p_socket_set_option (tcp_accepted, P_SOCKET_OPTION_TCP_QUICKACK, 1, NULL) == TRUE);
+		P_TEST_CHECK (p_socket_get_option (tcp_accepted, P_SOCKET_OPTION_TCP_QUICKACK, &value, NULL) == TRUE);
+		P_TEST_CHECK (value == 0 || value == 1);
+	}
+
+	if (p_socket_is_option_supported (P_SOCKET_OPTION_BUSY_POLL)) {
+		P_TEST_CHECK (p_socket_get_option (tcp_accepted, P_SOCKET_OPTION_BUSY_POLL, &value, NULL) == TRUE);
+		P_TEST_CHECK (value >= 0);
+	}
+
+	/* Connection state */
+	if (p_socket_get_tcp_info (tcp_client, &info, &error) == TRUE) {
+		P_TEST_CHECK (info.snd_mss > 0);
+		P_TEST_CHECK (info.snd_cwnd > 0);
+	} else {
+		P_TEST_CHECK (error != NULL);
+		P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_NOT_SUPPORTED);
+		clean_error (&error);
+	}
+
+	/* TCP options don't make sense for UDP */
+	PSocket *udp_socket = p_socket_new (P_SOCKET_FAMILY_INET,
+					    P_SOCKET_TYPE_DATAGRAM,
+					    P_SOCKET_PROTOCOL_UDP,
+					    NULL);
+	P_TEST_REQUIRE (udp_socket != NULL);
+
+	P_TEST_CHECK (p_socket_set_option (udp_socket, P_SOCKET_OPTION_TCP_NODELAY, 1, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	/* Closed socket */
+	P_TEST_CHECK (p_socket_close (udp_socket, NULL) == TRUE);
+
+	P_TEST_CHECK (p_socket_get_option (udp_socket, P_SOCKET_OPTION_TCP_NODELAY, &value, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	P_TEST_CHECK (p_socket_get_tcp_info (udp_socket, &info, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	p_socket_free (udp_socket);
+	p_socket_free (tcp_accepted);
+	p_socket_free (tcp_client);
+	p_socket_free (tcp_server);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+#define PSOCKET_BATCH_CLIENTS	16
+
+P_TEST_CASE_BEGIN (psocket_batch_test)
+{
+	p_libsys_init ();
+
+	PSocketAddressStorage	storage;
+	PSocketAddress		*addr;
+	PSocket			*clients[PSOCKET_BATCH_CLIENTS];
+	PSocket			*accepted[PSOCKET_BATCH_CLIENTS];
+	PError			*error = NULL;
+	pchar			buf[8];
+	pint			total;
+	pint			ret;
+	pint			i;
+
+	/* Bad input */
+	P_TEST_CHECK (p_socket_accept_batch (NULL, accepted, 1, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	P_TEST_CHECK (p_socket_connect_batch (NULL, 1, NULL, 0, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	PSocket *server = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_STREAM,
+					P_SOCKET_PROTOCOL_TCP,
+					NULL);
+	P_TEST_REQUIRE (server != NULL);
+
+	P_TEST_CHECK (p_socket_accept_batch (server, NULL, 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_accept_batch (server, accepted, 0, NULL) == -1);
+
+	addr = p_socket_address_init (&storage, "127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+
+	p_socket_set_listen_backlog (server, PSOCKET_BATCH_CLIENTS * 2);
+
+	P_TEST_CHECK (p_socket_bind (server, addr, FALSE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_listen (server, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_get_local_address_into (server, &storage, NULL) == TRUE);
+
+	addr = p_socket_address_from_storage (&storage);
+
+	P_TEST_CHECK (p_socket_connect_batch (clients, -1, addr, 0, NULL) == -1);
+	P_TEST_CHECK (p_socket_connect_batch (clients, 1, addr, -1, NULL) == -1);
+	P_TEST_CHECK (p_socket_connect_batch (clients, 0, addr, 0, NULL) == 0);
+
+	/* Nothing to accept yet */
+	p_socket_set_blocking (server, FALSE);
+
+	P_TEST_CHECK (p_socket_accept_batch (server, accepted, PSOCKET_BATCH_CLIENTS, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_WOULD_BLOCK);
+	clean_error (&error);
+
+	p_socket_set_blocking (server, TRUE);
+	p_socket_set_timeout (server, 100);
+
+	P_TEST_CHECK (p_socket_accept_batch (server, accepted, PSOCKET_BATCH_CLIENTS, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_TIMED_OUT);
+	clean_error (&error);
+
+	/* Connect the whole pool at once */
+	for (i = 0; i < PSOCKET_BATCH_CLIENTS; ++i) {
+		clients[i] = p_socket_new (P_SOCKET_FAMILY_INET,
+					   P_SOCKET_TYPE_STREAM,
+					   P_SOCKET_PROTOCOL_TCP,
+					   NULL);
+		P_TEST_REQUIRE (clients[i] != NULL);
+	}
+
+	P_TEST_CHECK (p_socket_connect_batch (clients, PSOCKET_BATCH_CLIENTS, addr, 5000, NULL) == PSOCKET_BATCH_CLIENTS);
+
+	for (i = 0; i < PSOCKET_BATCH_CLIENTS; ++i)
+		P_TEST_CHECK (p_socket_is_connected (clients[i]) == TRUE);
+
+	/* The queue can be drained in several steps, use a small batch to check it */
+	p_socket_set_timeout (server, 2000);
+
+	for (total = 0; total < PSOCKET_BATCH_CLIENTS; total += ret) {
+		ret = p_socket_accept_batch (server, accepted + total, PSOCKET_BATCH_CLIENTS / 4, NULL);
+		P_TEST_REQUIRE (ret > 0 && ret <= PSOCKET_BATCH_CLIENTS / 4);
+	}
+
+	P_TEST_CHECK (total == PSOCKET_BATCH_CLIENTS);
+
+	for (i = 0; i < PSOCKET_BATCH_CLIENTS; ++i) {
+		P_TEST_CHECK (p_socket_get_family (accepted[i]) == P_SOCKET_FAMILY_INET);
+		P_TEST_CHECK (p_socket_get_type (accepted[i]) == P_SOCKET_TYPE_STREAM);
+		P_TEST_CHECK (p_socket_get_protocol (accepted[i]) == P_SOCKET_PROTOCOL_TCP);
+		P_TEST_CHECK (p_socket_get_blocking (accepted[i]) == TRUE);
+		P_TEST_CHECK (p_socket_is_connected (accepted[i]) == TRUE);
+		P_TEST_CHECK (p_socket_is_closed (accepted[i]) == FALSE);
+	}
+
+	/* Every accepted socket is usable */
+	for (i = 0; i < PSOCKET_BATCH_CLIENTS; ++i) {
+		buf[0] = (pchar) ('a' + i);
+		P_TEST_CHECK (p_socket_send (clients[i], buf, 1, NULL) == 1);
+	}
+
+	for (i = 0; i < PSOCKET_BATCH_CLIENTS; ++i) {
+		p_socket_set_timeout (accepted[i], 2000);
+		P_TEST_CHECK (p_socket_receive (accepted[i], buf, sizeof (buf), NULL) == 1);
+		P_TEST_CHECK (buf[0] >= 'a' && buf[0] < 'a' + PSOCKET_BATCH_CLIENTS);
+	}
+
+	for (i = 0; i < PSOCKET_BATCH_CLIENTS; ++i) {
+		p_socket_free (accepted[i]);
+		p_socket_free (clients[i]);
+	}
+
+	/* Refused connections don't fail the call */
+	p_socket_free (server);
+
+	for (i = 0; i < 4; ++i) {
+		clients[i] = p_socket_new (P_SOCKET_FAMILY_INET,
+					   P_SOCKET_TYPE_STREAM,
+					   P_SOCKET_PROTOCOL_TCP,
+					   NULL);
+		P_TEST_REQUIRE (clients[i] != NULL);
+	}
+
+	P_TEST_CHECK (p_socket_close (clients[3], NULL) == TRUE);
+
+	P_TEST_CHECK (p_socket_connect_batch (clients, 4, addr, 2000, NULL) == 0);
+
+	for (i = 0; i < 4; ++i) {
+		P_TEST_CHECK (p_socket_is_connected (clients[i]) == FALSE);
+		p_socket_free (clients[i]);
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+static pboolean test_socket_unix_exchange (PSocketAddress *addr)
+{
+	PSocket		*server;
+	PSocket		*client;
+	PSocket		*accepted;
+	pchar		buf[16];
+	pchar		str_addr[P_SOCKET_ADDRESS_MAX_STRING_LEN];
+	pchar		expected[P_SOCKET_ADDRESS_MAX_STRING_LEN];
+	pboolean	ret;
+
+	server   = p_socket_new (P_SOCKET_FAMILY_UNIX, P_SOCKET_TYPE_STREAM, P_SOCKET_PROTOCOL_DEFAULT, NULL);
+	client   = p_socket_new (P_SOCKET_FAMILY_UNIX, P_SOCKET_TYPE_STREAM, P_SOCKET_PROTOCOL_DEFAULT, NULL);
+	accepted = NULL;
+	ret      = FALSE;
+
+	if (server == NULL || client == NULL)
+		goto out;
+
+	p_socket_set_timeout (server, 2000);
+	p_socket_set_timeout (client, 2000);
+
+	if (p_socket_bind (server, addr, FALSE, NULL) == FALSE ||
+	    p_socket_listen (server, NULL) == FALSE ||
+	    p_socket_connect (client, addr, NULL) == FALSE ||
+	    (accepted = p_socket_accept (server, NULL)) == NULL)
+		goto out;
+
+	p_socket_set_timeout (accepted, 2000);
+
+	if (p_socket_get_family (accepted) != P_SOCKET_FAMILY_UNIX ||
+	    p_socket_send (client, "unix", 4, NULL) != 4 ||
+	    p_socket_receive (accepted, buf, sizeof (buf), NULL) != 4 ||
+	    strncmp (buf, "unix", 4) != 0)
+		goto out;
+
+	/* Bound socket reports the same name */
+	PSocketAddressStorage	storage;
+
+	if (p_socket_get_local_address_into (server, &storage, NULL) == FALSE ||
+	    p_socket_address_get_address_into (p_socket_address_from_storage (&storage),
+					       str_addr,
+					       sizeof (str_addr)) == FALSE ||
+	    p_socket_address_get_address_into (addr, expected, sizeof (expected)) == FALSE)
+		goto out;
+
+	ret = strcmp (str_addr, expected) == 0;
+
+out:
+	p_socket_free (accepted);
+	p_socket_free (client);
+	p_socket_free (server);
+
+	return ret;
+}
+
+static void test_socket_unix (void)
+{
+	PSocket		*first;
+	PSocket		*second;
+	PSocket		*other_first;
+	PSocket		*other_second;
+	PSocket		*passed;
+	PError		*error = NULL;
+	pchar		buf[16];
+	pchar		str_addr[P_SOCKET_ADDRESS_MAX_STRING_LEN];
+	pint		fds[4];
+	pint		count;
+
+	if (p_socket_address_is_unix_supported () == FALSE) {
+		P_TEST_CHECK (p_socket_new_pair (P_SOCKET_TYPE_STREAM, &first, &second, &error) == FALSE);
+		P_TEST_CHECK (error != NULL);
+		clean_error (&error);
+		return;
+	}
+
+	/* Bad input */
+	P_TEST_CHECK (p_socket_new_pair (P_SOCKET_TYPE_STREAM, NULL, &second, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	P_TEST_CHECK (p_socket_new_pair (P_SOCKET_TYPE_UNKNOWN, &first, &second, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	count = 1;
+
+	P_TEST_CHECK (p_socket_send_fds (NULL, "x", 1, fds, 1, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	P_TEST_CHECK (p_socket_receive_fds (NULL, buf, sizeof (buf), fds, &count, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	clean_error (&error);
+
+	/* Connected pair */
+	P_TEST_REQUIRE (p_socket_new_pair (P_SOCKET_TYPE_STREAM, &first, &second, NULL) == TRUE);
+	P_TEST_REQUIRE (p_socket_new_pair (P_SOCKET_TYPE_STREAM, &other_first, &other_second, NULL) == TRUE);
+
+	p_socket_set_timeout (first, 2000);
+	p_socket_set_timeout (second, 2000);
+	p_socket_set_timeout (other_second, 2000);
+
+	P_TEST_CHECK (p_socket_get_family (first) == P_SOCKET_FAMILY_UNIX);
+	P_TEST_CHECK (p_socket_get_type (first) == P_SOCKET_TYPE_STREAM);
+	P_TEST_CHECK (p_socket_is_connected (first) == TRUE);
+	P_TEST_CHECK (p_socket_get_blocking (first) == TRUE);
+
+	PSocketAddress *local_addr = p_socket_get_local_address (first, NULL);
+
+	P_TEST_REQUIRE (local_addr != NULL);
+	P_TEST_CHECK (p_socket_address_get_family (local_addr) == P_SOCKET_FAMILY_UNIX);
+	P_TEST_CHECK (p_socket_address_get_address_into (local_addr, str_addr, sizeof (str_addr)) == TRUE);
+	P_TEST_CHECK (str_addr[0] == '\0');
+
+	p_socket_address_free (local_addr);
+
+	P_TEST_CHECK (p_socket_send (first, "pair", 4, NULL) == 4);
+	P_TEST_CHECK (p_socket_receive (second, buf, sizeof (buf), NULL) == 4);
+	P_TEST_CHECK (strncmp (buf, "pair", 4) == 0);
+
+	P_TEST_CHECK (p_socket_send_fds (first, "x", 1, fds, P_SOCKET_MAX_PASSED_FDS + 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_send_fds (first, "x", 1, NULL, 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_send_fds (first, "x", 0, fds, 1, NULL) == -1);
+
+	/* Pass a socket of another pair and talk through it */
+	fds[0] = p_socket_get_fd (other_first);
+
+	P_TEST_CHECK (p_socket_send_fds (first, "fd", 2, fds, 1, NULL) == 2);
+
+	p_socket_free (other_first);
+
+	fds[0] = -1;
+	count  = 4;
+
+	P_TEST_CHECK (p_socket_receive_fds (second, buf, sizeof (buf), fds, &count, NULL) == 2);
+	P_TEST_CHECK (strncmp (buf, "fd", 2) == 0);
+	P_TEST_REQUIRE (count == 1);
+	P_TEST_REQUIRE (fds[0] >= 0);
+
+	passed = p_socket_new_from_fd (fds[0], NULL);
+
+	P_TEST_REQUIRE (passed != NULL);
+	P_TEST_CHECK (p_socket_get_family (passed) == P_SOCKET_FAMILY_UNIX);
+	P_TEST_CHECK (p_socket_send (passed, "passed", 6, NULL) == 6);
+	P_TEST_CHECK (p_socket_receive (other_second, buf, sizeof (buf), NULL) == 6);
+	P_TEST_CHECK (strncmp (buf, "passed", 6) == 0);
+
+	p_socket_free (passed);
+
+	/* Plain data without descriptors */
+	count = 4;
+
+	P_TEST_CHECK (p_socket_send_fds (first, "data", 4, NULL, 0, NULL) == 4);
+	P_TEST_CHECK (p_socket_receive_fds (second, buf, sizeof (buf), fds, &count, NULL) == 4);
+	P_TEST_CHECK (count == 0);
+
+	p_socket_free (other_second);
+	p_socket_free (second);
+	p_socket_free (first);
+
+	/* Descriptors can't be passed through a network socket */
+	PSocket *tcp_socket = p_socket_new (P_SOCKET_FAMILY_INET,
+					    P_SOCKET_TYPE_STREAM,
+					    P_SOCKET_PROTOCOL_TCP,
+					    NULL);
+	P_TEST_REQUIRE (tcp_socket != NULL);
+
+	P_TEST_CHECK (p_socket_send_fds (tcp_socket, "x", 1, NULL, 0, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+	clean_error (&error);
+
+	p_socket_free (tcp_socket);
+
+	/* Listening on a file system path */
+	p_file_remove (PSOCKET_UNIX_TEST_PATH, NULL);
+
+	PSocketAddress *addr = p_socket_address_new_unix (PSOCKET_UNIX_TEST_PATH, FALSE);
+
+	P_TEST_REQUIRE (addr != NULL);
+	P_TEST_CHECK (test_socket_unix_exchange (addr) == TRUE);
+	P_TEST_CHECK (p_file_is_exists (PSOCKET_UNIX_TEST_PATH) == TRUE);
+	P_TEST_CHECK (p_file_remove (PSOCKET_UNIX_TEST_PATH, NULL) == TRUE);
+
+	p_socket_address_free (addr);
+
+	/* Listening in the abstract namespace */
+	if (p_socket_address_is_abstract_supported ()) {
+		addr = p_socket_address_new_unix ("plibsys-psocket-test", TRUE);
+
+		P_TEST_REQUIRE (addr != NULL);
+		P_TEST_CHECK (test_socket_unix_exchange (addr) == TRUE);
+
+		p_socket_address_free (addr);
+	}
+}
+
+P_TEST_CASE_BEGIN (psocket_unix_test)
+{
+	p_libsys_init ();
+
+	test_socket_unix ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (psocket_nomem_test);
@@ -1125,5 +2077,10 @@ P_TEST_SUITE_BEGIN()
 	P_TEST_SUITE_RUN_CASE (psocket_udp_test);
 	P_TEST_SUITE_RUN_CASE (psocket_tcp_test);
 	P_TEST_SUITE_RUN_CASE (psocket_shutdown_test);
+	P_TEST_SUITE_RUN_CASE (psocket_address_into_test);
+	P_TEST_SUITE_RUN_CASE (psocket_send_file_test);
+	P_TEST_SUITE_RUN_CASE (psocket_options_test);
+	P_TEST_SUITE_RUN_CASE (psocket_batch_test);
+	P_TEST_SUITE_RUN_CASE (psocket_unix_test);
 }
 P_TEST_SUITE_END()
@@ -0,0 +1,266 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+P_TEST_MODULE_INIT ();
+
+#define PSOCKETACCEPTOR_WORKERS	4
+#define PSOCKETACCEPTOR_CLIENTS	32
+
+static volatile pint	accepted_count;
+static volatile pint	worker_mask;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void acceptor_test_func (PSocket *socket, pint worker, ppointer user_data)
+{
+	pchar	buf[8];
+	pint	mask;
+
+	P_UNUSED (user_data);
+
+	/* Echo a byte back to show the connection is alive */
+	p_socket_set_timeout (socket, 2000);
+
+	if (p_socket_receive (socket, buf, 1, NULL) == 1)
+		p_socket_send (socket, buf, 1, NULL);
+
+	do {
+		mask = p_atomic_int_get (&worker_mask);
+	} while (p_atomic_int_compare_and_exchange (&worker_mask, mask, mask | (1 << worker)) == FALSE);
+
+	p_atomic_int_inc (&accepted_count);
+
+	p_socket_free (socket);
+}
+
+static pboolean acceptor_test_connect (PSocketAddress *addr, pint count)
+{
+	pchar	buf[8];
+	pint	i;
+
+	for (i = 0; i < count; ++i) {
+		PSocket *client = p_socket_new (p_socket_address_get_family (addr),
+						P_SOCKET_TYPE_STREAM,
+						P_SOCKET_PROTOCOL_TCP,
+						NULL);
+
+		if (client == NULL)
+			return FALSE;
+
+		p_socket_set_timeout (client, 2000);
+
+		if (p_socket_connect (client, addr, NULL) == FALSE ||
+		    p_socket_send (client, "x", 1, NULL) != 1 ||
+		    p_socket_receive (client, buf, sizeof (buf), NULL) != 1 ||
+		    buf[0] != 'x') {
+			p_socket_free (client);
+			return FALSE;
+		}
+
+		p_socket_free (client);
+	}
+
+	return TRUE;
+}
+
+static pboolean acceptor_test_wait (pint expected)
+{
+	pint i;
+
+	for (i = 0; i < 200 && p_atomic_int_get (&accepted_count) < expected; ++i)
+		p_uthread_sleep (10);
+
+	return p_atomic_int_get (&accepted_count) == expected;
+}
+
+P_TEST_CASE_BEGIN (psocketacceptor_nomem_test)
+{
+	p_libsys_init ();
+
+	PSocketAddress *addr = p_socket_address_new ("127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+
+	PMemVTable vtable;
+
+	vtable.f_free    = pmem_free;
+	vtable.f_malloc  = pmem_alloc;
+	vtable.f_realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_socket_acceptor_new (addr, 2, NULL) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_socket_address_free (addr);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketacceptor_bad_input_test)
+{
+	p_libsys_init ();
+
+	PError *error = NULL;
+
+	P_TEST_CHECK (p_socket_acceptor_new (NULL, 1, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_socket_acceptor_set_cpu_steering (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_acceptor_start (NULL, acceptor_test_func, NULL, FALSE, NULL) == FALSE);
+	P_TEST_CHECK (p_socket_acceptor_get_workers (NULL) == 0);
+	P_TEST_CHECK (p_socket_acceptor_get_listeners (NULL) == 0);
+	P_TEST_CHECK (p_socket_acceptor_get_listener (NULL, 0) == NULL);
+
+	p_socket_acceptor_stop (NULL);
+	p_socket_acceptor_free (NULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketacceptor_general_test)
+{
+	p_libsys_init ();
+
+	PSocketAddressStorage	storage;
+	PSocketAcceptor		*acceptor;
+	PSocketAddress		*addr;
+	PError			*error = NULL;
+	pint			listeners;
+	pint			i;
+
+	addr = p_socket_address_init (&storage, "127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+
+	acceptor = p_socket_acceptor_new (addr, PSOCKETACCEPTOR_WORKERS, NULL);
+	P_TEST_REQUIRE (acceptor != NULL);
+
+	listeners = p_socket_acceptor_get_listeners (acceptor);
+
+	P_TEST_CHECK (p_socket_acceptor_get_workers (acceptor) == PSOCKETACCEPTOR_WORKERS);
+	P_TEST_CHECK (listeners == 1 || listeners == PSOCKETACCEPTOR_WORKERS);
+	P_TEST_CHECK (p_socket_acceptor_get_listener (acceptor, -1) == NULL);
+	P_TEST_CHECK (p_socket_acceptor_get_listener (acceptor, listeners) == NULL);
+	P_TEST_CHECK (p_socket_acceptor_start (acceptor, NULL, NULL, FALSE, NULL) == FALSE);
+
+	/* All the listeners share the same port */
+	P_TEST_REQUIRE (p_socket_get_local_address_into (p_socket_acceptor_get_listener (acceptor, 0),
+							 &storage,
+							 NULL) == TRUE);
+
+	addr = p_socket_address_from_storage (&storage);
+	P_TEST_CHECK (p_socket_address_get_port (addr) != 0);
+
+	for (i = 1; i < listeners; ++i) {
+		PSocketAddress *local = p_socket_get_local_address (p_socket_acceptor_get_listener (acceptor, i),
+								    NULL);
+		P_TEST_REQUIRE (local != NULL);
+		P_TEST_CHECK (p_socket_address_get_port (local) == p_socket_address_get_port (addr));
+		p_socket_address_free (local);
+	}
+
+	/* Steering is optional */
+	if (p_socket_acceptor_set_cpu_steering (acceptor, &error) == FALSE) {
+		P_TEST_CHECK (error != NULL);
+		p_error_free (error);
+		error = NULL;
+	}
+
+	/* Connections queued before the start must be accepted as well */
+	p_atomic_int_set (&accepted_count, 0);
+	p_atomic_int_set (&worker_mask, 0);
+
+	PSocket *early = p_socket_new (P_SOCKET_FAMILY_INET, P_SOCKET_TYPE_STREAM, P_SOCKET_PROTOCOL_TCP, NULL);
+	P_TEST_REQUIRE (early != NULL);
+	P_TEST_CHECK (p_socket_connect (early, addr, NULL) == TRUE);
+
+	P_TEST_CHECK (p_socket_acceptor_start (acceptor, acceptor_test_func, NULL, TRUE, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_acceptor_start (acceptor, acceptor_test_func, NULL, TRUE, &error) == FALSE);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	p_socket_free (early);
+	P_TEST_CHECK (acceptor_test_wait (1) == TRUE);
+
+	P_TEST_CHECK (acceptor_test_connect (addr, PSOCKETACCEPTOR_CLIENTS) == TRUE);
+	P_TEST_CHECK (acceptor_test_wait (PSOCKETACCEPTOR_CLIENTS + 1) == TRUE);
+	P_TEST_CHECK (p_atomic_int_get (&worker_mask) != 0);
+	P_TEST_CHECK ((p_atomic_int_get (&worker_mask) & ~((1 << PSOCKETACCEPTOR_WORKERS) - 1)) == 0);
+
+	/* Restart without pinning */
+	p_socket_acceptor_stop (acceptor);
+	p_socket_acceptor_stop (acceptor);
+
+	P_TEST_CHECK (p_socket_acceptor_start (acceptor, acceptor_test_func, NULL, FALSE, NULL) == TRUE);
+	P_TEST_CHECK (acceptor_test_connect (addr, PSOCKETACCEPTOR_CLIENTS) == TRUE);
+	P_TEST_CHECK (acceptor_test_wait (2 * PSOCKETACCEPTOR_CLIENTS + 1) == TRUE);
+
+	p_socket_acceptor_free (acceptor);
+
+	/* Default number of workers */
+	addr = p_socket_address_init (&storage, "127.0.0.1", 0);
+	P_TEST_REQUIRE (addr != NULL);
+
+	acceptor = p_socket_acceptor_new (addr, 0, NULL);
+	P_TEST_REQUIRE (acceptor != NULL);
+	P_TEST_CHECK (p_socket_acceptor_get_workers (acceptor) == p_uthread_ideal_count ());
+
+	p_socket_acceptor_free (acceptor);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (psocketacceptor_nomem_test);
+	P_TEST_SUITE_RUN_CASE (psocketacceptor_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (psocketacceptor_general_test);
+}
+P_TEST_SUITE_END()
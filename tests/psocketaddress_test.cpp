@@ -95,11 +95,23 @@ P_TEST_CASE_BEGIN (psocketaddress_nomem_test)
 	P_TEST_CHECK (p_socket_address_new ("192.168.0.1", 1058) == NULL);
 	P_TEST_CHECK (p_socket_address_new_any (P_SOCKET_FAMILY_INET, 1058) == NULL);
 	P_TEST_CHECK (p_socket_address_new_loopback (P_SOCKET_FAMILY_INET, 1058) == NULL);
+	P_TEST_CHECK (p_socket_address_new_unix ("/tmp/plibsys.sock", FALSE) == NULL);
 	P_TEST_CHECK (p_socket_address_new_from_native (addr_buf, native_size) == NULL);
 
 	if (p_socket_address_is_ipv6_supported ())
 		P_TEST_CHECK (p_socket_address_new_from_native (addr_buf6, native_size6) == NULL);
 
+	/* Caller-owned storage doesn't need any memory */
+	PSocketAddressStorage	storage;
+	pchar			str_addr[P_SOCKET_ADDRESS_MAX_STRING_LEN];
+
+	P_TEST_CHECK (p_socket_address_init (&storage, "192.168.0.1", 1058) != NULL);
+	P_TEST_CHECK (p_socket_address_init_from_native (&storage, addr_buf, native_size) != NULL);
+	P_TEST_CHECK (p_socket_address_get_address_into (p_socket_address_from_storage (&storage),
+							 str_addr,
+							 sizeof (str_addr)) == TRUE);
+	P_TEST_CHECK (strcmp (str_addr, "192.168.0.1") == 0);
+
 	p_mem_restore_vtable ();
 
 	P_TEST_CHECK (p_socket_address_new_from_native (addr_buf, native_size - 1) == NULL);
@@ -134,6 +146,18 @@ P_TEST_CASE_BEGIN (psocketaddress_bad_input_test)
 	P_TEST_CHECK (p_socket_address_is_any (NULL) == FALSE);
 	P_TEST_CHECK (p_socket_address_is_loopback (NULL) == FALSE);
 
+	PSocketAddressStorage	storage;
+	pchar			str_addr[P_SOCKET_ADDRESS_MAX_STRING_LEN];
+
+	P_TEST_CHECK (p_socket_address_init (NULL, "192.168.0.1", 0) == NULL);
+	P_TEST_CHECK (p_socket_address_init (&storage, NULL, 0) == NULL);
+	P_TEST_CHECK (p_socket_address_init (&storage, "bad_address", 0) == NULL);
+	P_TEST_CHECK (p_socket_address_init_from_native (NULL, NULL, 0) == NULL);
+	P_TEST_CHECK (p_socket_address_init_from_native (&storage, NULL, 0) == NULL);
+	P_TEST_CHECK (p_socket_address_copy_into (NULL, &storage) == NULL);
+	P_TEST_CHECK (p_socket_address_copy_into (NULL, NULL) == NULL);
+	P_TEST_CHECK (p_socket_address_get_address_into (NULL, str_addr, sizeof (str_addr)) == FALSE);
+
 	p_socket_address_set_flow_info (NULL, 0);
 	p_socket_address_set_scope_id (NULL, 0);
 	p_socket_address_free (NULL);
@@ -329,10 +353,183 @@ P_TEST_CASE_BEGIN (psocketaddress_general_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (psocketaddress_storage_test)
+{
+	p_libsys_init ();
+
+	PSocketAddressStorage	storage;
+	PSocketAddressStorage	copy_storage;
+	pchar			str_addr[P_SOCKET_ADDRESS_MAX_STRING_LEN];
+
+	/* IPv4 */
+	PSocketAddress *addr = p_socket_address_init (&storage, "172.146.45.5", 5432);
+
+	P_TEST_REQUIRE (addr != NULL);
+	P_TEST_CHECK (addr == p_socket_address_from_storage (&storage));
+	P_TEST_CHECK (p_socket_address_get_family (addr) == P_SOCKET_FAMILY_INET);
+	P_TEST_CHECK (p_socket_address_get_port (addr) == 5432);
+	P_TEST_CHECK (p_socket_address_get_address_into (addr, str_addr, sizeof (str_addr)) == TRUE);
+	P_TEST_CHECK (strcmp (str_addr, "172.146.45.5") == 0);
+
+	/* Buffer is too small for the address string */
+	P_TEST_CHECK (p_socket_address_get_address_into (addr, str_addr, 12) == FALSE);
+	P_TEST_CHECK (p_socket_address_get_address_into (addr, str_addr, 13) == TRUE);
+	P_TEST_CHECK (strcmp (str_addr, "172.146.45.5") == 0);
+
+	/* Copy and native conversion round trip */
+	PSocketAddress *copy = p_socket_address_copy_into (addr, &copy_storage);
+
+	P_TEST_REQUIRE (copy != NULL);
+	P_TEST_CHECK (p_socket_address_get_port (copy) == 5432);
+
+	psize native_size = p_socket_address_get_native_size (copy);
+	ppointer native   = p_malloc0 (native_size);
+
+	P_TEST_REQUIRE (native != NULL);
+	P_TEST_CHECK (p_socket_address_to_native (copy, native, native_size) == TRUE);
+
+	addr = p_socket_address_init_from_native (&storage, native, native_size);
+
+	P_TEST_REQUIRE (addr != NULL);
+	P_TEST_CHECK (p_socket_address_get_family (addr) == P_SOCKET_FAMILY_INET);
+	P_TEST_CHECK (p_socket_address_get_port (addr) == 5432);
+	P_TEST_CHECK (p_socket_address_init_from_native (&storage, native, native_size - 1) == NULL);
+
+	p_free (native);
+
+	/* Heap-allocated address can be copied into a storage as well */
+	PSocketAddress *heap_addr = p_socket_address_new_loopback (P_SOCKET_FAMILY_INET, 80);
+
+	P_TEST_REQUIRE (heap_addr != NULL);
+
+	copy = p_socket_address_copy_into (heap_addr, &copy_storage);
+	p_socket_address_free (heap_addr);
+
+	P_TEST_CHECK (p_socket_address_is_loopback (copy) == TRUE);
+	P_TEST_CHECK (p_socket_address_get_port (copy) == 80);
+
+	if (p_socket_address_is_ipv6_supported ()) {
+		addr = p_socket_address_init (&storage, "2001:cdba:345f:24ab:fe45:5423:3257:9652", 2345);
+
+		P_TEST_REQUIRE (addr != NULL);
+		P_TEST_CHECK (p_socket_address_get_family (addr) == P_SOCKET_FAMILY_INET6);
+		P_TEST_CHECK (p_socket_address_get_port (addr) == 2345);
+		P_TEST_CHECK (p_socket_address_get_address_into (addr, str_addr, sizeof (str_addr)) == TRUE);
+		P_TEST_CHECK (strcmp (str_addr, "2001:cdba:345f:24ab:fe45:5423:3257:9652") == 0);
+	}
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+static void socket_address_test_unix (void)
+{
+	PSocketAddressStorage	storage;
+	pchar			str_addr[P_SOCKET_ADDRESS_MAX_STRING_LEN];
+	pchar			long_path[200];
+
+	if (p_socket_address_is_unix_supported () == FALSE) {
+		P_TEST_CHECK (p_socket_address_new_unix ("/tmp/plibsys.sock", FALSE) == NULL);
+		return;
+	}
+
+	P_TEST_CHECK (p_socket_address_new_unix (NULL, FALSE) == NULL);
+	P_TEST_CHECK (p_socket_address_new_unix ("", FALSE) == NULL);
+	P_TEST_CHECK (p_socket_address_init_unix (NULL, "/tmp/plibsys.sock", FALSE) == NULL);
+	P_TEST_CHECK (p_socket_address_init_unix (&storage, NULL, FALSE) == NULL);
+	P_TEST_CHECK (p_socket_address_is_abstract (NULL) == FALSE);
+
+	/* Path is too long */
+	memset (long_path, 'a', sizeof (long_path) - 1);
+	long_path[sizeof (long_path) - 1] = '\0';
+
+	P_TEST_CHECK (p_socket_address_new_unix (long_path, FALSE) == NULL);
+	P_TEST_CHECK (p_socket_address_new_unix (long_path, TRUE) == NULL);
+
+	/* File system path */
+	PSocketAddress *addr = p_socket_address_new_unix ("/tmp/plibsys.sock", FALSE);
+
+	P_TEST_REQUIRE (addr != NULL);
+	P_TEST_CHECK (p_socket_address_get_family (addr) == P_SOCKET_FAMILY_UNIX);
+	P_TEST_CHECK (p_socket_address_get_port (addr) == 0);
+	P_TEST_CHECK (p_socket_address_is_abstract (addr) == FALSE);
+	P_TEST_CHECK (p_socket_address_is_any (addr) == FALSE);
+	P_TEST_CHECK (p_socket_address_is_loopback (addr) == FALSE);
+	P_TEST_CHECK (p_socket_address_new_any (P_SOCKET_FAMILY_UNIX, 0) == NULL);
+	P_TEST_CHECK (p_socket_address_new_loopback (P_SOCKET_FAMILY_UNIX, 0) == NULL);
+
+	pchar *path = p_socket_address_get_address (addr);
+
+	P_TEST_REQUIRE (path != NULL);
+	P_TEST_CHECK (strcmp (path, "/tmp/plibsys.sock") == 0);
+	p_free (path);
+
+	P_TEST_CHECK (p_socket_address_get_address_into (addr, str_addr, 17) == FALSE);
+	P_TEST_CHECK (p_socket_address_get_address_into (addr, str_addr, 18) == TRUE);
+	P_TEST_CHECK (strcmp (str_addr, "/tmp/plibsys.sock") == 0);
+
+	/* Native conversion round trip */
+	psize native_size = p_socket_address_get_native_size (addr);
+	ppointer native   = p_malloc0 (sizeof (PSocketAddressStorage));
+
+	P_TEST_REQUIRE (native != NULL);
+	P_TEST_CHECK (native_size > strlen ("/tmp/plibsys.sock"));
+	P_TEST_CHECK (p_socket_address_to_native (addr, native, 4) == FALSE);
+	P_TEST_CHECK (p_socket_address_to_native (addr, native, sizeof (PSocketAddressStorage)) == TRUE);
+
+	PSocketAddress *native_addr = p_socket_address_init_from_native (&storage, native, native_size);
+
+	P_TEST_REQUIRE (native_addr != NULL);
+	P_TEST_CHECK (p_socket_address_get_family (native_addr) == P_SOCKET_FAMILY_UNIX);
+	P_TEST_CHECK (p_socket_address_get_address_into (native_addr, str_addr, sizeof (str_addr)) == TRUE);
+	P_TEST_CHECK (strcmp (str_addr, "/tmp/plibsys.sock") == 0);
+
+	p_socket_address_free (addr);
+
+	/* Abstract namespace */
+	addr = p_socket_address_init_unix (&storage, "plibsys-abstract", TRUE);
+
+	if (p_socket_address_is_abstract_supported ()) {
+		P_TEST_REQUIRE (addr != NULL);
+		P_TEST_CHECK (p_socket_address_get_family (addr) == P_SOCKET_FAMILY_UNIX);
+		P_TEST_CHECK (p_socket_address_is_abstract (addr) == TRUE);
+		P_TEST_CHECK (p_socket_address_get_address_into (addr, str_addr, sizeof (str_addr)) == TRUE);
+		P_TEST_CHECK (strcmp (str_addr, "@plibsys-abstract") == 0);
+
+		native_size = p_socket_address_get_native_size (addr);
+
+		P_TEST_CHECK (p_socket_address_to_native (addr, native, sizeof (PSocketAddressStorage)) == TRUE);
+
+		addr = p_socket_address_new_from_native (native, native_size);
+
+		P_TEST_REQUIRE (addr != NULL);
+		P_TEST_CHECK (p_socket_address_is_abstract (addr) == TRUE);
+		P_TEST_CHECK (p_socket_address_get_address_into (addr, str_addr, sizeof (str_addr)) == TRUE);
+		P_TEST_CHECK (strcmp (str_addr, "@plibsys-abstract") == 0);
+
+		p_socket_address_free (addr);
+	} else
+		P_TEST_CHECK (addr == NULL);
+
+	p_free (native);
+}
+
+P_TEST_CASE_BEGIN (psocketaddress_unix_test)
+{
+	p_libsys_init ();
+
+	socket_address_test_unix ();
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (psocketaddress_nomem_test);
 	P_TEST_SUITE_RUN_CASE (psocketaddress_bad_input_test);
 	P_TEST_SUITE_RUN_CASE (psocketaddress_general_test);
+	P_TEST_SUITE_RUN_CASE (psocketaddress_storage_test);
+	P_TEST_SUITE_RUN_CASE (psocketaddress_unix_test);
 }
 P_TEST_SUITE_END()
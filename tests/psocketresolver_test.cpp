@@ -0,0 +1,365 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+static volatile pint callback_count = 0;
+static volatile pint callback_addrs = 0;
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static void free_address_list (PList *list)
+{
+	p_list_foreach (list, (PFunc) p_socket_address_free, NULL);
+	p_list_free (list);
+}
+
+static bool check_address_list (PList *list, puint16 port, PSocketFamily family)
+{
+	if (list == NULL)
+		return false;
+
+	for (PList *iter = list; iter != NULL; iter = iter->next) {
+		PSocketAddress *addr = (PSocketAddress *) iter->data;
+
+		if (p_socket_address_get_port (addr) != port)
+			return false;
+
+		if (family != P_SOCKET_FAMILY_UNKNOWN && p_socket_address_get_family (addr) != family)
+			return false;
+	}
+
+	return true;
+}
+
+static void resolve_callback (PSocketResolveRequest *request, ppointer user_data)
+{
+	PList *result = p_socket_resolve_request_take_result (request, NULL);
+
+	if (check_address_list (result, 8080, P_SOCKET_FAMILY_UNKNOWN))
+		p_atomic_int_add (&callback_addrs, (pint) p_list_length (result));
+
+	free_address_list (result);
+
+	if (user_data != NULL)
+		p_socket_resolve_request_free (request);
+
+	p_atomic_int_inc (&callback_count);
+}
+
+P_TEST_CASE_BEGIN (psocketresolver_nomem_test)
+{
+	p_libsys_init ();
+
+	PSocketResolver *resolver = p_socket_resolver_new (1, 1000, NULL);
+	P_TEST_REQUIRE (resolver != NULL);
+
+	PMemVTable vtable;
+
+	vtable.f_free    = pmem_free;
+	vtable.f_malloc  = pmem_alloc;
+	vtable.f_realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+
+	P_TEST_CHECK (p_socket_resolver_new (1, 1000, NULL) == NULL);
+	P_TEST_CHECK (p_socket_resolver_lookup (resolver, "127.0.0.1", 80, P_SOCKET_FAMILY_UNKNOWN, NULL) == NULL);
+	P_TEST_CHECK (p_socket_resolver_lookup_async (resolver,
+						      "127.0.0.1",
+						      80,
+						      P_SOCKET_FAMILY_UNKNOWN,
+						      NULL,
+						      NULL,
+						      NULL) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_socket_resolver_free (resolver);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketresolver_bad_input_test)
+{
+	p_libsys_init ();
+
+	PError *error = NULL;
+
+	P_TEST_CHECK (p_socket_resolver_new (-1, 0, &error) == NULL);
+	P_TEST_CHECK (error != NULL && p_error_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_socket_resolver_lookup (NULL, "localhost", 80, P_SOCKET_FAMILY_UNKNOWN, &error) == NULL);
+	P_TEST_CHECK (error != NULL && p_error_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_socket_resolver_lookup_async (NULL,
+						      "localhost",
+						      80,
+						      P_SOCKET_FAMILY_UNKNOWN,
+						      NULL,
+						      NULL,
+						      &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_socket_resolve_request_take_result (NULL, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+
+	P_TEST_CHECK (p_socket_resolve_request_is_done (NULL) == FALSE);
+
+	p_socket_resolve_request_wait (NULL);
+	p_socket_resolve_request_free (NULL);
+	p_socket_resolver_clear_cache (NULL);
+	p_socket_resolver_free (NULL);
+
+	PSocketResolver *resolver = p_socket_resolver_new (0, 0, NULL);
+	P_TEST_REQUIRE (resolver != NULL);
+
+	error = NULL;
+
+	P_TEST_CHECK (p_socket_resolver_lookup (resolver, NULL, 80, P_SOCKET_FAMILY_UNKNOWN, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	P_TEST_CHECK (p_socket_resolver_lookup (resolver, "", 80, P_SOCKET_FAMILY_UNKNOWN, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+	error = NULL;
+
+	/* Numeric address of the other family */
+	P_TEST_CHECK (p_socket_resolver_lookup (resolver, "127.0.0.1", 80, P_SOCKET_FAMILY_INET6, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	p_error_free (error);
+
+	p_socket_resolver_free (resolver);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketresolver_lookup_test)
+{
+	p_libsys_init ();
+
+	PSocketResolver *resolver = p_socket_resolver_new (1, P_SOCKET_RESOLVER_DEFAULT_TTL, NULL);
+	P_TEST_REQUIRE (resolver != NULL);
+
+	/* Numeric address */
+	PList *result = p_socket_resolver_lookup (resolver, "127.0.0.1", 5432, P_SOCKET_FAMILY_UNKNOWN, NULL);
+	P_TEST_REQUIRE (result != NULL);
+	P_TEST_CHECK (p_list_length (result) == 1);
+	P_TEST_CHECK (check_address_list (result, 5432, P_SOCKET_FAMILY_INET));
+
+	pchar *str_addr = p_socket_address_get_address ((PSocketAddress *) result->data);
+	P_TEST_CHECK (str_addr != NULL && strcmp (str_addr, "127.0.0.1") == 0);
+	p_free (str_addr);
+
+	free_address_list (result);
+
+	/* Host name, resolved and then taken from the cache with another port */
+	PError *error = NULL;
+
+	result = p_socket_resolver_lookup (resolver, "localhost", 80, P_SOCKET_FAMILY_INET, &error);
+	P_TEST_REQUIRE (result != NULL);
+	P_TEST_CHECK (error == NULL);
+	P_TEST_CHECK (check_address_list (result, 80, P_SOCKET_FAMILY_INET));
+
+	psize count = p_list_length (result);
+	free_address_list (result);
+
+	result = p_socket_resolver_lookup (resolver, "localhost", 8080, P_SOCKET_FAMILY_INET, NULL);
+	P_TEST_REQUIRE (result != NULL);
+	P_TEST_CHECK (p_list_length (result) == count);
+	P_TEST_CHECK (check_address_list (result, 8080, P_SOCKET_FAMILY_INET));
+	free_address_list (result);
+
+	p_socket_resolver_clear_cache (resolver);
+
+	result = p_socket_resolver_lookup (resolver, "localhost", 8080, P_SOCKET_FAMILY_UNKNOWN, NULL);
+	P_TEST_REQUIRE (result != NULL);
+	P_TEST_CHECK (check_address_list (result, 8080, P_SOCKET_FAMILY_UNKNOWN));
+	free_address_list (result);
+
+	p_socket_resolver_free (resolver);
+
+	/* No caching at all */
+	resolver = p_socket_resolver_new (1, 0, NULL);
+	P_TEST_REQUIRE (resolver != NULL);
+
+	for (pint i = 0; i < 2; ++i) {
+		result = p_socket_resolver_lookup (resolver, "localhost", 22, P_SOCKET_FAMILY_INET, NULL);
+		P_TEST_CHECK (check_address_list (result, 22, P_SOCKET_FAMILY_INET));
+		free_address_list (result);
+	}
+
+	p_socket_resolver_free (resolver);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketresolver_async_test)
+{
+	p_libsys_init ();
+
+	PSocketResolver *resolver = p_socket_resolver_new (2, P_SOCKET_RESOLVER_DEFAULT_TTL, NULL);
+	P_TEST_REQUIRE (resolver != NULL);
+
+	/* Polling */
+	PSocketResolveRequest *request = p_socket_resolver_lookup_async (resolver,
+									 "localhost",
+									 443,
+									 P_SOCKET_FAMILY_INET,
+									 NULL,
+									 NULL,
+									 NULL);
+	P_TEST_REQUIRE (request != NULL);
+
+	p_socket_resolve_request_wait (request);
+	P_TEST_CHECK (p_socket_resolve_request_is_done (request) == TRUE);
+
+	PList *result = p_socket_resolve_request_take_result (request, NULL);
+	P_TEST_CHECK (check_address_list (result, 443, P_SOCKET_FAMILY_INET));
+	free_address_list (result);
+
+	PError *error = NULL;
+
+	P_TEST_CHECK (p_socket_resolve_request_take_result (request, &error) == NULL);
+	P_TEST_CHECK (error != NULL && p_error_get_code (error) == (pint) P_ERROR_IO_NO_MORE);
+	p_error_free (error);
+
+	p_socket_resolve_request_free (request);
+
+	/* Callbacks, the request is freed either by the callback or by the caller */
+	p_atomic_int_set (&callback_count, 0);
+	p_atomic_int_set (&callback_addrs, 0);
+
+	PSocketResolveRequest *requests[8];
+
+	for (pint i = 0; i < 8; ++i) {
+		requests[i] = p_socket_resolver_lookup_async (resolver,
+							      i % 2 == 0 ? "localhost" : "127.0.0.1",
+							      8080,
+							      P_SOCKET_FAMILY_UNKNOWN,
+							      resolve_callback,
+							      i < 4 ? (ppointer) resolver : NULL,
+							      NULL);
+		P_TEST_REQUIRE (requests[i] != NULL);
+	}
+
+	for (pint i = 4; i < 8; ++i) {
+		p_socket_resolve_request_wait (requests[i]);
+		p_socket_resolve_request_free (requests[i]);
+	}
+
+	while (p_atomic_int_get (&callback_count) < 8)
+		p_uthread_sleep (1);
+
+	P_TEST_CHECK (p_atomic_int_get (&callback_addrs) >= 8);
+
+	/* Request cancelled before completion */
+	request = p_socket_resolver_lookup_async (resolver,
+						  "localhost",
+						  80,
+						  P_SOCKET_FAMILY_INET6,
+						  NULL,
+						  NULL,
+						  NULL);
+
+	if (p_socket_address_is_ipv6_supported ())
+		P_TEST_CHECK (request != NULL);
+
+	p_socket_resolve_request_free (request);
+
+	/* Request left pending when the resolver is freed */
+	request = p_socket_resolver_lookup_async (resolver,
+						  "127.0.0.2",
+						  80,
+						  P_SOCKET_FAMILY_INET,
+						  NULL,
+						  NULL,
+						  NULL);
+	P_TEST_REQUIRE (request != NULL);
+
+	p_socket_resolver_free (resolver);
+
+	P_TEST_CHECK (p_socket_resolve_request_is_done (request) == TRUE);
+
+	error  = NULL;
+	result = p_socket_resolve_request_take_result (request, &error);
+
+	/* Either processed or aborted */
+	if (result != NULL)
+		P_TEST_CHECK (check_address_list (result, 80, P_SOCKET_FAMILY_INET));
+	else
+		P_TEST_CHECK (error != NULL && p_error_get_code (error) == (pint) P_ERROR_IO_ABORTED);
+
+	free_address_list (result);
+
+	if (error != NULL)
+		p_error_free (error);
+
+	p_socket_resolve_request_free (request);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (psocketresolver_nomem_test);
+	P_TEST_SUITE_RUN_CASE (psocketresolver_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (psocketresolver_lookup_test);
+	P_TEST_SUITE_RUN_CASE (psocketresolver_async_test);
+}
+P_TEST_SUITE_END()
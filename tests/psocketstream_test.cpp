@@ -0,0 +1,410 @@
+/*
+ * The MIT License
+ *
+ * Copyright (C) 2026 Alexander Saprykin <saprykin.spb@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "plibsys.h"
+#include "ptestmacros.h"
+
+#include <string.h>
+
+P_TEST_MODULE_INIT ();
+
+extern "C" ppointer pmem_alloc (psize nbytes)
+{
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" ppointer pmem_realloc (ppointer block, psize nbytes)
+{
+	P_UNUSED (block);
+	P_UNUSED (nbytes);
+	return (ppointer) NULL;
+}
+
+extern "C" void pmem_free (ppointer block)
+{
+	P_UNUSED (block);
+}
+
+static pboolean socket_stream_test_connect (PSocket **server, PSocket **client, PSocket **accepted)
+{
+	PSocketAddress *addr;
+	PSocketAddress *server_addr;
+
+	*server   = p_socket_new (P_SOCKET_FAMILY_INET, P_SOCKET_TYPE_STREAM, P_SOCKET_PROTOCOL_TCP, NULL);
+	*client   = p_socket_new (P_SOCKET_FAMILY_INET, P_SOCKET_TYPE_STREAM, P_SOCKET_PROTOCOL_TCP, NULL);
+	*accepted = NULL;
+
+	if (*server == NULL || *client == NULL)
+		return FALSE;
+
+	if ((addr = p_socket_address_new ("127.0.0.1", 0)) == NULL)
+		return FALSE;
+
+	if (p_socket_bind (*server, addr, FALSE, NULL) == FALSE ||
+	    p_socket_listen (*server, NULL) == FALSE) {
+		p_socket_address_free (addr);
+		return FALSE;
+	}
+
+	p_socket_address_free (addr);
+
+	if ((server_addr = p_socket_get_local_address (*server, NULL)) == NULL)
+		return FALSE;
+
+	p_socket_set_timeout (*client, 2000);
+
+	if (p_socket_connect (*client, server_addr, NULL) == FALSE) {
+		p_socket_address_free (server_addr);
+		return FALSE;
+	}
+
+	p_socket_address_free (server_addr);
+
+	if ((*accepted = p_socket_accept (*server, NULL)) == NULL)
+		return FALSE;
+
+	p_socket_set_timeout (*accepted, 2000);
+
+	return TRUE;
+}
+
+P_TEST_CASE_BEGIN (psocketstream_nomem_test)
+{
+	p_libsys_init ();
+
+	PSocket *socket = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_STREAM,
+					P_SOCKET_PROTOCOL_TCP,
+					NULL);
+	P_TEST_REQUIRE (socket != NULL);
+
+	PMemVTable vtable;
+
+	vtable.f_free    = pmem_free;
+	vtable.f_malloc  = pmem_alloc;
+	vtable.f_realloc = pmem_realloc;
+
+	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
+	P_TEST_CHECK (p_socket_stream_new (socket, 0, 0, NULL) == NULL);
+
+	p_mem_restore_vtable ();
+
+	p_socket_free (socket);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketstream_bad_input_test)
+{
+	const pchar	*data;
+	pchar		buf[8];
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_socket_stream_new (NULL, 0, 0, NULL) == NULL);
+	P_TEST_CHECK (p_socket_stream_get_socket (NULL) == NULL);
+	P_TEST_CHECK (p_socket_stream_get_buffered (NULL) == 0);
+	P_TEST_CHECK (p_socket_stream_get_unflushed (NULL) == 0);
+	P_TEST_CHECK (p_socket_stream_read (NULL, buf, sizeof (buf), NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_read_exact (NULL, buf, sizeof (buf), NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_read_until (NULL, "\n", 1, buf, sizeof (buf), NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_peek (NULL, 1, &data, NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_write (NULL, buf, sizeof (buf), NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_flush (NULL, NULL) == FALSE);
+
+	p_socket_stream_free (NULL);
+
+	PSocket *socket = p_socket_new (P_SOCKET_FAMILY_INET,
+					P_SOCKET_TYPE_DATAGRAM,
+					P_SOCKET_PROTOCOL_UDP,
+					NULL);
+	P_TEST_REQUIRE (socket != NULL);
+
+	PError *error = NULL;
+
+	P_TEST_CHECK (p_socket_stream_new (socket, 0, 0, &error) == NULL);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_INVALID_ARGUMENT);
+
+	p_error_free (error);
+	p_socket_free (socket);
+
+	socket = p_socket_new (P_SOCKET_FAMILY_INET, P_SOCKET_TYPE_STREAM, P_SOCKET_PROTOCOL_TCP, NULL);
+	P_TEST_REQUIRE (socket != NULL);
+
+	PSocketStream *stream = p_socket_stream_new (socket, 0, 0, NULL);
+	P_TEST_REQUIRE (stream != NULL);
+
+	P_TEST_CHECK (p_socket_stream_get_socket (stream) == socket);
+	P_TEST_CHECK (p_socket_stream_read (stream, NULL, sizeof (buf), NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_read (stream, buf, 0, NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_read_exact (stream, buf, 0, NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_read_until (stream, NULL, 1, buf, sizeof (buf), NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_read_until (stream, "\n", 0, buf, sizeof (buf), NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_read_until (stream, "\n", 1, buf, 0, NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_peek (stream, 1, NULL, NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_write (stream, NULL, 1, NULL) == -1);
+	P_TEST_CHECK (p_socket_stream_flush (stream, NULL) == TRUE);
+
+	p_socket_stream_free (stream);
+	p_socket_free (socket);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketstream_read_test)
+{
+	PSocketStream	*stream;
+	PSocket		*server;
+	PSocket		*client;
+	PSocket		*accepted;
+	const pchar	*data;
+	pchar		buf[64];
+	const pchar	*payload = "line1\nline2\r\n0123456789ABCDEF\nHEAD" \
+				   "exact-read-longer-than-buffer!tail";
+
+	p_libsys_init ();
+
+	P_TEST_REQUIRE (socket_stream_test_connect (&server, &client, &accepted) == TRUE);
+	P_TEST_REQUIRE (p_socket_send (client, payload, strlen (payload), NULL) == (pssize) strlen (payload));
+
+	/* Small buffer to go through refills */
+	stream = p_socket_stream_new (accepted, 8, 8, NULL);
+	P_TEST_REQUIRE (stream != NULL);
+
+	P_TEST_CHECK (p_socket_stream_get_buffered (stream) == 0);
+	P_TEST_CHECK (p_socket_stream_peek (stream, 3, &data, NULL) >= 3);
+	P_TEST_CHECK (strncmp (data, "lin", 3) == 0);
+	P_TEST_CHECK (p_socket_stream_get_buffered (stream) >= 3);
+
+	memset (buf, 0, sizeof (buf));
+	P_TEST_CHECK (p_socket_stream_read_until (stream, "\n", 1, buf, sizeof (buf), NULL) == 6);
+	P_TEST_CHECK (strcmp (buf, "line1\n") == 0);
+
+	/* The delimiter is split between refills */
+	memset (buf, 0, sizeof (buf));
+	P_TEST_CHECK (p_socket_stream_read_until (stream, "\r\n", 2, buf, sizeof (buf), NULL) == 7);
+	P_TEST_CHECK (strcmp (buf, "line2\r\n") == 0);
+
+	/* A line longer than the read buffer is returned in pieces */
+	memset (buf, 0, sizeof (buf));
+	P_TEST_CHECK (p_socket_stream_read_until (stream, "\n", 1, buf, sizeof (buf), NULL) == 8);
+	P_TEST_CHECK (strcmp (buf, "01234567") == 0);
+
+	/* A line longer than the user buffer as well */
+	memset (buf, 0, sizeof (buf));
+	P_TEST_CHECK (p_socket_stream_read_until (stream, "\n", 1, buf, 4, NULL) == 4);
+	P_TEST_CHECK (strcmp (buf, "89AB") == 0);
+
+	memset (buf, 0, sizeof (buf));
+	P_TEST_CHECK (p_socket_stream_read_until (stream, "\n", 1, buf, sizeof (buf), NULL) == 5);
+	P_TEST_CHECK (strcmp (buf, "CDEF\n") == 0);
+
+	/* Peek is limited to the buffer size */
+	P_TEST_CHECK (p_socket_stream_peek (stream, 100, &data, NULL) == 8);
+	P_TEST_CHECK (strncmp (data, "HEADexac", 8) == 0);
+
+	memset (buf, 0, sizeof (buf));
+	P_TEST_CHECK (p_socket_stream_read_exact (stream, buf, 4, NULL) == 4);
+	P_TEST_CHECK (strcmp (buf, "HEAD") == 0);
+
+	memset (buf, 0, sizeof (buf));
+	P_TEST_CHECK (p_socket_stream_read_exact (stream, buf, 30, NULL) == 30);
+	P_TEST_CHECK (strcmp (buf, "exact-read-longer-than-buffer!") == 0);
+
+	/* The rest is read after the remote side is closed */
+	P_TEST_CHECK (p_socket_shutdown (client, FALSE, TRUE, NULL) == TRUE);
+
+	memset (buf, 0, sizeof (buf));
+	P_TEST_CHECK (p_socket_stream_read_until (stream, "\n", 1, buf, sizeof (buf), NULL) == 4);
+	P_TEST_CHECK (strcmp (buf, "tail") == 0);
+
+	P_TEST_CHECK (p_socket_stream_read_until (stream, "\n", 1, buf, sizeof (buf), NULL) == 0);
+	P_TEST_CHECK (p_socket_stream_read (stream, buf, sizeof (buf), NULL) == 0);
+	P_TEST_CHECK (p_socket_stream_read_exact (stream, buf, 4, NULL) == 0);
+	P_TEST_CHECK (p_socket_stream_peek (stream, 4, &data, NULL) == 0);
+
+	p_socket_stream_free (stream);
+
+	p_socket_free (accepted);
+	p_socket_free (client);
+	p_socket_free (server);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketstream_write_test)
+{
+	PSocketStream	*stream;
+	PSocketStream	*reader;
+	PSocket		*server;
+	PSocket		*client;
+	PSocket		*accepted;
+	pchar		buf[64];
+	pchar		large_buf[40];
+
+	p_libsys_init ();
+
+	P_TEST_REQUIRE (socket_stream_test_connect (&server, &client, &accepted) == TRUE);
+
+	stream = p_socket_stream_new (client, 0, 16, NULL);
+	reader = p_socket_stream_new (accepted, 0, 0, NULL);
+
+	P_TEST_REQUIRE (stream != NULL);
+	P_TEST_REQUIRE (reader != NULL);
+
+	/* Small writes are coalesced */
+	P_TEST_CHECK (p_socket_stream_write (stream, "abc", 3, NULL) == 3);
+	P_TEST_CHECK (p_socket_stream_write (stream, "defgh", 5, NULL) == 5);
+	P_TEST_CHECK (p_socket_stream_get_unflushed (stream) == 8);
+
+	P_TEST_CHECK (p_socket_stream_flush (stream, NULL) == TRUE);
+	P_TEST_CHECK (p_socket_stream_get_unflushed (stream) == 0);
+
+	memset (buf, 0, sizeof (buf));
+	P_TEST_CHECK (p_socket_stream_read_exact (reader, buf, 8, NULL) == 8);
+	P_TEST_CHECK (strcmp (buf, "abcdefgh") == 0);
+
+	/* Overflowing write flushes the buffer first */
+	P_TEST_CHECK (p_socket_stream_write (stream, "0123456789", 10, NULL) == 10);
+	P_TEST_CHECK (p_socket_stream_write (stream, "ABCDEFGHIJ", 10, NULL) == 10);
+	P_TEST_CHECK (p_socket_stream_get_unflushed (stream) == 10);
+
+	memset (buf, 0, sizeof (buf));
+	P_TEST_CHECK (p_socket_stream_read_exact (reader, buf, 10, NULL) == 10);
+	P_TEST_CHECK (strcmp (buf, "0123456789") == 0);
+
+	/* Large write goes directly after the buffered data */
+	memset (large_buf, 'x', sizeof (large_buf));
+
+	P_TEST_CHECK (p_socket_stream_write (stream, large_buf, sizeof (large_buf), NULL) == (pssize) sizeof (large_buf));
+	P_TEST_CHECK (p_socket_stream_get_unflushed (stream) == 0);
+
+	memset (buf, 0, sizeof (buf));
+	P_TEST_CHECK (p_socket_stream_read_exact (reader, buf, 10 + sizeof (large_buf), NULL) ==
+		      (pssize) (10 + sizeof (large_buf)));
+	P_TEST_CHECK (strncmp (buf, "ABCDEFGHIJ", 10) == 0);
+	P_TEST_CHECK (memcmp (buf + 10, large_buf, sizeof (large_buf)) == 0);
+
+	p_socket_stream_free (reader);
+	p_socket_stream_free (stream);
+
+	p_socket_free (accepted);
+	p_socket_free (client);
+	p_socket_free (server);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (psocketstream_partial_test)
+{
+	PSocketStream	*stream;
+	PSocketStream	*reader;
+	PSocket		*server;
+	PSocket		*client;
+	PSocket		*accepted;
+	PError		*error = NULL;
+	const pchar	*data;
+	pchar		*large_buf;
+	pchar		buf[64];
+	pssize		ret;
+	psize		large_len = 32 * 1024 * 1024;
+
+	p_libsys_init ();
+
+	P_TEST_REQUIRE (socket_stream_test_connect (&server, &client, &accepted) == TRUE);
+
+	stream = p_socket_stream_new (client, 0, 16, NULL);
+	reader = p_socket_stream_new (accepted, 16, 0, NULL);
+
+	P_TEST_REQUIRE (stream != NULL);
+	P_TEST_REQUIRE (reader != NULL);
+
+	p_socket_set_blocking (client, FALSE);
+	p_socket_set_blocking (accepted, FALSE);
+
+	/* Big read returns the buffered data when the socket runs dry */
+	P_TEST_CHECK (p_socket_stream_write (stream, "0123456789", 10, NULL) == 10);
+	P_TEST_CHECK (p_socket_stream_flush (stream, NULL) == TRUE);
+
+	p_socket_set_blocking (accepted, TRUE);
+	P_TEST_CHECK (p_socket_stream_peek (reader, 10, &data, NULL) == 10);
+	p_socket_set_blocking (accepted, FALSE);
+
+	memset (buf, 0, sizeof (buf));
+	P_TEST_CHECK (p_socket_stream_read_exact (reader, buf, sizeof (buf), &error) == 10);
+	P_TEST_CHECK (error == NULL);
+	P_TEST_CHECK (strcmp (buf, "0123456789") == 0);
+	P_TEST_CHECK (p_socket_stream_get_buffered (reader) == 0);
+
+	P_TEST_CHECK (p_socket_stream_read_exact (reader, buf, sizeof (buf), &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_WOULD_BLOCK);
+	p_error_free (error);
+	error = NULL;
+
+	/* Big write reports the consumed part when the socket gets full */
+	large_buf = (pchar *) p_malloc0 (large_len);
+	P_TEST_REQUIRE (large_buf != NULL);
+
+	ret = p_socket_stream_write (stream, large_buf, large_len, &error);
+
+	P_TEST_CHECK (ret > 0 && ret < (pssize) large_len);
+	P_TEST_CHECK (error == NULL);
+	P_TEST_CHECK (p_socket_stream_get_unflushed (stream) == 0);
+
+	P_TEST_CHECK (p_socket_stream_write (stream, large_buf, large_len, &error) == -1);
+	P_TEST_CHECK (error != NULL);
+	P_TEST_CHECK (p_error_get_code (error) == (pint) P_ERROR_IO_WOULD_BLOCK);
+	P_TEST_CHECK (p_socket_stream_get_unflushed (stream) == 0);
+	p_error_free (error);
+
+	p_free (large_buf);
+
+	p_socket_stream_free (reader);
+	p_socket_stream_free (stream);
+
+	p_socket_free (accepted);
+	p_socket_free (client);
+	p_socket_free (server);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_SUITE_BEGIN()
+{
+	P_TEST_SUITE_RUN_CASE (psocketstream_nomem_test);
+	P_TEST_SUITE_RUN_CASE (psocketstream_bad_input_test);
+	P_TEST_SUITE_RUN_CASE (psocketstream_read_test);
+	P_TEST_SUITE_RUN_CASE (psocketstream_write_test);
+	P_TEST_SUITE_RUN_CASE (psocketstream_partial_test);
+}
+P_TEST_SUITE_END()
@@ -26,12 +26,34 @@
 #include "plibsys.h"
 #include "ptestmacros.h"
 
+#include <stdio.h>
 #include <string.h>
 #include <float.h>
 #include <math.h>
 
 P_TEST_MODULE_INIT ();
 
+#define PSTRING_INTERNER_THREADS	4
+#define PSTRING_INTERNER_STRINGS	500
+
+static PStringInterner *global_interner = NULL;
+static const pchar *global_interned[PSTRING_INTERNER_THREADS][PSTRING_INTERNER_STRINGS];
+
+static void * string_interner_test_thread (void *data)
+{
+	pint	idx = (pint) (psize) data;
+	pchar	buf[32];
+
+	for (pint i = 0; i < PSTRING_INTERNER_STRINGS; ++i) {
+		snprintf (buf, sizeof (buf), "interned-string-%d", i);
+		global_interned[idx][i] = p_string_interner_intern (global_interner, buf);
+	}
+
+	p_uthread_exit (0);
+
+	return NULL;
+}
+
 extern "C" ppointer pmem_alloc (psize nbytes)
 {
 	P_UNUSED (nbytes);
@@ -63,6 +85,7 @@ P_TEST_CASE_BEGIN (pstring_nomem_test)
 	P_TEST_CHECK (p_mem_set_vtable (&vtable) == TRUE);
 
 	P_TEST_CHECK (p_strdup ("test string") == NULL);
+	P_TEST_CHECK (p_string_interner_new () == NULL);
 
 	p_mem_restore_vtable ();
 
@@ -279,6 +302,200 @@ P_TEST_CASE_BEGIN (pstring_strtod_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (pstring_view_test)
+{
+	PStringView	view;
+	PStringView	token;
+	PStringView	tokens[8];
+	pint		count;
+
+	p_libsys_init ();
+
+	/* Construction */
+	view = p_string_view_from_str (NULL);
+	P_TEST_CHECK (view.data != NULL && view.len == 0);
+
+	view = p_string_view_from_data (NULL, 10);
+	P_TEST_CHECK (view.data != NULL && view.len == 0);
+
+	view = p_string_view_from_str ("test string");
+	P_TEST_CHECK (view.len == 11);
+	P_TEST_CHECK (strncmp (view.data, "test string", view.len) == 0);
+
+	view = p_string_view_from_data ("test string", 4);
+	P_TEST_CHECK (p_string_view_equal (view, p_string_view_from_str ("test")) == TRUE);
+	P_TEST_CHECK (p_string_view_equal (view, p_string_view_from_str ("tes")) == FALSE);
+	P_TEST_CHECK (p_string_view_equal (view, p_string_view_from_str ("tost")) == FALSE);
+	P_TEST_CHECK (p_string_view_equal (p_string_view_from_str (""),
+					   p_string_view_from_data (NULL, 0)) == TRUE);
+
+	/* Trimming */
+	const pchar *str = " \t text with spaces \n ";
+
+	view = p_string_view_trim (p_string_view_from_str (str));
+	P_TEST_CHECK (view.data == str + 3);
+	P_TEST_CHECK (p_string_view_equal (view, p_string_view_from_str ("text with spaces")) == TRUE);
+
+	view = p_string_view_trim (p_string_view_from_str (" \t\n "));
+	P_TEST_CHECK (view.len == 0);
+
+	view = p_string_view_trim (p_string_view_from_str ("x"));
+	P_TEST_CHECK (view.len == 1);
+
+	/* Searching */
+	view = p_string_view_from_str ("abcabcd");
+
+	P_TEST_CHECK (p_string_view_find_char (view, 'a') == 0);
+	P_TEST_CHECK (p_string_view_find_char (view, 'd') == 6);
+	P_TEST_CHECK (p_string_view_find_char (view, 'e') == -1);
+	P_TEST_CHECK (p_string_view_find_char (p_string_view_from_data ("abcd", 3), 'd') == -1);
+
+	P_TEST_CHECK (p_string_view_find (view, p_string_view_from_str ("abcd")) == 3);
+	P_TEST_CHECK (p_string_view_find (view, p_string_view_from_str ("bc")) == 1);
+	P_TEST_CHECK (p_string_view_find (view, p_string_view_from_str ("abcabcd")) == 0);
+	P_TEST_CHECK (p_string_view_find (view, p_string_view_from_str ("abcabcde")) == -1);
+	P_TEST_CHECK (p_string_view_find (view, p_string_view_from_str ("cb")) == -1);
+	P_TEST_CHECK (p_string_view_find (view, p_string_view_from_str ("")) == 0);
+	P_TEST_CHECK (p_string_view_find (p_string_view_from_data ("abcd", 3),
+					  p_string_view_from_str ("cd")) == -1);
+
+	/* Splitting */
+	P_TEST_CHECK (p_string_view_split (NULL, ',', &token) == FALSE);
+	P_TEST_CHECK (p_string_view_split (&view, ',', NULL) == FALSE);
+
+	str   = " a , b,,c ,";
+	view  = p_string_view_from_str (str);
+	count = 0;
+
+	while (count < 8 && p_string_view_split (&view, ',', &token) == TRUE)
+		tokens[count++] = p_string_view_trim (token);
+
+	P_TEST_REQUIRE (count == 5);
+	P_TEST_CHECK (p_string_view_equal (tokens[0], p_string_view_from_str ("a")) == TRUE);
+	P_TEST_CHECK (p_string_view_equal (tokens[1], p_string_view_from_str ("b")) == TRUE);
+	P_TEST_CHECK (tokens[2].len == 0);
+	P_TEST_CHECK (p_string_view_equal (tokens[3], p_string_view_from_str ("c")) == TRUE);
+	P_TEST_CHECK (tokens[4].len == 0);
+	P_TEST_CHECK (tokens[0].data >= str && tokens[3].data < str + strlen (str));
+	P_TEST_CHECK (p_string_view_split (&view, ',', &token) == FALSE);
+
+	view = p_string_view_from_str ("");
+	P_TEST_CHECK (p_string_view_split (&view, ',', &token) == TRUE);
+	P_TEST_CHECK (token.len == 0);
+	P_TEST_CHECK (p_string_view_split (&view, ',', &token) == FALSE);
+
+	view = p_string_view_from_str ("key=value");
+	P_TEST_CHECK (p_string_view_split (&view, ';', &token) == TRUE);
+	P_TEST_CHECK (p_string_view_equal (token, p_string_view_from_str ("key=value")) == TRUE);
+	P_TEST_CHECK (p_string_view_split (&view, ';', &token) == FALSE);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (pstring_interner_test)
+{
+	PStringInterner	*interner;
+	PUThread	*threads[PSTRING_INTERNER_THREADS];
+	pchar		buf[32];
+	const pchar	*str;
+
+	p_libsys_init ();
+
+	P_TEST_CHECK (p_string_interner_intern (NULL, "test") == NULL);
+	P_TEST_CHECK (p_string_interner_intern_view (NULL, p_string_view_from_str ("test")) == NULL);
+	P_TEST_CHECK (p_string_interner_lookup (NULL, "test") == NULL);
+	P_TEST_CHECK (p_string_interner_get_count (NULL) == 0);
+
+	p_string_interner_free (NULL);
+
+	interner = p_string_interner_new ();
+	P_TEST_REQUIRE (interner != NULL);
+
+	P_TEST_CHECK (p_string_interner_intern (interner, NULL) == NULL);
+	P_TEST_CHECK (p_string_interner_lookup (interner, NULL) == NULL);
+	P_TEST_CHECK (p_string_interner_intern_view (interner, p_string_view_from_data ("a\0b", 3)) == NULL);
+
+	/* Equal strings give the same pointer */
+	strcpy (buf, "interned");
+
+	str = p_string_interner_intern (interner, buf);
+
+	P_TEST_REQUIRE (str != NULL);
+	P_TEST_CHECK (str != buf);
+	P_TEST_CHECK (strcmp (str, "interned") == 0);
+	P_TEST_CHECK (p_string_interner_intern (interner, "interned") == str);
+	P_TEST_CHECK (p_string_interner_lookup (interner, "interned") == str);
+	P_TEST_CHECK (p_string_interner_intern_view (interner,
+						     p_string_view_from_str ("not interned yet")) != str);
+	P_TEST_CHECK (p_string_interner_intern_view (interner,
+						     p_string_view_from_data ("interned string", 8)) == str);
+	P_TEST_CHECK (p_string_interner_lookup (interner, "unknown") == NULL);
+	P_TEST_CHECK (p_string_interner_get_count (interner) == 2);
+
+	/* Empty string can be interned as well */
+	str = p_string_interner_intern (interner, "");
+
+	P_TEST_REQUIRE (str != NULL);
+	P_TEST_CHECK (*str == '\0');
+	P_TEST_CHECK (p_string_interner_intern_view (interner, p_string_view_from_str (NULL)) == str);
+	P_TEST_CHECK (p_string_interner_get_count (interner) == 3);
+
+	/* Interned strings work as hash table keys */
+	PHashTable *table = p_hash_table_new ();
+
+	P_TEST_REQUIRE (table != NULL);
+
+	p_hash_table_insert (table,
+			     (ppointer) p_string_interner_intern (interner, "key"),
+			     PINT_TO_POINTER (10));
+
+	strcpy (buf, "key");
+
+	P_TEST_CHECK (p_hash_table_lookup (table, p_string_interner_intern (interner, buf)) ==
+		      PINT_TO_POINTER (10));
+
+	p_hash_table_free (table);
+	p_string_interner_free (interner);
+
+	/* Concurrent interning */
+	global_interner = p_string_interner_new ();
+	P_TEST_REQUIRE (global_interner != NULL);
+
+	for (pint i = 0; i < PSTRING_INTERNER_THREADS; ++i) {
+		threads[i] = p_uthread_create ((PUThreadFunc) string_interner_test_thread,
+					       (ppointer) (psize) i,
+					       TRUE,
+					       NULL);
+		P_TEST_REQUIRE (threads[i] != NULL);
+	}
+
+	for (pint i = 0; i < PSTRING_INTERNER_THREADS; ++i) {
+		P_TEST_CHECK (p_uthread_join (threads[i]) == 0);
+		p_uthread_unref (threads[i]);
+	}
+
+	P_TEST_CHECK (p_string_interner_get_count (global_interner) == PSTRING_INTERNER_STRINGS);
+
+	for (pint i = 0; i < PSTRING_INTERNER_STRINGS; ++i) {
+		snprintf (buf, sizeof (buf), "interned-string-%d", i);
+
+		str = p_string_interner_lookup (global_interner, buf);
+
+		P_TEST_REQUIRE (str != NULL);
+		P_TEST_CHECK (strcmp (str, buf) == 0);
+
+		for (pint j = 0; j < PSTRING_INTERNER_THREADS; ++j)
+			P_TEST_CHECK (global_interned[j][i] == str);
+	}
+
+	p_string_interner_free (global_interner);
+	global_interner = NULL;
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (pstring_nomem_test);
@@ -286,5 +503,7 @@ P_TEST_SUITE_BEGIN()
 	P_TEST_SUITE_RUN_CASE (pstring_strchomp_test);
 	P_TEST_SUITE_RUN_CASE (pstring_strtok_test);
 	P_TEST_SUITE_RUN_CASE (pstring_strtod_test);
+	P_TEST_SUITE_RUN_CASE (pstring_view_test);
+	P_TEST_SUITE_RUN_CASE (pstring_interner_test);
 }
 P_TEST_SUITE_END()
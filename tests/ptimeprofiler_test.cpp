@@ -71,6 +71,8 @@ P_TEST_CASE_BEGIN (ptimeprofiler_bad_input_test)
 	p_libsys_init ();
 
 	P_TEST_CHECK (p_time_profiler_elapsed_usecs (NULL) == 0);
+	P_TEST_CHECK (p_time_profiler_elapsed_nsecs (NULL) == 0);
+	P_TEST_CHECK (p_time_profiler_ticks_to_nsecs (0) == 0);
 	p_time_profiler_reset (NULL);
 	p_time_profiler_free (NULL);
 
@@ -112,16 +114,58 @@ P_TEST_CASE_BEGIN (ptimeprofiler_general_test)
 	val = p_time_profiler_elapsed_usecs (profiler);
 	P_TEST_CHECK (val > prev_val);
 
+	p_time_profiler_reset (profiler);
+
+	p_uthread_sleep (25);
+	prev_val = p_time_profiler_elapsed_nsecs (profiler);
+	P_TEST_CHECK (prev_val >= 25 * 1000000ULL);
+
+	p_uthread_sleep (50);
+	val = p_time_profiler_elapsed_nsecs (profiler);
+	P_TEST_CHECK (val > prev_val);
+	P_TEST_CHECK (val / 1000 <= p_time_profiler_elapsed_usecs (profiler));
+
 	p_time_profiler_free (profiler);
 
 	p_libsys_shutdown ();
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (ptimeprofiler_ticks_test)
+{
+	puint64	start_ticks;
+	puint64	end_ticks;
+	puint64	nsecs;
+	pint	i;
+
+	p_libsys_init ();
+
+	start_ticks = p_time_profiler_ticks ();
+
+	for (i = 0; i < 1000; ++i) {
+		end_ticks = p_time_profiler_ticks ();
+		P_TEST_CHECK (end_ticks >= start_ticks);
+	}
+
+	p_uthread_sleep (100);
+
+	end_ticks = p_time_profiler_ticks ();
+	P_TEST_CHECK (end_ticks > start_ticks);
+
+	nsecs = p_time_profiler_ticks_to_nsecs (end_ticks - start_ticks);
+
+	P_TEST_CHECK (nsecs >= 100 * 1000000ULL);
+	P_TEST_CHECK (nsecs < 100 * 1000000000ULL);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (ptimeprofiler_nomem_test);
 	P_TEST_SUITE_RUN_CASE (ptimeprofiler_bad_input_test);
 	P_TEST_SUITE_RUN_CASE (ptimeprofiler_general_test);
+	P_TEST_SUITE_RUN_CASE (ptimeprofiler_ticks_test);
 }
 P_TEST_SUITE_END()
@@ -26,6 +26,8 @@
 #include "plibsys.h"
 #include "ptestmacros.h"
 
+#include <string.h>
+
 P_TEST_MODULE_INIT ();
 
 static pint              thread_wakes_1     = 0;
@@ -165,6 +167,83 @@ static void * test_thread_tls_func (void *data)
 	return NULL;
 }
 
+static volatile pint static_free_counter = 0;
+
+static void test_static_free_func (ppointer data)
+{
+	P_UNUSED (data);
+	p_atomic_int_inc (&static_free_counter);
+}
+
+static PUThreadStaticKey static_key = P_UTHREAD_STATIC_KEY_INIT (test_static_free_func);
+static PUThreadStaticKey static_keys[P_UTHREAD_STATIC_KEY_MAX + 8];
+
+static void * test_thread_static_func (void *data)
+{
+	pint	base  = PPOINTER_TO_INT (data);
+	pint	match = 1;
+
+	if (p_uthread_static_get_local (&static_key) != NULL)
+		match = 0;
+
+	p_uthread_static_set_local (&static_key, PINT_TO_POINTER (base));
+
+	/* Keys over the native TLS limit fall back to the system TLS */
+	for (pint i = 0; i < (pint) (sizeof (static_keys) / sizeof (static_keys[0])); ++i)
+		p_uthread_static_set_local (&static_keys[i], PINT_TO_POINTER (base + i + 1));
+
+	for (pint j = 0; j < 1000; ++j) {
+		if (p_uthread_static_get_local (&static_key) != PINT_TO_POINTER (base))
+			match = 0;
+
+		p_uthread_yield ();
+	}
+
+	for (pint i = 0; i < (pint) (sizeof (static_keys) / sizeof (static_keys[0])); ++i) {
+		if (p_uthread_static_get_local (&static_keys[i]) != PINT_TO_POINTER (base + i + 1))
+			match = 0;
+	}
+
+	p_uthread_static_replace_local (&static_key, PINT_TO_POINTER (base + 1));
+
+	if (p_uthread_static_get_local (&static_key) != PINT_TO_POINTER (base + 1))
+		match = 0;
+
+	if (p_uthread_current () != p_uthread_current ())
+		match = 0;
+
+	p_uthread_exit (match);
+
+	return NULL;
+}
+
+static void * test_thread_affinity_func (void *data)
+{
+	PUThreadCpuSet	*expected = (PUThreadCpuSet *) data;
+	PUThreadCpuSet	cpus;
+
+	if (p_uthread_get_affinity (NULL, &cpus) == FALSE)
+		p_uthread_exit (-1);
+
+	p_uthread_exit (memcmp (&cpus, expected, sizeof (cpus)) == 0 ? 1 : 0);
+
+	return NULL;
+}
+
+static void * test_thread_foreign_affinity_func (void *data)
+{
+	PUThread	*foreign = (PUThread *) data;
+	PUThreadCpuSet	cpus;
+
+	p_uthread_cpu_set_clear (&cpus);
+	p_uthread_cpu_set_add (&cpus, 0);
+
+	p_uthread_exit (p_uthread_get_affinity (foreign, &cpus) == FALSE &&
+			p_uthread_set_affinity (foreign, &cpus) == FALSE ? 1 : 0);
+
+	return NULL;
+}
+
 static void * test_thread_tls_create_func (void *data)
 {
 	P_UNUSED (data);
@@ -210,6 +289,20 @@ P_TEST_CASE_BEGIN (puthread_nomem_test)
 					     0,
 					     NULL) == NULL);
 
+	PUThreadCpuSet cpus;
+
+	p_uthread_cpu_set_clear (&cpus);
+	p_uthread_cpu_set_add (&cpus, 0);
+
+	P_TEST_CHECK (p_uthread_create_with_affinity ((PUThreadFunc) test_thread_func,
+						      (ppointer) &thread_wakes_2,
+						      TRUE,
+						      P_UTHREAD_PRIORITY_NORMAL,
+						      0,
+						      NULL,
+						      &cpus) == NULL);
+
+	P_TEST_CHECK (p_uthread_topology_new () == NULL);
 	P_TEST_CHECK (p_uthread_current () == NULL);
 	P_TEST_CHECK (p_uthread_local_new (NULL) == NULL);
 
@@ -249,6 +342,22 @@ P_TEST_CASE_BEGIN (puthread_bad_input_test)
 	P_TEST_CHECK (p_uthread_create_full (NULL, NULL, FALSE, P_UTHREAD_PRIORITY_NORMAL, 0, NULL) == NULL);
 	P_TEST_CHECK (p_uthread_join (NULL) == -1);
 	P_TEST_CHECK (p_uthread_set_priority (NULL, P_UTHREAD_PRIORITY_NORMAL) == FALSE);
+	P_TEST_CHECK (p_uthread_create_with_affinity (NULL, NULL, FALSE, P_UTHREAD_PRIORITY_NORMAL, 0, NULL, NULL) == NULL);
+	P_TEST_CHECK (p_uthread_set_affinity (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_uthread_get_affinity (NULL, NULL) == FALSE);
+	P_TEST_CHECK (p_uthread_cpu_set_add (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_uthread_cpu_set_contains (NULL, 0) == FALSE);
+	P_TEST_CHECK (p_uthread_cpu_set_get_count (NULL) == 0);
+	P_TEST_CHECK (p_uthread_topology_get_cpu_count (NULL) == 0);
+	P_TEST_CHECK (p_uthread_topology_get_core_count (NULL) == 0);
+	P_TEST_CHECK (p_uthread_topology_get_package_count (NULL) == 0);
+	P_TEST_CHECK (p_uthread_topology_get_node_count (NULL) == 0);
+	P_TEST_CHECK (p_uthread_topology_get_cpu_info (NULL, 0, NULL) == FALSE);
+	P_TEST_CHECK (p_uthread_topology_get_core_cpus (NULL, 0, NULL) == FALSE);
+	P_TEST_CHECK (p_uthread_topology_get_node_cpus (NULL, 0, NULL) == FALSE);
+	p_uthread_cpu_set_clear (NULL);
+	p_uthread_cpu_set_remove (NULL, 0);
+	p_uthread_topology_free (NULL);
 	P_TEST_CHECK (p_uthread_get_local (NULL) == NULL);
 	p_uthread_set_local (NULL, NULL);
 	p_uthread_replace_local (NULL, NULL);
@@ -470,6 +579,157 @@ P_TEST_CASE_BEGIN (puthread_tls_test)
 }
 P_TEST_CASE_END ()
 
+P_TEST_CASE_BEGIN (puthread_static_tls_test)
+{
+	PUThread *thr1;
+	PUThread *thr2;
+
+	p_libsys_init ();
+
+	static_free_counter = 0;
+
+	p_uthread_static_set_local (NULL, NULL);
+	p_uthread_static_replace_local (NULL, NULL);
+	P_TEST_CHECK (p_uthread_static_get_local (NULL) == NULL);
+
+	thr1 = p_uthread_create ((PUThreadFunc) test_thread_static_func, PINT_TO_POINTER (1000), TRUE, NULL);
+	thr2 = p_uthread_create ((PUThreadFunc) test_thread_static_func, PINT_TO_POINTER (2000), TRUE, NULL);
+
+	P_TEST_REQUIRE (thr1 != NULL);
+	P_TEST_REQUIRE (thr2 != NULL);
+
+	P_TEST_CHECK (p_uthread_join (thr1) == 1);
+	P_TEST_CHECK (p_uthread_join (thr2) == 1);
+
+	p_uthread_unref (thr1);
+	p_uthread_unref (thr2);
+
+	/* Every thread has replaced one value and destroyed another one on exit */
+	P_TEST_CHECK (p_atomic_int_get (&static_free_counter) == 4);
+
+	P_TEST_CHECK (p_uthread_static_get_local (&static_key) == NULL);
+	p_uthread_static_set_local (&static_key, PINT_TO_POINTER (10));
+	P_TEST_CHECK (p_uthread_static_get_local (&static_key) == PINT_TO_POINTER (10));
+	p_uthread_static_set_local (&static_key, NULL);
+	P_TEST_CHECK (p_atomic_int_get (&static_free_counter) == 4);
+
+	P_TEST_CHECK (p_uthread_current () == p_uthread_current ());
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
+P_TEST_CASE_BEGIN (puthread_affinity_test)
+{
+	PUThreadTopology	*topology;
+	PUThreadCpuInfo		info;
+	PUThreadCpuSet		cpus;
+	PUThreadCpuSet		all_cpus;
+	PUThread		*thr;
+	pint			cpu_count;
+	pint			core_count;
+	pint			prev_cpu;
+
+	p_libsys_init ();
+
+	/* CPU set operations */
+	p_uthread_cpu_set_clear (&cpus);
+	P_TEST_CHECK (p_uthread_cpu_set_get_count (&cpus) == 0);
+	P_TEST_CHECK (p_uthread_cpu_set_add (&cpus, 0) == TRUE);
+	P_TEST_CHECK (p_uthread_cpu_set_add (&cpus, 33) == TRUE);
+	P_TEST_CHECK (p_uthread_cpu_set_add (&cpus, P_UTHREAD_CPU_SET_SIZE - 1) == TRUE);
+	P_TEST_CHECK (p_uthread_cpu_set_add (&cpus, P_UTHREAD_CPU_SET_SIZE) == FALSE);
+	P_TEST_CHECK (p_uthread_cpu_set_add (&cpus, -1) == FALSE);
+	P_TEST_CHECK (p_uthread_cpu_set_get_count (&cpus) == 3);
+	P_TEST_CHECK (p_uthread_cpu_set_contains (&cpus, 33) == TRUE);
+	P_TEST_CHECK (p_uthread_cpu_set_contains (&cpus, 32) == FALSE);
+	p_uthread_cpu_set_remove (&cpus, 33);
+	P_TEST_CHECK (p_uthread_cpu_set_contains (&cpus, 33) == FALSE);
+	P_TEST_CHECK (p_uthread_cpu_set_get_count (&cpus) == 2);
+
+	p_uthread_cpu_set_clear (&cpus);
+	P_TEST_CHECK (p_uthread_set_affinity (NULL, &cpus) == FALSE);
+
+	/* Topology must be consistent */
+	topology = p_uthread_topology_new ();
+	P_TEST_REQUIRE (topology != NULL);
+
+	cpu_count  = p_uthread_topology_get_cpu_count (topology);
+	core_count = p_uthread_topology_get_core_count (topology);
+
+	P_TEST_CHECK (cpu_count > 0);
+	P_TEST_CHECK (core_count > 0 && core_count <= cpu_count);
+	P_TEST_CHECK (p_uthread_topology_get_package_count (topology) > 0);
+	P_TEST_CHECK (p_uthread_topology_get_package_count (topology) <= core_count);
+	P_TEST_CHECK (p_uthread_topology_get_node_count (topology) > 0);
+	P_TEST_CHECK (p_uthread_topology_get_cpu_info (topology, cpu_count, &info) == FALSE);
+	P_TEST_CHECK (p_uthread_topology_get_core_cpus (topology, core_count, &cpus) == FALSE);
+
+	prev_cpu = -1;
+
+	for (pint i = 0; i < cpu_count; ++i) {
+		P_TEST_REQUIRE (p_uthread_topology_get_cpu_info (topology, i, &info) == TRUE);
+		P_TEST_CHECK (info.cpu > prev_cpu);
+		P_TEST_CHECK (info.core >= 0 && info.core < core_count);
+
+		P_TEST_CHECK (p_uthread_topology_get_core_cpus (topology, info.core, &cpus) == TRUE);
+		P_TEST_CHECK (p_uthread_cpu_set_contains (&cpus, info.cpu) == TRUE);
+
+		P_TEST_CHECK (p_uthread_topology_get_node_cpus (topology, info.node, &cpus) == TRUE);
+		P_TEST_CHECK (p_uthread_cpu_set_contains (&cpus, info.cpu) == TRUE);
+
+		prev_cpu = info.cpu;
+	}
+
+	p_uthread_topology_free (topology);
+
+	/* Affinity is not supported everywhere */
+	if (p_uthread_get_affinity (NULL, &all_cpus) == FALSE) {
+		p_libsys_shutdown ();
+		P_TEST_CASE_RETURN ();
+	}
+
+	P_TEST_REQUIRE (p_uthread_cpu_set_get_count (&all_cpus) > 0);
+
+	/* Bind to a single CPU and then restore the old affinity */
+	for (prev_cpu = 0; p_uthread_cpu_set_contains (&all_cpus, prev_cpu) == FALSE; ++prev_cpu)
+		;
+
+	p_uthread_cpu_set_clear (&cpus);
+	p_uthread_cpu_set_add (&cpus, prev_cpu);
+
+	P_TEST_CHECK (p_uthread_set_affinity (p_uthread_current (), &cpus) == TRUE);
+	P_TEST_CHECK (p_uthread_get_affinity (NULL, &cpus) == TRUE);
+	P_TEST_CHECK (p_uthread_cpu_set_get_count (&cpus) == 1);
+	P_TEST_CHECK (p_uthread_cpu_set_contains (&cpus, prev_cpu) == TRUE);
+	P_TEST_CHECK (p_uthread_set_affinity (NULL, &all_cpus) == TRUE);
+
+	thr = p_uthread_create_with_affinity ((PUThreadFunc) test_thread_affinity_func,
+					      (ppointer) &cpus,
+					      TRUE,
+					      P_UTHREAD_PRIORITY_INHERIT,
+					      0,
+					      NULL,
+					      &cpus);
+	P_TEST_REQUIRE (thr != NULL);
+	P_TEST_CHECK (p_uthread_join (thr) == 1);
+
+	p_uthread_unref (thr);
+
+	/* Foreign thread can't be accessed from another thread */
+	thr = p_uthread_create ((PUThreadFunc) test_thread_foreign_affinity_func,
+				(ppointer) p_uthread_current (),
+				TRUE,
+				NULL);
+	P_TEST_REQUIRE (thr != NULL);
+	P_TEST_CHECK (p_uthread_join (thr) == 1);
+
+	p_uthread_unref (thr);
+
+	p_libsys_shutdown ();
+}
+P_TEST_CASE_END ()
+
 P_TEST_SUITE_BEGIN()
 {
 	P_TEST_SUITE_RUN_CASE (puthread_nomem_test);
@@ -477,5 +737,7 @@ P_TEST_SUITE_BEGIN()
 	P_TEST_SUITE_RUN_CASE (puthread_general_test);
 	P_TEST_SUITE_RUN_CASE (puthread_nonjoinable_test);
 	P_TEST_SUITE_RUN_CASE (puthread_tls_test);
+	P_TEST_SUITE_RUN_CASE (puthread_static_tls_test);
+	P_TEST_SUITE_RUN_CASE (puthread_affinity_test);
 }
 P_TEST_SUITE_END()